@@ -27,6 +27,10 @@ cp list.h $VBCC_DIR/include/mb/
 cp event.h $VBCC_DIR/include/mb/
 cp mouse.h $VBCC_DIR/include/mb/
 cp menu.h $VBCC_DIR/include/mb/
+cp console.h $VBCC_DIR/include/mb/
+cp terminal.h $VBCC_DIR/include/mb/
+cp text_window.h $VBCC_DIR/include/mb/
+cp text_glyph_atlas.h $VBCC_DIR/include/mb/
 
 # copy latest version of headers to VBCC for other projects to get to
 cp lib_sys.h $VBCC/targets/a2560-micah/include/mb/
@@ -43,6 +47,10 @@ cp list.h $VBCC/targets/a2560-micah/include/mb/
 cp event.h $VBCC/targets/a2560-micah/include/mb/
 cp mouse.h $VBCC/targets/a2560-micah/include/mb/
 cp menu.h $VBCC/targets/a2560-micah/include/mb/
+cp console.h $VBCC/targets/a2560-micah/include/mb/
+cp terminal.h $VBCC/targets/a2560-micah/include/mb/
+cp text_window.h $VBCC/targets/a2560-micah/include/mb/
+cp text_glyph_atlas.h $VBCC/targets/a2560-micah/include/mb/
 
 echo "Compiling PJW's minimal startup..."
 vasmm68k_mot -Felf -m68040 -o $VBCC_DIR/minimal_startup.o $VBCC_DIR/minimal_startup.s 
@@ -50,7 +58,7 @@ vasmm68k_mot -Felf -m68040 -o $VBCC_DIR/minimal_startup.o $VBCC_DIR/minimal_star
 echo "Building a2560_sys library..."
 
 # make SYS as static lib
-vc +$VBCC_DIR/a2560-lib-OSf -o a2560_sys.lib lib_sys.c theme.c control_template.c font.c window.c control.c general.c bitmap.c text.c list.c startup.c event.c mouse.c menu.c mcp_code/dev/ps2.c -D_A2560K_ -D_f68_ -DMODEL=MODEL_FOENIX_A2560K > $BUILD_DIR/a2560_sys.map
+vc +$VBCC_DIR/a2560-lib-OSf -o a2560_sys.lib lib_sys.c theme.c control_template.c font.c window.c control.c general.c bitmap.c text.c list.c startup.c event.c mouse.c menu.c console.c terminal.c text_window.c text_glyph_atlas.c mcp_code/dev/ps2.c -D_A2560K_ -D_f68_ -DMODEL=MODEL_FOENIX_A2560K > $BUILD_DIR/a2560_sys.map
 cp a2560_sys.lib $VBCC_DIR/lib/
 mv a2560_sys.lib $VBCC/targets/a2560-micah/lib/
 
@@ -66,7 +74,7 @@ echo "Building system demo executable..."
 vc +$VBCC_DIR/a2560-s28-OSf-test -o $BUILD_DIR/sys_demo.s28 lib_sys_demo.c -D_A2560K_ -D_f68_ > $BUILD_DIR/sys_demo.map
 
 # make demo code - SYS but not from library
-# vc +$VBCC_DIR/a2560-s28-OSf -o $BUILD_DIR/sys_demo.s28 lib_sys.c theme.c control_template.c font.c window.c control.c general.c bitmap.c text.c list.c startup.c event.c lib_sys_demo.c mouse.c menu.c -D_A2560K_
+# vc +$VBCC_DIR/a2560-s28-OSf -o $BUILD_DIR/sys_demo.s28 lib_sys.c theme.c control_template.c font.c window.c control.c general.c bitmap.c text.c list.c startup.c event.c lib_sys_demo.c mouse.c menu.c console.c terminal.c text_window.c text_glyph_atlas.c -D_A2560K_
 perl -i -0777 -pe 's/S804000000FB/S804020000FB/' "$BUILD_DIR/sys_demo.s28"
 
 echo "Building system demo executable..."
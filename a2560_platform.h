@@ -284,6 +284,16 @@
 	#define VRAM_LEN				0x00400000
 #endif
 
+// ** PS/2 keyboard and mouse data port per machine
+
+#if defined _C256_FMX_
+	#define PS2_DATA_PORT			0x00AF1060
+#elif defined _A2560U_
+	#define PS2_DATA_PORT			0x00B02800
+#elif defined _A2560K_
+	#define PS2_DATA_PORT			0xFEC02060
+#endif
+
 #define VRAM_OFFSET_TO_NEXT_SCREEN	0x75300		// 800x600 - 480,000 -- number of bytes needed to cover maximum screen resolution for one bitmap layer
 
 
@@ -457,6 +467,10 @@ typedef struct List List;						// defined in list.h
 typedef struct EventRecord EventRecord;			// defined in event.h
 typedef struct EventManager EventManager;		// defined in event.h
 typedef struct MouseTracker MouseTracker;		// defined in mouse.h
+typedef struct Console Console;					// defined in console.h
+typedef struct Terminal Terminal;				// defined in terminal.h
+typedef struct TextWindow TextWindow;			// defined in text_window.h
+typedef struct TextGlyphAtlas TextGlyphAtlas;	// defined in text_glyph_atlas.h
 typedef struct MenuItem MenuItem;				// defined in menu.h
 typedef struct MenuGroup MenuGroup;				// defined in menu.h
 typedef struct Menu Menu;						// defined in menu.h
@@ -487,8 +501,13 @@ typedef struct Screen
 	int16_t			text_rows_vis_;		// accounting for borders, the number of visible rows on screen
 	int16_t			text_mem_cols_;		// for the current resolution, the total number of columns per row in VRAM. Use for plotting x,y 
 	int16_t			text_mem_rows_;		// for the current resolution, the total number of rows per row in VRAM. Use for plotting x,y 
-	char*			text_ram_;
-	char*			text_attr_ram_;
+	char*			text_ram_;			// character memory Text functions work with: VICKY's, or the shadow buffer if one is in use
+	char*			text_attr_ram_;		// attribute memory Text functions work with: VICKY's, or the shadow buffer if one is in use
+	char*			text_vram_;			// while a shadow buffer is in use, VICKY's character memory. NULL otherwise.
+	char*			text_attr_vram_;	// while a shadow buffer is in use, VICKY's attribute memory. NULL otherwise.
+	char*			text_shadow_;		// one allocation holding the shadow char and attr buffers, followed by copies of what was last flushed to VICKY. NULL if no shadow buffer.
+	uint8_t*		text_dirty_;		// one flag per row of text_mem_rows_, kept at the end of the text_shadow_ allocation: non-zero if the row may have changed in the shadow buffer since the last Text_FlushShadow(). NULL if no shadow buffer.
+	TextWindow*		text_window_top_;	// topmost open text window on this screen, or NULL. see text_window.h
 	char*			text_font_ram_;		// 2K of memory holding font definitions.
 	char*			text_color_fore_ram_;	// 64b of memory holding foreground color LUTs for text mode, in BGRA order
 	char*			text_color_back_ram_;	// 64b of memory holding background color LUTs for text mode, in BGRA order
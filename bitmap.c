@@ -45,10 +45,32 @@
 
 
 
+/*****************************************************************************/
+/*                                 Structs                                   */
+/*****************************************************************************/
+
+//! One non-horizontal edge of a polygon being filled. x is 16.16 fixed point.
+struct BitmapEdge
+{
+	int16_t		y_top_;			// first scanline the edge crosses
+	int16_t		y_bottom_;		// first scanline below the edge
+	int16_t		x_;				// first pixel at or right of where the edge crosses the current scanline. the exact crossing is x_ - err_ / height_.
+	int16_t		err_;			// how far left of x_ the exact crossing is, in 1/height_ pixels. 0 to height_ - 1.
+	int16_t		x_step_;		// whole pixels the crossing moves from one scanline to the next, rounded down
+	int16_t		err_step_;		// the rest of the move, in 1/height_ pixels. 0 to height_ - 1.
+	int16_t		height_;		// number of scanlines from the top of the edge to the bottom, before any clipping
+	int8_t		winding_;		// 1 if the edge goes down, -1 if it goes up
+};
+
+
+
 /*****************************************************************************/
 /*                             Global Variables                              */
 /*****************************************************************************/
 
+static uint32_t				bitmap_bytes_blitted = 0;	// running total of bytes copied by Bitmap_Blit(), for performance measurement
+static struct BitmapEdge	bitmap_edges[BITMAP_MAX_POLYGON_POINTS];	// edge table for Bitmap_FillPolygon(), sorted by y_top_
+static struct BitmapEdge*	bitmap_active_edges[BITMAP_MAX_POLYGON_POINTS];	// edges crossing the current scanline, sorted by x_
 
 
 /*****************************************************************************/
@@ -74,13 +96,25 @@ unsigned char* Bitmap_GetMemLocForXY(Bitmap* the_bitmap, int16_t x, int16_t y);
 //! @return Returns an unsigned long that can be converted to the VRAM location that corresponds to the passed X, Y, or NULL on any error condition
 uint32_t Bitmap_GetMemLocIntForXY(Bitmap* the_bitmap, int16_t x, int16_t y);
 
-//! Draw 1 to 4 quadrants of a circle
-//! Only the specified quadrants will be drawn. This makes it possible to use this to make round rects, by only passing 1 quadrant.
-//! Based on http://rosettacode.org/wiki/Bitmap/Midpoint_circle_algorithm#C
-bool Bitmap_DrawCircleQuadrants(Bitmap* the_bitmap, int16_t x1, int16_t y1, int16_t radius, uint8_t the_color, bool ne, bool se, bool sw, bool nw);
+//! Fill one row of pixels from x1 to x2, clipped to the bitmap. This is the row-fill kernel every round shape is drawn with.
+//! @param	the_color: a 1-byte index to the current LUT
+void Bitmap_FillSpan(Bitmap* the_bitmap, int16_t x1, int16_t x2, int16_t y, uint8_t the_color);
+
+//! Draw an ellipse that may be stretched apart horizontally and vertically, as horizontal spans
+//! The left half is centered on cx_left, the right half on cx_right, the top half on cy_top, and the bottom half on cy_bottom, with straight edges joining them.
+//! With cx_left == cx_right and cy_top == cy_bottom, this is a plain ellipse (or a circle, if radius_x == radius_y). Stretched, it is a round rect.
+//! NO VALIDATION PERFORMED ON PARAMETERS, other than clipping each span. CALLING METHOD MUST VALIDATE.
+void Bitmap_DrawRoundSpans(Bitmap* the_bitmap, int16_t cx_left, int16_t cy_top, int16_t cx_right, int16_t cy_bottom, int16_t radius_x, int16_t radius_y, uint8_t the_color, bool do_fill);
+
+// draw a line between 2 points, clipped to the bitmap, stepping a pointer through bitmap memory
+void Bitmap_DrawClippedLine(Bitmap* the_bitmap, int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint8_t the_color, bool skip_first);
+
+// fill a polygon, one scanline at a time, from an edge table
+void Bitmap_FillPolygonScanlines(Bitmap* the_bitmap, Coordinate* the_points, int16_t num_points, uint8_t the_color, bool use_nonzero);
+
+// combine a row of source pixels, or a solid color, into a row of destination pixels, using the passed raster operation
+void Bitmap_RopRow(uint8_t* the_write_loc, uint8_t* the_read_loc, uint8_t the_color, int16_t the_len, bitmap_rop the_rop);
 
-//! Perform a flood fill starting at the coordinate passed. 
-bool Bitmap_Fill(Bitmap* the_bitmap, int16_t x, int16_t y, uint8_t the_color);
 
 // **** Debug functions *****
 
@@ -117,107 +151,664 @@ bool Bitmap_ValidateXY(Bitmap* the_bitmap, int16_t x, int16_t y)
 }
 
 
-//! Draw 1 to 4 quadrants of a circle
-//! Only the specified quadrants will be drawn. This makes it possible to use this to make round rects, by only passing 1 quadrant.
-//! NO VALIDATION PERFORMEND ON PARAMETERS. CALLING METHOD MUST VALIDATE.
-//! Based on http://rosettacode.org/wiki/Bitmap/Midpoint_circle_algorithm#C
-bool Bitmap_DrawCircleQuadrants(Bitmap* the_bitmap, int16_t x1, int16_t y1, int16_t radius, uint8_t the_color, bool ne, bool se, bool sw, bool nw)
+//! Fill one row of pixels from x1 to x2, clipped to the bitmap. This is the row-fill kernel every round shape is drawn with.
+//! @param	the_color: a 1-byte index to the current LUT
+void Bitmap_FillSpan(Bitmap* the_bitmap, int16_t x1, int16_t x2, int16_t y, uint8_t the_color)
+{
+	uint8_t*	the_write_loc;
+	
+	if (y < 0 || y >= the_bitmap->height_)
+	{
+		return;
+	}
+	
+	if (x1 < 0)
+	{
+		x1 = 0;
+	}
+	
+	if (x2 >= the_bitmap->width_)
+	{
+		x2 = the_bitmap->width_ - 1;
+	}
+	
+	if (x1 > x2)
+	{
+		return;
+	}
+	
+	the_write_loc = (uint8_t*)(the_bitmap->addr_int_ + ((uint32_t)the_bitmap->width_ * (uint32_t)y) + (uint32_t)x1);
+
+	#ifdef _C256_FMX_
+		int16_t i;
+		for (i = x1; i <= x2; i++)
+		{
+			*the_write_loc++ = the_color;
+		}
+	#else
+		memset(the_write_loc, the_color, x2 - x1 + 1);
+	#endif
+}
+
+
+//! Draw an ellipse that may be stretched apart horizontally and vertically, as horizontal spans
+//! The left half is centered on cx_left, the right half on cx_right, the top half on cy_top, and the bottom half on cy_bottom, with straight edges joining them.
+//! With cx_left == cx_right and cy_top == cy_bottom, this is a plain ellipse (or a circle, if radius_x == radius_y). Stretched, it is a round rect.
+//! NO VALIDATION PERFORMED ON PARAMETERS, other than clipping each span. CALLING METHOD MUST VALIDATE.
+void Bitmap_DrawRoundSpans(Bitmap* the_bitmap, int16_t cx_left, int16_t cy_top, int16_t cx_right, int16_t cy_bottom, int16_t radius_x, int16_t radius_y, uint8_t the_color, bool do_fill)
+{
+	uint32_t	rx = (uint32_t)radius_x;
+	uint32_t	ry = (uint32_t)radius_y;
+	uint32_t	the_limit;
+	uint32_t	the_numerator;
+	int16_t		dy;
+	int16_t		half_width = 0;
+	int16_t		prev_half_width = 0;
+	int16_t		inner_x;
+	int16_t		y;
+	
+	// LOGIC:
+	//   for each row dy away from the center, find the half width of the ellipse: the biggest x with
+	//     x^2 * ry^2 + dy^2 * rx^2 <= rx^2 * ry^2 + rx * ry * (rx + ry) / 2
+	//   for a circle, that is x^2 + dy^2 <= r^2 + r, the same rounding the midpoint circle algorithm uses. x is kept to no more than rx, so a flat ellipse doesn't poke out past its radius.
+	//   going from the top row (dy = ry) in to the middle row (dy = 0), the half width only grows, so it is found by stepping, not by a square root.
+	//   a filled shape is then one span per row. an outline is the part of each row outside the row above it, so it is 2 short spans per row, and stays connected.
+	//   the math fits in 32 bits as long as the radii are no more than BITMAP_MAX_RADIUS.
+	
+	for (dy = radius_y; dy >= 0; dy--)
+	{
+		if (ry == 0)
+		{
+			the_limit = rx * rx;
+		}
+		else
+		{
+			// x^2 <= rx * (rx * (ry^2 - dy^2) + ry * (rx + ry) / 2) / ry^2, divided in 2 steps so nothing overflows
+			the_numerator = rx * (ry * ry - (uint32_t)dy * dy) + ry * (rx + ry) / 2;
+			the_limit = ((the_numerator / ry) * rx + (the_numerator % ry) * rx / ry) / ry;
+		}
+		
+		while (half_width < radius_x && (uint32_t)(half_width + 1) * (uint32_t)(half_width + 1) <= the_limit)
+		{
+			half_width++;
+		}
+		
+		if (do_fill || dy == radius_y)
+		{
+			// the top and bottom rows of an outline are solid, the same as for a filled shape
+			Bitmap_FillSpan(the_bitmap, cx_left - half_width, cx_right + half_width, cy_top - dy, the_color);
+
+			if (dy != 0 || cy_top != cy_bottom)
+			{
+				Bitmap_FillSpan(the_bitmap, cx_left - half_width, cx_right + half_width, cy_bottom + dy, the_color);
+			}
+		}
+		else
+		{
+			inner_x = (prev_half_width + 1 < half_width) ? prev_half_width + 1 : half_width;
+			
+			Bitmap_FillSpan(the_bitmap, cx_left - half_width, cx_left - inner_x, cy_top - dy, the_color);
+			Bitmap_FillSpan(the_bitmap, cx_right + inner_x, cx_right + half_width, cy_top - dy, the_color);
+
+			if (dy != 0 || cy_top != cy_bottom)
+			{
+				Bitmap_FillSpan(the_bitmap, cx_left - half_width, cx_left - inner_x, cy_bottom + dy, the_color);
+				Bitmap_FillSpan(the_bitmap, cx_right + inner_x, cx_right + half_width, cy_bottom + dy, the_color);
+			}
+		}
+		
+		prev_half_width = half_width;
+	}
+	
+	// the straight sides between the top and bottom halves, if stretched vertically
+	for (y = cy_top + 1; y < cy_bottom; y++)
+	{
+		if (do_fill)
+		{
+			Bitmap_FillSpan(the_bitmap, cx_left - half_width, cx_right + half_width, y, the_color);
+		}
+		else
+		{
+			Bitmap_FillSpan(the_bitmap, cx_left - half_width, cx_left - half_width, y, the_color);
+			Bitmap_FillSpan(the_bitmap, cx_right + half_width, cx_right + half_width, y, the_color);
+		}
+	}
+}
+
+
+//! Draw a line between 2 points, clipped to the bitmap, stepping a pointer through bitmap memory
+//! The pixels drawn are the same whether or not the line is clipped, so a line that moves partly off the bitmap doesn't shift.
+//! @param	skip_first: if true, the pixel at x1, y1 is not drawn. Used by polylines, so the joins between segments aren't drawn twice.
+//! NO VALIDATION PERFORMED ON PARAMETERS, other than clipping. CALLING METHOD MUST VALIDATE. The line can't run more than BITMAP_MAX_LINE_SPAN pixels in either direction.
+void Bitmap_DrawClippedLine(Bitmap* the_bitmap, int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint8_t the_color, bool skip_first)
 {
-    int	f;
-    int	ddF_x;
-    int	ddF_y;
-    int	x;
-    int	y;
- 
-	f = 1 - radius;
-	ddF_x = 0;
-	ddF_y = -2 * radius;
-	x = 0;
-	y = radius;
+	int32_t		major_len;
+	int32_t		minor_len;
+	int32_t		major_lo;
+	int32_t		major_hi;
+	int32_t		minor_lo;
+	int32_t		minor_hi;
+	int32_t		first_step;
+	int32_t		last_step;
+	int32_t		the_limit;
+	int32_t		major_inc;
+	int32_t		minor_inc;
+	uint32_t	the_err;
+	uint32_t	minor_offset;
+	int16_t		sx = (x1 < x2) ? 1 : -1;
+	int16_t		sy = (y1 < y2) ? 1 : -1;
+	int16_t		x;
+	int16_t		y;
+	int16_t		the_count;
+	bool		is_x_major;
+	uint8_t*	the_write_loc;
+	
+	// LOGIC:
+	//   the pixel drawn at step i (0 to major_len) is i steps along the major axis (whichever of x and y the line is longer in),
+	//     and (2 * i * minor_len + major_len) / (2 * major_len) steps along the minor axis. that is Bresenham's line, in closed form.
+	//   clipping works out which steps land on the bitmap, once, up front. each edge of the bitmap cuts a range of steps,
+	//     directly for the major axis, and by inverting the formula above for the minor axis. the line is not moved to the edge, so it doesn't shift.
+	//   after that, the loop only writes a byte and moves a pointer: +/-1 for a step in x, +/-width for a step in y.
+	//   horizontal lines are a memset, vertical lines and diagonals don't need the error term at all.
+	//   the math fits in 32 bits as long as the line is no more than BITMAP_MAX_LINE_SPAN pixels long in either direction
+	
+	is_x_major = (abs(x2 - x1) >= abs(y2 - y1));
+	
+	if (is_x_major)
+	{
+		major_len = abs(x2 - x1);
+		minor_len = abs(y2 - y1);
+		major_lo = (sx > 0) ? -x1 : x1 - (the_bitmap->width_ - 1);
+		major_hi = (sx > 0) ? the_bitmap->width_ - 1 - x1 : x1;
+		minor_lo = (sy > 0) ? -y1 : y1 - (the_bitmap->height_ - 1);
+		minor_hi = (sy > 0) ? the_bitmap->height_ - 1 - y1 : y1;
+		major_inc = sx;
+		minor_inc = sy * (int32_t)the_bitmap->width_;
+	}
+	else
+	{
+		major_len = abs(y2 - y1);
+		minor_len = abs(x2 - x1);
+		major_lo = (sy > 0) ? -y1 : y1 - (the_bitmap->height_ - 1);
+		major_hi = (sy > 0) ? the_bitmap->height_ - 1 - y1 : y1;
+		minor_lo = (sx > 0) ? -x1 : x1 - (the_bitmap->width_ - 1);
+		minor_hi = (sx > 0) ? the_bitmap->width_ - 1 - x1 : x1;
+		major_inc = sy * (int32_t)the_bitmap->width_;
+		minor_inc = sx;
+	}
+	
+	// steps that are on the bitmap along the major axis
+	first_step = (skip_first) ? 1 : 0;
+	first_step = (major_lo > first_step) ? major_lo : first_step;
+	last_step = (major_hi < major_len) ? major_hi : major_len;
 
-	if (se || sw)
+	// steps that are on the bitmap along the minor axis
+	if (minor_hi < 0 || minor_lo > minor_len)
 	{
-		Bitmap_SetPixelAtXY(the_bitmap, x1, y1 + radius, the_color);
+		return;
 	}
-	if (ne || nw)
+	
+	if (minor_lo > 0)
 	{
-		Bitmap_SetPixelAtXY(the_bitmap, x1, y1 - radius, the_color);
+		// first step where (2 * i * minor_len + major_len) / (2 * major_len) >= minor_lo
+		the_limit = (major_len * (2 * minor_lo - 1) + 2 * minor_len - 1) / (2 * minor_len);
+		first_step = (the_limit > first_step) ? the_limit : first_step;
 	}
-	if (se || ne)
+	
+	if (minor_hi < minor_len)
+	{
+		// last step where (2 * i * minor_len + major_len) / (2 * major_len) <= minor_hi
+		the_limit = (major_len * (2 * minor_hi + 1) - 1) / (2 * minor_len);
+		last_step = (the_limit < last_step) ? the_limit : last_step;
+	}
+	
+	if (first_step > last_step)
+	{
+		return;
+	}
+
+	// find the first pixel on the bitmap, and the error term at that pixel
+	if (major_len == 0)
 	{
-		Bitmap_SetPixelAtXY(the_bitmap, x1 + radius, y1, the_color);
+		minor_offset = 0;
+		the_err = 0;
 	}
-	if (nw || sw)
+	else
 	{
-		Bitmap_SetPixelAtXY(the_bitmap, x1 - radius, y1, the_color);
+		the_err = 2 * (uint32_t)first_step * (uint32_t)minor_len + (uint32_t)major_len;
+		minor_offset = the_err / (2 * (uint32_t)major_len);
+		the_err = the_err % (2 * (uint32_t)major_len);
 	}
- 
-    while(x < y) 
+	
+	if (is_x_major)
 	{
-		if(f >= 0) 
+		x = x1 + sx * (int16_t)first_step;
+		y = y1 + sy * (int16_t)minor_offset;
+	}
+	else
+	{
+		x = x1 + sx * (int16_t)minor_offset;
+		y = y1 + sy * (int16_t)first_step;
+	}
+	
+	the_write_loc = (uint8_t*)(the_bitmap->addr_int_ + ((uint32_t)the_bitmap->width_ * (uint32_t)y) + (uint32_t)x);
+	the_count = last_step - first_step + 1;
+	
+	if (minor_len == 0 && is_x_major)
+	{
+		// horizontal
+		if (sx < 0)
 		{
-			y--;
-			ddF_y += 2;
-			f += ddF_y;
+			the_write_loc -= the_count - 1;
 		}
 
-		x++;
-		ddF_x += 2;
-		f += ddF_x + 1;  
- 
- 		if (se)
-        {
-			Bitmap_SetPixelAtXY(the_bitmap, x1 + x, y1 + y, the_color);
-			Bitmap_SetPixelAtXY(the_bitmap, x1 + y, y1 + x, the_color);
-        }
- 
- 		if (sw)
-        {
-			Bitmap_SetPixelAtXY(the_bitmap, x1 - x, y1 + y, the_color);
-			Bitmap_SetPixelAtXY(the_bitmap, x1 - y, y1 + x, the_color);
-        }
- 
- 		if (ne)
-        {
-			Bitmap_SetPixelAtXY(the_bitmap, x1 + x, y1 - y, the_color);
-			Bitmap_SetPixelAtXY(the_bitmap, x1 + y, y1 - x, the_color);
-        }
- 
- 		if (nw)
-        {
-			Bitmap_SetPixelAtXY(the_bitmap, x1 - x, y1 - y, the_color);
-			Bitmap_SetPixelAtXY(the_bitmap, x1 - y, y1 - x, the_color);
-        }
-    }
-    
-    return true;
+		#ifdef _C256_FMX_
+			for (; the_count > 0; the_count--)
+			{
+				*the_write_loc++ = the_color;
+			}
+		#else
+			memset(the_write_loc, the_color, the_count);
+		#endif
+	}
+	else if (minor_len == 0 || minor_len == major_len)
+	{
+		// vertical, or 45 degrees: every step moves the same way
+		major_inc = (minor_len == 0) ? major_inc : major_inc + minor_inc;
+
+		for (; the_count > 0; the_count--)
+		{
+			*the_write_loc = the_color;
+			the_write_loc += major_inc;
+		}
+	}
+	else
+	{
+		for (; the_count > 0; the_count--)
+		{
+			*the_write_loc = the_color;
+			the_write_loc += major_inc;
+			the_err += 2 * minor_len;
+			
+			if (the_err >= 2 * (uint32_t)major_len)
+			{
+				the_err -= 2 * major_len;
+				the_write_loc += minor_inc;
+			}
+		}
+	}
 }
 
 
-//! Perform a flood fill starting at the coordinate passed. 
-//! WARNING: this function is recursive, and if applied to a size even 1/10th the size of the screen, it can eat the stack. Either do not use this, or control its usage to just situations you can control. Or set an enormous stack size when building your app.
-//! @param	the_color: a 1-byte index to the current LUT
-bool Bitmap_Fill(Bitmap* the_bitmap, int16_t x, int16_t y, uint8_t the_color)
-{   
-	int16_t	height;
-	int16_t	width;
+//! Fill a polygon, one scanline at a time, from an edge table
+//! @param	use_nonzero: if true, fill areas the outline winds around any number of times other than 0. if false, fill areas it winds around an odd number of times.
+//! NO VALIDATION PERFORMED ON PARAMETERS, other than clipping each span. CALLING METHOD MUST VALIDATE. Points must be within +/- BITMAP_MAX_POLYGON_COORD.
+void Bitmap_FillPolygonScanlines(Bitmap* the_bitmap, Coordinate* the_points, int16_t num_points, uint8_t the_color, bool use_nonzero)
+{
+	struct BitmapEdge*	the_edge;
+	struct BitmapEdge	temp_edge;
+	int16_t				num_edges = 0;
+	int16_t				num_active = 0;
+	int16_t				next_edge = 0;
+	int16_t				i;
+	int16_t				j;
+	int16_t				y;
+	int16_t				y_end;
+	int16_t				x1;
+	int16_t				y1;
+	int16_t				x2;
+	int16_t				y2;
+	int16_t				the_winding;
+	int16_t				span_start;
+	int32_t				the_offset;
 	
-	width = the_bitmap->width_;
-	height = the_bitmap->height_;
-
-    if ( 0 <= y && y < height && 0 <= x && x < width && Bitmap_GetPixelAtXY(the_bitmap, x, y) != the_color )
-    {
-        Bitmap_SetPixelAtXY(the_bitmap, x, y, the_color);
-        Bitmap_Fill(the_bitmap, x-1, y, the_color);
-        Bitmap_Fill(the_bitmap, x+1, y, the_color);
-        Bitmap_Fill(the_bitmap, x, y-1, the_color);
-        Bitmap_Fill(the_bitmap, x, y+1, the_color);
-    }    
-    
-    return true;
+	// LOGIC:
+	//   a pixel is inside if its top left corner is inside the polygon. that way, polygons that share an edge don't both draw it,
+	//     and a polygon with corners at (0, 0) and (10, 10) covers exactly 10 x 10 pixels.
+	//   each edge covers scanlines from its top y to the one before its bottom y. horizontal edges cover none, and are dropped.
+	//   the edge table is sorted by top y. going down the scanlines, edges join the active list when they start and leave it when they end.
+	//   each edge keeps the first pixel at or right of where it crosses the scanline, plus an exact remainder, and steps them like a Bresenham line.
+	//     so there is no division per scanline, and no rounding error builds up down a long edge: the crossing is always the exact one.
+	//   the active list is kept sorted by x with an insertion sort, which is cheap because the order hardly changes from one scanline to the next.
+	//   each scanline is then filled as spans between pairs of edges (even-odd), or wherever the running winding count is not 0 (non-zero).
+	
+	// build the edge table
+	for (i = 0; i < num_points; i++)
+	{
+		x1 = the_points[i].x;
+		y1 = the_points[i].y;
+		x2 = the_points[(i + 1) % num_points].x;
+		y2 = the_points[(i + 1) % num_points].y;
+		
+		if (y1 == y2)
+		{
+			continue;
+		}
+		
+		the_winding = (y1 < y2) ? 1 : -1;
+		
+		if (y1 > y2)
+		{
+			x1 = the_points[(i + 1) % num_points].x;
+			y1 = the_points[(i + 1) % num_points].y;
+			x2 = the_points[i].x;
+			y2 = the_points[i].y;
+		}
+		
+		// edges entirely above or below the bitmap can't affect any scanline that gets drawn
+		if (y2 <= 0 || y1 >= the_bitmap->height_)
+		{
+			continue;
+		}
+		
+		the_edge = &bitmap_edges[num_edges++];
+		the_edge->winding_ = the_winding;
+
+		the_edge->y_top_ = y1;
+		the_edge->y_bottom_ = y2;
+		the_edge->height_ = y2 - y1;
+		the_edge->x_step_ = (x2 - x1) / the_edge->height_;
+		the_edge->err_step_ = (x2 - x1) % the_edge->height_;
+		
+		if (the_edge->err_step_ < 0)
+		{
+			the_edge->x_step_--;
+			the_edge->err_step_ += the_edge->height_;
+		}
+		
+		the_edge->x_ = x1;
+		the_edge->err_ = 0;
+		
+		// edges that start above the bitmap are moved down to its top row, where they cross at x1 + (x2 - x1) * (0 - y1) / height_
+		if (y1 < 0)
+		{
+			the_offset = (int32_t)(x2 - x1) * (int32_t)(0 - y1);
+			the_edge->x_ = x1 + (int16_t)(the_offset / the_edge->height_);
+			the_edge->err_ = (int16_t)(the_offset % the_edge->height_);
+			
+			// round the crossing up to the next whole pixel, and keep how far it was rounded
+			if (the_edge->err_ > 0)
+			{
+				the_edge->x_++;
+				the_edge->err_ = the_edge->height_ - the_edge->err_;
+			}
+			else
+			{
+				the_edge->err_ = 0 - the_edge->err_;
+			}
+			
+			the_edge->y_top_ = 0;
+		}
+		
+		// insertion sort by top y
+		temp_edge = *the_edge;
+		
+		for (j = num_edges - 1; j > 0 && bitmap_edges[j - 1].y_top_ > temp_edge.y_top_; j--)
+		{
+			bitmap_edges[j] = bitmap_edges[j - 1];
+		}
+		
+		bitmap_edges[j] = temp_edge;
+	}
+	
+	if (num_edges == 0)
+	{
+		return;
+	}
+	
+	y_end = the_bitmap->height_;
+	
+	for (y = bitmap_edges[0].y_top_; y < y_end; y++)
+	{
+		// drop edges that have ended
+		for (i = 0, j = 0; i < num_active; i++)
+		{
+			if (bitmap_active_edges[i]->y_bottom_ > y)
+			{
+				bitmap_active_edges[j++] = bitmap_active_edges[i];
+			}
+		}
+		
+		num_active = j;
+		
+		// add edges that start on this scanline
+		while (next_edge < num_edges && bitmap_edges[next_edge].y_top_ == y)
+		{
+			bitmap_active_edges[num_active++] = &bitmap_edges[next_edge++];
+		}
+		
+		if (num_active == 0)
+		{
+			if (next_edge >= num_edges)
+			{
+				break;
+			}
+			
+			// nothing to draw until the next edge starts
+			y = bitmap_edges[next_edge].y_top_ - 1;
+			continue;
+		}
+		
+		// insertion sort by x
+		for (i = 1; i < num_active; i++)
+		{
+			the_edge = bitmap_active_edges[i];
+			
+			for (j = i; j > 0 && bitmap_active_edges[j - 1]->x_ > the_edge->x_; j--)
+			{
+				bitmap_active_edges[j] = bitmap_active_edges[j - 1];
+			}
+			
+			bitmap_active_edges[j] = the_edge;
+		}
+		
+		// fill spans. a span starts at the first pixel whose left edge is at or right of where the edge crosses, and runs up to, but not including, the pixel where the next edge crosses
+		if (use_nonzero)
+		{
+			the_winding = 0;
+			span_start = 0;
+
+			for (i = 0; i < num_active; i++)
+			{
+				if (the_winding == 0)
+				{
+					span_start = bitmap_active_edges[i]->x_;
+				}
+
+				the_winding += bitmap_active_edges[i]->winding_;
+				
+				if (the_winding == 0)
+				{
+					Bitmap_FillSpan(the_bitmap, span_start, bitmap_active_edges[i]->x_ - 1, y, the_color);
+				}
+			}
+		}
+		else
+		{
+			for (i = 0; i + 1 < num_active; i += 2)
+			{
+				Bitmap_FillSpan(the_bitmap, bitmap_active_edges[i]->x_, bitmap_active_edges[i + 1]->x_ - 1, y, the_color);
+			}
+		}
+		
+		// step to the next scanline. the crossing moves right by x_step_ + err_step_ / height_; if that takes it past x_ - 1, x_ moves one more.
+		for (i = 0; i < num_active; i++)
+		{
+			the_edge = bitmap_active_edges[i];
+			the_edge->x_ += the_edge->x_step_;
+			the_edge->err_ -= the_edge->err_step_;
+			
+			if (the_edge->err_ < 0)
+			{
+				the_edge->x_++;
+				the_edge->err_ += the_edge->height_;
+			}
+		}
+	}
 }
 
 
+//! Combine a row of source pixels, or a solid color, into a row of destination pixels, using the passed raster operation
+//! Works 4 pixels at a time wherever the source and destination line up on 4-byte boundaries.
+//! @param	the_read_loc: the source row, or NULL to use the_color for every source pixel
+//! NO VALIDATION PERFORMED ON PARAMETERS. CALLING METHOD MUST VALIDATE. If the rows overlap, the destination must not start inside the source.
+void Bitmap_RopRow(uint8_t* the_write_loc, uint8_t* the_read_loc, uint8_t the_color, int16_t the_len, bitmap_rop the_rop)
+{
+	uint32_t*	the_write_long;
+	uint32_t*	the_read_long;
+	uint32_t	the_color_long;
+	int16_t		num_longs = 0;
+	int16_t		i;
+	
+	// LOGIC:
+	//   with a solid color, every op is a fill, an AND, an OR, or an XOR with a constant: NOT-src is a fill with ~color, and invert-dest is an XOR with 0xff.
+	//   with a source row, invert-dest ignores the source, so it is the same as with a solid color.
+	//   the op is chosen once per row, not once per pixel. within the row, bytes are done one at a time until the destination is on a 4-byte boundary,
+	//     then 4 at a time, then any left over one at a time. if the source can't be put on a 4-byte boundary at the same time, the whole row is done a byte at a time.
+	
+	if (the_rop == ROP_INVERT)
+	{
+		the_read_loc = NULL;
+		the_color = 0xff;
+		the_rop = ROP_XOR;
+	}
+	else if (the_read_loc == NULL && the_rop == ROP_NOT_SRC)
+	{
+		the_color = ~the_color;
+		the_rop = ROP_COPY;
+	}
+	
+	if (the_rop == ROP_COPY)
+	{
+		#ifdef _C256_FMX_
+			if (the_read_loc == NULL)
+			{
+				for (i = 0; i < the_len; i++)
+				{
+					*the_write_loc++ = the_color;
+				}
+			}
+			else
+			{
+				for (i = 0; i < the_len; i++)
+				{
+					*the_write_loc++ = *the_read_loc++;
+				}
+			}
+		#else
+			if (the_read_loc == NULL)
+			{
+				memset(the_write_loc, the_color, the_len);
+			}
+			else
+			{
+				memmove(the_write_loc, the_read_loc, the_len);
+			}
+		#endif
+		
+		return;
+	}
+	
+	#ifndef _C256_FMX_
+		if (the_len >= 8 && (the_read_loc == NULL || (((uint32_t)the_read_loc ^ (uint32_t)the_write_loc) & 3) == 0))
+		{
+			// bring the destination to a 4-byte boundary, then do the bulk of the row 4 pixels at a time
+			i = (4 - ((uint32_t)the_write_loc & 3)) & 3;
+			Bitmap_RopRow(the_write_loc, the_read_loc, the_color, i, the_rop);
+			the_write_loc += i;
+			the_read_loc = (the_read_loc == NULL) ? NULL : the_read_loc + i;
+			the_len -= i;
+			
+			num_longs = the_len >> 2;
+			the_write_long = (uint32_t*)the_write_loc;
+			the_read_long = (uint32_t*)the_read_loc;
+			the_color_long = (uint32_t)the_color * 0x01010101UL;
+			
+			if (the_read_loc == NULL)
+			{
+				switch (the_rop)
+				{
+					case ROP_XOR:
+						for (i = 0; i < num_longs; i++)	*the_write_long++ ^= the_color_long;
+						break;
+					case ROP_OR:
+						for (i = 0; i < num_longs; i++)	*the_write_long++ |= the_color_long;
+						break;
+					case ROP_AND:
+						for (i = 0; i < num_longs; i++)	*the_write_long++ &= the_color_long;
+						break;
+					default:
+						break;
+				}
+			}
+			else
+			{
+				switch (the_rop)
+				{
+					case ROP_XOR:
+						for (i = 0; i < num_longs; i++)	*the_write_long++ ^= *the_read_long++;
+						break;
+					case ROP_OR:
+						for (i = 0; i < num_longs; i++)	*the_write_long++ |= *the_read_long++;
+						break;
+					case ROP_AND:
+						for (i = 0; i < num_longs; i++)	*the_write_long++ &= *the_read_long++;
+						break;
+					case ROP_NOT_SRC:
+						for (i = 0; i < num_longs; i++)	*the_write_long++ = ~*the_read_long++;
+						break;
+					default:
+						break;
+				}
+				
+				the_read_loc += num_longs * 4;
+			}
+			
+			the_write_loc += num_longs * 4;
+			the_len -= num_longs * 4;
+		}
+	#endif
+	
+	// whatever is left, a byte at a time
+	if (the_read_loc == NULL)
+	{
+		switch (the_rop)
+		{
+			case ROP_XOR:
+				for (i = 0; i < the_len; i++)	*the_write_loc++ ^= the_color;
+				break;
+			case ROP_OR:
+				for (i = 0; i < the_len; i++)	*the_write_loc++ |= the_color;
+				break;
+			case ROP_AND:
+				for (i = 0; i < the_len; i++)	*the_write_loc++ &= the_color;
+				break;
+			default:
+				break;
+		}
+	}
+	else
+	{
+		switch (the_rop)
+		{
+			case ROP_XOR:
+				for (i = 0; i < the_len; i++)	*the_write_loc++ ^= *the_read_loc++;
+				break;
+			case ROP_OR:
+				for (i = 0; i < the_len; i++)	*the_write_loc++ |= *the_read_loc++;
+				break;
+			case ROP_AND:
+				for (i = 0; i < the_len; i++)	*the_write_loc++ &= *the_read_loc++;
+				break;
+			case ROP_NOT_SRC:
+				for (i = 0; i < the_len; i++)	*the_write_loc++ = ~*the_read_loc++;
+				break;
+			default:
+				break;
+		}
+	}
+}
+
 
 // **** Debug functions *****
 
@@ -234,6 +825,7 @@ void Bitmap_Print(Bitmap* the_bitmap)
 	DEBUG_OUT(("  font_: %p",			the_bitmap->font_));	
 	DEBUG_OUT(("  addr_: %p",			the_bitmap->addr_));
 	DEBUG_OUT(("  addr_int_: %lx",		the_bitmap->addr_int_));
+	DEBUG_OUT(("  alloc_size_: %lu",	the_bitmap->alloc_size_));
 }
 
 //! \endcond
@@ -292,6 +884,7 @@ Bitmap* Bitmap_New(int16_t width, int16_t height, Font* the_font, bool in_vram)
 		}
 		
 		the_bitmap->addr_int_ = (uint32_t)the_bitmap->addr_;
+		the_bitmap->alloc_size_ = (uint32_t)width * height;
 	}
 	else
 	{
@@ -343,9 +936,11 @@ bool Bitmap_Destroy(Bitmap** the_bitmap)
 		(*the_bitmap)->font_ = NULL;
 	}
 
+	// LOGIC:
+	//   VRAM bitmaps point into video memory that was never allocated; only normal-memory pixel storage is ours to free
 	if ((*the_bitmap)->addr_)
 	{
-		if ((*the_bitmap)->in_vram_)
+		if ((*the_bitmap)->in_vram_ == false)
 		{
 			free((*the_bitmap)->addr_);
 		}
@@ -367,8 +962,7 @@ bool Bitmap_Destroy(Bitmap** the_bitmap)
 //! @return	Returns false in any error condition
 bool Bitmap_Resize(Bitmap* the_bitmap, int16_t width, int16_t height)
 {
-	size_t	old_size;
-	size_t	new_size;
+	uint32_t	new_size;
 	
 	if (the_bitmap == NULL)
 	{
@@ -378,16 +972,16 @@ bool Bitmap_Resize(Bitmap* the_bitmap, int16_t width, int16_t height)
 
 	DEBUG_OUT(("%s %d: start bitmap resizing; old = %i x %i; new=%i x %i", __func__, __LINE__, the_bitmap->width_, the_bitmap->height_, width, height));
 
-	old_size = the_bitmap->width_ * the_bitmap->height_;
-	new_size = width * height;
+	new_size = (uint32_t)width * height;
 	
 	the_bitmap->width_ = width;
 	the_bitmap->height_ = height;
 	
-	// Reallocate bitmap only if both are true:
+	// Reallocate bitmap only if all are true:
 	//   window is not in VRAM. we only store backdrop in VRAM, and it shares same bitmap as the screen.
-	//   window got LARGER. if it got smaller, we can just keep reusing same bitmap and not worry about the extra space.
-	if (the_bitmap->in_vram_ == false && new_size > old_size)
+	//   window needs more than is allocated. if it got smaller, or grew back within a size it had before, we can just keep reusing same bitmap and not worry about the extra space.
+	//   storage hasn't been released. if it was, it will be allocated at the new size when restored.
+	if (the_bitmap->in_vram_ == false && new_size > the_bitmap->alloc_size_ && the_bitmap->addr_ != NULL)
 	{
 		if (the_bitmap->addr_)
 		{
@@ -397,16 +991,79 @@ bool Bitmap_Resize(Bitmap* the_bitmap, int16_t width, int16_t height)
 		if ((the_bitmap->addr_ = calloc(sizeof(uint8_t), width * height)) == NULL)
 		{
 			LOG_ERR(("%s %d: Couldn't instantiate a bitmap", __func__, __LINE__));
+			the_bitmap->addr_int_ = 0;
+			the_bitmap->alloc_size_ = 0;
 			return false;
 		}
 		
 		the_bitmap->addr_int_ = (uint32_t)the_bitmap->addr_;
+		the_bitmap->alloc_size_ = new_size;
 	}
 	
 	return true;
 }
 
 
+//! Free the pixel storage of a bitmap held in standard RAM, keeping the bitmap object and its dimensions
+//! NOTE: until Bitmap_RestoreStorage() is called, nothing may be drawn into or blitted from the bitmap
+//! @return	Returns false in any error condition, including if the bitmap is held in VRAM
+bool Bitmap_ReleaseStorage(Bitmap* the_bitmap)
+{
+	if (the_bitmap == NULL)
+	{
+		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
+		return false;
+	}
+	
+	if (the_bitmap->in_vram_)
+	{
+		LOG_ERR(("%s %d: storage for bitmaps in VRAM can't be released", __func__ , __LINE__));
+		return false;
+	}
+	
+	if (the_bitmap->addr_)
+	{
+		LOG_ALLOC(("%s %d:	__FREE__	the_bitmap->addr_	%p	size	%lu", __func__ , __LINE__, the_bitmap->addr_, the_bitmap->alloc_size_));
+		free(the_bitmap->addr_);
+		the_bitmap->addr_ = NULL;
+		the_bitmap->addr_int_ = 0;
+		the_bitmap->alloc_size_ = 0;
+	}
+	
+	return true;
+}
+
+
+//! Re-allocate (cleared) pixel storage for a bitmap whose storage was freed with Bitmap_ReleaseStorage(), at its current width/height
+//! @return	Returns false in any error condition
+bool Bitmap_RestoreStorage(Bitmap* the_bitmap)
+{
+	if (the_bitmap == NULL)
+	{
+		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
+		return false;
+	}
+	
+	if (the_bitmap->in_vram_ || the_bitmap->addr_ != NULL)
+	{
+		// nothing was released
+		return true;
+	}
+	
+	if ((the_bitmap->addr_ = calloc(sizeof(uint8_t), the_bitmap->width_ * the_bitmap->height_)) == NULL)
+	{
+		LOG_ERR(("%s %d: Couldn't re-allocate storage for bitmap", __func__, __LINE__));
+		return false;
+	}
+	LOG_ALLOC(("%s %d:	__ALLOC__	the_bitmap->addr_	%p	size	%i", __func__ , __LINE__, the_bitmap->addr_, the_bitmap->width_ * the_bitmap->height_));
+	
+	the_bitmap->addr_int_ = (uint32_t)the_bitmap->addr_;
+	the_bitmap->alloc_size_ = (uint32_t)the_bitmap->width_ * the_bitmap->height_;
+	
+	return true;
+}
+
+
 
 
 // **** Block copy functions ****
@@ -438,18 +1095,37 @@ bool Bitmap_BlitRect(Bitmap* src_bm, Rectangle* src_rect, Bitmap* dst_bm, int16_
 
 //! Blit from source bitmap to distination bitmap. 
 //! The source and destination bitmaps can be the same: you can use this to copy a chunk of pixels from one part of a screen to another. If the destination location cannot fit the entirety of the copied rectangle, the copy will be truncated, but will not return an error. 
+//! The source and destination rects may overlap (eg, when scrolling the contents of a bitmap): the copy is done in an order that does not overwrite pixels before they are read.
 //! @param src_bm: the source bitmap. It must have a valid address within the VRAM memory space.
 //! @param dst_bm: the destination bitmap. It must have a valid address within the VRAM memory space. It can be the same bitmap as the source.
 //! @param src_x, src_y: the upper left coordinate within the source bitmap, for the rectangle you want to copy. May be negative.
 //! @param dst_x, dst_y: the location within the destination bitmap to copy pixels to. May be negative.
 //! @param width, height: the scope of the copy, in pixels.
 bool Bitmap_Blit(Bitmap* src_bm, int16_t src_x, int16_t src_y, Bitmap* dst_bm, int16_t dst_x, int16_t dst_y, int16_t width, int16_t height)
+{
+	return Bitmap_BlitRop(src_bm, src_x, src_y, dst_bm, dst_x, dst_y, width, height, ROP_COPY);
+}
+
+
+//! Blit from source bitmap to destination bitmap, combining the source pixels with the destination pixels using a raster operation
+//! Clipping, and overlapping source and destination rects, are handled the same as for Bitmap_Blit().
+//! XOR-ing the same source onto the same spot twice puts the destination back the way it was, so a highlight can be toggled on and off without redrawing what is under it.
+//! @param src_bm: the source bitmap. It must have a valid address within the VRAM memory space.
+//! @param dst_bm: the destination bitmap. It must have a valid address within the VRAM memory space. It can be the same bitmap as the source.
+//! @param src_x, src_y: the upper left coordinate within the source bitmap, for the rectangle you want to copy. May be negative.
+//! @param dst_x, dst_y: the location within the destination bitmap to copy pixels to. May be negative.
+//! @param width, height: the scope of the copy, in pixels.
+//! @param the_rop: how to combine each source pixel with the destination pixel. ROP_COPY is the same as Bitmap_Blit(). ROP_INVERT ignores the source.
+bool Bitmap_BlitRop(Bitmap* src_bm, int16_t src_x, int16_t src_y, Bitmap* dst_bm, int16_t dst_x, int16_t dst_y, int16_t width, int16_t height, bitmap_rop the_rop)
 {
 	uint32_t		the_read_loc_int;
 	uint32_t		the_write_loc_int;
 	uint8_t*		the_write_loc;
 	uint8_t*		the_read_loc;
 	uint32_t		copy_size;
+	uint32_t		i;
+	int32_t			read_step;
+	int32_t			write_step;
 	int16_t			j;
 	
 	// TODO: move the 2 checks below to a private common function if other blit functions are added
@@ -511,302 +1187,103 @@ bool Bitmap_Blit(Bitmap* src_bm, int16_t src_x, int16_t src_y, Bitmap* dst_bm, i
 	the_write_loc_int = dst_bm->addr_int_ + ((uint32_t)dst_bm->width_ * (uint32_t)dst_y) + (uint32_t)dst_x;
 	//DEBUG_OUT(("%s %d: the_read_loc_int=%i, the_write_loc_int=%i, copy_size=%lu", __func__, __LINE__, the_read_loc_int, the_write_loc_int, copy_size));
 	
-	for (j = 0; j < height; j++)
-	{
-		the_write_loc = (uint8_t*)the_write_loc_int;
-		the_read_loc = (uint8_t*)the_read_loc_int;
-		//DEBUG_OUT(("%s %d: the_read_loc=%p, the_write_loc=%p, copy_size=%lu", __func__, __LINE__, the_read_loc, the_write_loc, copy_size));
-
-		#ifdef _C256_FMX_
-			uint32_t i;
-			
-			for (i=0; i < copy_size; i++)
-			{
-				*the_write_loc = *the_read_loc;
-				the_write_loc++;
-				the_read_loc++;
-// 				the_write_loc_int++;			
-// 				the_read_loc_int++;			
-// 				the_write_loc = (uint8_t*)the_write_loc_int;
-// 				the_read_loc = (uint8_t*)the_read_loc_int;
-			}
-		#else
-			memcpy(the_write_loc, the_read_loc, copy_size);
-		#endif	
-		
-		the_write_loc_int += (uint32_t)dst_bm->width_;
-		the_read_loc_int += (uint32_t)src_bm->width_;
-	}
-
-	return true;
-}
-
-
-//! Tile the source bitmap into the destination bitmap, filling it
-//! The source and destination bitmaps can be the same: you can use this to copy a chunk of pixels from one part of a screen to another. If the destination location cannot fit the entirety of the copied rectangle, the copy will be truncated, but will not return an error. 
-//! @param src_bm: the source bitmap. It must have a valid address within the VRAM memory space.
-//! @param dst_bm: the destination bitmap. It must have a valid address within the VRAM memory space. It can be the same bitmap as the source.
-//! @param src_x, src_y: the upper left coordinate within the source bitmap, for the tile you want to copy. Must be non-negative.
-//! @param width, height: the size of the tile to be derived from the source bitmap, in pixels.
-bool Bitmap_Tile(Bitmap* src_bm, int16_t src_x, int16_t src_y, Bitmap* dst_bm, int16_t width, int16_t height)
-{
-	unsigned char*		the_starting_read_loc;
-	unsigned char*		the_read_loc;
-	unsigned char*		the_write_loc;
-	int16_t				i;
-	int16_t				h_tiles;
-	int16_t				h_rem;
-	int16_t				v_tiles;
-	int16_t				v_rem;
-	int16_t				j;
-	
-	
-	// TODO: move the 2 checks below to a private common function if other blit functions are added
-	
-	if (src_bm == NULL || dst_bm == NULL)
-	{
-		LOG_ERR(("%s %d: passed source or destination bitmap was NULL", __func__, __LINE__));
-		return false;
-	}
-	
-	if (src_bm->addr_ == NULL || dst_bm->addr_ == NULL)
-	{
-		LOG_ERR(("%s %d: passed source or destination bitmap had a NULL address", __func__, __LINE__));
-		return false;
-	}
+	read_step = (int32_t)src_bm->width_;
+	write_step = (int32_t)dst_bm->width_;
 	
 	// LOGIC:
-	//   The entire width and height of the tile must be within the source bitmap. 
+	//   when copying within one bitmap (scrolling), the source and destination rects can overlap
+	//   if the destination is lower than the source, copy rows bottom-up, so no source row is overwritten before it has been read
+	//   within a row, memmove takes care of left/right overlap
 	
-	if (src_x < 0 || src_x + width > src_bm->width_ || src_y < 0 || src_y + height > src_bm->height_)
+	if (src_bm == dst_bm && dst_y > src_y)
 	{
-		LOG_INFO(("%s %d: Tile operations require the entire height and width of the tile to be defined within the bounds of the source bitmap. No tiling performed. src_x=%i, src_y=%i, width=%i, height=%i.", __func__, __LINE__, src_x, src_y, width, height));
-		return false;
+		the_read_loc_int += (uint32_t)read_step * (uint32_t)(height - 1);
+		the_write_loc_int += (uint32_t)write_step * (uint32_t)(height - 1);
+		read_step = -read_step;
+		write_step = -write_step;
 	}
-
-	//DEBUG_OUT(("%s %d: starting parameters: src_x=%i, src_y=%i, width=%i, height=%i.", __func__, __LINE__, src_x, src_y, width, height));
-	//DEBUG_OUT(("%s %d: dst_bm=%p, dst_bm=%p", __func__, __LINE__, src_bm, dst_bm));
-	
-	// LOGIC:
-	//   Unlike a blit operation, a tile operation always starts in the upper left corner of the target bitmap, and fills it entirely
-	//   As an optimization, each row of one tile worth will be copied to the right to fill one horizontal row of the dest. bitmap
-	//   From that point, will loop through the required number of remaining bands, copying the full width of the dest bitmap.
-	
-	// adjust copy width/height if the prescribed tile height or width wouldn't fit on target bitmap
-	width = (width >= dst_bm->width_) ? dst_bm->width_ : width;
-	height = (height >= dst_bm->height_) ? dst_bm->height_ : height;
-
-	// checks complete. ready to tile. 
-	the_starting_read_loc = src_bm->addr_ + (src_bm->width_ * src_y) + src_x;
-	
-	h_tiles = dst_bm->width_ / width;
-	h_rem = dst_bm->width_ % width;
-	
-	// first loop is to create 1 pixel row worth extending across the entire target bitmap
-	// and loop that for each row in the source tile
-	for (i = 0; i < height; i++)
-	{
-		the_read_loc = the_starting_read_loc + src_bm->width_ * i;
-		the_write_loc = dst_bm->addr_ + dst_bm->width_ * i; // x=0, row = i
-
-		for (j = 0; j < h_tiles; j++)
-		{
-			memcpy(the_write_loc, the_read_loc, width);
-	
-			the_write_loc += width;
-		}
-		
-		// the last horizontal span, if any, will have less width
-		if (h_rem)
-		{
-			memcpy(the_write_loc, the_read_loc, h_rem);
-		}
-	}		
-	
-	
-	// have now filled the entire width of the dest. bitmap, to a height of 'height'. tile downwards...
-	
-	v_tiles = dst_bm->height_ / height;
-	v_rem = dst_bm->height_ % height;
-
-	//DEBUG_OUT(("%s %d: h_tiles=%i, h_rem=%i, v_tiles=%i, v_rem=%i", __func__, __LINE__, h_tiles, h_rem, v_tiles, v_rem));
-
-	// now we are reading from the destination bitmap, from the area we prepared. 
-	// we will keep reading the same blob over and over again, so read loc is now permanent.
-	the_read_loc = dst_bm->addr_;
-	
-	uint32_t write_size = dst_bm->width_ * height;
-	the_write_loc = dst_bm->addr_ + (dst_bm->width_ * height * 1); // right after the first band of tile
-	
-	// each loop is horizontal band of tiles running full length of target bitmap, writing top to bottom, from 2nd vertical band
-	for (j = 1; j < v_tiles; j++)	 // 1 because we just wrote one band worth's above.
-	{
-		memcpy(the_write_loc, the_read_loc, write_size);
-	
-		the_write_loc += write_size;
-	}
-	
-	// the last tile, if any, will have less height
-	if (v_rem)
-	{
-		height = v_rem;
-		write_size = dst_bm->width_ * height;
-		
-		memcpy(the_write_loc, the_read_loc, write_size);
-	}
-	
-	//DEBUG_OUT(("%s %d: final parameters: src_x=%i, src_y=%i, width=%i, height=%i.", __func__, __LINE__, src_x, src_y, width, height));
-	
-	return true;
-}
-
-
-//! Tile the source bitmap into the destination bitmap, filling it
-//! The source and destination bitmaps can be the same: you can use this to copy a chunk of pixels from one part of a screen to another. If the destination location cannot fit the entirety of the copied rectangle, the copy will be truncated, but will not return an error. 
-//! @param src_bm: the source bitmap. It must have a valid address within the VRAM memory space.
-//! @param dst_bm: the destination bitmap. It must have a valid address within the VRAM memory space. It can be the same bitmap as the source.
-//! @param src_x, src_y: the upper left coordinate within the source bitmap, for the tile you want to copy. Must be non-negative.
-//! @param width, height: the size of the tile to be derived from the source bitmap, in pixels.
-bool Bitmap_TileV2(Bitmap* src_bm, int16_t src_x, int16_t src_y, Bitmap* dst_bm, int16_t width, int16_t height)
-{
-	unsigned char*		the_starting_read_loc;
-	unsigned char*		the_read_loc;
-	unsigned char*		the_write_loc;
-	int16_t				i;
-	int16_t				h_tiles;
-	int16_t				h_rem;
-	int16_t				v_tiles;
-	int16_t				v_rem;
-	int16_t				j;
 	
-	
-	// TODO: move the 2 checks below to a private common function if other blit functions are added
-	
-	if (src_bm == NULL || dst_bm == NULL)
-	{
-		LOG_ERR(("%s %d: passed source or destination bitmap was NULL", __func__, __LINE__));
-		return false;
-	}
-	
-	if (src_bm->addr_ == NULL || dst_bm->addr_ == NULL)
-	{
-		LOG_ERR(("%s %d: passed source or destination bitmap had a NULL address", __func__, __LINE__));
-		return false;
-	}
-	
-	// LOGIC:
-	//   The entire width and height of the tile must be within the source bitmap. 
-	
-	if (src_x < 0 || src_x + width > src_bm->width_ || src_y < 0 || src_y + height > src_bm->height_)
-	{
-		LOG_INFO(("%s %d: Tile operations require the entire height and width of the tile to be defined within the bounds of the source bitmap. No tiling performed. src_x=%i, src_y=%i, width=%i, height=%i.", __func__, __LINE__, src_x, src_y, width, height));
-		return false;
-	}
-
-	//DEBUG_OUT(("%s %d: starting parameters: src_x=%i, src_y=%i, width=%i, height=%i.", __func__, __LINE__, src_x, src_y, width, height));
-	//DEBUG_OUT(("%s %d: dst_bm=%p, dst_bm=%p", __func__, __LINE__, src_bm, dst_bm));
-	
-	// LOGIC:
-	//   Unlike a blit operation, a tile operation always starts in the upper left corner of the target bitmap, and fills it entirely
-	//   As an optimization, each row of one tile worth will be copied to the right to fill one horizontal row of the dest. bitmap
-	//   From that point, will loop through the required number of remaining bands, copying the full width of the dest bitmap.
-	
-	// adjust copy width/height if the prescribed tile height or width wouldn't fit on target bitmap
-	width = (width >= dst_bm->width_) ? dst_bm->width_ : width;
-	height = (height >= dst_bm->height_) ? dst_bm->height_ : height;
-
-	// checks complete. ready to tile. 
-	the_starting_read_loc = src_bm->addr_ + (src_bm->width_ * src_y) + src_x;
-	
-	h_tiles = dst_bm->width_ / width;
-	h_rem = dst_bm->width_ % width;
-	
-	// first loop is to create 1 pixel row worth extending across the entire target bitmap
-	// and loop that for each row in the source tile
-	for (i = 0; i < height; i++)
+	for (j = 0; j < height; j++)
 	{
-		the_read_loc = the_starting_read_loc + src_bm->width_ * i;
-		the_write_loc = dst_bm->addr_ + dst_bm->width_ * i; // x=0, row = i
+		the_write_loc = (uint8_t*)the_write_loc_int;
+		the_read_loc = (uint8_t*)the_read_loc_int;
+		//DEBUG_OUT(("%s %d: the_read_loc=%p, the_write_loc=%p, copy_size=%lu", __func__, __LINE__, the_read_loc, the_write_loc, copy_size));
 
-		for (j = 0; j < h_tiles; j++)
+		if (the_rop != ROP_COPY)
 		{
-			memcpy(the_write_loc, the_read_loc, width);
-	
-			the_write_loc += width;
+			if (the_write_loc > the_read_loc && the_write_loc < the_read_loc + copy_size)
+			{
+				// LOGIC: the destination starts inside the source, in the same row: combine right to left, one pixel at a time, so no source pixel is changed before it is read
+				for (i = copy_size; i > 0; i--)
+				{
+					Bitmap_RopRow(the_write_loc + i - 1, the_read_loc + i - 1, 0, 1, the_rop);
+				}
+			}
+			else
+			{
+				Bitmap_RopRow(the_write_loc, the_read_loc, 0, (int16_t)copy_size, the_rop);
+			}
 		}
-		
-		// the last horizontal span, if any, will have less width
-		if (h_rem)
+		else
 		{
-			memcpy(the_write_loc, the_read_loc, h_rem);
+		#ifdef _C256_FMX_
+			if (the_write_loc > the_read_loc)
+			{
+				for (i = copy_size; i > 0; i--)
+				{
+					*(the_write_loc + i - 1) = *(the_read_loc + i - 1);
+				}
+			}
+			else
+			{
+				for (i=0; i < copy_size; i++)
+				{
+					*the_write_loc = *the_read_loc;
+					the_write_loc++;
+					the_read_loc++;
+				}
+			}
+		#else
+			memmove(the_write_loc, the_read_loc, copy_size);
+		#endif	
 		}
-	}		
-	
-	
-	// have now filled the entire width of the dest. bitmap, to a height of 'height'. tile downwards...
-	
-	v_tiles = dst_bm->height_ / height;
-	v_rem = dst_bm->height_ % height;
-
-	//DEBUG_OUT(("%s %d: h_tiles=%i, h_rem=%i, v_tiles=%i, v_rem=%i", __func__, __LINE__, h_tiles, h_rem, v_tiles, v_rem));
-	
-	// each loop is one tile, writing top to bottom, from 2nd vertical band
-	for (j = 1; j < v_tiles; j++)	 // 1 because we just wrote one band worth's above.
-	{
-		the_read_loc = dst_bm->addr_; // now we are reading from the destination bitmap, from the area we prepared
-		the_write_loc = dst_bm->addr_ + (dst_bm->width_ * height * j);
-		
-		for (i = 0; i < height; i++)
-		{
-			memcpy(the_write_loc, the_read_loc, dst_bm->width_);
 		
-			the_write_loc += dst_bm->width_;
-			the_read_loc += dst_bm->width_;
-		}		
+		the_write_loc_int += (uint32_t)write_step;
+		the_read_loc_int += (uint32_t)read_step;
 	}
-	
-	// the last tile, if any, will have less height
-	if (v_rem)
-	{
-		the_read_loc = dst_bm->addr_; // now we are reading from the destination bitmap, from the area we prepared
-		the_write_loc = dst_bm->addr_ + (dst_bm->width_ * height * j);
-		height = v_rem;
 
-		for (i = 0; i < height; i++)
-		{
-			memcpy(the_write_loc, the_read_loc, dst_bm->width_);
-		
-			the_write_loc += dst_bm->width_;
-			the_read_loc += dst_bm->width_;
-		}		
-	}
-	
-	//DEBUG_OUT(("%s %d: final parameters: src_x=%i, src_y=%i, width=%i, height=%i.", __func__, __LINE__, src_x, src_y, width, height));
+	bitmap_bytes_blitted += copy_size * (uint32_t)j;
 	
 	return true;
 }
 
 
-//! Tile the source bitmap into the destination bitmap, filling it
-//! The source and destination bitmaps can be the same: you can use this to copy a chunk of pixels from one part of a screen to another. If the destination location cannot fit the entirety of the copied rectangle, the copy will be truncated, but will not return an error. 
+//! Tile the source bitmap into all or part of the destination bitmap
+//! The pattern is always lined up with the top left corner of the destination bitmap, so tiling any part of it gives the same pixels as tiling the whole thing.
+//!   Use this to repair only the damaged parts of a patterned backdrop.
 //! @param src_bm: the source bitmap. It must have a valid address within the VRAM memory space.
-//! @param dst_bm: the destination bitmap. It must have a valid address within the VRAM memory space. It can be the same bitmap as the source.
 //! @param src_x, src_y: the upper left coordinate within the source bitmap, for the tile you want to copy. Must be non-negative.
-//! @param width, height: the size of the tile to be derived from the source bitmap, in pixels.
-bool Bitmap_TileV1(Bitmap* src_bm, int16_t src_x, int16_t src_y, Bitmap* dst_bm, int16_t width, int16_t height)
+//! @param dst_bm: the destination bitmap. It must have a valid address within the VRAM memory space. It must not be the same bitmap as the source.
+//! @param width, height: the size of the tile to be derived from the source bitmap, in pixels. The entire tile must be within the source bitmap.
+//! @param dst_rect: the part of the destination bitmap to fill, with MaxX and MaxY included. Any part off the bitmap is clipped. Pass NULL to fill the whole bitmap.
+//! @return	returns false on any error/invalid input.
+bool Bitmap_Tile(Bitmap* src_bm, int16_t src_x, int16_t src_y, Bitmap* dst_bm, int16_t width, int16_t height, Rectangle* dst_rect)
 {
-	unsigned char*		the_starting_read_loc;
-	unsigned char*		the_read_loc;
-	unsigned char*		the_write_loc;
-	int16_t				i;
-	int16_t				h_tiles;
-	int16_t				h_rem;
-	int16_t				v_tiles;
-	int16_t				v_rem;
-	int16_t				j;
-	
-	
-	// TODO: move the 2 checks below to a private common function if other blit functions are added
+	uint8_t*	the_read_loc;
+	uint8_t*	the_write_loc;
+	uint8_t*	the_first_row_loc;
+	uint32_t	dst_pitch;
+	uint32_t	copy_len;
+	int16_t		x1 = 0;
+	int16_t		y1 = 0;
+	int16_t		x2;
+	int16_t		y2;
+	int16_t		fill_width;
+	int16_t		fill_height;
+	int16_t		phase_x;
+	int16_t		rows_done;
+	int16_t		row_len;
+	int16_t		i;
 	
 	if (src_bm == NULL || dst_bm == NULL)
 	{
@@ -820,109 +1297,107 @@ bool Bitmap_TileV1(Bitmap* src_bm, int16_t src_x, int16_t src_y, Bitmap* dst_bm,
 		return false;
 	}
 	
+	if (src_bm == dst_bm)
+	{
+		LOG_ERR(("%s %d: source and destination bitmaps must be different", __func__, __LINE__));
+		return false;
+	}
+	
 	// LOGIC:
 	//   The entire width and height of the tile must be within the source bitmap. 
 	
-	if (src_x < 0 || src_x + width > src_bm->width_ || src_y < 0 || src_y + height > src_bm->height_)
+	if (width < 1 || height < 1 || src_x < 0 || src_x + width > src_bm->width_ || src_y < 0 || src_y + height > src_bm->height_)
 	{
 		LOG_INFO(("%s %d: Tile operations require the entire height and width of the tile to be defined within the bounds of the source bitmap. No tiling performed. src_x=%i, src_y=%i, width=%i, height=%i.", __func__, __LINE__, src_x, src_y, width, height));
 		return false;
 	}
-
-	//DEBUG_OUT(("%s %d: starting parameters: src_x=%i, src_y=%i, width=%i, height=%i.", __func__, __LINE__, src_x, src_y, width, height));
-	//DEBUG_OUT(("%s %d: dst_bm=%p, dst_bm=%p", __func__, __LINE__, src_bm, dst_bm));
-	
-	// LOGIC:
-	//   Unlike a blit operation, a tile operation always starts in the upper left corner of the target bitmap, and fills it entirely
-	//   As an optimization, one tile worth will be copied first, then copied to the right to fill one horizontal band of the dest. bitmap
-	//   From that point, will loop through the required number of remaining bands, copying the full width of the dest bitmap.
-	
-	// adjust copy width/height if the prescribed tile height or width wouldn't fit on target bitmap
-	width = (width >= dst_bm->width_) ? dst_bm->width_ : width;
-	height = (height >= dst_bm->height_) ? dst_bm->height_ : height;
-
-	// checks complete. ready to tile. 
-	the_starting_read_loc = src_bm->addr_ + (src_bm->width_ * src_y) + src_x;
 	
-	h_tiles = dst_bm->width_ / width;
-	h_rem = dst_bm->width_ % width;
+	x2 = dst_bm->width_ - 1;
+	y2 = dst_bm->height_ - 1;
 	
-	// each loop is one tile, writing left to right
-	for (j = 0; j < h_tiles; j++)
+	if (dst_rect != NULL)
 	{
-		the_read_loc = the_starting_read_loc;
-		the_write_loc = dst_bm->addr_ + width * j; // row 0, and x pos of width * num times already tiled
-
-		for (i = 0; i < height; i++)
-		{
-			memcpy(the_write_loc, the_read_loc, width);
-		
-			the_write_loc += dst_bm->width_;
-			the_read_loc += src_bm->width_;
-		}		
+		x1 = (dst_rect->MinX > x1) ? dst_rect->MinX : x1;
+		y1 = (dst_rect->MinY > y1) ? dst_rect->MinY : y1;
+		x2 = (dst_rect->MaxX < x2) ? dst_rect->MaxX : x2;
+		y2 = (dst_rect->MaxY < y2) ? dst_rect->MaxY : y2;
 	}
 	
-	// the last tile, if any, will have same height, but less width
-	if (h_rem)
+	if (x1 > x2 || y1 > y2)
 	{
-		the_read_loc = the_starting_read_loc;
-		the_write_loc = dst_bm->addr_ + width * j; // row 0, and x pos of width * num times already tiled
-		width = h_rem;
-
-		for (i = 0; i < height; i++)
-		{
-			memcpy(the_write_loc, the_read_loc, width);
-		
-			the_write_loc += dst_bm->width_;
-			the_read_loc += src_bm->width_;
-		}		
+		return true;	// nothing on the bitmap to fill: not an error
 	}
 	
-	// have now filled the entire width of the dest. bitmap, to a height of 'height'. tile downwards...
+	fill_width = x2 - x1 + 1;
+	fill_height = y2 - y1 + 1;
+	phase_x = x1 % width;
+	dst_pitch = (uint32_t)dst_bm->width_;
 	
-	v_tiles = dst_bm->height_ / height;
-	v_rem = dst_bm->height_ % height;
-
-	//DEBUG_OUT(("%s %d: h_tiles=%i, h_rem=%i, v_tiles=%i, v_rem=%i", __func__, __LINE__, h_tiles, h_rem, v_tiles, v_rem));
+	// LOGIC:
+	//   pixel (x, y) of the destination always gets pixel (x % width, y % height) of the tile, wherever the fill starts.
+	//   each of the first rows (up to one tile high) is built by copying one tile's width of pattern from the source, starting at the right phase,
+	//     then doubling: copying what has been written so far to just after it. because what has been written is always a whole number of tiles wide, the pattern stays in phase.
+	//     that is 2 + log2(row width / tile width) copies per row, rather than one per tile.
+	//   every row after those is a copy of the row one tile height above it. if the fill is the full width of the bitmap, the rows are next to each other in memory,
+	//     so the rows written so far are doubled the same way, a block of whole rows at a time.
 	
-	// each loop is one tile, writing top to bottom, from 2nd vertical band
-	for (j = 1; j < v_tiles; j++)	 // 1 because we just wrote one band worth's above.
+	the_first_row_loc = (uint8_t*)(dst_bm->addr_int_ + dst_pitch * (uint32_t)y1 + (uint32_t)x1);
+	the_write_loc = the_first_row_loc;
+	rows_done = (fill_height < height) ? fill_height : height;
+	
+	for (i = 0; i < rows_done; i++)
 	{
-		the_read_loc = dst_bm->addr_; // now we are reading from the destination bitmap, from the area we prepared
-		the_write_loc = dst_bm->addr_ + (dst_bm->width_ * height * j);
+		the_read_loc = (uint8_t*)(src_bm->addr_int_ + (uint32_t)src_bm->width_ * (uint32_t)(src_y + (y1 + i) % height) + (uint32_t)src_x);
+		
+		// one tile's width of pattern: from the phase to the right edge of the tile, then from the left edge of the tile up to the phase
+		copy_len = (fill_width < width - phase_x) ? fill_width : width - phase_x;
+		memcpy(the_write_loc, the_read_loc + phase_x, copy_len);
+		row_len = copy_len;
 		
-		for (i = 0; i < height; i++)
+		if (row_len < fill_width && phase_x > 0)
 		{
-			memcpy(the_write_loc, the_read_loc, dst_bm->width_);
+			copy_len = (fill_width - row_len < phase_x) ? fill_width - row_len : phase_x;
+			memcpy(the_write_loc + row_len, the_read_loc, copy_len);
+			row_len += copy_len;
+		}
+		
+		// double it until the row is full
+		while (row_len < fill_width)
+		{
+			copy_len = (fill_width - row_len < row_len) ? fill_width - row_len : row_len;
+			memcpy(the_write_loc + row_len, the_write_loc, copy_len);
+			row_len += copy_len;
+		}
 		
-			the_write_loc += dst_bm->width_;
-			the_read_loc += dst_bm->width_;
-		}		
+		the_write_loc += dst_pitch;
 	}
 	
-	// the last tile, if any, will have less height
-	if (v_rem)
+	if (fill_width == dst_bm->width_)
 	{
-		the_read_loc = dst_bm->addr_; // now we are reading from the destination bitmap, from the area we prepared
-		the_write_loc = dst_bm->addr_ + (dst_bm->width_ * height * j);
-		height = v_rem;
-
-		for (i = 0; i < height; i++)
+		// full width: double whole blocks of rows. rows_done stays a whole number of tiles high, so the pattern stays in phase.
+		while (rows_done < fill_height)
 		{
-			memcpy(the_write_loc, the_read_loc, dst_bm->width_);
-		
-			the_write_loc += dst_bm->width_;
-			the_read_loc += dst_bm->width_;
-		}		
+			i = (fill_height - rows_done < rows_done) ? fill_height - rows_done : rows_done;
+			memcpy(the_first_row_loc + dst_pitch * (uint32_t)rows_done, the_first_row_loc, dst_pitch * (uint32_t)i);
+			rows_done += i;
+		}
+	}
+	else
+	{
+		// part of the width: each row is a copy of the one a tile height above it
+		for (; rows_done < fill_height; rows_done++)
+		{
+			memcpy(the_write_loc, the_write_loc - dst_pitch * (uint32_t)height, fill_width);
+			the_write_loc += dst_pitch;
+		}
 	}
-	
-	//DEBUG_OUT(("%s %d: final parameters: src_x=%i, src_y=%i, width=%i, height=%i.", __func__, __LINE__, src_x, src_y, width, height));
 	
 	return true;
 }
 
 
 
+
 // **** Block fill functions ****
 
 
@@ -1028,6 +1503,68 @@ bool Bitmap_FillBox(Bitmap* the_bitmap, int16_t x, int16_t y, int16_t width, int
 
 
 
+//! Fill a batch of rectangles with the same color
+//! Cheaper than calling Bitmap_FillBox() for each one: the bitmap is validated once, and each rectangle is clipped to the bitmap rather than rejected.
+//! @param	the_rects: array of at least num_rects rectangles. MinX to MaxX and MinY to MaxY are all filled, including MaxX and MaxY. Rectangles with MaxX < MinX or MaxY < MinY are skipped.
+//! @param	num_rects: number of rectangles in the array
+//! @param	the_color: a 1-byte index to the current LUT
+//! @return	returns false on any error/invalid input.
+bool Bitmap_FillBoxes(Bitmap* the_bitmap, Rectangle* the_rects, int16_t num_rects, uint8_t the_color)
+{
+	uint8_t*	the_write_loc;
+	int16_t		i;
+	int16_t		x1;
+	int16_t		y1;
+	int16_t		x2;
+	int16_t		y2;
+	
+	if (the_bitmap == NULL)
+	{
+		LOG_ERR(("%s %d: passed bitmap was NULL", __func__, __LINE__));
+		return false;
+	}
+
+	if (the_rects == NULL || num_rects < 0)
+	{
+		LOG_ERR(("%s %d: no rectangles passed", __func__, __LINE__));
+		return false;
+	}
+	
+	for (i = 0; i < num_rects; i++)
+	{
+		x1 = (the_rects[i].MinX < 0) ? 0 : the_rects[i].MinX;
+		y1 = (the_rects[i].MinY < 0) ? 0 : the_rects[i].MinY;
+		x2 = (the_rects[i].MaxX >= the_bitmap->width_) ? the_bitmap->width_ - 1 : the_rects[i].MaxX;
+		y2 = (the_rects[i].MaxY >= the_bitmap->height_) ? the_bitmap->height_ - 1 : the_rects[i].MaxY;
+		
+		if (x1 > x2 || y1 > y2)
+		{
+			continue;
+		}
+		
+		the_write_loc = (uint8_t*)(the_bitmap->addr_int_ + ((uint32_t)the_bitmap->width_ * (uint32_t)y1) + (uint32_t)x1);
+		
+		for (; y1 <= y2; y1++)
+		{
+			#ifdef _C256_FMX_
+				int16_t j;
+				for (j = 0; j <= x2 - x1; j++)
+				{
+					*(the_write_loc + j) = the_color;
+				}
+			#else
+				memset(the_write_loc, the_color, x2 - x1 + 1);
+			#endif
+			
+			the_write_loc += the_bitmap->width_;
+		}
+	}
+	
+	return true;
+}
+
+
+
 
 // **** Bitmap functions *****
 
@@ -1164,6 +1701,13 @@ Font* Bitmap_GetFont(Bitmap* the_bitmap)
 }
 
 
+//! Get the total number of bytes copied by Bitmap_Blit() and its wrappers, across all bitmaps
+uint32_t Bitmap_GetBytesBlitted(void)
+{
+	return bitmap_bytes_blitted;
+}
+
+
 
 //! Calculate the VRAM location of the specified coordinate within the bitmap
 //! @param	the_bitmap: reference to a valid Bitmap object.
@@ -1287,6 +1831,46 @@ bool Bitmap_SetPixelAtXY(Bitmap* the_bitmap, int16_t x, int16_t y, uint8_t the_c
 }
 
 
+//! Set a batch of pixels to the same color
+//! Cheaper than calling Bitmap_SetPixelAtXY() for each one: the bitmap is validated once, and points off the bitmap are skipped without logging.
+//! @param	the_points: array of at least num_points coordinates
+//! @param	num_points: number of points in the array
+//! @param	the_color: a 1-byte index to the current LUT
+//! @return	returns false on any error/invalid input.
+bool Bitmap_SetPixels(Bitmap* the_bitmap, Coordinate* the_points, int16_t num_points, uint8_t the_color)
+{
+	uint8_t*	the_base_loc;
+	uint32_t	the_width;
+	int16_t		i;
+	
+	if (the_bitmap == NULL)
+	{
+		LOG_ERR(("%s %d: passed bitmap was NULL", __func__, __LINE__));
+		return false;
+	}
+
+	if (the_points == NULL || num_points < 0)
+	{
+		LOG_ERR(("%s %d: no points passed", __func__, __LINE__));
+		return false;
+	}
+	
+	the_base_loc = (uint8_t*)the_bitmap->addr_int_;
+	the_width = (uint32_t)the_bitmap->width_;
+	
+	for (i = 0; i < num_points; i++)
+	{
+		// LOGIC: casting to unsigned turns negative coordinates into big ones, so one compare per axis does for both edges
+		if ((uint16_t)the_points[i].x < (uint16_t)the_bitmap->width_ && (uint16_t)the_points[i].y < (uint16_t)the_bitmap->height_)
+		{
+			*(the_base_loc + the_width * (uint32_t)the_points[i].y + (uint32_t)the_points[i].x) = the_color;
+		}
+	}
+	
+	return true;
+}
+
+
 
 
 // **** Get pixel functions *****
@@ -1328,58 +1912,107 @@ uint8_t Bitmap_GetPixelAtXY(Bitmap* the_bitmap, int16_t x, int16_t y)
 
 //! Draws a line between 2 passed coordinates.
 //! Use for any line that is not perfectly vertical or perfectly horizontal
-//! Based on http://rosettacode.org/wiki/Bitmap/Bresenham%27s_line_algorithm#C. Used in C128 Lich King. 
+//! Either end, or both, may be off the bitmap: the line is clipped once to the bitmap, and only the part on the bitmap is drawn.
+//! @param	the_color: a 1-byte index to the current LUT
+//! @return	returns false on any error/invalid input, including a line that runs more than BITMAP_MAX_LINE_SPAN pixels in either direction. A line that is entirely off the bitmap is not an error.
 bool Bitmap_DrawLine(Bitmap* the_bitmap, int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint8_t the_color)
 {
-	int16_t dx;
-	int16_t sx;
-	int16_t dy;
-	int16_t sy;
-	int16_t err;
-
 	if (the_bitmap == NULL)
 	{
 		LOG_ERR(("%s %d: passed bitmap was NULL", __func__, __LINE__));
 		return false;
 	}
 
-	if (!Bitmap_ValidateXY(the_bitmap, x1, y1))
+	if (abs(x2 - x1) > BITMAP_MAX_LINE_SPAN || abs(y2 - y1) > BITMAP_MAX_LINE_SPAN)
 	{
-		LOG_ERR(("%s %d: illegal coordinate", __func__, __LINE__));
+		LOG_ERR(("%s %d: line too long (%i, %i to %i, %i)", __func__, __LINE__, x1, y1, x2, y2));
 		return false;
 	}
 	
-	dx = abs(x2 - x1);
-	sx = x1 < x2 ? 1 : -1;
-	dy = abs(y2 - y1);
-	sy = y1 < y2 ? 1 : -1;
-	err = (dx > dy ? dx : -dy)/2;
+	Bitmap_DrawClippedLine(the_bitmap, x1, y1, x2, y2, the_color, false);
+	
+	return true;
+}
 
-	for(;;)
-	{
-		int16_t e2;
 
-		Bitmap_SetPixelAtXY(the_bitmap, x1, y1, the_color);
+//! Draws connected lines through a series of points, from the first to the last
+//! Cheaper than calling Bitmap_DrawLine() for each segment: the bitmap is validated once, and each join is drawn once, not twice.
+//! Points may be off the bitmap; each segment is clipped.
+//! @param	the_points: array of at least num_points coordinates. To draw a closed shape, repeat the first point at the end.
+//! @param	num_points: number of points in the array. 1 point draws a single pixel.
+//! @param	the_color: a 1-byte index to the current LUT
+//! @return	returns false on any error/invalid input, including a segment that runs more than BITMAP_MAX_LINE_SPAN pixels in either direction. Nothing is drawn if any segment is invalid.
+bool Bitmap_DrawPolyline(Bitmap* the_bitmap, Coordinate* the_points, int16_t num_points, uint8_t the_color)
+{
+	int16_t		i;
+	
+	if (the_bitmap == NULL)
+	{
+		LOG_ERR(("%s %d: passed bitmap was NULL", __func__, __LINE__));
+		return false;
+	}
 
-		if (x1==x2 && y1==y2)
+	if (the_points == NULL || num_points < 1)
+	{
+		LOG_ERR(("%s %d: no points passed", __func__, __LINE__));
+		return false;
+	}
+	
+	for (i = 1; i < num_points; i++)
+	{
+		if (abs(the_points[i].x - the_points[i-1].x) > BITMAP_MAX_LINE_SPAN || abs(the_points[i].y - the_points[i-1].y) > BITMAP_MAX_LINE_SPAN)
 		{
-			break;
+			LOG_ERR(("%s %d: segment %i too long", __func__, __LINE__, i));
+			return false;
 		}
+	}
 
-		e2 = err;
+	Bitmap_DrawClippedLine(the_bitmap, the_points[0].x, the_points[0].y, the_points[0].x, the_points[0].y, the_color, false);
+	
+	for (i = 1; i < num_points; i++)
+	{
+		Bitmap_DrawClippedLine(the_bitmap, the_points[i-1].x, the_points[i-1].y, the_points[i].x, the_points[i].y, the_color, true);
+	}
+	
+	return true;
+}
 
-		if (e2 >-dx)
-		{
-			err -= dy;
-			x1 += sx;
-		}
+//! Draws a batch of separate lines with the same color
+//! Cheaper than calling Bitmap_DrawLine() for each one: the bitmap is validated once. Each line is clipped to the bitmap.
+//! @param	the_points: array of at least num_lines * 2 coordinates: the start and end of the first line, then the start and end of the second, and so on
+//! @param	num_lines: number of lines to draw
+//! @param	the_color: a 1-byte index to the current LUT
+//! @return	returns false on any error/invalid input, including a line that runs more than BITMAP_MAX_LINE_SPAN pixels in either direction. Nothing is drawn if any line is invalid.
+bool Bitmap_DrawLines(Bitmap* the_bitmap, Coordinate* the_points, int16_t num_lines, uint8_t the_color)
+{
+	int32_t		i;
+	
+	if (the_bitmap == NULL)
+	{
+		LOG_ERR(("%s %d: passed bitmap was NULL", __func__, __LINE__));
+		return false;
+	}
 
-		if (e2 < dy)
+	if (the_points == NULL || num_lines < 0)
+	{
+		LOG_ERR(("%s %d: no lines passed", __func__, __LINE__));
+		return false;
+	}
+	
+	// LOGIC: there are up to 2 * 32767 points, so the index has to be wider than num_lines
+	for (i = 0; i < (int32_t)num_lines * 2; i += 2)
+	{
+		if (abs(the_points[i+1].x - the_points[i].x) > BITMAP_MAX_LINE_SPAN || abs(the_points[i+1].y - the_points[i].y) > BITMAP_MAX_LINE_SPAN)
 		{
-			err += dx;
-			y1 += sy;
+			LOG_ERR(("%s %d: line %i too long", __func__, __LINE__, (int16_t)(i / 2)));
+			return false;
 		}
 	}
+
+	for (i = 0; i < (int32_t)num_lines * 2; i += 2)
+	{
+		Bitmap_DrawClippedLine(the_bitmap, the_points[i].x, the_points[i].y, the_points[i+1].x, the_points[i+1].y, the_color, false);
+	}
 	
 	return true;
 }
@@ -1419,8 +2052,6 @@ bool Bitmap_DrawHLine(Bitmap* the_bitmap, int16_t x, int16_t y, int16_t the_line
 //! @return	returns false on any error/invalid input.
 bool Bitmap_DrawVLine(Bitmap* the_bitmap, int16_t x, int16_t y, int16_t the_line_len, uint8_t the_color)
 {
-	int16_t		dy;
-
 	//DEBUG_OUT(("%s %d: x=%i, y=%i, the_line_len=%i, the_color=%i", __func__, __LINE__, x, y, the_line_len, the_color));
 	
 	if (the_bitmap == NULL)
@@ -1435,9 +2066,15 @@ bool Bitmap_DrawVLine(Bitmap* the_bitmap, int16_t x, int16_t y, int16_t the_line
 		return false;
 	}
 	
-	for (dy = 0; dy < the_line_len; dy++)
+	// LOGIC: the line is clipped at the bottom of the bitmap, then drawn by stepping a pointer down one row at a time
+	if (the_line_len > the_bitmap->height_ - y)
+	{
+		the_line_len = the_bitmap->height_ - y;
+	}
+	
+	if (the_line_len > 0)
 	{
-		Bitmap_SetPixelAtXY(the_bitmap, x, y + dy, the_color);
+		Bitmap_DrawClippedLine(the_bitmap, x, y, x, y + the_line_len - 1, the_color, false);
 	}
 	
 	return true;
@@ -1591,15 +2228,102 @@ bool Bitmap_DrawBox(Bitmap* the_bitmap, int16_t x, int16_t y, int16_t width, int
 }
 
 
+//! Draws a rectangle, or fills it, combining the_color with the pixels already there using a raster operation
+//! Use for highlights, carets, drag outlines, and inverted menu items: drawing the same box with ROP_XOR or ROP_INVERT a second time puts back what was under it, with no redraw.
+//! Each pixel is only changed once, even at the corners of an outline, so XOR and invert undo cleanly. Any part of the box off the bitmap is clipped.
+//! @param	width: width, in pixels, of the rectangle to be drawn
+//! @param	height: height, in pixels, of the rectangle to be drawn
+//! @param	the_color: a 1-byte index to the current LUT. Ignored for ROP_INVERT.
+//! @param	do_fill: If true, the box will be filled. If false, only the outline will be drawn.
+//! @param	the_rop: how to combine the_color with each pixel in the box. ROP_COPY draws the box normally.
+//! @return	returns false on any error/invalid input.
+bool Bitmap_DrawBoxRop(Bitmap* the_bitmap, int16_t x, int16_t y, int16_t width, int16_t height, uint8_t the_color, bool do_fill, bitmap_rop the_rop)
+{
+	Rectangle	the_parts[4];
+	int16_t		num_parts;
+	int16_t		i;
+	int16_t		row;
+	int16_t		x1;
+	int16_t		y1;
+	int16_t		x2;
+	int16_t		y2;
+	uint8_t*	the_write_loc;
+	
+	if (the_bitmap == NULL)
+	{
+		LOG_ERR(("%s %d: passed bitmap was NULL", __func__, __LINE__));
+		return false;
+	}
+
+	if (width < 1 || height < 1)
+	{
+		LOG_ERR(("%s %d: illegal box size (%i, %i)", __func__, __LINE__, width, height));
+		return false;
+	}
+	
+	// LOGIC:
+	//   a filled box is one part. an outline is the full top and bottom rows, and the sides between them, so no pixel is in 2 parts.
+	//   each part is clipped to the bitmap, then handed to the row kernel one row at a time.
+	
+	the_parts[0].MinX = x;
+	the_parts[0].MinY = y;
+	the_parts[0].MaxX = x + width - 1;
+	the_parts[0].MaxY = (do_fill) ? y + height - 1 : y;
+	num_parts = 1;
+	
+	if (!do_fill && height > 1)
+	{
+		the_parts[1].MinX = x;
+		the_parts[1].MinY = y + height - 1;
+		the_parts[1].MaxX = x + width - 1;
+		the_parts[1].MaxY = y + height - 1;
+		the_parts[2].MinX = x;
+		the_parts[2].MinY = y + 1;
+		the_parts[2].MaxX = x;
+		the_parts[2].MaxY = y + height - 2;
+		the_parts[3].MinX = x + width - 1;
+		the_parts[3].MinY = y + 1;
+		the_parts[3].MaxX = x + width - 1;
+		the_parts[3].MaxY = y + height - 2;
+		num_parts = (width > 1) ? 4 : 3;
+	}
+	
+	for (i = 0; i < num_parts; i++)
+	{
+		x1 = (the_parts[i].MinX < 0) ? 0 : the_parts[i].MinX;
+		y1 = (the_parts[i].MinY < 0) ? 0 : the_parts[i].MinY;
+		x2 = (the_parts[i].MaxX >= the_bitmap->width_) ? the_bitmap->width_ - 1 : the_parts[i].MaxX;
+		y2 = (the_parts[i].MaxY >= the_bitmap->height_) ? the_bitmap->height_ - 1 : the_parts[i].MaxY;
+		
+		if (x1 > x2 || y1 > y2)
+		{
+			continue;
+		}
+		
+		the_write_loc = (uint8_t*)(the_bitmap->addr_int_ + ((uint32_t)the_bitmap->width_ * (uint32_t)y1) + (uint32_t)x1);
+		
+		for (row = y1; row <= y2; row++)
+		{
+			Bitmap_RopRow(the_write_loc, NULL, the_color, x2 - x1 + 1, the_rop);
+			the_write_loc += the_bitmap->width_;
+		}
+	}
+	
+	return true;
+}
+
+
 //! Draws a rounded rectangle with the specified size and radius, and optionally fills the rectangle.
+//! Each row is drawn as one or two horizontal spans, so a filled round rect draws at close to the speed of a plain filled rect.
 //! @param	width: width, in pixels, of the rectangle to be drawn
 //! @param	height: height, in pixels, of the rectangle to be drawn
-//! @param	radius: radius, in pixels, of the arc to be applied to the rectangle's corners. Enforces a minimum of 3, maximum of 20.
+//! @param	radius: radius, in pixels, of the arc to be applied to the rectangle's corners. 0 draws square corners. Radii too big for the rectangle are reduced to half its width or height, whichever is smaller.
 //! @param	the_color: a 1-byte index to the current color LUT
 //! @param	do_fill: If true, the box will be filled with the provided color. If false, the box will only draw the outline.
 //! @return	returns false on any error/invalid input.
 bool Bitmap_DrawRoundBox(Bitmap* the_bitmap, int16_t x, int16_t y, int16_t width, int16_t height, int16_t radius, uint8_t the_color, bool do_fill)
 {	
+	int16_t		max_radius;
 
 	//DEBUG_OUT(("%s %d: x=%i, y=%i, width=%i, height=%i, the_color=%i", __func__, __LINE__, x, y, width, height, the_color));
 
@@ -1615,89 +2339,120 @@ bool Bitmap_DrawRoundBox(Bitmap* the_bitmap, int16_t x, int16_t y, int16_t width
 		return false;
 	}
 	
-	if (!Bitmap_ValidateXY(the_bitmap, x + width - 1, y + height - 1))
+	if (width < 1 || height < 1 || !Bitmap_ValidateXY(the_bitmap, x + width - 1, y + height - 1))
 	{
 		LOG_ERR(("%s %d: illegal coordinate", __func__, __LINE__));
 		return false;
 	}
 
-	radius = (radius < 3) ? 3 : radius;
-	radius = (radius > 20) ? 20 : radius;
-	
-	
-	// adjust box x, y, width, height values to line up with the edges of the arcs
-	width -= radius * 2;
-	height -= radius * 2;
-	x += radius;
-	y += radius;
-	
-	// Draw 4 circle quadrants
-	Bitmap_DrawCircleQuadrants(the_bitmap, x, y, radius, the_color, PARAM_SKIP_NE, PARAM_SKIP_SE, PARAM_SKIP_SW, PARAM_DRAW_NW);
-	Bitmap_DrawCircleQuadrants(the_bitmap, x + width, y, radius, the_color, PARAM_DRAW_NE, PARAM_SKIP_SE, PARAM_SKIP_SW, PARAM_SKIP_NW);
-	Bitmap_DrawCircleQuadrants(the_bitmap, x, y + height, radius, the_color, PARAM_SKIP_NE, PARAM_SKIP_SE, PARAM_DRAW_SW, PARAM_SKIP_NW);
-	Bitmap_DrawCircleQuadrants(the_bitmap, x + width, y + height, radius, the_color, PARAM_SKIP_NE, PARAM_DRAW_SE, PARAM_SKIP_SW, PARAM_SKIP_NW);
-	
-	// draw 4 shortened lines that will match up with the edges of the arcs
-	if (!Bitmap_DrawHLine(the_bitmap, x, y - radius, width, the_color))
-	{
-		LOG_ERR(("%s %d: draw box failed", __func__, __LINE__));
-		return false;
-	}
+	// LOGIC:
+	//   a round rect is a circle of the corner radius, with its quadrants pulled apart to the corners of the box, and straight edges between them
+	//   the corners can't be bigger than half the box, or the quadrants would cross over each other
+	max_radius = ((width < height) ? width : height) / 2;
+	radius = (radius < 0) ? 0 : radius;
+	radius = (radius > max_radius) ? max_radius : radius;
 	
-	if (!Bitmap_DrawVLine(the_bitmap, x + width + radius, y, height, the_color))
+	Bitmap_DrawRoundSpans(the_bitmap, x + radius, y + radius, x + width - 1 - radius, y + height - 1 - radius, radius, radius, the_color, do_fill);
+		
+	return true;
+}
+
+
+//! Draw a circle
+//! @param	radius: radius, in pixels, of the circle, between 0 and BITMAP_MAX_RADIUS. Any part of the circle that falls outside the bitmap is clipped.
+//! @param	the_color: a 1-byte index to the current color LUT
+//! @return	returns false on any error/invalid input.
+bool Bitmap_DrawCircle(Bitmap* the_bitmap, int16_t x1, int16_t y1, int16_t radius, uint8_t the_color)
+{
+	return Bitmap_DrawEllipse(the_bitmap, x1, y1, radius, radius, the_color, PARAM_DO_NOT_FILL);
+}
+
+
+//! Draw a filled circle
+//! @param	radius: radius, in pixels, of the circle, between 0 and BITMAP_MAX_RADIUS. Any part of the circle that falls outside the bitmap is clipped.
+//! @param	the_color: a 1-byte index to the current color LUT
+//! @return	returns false on any error/invalid input.
+bool Bitmap_FillCircle(Bitmap* the_bitmap, int16_t x1, int16_t y1, int16_t radius, uint8_t the_color)
+{
+	return Bitmap_DrawEllipse(the_bitmap, x1, y1, radius, radius, the_color, PARAM_DO_FILL);
+}
+
+
+//! Draw an ellipse, and optionally fill it. Each row is drawn as one span if filled, or two short spans if not.
+//! @param	x1: the horizontal position of the center of the ellipse. Must be within the bitmap.
+//! @param	y1: the vertical position of the center of the ellipse. Must be within the bitmap.
+//! @param	radius_x: horizontal radius, in pixels, between 0 and BITMAP_MAX_RADIUS. Any part of the ellipse that falls outside the bitmap is clipped.
+//! @param	radius_y: vertical radius, in pixels, between 0 and BITMAP_MAX_RADIUS
+//! @param	the_color: a 1-byte index to the current color LUT
+//! @param	do_fill: If true, the ellipse will be filled with the provided color. If false, only the outline will be drawn.
+//! @return	returns false on any error/invalid input.
+bool Bitmap_DrawEllipse(Bitmap* the_bitmap, int16_t x1, int16_t y1, int16_t radius_x, int16_t radius_y, uint8_t the_color, bool do_fill)
+{
+	if (the_bitmap == NULL)
 	{
-		LOG_ERR(("%s %d: draw box failed", __func__, __LINE__));
+		LOG_ERR(("%s %d: passed bitmap was NULL", __func__, __LINE__));
 		return false;
 	}
-	
-	if (!Bitmap_DrawHLine(the_bitmap, x, y + height + radius, width, the_color))
+
+	if (!Bitmap_ValidateXY(the_bitmap, x1, y1))
 	{
-		LOG_ERR(("%s %d: draw box failed", __func__, __LINE__));
+		LOG_ERR(("%s %d: illegal coordinate", __func__, __LINE__));
 		return false;
 	}
-	
-	if (!Bitmap_DrawVLine(the_bitmap, x - radius, y, height, the_color))
+
+	if (radius_x < 0 || radius_y < 0 || radius_x > BITMAP_MAX_RADIUS || radius_y > BITMAP_MAX_RADIUS)
 	{
-		LOG_ERR(("%s %d: draw box failed", __func__, __LINE__));
+		LOG_ERR(("%s %d: illegal radius (%i, %i)", __func__, __LINE__, radius_x, radius_y));
 		return false;
 	}
+
+	Bitmap_DrawRoundSpans(the_bitmap, x1, y1, x1, y1, radius_x, radius_y, the_color, do_fill);
 	
-	// fill with same color as outline, if specified
-	if (do_fill)
-	{
-		Bitmap_FillBox(the_bitmap, x + radius, y + 1, width - radius*2, radius, the_color);
-		Bitmap_FillBox(the_bitmap, x + 1, y + radius, width - 1, height-radius*2, the_color);
-		Bitmap_FillBox(the_bitmap, x + radius, y + height-radius*1, width - radius*2, radius-1, the_color);
-		Bitmap_Fill(the_bitmap, x + radius - 1, y + 1, the_color);
-		Bitmap_Fill(the_bitmap, x + (width - radius) + 1, y + 1, the_color);
-		Bitmap_Fill(the_bitmap, x + radius - 1, y + (height - radius) + 1, the_color);
-		Bitmap_Fill(the_bitmap, x + (width - radius) + 1, y + (height - radius) + 1, the_color);
-	}
-		
 	return true;
 }
 
 
-//! Draw a circle
-//! Based on http://rosettacode.org/wiki/Bitmap/Midpoint_circle_algorithm#C
-bool Bitmap_DrawCircle(Bitmap* the_bitmap, int16_t x1, int16_t y1, int16_t radius, uint8_t the_color)
+//! Fill a polygon with any number of sides from 3 to BITMAP_MAX_POLYGON_POINTS, such as an arrow, a pie slice, or a star
+//! The polygon is filled one scanline at a time, with no flood fill, so it doesn't matter what is already drawn in or around it.
+//! The last point is joined back to the first. A pixel is filled if its top left corner is inside the polygon, so a square with corners at (0, 0) and (10, 10) fills 10 x 10 pixels,
+//!   and polygons that share an edge don't both fill the pixels along it. Any part of the polygon outside the bitmap is clipped.
+//! @param	the_points: array of at least num_points coordinates, each between -BITMAP_MAX_POLYGON_COORD and BITMAP_MAX_POLYGON_COORD
+//! @param	num_points: number of points in the array, from 3 to BITMAP_MAX_POLYGON_POINTS
+//! @param	the_color: a 1-byte index to the current LUT
+//! @param	use_nonzero: PARAM_FILL_NONZERO to fill every area the outline goes around, PARAM_FILL_EVEN_ODD to leave holes where it goes around an even number of times (the middle of a 5-pointed star, for example)
+//! @return	returns false on any error/invalid input.
+bool Bitmap_FillPolygon(Bitmap* the_bitmap, Coordinate* the_points, int16_t num_points, uint8_t the_color, bool use_nonzero)
 {
+	int16_t		i;
+	
 	if (the_bitmap == NULL)
 	{
 		LOG_ERR(("%s %d: passed bitmap was NULL", __func__, __LINE__));
 		return false;
 	}
 
-	if (!Bitmap_ValidateXY(the_bitmap, x1, y1))
+	if (the_points == NULL || num_points < 3 || num_points > BITMAP_MAX_POLYGON_POINTS)
 	{
-		LOG_ERR(("%s %d: illegal coordinate", __func__, __LINE__));
+		LOG_ERR(("%s %d: illegal number of points (%i)", __func__, __LINE__, num_points));
 		return false;
 	}
+	
+	for (i = 0; i < num_points; i++)
+	{
+		if (abs(the_points[i].x) > BITMAP_MAX_POLYGON_COORD || abs(the_points[i].y) > BITMAP_MAX_POLYGON_COORD)
+		{
+			LOG_ERR(("%s %d: illegal coordinate %i, %i", __func__, __LINE__, the_points[i].x, the_points[i].y));
+			return false;
+		}
+	}
 
-	return Bitmap_DrawCircleQuadrants(the_bitmap, x1, y1, radius, the_color, PARAM_DRAW_NE, PARAM_DRAW_SE, PARAM_DRAW_SW, PARAM_DRAW_NW);
+	Bitmap_FillPolygonScanlines(the_bitmap, the_points, num_points, the_color, use_nonzero);
+	
+	return true;
 }
 
 
+
 // **** Draw string functions *****
 
 
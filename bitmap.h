@@ -67,18 +67,17 @@
 /*                            Macro Definitions                              */
 /*****************************************************************************/
 
-#define PARAM_DRAW_NE		true	//!< for Bitmap_DrawCircleQuadrants, do draw NE quadrant
-#define PARAM_DRAW_SE		true	//!< for Bitmap_DrawCircleQuadrants, do draw SE quadrant
-#define PARAM_DRAW_SW		true	//!< for Bitmap_DrawCircleQuadrants, do draw SW quadrant
-#define PARAM_DRAW_NW		true	//!< for Bitmap_DrawCircleQuadrants, do draw NW quadrant
-#define PARAM_SKIP_NE		false	//!< for Bitmap_DrawCircleQuadrants, do NOT draw NE quadrant
-#define PARAM_SKIP_SE		false	//!< for Bitmap_DrawCircleQuadrants, do NOT draw SE quadrant
-#define PARAM_SKIP_SW		false	//!< for Bitmap_DrawCircleQuadrants, do NOT draw SW quadrant
-#define PARAM_SKIP_NW		false	//!< for Bitmap_DrawCircleQuadrants, do NOT draw NW quadrant
-
 #define PARAM_DO_FILL		true	//!< for various graphic routines
 #define PARAM_DO_NOT_FILL	false	//!< for various graphic routines
 
+#define BITMAP_MAX_RADIUS	1600	//!< largest radius for circles and ellipses. keeps the span math within 32 bits.
+#define BITMAP_MAX_LINE_SPAN	32767	//!< most pixels a line can run horizontally or vertically. keeps the clipping math within 32 bits.
+#define BITMAP_MAX_POLYGON_POINTS	64		//!< most points in a polygon passed to Bitmap_FillPolygon
+#define BITMAP_MAX_POLYGON_COORD	16383	//!< largest coordinate, positive or negative, for a polygon point. keeps the edge stepping within 16 bits, and the clipping math within 32 bits.
+
+#define PARAM_FILL_NONZERO	true	//!< for Bitmap_FillPolygon: fill every area the outline goes around
+#define PARAM_FILL_EVEN_ODD	false	//!< for Bitmap_FillPolygon: fill only areas the outline goes around an odd number of times
+
 #define PARAM_IN_VRAM		true	//!< for Bitmap_New
 #define PARAM_NOT_IN_VRAM	false	//!< for Bitmap_New
 
@@ -87,6 +86,16 @@
 /*                               Enumerations                                */
 /*****************************************************************************/
 
+//! How Bitmap_BlitRop() and Bitmap_DrawBoxRop() combine each source pixel (or the passed color) with the destination pixel
+typedef enum bitmap_rop
+{
+	ROP_COPY		= 0,	//!< dst = src
+	ROP_XOR			= 1,	//!< dst = dst ^ src. doing it twice puts dst back.
+	ROP_OR			= 2,	//!< dst = dst | src
+	ROP_AND			= 3,	//!< dst = dst & src
+	ROP_NOT_SRC		= 4,	//!< dst = ~src
+	ROP_INVERT		= 5,	//!< dst = ~dst. src is ignored. doing it twice puts dst back.
+} bitmap_rop;
 
 
 /*****************************************************************************/
@@ -105,6 +114,7 @@ struct Bitmap
 	unsigned char*	addr_;		//!< address of the start of the bitmap, within the machine's global address space. This is not the VICKY's local address for this bitmap. This address MUST be within the VRAM, however, it cannot be in non-VRAM memory space.
 	uint32_t		addr_int_;	//!< address of the start of the bitmap, as an unsigned long int. For use with plotting locations on 65816/Calypsi, which imposed a max 64k data size (at the moment)
 	bool			in_vram_;	//!< a way to know if this bitmap is pointing to VRAM or standard RAM space.
+	uint32_t		alloc_size_;	//!< bytes of standard RAM allocated at addr_. Can be more than width_ * height_, as storage is kept when a bitmap shrinks. 0 for VRAM bitmaps, and while storage is released.
 };
 
 
@@ -142,6 +152,15 @@ bool Bitmap_Destroy(Bitmap** the_bitmap);
 //! @return	Returns false in any error condition
 bool Bitmap_Resize(Bitmap* the_bitmap, int16_t width, int16_t height);
 
+//! Free the pixel storage of a bitmap held in standard RAM, keeping the bitmap object and its dimensions
+//! NOTE: until Bitmap_RestoreStorage() is called, nothing may be drawn into or blitted from the bitmap
+//! @return	Returns false in any error condition, including if the bitmap is held in VRAM
+bool Bitmap_ReleaseStorage(Bitmap* the_bitmap);
+
+//! Re-allocate (cleared) pixel storage for a bitmap whose storage was freed with Bitmap_ReleaseStorage(), at its current width/height
+//! @return	Returns false in any error condition
+bool Bitmap_RestoreStorage(Bitmap* the_bitmap);
+
 
 
 
@@ -158,6 +177,7 @@ bool Bitmap_BlitRect(Bitmap* src_bm, Rectangle* src_rect, Bitmap* dst_bm, int16_
 
 //! Blit from source bitmap to distination bitmap. 
 //! The source and destination bitmaps can be the same: you can use this to copy a chunk of pixels from one part of a screen to another. If the destination location cannot fit the entirety of the copied rectangle, the copy will be truncated, but will not return an error. 
+//! The source and destination rects may overlap (eg, when scrolling the contents of a bitmap): the copy is done in an order that does not overwrite pixels before they are read.
 //! @param src_bm: the source bitmap. It must have a valid address within the VRAM memory space.
 //! @param dst_bm: the destination bitmap. It must have a valid address within the VRAM memory space. It can be the same bitmap as the source.
 //! @param src_x, src_y: the upper left coordinate within the source bitmap, for the rectangle you want to copy. May be negative.
@@ -165,29 +185,27 @@ bool Bitmap_BlitRect(Bitmap* src_bm, Rectangle* src_rect, Bitmap* dst_bm, int16_
 //! @param width, height: the scope of the copy, in pixels.
 bool Bitmap_Blit(Bitmap* src_bm, int16_t src_x, int16_t src_y, Bitmap* dst_bm, int16_t dst_x, int16_t dst_y, int16_t width, int16_t height);
 
-//! Tile the source bitmap into the destination bitmap, filling it
-//! The source and destination bitmaps can be the same: you can use this to copy a chunk of pixels from one part of a screen to another. If the destination location cannot fit the entirety of the copied rectangle, the copy will be truncated, but will not return an error. 
+//! Blit from source bitmap to destination bitmap, combining the source pixels with the destination pixels using a raster operation
+//! Clipping, and overlapping source and destination rects, are handled the same as for Bitmap_Blit().
+//! XOR-ing the same source onto the same spot twice puts the destination back the way it was, so a highlight can be toggled on and off without redrawing what is under it.
 //! @param src_bm: the source bitmap. It must have a valid address within the VRAM memory space.
 //! @param dst_bm: the destination bitmap. It must have a valid address within the VRAM memory space. It can be the same bitmap as the source.
-//! @param src_x, src_y: the upper left coordinate within the source bitmap, for the tile you want to copy. Must be non-negative.
-//! @param width, height: the size of the tile to be derived from the source bitmap, in pixels.
-bool Bitmap_Tile(Bitmap* src_bm, int16_t src_x, int16_t src_y, Bitmap* dst_bm, int16_t width, int16_t height);
-
-//! Tile the source bitmap into the destination bitmap, filling it
-//! The source and destination bitmaps can be the same: you can use this to copy a chunk of pixels from one part of a screen to another. If the destination location cannot fit the entirety of the copied rectangle, the copy will be truncated, but will not return an error. 
-//! @param src_bm: the source bitmap. It must have a valid address within the VRAM memory space.
-//! @param dst_bm: the destination bitmap. It must have a valid address within the VRAM memory space. It can be the same bitmap as the source.
-//! @param src_x, src_y: the upper left coordinate within the source bitmap, for the tile you want to copy. Must be non-negative.
-//! @param width, height: the size of the tile to be derived from the source bitmap, in pixels.
-bool Bitmap_TileV1(Bitmap* src_bm, int16_t src_x, int16_t src_y, Bitmap* dst_bm, int16_t width, int16_t height);
+//! @param src_x, src_y: the upper left coordinate within the source bitmap, for the rectangle you want to copy. May be negative.
+//! @param dst_x, dst_y: the location within the destination bitmap to copy pixels to. May be negative.
+//! @param width, height: the scope of the copy, in pixels.
+//! @param the_rop: how to combine each source pixel with the destination pixel. ROP_COPY is the same as Bitmap_Blit(). ROP_INVERT ignores the source.
+bool Bitmap_BlitRop(Bitmap* src_bm, int16_t src_x, int16_t src_y, Bitmap* dst_bm, int16_t dst_x, int16_t dst_y, int16_t width, int16_t height, bitmap_rop the_rop);
 
-//! Tile the source bitmap into the destination bitmap, filling it
-//! The source and destination bitmaps can be the same: you can use this to copy a chunk of pixels from one part of a screen to another. If the destination location cannot fit the entirety of the copied rectangle, the copy will be truncated, but will not return an error. 
+//! Tile the source bitmap into all or part of the destination bitmap
+//! The pattern is always lined up with the top left corner of the destination bitmap, so tiling any part of it gives the same pixels as tiling the whole thing.
+//!   Use this to repair only the damaged parts of a patterned backdrop.
 //! @param src_bm: the source bitmap. It must have a valid address within the VRAM memory space.
-//! @param dst_bm: the destination bitmap. It must have a valid address within the VRAM memory space. It can be the same bitmap as the source.
 //! @param src_x, src_y: the upper left coordinate within the source bitmap, for the tile you want to copy. Must be non-negative.
-//! @param width, height: the size of the tile to be derived from the source bitmap, in pixels.
-bool Bitmap_TileV2(Bitmap* src_bm, int16_t src_x, int16_t src_y, Bitmap* dst_bm, int16_t width, int16_t height);
+//! @param dst_bm: the destination bitmap. It must have a valid address within the VRAM memory space. It must not be the same bitmap as the source.
+//! @param width, height: the size of the tile to be derived from the source bitmap, in pixels. The entire tile must be within the source bitmap.
+//! @param dst_rect: the part of the destination bitmap to fill, with MaxX and MaxY included. Any part off the bitmap is clipped. Pass NULL to fill the whole bitmap.
+//! @return	returns false on any error/invalid input.
+bool Bitmap_Tile(Bitmap* src_bm, int16_t src_x, int16_t src_y, Bitmap* dst_bm, int16_t width, int16_t height, Rectangle* dst_rect);
 
 
 
@@ -209,6 +227,14 @@ bool Bitmap_FillBoxRect(Bitmap* the_bitmap, Rectangle* the_coords, uint8_t the_c
 //! @return	returns false on any error/invalid input.
 bool Bitmap_FillBox(Bitmap* the_bitmap, int16_t x, int16_t y, int16_t width, int16_t height, uint8_t the_color);
 
+//! Fill a batch of rectangles with the same color
+//! Cheaper than calling Bitmap_FillBox() for each one: the bitmap is validated once, and each rectangle is clipped to the bitmap rather than rejected.
+//! @param	the_rects: array of at least num_rects rectangles. MinX to MaxX and MinY to MaxY are all filled, including MaxX and MaxY. Rectangles with MaxX < MinX or MaxY < MinY are skipped.
+//! @param	num_rects: number of rectangles in the array
+//! @param	the_color: a 1-byte index to the current LUT
+//! @return	returns false on any error/invalid input.
+bool Bitmap_FillBoxes(Bitmap* the_bitmap, Rectangle* the_rects, int16_t num_rects, uint8_t the_color);
+
 
 
 
@@ -269,6 +295,9 @@ uint32_t Bitmap_GetMemLocInt(Bitmap* the_bitmap);
 //! @return Returns NULL on any error
 Font* Bitmap_GetFont(Bitmap* the_bitmap);
 
+//! Get the total number of bytes copied by Bitmap_Blit() and its wrappers, across all bitmaps
+uint32_t Bitmap_GetBytesBlitted(void);
+
 
 
 // **** Set pixel functions *****
@@ -279,6 +308,14 @@ Font* Bitmap_GetFont(Bitmap* the_bitmap);
 //! @return	returns false on any error/invalid input.
 bool Bitmap_SetPixelAtXY(Bitmap* the_bitmap, int16_t x, int16_t y, uint8_t the_color);
 
+//! Set a batch of pixels to the same color
+//! Cheaper than calling Bitmap_SetPixelAtXY() for each one: the bitmap is validated once, and points off the bitmap are skipped without logging.
+//! @param	the_points: array of at least num_points coordinates
+//! @param	num_points: number of points in the array
+//! @param	the_color: a 1-byte index to the current LUT
+//! @return	returns false on any error/invalid input.
+bool Bitmap_SetPixels(Bitmap* the_bitmap, Coordinate* the_points, int16_t num_points, uint8_t the_color);
+
 
 
 // **** Get pixel functions *****
@@ -295,9 +332,28 @@ uint8_t Bitmap_GetPixelAtXY(Bitmap* the_bitmap, int16_t x, int16_t y);
 
 //! Draws a line between 2 passed coordinates.
 //! Use for any line that is not perfectly vertical or perfectly horizontal
-//! Based on http://rosettacode.org/wiki/Bitmap/Bresenham%27s_line_algorithm#C. Used in C128 Lich King. 
+//! Either end, or both, may be off the bitmap: the line is clipped once to the bitmap, and only the part on the bitmap is drawn.
+//! @param	the_color: a 1-byte index to the current LUT
+//! @return	returns false on any error/invalid input, including a line that runs more than BITMAP_MAX_LINE_SPAN pixels in either direction. A line that is entirely off the bitmap is not an error.
 bool Bitmap_DrawLine(Bitmap* the_bitmap, int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint8_t the_color);
 
+//! Draws connected lines through a series of points, from the first to the last
+//! Cheaper than calling Bitmap_DrawLine() for each segment: the bitmap is validated once, and each join is drawn once, not twice.
+//! Points may be off the bitmap; each segment is clipped.
+//! @param	the_points: array of at least num_points coordinates. To draw a closed shape, repeat the first point at the end.
+//! @param	num_points: number of points in the array. 1 point draws a single pixel.
+//! @param	the_color: a 1-byte index to the current LUT
+//! @return	returns false on any error/invalid input, including a segment that runs more than BITMAP_MAX_LINE_SPAN pixels in either direction. Nothing is drawn if any segment is invalid.
+bool Bitmap_DrawPolyline(Bitmap* the_bitmap, Coordinate* the_points, int16_t num_points, uint8_t the_color);
+
+//! Draws a batch of separate lines with the same color
+//! Cheaper than calling Bitmap_DrawLine() for each one: the bitmap is validated once. Each line is clipped to the bitmap.
+//! @param	the_points: array of at least num_lines * 2 coordinates: the start and end of the first line, then the start and end of the second, and so on
+//! @param	num_lines: number of lines to draw
+//! @param	the_color: a 1-byte index to the current LUT
+//! @return	returns false on any error/invalid input, including a line that runs more than BITMAP_MAX_LINE_SPAN pixels in either direction. Nothing is drawn if any line is invalid.
+bool Bitmap_DrawLines(Bitmap* the_bitmap, Coordinate* the_points, int16_t num_lines, uint8_t the_color);
+
 //! Draws a horizontal line from specified coords, for n pixels, using the specified pixel value
 //! @param	the_color: a 1-byte index to the current LUT
 //! @return	returns false on any error/invalid input.
@@ -326,19 +382,59 @@ bool Bitmap_DrawBoxCoords(Bitmap* the_bitmap, int16_t x1, int16_t y1, int16_t x2
 //! @return	returns false on any error/invalid input.
 bool Bitmap_DrawBox(Bitmap* the_bitmap, int16_t x, int16_t y, int16_t width, int16_t height, uint8_t the_color, bool do_fill);
 
+//! Draws a rectangle, or fills it, combining the_color with the pixels already there using a raster operation
+//! Use for highlights, carets, drag outlines, and inverted menu items: drawing the same box with ROP_XOR or ROP_INVERT a second time puts back what was under it, with no redraw.
+//! Each pixel is only changed once, even at the corners of an outline, so XOR and invert undo cleanly. Any part of the box off the bitmap is clipped.
+//! @param	width: width, in pixels, of the rectangle to be drawn
+//! @param	height: height, in pixels, of the rectangle to be drawn
+//! @param	the_color: a 1-byte index to the current LUT. Ignored for ROP_INVERT.
+//! @param	do_fill: If true, the box will be filled. If false, only the outline will be drawn.
+//! @param	the_rop: how to combine the_color with each pixel in the box. ROP_COPY draws the box normally.
+//! @return	returns false on any error/invalid input.
+bool Bitmap_DrawBoxRop(Bitmap* the_bitmap, int16_t x, int16_t y, int16_t width, int16_t height, uint8_t the_color, bool do_fill, bitmap_rop the_rop);
+
 //! Draws a rounded rectangle with the specified size and radius, and optionally fills the rectangle.
+//! Each row is drawn as one or two horizontal spans, so a filled round rect draws at close to the speed of a plain filled rect.
 //! @param	width: width, in pixels, of the rectangle to be drawn
 //! @param	height: height, in pixels, of the rectangle to be drawn
-//! @param	radius: radius, in pixels, of the arc to be applied to the rectangle's corners. Minimum 3, maximum 20.
+//! @param	radius: radius, in pixels, of the arc to be applied to the rectangle's corners. 0 draws square corners. Radii too big for the rectangle are reduced to half its width or height, whichever is smaller.
 //! @param	the_color: a 1-byte index to the current color LUT
 //! @param	do_fill: If true, the box will be filled with the provided color. If false, the box will only draw the outline.
 //! @return	returns false on any error/invalid input.
 bool Bitmap_DrawRoundBox(Bitmap* the_bitmap, int16_t x, int16_t y, int16_t width, int16_t height, int16_t radius, uint8_t the_color, bool do_fill);
 
 //! Draw a circle
-//! Based on http://rosettacode.org/wiki/Bitmap/Midpoint_circle_algorithm#C
+//! @param	radius: radius, in pixels, of the circle, between 0 and BITMAP_MAX_RADIUS. Any part of the circle that falls outside the bitmap is clipped.
+//! @param	the_color: a 1-byte index to the current color LUT
+//! @return	returns false on any error/invalid input.
 bool Bitmap_DrawCircle(Bitmap* the_bitmap, int16_t x1, int16_t y1, int16_t radius, uint8_t the_color);
 
+//! Draw a filled circle
+//! @param	radius: radius, in pixels, of the circle, between 0 and BITMAP_MAX_RADIUS. Any part of the circle that falls outside the bitmap is clipped.
+//! @param	the_color: a 1-byte index to the current color LUT
+//! @return	returns false on any error/invalid input.
+bool Bitmap_FillCircle(Bitmap* the_bitmap, int16_t x1, int16_t y1, int16_t radius, uint8_t the_color);
+
+//! Draw an ellipse, and optionally fill it. Each row is drawn as one span if filled, or two short spans if not.
+//! @param	x1: the horizontal position of the center of the ellipse. Must be within the bitmap.
+//! @param	y1: the vertical position of the center of the ellipse. Must be within the bitmap.
+//! @param	radius_x: horizontal radius, in pixels, between 0 and BITMAP_MAX_RADIUS. Any part of the ellipse that falls outside the bitmap is clipped.
+//! @param	radius_y: vertical radius, in pixels, between 0 and BITMAP_MAX_RADIUS
+//! @param	the_color: a 1-byte index to the current color LUT
+//! @param	do_fill: If true, the ellipse will be filled with the provided color. If false, only the outline will be drawn.
+//! @return	returns false on any error/invalid input.
+bool Bitmap_DrawEllipse(Bitmap* the_bitmap, int16_t x1, int16_t y1, int16_t radius_x, int16_t radius_y, uint8_t the_color, bool do_fill);
+
+//! Fill a polygon with any number of sides from 3 to BITMAP_MAX_POLYGON_POINTS, such as an arrow, a pie slice, or a star
+//! The polygon is filled one scanline at a time, with no flood fill, so it doesn't matter what is already drawn in or around it.
+//! The last point is joined back to the first. A pixel is filled if its top left corner is inside the polygon, so a square with corners at (0, 0) and (10, 10) fills 10 x 10 pixels,
+//!   and polygons that share an edge don't both fill the pixels along it. Any part of the polygon outside the bitmap is clipped.
+//! @param	the_points: array of at least num_points coordinates, each between -BITMAP_MAX_POLYGON_COORD and BITMAP_MAX_POLYGON_COORD
+//! @param	num_points: number of points in the array, from 3 to BITMAP_MAX_POLYGON_POINTS
+//! @param	the_color: a 1-byte index to the current LUT
+//! @param	use_nonzero: PARAM_FILL_NONZERO to fill every area the outline goes around, PARAM_FILL_EVEN_ODD to leave holes where it goes around an even number of times (the middle of a 5-pointed star, for example)
+//! @return	returns false on any error/invalid input.
+bool Bitmap_FillPolygon(Bitmap* the_bitmap, Coordinate* the_points, int16_t num_points, uint8_t the_color, bool use_nonzero);
 
 
 
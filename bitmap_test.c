@@ -24,6 +24,7 @@
 
 // C includes
 #include <stdbool.h>
+#include <stdlib.h>
 
 
 // A2560 includes
@@ -65,9 +66,196 @@ extern System*			global_system;
 /*                       Private Function Definitions                        */
 /*****************************************************************************/
 
+// count the pixels of the_color, and get the smallest rect holding all of them. the extent is left empty (MinX > MaxX) if there are none.
+static uint32_t bitmap_test_count_color(Bitmap* the_bitmap, uint8_t the_color, Rectangle* the_extent)
+{
+	uint32_t	the_count = 0;
+	int16_t		x;
+	int16_t		y;
+	
+	the_extent->MinX = the_bitmap->width_;
+	the_extent->MinY = the_bitmap->height_;
+	the_extent->MaxX = -1;
+	the_extent->MaxY = -1;
+	
+	for (y = 0; y < the_bitmap->height_; y++)
+	{
+		for (x = 0; x < the_bitmap->width_; x++)
+		{
+			if (Bitmap_GetPixelAtXY(the_bitmap, x, y) == the_color)
+			{
+				the_count++;
+				the_extent->MinX = (x < the_extent->MinX) ? x : the_extent->MinX;
+				the_extent->MinY = (y < the_extent->MinY) ? y : the_extent->MinY;
+				the_extent->MaxX = (x > the_extent->MaxX) ? x : the_extent->MaxX;
+				the_extent->MaxY = (y > the_extent->MaxY) ? y : the_extent->MaxY;
+			}
+		}
+	}
+	
+	return the_count;
+}
+
+
+// true if the rect has exactly the passed corners
+static bool bitmap_test_rect_is(Rectangle* the_rect, int16_t x1, int16_t y1, int16_t x2, int16_t y2)
+{
+	return (the_rect->MinX == x1 && the_rect->MinY == y1 && the_rect->MaxX == x2 && the_rect->MaxY == y2);
+}
+
+
+// true if every pixel of the_bitmap is the same as the pixel x_offset, y_offset away in the_reference. pixels whose match would be off the_reference must be 0.
+static bool bitmap_test_matches_shifted(Bitmap* the_bitmap, Bitmap* the_reference, int16_t x_offset, int16_t y_offset)
+{
+	int16_t		x;
+	int16_t		y;
+	int16_t		ref_x;
+	int16_t		ref_y;
+	uint8_t		the_expected_color;
+	
+	for (y = 0; y < the_bitmap->height_; y++)
+	{
+		for (x = 0; x < the_bitmap->width_; x++)
+		{
+			ref_x = x + x_offset;
+			ref_y = y + y_offset;
+			the_expected_color = 0;
+			
+			if (ref_x >= 0 && ref_x < the_reference->width_ && ref_y >= 0 && ref_y < the_reference->height_)
+			{
+				the_expected_color = Bitmap_GetPixelAtXY(the_reference, ref_x, ref_y);
+			}
+			
+			if (Bitmap_GetPixelAtXY(the_bitmap, x, y) != the_expected_color)
+			{
+				return false;
+			}
+		}
+	}
+	
+	return true;
+}
+
+
+// true if every pixel that is not 0 in the_other is also not 0 in the_bitmap
+static bool bitmap_test_covers(Bitmap* the_bitmap, Bitmap* the_other)
+{
+	int16_t		x;
+	int16_t		y;
+	
+	for (y = 0; y < the_bitmap->height_; y++)
+	{
+		for (x = 0; x < the_bitmap->width_; x++)
+		{
+			if (Bitmap_GetPixelAtXY(the_other, x, y) != 0 && Bitmap_GetPixelAtXY(the_bitmap, x, y) == 0)
+			{
+				return false;
+			}
+		}
+	}
+	
+	return true;
+}
+
+
+
+
+
+// fill the bitmap with a pattern of every color, different for each seed, so raster ops have all bit combinations to work on
+static void bitmap_test_fill_pattern(Bitmap* the_bitmap, uint8_t the_seed)
+{
+	int16_t		x;
+	int16_t		y;
+	
+	for (y = 0; y < the_bitmap->height_; y++)
+	{
+		for (x = 0; x < the_bitmap->width_; x++)
+		{
+			Bitmap_SetPixelAtXY(the_bitmap, x, y, (uint8_t)(x * 7 + y * 13 + the_seed * 31) ^ (uint8_t)(y * the_seed));
+		}
+	}
+}
+
+
+// check every pixel of the bitmap against the tiling rule: inside the rect (or everywhere, if it is NULL) the pixel comes from the tile at x mod width, y mod height; outside it, the pixel is still the background color
+static bool bitmap_test_matches_tile(Bitmap* the_bitmap, Bitmap* the_pattern, int16_t src_x, int16_t src_y, int16_t width, int16_t height, Rectangle* the_rect, uint8_t the_background)
+{
+	int16_t		x;
+	int16_t		y;
+	uint8_t		the_expected_color;
+	
+	for (y = 0; y < the_bitmap->height_; y++)
+	{
+		for (x = 0; x < the_bitmap->width_; x++)
+		{
+			the_expected_color = the_background;
+			
+			if (the_rect == NULL || (x >= the_rect->MinX && x <= the_rect->MaxX && y >= the_rect->MinY && y <= the_rect->MaxY))
+			{
+				the_expected_color = Bitmap_GetPixelAtXY(the_pattern, src_x + x % width, src_y + y % height);
+			}
+			
+			if (Bitmap_GetPixelAtXY(the_bitmap, x, y) != the_expected_color)
+			{
+				return false;
+			}
+		}
+	}
+	
+	return true;
+}
+
 
+// the polygon fill rule, one pixel at a time: a pixel is inside if its top left corner is. each edge counts for the scanlines from its top y up to, but not including, its bottom y, if it crosses them at or left of the pixel.
+static bool bitmap_test_pixel_in_polygon(Coordinate* the_points, int16_t num_points, int16_t x, int16_t y, bool use_nonzero)
+{
+	int32_t		x1;
+	int32_t		y1;
+	int32_t		x2;
+	int32_t		y2;
+	int16_t		the_winding = 0;
+	int16_t		i;
+	
+	for (i = 0; i < num_points; i++)
+	{
+		x1 = the_points[i].x;
+		y1 = the_points[i].y;
+		x2 = the_points[(i + 1) % num_points].x;
+		y2 = the_points[(i + 1) % num_points].y;
+		
+		if (y1 < y2 && y >= y1 && y < y2 && x1 * (y2 - y1) + (x2 - x1) * (y - y1) <= x * (y2 - y1))
+		{
+			the_winding++;
+		}
+		else if (y2 < y1 && y >= y2 && y < y1 && x2 * (y1 - y2) + (x1 - x2) * (y - y2) <= x * (y1 - y2))
+		{
+			the_winding--;
+		}
+	}
+	
+	return use_nonzero ? (the_winding != 0) : ((the_winding & 1) != 0);
+}
 
 
+// true if exactly the pixels inside the polygon are 1, and all others are 0
+static bool bitmap_test_matches_polygon(Bitmap* the_bitmap, Coordinate* the_points, int16_t num_points, bool use_nonzero)
+{
+	int16_t		x;
+	int16_t		y;
+	
+	for (y = 0; y < the_bitmap->height_; y++)
+	{
+		for (x = 0; x < the_bitmap->width_; x++)
+		{
+			if (Bitmap_GetPixelAtXY(the_bitmap, x, y) != (bitmap_test_pixel_in_polygon(the_points, num_points, x, y, use_nonzero) ? 1 : 0))
+			{
+				return false;
+			}
+		}
+	}
+	
+	return true;
+}
 
 
 /*****************************************************************************/
@@ -91,30 +279,525 @@ void bitmap_test_teardown(void)	// this is called EVERY test
 
 
 
+// **** unit tests
+
+MU_TEST(bitmap_test_round_shapes)
+{
+	Bitmap*		the_bitmap;
+	Bitmap*		the_reference;
+	Rectangle	the_extent;
+	Rectangle	the_outline_extent;
+	uint32_t	the_count;
+	int16_t		i;
+	int16_t		the_centers[6][2] = {{0, 24}, {63, 24}, {32, 0}, {32, 47}, {0, 0}, {63, 47}};
+	
+	mu_assert( (the_bitmap = Bitmap_New(64, 48, NULL, PARAM_NOT_IN_VRAM)) != NULL, "Could not create a bitmap" );
+	mu_assert( (the_reference = Bitmap_New(64, 48, NULL, PARAM_NOT_IN_VRAM)) != NULL, "Could not create a bitmap" );
+	
+	// radius 0: a round box is a plain box, a circle is one pixel, and a flat ellipse is a line
+	Bitmap_FillMemory(the_bitmap, 0);
+	mu_assert( Bitmap_DrawRoundBox(the_bitmap, 10, 5, 20, 12, 0, 1, PARAM_DO_FILL), "Bitmap_DrawRoundBox failed" );
+	mu_assert_int_eq(20 * 12, bitmap_test_count_color(the_bitmap, 1, &the_extent));
+	mu_assert( bitmap_test_rect_is(&the_extent, 10, 5, 29, 16), "round box with radius 0 is not the box" );
+	
+	Bitmap_FillMemory(the_bitmap, 0);
+	mu_assert( Bitmap_DrawRoundBox(the_bitmap, 10, 5, 20, 12, 0, 1, PARAM_DO_NOT_FILL), "Bitmap_DrawRoundBox failed" );
+	mu_assert_int_eq(20 * 2 + 12 * 2 - 4, bitmap_test_count_color(the_bitmap, 1, &the_extent));
+	mu_assert( bitmap_test_rect_is(&the_extent, 10, 5, 29, 16), "round box outline with radius 0 is not the box outline" );
+	
+	Bitmap_FillMemory(the_bitmap, 0);
+	mu_assert( Bitmap_FillCircle(the_bitmap, 30, 20, 0, 1), "Bitmap_FillCircle failed" );
+	mu_assert( Bitmap_DrawCircle(the_bitmap, 30, 20, 0, 1), "Bitmap_DrawCircle failed" );
+	mu_assert_int_eq(1, bitmap_test_count_color(the_bitmap, 1, &the_extent));
+	mu_assert( bitmap_test_rect_is(&the_extent, 30, 20, 30, 20), "circle with radius 0 is not one pixel" );
+	
+	Bitmap_FillMemory(the_bitmap, 0);
+	mu_assert( Bitmap_DrawEllipse(the_bitmap, 30, 20, 5, 0, 1, PARAM_DO_NOT_FILL), "Bitmap_DrawEllipse failed" );
+	mu_assert_int_eq(11, bitmap_test_count_color(the_bitmap, 1, &the_extent));
+	mu_assert( bitmap_test_rect_is(&the_extent, 25, 20, 35, 20), "ellipse with vertical radius 0 is not a line" );
+	
+	// a radius too big for the box is cut down to half the shorter side, and a negative one to 0
+	Bitmap_FillMemory(the_bitmap, 0);
+	mu_assert( Bitmap_DrawRoundBox(the_bitmap, 10, 5, 20, 12, 6, 1, PARAM_DO_FILL), "Bitmap_DrawRoundBox failed" );
+	the_count = bitmap_test_count_color(the_bitmap, 1, &the_extent);
+	mu_assert( the_count < 20 * 12, "round box corners were not rounded" );
+	
+	Bitmap_FillMemory(the_bitmap, 0);
+	mu_assert( Bitmap_DrawRoundBox(the_bitmap, 10, 5, 20, 12, 100, 1, PARAM_DO_FILL), "Bitmap_DrawRoundBox failed" );
+	mu_assert_int_eq(the_count, bitmap_test_count_color(the_bitmap, 1, &the_extent));
+	mu_assert( bitmap_test_rect_is(&the_extent, 10, 5, 29, 16), "round box with a clamped radius is not the size of the box" );
+	
+	Bitmap_FillMemory(the_bitmap, 0);
+	mu_assert( Bitmap_DrawRoundBox(the_bitmap, 10, 5, 20, 12, -3, 1, PARAM_DO_FILL), "Bitmap_DrawRoundBox failed" );
+	mu_assert_int_eq(20 * 12, bitmap_test_count_color(the_bitmap, 1, &the_extent));
+	
+	// clipping: a circle or ellipse centered on each edge and corner draws exactly the part of a whole one that is on the bitmap
+	for (i = 0; i < 6; i++)
+	{
+		Bitmap_FillMemory(the_reference, 0);
+		Bitmap_FillMemory(the_bitmap, 0);
+		Bitmap_FillCircle(the_reference, 32, 24, 10, 1);
+		mu_assert( Bitmap_FillCircle(the_bitmap, the_centers[i][0], the_centers[i][1], 10, 1), "Bitmap_FillCircle failed on an edge" );
+		mu_assert( bitmap_test_matches_shifted(the_bitmap, the_reference, 32 - the_centers[i][0], 24 - the_centers[i][1]), "clipped filled circle is not part of the whole circle" );
+		
+		Bitmap_FillMemory(the_reference, 0);
+		Bitmap_FillMemory(the_bitmap, 0);
+		Bitmap_DrawEllipse(the_reference, 32, 24, 14, 8, 1, PARAM_DO_NOT_FILL);
+		mu_assert( Bitmap_DrawEllipse(the_bitmap, the_centers[i][0], the_centers[i][1], 14, 8, 1, PARAM_DO_NOT_FILL), "Bitmap_DrawEllipse failed on an edge" );
+		mu_assert( bitmap_test_matches_shifted(the_bitmap, the_reference, 32 - the_centers[i][0], 24 - the_centers[i][1]), "clipped ellipse outline is not part of the whole ellipse" );
+	}
+	
+	// a round box can touch every edge, but not go past any of them
+	mu_assert( Bitmap_DrawRoundBox(the_bitmap, 0, 0, 64, 48, 10, 1, PARAM_DO_FILL), "Bitmap_DrawRoundBox refused a box the size of the bitmap" );
+	mu_assert( Bitmap_DrawRoundBox(the_bitmap, -1, 0, 64, 48, 10, 1, PARAM_DO_FILL) == false, "Bitmap_DrawRoundBox accepted a box past the left edge" );
+	mu_assert( Bitmap_DrawRoundBox(the_bitmap, 1, 0, 64, 48, 10, 1, PARAM_DO_FILL) == false, "Bitmap_DrawRoundBox accepted a box past the right edge" );
+	mu_assert( Bitmap_DrawRoundBox(the_bitmap, 0, -1, 64, 48, 10, 1, PARAM_DO_FILL) == false, "Bitmap_DrawRoundBox accepted a box past the top edge" );
+	mu_assert( Bitmap_DrawRoundBox(the_bitmap, 0, 1, 64, 48, 10, 1, PARAM_DO_FILL) == false, "Bitmap_DrawRoundBox accepted a box past the bottom edge" );
+	
+	// a filled shape has the same extent as its outline, and covers every pixel of it
+	for (i = 0; i < 3; i++)
+	{
+		Bitmap_FillMemory(the_reference, 0);
+		Bitmap_FillMemory(the_bitmap, 0);
+		
+		if (i == 0)
+		{
+			Bitmap_DrawCircle(the_reference, 32, 24, 10, 1);
+			Bitmap_FillCircle(the_bitmap, 32, 24, 10, 1);
+		}
+		else if (i == 1)
+		{
+			Bitmap_DrawEllipse(the_reference, 32, 24, 14, 8, 1, PARAM_DO_NOT_FILL);
+			Bitmap_DrawEllipse(the_bitmap, 32, 24, 14, 8, 1, PARAM_DO_FILL);
+		}
+		else
+		{
+			Bitmap_DrawRoundBox(the_reference, 8, 6, 41, 30, 9, 1, PARAM_DO_NOT_FILL);
+			Bitmap_DrawRoundBox(the_bitmap, 8, 6, 41, 30, 9, 1, PARAM_DO_FILL);
+		}
+		
+		bitmap_test_count_color(the_reference, 1, &the_outline_extent);
+		bitmap_test_count_color(the_bitmap, 1, &the_extent);
+		mu_assert( bitmap_test_rect_is(&the_extent, the_outline_extent.MinX, the_outline_extent.MinY, the_outline_extent.MaxX, the_outline_extent.MaxY), "filled shape is not the size of its outline" );
+		mu_assert( bitmap_test_covers(the_bitmap, the_reference), "filled shape does not cover its outline" );
+	}
+	
+	Bitmap_Destroy(&the_bitmap);
+	Bitmap_Destroy(&the_reference);
+}
+
+
+
+MU_TEST(bitmap_test_lines)
+{
+	Bitmap*		the_bitmap;
+	Bitmap*		the_reference;
+	Rectangle	the_extent;
+	int16_t		i;
+	int16_t		the_crossing_lines[7][4] = {
+					{-20, 10, 30, 30},		// left edge
+					{40, 5, 90, 25},		// right edge
+					{10, -15, 30, 40},		// top edge
+					{50, 20, 40, 70},		// bottom edge
+					{-30, -20, 90, 70},		// in at the top left, out at the bottom right
+					{70, -10, -5, 60},		// in at the top right, out at the bottom left
+					{-25, 47, 88, 47},		// along the bottom row, off both sides
+				};
+	int16_t		the_outside_lines[5][4] = {
+					{-10, -5, -1, 40},		// left of the bitmap
+					{64, 0, 90, 47},		// right of it
+					{0, -1, 63, -20},		// above it
+					{5, 48, 60, 71},		// below it
+					{-10, 5, 5, -10},		// across the top left corner, without touching the bitmap
+				};
+	
+	mu_assert( (the_bitmap = Bitmap_New(64, 48, NULL, PARAM_NOT_IN_VRAM)) != NULL, "Could not create a bitmap" );
+	mu_assert( (the_reference = Bitmap_New(128, 96, NULL, PARAM_NOT_IN_VRAM)) != NULL, "Could not create a bitmap" );
+	
+	// a line fully inside has one pixel per step along its longer side, from one end to the other
+	Bitmap_FillMemory(the_bitmap, 0);
+	mu_assert( Bitmap_DrawLine(the_bitmap, 5, 5, 20, 12, 1), "Bitmap_DrawLine failed" );
+	mu_assert_int_eq(16, bitmap_test_count_color(the_bitmap, 1, &the_extent));
+	mu_assert( bitmap_test_rect_is(&the_extent, 5, 5, 20, 12), "line inside the bitmap does not run from end to end" );
+	mu_assert( Bitmap_GetPixelAtXY(the_bitmap, 5, 5) == 1 && Bitmap_GetPixelAtXY(the_bitmap, 20, 12) == 1, "line inside the bitmap is missing an end" );
+	
+	Bitmap_FillMemory(the_bitmap, 0);
+	mu_assert( Bitmap_DrawLine(the_bitmap, 30, 40, 22, 2, 1), "Bitmap_DrawLine failed" );
+	mu_assert_int_eq(39, bitmap_test_count_color(the_bitmap, 1, &the_extent));
+	mu_assert( bitmap_test_rect_is(&the_extent, 22, 2, 30, 40), "steep line inside the bitmap does not run from end to end" );
+	
+	// a line crossing any edge draws the same pixels as the whole line would, where they are on the bitmap
+	for (i = 0; i < 7; i++)
+	{
+		Bitmap_FillMemory(the_reference, 0);
+		Bitmap_FillMemory(the_bitmap, 0);
+		Bitmap_DrawLine(the_reference, the_crossing_lines[i][0] + 32, the_crossing_lines[i][1] + 24, the_crossing_lines[i][2] + 32, the_crossing_lines[i][3] + 24, 1);
+		mu_assert( Bitmap_DrawLine(the_bitmap, the_crossing_lines[i][0], the_crossing_lines[i][1], the_crossing_lines[i][2], the_crossing_lines[i][3], 1), "Bitmap_DrawLine failed on a line crossing an edge" );
+		mu_assert( bitmap_test_count_color(the_bitmap, 1, &the_extent) > 0, "clipped line drew nothing" );
+		mu_assert( bitmap_test_matches_shifted(the_bitmap, the_reference, 32, 24), "clipped line is not part of the whole line" );
+	}
+	
+	// a line fully outside draws nothing, and is not an error
+	Bitmap_FillMemory(the_bitmap, 0);
+	
+	for (i = 0; i < 5; i++)
+	{
+		mu_assert( Bitmap_DrawLine(the_bitmap, the_outside_lines[i][0], the_outside_lines[i][1], the_outside_lines[i][2], the_outside_lines[i][3], 1), "Bitmap_DrawLine refused a line outside the bitmap" );
+	}
+	
+	mu_assert_int_eq(0, bitmap_test_count_color(the_bitmap, 1, &the_extent));
+	
+	// a line from a point to itself is one pixel, including in a corner
+	mu_assert( Bitmap_DrawLine(the_bitmap, 7, 9, 7, 9, 1), "Bitmap_DrawLine failed on a single pixel" );
+	mu_assert( Bitmap_DrawLine(the_bitmap, 63, 47, 63, 47, 1), "Bitmap_DrawLine failed on a single pixel" );
+	mu_assert_int_eq(2, bitmap_test_count_color(the_bitmap, 1, &the_extent));
+	mu_assert( Bitmap_GetPixelAtXY(the_bitmap, 7, 9) == 1 && Bitmap_GetPixelAtXY(the_bitmap, 63, 47) == 1, "single pixel line drawn in the wrong place" );
+	
+	// too long to step safely
+	mu_assert( Bitmap_DrawLine(the_bitmap, -20000, 0, 20000, 0, 1) == false, "Bitmap_DrawLine accepted a line longer than BITMAP_MAX_LINE_SPAN" );
+	
+	Bitmap_Destroy(&the_bitmap);
+	Bitmap_Destroy(&the_reference);
+}
+
+
+
+MU_TEST(bitmap_test_polygons)
+{
+	Bitmap*		the_bitmap;
+	Rectangle	the_extent;
+	int16_t		i;
+	int16_t		j;
+	Coordinate	the_square[4] = {{5, 5}, {15, 5}, {15, 15}, {5, 15}};
+	Coordinate	the_star[5] = {{32, 2}, {45, 42}, {11, 17}, {53, 17}, {19, 42}};
+	Coordinate	the_twice_around[8] = {{10, 10}, {30, 10}, {30, 30}, {10, 30}, {10, 10}, {30, 10}, {30, 30}, {10, 30}};
+	Coordinate	the_shapes[4][4] = {
+					{{0, -16000}, {63, 47}, {1, 47}, {1, 40}},			// long steep edges, clipped at the top
+					{{-9000, 3}, {70, 4}, {70, 45}, {-9000, 44}},		// long shallow edges, clipped at the left
+					{{3, 1}, {61, 46}, {2, 46}, {60, 2}},				// a bow tie: edges cross in the middle
+					{{-16383, -16383}, {16383, 16383}, {-16383, 16383}, {-16383, 0}},	// the biggest coordinates allowed
+				};
+	
+	mu_assert( (the_bitmap = Bitmap_New(64, 48, NULL, PARAM_NOT_IN_VRAM)) != NULL, "Could not create a bitmap" );
+	
+	// a square from 5, 5 to 15, 15 covers 10 x 10 pixels, from 5, 5 to 14, 14
+	Bitmap_FillMemory(the_bitmap, 0);
+	mu_assert( Bitmap_FillPolygon(the_bitmap, the_square, 4, 1, PARAM_FILL_EVEN_ODD), "Bitmap_FillPolygon failed" );
+	mu_assert_int_eq(100, bitmap_test_count_color(the_bitmap, 1, &the_extent));
+	mu_assert( bitmap_test_rect_is(&the_extent, 5, 5, 14, 14), "square polygon is not 10 x 10 pixels" );
+	
+	// a 5 pointed star: even-odd leaves the middle empty, non-zero fills it
+	Bitmap_FillMemory(the_bitmap, 0);
+	mu_assert( Bitmap_FillPolygon(the_bitmap, the_star, 5, 1, PARAM_FILL_EVEN_ODD), "Bitmap_FillPolygon failed" );
+	mu_assert( Bitmap_GetPixelAtXY(the_bitmap, 32, 24) == 0, "even-odd filled the middle of the star" );
+	mu_assert( Bitmap_GetPixelAtXY(the_bitmap, 32, 8) == 1, "even-odd did not fill a point of the star" );
+	mu_assert( bitmap_test_matches_polygon(the_bitmap, the_star, 5, PARAM_FILL_EVEN_ODD), "even-odd star is not filled by the rule" );
+	
+	Bitmap_FillMemory(the_bitmap, 0);
+	mu_assert( Bitmap_FillPolygon(the_bitmap, the_star, 5, 1, PARAM_FILL_NONZERO), "Bitmap_FillPolygon failed" );
+	mu_assert( Bitmap_GetPixelAtXY(the_bitmap, 32, 24) == 1, "non-zero did not fill the middle of the star" );
+	mu_assert( Bitmap_GetPixelAtXY(the_bitmap, 32, 8) == 1, "non-zero did not fill a point of the star" );
+	mu_assert( bitmap_test_matches_polygon(the_bitmap, the_star, 5, PARAM_FILL_NONZERO), "non-zero star is not filled by the rule" );
+	
+	// going round a square twice: even-odd fills nothing, non-zero fills all of it
+	Bitmap_FillMemory(the_bitmap, 0);
+	mu_assert( Bitmap_FillPolygon(the_bitmap, the_twice_around, 8, 1, PARAM_FILL_EVEN_ODD), "Bitmap_FillPolygon failed" );
+	mu_assert_int_eq(0, bitmap_test_count_color(the_bitmap, 1, &the_extent));
+	mu_assert( Bitmap_FillPolygon(the_bitmap, the_twice_around, 8, 1, PARAM_FILL_NONZERO), "Bitmap_FillPolygon failed" );
+	mu_assert_int_eq(400, bitmap_test_count_color(the_bitmap, 1, &the_extent));
+	
+	// long edges, clipped edges, and crossing edges all land on exactly the pixels the rule says, in both modes
+	for (i = 0; i < 4; i++)
+	{
+		for (j = 0; j < 2; j++)
+		{
+			Bitmap_FillMemory(the_bitmap, 0);
+			mu_assert( Bitmap_FillPolygon(the_bitmap, the_shapes[i], 4, 1, (j == 0) ? PARAM_FILL_EVEN_ODD : PARAM_FILL_NONZERO), "Bitmap_FillPolygon failed" );
+			mu_assert( bitmap_test_matches_polygon(the_bitmap, the_shapes[i], 4, (j == 0) ? PARAM_FILL_EVEN_ODD : PARAM_FILL_NONZERO), "polygon edge is off by a pixel" );
+		}
+	}
+	
+	// bad values
+	mu_assert( Bitmap_FillPolygon(the_bitmap, the_square, 2, 1, PARAM_FILL_EVEN_ODD) == false, "Bitmap_FillPolygon accepted 2 points" );
+	mu_assert( Bitmap_FillPolygon(the_bitmap, the_square, BITMAP_MAX_POLYGON_POINTS + 1, 1, PARAM_FILL_EVEN_ODD) == false, "Bitmap_FillPolygon accepted too many points" );
+	the_square[0].x = BITMAP_MAX_POLYGON_COORD + 1;
+	mu_assert( Bitmap_FillPolygon(the_bitmap, the_square, 4, 1, PARAM_FILL_EVEN_ODD) == false, "Bitmap_FillPolygon accepted a coordinate past BITMAP_MAX_POLYGON_COORD" );
+	
+	Bitmap_Destroy(&the_bitmap);
+}
+
+
+MU_TEST(bitmap_test_batches)
+{
+	Bitmap*		the_bitmap;
+	Bitmap*		the_reference;
+	Rectangle	the_extent;
+	int16_t		i;
+	int16_t		x;
+	int16_t		y;
+	bool		is_inside;
+	Coordinate	the_points[7] = {{0, 0}, {63, 47}, {10, 20}, {-1, 0}, {64, 5}, {3, -1}, {3, 48}};
+	Coordinate	the_line_points[8] = {{2, 3}, {40, 9}, {-10, 30}, {70, 20}, {5, 5}, {5, 5}, {-5, -5}, {-1, 80}};
+	Coordinate	the_too_long[4] = {{0, 0}, {10, 10}, {-20000, 0}, {20000, 0}};
+	Rectangle	the_rects[5] = {{2, 2, 10, 6}, {-5, 40, 3, 60}, {60, -3, 70, 2}, {20, 20, 19, 30}, {8, 4, 12, 8}};
+	
+	mu_assert( (the_bitmap = Bitmap_New(64, 48, NULL, PARAM_NOT_IN_VRAM)) != NULL, "Could not create a bitmap" );
+	mu_assert( (the_reference = Bitmap_New(64, 48, NULL, PARAM_NOT_IN_VRAM)) != NULL, "Could not create a bitmap" );
+	
+	// pixels: points on the bitmap are set, points off it are skipped
+	Bitmap_FillMemory(the_bitmap, 0);
+	mu_assert( Bitmap_SetPixels(the_bitmap, the_points, 7, 1), "Bitmap_SetPixels failed" );
+	mu_assert_int_eq(3, bitmap_test_count_color(the_bitmap, 1, &the_extent));
+	mu_assert( Bitmap_GetPixelAtXY(the_bitmap, 0, 0) == 1 && Bitmap_GetPixelAtXY(the_bitmap, 63, 47) == 1 && Bitmap_GetPixelAtXY(the_bitmap, 10, 20) == 1, "Bitmap_SetPixels set the wrong pixels" );
+	mu_assert( Bitmap_SetPixels(the_bitmap, the_points, 0, 1), "Bitmap_SetPixels failed on 0 points" );
+	mu_assert( Bitmap_SetPixels(the_bitmap, NULL, 1, 1) == false, "Bitmap_SetPixels accepted no points" );
+	
+	// lines: the same pixels as one Bitmap_DrawLine() per line, including lines that are clipped or off the bitmap
+	Bitmap_FillMemory(the_bitmap, 0);
+	Bitmap_FillMemory(the_reference, 0);
+	mu_assert( Bitmap_DrawLines(the_bitmap, the_line_points, 4, 1), "Bitmap_DrawLines failed" );
+	
+	for (i = 0; i < 8; i += 2)
+	{
+		Bitmap_DrawLine(the_reference, the_line_points[i].x, the_line_points[i].y, the_line_points[i+1].x, the_line_points[i+1].y, 1);
+	}
+	
+	mu_assert( bitmap_test_matches_shifted(the_bitmap, the_reference, 0, 0), "Bitmap_DrawLines did not draw the same as Bitmap_DrawLine" );
+	
+	// a polyline through the same points is the same as a line between each pair of points
+	Bitmap_FillMemory(the_bitmap, 0);
+	Bitmap_FillMemory(the_reference, 0);
+	mu_assert( Bitmap_DrawPolyline(the_bitmap, the_line_points, 8, 1), "Bitmap_DrawPolyline failed" );
+	
+	for (i = 1; i < 8; i++)
+	{
+		Bitmap_DrawLine(the_reference, the_line_points[i-1].x, the_line_points[i-1].y, the_line_points[i].x, the_line_points[i].y, 1);
+	}
+	
+	mu_assert( bitmap_test_matches_shifted(the_bitmap, the_reference, 0, 0), "Bitmap_DrawPolyline did not draw the same as Bitmap_DrawLine" );
+	
+	// one bad line and nothing is drawn
+	Bitmap_FillMemory(the_bitmap, 0);
+	mu_assert( Bitmap_DrawLines(the_bitmap, the_too_long, 2, 1) == false, "Bitmap_DrawLines accepted a line longer than BITMAP_MAX_LINE_SPAN" );
+	mu_assert( Bitmap_DrawPolyline(the_bitmap, the_too_long, 4, 1) == false, "Bitmap_DrawPolyline accepted a segment longer than BITMAP_MAX_LINE_SPAN" );
+	mu_assert_int_eq(0, bitmap_test_count_color(the_bitmap, 1, &the_extent));
+	mu_assert( Bitmap_DrawLines(the_bitmap, the_line_points, 0, 1), "Bitmap_DrawLines failed on 0 lines" );
+	
+	// rects: each is clipped to the bitmap, and empty ones are skipped
+	Bitmap_FillMemory(the_bitmap, 0);
+	mu_assert( Bitmap_FillBoxes(the_bitmap, the_rects, 5, 1), "Bitmap_FillBoxes failed" );
+	
+	for (y = 0; y < 48; y++)
+	{
+		for (x = 0; x < 64; x++)
+		{
+			is_inside = false;
+			
+			for (i = 0; i < 5; i++)
+			{
+				is_inside = is_inside || (x >= the_rects[i].MinX && x <= the_rects[i].MaxX && y >= the_rects[i].MinY && y <= the_rects[i].MaxY);
+			}
+			
+			mu_assert( Bitmap_GetPixelAtXY(the_bitmap, x, y) == (is_inside ? 1 : 0), "Bitmap_FillBoxes filled the wrong pixels" );
+		}
+	}
+	
+	mu_assert( Bitmap_FillBoxes(the_bitmap, NULL, 1, 1) == false, "Bitmap_FillBoxes accepted no rects" );
+	
+	Bitmap_Destroy(&the_bitmap);
+	Bitmap_Destroy(&the_reference);
+}
+
+
+
+MU_TEST(bitmap_test_rops)
+{
+	Bitmap*		the_src;
+	Bitmap*		the_dst;
+	Bitmap*		the_saved;
+	uint8_t		the_src_color;
+	uint8_t		the_dst_color;
+	uint8_t		the_expected_color;
+	int16_t		i;
+	int16_t		x;
+	int16_t		y;
+	bool		is_inside;
+	bool		is_edge;
+	bitmap_rop	the_rops[4] = {ROP_AND, ROP_OR, ROP_NOT_SRC, ROP_COPY};
+	int16_t		the_blits[4][6] = {
+					{0, 0, 0, 0, 64, 48},		// whole bitmap, rows lined up on 4-byte boundaries
+					{3, 1, 6, 5, 37, 20},		// source and destination out of step, so the row is done a byte at a time
+					{5, 2, 9, 7, 7, 3},			// short rows in step, with a ragged start and end
+					{10, 10, -4, 40, 30, 20},	// clipped on the left and bottom of the destination
+				};
+	
+	mu_assert( (the_src = Bitmap_New(64, 48, NULL, PARAM_NOT_IN_VRAM)) != NULL, "Could not create a bitmap" );
+	mu_assert( (the_dst = Bitmap_New(64, 48, NULL, PARAM_NOT_IN_VRAM)) != NULL, "Could not create a bitmap" );
+	mu_assert( (the_saved = Bitmap_New(64, 48, NULL, PARAM_NOT_IN_VRAM)) != NULL, "Could not create a bitmap" );
+	bitmap_test_fill_pattern(the_src, 1);
+	bitmap_test_fill_pattern(the_dst, 2);
+	Bitmap_Blit(the_dst, 0, 0, the_saved, 0, 0, 64, 48);
+	
+	// XOR-ing the same source onto the same spot twice puts the destination back, and so does inverting twice
+	for (i = 0; i < 4; i++)
+	{
+		mu_assert( Bitmap_BlitRop(the_src, the_blits[i][0], the_blits[i][1], the_dst, the_blits[i][2], the_blits[i][3], the_blits[i][4], the_blits[i][5], ROP_XOR), "Bitmap_BlitRop failed" );
+		mu_assert( bitmap_test_matches_shifted(the_dst, the_saved, 0, 0) == false, "XOR did not change the destination" );
+		mu_assert( Bitmap_BlitRop(the_src, the_blits[i][0], the_blits[i][1], the_dst, the_blits[i][2], the_blits[i][3], the_blits[i][4], the_blits[i][5], ROP_XOR), "Bitmap_BlitRop failed" );
+		mu_assert( bitmap_test_matches_shifted(the_dst, the_saved, 0, 0), "XOR twice did not restore the destination" );
+		
+		mu_assert( Bitmap_BlitRop(the_src, the_blits[i][0], the_blits[i][1], the_dst, the_blits[i][2], the_blits[i][3], the_blits[i][4], the_blits[i][5], ROP_INVERT), "Bitmap_BlitRop failed" );
+		mu_assert( Bitmap_BlitRop(the_src, the_blits[i][0], the_blits[i][1], the_dst, the_blits[i][2], the_blits[i][3], the_blits[i][4], the_blits[i][5], ROP_INVERT), "Bitmap_BlitRop failed" );
+		mu_assert( bitmap_test_matches_shifted(the_dst, the_saved, 0, 0), "invert twice did not restore the destination" );
+	}
+	
+	mu_assert( Bitmap_DrawBoxRop(the_dst, 3, 2, 50, 40, 0x5A, PARAM_DO_FILL, ROP_XOR), "Bitmap_DrawBoxRop failed" );
+	mu_assert( Bitmap_DrawBoxRop(the_dst, 3, 2, 50, 40, 0x5A, PARAM_DO_FILL, ROP_XOR), "Bitmap_DrawBoxRop failed" );
+	mu_assert( bitmap_test_matches_shifted(the_dst, the_saved, 0, 0), "XOR box twice did not restore the destination" );
+	mu_assert( Bitmap_DrawBoxRop(the_dst, -5, 7, 30, 60, 0, PARAM_DO_NOT_FILL, ROP_INVERT), "Bitmap_DrawBoxRop failed" );
+	mu_assert( Bitmap_DrawBoxRop(the_dst, -5, 7, 30, 60, 0, PARAM_DO_NOT_FILL, ROP_INVERT), "Bitmap_DrawBoxRop failed" );
+	mu_assert( bitmap_test_matches_shifted(the_dst, the_saved, 0, 0), "inverted outline twice did not restore the destination" );
+	
+	// AND, OR, NOT and copy give the right pixel inside the blit, and leave every pixel outside it alone
+	for (i = 0; i < 4; i++)
+	{
+		Bitmap_Blit(the_saved, 0, 0, the_dst, 0, 0, 64, 48);
+		mu_assert( Bitmap_BlitRop(the_src, the_blits[1][0], the_blits[1][1], the_dst, the_blits[1][2], the_blits[1][3], the_blits[1][4], the_blits[1][5], the_rops[i]), "Bitmap_BlitRop failed" );
+		
+		for (y = 0; y < 48; y++)
+		{
+			for (x = 0; x < 64; x++)
+			{
+				the_dst_color = Bitmap_GetPixelAtXY(the_saved, x, y);
+				the_expected_color = the_dst_color;
+				
+				if (x >= the_blits[1][2] && x < the_blits[1][2] + the_blits[1][4] && y >= the_blits[1][3] && y < the_blits[1][3] + the_blits[1][5])
+				{
+					the_src_color = Bitmap_GetPixelAtXY(the_src, x - the_blits[1][2] + the_blits[1][0], y - the_blits[1][3] + the_blits[1][1]);
+					the_expected_color = (the_rops[i] == ROP_AND) ? (the_dst_color & the_src_color) : (the_rops[i] == ROP_OR) ? (the_dst_color | the_src_color) : (the_rops[i] == ROP_NOT_SRC) ? (uint8_t)~the_src_color : the_src_color;
+				}
+				
+				mu_assert( Bitmap_GetPixelAtXY(the_dst, x, y) == the_expected_color, "Bitmap_BlitRop combined a pixel wrongly" );
+			}
+		}
+	}
+	
+	// the same for a box combined with a color, filled and outlined
+	for (i = 0; i < 4; i++)
+	{
+		Bitmap_Blit(the_saved, 0, 0, the_dst, 0, 0, 64, 48);
+		mu_assert( Bitmap_DrawBoxRop(the_dst, 5, 3, 41, 30, 0x3C, (i & 1) ? PARAM_DO_NOT_FILL : PARAM_DO_FILL, (i < 2) ? ROP_AND : ROP_OR), "Bitmap_DrawBoxRop failed" );
+		
+		for (y = 0; y < 48; y++)
+		{
+			for (x = 0; x < 64; x++)
+			{
+				the_dst_color = Bitmap_GetPixelAtXY(the_saved, x, y);
+				is_inside = (x >= 5 && x <= 45 && y >= 3 && y <= 32);
+				is_edge = is_inside && (x == 5 || x == 45 || y == 3 || y == 32);
+				the_expected_color = the_dst_color;
+				
+				if ((i & 1) ? is_edge : is_inside)
+				{
+					the_expected_color = (i < 2) ? (the_dst_color & 0x3C) : (the_dst_color | 0x3C);
+				}
+				
+				mu_assert( Bitmap_GetPixelAtXY(the_dst, x, y) == the_expected_color, "Bitmap_DrawBoxRop combined a pixel wrongly" );
+			}
+		}
+	}
+	
+	Bitmap_Destroy(&the_src);
+	Bitmap_Destroy(&the_dst);
+	Bitmap_Destroy(&the_saved);
+}
+
+
+MU_TEST(bitmap_test_tile_pattern)
+{
+	Bitmap*		the_pattern;
+	Bitmap*		the_bitmap;
+	int16_t		i;
+	int16_t		j;
+	int16_t		the_tiles[6][4] = {
+					{0, 0, 16, 16},		// the usual backdrop tile, which divides the bitmap evenly
+					{0, 0, 3, 5},		// odd sizes, so every row starts at a different phase
+					{4, 9, 7, 1},		// a single row from the middle of the source
+					{21, 2, 13, 11},	// wider than a 4-byte copy, and not a multiple of it
+					{39, 29, 1, 1},		// one pixel from the far corner of the source
+					{0, 0, 40, 30},		// the whole source, only partly fitting the bitmap
+				};
+	Rectangle	the_extent;
+	Rectangle	the_rects[6] = {
+					{0, 0, 60, 36},		// the whole bitmap, passed as a rect
+					{5, 3, 30, 20},		// inside the bitmap, starting mid-tile
+					{-7, -4, 11, 9},	// off the top left
+					{45, 30, 99, 80},	// off the bottom right
+					{17, 0, 17, 36},	// one column
+					{23, 19, 22, 25},	// empty: max x is left of min x
+				};
+	
+	mu_assert( (the_pattern = Bitmap_New(40, 30, NULL, PARAM_NOT_IN_VRAM)) != NULL, "Could not create a bitmap" );
+	mu_assert( (the_bitmap = Bitmap_New(61, 37, NULL, PARAM_NOT_IN_VRAM)) != NULL, "Could not create a bitmap" );
+	bitmap_test_fill_pattern(the_pattern, 3);
+	
+	// LOGIC:
+	//   the pattern is lined up with the top left of the bitmap, so any part of it must match the same part of a full tiling, pixel for pixel.
+	//   the bitmap is an odd size, so the last tile on each row and column is cut short.
+	
+	for (i = 0; i < 6; i++)
+	{
+		Bitmap_FillMemory(the_bitmap, 0xEE);
+		mu_assert( Bitmap_Tile(the_pattern, the_tiles[i][0], the_tiles[i][1], the_bitmap, the_tiles[i][2], the_tiles[i][3], NULL), "Bitmap_Tile failed" );
+		mu_assert( bitmap_test_matches_tile(the_bitmap, the_pattern, the_tiles[i][0], the_tiles[i][1], the_tiles[i][2], the_tiles[i][3], NULL, 0xEE), "full tiling does not match the pattern" );
+		
+		for (j = 0; j < 6; j++)
+		{
+			Bitmap_FillMemory(the_bitmap, 0xEE);
+			mu_assert( Bitmap_Tile(the_pattern, the_tiles[i][0], the_tiles[i][1], the_bitmap, the_tiles[i][2], the_tiles[i][3], &the_rects[j]), "Bitmap_Tile failed" );
+			mu_assert( bitmap_test_matches_tile(the_bitmap, the_pattern, the_tiles[i][0], the_tiles[i][1], the_tiles[i][2], the_tiles[i][3], &the_rects[j], 0xEE), "tiling part of the bitmap does not match the pattern" );
+		}
+	}
+	
+	// a tile that does not fit in the source is refused, and leaves the bitmap alone
+	Bitmap_FillMemory(the_bitmap, 0xEE);
+	mu_assert( Bitmap_Tile(the_pattern, 30, 0, the_bitmap, 11, 5, NULL) == false, "Bitmap_Tile accepted a tile off the source" );
+	mu_assert( Bitmap_Tile(the_pattern, 0, 0, the_bitmap, 0, 5, NULL) == false, "Bitmap_Tile accepted an empty tile" );
+	mu_assert( bitmap_test_count_color(the_bitmap, 0xEE, &the_extent) == 61 * 37, "a refused tiling changed the bitmap" );
+	
+	Bitmap_Destroy(&the_pattern);
+	Bitmap_Destroy(&the_bitmap);
+}
+
+
+
 // **** speed tests
 
 MU_TEST(bitmap_test_tiling)
 {
-	long	start_ticks;
-	long	end_ticks;
-	long	test1_ticks;
-	long	test2_ticks;
-	long	test3_ticks;
-	int16_t	i;
-	int16_t	times_to_run = 100;
+	long		start_ticks;
+	long		end_ticks;
+	long		test1_ticks;
+	long		test2_ticks;
+	long		test3_ticks;
+	int16_t		i;
+	int16_t		j;
+	int16_t		times_to_run = 100;
+	Rectangle	the_window_rect = {100, 100, 419, 339};
+	Rectangle	the_damage[4] = {{100, 100, 419, 119}, {100, 120, 109, 329}, {410, 120, 419, 329}, {100, 330, 419, 339}};
 	
 	Theme*	the_theme = Sys_GetTheme(global_system);
 	Bitmap*	the_pattern = Theme_GetDesktopPattern(the_theme);
 	Bitmap*	the_target_bitmap = Sys_GetScreenBitmap(global_system, back_layer);
 	
 	
-	// test speed of first variant
+	// test speed of tiling the whole screen
 	start_ticks = mu_timer_real();
 
 	// speed test 1 goes here
 	for (i = 0; i < times_to_run; i++)
 	{
-		Bitmap_TileV1(the_pattern, 0, 0, the_target_bitmap, 16, 16);
+		Bitmap_Tile(the_pattern, 0, 0, the_target_bitmap, 16, 16, NULL);
 	}
 	
 	end_ticks = mu_timer_real();
@@ -122,13 +805,13 @@ MU_TEST(bitmap_test_tiling)
 
 
 	
-	// test speed of 2nd variant
+	// test speed of re-tiling the area under a closed window
 	start_ticks = mu_timer_real();
 	
 	// speed test 2 goes here
 	for (i = 0; i < times_to_run; i++)
 	{
-		Bitmap_TileV2(the_pattern, 0, 0, the_target_bitmap, 16, 16);
+		Bitmap_Tile(the_pattern, 0, 0, the_target_bitmap, 16, 16, &the_window_rect);
 	}
 		
 	end_ticks = mu_timer_real();
@@ -136,20 +819,376 @@ MU_TEST(bitmap_test_tiling)
 
 
 	
-	// test speed of 3rd variant
+	// test speed of re-tiling only the frame of a window that moved: 4 thin damage rects
 	start_ticks = mu_timer_real();
 	
 	// speed test 3 goes here
 	for (i = 0; i < times_to_run; i++)
 	{
-		Bitmap_Tile(the_pattern, 0, 0, the_target_bitmap, 16, 16);
+		for (j = 0; j < 4; j++)
+		{
+			Bitmap_Tile(the_pattern, 0, 0, the_target_bitmap, 16, 16, &the_damage[j]);
+		}
 	}
 		
 	end_ticks = mu_timer_real();
 	test3_ticks = end_ticks - start_ticks;
 	
-	printf("\nSpeed results: 1st: %li ticks; 2nd: %li ticks; 3rd: %li ticks\n", test1_ticks, test2_ticks, test3_ticks);
-	DEBUG_OUT(("Speed results: 1st: %li ticks; 2nd: %li ticks; 3rd: %li ticks", test1_ticks, test2_ticks, test3_ticks));
+	printf("\nSpeed results: full screen: %li ticks; window rect: %li ticks; damage rects: %li ticks\n", test1_ticks, test2_ticks, test3_ticks);
+	DEBUG_OUT(("Speed results: full screen: %li ticks; window rect: %li ticks; damage rects: %li ticks", test1_ticks, test2_ticks, test3_ticks));
+}
+
+
+
+MU_TEST(bitmap_test_line_speed)
+{
+	long		start_ticks;
+	long		end_ticks;
+	long		test1_ticks;
+	long		test2_ticks;
+	long		test3_ticks;
+	int16_t		i;
+	int16_t		j;
+	int16_t		x;
+	int16_t		y;
+	int16_t		times_to_run = 20;
+	int16_t		num_points = 33;
+	Coordinate	the_points[33];
+	
+	Bitmap*	the_target_bitmap = Sys_GetScreenBitmap(global_system, back_layer);
+	
+	// a zig-zag chart line across the screen, and partly off the bottom of it
+	for (j = 0; j < num_points; j++)
+	{
+		the_points[j].x = j * 19;
+		the_points[j].y = (j & 1) ? 50 : 500;
+	}
+	
+	// test speed of first variant: a pixel at a time, the way lines used to be drawn
+	start_ticks = mu_timer_real();
+
+	for (i = 0; i < times_to_run; i++)
+	{
+		for (j = 1; j < num_points; j++)
+		{
+			int16_t	dx = abs(the_points[j].x - the_points[j-1].x);
+			int16_t	dy = abs(the_points[j].y - the_points[j-1].y);
+			int16_t	sy = the_points[j-1].y < the_points[j].y ? 1 : -1;
+			int16_t	err = (dx > dy ? dx : -dy)/2;
+			int16_t	e2;
+			
+			x = the_points[j-1].x;
+			y = the_points[j-1].y;
+			
+			for(;;)
+			{
+				Bitmap_SetPixelAtXY(the_target_bitmap, x, y, i);
+				
+				if (x == the_points[j].x && y == the_points[j].y)
+				{
+					break;
+				}
+
+				e2 = err;
+				
+				if (e2 > -dx)
+				{
+					err -= dy;
+					x++;
+				}
+
+				if (e2 < dy)
+				{
+					err += dx;
+					y += sy;
+				}
+			}
+		}
+	}
+	
+	end_ticks = mu_timer_real();
+	test1_ticks = end_ticks - start_ticks;
+
+
+	
+	// test speed of 2nd variant
+	start_ticks = mu_timer_real();
+	
+	for (i = 0; i < times_to_run; i++)
+	{
+		for (j = 1; j < num_points; j++)
+		{
+			Bitmap_DrawLine(the_target_bitmap, the_points[j-1].x, the_points[j-1].y, the_points[j].x, the_points[j].y, i);
+		}
+	}
+		
+	end_ticks = mu_timer_real();
+	test2_ticks = end_ticks - start_ticks;
+
+
+	
+	// test speed of 3rd variant
+	start_ticks = mu_timer_real();
+	
+	for (i = 0; i < times_to_run; i++)
+	{
+		Bitmap_DrawPolyline(the_target_bitmap, the_points, num_points, i);
+	}
+		
+	end_ticks = mu_timer_real();
+	test3_ticks = end_ticks - start_ticks;
+	
+	printf("\nLine speed results: per-pixel: %li ticks; DrawLine: %li ticks; DrawPolyline: %li ticks\n", test1_ticks, test2_ticks, test3_ticks);
+	DEBUG_OUT(("Line speed results: per-pixel: %li ticks; DrawLine: %li ticks; DrawPolyline: %li ticks", test1_ticks, test2_ticks, test3_ticks));
+}
+
+
+
+MU_TEST(bitmap_test_batch_speed)
+{
+	long		start_ticks;
+	long		end_ticks;
+	long		points1_ticks;
+	long		points2_ticks;
+	long		lines1_ticks;
+	long		lines2_ticks;
+	long		rects1_ticks;
+	long		rects2_ticks;
+	int16_t		i;
+	int16_t		j;
+	int16_t		times_to_run = 20;
+	int16_t		num_items = 64;
+	Coordinate	the_points[128];
+	Rectangle	the_rects[64];
+	
+	Bitmap*	the_target_bitmap = Sys_GetScreenBitmap(global_system, back_layer);
+	
+	// scattered points, short lines (grid ticks), and small rects (bar chart bars), all on screen
+	for (j = 0; j < num_items; j++)
+	{
+		the_points[j * 2].x = 10 + j * 9;
+		the_points[j * 2].y = 20 + (j * 37) % 300;
+		the_points[j * 2 + 1].x = the_points[j * 2].x + 6;
+		the_points[j * 2 + 1].y = the_points[j * 2].y + 3;
+		the_rects[j].MinX = 10 + j * 9;
+		the_rects[j].MinY = 400 - (j * 13) % 200;
+		the_rects[j].MaxX = the_rects[j].MinX + 7;
+		the_rects[j].MaxY = 400;
+	}
+	
+	// points: one call per point, then one call for all of them
+	start_ticks = mu_timer_real();
+
+	for (i = 0; i < times_to_run; i++)
+	{
+		for (j = 0; j < num_items * 2; j++)
+		{
+			Bitmap_SetPixelAtXY(the_target_bitmap, the_points[j].x, the_points[j].y, i);
+		}
+	}
+	
+	end_ticks = mu_timer_real();
+	points1_ticks = end_ticks - start_ticks;
+
+	start_ticks = mu_timer_real();
+
+	for (i = 0; i < times_to_run; i++)
+	{
+		Bitmap_SetPixels(the_target_bitmap, the_points, num_items * 2, i);
+	}
+	
+	end_ticks = mu_timer_real();
+	points2_ticks = end_ticks - start_ticks;
+
+	// lines
+	start_ticks = mu_timer_real();
+
+	for (i = 0; i < times_to_run; i++)
+	{
+		for (j = 0; j < num_items * 2; j += 2)
+		{
+			Bitmap_DrawLine(the_target_bitmap, the_points[j].x, the_points[j].y, the_points[j+1].x, the_points[j+1].y, i);
+		}
+	}
+	
+	end_ticks = mu_timer_real();
+	lines1_ticks = end_ticks - start_ticks;
+
+	start_ticks = mu_timer_real();
+
+	for (i = 0; i < times_to_run; i++)
+	{
+		Bitmap_DrawLines(the_target_bitmap, the_points, num_items, i);
+	}
+	
+	end_ticks = mu_timer_real();
+	lines2_ticks = end_ticks - start_ticks;
+
+	// rects
+	start_ticks = mu_timer_real();
+
+	for (i = 0; i < times_to_run; i++)
+	{
+		for (j = 0; j < num_items; j++)
+		{
+			Bitmap_FillBox(the_target_bitmap, the_rects[j].MinX, the_rects[j].MinY, the_rects[j].MaxX - the_rects[j].MinX + 1, the_rects[j].MaxY - the_rects[j].MinY, i);
+		}
+	}
+	
+	end_ticks = mu_timer_real();
+	rects1_ticks = end_ticks - start_ticks;
+
+	start_ticks = mu_timer_real();
+
+	for (i = 0; i < times_to_run; i++)
+	{
+		Bitmap_FillBoxes(the_target_bitmap, the_rects, num_items, i);
+	}
+	
+	end_ticks = mu_timer_real();
+	rects2_ticks = end_ticks - start_ticks;
+	
+	printf("\nBatch speed results (per call / batched): points: %li / %li ticks; lines: %li / %li ticks; rects: %li / %li ticks\n", points1_ticks, points2_ticks, lines1_ticks, lines2_ticks, rects1_ticks, rects2_ticks);
+	DEBUG_OUT(("Batch speed results (per call / batched): points: %li / %li ticks; lines: %li / %li ticks; rects: %li / %li ticks", points1_ticks, points2_ticks, lines1_ticks, lines2_ticks, rects1_ticks, rects2_ticks));
+}
+
+
+MU_TEST(bitmap_test_polygon_speed)
+{
+	long		start_ticks;
+	long		end_ticks;
+	long		test1_ticks;
+	long		test2_ticks;
+	int16_t		i;
+	int16_t		times_to_run = 20;
+	Coordinate	the_arrow[7] = {{100, 200}, {200, 100}, {200, 150}, {300, 150}, {300, 250}, {200, 250}, {200, 300}};
+	
+	Bitmap*	the_target_bitmap = Sys_GetScreenBitmap(global_system, back_layer);
+	
+	// test speed of first variant: the arrow's bounding box, as a baseline for how close a polygon gets to a plain rect fill
+	start_ticks = mu_timer_real();
+
+	for (i = 0; i < times_to_run; i++)
+	{
+		Bitmap_FillBox(the_target_bitmap, 100, 100, 200, 199, i);
+	}
+	
+	end_ticks = mu_timer_real();
+	test1_ticks = end_ticks - start_ticks;
+
+	// test speed of 2nd variant
+	start_ticks = mu_timer_real();
+
+	for (i = 0; i < times_to_run; i++)
+	{
+		Bitmap_FillPolygon(the_target_bitmap, the_arrow, 7, i, PARAM_FILL_EVEN_ODD);
+	}
+	
+	end_ticks = mu_timer_real();
+	test2_ticks = end_ticks - start_ticks;
+	
+	printf("\nPolygon speed results: bounding box: %li ticks; polygon: %li ticks\n", test1_ticks, test2_ticks);
+	DEBUG_OUT(("Polygon speed results: bounding box: %li ticks; polygon: %li ticks", test1_ticks, test2_ticks));
+}
+
+
+
+MU_TEST(bitmap_test_round_speed)
+{
+	long		start_ticks;
+	long		end_ticks;
+	long		test1_ticks;
+	long		test2_ticks;
+	long		test3_ticks;
+	int16_t		i;
+	int16_t		times_to_run = 20;
+	
+	Bitmap*	the_target_bitmap = Sys_GetScreenBitmap(global_system, back_layer);
+	
+	// test speed of first variant: a plain box, as a baseline for how close a round shape gets to a plain rect fill
+	start_ticks = mu_timer_real();
+
+	for (i = 0; i < times_to_run; i++)
+	{
+		Bitmap_FillBox(the_target_bitmap, 100, 100, 200, 200, i);
+	}
+	
+	end_ticks = mu_timer_real();
+	test1_ticks = end_ticks - start_ticks;
+
+	// test speed of 2nd variant: the same box with round corners
+	start_ticks = mu_timer_real();
+
+	for (i = 0; i < times_to_run; i++)
+	{
+		Bitmap_DrawRoundBox(the_target_bitmap, 100, 100, 200, 200, 24, i, PARAM_DO_FILL);
+	}
+	
+	end_ticks = mu_timer_real();
+	test2_ticks = end_ticks - start_ticks;
+
+	// test speed of 3rd variant: the circle that fits in the box
+	start_ticks = mu_timer_real();
+
+	for (i = 0; i < times_to_run; i++)
+	{
+		Bitmap_FillCircle(the_target_bitmap, 200, 200, 99, i);
+	}
+	
+	end_ticks = mu_timer_real();
+	test3_ticks = end_ticks - start_ticks;
+	
+	printf("\nRound shape speed results: box: %li ticks; round box: %li ticks; circle: %li ticks\n", test1_ticks, test2_ticks, test3_ticks);
+	DEBUG_OUT(("Round shape speed results: box: %li ticks; round box: %li ticks; circle: %li ticks", test1_ticks, test2_ticks, test3_ticks));
+}
+
+
+
+MU_TEST(bitmap_test_rop_speed)
+{
+	long		start_ticks;
+	long		end_ticks;
+	long		test1_ticks;
+	long		test2_ticks;
+	int16_t		i;
+	int16_t		x;
+	int16_t		y;
+	int16_t		times_to_run = 10;
+	
+	Bitmap*	the_target_bitmap = Sys_GetScreenBitmap(global_system, back_layer);
+	
+	// toggling a 200 x 16 selection highlight on and off, as for a menu item
+	
+	// test speed of first variant: read, XOR, and write each pixel
+	start_ticks = mu_timer_real();
+
+	for (i = 0; i < times_to_run * 2; i++)
+	{
+		for (y = 100; y < 116; y++)
+		{
+			for (x = 100; x < 300; x++)
+			{
+				Bitmap_SetPixelAtXY(the_target_bitmap, x, y, Bitmap_GetPixelAtXY(the_target_bitmap, x, y) ^ 0xff);
+			}
+		}
+	}
+	
+	end_ticks = mu_timer_real();
+	test1_ticks = end_ticks - start_ticks;
+
+	// test speed of 2nd variant
+	start_ticks = mu_timer_real();
+
+	for (i = 0; i < times_to_run * 2; i++)
+	{
+		Bitmap_DrawBoxRop(the_target_bitmap, 100, 100, 200, 16, 0, PARAM_DO_FILL, ROP_INVERT);
+	}
+	
+	end_ticks = mu_timer_real();
+	test2_ticks = end_ticks - start_ticks;
+	
+	printf("\nRaster op speed results: per-pixel XOR: %li ticks; Bitmap_DrawBoxRop: %li ticks\n", test1_ticks, test2_ticks);
+	DEBUG_OUT(("Raster op speed results: per-pixel XOR: %li ticks; Bitmap_DrawBoxRop: %li ticks", test1_ticks, test2_ticks));
 }
 
 
@@ -160,6 +1199,11 @@ MU_TEST_SUITE(bitmap_test_suite_speed)
 	MU_SUITE_CONFIGURE(&bitmap_test_setup, &bitmap_test_teardown);
 	
 	MU_RUN_TEST(bitmap_test_tiling);
+	MU_RUN_TEST(bitmap_test_line_speed);
+	MU_RUN_TEST(bitmap_test_batch_speed);
+	MU_RUN_TEST(bitmap_test_polygon_speed);
+	MU_RUN_TEST(bitmap_test_round_speed);
+	MU_RUN_TEST(bitmap_test_rop_speed);
 }
 
 
@@ -168,6 +1212,12 @@ MU_TEST_SUITE(bitmap_test_suite_units)
 {	
 	MU_SUITE_CONFIGURE(&bitmap_test_setup, &bitmap_test_teardown);
 	
+	MU_RUN_TEST(bitmap_test_round_shapes);
+	MU_RUN_TEST(bitmap_test_lines);
+	MU_RUN_TEST(bitmap_test_polygons);
+	MU_RUN_TEST(bitmap_test_batches);
+	MU_RUN_TEST(bitmap_test_rops);
+	MU_RUN_TEST(bitmap_test_tile_pattern);
 // 	MU_RUN_TEST(font_replace_test);
 }
 
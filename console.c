@@ -0,0 +1,585 @@
+/*
+ * console.c
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+
+
+
+
+/*****************************************************************************/
+/*                                Includes                                   */
+/*****************************************************************************/
+
+// project includes
+#include "console.h"
+#include "text.h"
+
+// A2560 includes
+#include <mcp/syscalls.h>
+#include "lib_sys.h"
+#include "general.h"
+
+// C includes
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+
+/*****************************************************************************/
+/*                               Definitions                                 */
+/*****************************************************************************/
+
+
+
+/*****************************************************************************/
+/*                             Global Variables                              */
+/*****************************************************************************/
+
+extern System*			global_system;
+
+static Console*			console_log_target;		// console that logged messages are shown in, or NULL. see Console_SetLogConsole()
+static bool				console_in_log_hook;	// true while a logged message is being added, so anything logged by the console code itself is not added too
+
+
+
+/*****************************************************************************/
+/*                       Private Function Prototypes                         */
+/*****************************************************************************/
+
+// get the start of the passed line in the ring buffer
+char* Console_GetLine(Console* the_console, uint32_t the_line);
+
+// start a new line, wiping whatever older line used its slot in the ring buffer
+void Console_NewLine(Console* the_console);
+
+// the most lines the view can be scrolled back, given how many lines are in the buffer
+int16_t Console_GetMaxScrollBack(Console* the_console);
+
+// draw one line into one row of the console area
+void Console_DrawRow(Console* the_console, int16_t the_row, uint32_t the_line);
+
+// General_LogHook that adds each logged message to console_log_target
+void Console_LogHook(LoggingLevel the_level, const char* the_message);
+
+
+
+/*****************************************************************************/
+/*                       Private Function Definitions                        */
+/*****************************************************************************/
+
+// get the start of the passed line in the ring buffer
+char* Console_GetLine(Console* the_console, uint32_t the_line)
+{
+	return the_console->lines_ + (the_line % the_console->max_lines_) * the_console->width_;
+}
+
+
+// start a new line, wiping whatever older line used its slot in the ring buffer
+void Console_NewLine(Console* the_console)
+{
+	memset(Console_GetLine(the_console, the_console->line_count_), ' ', the_console->width_);
+
+	if (the_console->dirty_line_ > the_console->line_count_)
+	{
+		the_console->dirty_line_ = the_console->line_count_;
+	}
+
+	the_console->line_count_++;
+	the_console->cursor_x_ = 0;
+
+	// LOGIC:
+	//   if the user has scrolled back, keep the same lines in view while new ones come in,
+	//   until the lines they are looking at fall out of the buffer
+	if (the_console->scroll_back_ > 0)
+	{
+		the_console->scroll_back_++;
+
+		if (the_console->scroll_back_ > Console_GetMaxScrollBack(the_console))
+		{
+			the_console->scroll_back_ = Console_GetMaxScrollBack(the_console);
+		}
+	}
+}
+
+
+// the most lines the view can be scrolled back, given how many lines are in the buffer
+int16_t Console_GetMaxScrollBack(Console* the_console)
+{
+	uint32_t	lines_held;
+
+	// LOGIC: Console_New() makes height_ at least 1 and max_lines_ at least height_, so both can be compared as unsigned
+	lines_held = the_console->line_count_;
+
+	if (lines_held > (uint32_t)the_console->max_lines_)
+	{
+		lines_held = the_console->max_lines_;
+	}
+
+	if (lines_held <= (uint32_t)the_console->height_)
+	{
+		return 0;
+	}
+
+	return lines_held - the_console->height_;
+}
+
+
+// draw one line into one row of the console area
+void Console_DrawRow(Console* the_console, int16_t the_row, uint32_t the_line)
+{
+	Text_DrawCharsAtXY(the_console->screen_, the_console->x1_, the_console->y1_ + the_row, Console_GetLine(the_console, the_line), the_console->width_, the_console->fore_color_, the_console->back_color_);
+	the_console->rows_drawn_++;
+}
+
+
+// General_LogHook that adds each logged message to console_log_target
+void Console_LogHook(LoggingLevel the_level, const char* the_message)
+{
+	if (console_log_target == NULL || console_in_log_hook)
+	{
+		return;
+	}
+
+	console_in_log_hook = true;
+
+	if (console_log_target->cursor_x_ > 0)
+	{
+		Console_NewLine(console_log_target);
+	}
+
+	Console_Write(console_log_target, the_message);
+	Console_NewLine(console_log_target);
+
+	console_in_log_hook = false;
+}
+
+
+
+
+/*****************************************************************************/
+/*                        Public Function Definitions                        */
+/*****************************************************************************/
+
+
+
+// **** CONSTRUCTOR AND DESTRUCTOR *****
+
+
+// constructor
+//! Allocate a console for a rectangular area of a text screen. The area is cleared at the first render.
+//! @param	the_screen: valid pointer to the target screen to operate on
+//! @param	x1: the leftmost horizontal position, between 0 and the screen's text_cols_vis_ - 1
+//! @param	y1: the uppermost vertical position, between 0 and the screen's text_rows_vis_ - 1
+//! @param	x2: the rightmost horizontal position, between 0 and the screen's text_cols_vis_ - 1
+//! @param	y2: the lowermost vertical position, between 0 and the screen's text_rows_vis_ - 1
+//! @param	scrollback_lines: number of lines to remember, including the ones on screen
+//! @param	fore_color: Index to the desired foreground color (0-15)
+//! @param	back_color: Index to the desired background color (0-15)
+//! @return	Returns NULL on any error/invalid input, or if memory could not be allocated
+Console* Console_New(Screen* the_screen, int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t scrollback_lines, uint8_t fore_color, uint8_t back_color)
+{
+	Console*	the_console = NULL;
+
+	if (the_screen == NULL)
+	{
+		LOG_ERR(("%s %d: passed screen was NULL", __func__, __LINE__));
+		goto error;
+	}
+
+	if (x1 < 0 || y1 < 0 || x1 > x2 || y1 > y2 || x2 >= the_screen->text_cols_vis_ || y2 >= the_screen->text_rows_vis_)
+	{
+		LOG_ERR(("%s %d: illegal coordinates (%i, %i) - (%i, %i)", __func__, __LINE__, x1, y1, x2, y2));
+		goto error;
+	}
+
+	if ( (the_console = (Console*)calloc(1, sizeof(Console)) ) == NULL)
+	{
+		LOG_ERR(("%s %d: could not allocate memory to create new Console object", __func__ , __LINE__));
+		goto error;
+	}
+	LOG_ALLOC(("%s %d:	__ALLOC__	the_console	%p	size	%i", __func__ , __LINE__, the_console, sizeof(Console)));
+
+	the_console->screen_ = the_screen;
+	the_console->x1_ = x1;
+	the_console->y1_ = y1;
+	the_console->x2_ = x2;
+	the_console->y2_ = y2;
+	the_console->width_ = x2 - x1 + 1;
+	the_console->height_ = y2 - y1 + 1;
+	the_console->fore_color_ = fore_color;
+	the_console->back_color_ = back_color;
+
+	if (scrollback_lines < the_console->height_)
+	{
+		scrollback_lines = the_console->height_;
+	}
+
+	if (scrollback_lines < CONSOLE_MIN_SCROLLBACK)
+	{
+		scrollback_lines = CONSOLE_MIN_SCROLLBACK;
+	}
+
+	the_console->max_lines_ = scrollback_lines;
+
+	if ( (the_console->lines_ = (char*)calloc(the_console->max_lines_, the_console->width_) ) == NULL)
+	{
+		LOG_ERR(("%s %d: could not allocate memory for the scrollback buffer", __func__ , __LINE__));
+		goto error;
+	}
+	LOG_ALLOC(("%s %d:	__ALLOC__	the_console->lines_	%p	size	%i", __func__ , __LINE__, the_console->lines_, the_console->max_lines_ * the_console->width_));
+
+	Console_Clear(the_console);
+
+	return the_console;
+
+error:
+	if (the_console)	Console_Destroy(&the_console);
+	return NULL;
+}
+
+
+// destructor
+// frees all allocated memory associated with the passed object, and the object itself. If it was the log console, logging to it is stopped.
+void Console_Destroy(Console** the_console)
+{
+	if (*the_console == NULL)
+	{
+		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
+		return;
+	}
+
+	if (console_log_target == *the_console)
+	{
+		Console_SetLogConsole(NULL);
+	}
+
+	if ((*the_console)->lines_)
+	{
+		LOG_ALLOC(("%s %d:	__FREE__	(*the_console)->lines_	%p	size	%i", __func__ , __LINE__, (*the_console)->lines_, (*the_console)->max_lines_ * (*the_console)->width_));
+		free((*the_console)->lines_);
+		(*the_console)->lines_ = NULL;
+	}
+
+	LOG_ALLOC(("%s %d:	__FREE__	*the_console	%p	size	%i", __func__ , __LINE__, *the_console, sizeof(Console)));
+	free(*the_console);
+	*the_console = NULL;
+}
+
+
+
+
+// **** SETTERS *****
+
+
+//! Add a string to the end of the console. '\n' or '\r' start a new line, and lines longer than the console is wide are wrapped.
+//! Nothing is drawn until Console_Render() is called, so this is cheap enough to call from anywhere.
+//! @param	the_string: the null-terminated string to add
+void Console_Write(Console* the_console, const char* the_string)
+{
+	if (the_console == NULL)
+	{
+		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
+		goto error;
+	}
+
+	while (*the_string)
+	{
+		Console_PutChar(the_console, *the_string++);
+	}
+
+	return;
+
+error:
+	Sys_Destroy(&global_system);	// crash early, crash often
+	return;
+}
+
+
+//! Add one character to the end of the console. See Console_Write().
+void Console_PutChar(Console* the_console, char the_char)
+{
+	char*		the_line;
+
+	if (the_console == NULL)
+	{
+		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
+		goto error;
+	}
+
+	// LOGIC:
+	//   "\r\n" is one line break, not two
+	if (the_char == '\n' && the_console->last_was_cr_)
+	{
+		the_console->last_was_cr_ = false;
+		return;
+	}
+
+	the_console->last_was_cr_ = (the_char == '\r');
+
+	if (the_char == '\n' || the_char == '\r')
+	{
+		Console_NewLine(the_console);
+		return;
+	}
+
+	if (the_char == '\t')
+	{
+		do
+		{
+			Console_PutChar(the_console, ' ');
+		} while (the_console->cursor_x_ % CONSOLE_TAB_WIDTH != 0 && the_console->cursor_x_ < the_console->width_);
+
+		return;
+	}
+
+	if ((unsigned char)the_char < ' ')
+	{
+		return;
+	}
+
+	if (the_console->cursor_x_ >= the_console->width_)
+	{
+		Console_NewLine(the_console);
+	}
+
+	the_line = Console_GetLine(the_console, the_console->line_count_ - 1);
+	the_line[the_console->cursor_x_++] = the_char;
+
+	if (the_console->dirty_line_ > the_console->line_count_ - 1)
+	{
+		the_console->dirty_line_ = the_console->line_count_ - 1;
+	}
+
+	return;
+
+error:
+	Sys_Destroy(&global_system);	// crash early, crash often
+	return;
+}
+
+
+//! Forget all lines, and clear the console area at the next render
+void Console_Clear(Console* the_console)
+{
+	if (the_console == NULL)
+	{
+		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
+		goto error;
+	}
+
+	// LOGIC: there is always a line being written to. line 0 is the first one.
+	memset(the_console->lines_, ' ', the_console->width_);
+	the_console->line_count_ = 1;
+	the_console->cursor_x_ = 0;
+	the_console->last_was_cr_ = false;
+	the_console->scroll_back_ = 0;
+	the_console->dirty_line_ = 0;
+	the_console->rendered_top_ = 0;
+	the_console->needs_full_render_ = true;
+
+	return;
+
+error:
+	Sys_Destroy(&global_system);	// crash early, crash often
+	return;
+}
+
+
+//! Move the view back through (positive num_lines) or forward through (negative num_lines) the scrollback buffer
+//! The view stays put as new lines come in, until it is moved back to the end, either by this or by Console_ScrollToEnd().
+void Console_ScrollBack(Console* the_console, int16_t num_lines)
+{
+	int16_t		max_scroll_back;
+	int16_t		new_scroll_back;
+
+	if (the_console == NULL)
+	{
+		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
+		goto error;
+	}
+
+	max_scroll_back = Console_GetMaxScrollBack(the_console);
+	new_scroll_back = the_console->scroll_back_ + num_lines;
+
+	if (new_scroll_back < 0)
+	{
+		new_scroll_back = 0;
+	}
+	else if (new_scroll_back > max_scroll_back)
+	{
+		new_scroll_back = max_scroll_back;
+	}
+
+	the_console->scroll_back_ = new_scroll_back;
+
+	return;
+
+error:
+	Sys_Destroy(&global_system);	// crash early, crash often
+	return;
+}
+
+
+//! Go back to tailing the newest lines
+void Console_ScrollToEnd(Console* the_console)
+{
+	if (the_console == NULL)
+	{
+		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
+		goto error;
+	}
+
+	the_console->scroll_back_ = 0;
+
+	return;
+
+error:
+	Sys_Destroy(&global_system);	// crash early, crash often
+	return;
+}
+
+
+//! Show everything logged with General_LogError(), General_LogWarning(), General_LogInfo(), etc. in the console, as well as wherever else it usually goes.
+//! Pass NULL to stop. Only one console at a time can be the log console.
+void Console_SetLogConsole(Console* the_console)
+{
+	console_log_target = the_console;
+
+	if (the_console == NULL)
+	{
+		General_SetLogHook(NULL);
+	}
+	else
+	{
+		General_SetLogHook(&Console_LogHook);
+	}
+}
+
+
+
+
+// **** GETTERS *****
+
+
+//! @return	Returns true if the view is at the end of the scrollback buffer, showing the newest lines
+bool Console_IsAtEnd(Console* the_console)
+{
+	if (the_console == NULL)
+	{
+		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
+		goto error;
+	}
+
+	return (the_console->scroll_back_ == 0);
+
+error:
+	Sys_Destroy(&global_system);	// crash early, crash often
+	return false;
+}
+
+
+
+
+// **** OTHER FUNCTIONS *****
+
+
+//! Bring the console area on screen up to date
+//! If only new lines were added, the area is scrolled with Text_ScrollBox() and only the new lines are drawn.
+//! Call this from the main loop, a timer, or an idle task: many writes between renders cost no more to draw than one screenful.
+void Console_Render(Console* the_console)
+{
+	uint32_t	the_top;
+	uint32_t	the_line;
+	int32_t		the_shift;
+	int16_t		the_row;
+	bool		scrolled_in;
+
+	if (the_console == NULL)
+	{
+		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
+		goto error;
+	}
+
+	// work out which line goes at the top of the area now
+	if (the_console->line_count_ > (uint32_t)the_console->height_)
+	{
+		the_top = the_console->line_count_ - the_console->height_;
+	}
+	else
+	{
+		the_top = 0;
+	}
+
+	the_top -= the_console->scroll_back_;
+	the_shift = (int32_t)(the_top - the_console->rendered_top_);
+
+	// LOGIC:
+	//   if the view moved by less than a screenful, the lines still in view are already on screen, just in the wrong rows:
+	//     scroll them with Text_ScrollBox() and draw only the rows that scrolled in, plus any rows whose lines were written to.
+	//   otherwise, clear the area and draw every row.
+	//   either way, nothing is drawn for rows past the newest line.
+
+	if (the_console->needs_full_render_ || the_shift >= the_console->height_ || -the_shift >= the_console->height_)
+	{
+		Text_FillBox(the_console->screen_, the_console->x1_, the_console->y1_, the_console->x2_, the_console->y2_, ' ', the_console->fore_color_, the_console->back_color_);
+		the_shift = the_console->height_;
+	}
+	else if (the_shift != 0)
+	{
+		Text_ScrollBox(the_console->screen_, the_console->x1_, the_console->y1_, the_console->x2_, the_console->y2_, (int16_t)the_shift, the_console->fore_color_, the_console->back_color_);
+		the_console->scrolls_++;
+	}
+
+	for (the_row = 0; the_row < the_console->height_; the_row++)
+	{
+		the_line = the_top + the_row;
+
+		if (the_line >= the_console->line_count_)
+		{
+			break;
+		}
+
+		scrolled_in = (the_shift > 0 && the_row >= the_console->height_ - the_shift) || (the_shift < 0 && the_row < -the_shift);
+
+		if (scrolled_in || the_line >= the_console->dirty_line_)
+		{
+			Console_DrawRow(the_console, the_row, the_line);
+		}
+	}
+
+	the_console->rendered_top_ = the_top;
+	the_console->dirty_line_ = the_console->line_count_;
+	the_console->needs_full_render_ = false;
+
+	return;
+
+error:
+	Sys_Destroy(&global_system);	// crash early, crash often
+	return;
+}
+
+
+
+
+// **** Debug functions *****
+
+void Console_Print(Console* the_console)
+{
+	DEBUG_OUT(("Console print out:"));
+	DEBUG_OUT(("  address: %p", 			the_console));
+	DEBUG_OUT(("  screen_: %p", 			the_console->screen_));
+	DEBUG_OUT(("  x1_, y1_: %i, %i", 		the_console->x1_, the_console->y1_));
+	DEBUG_OUT(("  x2_, y2_: %i, %i", 		the_console->x2_, the_console->y2_));
+	DEBUG_OUT(("  max_lines_: %i", 			the_console->max_lines_));
+	DEBUG_OUT(("  line_count_: %lu", 		the_console->line_count_));
+	DEBUG_OUT(("  cursor_x_: %i", 			the_console->cursor_x_));
+	DEBUG_OUT(("  scroll_back_: %i", 		the_console->scroll_back_));
+	DEBUG_OUT(("  dirty_line_: %lu", 		the_console->dirty_line_));
+	DEBUG_OUT(("  rendered_top_: %lu", 		the_console->rendered_top_));
+	DEBUG_OUT(("  rows_drawn_: %lu", 		the_console->rows_drawn_));
+	DEBUG_OUT(("  scrolls_: %lu", 			the_console->scrolls_));
+}
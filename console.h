@@ -0,0 +1,162 @@
+//! @file console.h
+
+/*
+ * console.h
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#ifndef CONSOLE_H_
+#define CONSOLE_H_
+
+
+
+/* about this class: Console
+ *
+ * A scrolling text-mode console, drawn in a rectangular area of a text screen, with a scrollback buffer
+ *
+ *** things this class needs to be able to do
+ * accept text (including line breaks) without touching the screen, so writing to it never stalls the caller
+ * keep a fixed number of lines of scrollback in a ring buffer, discarding the oldest lines as new ones arrive
+ * draw only what changed since the last render: scroll the area with Text_ScrollBox() and draw the new lines
+ * let the user scroll back through the history, and jump back to tailing the newest lines
+ * optionally show everything that is logged with General_LogXXX() / LOG_XXX()
+ *
+ *** things objects of this class have
+ * a screen, and a rectangle on that screen
+ * a ring buffer of fixed-width lines
+ * what was on screen at the last render, so the next render knows what to draw
+ *
+ */
+
+
+/*****************************************************************************/
+/*                                Includes                                   */
+/*****************************************************************************/
+
+// project includes
+
+// C includes
+#include <stdbool.h>
+
+// A2560 includes
+#include "a2560_platform.h"
+#include "general.h"
+
+
+/*****************************************************************************/
+/*                            Macro Definitions                              */
+/*****************************************************************************/
+
+#define CONSOLE_MIN_SCROLLBACK		4	// fewest lines of scrollback a console can be created with. Less than the visible rows is rounded up to the visible rows.
+#define CONSOLE_TAB_WIDTH			4	// tab characters advance to the next multiple of this many columns
+
+
+/*****************************************************************************/
+/*                               Enumerations                                */
+/*****************************************************************************/
+
+
+/*****************************************************************************/
+/*                                 Structs                                   */
+/*****************************************************************************/
+
+struct Console
+{
+	Screen*			screen_;
+	int16_t			x1_;				// area of the screen the console is drawn in, in text columns and rows
+	int16_t			y1_;
+	int16_t			x2_;
+	int16_t			y2_;
+	int16_t			width_;				// number of columns in the area, and the length of every line in lines_
+	int16_t			height_;			// number of rows in the area
+	uint8_t			fore_color_;
+	uint8_t			back_color_;
+	char*			lines_;				// ring buffer of max_lines_ lines, each width_ chars long, padded with spaces. Line n is in slot n % max_lines_.
+	int16_t			max_lines_;			// number of lines lines_ has room for
+	uint32_t		line_count_;		// number of lines ever started. the newest line is line_count_ - 1.
+	int16_t			cursor_x_;			// column in the newest line the next character goes in
+	bool			last_was_cr_;		// true if the last character written was a '\r', so that a '\n' right after it does not start another line
+	int16_t			scroll_back_;		// how many lines back from the newest the view is. 0 = tailing the newest lines.
+	uint32_t		dirty_line_;		// oldest line written to since the last render. line_count_ or more if none.
+	uint32_t		rendered_top_;		// line that was at the top of the area at the last render
+	bool			needs_full_render_;	// true if the whole area must be drawn at the next render
+	uint32_t		rows_drawn_;		// number of rows drawn by Console_Render(), for comparison with the number of lines written
+	uint32_t		scrolls_;			// number of times Console_Render() was able to scroll instead of redrawing
+};
+
+
+/*****************************************************************************/
+/*                             Global Variables                              */
+/*****************************************************************************/
+
+
+/*****************************************************************************/
+/*                       Public Function Prototypes                          */
+/*****************************************************************************/
+
+// **** CONSTRUCTOR AND DESTRUCTOR *****
+
+// constructor
+//! Allocate a console for a rectangular area of a text screen. The area is cleared at the first render.
+//! @param	the_screen: valid pointer to the target screen to operate on
+//! @param	x1: the leftmost horizontal position, between 0 and the screen's text_cols_vis_ - 1
+//! @param	y1: the uppermost vertical position, between 0 and the screen's text_rows_vis_ - 1
+//! @param	x2: the rightmost horizontal position, between 0 and the screen's text_cols_vis_ - 1
+//! @param	y2: the lowermost vertical position, between 0 and the screen's text_rows_vis_ - 1
+//! @param	scrollback_lines: number of lines to remember, including the ones on screen
+//! @param	fore_color: Index to the desired foreground color (0-15)
+//! @param	back_color: Index to the desired background color (0-15)
+//! @return	Returns NULL on any error/invalid input, or if memory could not be allocated
+Console* Console_New(Screen* the_screen, int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t scrollback_lines, uint8_t fore_color, uint8_t back_color);
+
+// destructor
+// frees all allocated memory associated with the passed object, and the object itself. If it was the log console, logging to it is stopped.
+void Console_Destroy(Console** the_console);
+
+
+// **** SETTERS *****
+
+//! Add a string to the end of the console. '\n' or '\r' start a new line, and lines longer than the console is wide are wrapped.
+//! Nothing is drawn until Console_Render() is called, so this is cheap enough to call from anywhere.
+//! @param	the_string: the null-terminated string to add
+void Console_Write(Console* the_console, const char* the_string);
+
+//! Add one character to the end of the console. See Console_Write().
+void Console_PutChar(Console* the_console, char the_char);
+
+//! Forget all lines, and clear the console area at the next render
+void Console_Clear(Console* the_console);
+
+//! Move the view back through (positive num_lines) or forward through (negative num_lines) the scrollback buffer
+//! The view stays put as new lines come in, until it is moved back to the end, either by this or by Console_ScrollToEnd().
+void Console_ScrollBack(Console* the_console, int16_t num_lines);
+
+//! Go back to tailing the newest lines
+void Console_ScrollToEnd(Console* the_console);
+
+//! Show everything logged with General_LogError(), General_LogWarning(), General_LogInfo(), etc. in the console, as well as wherever else it usually goes.
+//! Pass NULL to stop. Only one console at a time can be the log console.
+void Console_SetLogConsole(Console* the_console);
+
+
+// **** GETTERS *****
+
+//! @return	Returns true if the view is at the end of the scrollback buffer, showing the newest lines
+bool Console_IsAtEnd(Console* the_console);
+
+
+// **** OTHER FUNCTIONS *****
+
+//! Bring the console area on screen up to date
+//! If only new lines were added, the area is scrolled with Text_ScrollBox() and only the new lines are drawn.
+//! Call this from the main loop, a timer, or an idle task: many writes between renders cost no more to draw than one screenful.
+void Console_Render(Console* the_console);
+
+
+// **** Debug functions *****
+
+void Console_Print(Console* the_console);
+
+
+#endif /* CONSOLE_H_ */
@@ -534,6 +534,12 @@ void Control_AlignToParentRect(Control* the_control)
 	// ensure it will get rendered in next pass
 	the_control->invalidated_ = true;
 	
+	// the parent window's hit-testing index may no longer match where the control is
+	if (the_control->parent_win_ != NULL)
+	{
+		the_control->parent_win_->control_index_invalidated_ = true;
+	}
+	
 	//DEBUG_OUT(("%s %d: Control after AlignToWindow...", __func__, __LINE__));
 	//Control_Print(the_control);
 	
@@ -38,6 +38,15 @@
 /*                               Definitions                                 */
 /*****************************************************************************/
 
+// kinds of event the system does nothing with except pass to the window: if the window's event mask excludes them, they needn't be queued at all
+#define EVENT_WINDOW_ONLY_KINDS		(keyUpMask | autoKeyMask | updateMask | activateEvtMask | menuOpenedMask | menuSelectedMask | menuCanceledMask | controlClickedMask | windowChangedMask)
+
+// number of set 1 scan codes covered by event_key_chars[]
+#define EVENT_KEY_CHARS_COUNT		0x3A
+
+// kinds of event that come from the user, and are captured by EventManager_StartRecording(). everything else is generated by the system in response to these.
+#define EVENT_RECORDED_KINDS		(mouseDownMask | mouseUpMask | keyDownMask | keyUpMask | autoKeyMask | rMouseDownMask | rMouseUpMask | mouseMovedMask)
+
 
 
 /*****************************************************************************/
@@ -52,6 +61,15 @@
 
 extern System*			global_system;
 
+// the character printed on each key of the main block, by set 1 scan code (US layout), for matching keys to menu shortcuts. 0 for keys with no character.
+static const unsigned char event_key_chars[EVENT_KEY_CHARS_COUNT] =
+{
+	0,   27,  '1', '2', '3', '4', '5', '6', '7', '8', '9', '0', '-', '=', 8,   9,		// 0x00
+	'Q', 'W', 'E', 'R', 'T', 'Y', 'U', 'I', 'O', 'P', '[', ']', 13,  0,   'A', 'S',	// 0x10
+	'D', 'F', 'G', 'H', 'J', 'K', 'L', ';', '\'', '`', 0,   '\\', 'Z', 'X', 'C', 'V',	// 0x20
+	'B', 'N', 'M', ',', '.', '/', 0,   '*', 0,   ' ',								// 0x30
+};
+
 
 /*****************************************************************************/
 /*                       Private Function Prototypes                         */
@@ -60,6 +78,53 @@ extern System*			global_system;
 //! Make the passed event a nullEvent, blanking out all fields
 static void Event_SetNull(EventRecord* the_event);
 
+//! Interrupt-time: add one raw input record to the input queue, or drop it if the queue is full
+static void EventManager_QueueInput(EventManager* the_event_manager, input_kind the_kind, uint8_t the_buttons, uint16_t the_code, int16_t dx, int16_t dy);
+
+//! Put a timer into the wheel slot that matches its expiry time
+static void EventManager_QueueTimer(EventManager* the_event_manager, int8_t the_timer_id);
+
+//! Give an event to a window: to its handler for that kind of event if it has one, otherwise to its main event handler
+//! Events not in the window's event mask are dropped
+static void EventManager_DeliverToWindow(EventManager* the_event_manager, Window* the_window, EventRecord* the_event);
+
+//! Dispatch table entry: give the event to the window it was queued for
+static void EventManager_DispatchToWindow(EventManager* the_event_manager, EventRecord* the_event);
+
+
+//! Dispatch table entry: mark the window inactive, then give it the event
+static void EventManager_HandleInactivate(EventManager* the_event_manager, EventRecord* the_event);
+
+//! Dispatch table entry: turn the key into a menuSelected event if it is a shortcut in the active window, otherwise give it to the active window
+static void EventManager_HandleKeyDown(EventManager* the_event_manager, EventRecord* the_event);
+
+//! Dispatch table entry: repeat the last shortcut if the key held down is its key, otherwise give the event to the active window
+static void EventManager_HandleAutoKey(EventManager* the_event_manager, EventRecord* the_event);
+
+//! Dispatch table entry: end a shortcut when its key is released, otherwise give the event to the active window
+static void EventManager_HandleKeyUp(EventManager* the_event_manager, EventRecord* the_event);
+
+//! Take a timer out of the wheel slot it is queued in
+static void EventManager_UnqueueTimer(EventManager* the_event_manager, int8_t the_timer_id);
+
+//! @return	Returns true if there is raw input waiting for EventManager_ProcessInput(), or events waiting in the event queue
+static bool EventManager_InputPending(EventManager* the_event_manager);
+
+//! Wait until input arrives, or until the_deadline tick is reached. If the_deadline is 0, wait for input only.
+static void EventManager_SleepUntil(EventManager* the_event_manager, uint32_t the_deadline);
+
+//! Add an event to the recording started by EventManager_StartRecording(), if there is room for it
+static void EventManager_RecordEvent(EventManager* the_event_manager, event_kind the_what, uint32_t the_code, int16_t x, int16_t y, event_modifiers the_modifiers);
+
+//! Write one entry to an event log file, big-endian
+static bool EventManager_WriteLogEntry(FILE* the_file, EventLogEntry* the_entry);
+
+//! Read one big-endian entry from an event log file
+static bool EventManager_ReadLogEntry(FILE* the_file, EventLogEntry* the_entry);
+
+//! @return	Returns the average time per call, in microseconds, of a handler that used the_ticks over the_count calls
+static uint32_t EventManager_AverageMicroseconds(uint32_t the_ticks, uint32_t the_count);
+
 // **** DEBUG/TESTING Functions
 
 // create one random event in simulation of an interrupt activity
@@ -78,12 +143,369 @@ static void Event_SetNull(EventRecord* the_event)
 	the_event->code_ = 0L;
 	the_event->when_ = 0L;
 	the_event->window_ = NULL;
+	the_event->window_ref_ = SYS_WINDOW_REF_NONE;
 	the_event->control_ = NULL;
 	the_event->x_ = -1;
 	the_event->y_ = -1;
 	the_event->modifiers_ = 0;
 }
 
+
+//! Interrupt-time: add one raw input record to the input queue, or drop it if the queue is full
+static void EventManager_QueueInput(EventManager* the_event_manager, input_kind the_kind, uint8_t the_buttons, uint16_t the_code, int16_t dx, int16_t dy)
+{
+	InputRecord*	the_record;
+	uint16_t		the_write_idx;
+	uint16_t		the_next_idx;
+	
+	// LOGIC:
+	//   same rules as the event queue: fill the slot first, then publish it by moving input_write_idx_
+	//   one slot is always left empty, so a full queue can be told apart from an empty one
+	
+	the_write_idx = the_event_manager->input_write_idx_;
+	the_next_idx = (the_write_idx + 1) % INPUT_QUEUE_SIZE;
+	
+	if (the_next_idx == the_event_manager->input_read_idx_)
+	{
+		the_event_manager->input_dropped_count_++;
+		return;
+	}
+	
+	the_record = &the_event_manager->input_queue_[the_write_idx];
+	the_record->kind_ = the_kind;
+	the_record->buttons_ = the_buttons;
+	the_record->code_ = the_code;
+	the_record->dx_ = dx;
+	the_record->dy_ = dy;
+	the_record->modifiers_ = the_event_manager->kbd_modifiers_;
+	
+	the_event_manager->input_write_idx_ = the_next_idx;
+}
+
+
+//! Give an event to a window: to its handler for that kind of event if it has one, otherwise to its main event handler
+//! Events not in the window's event mask are dropped
+static void EventManager_DeliverToWindow(EventManager* the_event_manager, Window* the_window, EventRecord* the_event)
+{
+	void	(*the_handler)(EventRecord*);
+	
+	if (the_window == NULL)
+	{
+		return;
+	}
+	
+	if ((the_window->event_mask_ & (1L << the_event->what_)) == 0)
+	{
+		the_event_manager->masked_count_++;
+		return;
+	}
+	
+	the_handler = the_window->kind_handler_[the_event->what_];
+	
+	if (the_handler == NULL)
+	{
+		the_handler = the_window->event_handler_;
+	}
+	
+	if (the_handler != NULL)
+	{
+		(*the_handler)(the_event);
+	}
+}
+
+
+//! Dispatch table entry: give the event to the window it was queued for
+static void EventManager_DispatchToWindow(EventManager* the_event_manager, EventRecord* the_event)
+{
+	EventManager_DeliverToWindow(the_event_manager, the_event->window_, the_event);
+}
+
+
+//! Dispatch table entry: mark the window inactive, then give it the event
+static void EventManager_HandleInactivate(EventManager* the_event_manager, EventRecord* the_event)
+{
+	if (the_event->window_ == NULL)
+	{
+		return;
+	}
+	
+	Window_SetActive(the_event->window_, false);
+	EventManager_DeliverToWindow(the_event_manager, the_event->window_, the_event);
+}
+
+
+//! Dispatch table entry: turn the key into a menuSelected event if it is a shortcut in the active window, otherwise give it to the active window
+static void EventManager_HandleKeyDown(EventManager* the_event_manager, EventRecord* the_event)
+{
+	Window*			the_window;
+	unsigned char	the_char = 0;
+	int16_t			the_menu_id;
+	
+	// LOGIC:
+	//   the active window keeps a hash table of the shortcuts of its menu groups, so this is one lookup whatever the number of menus
+	//   a shortcut is eaten: the window hears about it as a menuSelected, just as if the item had been picked from the menu
+	//   the result is kept for the autoKey events that follow while the key is held down
+	
+	the_window = Sys_GetActiveWindow(global_system);
+	the_event_manager->shortcut_code_ = 0;
+	
+	if (the_event->code_ < EVENT_KEY_CHARS_COUNT)
+	{
+		the_char = event_key_chars[the_event->code_];
+	}
+	
+	if (the_window == NULL || (the_menu_id = Window_FindShortcut(the_window, the_char, the_event->modifiers_)) == MENU_ID_NO_SELECTION)
+	{
+		EventManager_DeliverToWindow(the_event_manager, the_window, the_event);
+		return;
+	}
+	
+	the_event_manager->shortcut_code_ = the_event->code_;
+	the_event_manager->shortcut_modifiers_ = the_event->modifiers_;
+	the_event_manager->shortcut_window_ref_ = Sys_GetWindowRef(global_system, the_window);
+	the_event_manager->shortcut_menu_id_ = the_menu_id;
+	
+	EventManager_AddEvent(menuSelected, the_menu_id, the_event_manager->pointer_x_, the_event_manager->pointer_y_, the_event->modifiers_, the_window, NULL);
+}
+
+
+//! Dispatch table entry: repeat the last shortcut if the key held down is its key, otherwise give the event to the active window
+static void EventManager_HandleAutoKey(EventManager* the_event_manager, EventRecord* the_event)
+{
+	Window*			the_window;
+	
+	the_window = Sys_GetActiveWindow(global_system);
+	
+	if (the_event_manager->shortcut_code_ == 0 || the_event->code_ != the_event_manager->shortcut_code_ || the_event->modifiers_ != the_event_manager->shortcut_modifiers_ || 
+		the_window == NULL || Sys_GetWindowRef(global_system, the_window) != the_event_manager->shortcut_window_ref_)
+	{
+		EventManager_DeliverToWindow(the_event_manager, the_window, the_event);
+		return;
+	}
+	
+	EventManager_AddEvent(menuSelected, the_event_manager->shortcut_menu_id_, the_event_manager->pointer_x_, the_event_manager->pointer_y_, the_event->modifiers_, the_window, NULL);
+}
+
+
+//! Dispatch table entry: end a shortcut when its key is released, otherwise give the event to the active window
+static void EventManager_HandleKeyUp(EventManager* the_event_manager, EventRecord* the_event)
+{
+	// the window never saw the key go down, so it doesn't get the key coming up either
+	if (the_event_manager->shortcut_code_ != 0 && the_event->code_ == the_event_manager->shortcut_code_)
+	{
+		the_event_manager->shortcut_code_ = 0;
+		return;
+	}
+	
+	EventManager_DeliverToWindow(the_event_manager, Sys_GetActiveWindow(global_system), the_event);
+}
+
+
+//! Put a timer into the wheel slot that matches its expiry time
+static void EventManager_QueueTimer(EventManager* the_event_manager, int8_t the_timer_id)
+{
+	EventTimer*		the_timer;
+	uint32_t		the_delta;
+	int8_t			the_slot;
+	
+	// LOGIC:
+	//   wheel_now_ is the next tick not yet processed
+	//   due within TIMER_WHEEL_SIZE ticks: level 0, one slot per tick
+	//   due within TIMER_WHEEL_SIZE^2 ticks: level 1, one slot per TIMER_WHEEL_SIZE ticks. these are moved down to level 0 as their block of ticks comes up
+	//   further out than that: the last level 1 slot, to be looked at again when it comes up
+	//   already overdue: the slot for the next tick
+	
+	the_timer = &the_event_manager->timers_[the_timer_id];
+	
+	if ((int32_t)(the_timer->expires_ - the_event_manager->wheel_now_) < 0)
+	{
+		the_delta = 0;
+		the_slot = the_event_manager->wheel_now_ & TIMER_WHEEL_MASK;
+	}
+	else
+	{
+		the_delta = the_timer->expires_ - the_event_manager->wheel_now_;
+		
+		if (the_delta < TIMER_WHEEL_SIZE)
+		{
+			the_slot = the_timer->expires_ & TIMER_WHEEL_MASK;
+		}
+		else if (the_delta < TIMER_WHEEL_SIZE * TIMER_WHEEL_SIZE)
+		{
+			the_slot = TIMER_WHEEL_SIZE + ((the_timer->expires_ >> TIMER_WHEEL_BITS) & TIMER_WHEEL_MASK);
+		}
+		else
+		{
+			the_slot = TIMER_WHEEL_SIZE + (((the_event_manager->wheel_now_ >> TIMER_WHEEL_BITS) + TIMER_WHEEL_MASK) & TIMER_WHEEL_MASK);
+		}
+	}
+	
+	the_timer->slot_ = the_slot;
+	the_timer->next_ = the_event_manager->timer_wheel_[the_slot];
+	the_event_manager->timer_wheel_[the_slot] = the_timer_id;
+}
+
+
+//! Take a timer out of the wheel slot it is queued in
+static void EventManager_UnqueueTimer(EventManager* the_event_manager, int8_t the_timer_id)
+{
+	EventTimer*		the_timer;
+	int8_t*			the_link;
+	
+	the_timer = &the_event_manager->timers_[the_timer_id];
+	
+	if (the_timer->slot_ < 0)
+	{
+		return;
+	}
+	
+	the_link = &the_event_manager->timer_wheel_[the_timer->slot_];
+	
+	while (*the_link != -1)
+	{
+		if (*the_link == the_timer_id)
+		{
+			*the_link = the_timer->next_;
+			break;
+		}
+		
+		the_link = &the_event_manager->timers_[*the_link].next_;
+	}
+	
+	the_timer->slot_ = TIMER_NOT_QUEUED;
+	the_timer->next_ = -1;
+}
+
+
+//! @return	Returns true if there is raw input waiting for EventManager_ProcessInput(), or events waiting in the event queue
+static bool EventManager_InputPending(EventManager* the_event_manager)
+{
+	return (the_event_manager->input_read_idx_ != the_event_manager->input_write_idx_ || the_event_manager->read_idx_ != the_event_manager->write_idx_);
+}
+
+
+//! Wait until input arrives, or until the_deadline tick is reached. If the_deadline is 0, wait for input only.
+static void EventManager_SleepUntil(EventManager* the_event_manager, uint32_t the_deadline)
+{
+	// LOGIC:
+	//   the interrupt handlers are the only thing that can change the queues while we wait, so this is just a check of the indexes and the tick count
+	//   there is no MCP call to halt the CPU until the next interrupt; if one appears, it belongs in this loop
+	
+	while (EventManager_InputPending(the_event_manager) == false)
+	{
+		if (the_deadline != 0 && (int32_t)(sys_time_jiffies() - the_deadline) >= 0)
+		{
+			return;
+		}
+	}
+}
+
+
+//! Add an event to the recording started by EventManager_StartRecording(), if there is room for it
+static void EventManager_RecordEvent(EventManager* the_event_manager, event_kind the_what, uint32_t the_code, int16_t x, int16_t y, event_modifiers the_modifiers)
+{
+	EventLogEntry*	the_entry;
+	uint32_t		now;
+	uint32_t		the_delay;
+	
+	if (the_event_manager->record_count_ >= the_event_manager->record_max_)
+	{
+		return;
+	}
+	
+	now = sys_time_jiffies();
+	the_delay = (the_event_manager->record_count_ == 0) ? 0 : now - the_event_manager->record_last_when_;
+	the_event_manager->record_last_when_ = now;
+
+	the_entry = &the_event_manager->record_buffer_[the_event_manager->record_count_];
+	the_entry->what_ = the_what;
+	the_entry->reserved_ = 0;
+	the_entry->modifiers_ = the_modifiers;
+	the_entry->delay_ = (the_delay > EVENT_LOG_MAX_DELAY) ? EVENT_LOG_MAX_DELAY : the_delay;
+	the_entry->x_ = x;
+	the_entry->y_ = y;
+	the_entry->code_ = the_code;
+	
+	the_event_manager->record_count_++;
+}
+
+
+//! Write one entry to an event log file, big-endian
+static bool EventManager_WriteLogEntry(FILE* the_file, EventLogEntry* the_entry)
+{
+	uint8_t		the_bytes[EVENT_LOG_ENTRY_SIZE];
+	
+	// LOGIC:
+	//   written a byte at a time rather than as a struct, so the file doesn't depend on the compiler's padding or the CPU's byte order
+	
+	the_bytes[0] = the_entry->what_;
+	the_bytes[1] = the_entry->reserved_;
+	the_bytes[2] = the_entry->modifiers_ >> 8;
+	the_bytes[3] = the_entry->modifiers_ & 0xFF;
+	the_bytes[4] = the_entry->delay_ >> 8;
+	the_bytes[5] = the_entry->delay_ & 0xFF;
+	the_bytes[6] = (uint16_t)the_entry->x_ >> 8;
+	the_bytes[7] = (uint16_t)the_entry->x_ & 0xFF;
+	the_bytes[8] = (uint16_t)the_entry->y_ >> 8;
+	the_bytes[9] = (uint16_t)the_entry->y_ & 0xFF;
+	the_bytes[10] = the_entry->code_ >> 24;
+	the_bytes[11] = (the_entry->code_ >> 16) & 0xFF;
+	the_bytes[12] = (the_entry->code_ >> 8) & 0xFF;
+	the_bytes[13] = the_entry->code_ & 0xFF;
+	
+	return (fwrite(the_bytes, EVENT_LOG_ENTRY_SIZE, 1, the_file) == 1);
+}
+
+
+//! Read one big-endian entry from an event log file
+static bool EventManager_ReadLogEntry(FILE* the_file, EventLogEntry* the_entry)
+{
+	uint8_t		the_bytes[EVENT_LOG_ENTRY_SIZE];
+	
+	if (fread(the_bytes, EVENT_LOG_ENTRY_SIZE, 1, the_file) != 1)
+	{
+		return false;
+	}
+	
+	the_entry->what_ = the_bytes[0];
+	the_entry->reserved_ = the_bytes[1];
+	the_entry->modifiers_ = ((uint16_t)the_bytes[2] << 8) | the_bytes[3];
+	the_entry->delay_ = ((uint16_t)the_bytes[4] << 8) | the_bytes[5];
+	the_entry->x_ = (int16_t)(((uint16_t)the_bytes[6] << 8) | the_bytes[7]);
+	the_entry->y_ = (int16_t)(((uint16_t)the_bytes[8] << 8) | the_bytes[9]);
+	the_entry->code_ = ((uint32_t)the_bytes[10] << 24) | ((uint32_t)the_bytes[11] << 16) | ((uint32_t)the_bytes[12] << 8) | the_bytes[13];
+	
+	return true;
+}
+
+
+//! @return	Returns the average time per call, in microseconds, of a handler that used the_ticks over the_count calls
+static uint32_t EventManager_AverageMicroseconds(uint32_t the_ticks, uint32_t the_count)
+{
+	uint32_t	whole_ticks;
+	uint32_t	remainder;
+	
+	if (the_count == 0)
+	{
+		return 0;
+	}
+	
+	// LOGIC:
+	//   whole ticks per call first, then the remainder, so the_ticks * EVENT_MICROSECONDS_PER_TICK can't overflow
+	//   the remainder is less than the_count, so if it is still too big to multiply, scale both down together
+	
+	whole_ticks = the_ticks / the_count;
+	remainder = the_ticks % the_count;
+	
+	while (remainder > 0xFFFFFFFFUL / EVENT_MICROSECONDS_PER_TICK)
+	{
+		remainder >>= 1;
+		the_count >>= 1;
+	}
+	
+	return whole_ticks * EVENT_MICROSECONDS_PER_TICK + (remainder * EVENT_MICROSECONDS_PER_TICK) / the_count;
+}
+
 // **** Debug functions *****
 
 void Event_Print(EventRecord* the_event)
@@ -100,6 +522,7 @@ void Event_Print(EventRecord* the_event)
 	{
 		DEBUG_OUT(("  window_: (NULL)"));
 	}
+	DEBUG_OUT(("  window_ref_: %lx", the_event->window_ref_));
 	DEBUG_OUT(("  control_: %p", the_event->control_));
 	DEBUG_OUT(("  x_: %i", the_event->x_));
 	DEBUG_OUT(("  y_: %i", the_event->y_));
@@ -113,6 +536,66 @@ void EventManager_Print(EventManager* the_event_manager)
 	DEBUG_OUT(("  queue_: %p", the_event_manager->queue_));
 	DEBUG_OUT(("  write_idx_: %i", the_event_manager->write_idx_));
 	DEBUG_OUT(("  read_idx_: %i", the_event_manager->read_idx_));
+	DEBUG_OUT(("  dropped_count_: %lu", the_event_manager->dropped_count_));
+	DEBUG_OUT(("  coalesced_count_: %lu", the_event_manager->coalesced_count_));
+	DEBUG_OUT(("  overflowed_: %i", the_event_manager->overflowed_));
+	DEBUG_OUT(("  masked_count_: %lu", the_event_manager->masked_count_));
+	DEBUG_OUT(("  stale_count_: %lu", the_event_manager->stale_count_));
+	DEBUG_OUT(("  input_write_idx_: %i", the_event_manager->input_write_idx_));
+	DEBUG_OUT(("  input_read_idx_: %i", the_event_manager->input_read_idx_));
+	DEBUG_OUT(("  input_dropped_count_: %lu", the_event_manager->input_dropped_count_));
+	DEBUG_OUT(("  kbd_modifiers_: %x", the_event_manager->kbd_modifiers_));
+	DEBUG_OUT(("  mouse_buttons_: %x", the_event_manager->mouse_buttons_));
+	DEBUG_OUT(("  pointer_x_: %i", the_event_manager->pointer_x_));
+	DEBUG_OUT(("  pointer_y_: %i", the_event_manager->pointer_y_));
+	DEBUG_OUT(("  wheel_now_: %lu", the_event_manager->wheel_now_));
+	DEBUG_OUT(("  idle_next_: %i", the_event_manager->idle_next_));
+	Mouse_PrintGestureStats(the_event_manager->mouse_tracker_);
+}
+
+
+//! Log the time used by each active timer and idle task, in total and on average per call
+void EventManager_PrintTaskStats(EventManager* the_event_manager)
+{
+	int16_t		i;
+	
+	// LOGIC:
+	//   each call is timed in whole ticks, which is too coarse to say anything about one call. the totals over many calls are good, though,
+	//   so the average per call comes from the totals rather than from any single reading
+	
+	DEBUG_OUT(("Timer and idle task stats: (ticks used / times called; average per call)"));
+	
+	for (i = 0; i < EVENT_MAX_TIMERS; i++)
+	{
+		EventTimer*		the_timer = &the_event_manager->timers_[i];
+		
+		if (the_timer->in_use_)
+		{
+			DEBUG_OUT(("  timer %i: %p; expires %lu, period %lu; %lu / %lu; %lu us", i, the_timer->handler_, the_timer->expires_, the_timer->period_, the_timer->run_ticks_, the_timer->run_count_, EventManager_AverageMicroseconds(the_timer->run_ticks_, the_timer->run_count_)));
+		}
+	}
+	
+	for (i = 0; i < EVENT_MAX_IDLE_TASKS; i++)
+	{
+		EventIdleTask*	the_task = &the_event_manager->idle_tasks_[i];
+		
+		if (the_task->in_use_)
+		{
+			DEBUG_OUT(("  idle task %i: %p; %lu / %lu; %lu us", i, the_task->handler_, the_task->run_ticks_, the_task->run_count_, EventManager_AverageMicroseconds(the_task->run_ticks_, the_task->run_count_)));
+		}
+	}
+}
+
+//! Log the totals collected by EventManager_Replay()
+void EventManager_PrintReplayStats(EventReplayStats* the_stats)
+{
+	DEBUG_OUT(("Replay stats:"));
+	DEBUG_OUT(("  events_: %u", the_stats->events_));
+	DEBUG_OUT(("  elapsed_ticks_: %lu", the_stats->elapsed_ticks_));
+	DEBUG_OUT(("  handling_ticks_: %lu", the_stats->handling_ticks_));
+	DEBUG_OUT(("  max_handling_ticks_: %lu", the_stats->max_handling_ticks_));
+	DEBUG_OUT(("  render_ticks_: %lu", the_stats->render_ticks_));
+	DEBUG_OUT(("  bytes_blitted_: %lu", the_stats->bytes_blitted_));
 }
 
 
@@ -166,44 +649,132 @@ void EventManager_GenerateRandomEvent(void)
 	}			
 }
 
-/*****************************************************************************/
-/*                        Public Function Definitions                        */
-/*****************************************************************************/
-
-
-// **** CONSTRUCTOR AND DESTRUCTOR *****
 
-// constructor
-//! Allocate an EventManager object
-EventRecord* Event_New(void)
+//! Feed a random stream of keyboard and mouse bytes through the interrupt handlers, as if num_interrupts PS/2 interrupts had fired
+//! Includes 0xE0-prefixed keys, shifted keys, button presses, and stray mouse bytes that have to be resynchronized. Use to load-test the input pipeline without hardware.
+void EventManager_SimulateInputIRQs(uint16_t num_interrupts)
 {
-	EventRecord*	the_event;
-	
-	if ( (the_event = (EventRecord*)calloc(1, sizeof(EventRecord)) ) == NULL)
-	{
-		LOG_ERR(("%s %d: could not allocate memory to create new EventRecord", __func__ , __LINE__));
-		goto error;
-	}
-	LOG_ALLOC(("%s %d:	__ALLOC__	the_event	%p	size	%i", __func__ , __LINE__, the_event, sizeof(EventRecord)));
+	static uint8_t	sim_buttons = 0;
+	uint16_t		i = 0;
+	uint8_t			scan_code;
+	uint8_t			the_byte;
+	int16_t			dx;
+	int16_t			dy;
+	int16_t			dice;
 
-	Event_SetNull(the_event);
-		
-	return the_event;
+	// LOGIC:
+	//   every byte goes through the same handlers the real interrupts call, one byte per "interrupt"
+	//   scan codes are kept to the main block of set 1 (0x02-0x35), so they never look like a prefix or a modifier by accident
 	
-error:
-	if (the_event)					Event_Destroy(&the_event);
-	Sys_Destroy(&global_system);	// crash early, crash often
-	return NULL;
-}
-
-
-// destructor
-// frees all allocated memory associated with the passed object, and the object itself
-bool Event_Destroy(EventRecord** the_event)
-{
-	if (*the_event == NULL)
+	while (i < num_interrupts)
 	{
-		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
+		dice = rand() % 10;
+		
+		if (dice < 5)
+		{
+			// a mouse packet: small movement, occasionally pressing or releasing the left or right button
+			dx = (rand() % 41) - 20;
+			dy = (rand() % 41) - 20;
+			
+			if (rand() % 8 == 0)
+			{
+				sim_buttons ^= (rand() % 2 == 0) ? MOUSE_BUTTON_LEFT : MOUSE_BUTTON_RIGHT;
+			}
+			
+			// PS/2 reports upward movement as positive
+			dy = -dy;
+			the_byte = 0x08 | sim_buttons | (dx < 0 ? 0x10 : 0) | (dy < 0 ? 0x20 : 0);
+			
+			EventManager_HandleMouseIRQ(the_byte);
+			EventManager_HandleMouseIRQ((uint8_t)dx);
+			EventManager_HandleMouseIRQ((uint8_t)dy);
+			i += 3;
+		}
+		else if (dice < 9)
+		{
+			// a key tap: some are extended keys, some are shifted
+			scan_code = 0x02 + (rand() % 0x34);
+			
+			if (dice == 8)
+			{
+				// tapping shift while shift is held would look like a typematic repeat
+				if (scan_code == 0x2A)
+				{
+					scan_code = 0x2B;
+				}
+				
+				EventManager_HandleKeyboardIRQ(0x2A);
+				i++;
+			}
+			
+			if (dice == 7)
+			{
+				EventManager_HandleKeyboardIRQ(0xE0);
+				EventManager_HandleKeyboardIRQ(scan_code);
+				EventManager_HandleKeyboardIRQ(0xE0);
+				EventManager_HandleKeyboardIRQ(scan_code | 0x80);
+				i += 4;
+			}
+			else
+			{
+				EventManager_HandleKeyboardIRQ(scan_code);
+				EventManager_HandleKeyboardIRQ(scan_code | 0x80);
+				i += 2;
+			}
+			
+			if (dice == 8)
+			{
+				EventManager_HandleKeyboardIRQ(0x2A | 0x80);
+				i++;
+			}
+		}
+		else
+		{
+			// line noise on the mouse port: a byte without the sync bit must be thrown away
+			EventManager_HandleMouseIRQ((uint8_t)(rand() & 0xF7));
+			i++;
+		}
+	}
+}
+
+/*****************************************************************************/
+/*                        Public Function Definitions                        */
+/*****************************************************************************/
+
+
+// **** CONSTRUCTOR AND DESTRUCTOR *****
+
+// constructor
+//! Allocate an EventManager object
+EventRecord* Event_New(void)
+{
+	EventRecord*	the_event;
+	
+	if ( (the_event = (EventRecord*)calloc(1, sizeof(EventRecord)) ) == NULL)
+	{
+		LOG_ERR(("%s %d: could not allocate memory to create new EventRecord", __func__ , __LINE__));
+		goto error;
+	}
+	LOG_ALLOC(("%s %d:	__ALLOC__	the_event	%p	size	%i", __func__ , __LINE__, the_event, sizeof(EventRecord)));
+
+	Event_SetNull(the_event);
+		
+	return the_event;
+	
+error:
+	if (the_event)					Event_Destroy(&the_event);
+	Sys_Destroy(&global_system);	// crash early, crash often
+	return NULL;
+}
+
+
+// destructor
+// frees all allocated memory associated with the passed object, and the object itself
+bool Event_Destroy(EventRecord** the_event)
+{
+	if (*the_event == NULL)
+	{
+		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
 		goto error;
 	}
 
@@ -224,6 +795,7 @@ error:
 EventManager* EventManager_New(void)
 {
 	EventManager*	the_event_manager;
+	int				i;
 	
 	if ( (the_event_manager = (EventManager*)calloc(1, sizeof(EventManager)) ) == NULL)
 	{
@@ -234,7 +806,40 @@ EventManager* EventManager_New(void)
 
 	the_event_manager->write_idx_ = 0;
 	the_event_manager->read_idx_ = 0;
+	the_event_manager->dropped_count_ = 0;
+	the_event_manager->coalesced_count_ = 0;
+	the_event_manager->overflowed_ = false;
+	the_event_manager->masked_count_ = 0;
+	the_event_manager->stale_count_ = 0;
+	the_event_manager->record_buffer_ = NULL;
+	the_event_manager->record_max_ = 0;
+	the_event_manager->record_count_ = 0;
+	the_event_manager->shortcut_code_ = 0;
+	the_event_manager->input_write_idx_ = 0;
+	the_event_manager->input_read_idx_ = 0;
+	the_event_manager->input_dropped_count_ = 0;
+	the_event_manager->kbd_modifiers_ = 0;
+	the_event_manager->kbd_prefix_ = 0;
+	the_event_manager->kbd_skip_count_ = 0;
+	memset(the_event_manager->kbd_held_, 0, sizeof(the_event_manager->kbd_held_));
+	the_event_manager->mouse_packet_idx_ = 0;
+	the_event_manager->mouse_buttons_ = 0;
+	the_event_manager->pointer_x_ = 0;
+	the_event_manager->pointer_y_ = 0;
+	the_event_manager->wheel_now_ = sys_time_jiffies();
+	the_event_manager->idle_next_ = 0;
 	the_event_manager->mouse_tracker_->mode_ = mouseFree;
+	
+	for (i = 0; i < TIMER_WHEEL_SIZE * 2; i++)
+	{
+		the_event_manager->timer_wheel_[i] = -1;
+	}
+	
+	for (i = 0; i < EVENT_MAX_TIMERS; i++)
+	{
+		the_event_manager->timers_[i].slot_ = TIMER_NOT_QUEUED;
+		the_event_manager->timers_[i].next_ = -1;
+	}
 
 	// get a mouse tracker
 	if ( (the_event_manager->mouse_tracker_ = Mouse_New()) == NULL)
@@ -246,8 +851,6 @@ EventManager* EventManager_New(void)
 
 	//DEBUG_OUT(("%s %d: EventManager (%p) created", __func__ , __LINE__, the_event_manager));
 	
-	int	i;
-	
 	for (i=0; i < EVENT_QUEUE_SIZE; i++)
 	{
 		if ( (the_event_manager->queue_[i] = Event_New()) == NULL)
@@ -284,172 +887,1159 @@ bool EventManager_Destroy(EventManager** the_event_manager)
 	{
 		if ((*the_event_manager)->queue_[i] != NULL)
 		{
-			Event_Destroy(&(*the_event_manager)->queue_[i]);
+			Event_Destroy(&(*the_event_manager)->queue_[i]);
+		}
+	}
+	
+	if ((*the_event_manager)->record_buffer_ != NULL)
+	{
+		LOG_ALLOC(("%s %d:	__FREE__	record_buffer_	%p	size	%i", __func__ , __LINE__, (*the_event_manager)->record_buffer_, sizeof(EventLogEntry) * (*the_event_manager)->record_max_));
+		free((*the_event_manager)->record_buffer_);
+	}
+	
+	LOG_ALLOC(("%s %d:	__FREE__	*the_event_manager	%p	size	%i", __func__ , __LINE__, *the_event_manager, sizeof(EventManager)));
+	free(*the_event_manager);
+	*the_event_manager = NULL;
+	
+	return true;
+	
+error:
+	Sys_Destroy(&global_system);	// crash early, crash often
+	return false;
+}
+
+
+
+// **** Queue Management functions *****
+
+//! Checks to see if there is an event in the queue
+//! returns NULL if no event (not the same as returning an event of type nullEvent)
+//! Events for a window that was closed after they were queued are skipped, so the window_ and control_ of a returned event are always valid
+EventRecord* EventManager_NextEvent(void)
+{
+	EventManager*	the_event_manager;
+	EventRecord*	the_event;
+	uint16_t		the_read_idx;
+	bool			is_stale;
+	
+	// LOGIC:
+	//   the event buffer is circular. nullEvents are allowed and present.
+	//   so the way to know if there is a waiting event is to compare the read and write indices
+	//   if read=write, then there are no pending events
+	//   read_idx_ is only ever written here, and in one store, so an interrupt adding an event always sees a consistent value
+	//   the slot just handed out is the one before read_idx_, which the producer never writes to (see EventManager_AddEvent), so the caller can use it until the next call
+	
+	//   closing a window doesn't touch the queue. instead, each event carries the window's ref (slot + generation) from when it was queued
+	//     if the slot has been freed since, the ref no longer matches and the event is skipped, along with the window_/control_ pointers it holds
+	//     controls live exactly as long as their window, so the window's ref covers control_ as well
+	//   nullEvents are skipped too, so they don't hide the events queued after them
+	
+	the_event_manager = Sys_GetEventManager(global_system);
+	
+	do
+	{
+		the_read_idx = the_event_manager->read_idx_;
+	
+		if (the_read_idx == the_event_manager->write_idx_)
+		{
+			DEBUG_OUT(("%s %d: read_idx_=%i SAME AS write_idx_=%i", __func__, __LINE__, the_read_idx, the_event_manager->write_idx_));
+			return NULL;
+		}
+	
+		the_event = the_event_manager->queue_[the_read_idx];
+
+		//DEBUG_OUT(("%s %d: Next Event: type=%i", __func__, __LINE__, the_event->what_));
+		//EventManager_Print(the_event_manager);
+		//Event_Print(the_event);
+	
+		the_event_manager->read_idx_ = (the_read_idx + 1) % EVENT_QUEUE_SIZE;
+		
+		is_stale = (the_event->window_ref_ != SYS_WINDOW_REF_NONE && Sys_GetWindowFromRef(global_system, the_event->window_ref_) == NULL);
+		
+		if (is_stale)
+		{
+			DEBUG_OUT(("%s %d: skipping event (type=%i) for a closed window", __func__, __LINE__, the_event->what_));
+			the_event_manager->stale_count_++;
+		}
+	} while (is_stale || the_event->what_ == nullEvent);
+
+	//DEBUG_OUT(("%s %d: read_idx_=%i, read_idx_ mod EVENT_QUEUE_SIZE=%i", __func__, __LINE__, the_event_manager->read_idx_, the_event_manager->read_idx_ % EVENT_QUEUE_SIZE));
+	//DEBUG_OUT(("%s %d: exiting; event what=%i (%p), read_idx_=%i, write_idx_=%i", __func__, __LINE__, the_event->what_, the_event, the_event_manager->read_idx_, the_event_manager->write_idx_));
+	
+	return the_event;
+}
+
+
+//! Add a new event to the event queue
+//! NOTE: this does not actually insert a new record, as the event queue is a circular buffer
+//! It fills in the next free slot, and only then makes it visible to EventManager_NextEvent(), so it is safe to call from an interrupt.
+//! If the queue is full, the event is dropped: see EventManager_CheckOverflow().
+//! A mouseMoved event is merged into the last queued event, if that is a mouseMoved with the same modifiers that has not been read yet.
+//! @param	the_window: this may be set for non-mouse up/down events. For mouse up/down events, it will not be set, and X/Y will be used to find the window.
+void EventManager_AddEvent(event_kind the_what, uint32_t the_code, int16_t x, int16_t y, event_modifiers the_modifiers, Window* the_window, Control* the_control)
+{
+	EventManager*	the_event_manager;
+	EventRecord*	the_event;
+	uint16_t		the_write_idx;
+	uint16_t		the_next_idx;
+
+	DEBUG_OUT(("%s %d: reached; the_what=%i, the_code=%i, x=%i, y=%i, the_window=%p", __func__, __LINE__, the_what, the_code, x, y, the_window));
+	
+	// LOGIC:
+	//   single producer, single consumer ring: this function only writes write_idx_, EventManager_NextEvent() only writes read_idx_
+	//   the queue is full when advancing write_idx_ would make it equal read_idx_. 
+	//     that leaves the slot before read_idx_ alone: it holds the event the consumer is currently working with.
+	//   a fast-moving mouse can produce far more moves than the app can use. if the last event queued is an unread move, just update its position.
+	//     the consumer never reads an event's fields before it has moved read_idx_ past it, so an unread event can be updated in place.
+	
+	the_event_manager = Sys_GetEventManager(global_system);
+	the_write_idx = the_event_manager->write_idx_;
+	
+	if (the_event_manager->record_buffer_ != NULL && (EVENT_RECORDED_KINDS & (1L << the_what)))
+	{
+		EventManager_RecordEvent(the_event_manager, the_what, the_code, x, y, the_modifiers);
+	}
+	
+	if (the_what == mouseMoved && the_write_idx != the_event_manager->read_idx_)
+	{
+		the_event = the_event_manager->queue_[(the_write_idx + EVENT_QUEUE_SIZE - 1) % EVENT_QUEUE_SIZE];
+		
+		if (the_event->what_ == mouseMoved && the_event->modifiers_ == the_modifiers)
+		{
+			the_event->when_ = sys_time_jiffies();
+			the_event->x_ = x;
+			the_event->y_ = y;
+			
+			if (the_window != NULL)
+			{
+				the_event->window_ = the_window;
+				the_event->window_ref_ = Sys_GetWindowRef(global_system, the_window);
+			}
+			
+			the_event_manager->coalesced_count_++;
+			return;
+		}
+	}
+	
+	the_next_idx = (the_write_idx + 1) % EVENT_QUEUE_SIZE;
+	
+	if (the_next_idx == the_event_manager->read_idx_)
+	{
+		the_event_manager->dropped_count_++;
+		the_event_manager->overflowed_ = true;
+		return;
+	}
+	
+	the_event = the_event_manager->queue_[the_write_idx];
+	
+	if (the_what == nullEvent)
+	{
+		DEBUG_OUT(("%s %d: null event added", __func__, __LINE__));
+		Event_SetNull(the_event);
+		the_event_manager->write_idx_ = the_next_idx;
+		return;
+	}
+	
+	// LOGIC:
+	//   Because an interrupt will (most likely) be the thing creating this event
+	//   We accept only the minimum of info here and create the rest from that info
+	the_event->what_ = the_what;
+	the_event->code_ = the_code;
+	the_event->when_ = sys_time_jiffies();
+	the_event->x_ = x;
+	the_event->y_ = y;
+	the_event->modifiers_ = the_modifiers;
+	the_event->window_ = the_window;
+	the_event->control_ = the_control;
+	
+	// check for a window and a control, using x and y
+	// LOGIC:
+	//   do not try to find window for a disk event
+	//   do not try to find window/control for a control clicked event, it will already have been set
+	//   for mouseup/down find window based on cursor pos (if window not already set, which it might have been)
+	//   for all other events, if window hadn't been set, set it to active window.
+	
+	if (the_what == diskEvt || the_what == controlClicked)
+	{
+		// twiddle thumbs
+	}
+	else if (the_what == mouseDown || the_what == mouseUp)
+	{
+		// might already have been set, if interrupt isn't what generated the event
+		if (the_event->window_ == NULL)
+		{
+			the_event->window_ = Sys_GetWindowAtXY(global_system, x, y);
+		}
+	}
+	else if (the_event->window_ == NULL)
+	{
+		the_event->window_ = Sys_GetActiveWindow(global_system);
+	}
+	
+	// LOGIC:
+	//   if the system would only pass this event on to a window that doesn't want it, don't queue it at all
+	//   the slot has not been published yet, so leaving write_idx_ alone just gives it back
+	//   mouse moves are always queued: whether the system needs one depends on the mouse mode when it is handled, not now.
+	//     the mouseDown that starts a drag is often still in the queue (or still in the input queue) when its first moves are added.
+	//     a move nobody wants is turned away by the window's event mask when it is dispatched instead, and merging keeps free moves to one per batch.
+	
+	if (the_event->window_ != NULL && (the_event->window_->event_mask_ & (1L << the_what)) == 0 && (EVENT_WINDOW_ONLY_KINDS & (1L << the_what)))
+	{
+		the_event_manager->masked_count_++;
+		return;
+	}
+	
+	the_event->window_ref_ = Sys_GetWindowRef(global_system, the_event->window_);
+	
+	// event is complete: publish it to the consumer
+	the_event_manager->write_idx_ = the_next_idx;
+}
+
+
+//! @return	Returns the number of events waiting in the queue
+uint16_t EventManager_GetPendingCount(void)
+{
+	EventManager*	the_event_manager;
+	
+	the_event_manager = Sys_GetEventManager(global_system);
+	
+	return (the_event_manager->write_idx_ + EVENT_QUEUE_SIZE - the_event_manager->read_idx_) % EVENT_QUEUE_SIZE;
+}
+
+
+//! Check whether any events have been dropped because the queue was full, and reset the check
+//! @return	Returns true if one or more events were dropped since the last call
+bool EventManager_CheckOverflow(void)
+{
+	EventManager*	the_event_manager;
+	bool			overflowed;
+	
+	the_event_manager = Sys_GetEventManager(global_system);
+	
+	overflowed = the_event_manager->overflowed_;
+	
+	if (overflowed)
+	{
+		LOG_WARN(("%s %d: event queue overflowed; %lu events dropped so far", __func__, __LINE__, the_event_manager->dropped_count_));
+		the_event_manager->overflowed_ = false;
+	}
+	
+	return overflowed;
+}
+
+
+//! @return	Returns the total number of events dropped because the queue was full
+uint32_t EventManager_GetDroppedCount(void)
+{
+	return Sys_GetEventManager(global_system)->dropped_count_;
+}
+
+
+//! @return	Returns the total number of mouseMoved events merged into a queued mouseMoved
+uint32_t EventManager_GetCoalescedCount(void)
+{
+	return Sys_GetEventManager(global_system)->coalesced_count_;
+}
+
+
+//! @return	Returns the total number of events dropped because the target window's event mask did not include them
+uint32_t EventManager_GetMaskedCount(void)
+{
+	return Sys_GetEventManager(global_system)->masked_count_;
+}
+
+
+//! @return	Returns the total number of events discarded because their window was closed while they were in the queue
+uint32_t EventManager_GetStaleCount(void)
+{
+	return Sys_GetEventManager(global_system)->stale_count_;
+}
+
+
+
+
+// **** Input pipeline functions *****
+
+//! Interrupt-time handling of one byte from the PS/2 keyboard
+//! Tracks the 0xE0 prefix, modifier keys, and which keys are held down, and queues one InputRecord for each key pressed, repeated, or released
+//! @param	scan_code: the set 1 scan code byte read from the PS/2 data port
+void EventManager_HandleKeyboardIRQ(uint8_t scan_code)
+{
+	EventManager*	the_event_manager;
+	uint8_t			make_code;
+	uint8_t			held_idx;
+	uint8_t			held_bit;
+	bool			is_break;
+	bool			is_extended;
+	bool			is_repeat;
+	uint16_t		the_flag = 0;
+	
+	// LOGIC:
+	//   set 1 scan codes: bit 7 set = key released. 0xE0 = next byte is an extended key. 
+	//   0xE1 starts the 6-byte pause key sequence (E1 1D 45 E1 9D C5), which has no release and is just skipped
+	//   modifier state is kept here rather than in the bottom half, so every record carries the modifiers in effect at the time
+	//   while a key is held, the keyboard sends its make code again at the typematic rate, with no break codes in between.
+	//     a make code for a key that is already down is a repeat, and is queued as inputAutoKey rather than as another key press
+	
+	the_event_manager = Sys_GetEventManager(global_system);
+	
+	if (the_event_manager->kbd_skip_count_ > 0)
+	{
+		the_event_manager->kbd_skip_count_--;
+		return;
+	}
+	
+	switch (scan_code)
+	{
+		case 0xE0:
+			the_event_manager->kbd_prefix_ = 0xE0;
+			return;
+			
+		case 0xE1:
+			the_event_manager->kbd_skip_count_ = 5;
+			the_event_manager->kbd_prefix_ = 0;
+			return;
+			
+		case 0x00:	// key detection error / buffer overrun
+		case 0x80:
+		case 0xFA:	// acknowledge
+		case 0xFE:	// resend
+		case 0xFF:	// key detection error / buffer overrun
+			the_event_manager->kbd_prefix_ = 0;
+			return;
+			
+		default:
+			break;
+	}
+	
+	make_code = scan_code & 0x7F;
+	is_break = (scan_code & 0x80) != 0;
+	is_extended = (the_event_manager->kbd_prefix_ == 0xE0);
+	the_event_manager->kbd_prefix_ = 0;
+	
+	// some keyboards wrap extended keys in fake shift presses (E0 2A / E0 AA): those are not real keys
+	if (is_extended && (make_code == 0x2A || make_code == 0x36))
+	{
+		return;
+	}
+	
+	held_idx = (make_code >> 3) | (is_extended ? 0x10 : 0);
+	held_bit = 1 << (make_code & 0x07);
+	is_repeat = (is_break == false && (the_event_manager->kbd_held_[held_idx] & held_bit) != 0);
+	
+	if (is_break)
+	{
+		the_event_manager->kbd_held_[held_idx] &= ~held_bit;
+	}
+	else
+	{
+		the_event_manager->kbd_held_[held_idx] |= held_bit;
+	}
+	
+	switch (make_code)
+	{
+		case 0x2A:
+			the_flag = shiftKey;
+			break;
+			
+		case 0x36:
+			the_flag = rightShiftKey;
+			break;
+			
+		case 0x1D:
+			the_flag = (is_extended ? rightControlKey : controlKey);
+			break;
+			
+		case 0x38:
+			the_flag = (is_extended ? rightOptionKey : optionKey);
+			break;
+			
+		case 0x5B:	// left and right "Windows" keys act as the foenix key
+		case 0x5C:
+			if (is_extended)
+			{
+				the_flag = foenixKey;
+			}
+			break;
+			
+		case 0x3A:
+			// caps lock toggles on each press, and ignores repeats and releases
+			if (is_break == false && is_repeat == false)
+			{
+				the_event_manager->kbd_modifiers_ ^= alphaLock;
+			}
+			break;
+			
+		default:
+			break;
+	}
+	
+	if (the_flag)
+	{
+		if (is_break)
+		{
+			the_event_manager->kbd_modifiers_ &= ~the_flag;
+		}
+		else
+		{
+			the_event_manager->kbd_modifiers_ |= the_flag;
+		}
+	}
+	
+	EventManager_QueueInput(the_event_manager, (is_break ? inputKeyUp : (is_repeat ? inputAutoKey : inputKeyDown)), 0, make_code | (is_extended ? EXTENDED_KEY_FLAG : 0), 0, 0);
+}
+
+
+//! Interrupt-time handling of one byte from the PS/2 mouse
+//! Assembles 3-byte mouse packets, and queues one InputRecord for each complete packet. Bytes that are out of step with the packet boundaries are discarded.
+//! @param	mouse_byte: the byte read from the PS/2 data port
+void EventManager_HandleMouseIRQ(uint8_t mouse_byte)
+{
+	EventManager*	the_event_manager;
+	uint8_t*		the_packet;
+	int16_t			dx;
+	int16_t			dy;
+	
+	// LOGIC:
+	//   byte 0: bits 0-2 buttons, bit 3 always set, bits 4/5 x/y sign, bits 6/7 x/y overflow
+	//   byte 1: x movement, byte 2: y movement (9-bit two's complement with the sign bits from byte 0)
+	//   if byte 0 arrives without bit 3, we are out of step with the mouse: drop bytes until one has it
+	
+	the_event_manager = Sys_GetEventManager(global_system);
+	the_packet = the_event_manager->mouse_packet_;
+	
+	if (the_event_manager->mouse_packet_idx_ == 0 && (mouse_byte & 0x08) == 0)
+	{
+		return;
+	}
+	
+	the_packet[the_event_manager->mouse_packet_idx_++] = mouse_byte;
+	
+	if (the_event_manager->mouse_packet_idx_ < 3)
+	{
+		return;
+	}
+	
+	the_event_manager->mouse_packet_idx_ = 0;
+	
+	if (the_packet[0] & 0xC0)
+	{
+		// movement overflowed the counters: the deltas are meaningless, but the buttons are still good
+		dx = 0;
+		dy = 0;
+	}
+	else
+	{
+		dx = (the_packet[0] & 0x10) ? (int16_t)the_packet[1] - 256 : (int16_t)the_packet[1];
+		dy = (the_packet[0] & 0x20) ? (int16_t)the_packet[2] - 256 : (int16_t)the_packet[2];
+		dy = -dy;	// PS/2 counts upward movement as positive
+	}
+	
+	EventManager_QueueInput(the_event_manager, inputMouse, the_packet[0] & (MOUSE_BUTTON_LEFT | MOUSE_BUTTON_RIGHT | MOUSE_BUTTON_MIDDLE), 0, dx, dy);
+}
+
+
+//! Turn any raw input queued by the interrupt handlers into keyDown/autoKey/keyUp, mouseMoved, mouseDown/Up and rMouseDown/Up events
+//! Called by EventManager_WaitForEvent() before it reads the event queue
+//! @return	Returns the number of events added to the event queue
+uint16_t EventManager_ProcessInput(void)
+{
+	EventManager*	the_event_manager;
+	InputRecord*	the_record;
+	Screen*			the_screen;
+	uint16_t		the_read_idx;
+	uint16_t		num_events = 0;
+	uint8_t			changed_buttons;
+	
+	the_event_manager = Sys_GetEventManager(global_system);
+	the_screen = Sys_GetScreen(global_system, ID_CHANNEL_B);
+	
+	// LOGIC:
+	//   the record is fully used before input_read_idx_ is moved past it, so the interrupt handlers can't reuse the slot underneath us
+	//   mouse records become a mouseMoved (pointer kept within the screen), then a down/up event for each button that changed
+	
+	while ( (the_read_idx = the_event_manager->input_read_idx_) != the_event_manager->input_write_idx_)
+	{
+		the_record = &the_event_manager->input_queue_[the_read_idx];
+		
+		switch (the_record->kind_)
+		{
+			case inputKeyDown:
+				EventManager_AddEvent(keyDown, the_record->code_, -1, -1, the_record->modifiers_, NULL, NULL);
+				num_events++;
+				break;
+				
+			case inputAutoKey:
+				EventManager_AddEvent(autoKey, the_record->code_, -1, -1, the_record->modifiers_, NULL, NULL);
+				num_events++;
+				break;
+				
+			case inputKeyUp:
+				EventManager_AddEvent(keyUp, the_record->code_, -1, -1, the_record->modifiers_, NULL, NULL);
+				num_events++;
+				break;
+				
+			case inputMouse:
+				if (the_record->dx_ != 0 || the_record->dy_ != 0)
+				{
+					the_event_manager->pointer_x_ += the_record->dx_;
+					the_event_manager->pointer_y_ += the_record->dy_;
+					
+					if (the_event_manager->pointer_x_ < 0)
+					{
+						the_event_manager->pointer_x_ = 0;
+					}
+					else if (the_screen && the_event_manager->pointer_x_ >= the_screen->width_)
+					{
+						the_event_manager->pointer_x_ = the_screen->width_ - 1;
+					}
+					
+					if (the_event_manager->pointer_y_ < 0)
+					{
+						the_event_manager->pointer_y_ = 0;
+					}
+					else if (the_screen && the_event_manager->pointer_y_ >= the_screen->height_)
+					{
+						the_event_manager->pointer_y_ = the_screen->height_ - 1;
+					}
+					
+					EventManager_AddEvent(mouseMoved, 0, the_event_manager->pointer_x_, the_event_manager->pointer_y_, the_record->modifiers_, NULL, NULL);
+					num_events++;
+				}
+				
+				changed_buttons = the_record->buttons_ ^ the_event_manager->mouse_buttons_;
+				
+				if (changed_buttons & MOUSE_BUTTON_LEFT)
+				{
+					EventManager_AddEvent(((the_record->buttons_ & MOUSE_BUTTON_LEFT) ? mouseDown : mouseUp), 0, the_event_manager->pointer_x_, the_event_manager->pointer_y_, the_record->modifiers_, NULL, NULL);
+					num_events++;
+				}
+				
+				if (changed_buttons & MOUSE_BUTTON_RIGHT)
+				{
+					EventManager_AddEvent(((the_record->buttons_ & MOUSE_BUTTON_RIGHT) ? rMouseDown : rMouseUp), 0, the_event_manager->pointer_x_, the_event_manager->pointer_y_, the_record->modifiers_, NULL, NULL);
+					num_events++;
+				}
+				
+				the_event_manager->mouse_buttons_ = the_record->buttons_;
+				break;
+				
+			default:
+				break;
+		}
+		
+		the_event_manager->input_read_idx_ = (the_read_idx + 1) % INPUT_QUEUE_SIZE;
+	}
+	
+	return num_events;
+}
+
+
+//! @return	Returns the total number of raw input records dropped because the input queue was full
+uint32_t EventManager_GetInputDroppedCount(void)
+{
+	return Sys_GetEventManager(global_system)->input_dropped_count_;
+}
+
+
+
+
+// **** Timer and idle task functions *****
+
+//! Start a timer
+//! @param	the_delay: number of ticks (sys_time_jiffies) from now until the timer first fires. Minimum 1.
+//! @param	the_period: number of ticks between firings after that, or 0 for a timer that fires only once
+//! @param	the_handler: the function to call when the timer fires
+//! @param	the_user_data: passed to the_handler
+//! @return	Returns the id of the timer, or -1 if all timers are in use
+int16_t EventManager_AddTimer(uint32_t the_delay, uint32_t the_period, EventTimerHandler the_handler, void* the_user_data)
+{
+	EventManager*	the_event_manager;
+	EventTimer*		the_timer;
+	int16_t			i;
+	
+	if (the_handler == NULL)
+	{
+		LOG_ERR(("%s %d: passed handler was null", __func__ , __LINE__));
+		return -1;
+	}
+	
+	the_event_manager = Sys_GetEventManager(global_system);
+	
+	// LOGIC:
+	//   a timer that was removed by its own handler is still TIMER_FIRING until the handler returns, so it can't be reused yet
+	
+	for (i = 0; i < EVENT_MAX_TIMERS; i++)
+	{
+		the_timer = &the_event_manager->timers_[i];
+		
+		if (the_timer->in_use_ == false && the_timer->slot_ == TIMER_NOT_QUEUED)
+		{
+			if (the_delay < 1)
+			{
+				the_delay = 1;
+			}
+			
+			the_timer->handler_ = the_handler;
+			the_timer->user_data_ = the_user_data;
+			the_timer->expires_ = sys_time_jiffies() + the_delay;
+			the_timer->period_ = the_period;
+			the_timer->run_ticks_ = 0;
+			the_timer->run_count_ = 0;
+			the_timer->in_use_ = true;
+			
+			EventManager_QueueTimer(the_event_manager, i);
+			
+			return i;
+		}
+	}
+	
+	LOG_WARN(("%s %d: all %i timers are in use", __func__ , __LINE__, EVENT_MAX_TIMERS));
+	
+	return -1;
+}
+
+
+//! Stop a timer. Safe to call from within a timer handler, including the timer's own.
+//! @return	Returns false if the id did not refer to an active timer
+bool EventManager_RemoveTimer(int16_t the_timer_id)
+{
+	EventManager*	the_event_manager;
+	
+	the_event_manager = Sys_GetEventManager(global_system);
+	
+	if (the_timer_id < 0 || the_timer_id >= EVENT_MAX_TIMERS || the_event_manager->timers_[the_timer_id].in_use_ == false)
+	{
+		return false;
+	}
+	
+	// a timer that is TIMER_FIRING is not on the wheel: EventManager_RunTimers() sees in_use_ is false and lets it go
+	EventManager_UnqueueTimer(the_event_manager, the_timer_id);
+	the_event_manager->timers_[the_timer_id].in_use_ = false;
+	
+	return true;
+}
+
+
+//! Call the handlers of any timers that have come due, and re-arm repeating timers
+//! @return	Returns the number of timer handlers called
+uint16_t EventManager_RunTimers(void)
+{
+	EventManager*	the_event_manager;
+	EventTimer*		the_timer;
+	uint32_t		now;
+	uint32_t		this_tick;
+	uint32_t		start_ticks;
+	int8_t			the_list;
+	int8_t			the_timer_id;
+	uint16_t		num_fired = 0;
+	
+	the_event_manager = Sys_GetEventManager(global_system);
+	now = sys_time_jiffies();
+	
+	// LOGIC:
+	//   step the wheel one tick at a time up to now. each step is one slot, so an empty tick costs almost nothing.
+	//   at the start of each block of TIMER_WHEEL_SIZE ticks, the matching level 1 slot is emptied back into the wheel, which puts its timers into level 0
+	//   the slot for the tick is detached before any handlers run, so handlers can add and remove timers freely
+	
+	while ((int32_t)(now - the_event_manager->wheel_now_) >= 0)
+	{
+		this_tick = the_event_manager->wheel_now_;
+		
+		if ((this_tick & TIMER_WHEEL_MASK) == 0)
+		{
+			int8_t	the_slot = TIMER_WHEEL_SIZE + ((this_tick >> TIMER_WHEEL_BITS) & TIMER_WHEEL_MASK);
+			
+			the_list = the_event_manager->timer_wheel_[the_slot];
+			the_event_manager->timer_wheel_[the_slot] = -1;
+			
+			while (the_list != -1)
+			{
+				the_timer_id = the_list;
+				the_list = the_event_manager->timers_[the_timer_id].next_;
+				EventManager_QueueTimer(the_event_manager, the_timer_id);
+			}
+		}
+		
+		the_list = the_event_manager->timer_wheel_[this_tick & TIMER_WHEEL_MASK];
+		the_event_manager->timer_wheel_[this_tick & TIMER_WHEEL_MASK] = -1;
+		
+		for (the_timer_id = the_list; the_timer_id != -1; the_timer_id = the_event_manager->timers_[the_timer_id].next_)
+		{
+			the_event_manager->timers_[the_timer_id].slot_ = TIMER_FIRING;
+		}
+		
+		the_event_manager->wheel_now_ = this_tick + 1;
+		
+		while (the_list != -1)
+		{
+			the_timer_id = the_list;
+			the_timer = &the_event_manager->timers_[the_timer_id];
+			the_list = the_timer->next_;
+			the_timer->next_ = -1;
+			
+			if (the_timer->in_use_ && (int32_t)(the_timer->expires_ - this_tick) > 0)
+			{
+				// not actually due: it was parked in the last level 1 slot
+				the_timer->slot_ = TIMER_NOT_QUEUED;
+				EventManager_QueueTimer(the_event_manager, the_timer_id);
+				continue;
+			}
+			
+			if (the_timer->in_use_)
+			{
+				start_ticks = sys_time_jiffies();
+				(*the_timer->handler_)(the_timer->user_data_);
+				the_timer->run_ticks_ += sys_time_jiffies() - start_ticks;
+				the_timer->run_count_++;
+				num_fired++;
+			}
+			
+			the_timer->slot_ = TIMER_NOT_QUEUED;
+			
+			if (the_timer->in_use_)
+			{
+				if (the_timer->period_ == 0)
+				{
+					the_timer->in_use_ = false;
+				}
+				else
+				{
+					// stay on the original schedule, unless we've fallen so far behind that the next firing is already overdue
+					the_timer->expires_ += the_timer->period_;
+					
+					if ((int32_t)(the_timer->expires_ - now) <= 0)
+					{
+						the_timer->expires_ = now + the_timer->period_;
+					}
+					
+					EventManager_QueueTimer(the_event_manager, the_timer_id);
+				}
+			}
+		}
+	}
+	
+	return num_fired;
+}
+
+
+//! @return	Returns the tick at which the next timer comes due, or 0 if there are no active timers
+uint32_t EventManager_GetNextTimerTicks(void)
+{
+	EventManager*	the_event_manager;
+	EventTimer*		the_timer;
+	uint32_t		the_next = 0;
+	bool			found = false;
+	int16_t			i;
+	
+	the_event_manager = Sys_GetEventManager(global_system);
+	
+	for (i = 0; i < EVENT_MAX_TIMERS; i++)
+	{
+		the_timer = &the_event_manager->timers_[i];
+		
+		if (the_timer->in_use_ && (found == false || (int32_t)(the_timer->expires_ - the_next) < 0))
+		{
+			the_next = the_timer->expires_;
+			found = true;
+		}
+	}
+	
+	// a timer due at tick 0 would look like "no timers": nudge it by one tick
+	if (found && the_next == 0)
+	{
+		the_next = 1;
+	}
+	
+	return the_next;
+}
+
+
+//! Register a task to be given time whenever the event loop has nothing else to do
+//! @return	Returns the id of the task, or -1 if all idle task slots are in use
+int16_t EventManager_AddIdleTask(EventIdleHandler the_handler, void* the_user_data)
+{
+	EventManager*	the_event_manager;
+	EventIdleTask*	the_task;
+	int16_t			i;
+	
+	if (the_handler == NULL)
+	{
+		LOG_ERR(("%s %d: passed handler was null", __func__ , __LINE__));
+		return -1;
+	}
+	
+	the_event_manager = Sys_GetEventManager(global_system);
+	
+	for (i = 0; i < EVENT_MAX_IDLE_TASKS; i++)
+	{
+		the_task = &the_event_manager->idle_tasks_[i];
+		
+		if (the_task->in_use_ == false)
+		{
+			the_task->handler_ = the_handler;
+			the_task->user_data_ = the_user_data;
+			the_task->run_ticks_ = 0;
+			the_task->run_count_ = 0;
+			the_task->in_use_ = true;
+			
+			return i;
+		}
+	}
+	
+	LOG_WARN(("%s %d: all %i idle task slots are in use", __func__ , __LINE__, EVENT_MAX_IDLE_TASKS));
+	
+	return -1;
+}
+
+
+//! Unregister an idle task
+//! @return	Returns false if the id did not refer to a registered idle task
+bool EventManager_RemoveIdleTask(int16_t the_task_id)
+{
+	EventManager*	the_event_manager;
+	
+	the_event_manager = Sys_GetEventManager(global_system);
+	
+	if (the_task_id < 0 || the_task_id >= EVENT_MAX_IDLE_TASKS || the_event_manager->idle_tasks_[the_task_id].in_use_ == false)
+	{
+		return false;
+	}
+	
+	the_event_manager->idle_tasks_[the_task_id].in_use_ = false;
+	
+	return true;
+}
+
+
+//! Give registered idle tasks one time slice (EVENT_IDLE_SLICE_TICKS), in turn, stopping early if input or events arrive
+//! @return	Returns true if any idle tasks are still registered
+bool EventManager_RunIdleTasks(void)
+{
+	EventManager*	the_event_manager;
+	EventIdleTask*	the_task;
+	uint32_t		slice_start;
+	uint32_t		start_ticks;
+	int16_t			num_checked = 0;
+	int16_t			num_registered = 0;
+	uint8_t			i;
+	
+	the_event_manager = Sys_GetEventManager(global_system);
+	slice_start = sys_time_jiffies();
+	
+	// LOGIC:
+	//   round-robin from where the last slice stopped, one call per task per turn
+	//   the slice ends when its time is used up, when input arrives, or after a full pass in which no task was registered
+	//   a handler returning false is finished, and is unregistered
+	
+	while (EventManager_InputPending(the_event_manager) == false)
+	{
+		i = the_event_manager->idle_next_;
+		the_event_manager->idle_next_ = (i + 1) % EVENT_MAX_IDLE_TASKS;
+		the_task = &the_event_manager->idle_tasks_[i];
+		
+		if (the_task->in_use_)
+		{
+			num_registered++;
+			start_ticks = sys_time_jiffies();
+			
+			if ((*the_task->handler_)(the_task->user_data_) == false)
+			{
+				the_task->in_use_ = false;
+			}
+			
+			the_task->run_ticks_ += sys_time_jiffies() - start_ticks;
+			the_task->run_count_++;
+		}
+		
+		if (++num_checked == EVENT_MAX_IDLE_TASKS)
+		{
+			if (num_registered == 0 || sys_time_jiffies() - slice_start >= EVENT_IDLE_SLICE_TICKS)
+			{
+				break;
+			}
+			
+			num_checked = 0;
+			num_registered = 0;
+		}
+	}
+	
+	for (i = 0; i < EVENT_MAX_IDLE_TASKS; i++)
+	{
+		if (the_event_manager->idle_tasks_[i].in_use_)
+		{
+			return true;
 		}
 	}
 	
-	LOG_ALLOC(("%s %d:	__FREE__	*the_event_manager	%p	size	%i", __func__ , __LINE__, *the_event_manager, sizeof(EventManager)));
-	free(*the_event_manager);
-	*the_event_manager = NULL;
+	return false;
+}
+
+
+//! Ticks are only 1/60 s, so a single call to a handler almost always measures 0 ticks, and now and then 1.
+//! A call that takes a fraction of a tick measures 1 tick with that same chance, so over many calls the total adds up to the real time spent.
+//! Use it together with the number of calls (see EventManager_PrintTaskStats()), not as the cost of any one call.
+//! @return	Returns the total number of ticks spent in the handler of the specified timer, or 0 if not a valid timer
+uint32_t EventManager_GetTimerTicksUsed(int16_t the_timer_id)
+{
+	if (the_timer_id < 0 || the_timer_id >= EVENT_MAX_TIMERS)
+	{
+		return 0;
+	}
 	
-	return true;
+	return Sys_GetEventManager(global_system)->timers_[the_timer_id].run_ticks_;
+}
+
+
+//! Like EventManager_GetTimerTicksUsed(), this is only meaningful summed over many calls
+//! @return	Returns the total number of ticks spent in the handler of the specified idle task, or 0 if not a valid task
+uint32_t EventManager_GetIdleTaskTicksUsed(int16_t the_task_id)
+{
+	if (the_task_id < 0 || the_task_id >= EVENT_MAX_IDLE_TASKS)
+	{
+		return 0;
+	}
 	
-error:
-	Sys_Destroy(&global_system);	// crash early, crash often
-	return false;
+	return Sys_GetEventManager(global_system)->idle_tasks_[the_task_id].run_ticks_;
 }
 
 
 
-// **** Queue Management functions *****
 
-//! Nulls out any events associated with the window pointer passed
-//! Call this when a window has been closed, to ensure that there are not future events that will try to recall the window after it is destroyed
-void EventManager_RemoveEventsForWindow(Window* the_window)
+// **** Record/replay functions *****
+
+//! Start capturing keyboard and mouse events as they are added to the event queue
+//! @param	max_events: number of events to make room for. Events after that are not recorded.
+//! @return	Returns false if already recording, or if the memory could not be allocated
+bool EventManager_StartRecording(uint16_t max_events)
 {
 	EventManager*	the_event_manager;
-	uint16_t		start;
-	uint16_t		stop;
-	uint16_t		i;
-	
-	// LOGIC:
-	//   the event buffer is circular. nullEvents are allowed and present.
-	//   so the way to know if there is a waiting event is to compare the read and write indices
-	//   if read=write, then there are no pending events
+	EventLogEntry*	the_buffer;
 	
 	the_event_manager = Sys_GetEventManager(global_system);
 	
-// 	if (the_event_manager->read_idx_ == the_event_manager->write_idx_)
-// 	{
-// 		DEBUG_OUT(("%s %d: read_idx_=%i SAME AS write_idx_=%i", __func__, __LINE__, the_event_manager->read_idx_, the_event_manager->write_idx_));
-// 		return;
-// 	}
-	
-	start = the_event_manager->read_idx_;
-	stop = the_event_manager->write_idx_;
-	DEBUG_OUT(("%s %d: read_idx_=%i, write_idx_=%i, window=%p", __func__, __LINE__, the_event_manager->read_idx_, the_event_manager->write_idx_, the_window));
-	
-	for (i = start; i <= stop; i++)
+	if (the_event_manager->record_buffer_ != NULL)
 	{
-		EventRecord*	the_event;
+		LOG_WARN(("%s %d: already recording", __func__, __LINE__));
+		return false;
+	}
 	
-		the_event = the_event_manager->queue_[i];
-
-		DEBUG_OUT(("%s %d: this event: window=%p, readidx=%i", __func__, __LINE__, the_event->window_, i));
-
-		if (the_event->window_ != NULL)
-		{
-			if (the_event->window_ == the_window)
-			{
-				Event_SetNull(the_event);
-			}
-		}
+	if ( (the_buffer = (EventLogEntry*)calloc(max_events, sizeof(EventLogEntry)) ) == NULL)
+	{
+		LOG_ERR(("%s %d: could not allocate memory to record %u events", __func__ , __LINE__, max_events));
+		return false;
 	}
+	LOG_ALLOC(("%s %d:	__ALLOC__	the_buffer	%p	size	%i", __func__ , __LINE__, the_buffer, sizeof(EventLogEntry) * max_events));
 	
-	return;
+	// LOGIC:
+	//   EventManager_AddEvent() may be called from an interrupt, so recording only fills in memory. the file is written when recording stops.
+	//   the buffer is set last: until then, AddEvent doesn't see a recording in progress
+	
+	the_event_manager->record_max_ = max_events;
+	the_event_manager->record_count_ = 0;
+	the_event_manager->record_buffer_ = the_buffer;
+	
+	return true;
 }
 
 
-//! Checks to see if there is an event in the queue
-//! returns NULL if no event (not the same as returning an event of type nullEvent)
-EventRecord* EventManager_NextEvent(void)
+//! Stop capturing events, and write the events captured to an event log file
+//! @param	the_file_path: the file to write. Pass NULL to discard the events.
+//! @return	Returns false if not recording, or if the file could not be written
+bool EventManager_StopRecording(const char* the_file_path)
 {
 	EventManager*	the_event_manager;
-	EventRecord*	the_event;
-	
-	// LOGIC:
-	//   the event buffer is circular. nullEvents are allowed and present.
-	//   so the way to know if there is a waiting event is to compare the read and write indices
-	//   if read=write, then there are no pending events
+	EventLogEntry*	the_buffer;
+	FILE*			the_file;
+	uint8_t			the_header[EVENT_LOG_HEADER_SIZE];
+	uint16_t		i;
+	bool			success = true;
 	
 	the_event_manager = Sys_GetEventManager(global_system);
+	the_buffer = the_event_manager->record_buffer_;
 	
-	if (the_event_manager->read_idx_ == the_event_manager->write_idx_)
+	if (the_buffer == NULL)
 	{
-		DEBUG_OUT(("%s %d: read_idx_=%i SAME AS write_idx_=%i", __func__, __LINE__, the_event_manager->read_idx_, the_event_manager->write_idx_));
-		return NULL;
+		LOG_WARN(("%s %d: not recording", __func__, __LINE__));
+		return false;
 	}
 	
-	the_event = the_event_manager->queue_[the_event_manager->read_idx_];
-
-	//DEBUG_OUT(("%s %d: Next Event: type=%i", __func__, __LINE__, the_event->what_));
-	//EventManager_Print(the_event_manager);
-	//Event_Print(the_event);
-	
-	the_event_manager->read_idx_++;
-	the_event_manager->read_idx_ %= EVENT_QUEUE_SIZE;
+	// stop recording before anything else, so no event can be added while the buffer is written out
+	the_event_manager->record_buffer_ = NULL;
 	
-	if (the_event->what_ == nullEvent)
+	if (the_file_path != NULL)
 	{
-		DEBUG_OUT(("%s %d: event was null. read_idx_=%i, write_idx_=%i", __func__, __LINE__, the_event_manager->read_idx_, the_event_manager->write_idx_));
-		return NULL;
+		if ( (the_file = fopen(the_file_path, "wb")) == NULL)
+		{
+			LOG_ERR(("%s %d: could not open '%s' to write event log", __func__, __LINE__, the_file_path));
+			success = false;
+		}
+		else
+		{
+			the_header[0] = EVENT_LOG_MAGIC >> 24;
+			the_header[1] = (EVENT_LOG_MAGIC >> 16) & 0xFF;
+			the_header[2] = (EVENT_LOG_MAGIC >> 8) & 0xFF;
+			the_header[3] = EVENT_LOG_MAGIC & 0xFF;
+			the_header[4] = EVENT_LOG_VERSION >> 8;
+			the_header[5] = EVENT_LOG_VERSION & 0xFF;
+			the_header[6] = the_event_manager->record_count_ >> 8;
+			the_header[7] = the_event_manager->record_count_ & 0xFF;
+			
+			success = (fwrite(the_header, EVENT_LOG_HEADER_SIZE, 1, the_file) == 1);
+			
+			for (i = 0; success && i < the_event_manager->record_count_; i++)
+			{
+				success = EventManager_WriteLogEntry(the_file, &the_buffer[i]);
+			}
+			
+			if (fclose(the_file) != 0)
+			{
+				success = false;
+			}
+			
+			if (success == false)
+			{
+				LOG_ERR(("%s %d: could not write event log '%s'", __func__, __LINE__, the_file_path));
+			}
+			
+			DEBUG_OUT(("%s %d: %u events written to '%s'", __func__, __LINE__, the_event_manager->record_count_, the_file_path));
+		}
 	}
 
-	//DEBUG_OUT(("%s %d: read_idx_=%i, read_idx_ mod EVENT_QUEUE_SIZE=%i", __func__, __LINE__, the_event_manager->read_idx_, the_event_manager->read_idx_ % EVENT_QUEUE_SIZE));
-	//DEBUG_OUT(("%s %d: exiting; event what=%i (%p), read_idx_=%i, write_idx_=%i", __func__, __LINE__, the_event->what_, the_event, the_event_manager->read_idx_, the_event_manager->write_idx_));
+	LOG_ALLOC(("%s %d:	__FREE__	the_buffer	%p	size	%i", __func__ , __LINE__, the_buffer, sizeof(EventLogEntry) * the_event_manager->record_max_));
+	free(the_buffer);
+	the_event_manager->record_max_ = 0;
+	the_event_manager->record_count_ = 0;
 	
-	return the_event;
+	return success;
 }
 
 
-//! Add a new event to the event queue
-//! NOTE: this does not actually insert a new record, as the event queue is a circular buffer
-//! It overwrites whatever slot is next in line
-//! @param	the_window: this may be set for non-mouse up/down events. For mouse up/down events, it will not be set, and X/Y will be used to find the window.
-void EventManager_AddEvent(event_kind the_what, uint32_t the_code, int16_t x, int16_t y, event_modifiers the_modifiers, Window* the_window, Control* the_control)
+//! Feed the events from an event log file back into the event queue one at a time, handling each one fully before the next
+//! @param	at_original_speed: if true, events are spaced out as they were when recorded. If false, each event is added as soon as the last one has been handled.
+//! @param	the_results_path: if not NULL, a tab-separated line is written here for each event: handling ticks, render ticks, bytes blitted
+//! @param	the_stats: totals for the whole replay are returned here
+//! @return	Returns false if the log could not be read
+bool EventManager_Replay(const char* the_file_path, bool at_original_speed, const char* the_results_path, EventReplayStats* the_stats)
 {
-	EventManager*	the_event_manager;
-	EventRecord*	the_event;
-
-	DEBUG_OUT(("%s %d: reached; the_what=%i, the_code=%i, x=%i, y=%i, the_window=%p", __func__, __LINE__, the_what, the_code, x, y, the_window));
+	FILE*			the_file;
+	FILE*			the_results_file = NULL;
+	EventLogEntry	the_entry;
+	uint8_t			the_header[EVENT_LOG_HEADER_SIZE];
+	uint16_t		num_entries;
+	uint16_t		i;
+	uint32_t		start_ticks;
+	uint32_t		due_ticks;
+	uint32_t		handling_ticks;
+	uint32_t		render_ticks;
+	uint32_t		bytes_blitted;
+	bool			success = true;
 	
-	the_event_manager = Sys_GetEventManager(global_system);
+	if (the_stats == NULL)
+	{
+		LOG_ERR(("%s %d: passed stats was null", __func__ , __LINE__));
+		return false;
+	}
 	
-	the_event = the_event_manager->queue_[the_event_manager->write_idx_++];
-	the_event_manager->write_idx_ %= EVENT_QUEUE_SIZE;
+	memset(the_stats, 0, sizeof(EventReplayStats));
 	
-	if (the_what == nullEvent)
+	if ( (the_file = fopen(the_file_path, "rb")) == NULL)
 	{
-		DEBUG_OUT(("%s %d: null event added", __func__, __LINE__));
-		Event_SetNull(the_event);
-		return;
+		LOG_ERR(("%s %d: could not open event log '%s'", __func__, __LINE__, the_file_path));
+		return false;
 	}
 	
-	// LOGIC:
-	//   Because an interrupt will (most likely) be the thing creating this event
-	//   We accept only the minimum of info here and create the rest from that info
-	the_event->what_ = the_what;
-	the_event->code_ = the_code;
-	the_event->when_ = sys_time_jiffies();
-	the_event->x_ = x;
-	the_event->y_ = y;
-	the_event->modifiers_ = the_modifiers;
-	the_event->window_ = the_window;
-	the_event->control_ = the_control;
+	if (fread(the_header, EVENT_LOG_HEADER_SIZE, 1, the_file) != 1 || 
+		(((uint32_t)the_header[0] << 24) | ((uint32_t)the_header[1] << 16) | ((uint32_t)the_header[2] << 8) | the_header[3]) != EVENT_LOG_MAGIC || 
+		(((uint16_t)the_header[4] << 8) | the_header[5]) != EVENT_LOG_VERSION)
+	{
+		LOG_ERR(("%s %d: '%s' is not an event log this version can read", __func__, __LINE__, the_file_path));
+		fclose(the_file);
+		return false;
+	}
 	
-	// check for a window and a control, using x and y
-	// LOGIC:
-	//   do not try to find window for a disk event
-	//   do not try to find window/control for a control clicked event, it will already have been set
-	//   for mouseup/down find window based on cursor pos (if window not already set, which it might have been)
-	//   for all other events, if window hadn't been set, set it to active window.
+	num_entries = ((uint16_t)the_header[6] << 8) | the_header[7];
 	
-	if (the_what == diskEvt || the_what == controlClicked)
+	if (the_results_path != NULL)
 	{
-		// twiddle thumbs
+		if ( (the_results_file = fopen(the_results_path, "w")) == NULL)
+		{
+			LOG_ERR(("%s %d: could not open '%s' to write replay results", __func__, __LINE__, the_results_path));
+			fclose(the_file);
+			return false;
+		}
+		
+		fprintf(the_results_file, "event\twhat\thandling_ticks\trender_ticks\tbytes_blitted\n");
 	}
-	else if (the_what == mouseDown || the_what == mouseUp)
+	
+	// LOGIC:
+	//   each event goes through EventManager_AddEvent() exactly as it did when it was recorded, then is handled before the next is added
+	//     so the cost of each event can be measured on its own, and windows, masks, etc. are resolved against the current state of the system
+	//   at original speed, events are due at the same offsets from the start as they were recorded; reading the file doesn't push them later
+	//   an event can be dropped by a window's event mask without being queued. waiting for it would never return, so only wait if something was queued.
+	
+	start_ticks = sys_time_jiffies();
+	due_ticks = start_ticks;
+	
+	for (i = 0; i < num_entries; i++)
 	{
-		// might already have been set, if interrupt isn't what generated the event
-		if (the_event->window_ == NULL)
+		if (EventManager_ReadLogEntry(the_file, &the_entry) == false)
 		{
-			the_event->window_ = Sys_GetWindowAtXY(global_system, x, y);
+			LOG_ERR(("%s %d: event log '%s' ended after %u of %u events", __func__, __LINE__, the_file_path, i, num_entries));
+			success = false;
+			break;
+		}
+		
+		if (at_original_speed)
+		{
+			due_ticks += the_entry.delay_;
+			
+			while ((int32_t)(sys_time_jiffies() - due_ticks) < 0)
+			{
+			}
+		}
+		
+		render_ticks = Sys_GetRenderTicks(global_system);
+		bytes_blitted = Bitmap_GetBytesBlitted();
+		handling_ticks = sys_time_jiffies();
+		
+		EventManager_AddEvent((event_kind)the_entry.what_, the_entry.code_, the_entry.x_, the_entry.y_, (event_modifiers)the_entry.modifiers_, NULL, NULL);
+		
+		if (EventManager_GetPendingCount() > 0)
+		{
+			EventManager_WaitForEvent();
+		}
+		
+		handling_ticks = sys_time_jiffies() - handling_ticks;
+		render_ticks = Sys_GetRenderTicks(global_system) - render_ticks;
+		bytes_blitted = Bitmap_GetBytesBlitted() - bytes_blitted;
+		
+		the_stats->events_++;
+		the_stats->handling_ticks_ += handling_ticks;
+		the_stats->render_ticks_ += render_ticks;
+		the_stats->bytes_blitted_ += bytes_blitted;
+		
+		if (handling_ticks > the_stats->max_handling_ticks_)
+		{
+			the_stats->max_handling_ticks_ = handling_ticks;
+		}
+		
+		if (the_results_file != NULL)
+		{
+			fprintf(the_results_file, "%u\t%u\t%lu\t%lu\t%lu\n", i, the_entry.what_, (unsigned long)handling_ticks, (unsigned long)render_ticks, (unsigned long)bytes_blitted);
 		}
 	}
-	else if (the_event->window_ == NULL)
+	
+	the_stats->elapsed_ticks_ = sys_time_jiffies() - start_ticks;
+	
+	fclose(the_file);
+	
+	if (the_results_file != NULL)
 	{
-		the_event->window_ = Sys_GetActiveWindow(global_system);
-	}	
+		fclose(the_results_file);
+	}
+	
+	return success;
 }
 
 
@@ -517,7 +2107,9 @@ void EventManager_HandleMouseUp(EventManager* the_event_manager, EventRecord* th
 	{					
 		DEBUG_OUT(("%s %d: mouse up from mouseDragTitle: move window '%s'!", __func__, __LINE__, clicked_window->title_));
 		
-		if (x_delta != 0 && y_delta != 0)
+		// LOGIC:
+		//   a purely horizontal or vertical drag is still a drag. a button down and up in the title bar that never left the movement threshold is not.
+		if (Mouse_MovedEnoughForDragStart(the_event_manager->mouse_tracker_) && (x_delta != 0 || y_delta != 0))
 		{
 			int16_t	new_x;
 			int16_t	new_y;
@@ -587,7 +2179,7 @@ void EventManager_HandleMouseUp(EventManager* the_event_manager, EventRecord* th
 		}
 		else if (starting_mode == mouseResizeDownRight)
 		{
-			if (y_delta != 0)
+			if (x_delta != 0 || y_delta != 0)
 			{
 				new_width += x_delta;
 				new_height += y_delta;
@@ -595,7 +2187,7 @@ void EventManager_HandleMouseUp(EventManager* the_event_manager, EventRecord* th
 			}
 		}
 
-		if (change_made)
+		if (change_made && Mouse_MovedEnoughForDragStart(the_event_manager->mouse_tracker_))
 		{
 			int32_t	the_code;
 			
@@ -692,6 +2284,9 @@ void EventManager_HandleMouseDown(EventManager* the_event_manager, EventRecord*
 	// update the mouse tracker so that if we end up dragging, we'll know where the original click was. (or if a future double click, what time the click was, etc.)
 	Mouse_AcceptUpdate(the_event_manager->mouse_tracker_, the_window, the_event->x_, the_event->y_, true);
 	
+	// let the window see whether this was a single click or the second click of a double click
+	the_event->code_ = Mouse_GetClickCount(the_event_manager->mouse_tracker_);
+	
 	//DEBUG_OUT(("%s %d: Mouse DOWN; event x/y=(%i, %i)", __func__, __LINE__, the_event->x_, the_event->y_));
 
 	// get local coords so we can check for drag and lasso
@@ -871,8 +2466,15 @@ void EventManager_HandleMouseMoved(EventManager* the_event_manager, EventRecord*
 
 	the_window = the_event->window_;
 	
-	// update the mouse so it knows it's X/Y
-	Mouse_SetXY(the_event_manager->mouse_tracker_, the_event->x_, the_event->y_);
+	// update the mouse so it knows it's X/Y. if the button is down, this also decides whether the move is a real drag or just jitter
+	if (starting_mode == mouseFree || starting_mode == mouseMenuOpen)
+	{
+		Mouse_SetXY(the_event_manager->mouse_tracker_, the_event->x_, the_event->y_);
+	}
+	else
+	{
+		Mouse_AcceptMove(the_event_manager->mouse_tracker_, the_event->x_, the_event->y_);
+	}
 
 	// get the delta between current and last clicked position
 	x_delta = Mouse_GetXDelta(the_event_manager->mouse_tracker_);
@@ -912,7 +2514,8 @@ void EventManager_HandleMouseMoved(EventManager* the_event_manager, EventRecord*
 		
 		if (the_event->window_ != NULL)
 		{
-			if (x_delta != 0 && y_delta != 0)
+			// only redraw once the pointer is past the drag threshold, and no more often than MOUSE_OUTLINE_REDRAW_TICKS
+			if (Mouse_OutlineNeedsRedraw(the_event_manager->mouse_tracker_))
 			{
 				int16_t	new_x;
 				int16_t	new_y;
@@ -987,7 +2590,7 @@ void EventManager_HandleMouseMoved(EventManager* the_event_manager, EventRecord*
 		}
 		else if (starting_mode == mouseResizeDownRight)
 		{
-			if (y_delta != 0)
+			if (x_delta != 0 || y_delta != 0)
 			{
 				new_width += x_delta;
 				new_height += y_delta;
@@ -997,7 +2600,8 @@ void EventManager_HandleMouseMoved(EventManager* the_event_manager, EventRecord*
 
 		DEBUG_OUT(("%s %d: mouse move in RESIZE evt; changed=%i, new x/y/w/h=%i, %i -- %i, %i", __func__, __LINE__, change_made, new_x, new_y, new_width, new_height));
 		
-		if (change_made)
+		// only redraw once the pointer is past the drag threshold, and no more often than MOUSE_OUTLINE_REDRAW_TICKS
+		if (change_made && Mouse_OutlineNeedsRedraw(the_event_manager->mouse_tracker_))
 		{
 			Bitmap*		the_bitmap = Sys_GetScreenBitmap(global_system, back_layer);
 			
@@ -1040,11 +2644,40 @@ void EventManager_HandleMouseMoved(EventManager* the_event_manager, EventRecord*
 	else
 	{
 		// give window an event
-		(*the_window->event_handler_)(the_event);				
+		EventManager_DeliverToWindow(the_event_manager, the_window, the_event);
 	}					
 }
 
 
+// window.h is included before event.h's enums are declared, so it keeps its own copies of the event kind count and default event mask
+//   these fail to compile (negative array size) if a kind of event is added to event.h without updating window.h
+typedef char event_kind_count_matches_window_h[(WIN_EVENT_KIND_COUNT == numEventKinds) ? 1 : -1];
+typedef char event_default_mask_matches_window_h[(WIN_DEFAULT_EVENT_MASK == (everyEvent & ~mouseMovedMask)) ? 1 : -1];
+
+// system-level handling for each kind of event, indexed by event_kind. NULL means the system has no use for that kind of event.
+static void (* const event_dispatch_table[WIN_EVENT_KIND_COUNT])(EventManager*, EventRecord*) =
+{
+	NULL,									// nullEvent
+	EventManager_HandleMouseDown,			// mouseDown
+	EventManager_HandleMouseUp,				// mouseUp
+	EventManager_HandleKeyDown,				// keyDown
+	EventManager_HandleKeyUp,				// keyUp
+	EventManager_HandleAutoKey,				// autoKey
+	EventManager_DispatchToWindow,			// updateEvt
+	NULL,									// diskEvt
+	EventManager_DispatchToWindow,			// activateEvt
+	EventManager_HandleInactivate,			// inactivateEvt
+	EventManager_HandleRightMouseDown,		// rMouseDown
+	NULL,									// rMouseUp: menu events are designed to fire on right mouse DOWN
+	EventManager_DispatchToWindow,			// menuOpened
+	EventManager_DispatchToWindow,			// menuSelected
+	EventManager_DispatchToWindow,			// menuCanceled
+	EventManager_DispatchToWindow,			// controlClicked
+	EventManager_HandleMouseMoved,			// mouseMoved
+	EventManager_DispatchToWindow,			// windowChanged
+};
+
+
 //! Wait for an event to happen, do system-processing of it, then if appropriate, give the window responsible for the event a chance to do something with it
 void EventManager_WaitForEvent(void)
 {
@@ -1069,191 +2702,45 @@ void EventManager_WaitForEvent(void)
 // 	DEBUG_OUT(("%s %d: first event: %i", __func__, __LINE__, the_event->what_));
 // 	
 
-	while ( (the_event = EventManager_NextEvent()) != NULL)
+	// LOGIC:
+	//   until there is at least one event to handle: 
+	//     turn raw input into events, run any timers that are due (their handlers may add events),
+	//     then give idle tasks a slice, or if there are none, sleep until the next timer or until input arrives
+	
+	for (;;)
 	{
-		MouseMode		starting_mode;
-		Window*			the_active_window;
+		EventManager_ProcessInput();
+		EventManager_RunTimers();
+		
+		if (EventManager_GetPendingCount() > 0)
+		{
+			break;
+		}
 		
+		if (EventManager_RunIdleTasks() == false)
+		{
+			EventManager_SleepUntil(the_event_manager, EventManager_GetNextTimerTicks());
+		}
+	}
+	
+	// let the log know if events were lost since the last time round
+	EventManager_CheckOverflow();
+	
+	while ( (the_event = EventManager_NextEvent()) != NULL)
+	{
 		DEBUG_OUT(("%s %d: Received Event Event: type=%i", __func__, __LINE__, the_event->what_));
 		//Event_Print(the_event);
 		
-		starting_mode = Mouse_GetMode(the_event_manager->mouse_tracker_);
-		
 		// LOGIC:
 		//   event could be for:
 		//   1. a mouse event. Will sort out non-app window click vs main window click vs about window click in the specific handler
-		//   2. an update event. need to detect and route for main window vs about window
-		//   3. an activate event. need to detect and route for main window vs about window
-		//   4. a keyboard event. need to check for menu shortcuts and activate menus. no other keyboard input needed.
+		//   2. an update, activate, menu, or control event: goes to the window it was queued for
+		//   3. a keyboard event: goes to the active window
+		//   the system-level handler for each kind is looked up in event_dispatch_table; the window's event mask and per-kind handlers are applied on delivery
 
-		switch (the_event->what_)
+		if (the_event->what_ < WIN_EVENT_KIND_COUNT && event_dispatch_table[the_event->what_] != NULL)
 		{
-			case nullEvent:
-				DEBUG_OUT(("%s %d: null event", __func__, __LINE__));
-				break;
-		
-			case mouseMoved:				
-				DEBUG_OUT(("%s %d: mouse move event (%i, %i)", __func__, __LINE__, the_event->x_, the_event->y_));
-
-				EventManager_HandleMouseMoved(the_event_manager, the_event);
-	
-				break;
-				
-			case mouseDown:				
-				DEBUG_OUT(("%s %d: mouse down event (%i, %i)", __func__, __LINE__, the_event->x_, the_event->y_));
-
-				EventManager_HandleMouseDown(the_event_manager, the_event);
-				
-				break;
-
-			case mouseUp:
-				DEBUG_OUT(("%s %d: mouse up event (%i, %i)", __func__, __LINE__, the_event->x_, the_event->y_));
-
-				EventManager_HandleMouseUp(the_event_manager, the_event);
-				
-				break;
-
-			case rMouseDown:				
-				DEBUG_OUT(("%s %d: right mouse down event (%i, %i)", __func__, __LINE__, the_event->x_, the_event->y_));
-
-				EventManager_HandleRightMouseDown(the_event_manager, the_event);
-				
-				break;
-
-			case rMouseUp:
-				DEBUG_OUT(("%s %d: right mouse up event (%i, %i)", __func__, __LINE__, the_event->x_, the_event->y_));
-
-				// eat this event: we don't care about right mouse up: menu events are designed to fire on right mouse DOWN
-				
-				break;
-
-			case menuOpened:
-				DEBUG_OUT(("%s %d: menu opened event: %c", __func__, __LINE__, the_event->code_));
-				// give window an event
-				(*the_event->window_->event_handler_)(the_event);
-		
-				break;
-				
-			case menuSelected:
-				DEBUG_OUT(("%s %d: menu item selected event: %c", __func__, __LINE__, the_event->code_));
-				// give window an event
-				(*the_event->window_->event_handler_)(the_event);
-		
-				break;
-				
-			case controlClicked:
-				DEBUG_OUT(("%s %d: control clicked event: %c", __func__, __LINE__, the_event->code_));
-				// give window an event
-				(*the_event->window_->event_handler_)(the_event);
-		
-				break;
-				
-			case keyDown:
-				DEBUG_OUT(("%s %d: key down event: '%c' (%x) mod (%x)", __func__, __LINE__, the_event->code_, the_event->code_, the_event->modifiers_));
-
-				// give active window an event
-				the_active_window = Sys_GetActiveWindow(global_system);
-
-				(*the_active_window->event_handler_)(the_event);				
-
-				break;
-			
-			case keyUp:
-				DEBUG_OUT(("%s %d: key up event: '%c' (%x) mod (%x)", __func__, __LINE__, the_event->code_, the_event->code_, the_event->modifiers_));
-
-				// give active window an event
-				the_active_window = Sys_GetActiveWindow(global_system);
-
-				(*the_active_window->event_handler_)(the_event);				
-
-				break;
-
-			case updateEvt:
-				DEBUG_OUT(("%s %d: updateEvt event", __func__, __LINE__));
-
-				// give window an event
-				(*the_event->window_->event_handler_)(the_event);				
-
-// 				// Get a RSS surface pointer from the message
-// 				//  LOGIC: the_window will be 0 in some cases
-// 				//    for activateEvt and updateEvt, message will be WindowPtr
-// 				//    (see EventRecord)
-// 			
-// 				affected_app_window = (RSSWindow*)GetWRefCon((WindowPtr)the_event->message);
-// 
-// 				if (affected_app_window == global_app->main_window_)
-// 				{
-// 					the_surface = (RSSWindow*)affected_app_window;
-// 					Window_HandleUpdateEvent(the_surface, the_event);
-// 				}
-// 				else
-// 				{
-// 					// maybe it was an About window that got the event? 	
-// 					if (affected_app_window == global_app->about_window_)
-// 					{
-// 						the_about_window = (RSSAboutWindow*)affected_app_window;
-// 						AboutWindow_HandleUpdateEvent(the_about_window, the_event);
-// 					}
-// 				}
-// 			
-// 				return kUIMsgTypeNonRelevant;
-				break;
-			
-			case activateEvt:
-				DEBUG_OUT(("%s %d: activateEvt event", __func__, __LINE__));
-
-				// give window an event
-				(*the_event->window_->event_handler_)(the_event);				
-
-				
-				// tell window to make its active_ state
-				//Window_SetActive(the_event->window_, true); // now this is done as part of Sys_SetActiveWindow
-
-				// do what, exactly? 
-				//Sys_SetActiveWindow(global_system, the_event->window_); // don't set here, set in the mouse down thing that caused it
-				//Sys_Render(global_system);
-
-				//Sys_SetActiveWindow(global_system, the_event->window_);
-				//DEBUG_OUT(("%s %d: **** changed active window to = '%s'; redrawing all windows", __func__, __LINE__, the_event->window_));
-				
-				
-				// need to make system move the window to the front
-				// but also need to give app a chance to get this activate event before system does that. 
-				//Window_Activate(the_event->window_);
-				
-				break;
-			
-			case inactivateEvt:
-				DEBUG_OUT(("%s %d: inactivateEvt event", __func__, __LINE__));
-				// do what, exactly? 
-				//Sys_SetActiveWindow(global_system, the_event->window_);
-				
-				// tell window to make its active_ state
-				Window_SetActive(the_event->window_, false); // now this is done as part of Sys_SetActiveWindow
-				//Sys_Render(global_system);
-
-				// give window an event
-				(*the_event->window_->event_handler_)(the_event);				
-
-				
-				// need to make system move the window to the front
-				// but also need to give app a chance to get this activate event before system does that. 
-				//Window_Inactivate(the_event->window_);
-				
-				break;
-
-			case windowChanged:
-				DEBUG_OUT(("%s %d: windowChanged event", __func__, __LINE__));
-
-				// give window an event
-				(*the_event->window_->event_handler_)(the_event);				
-
-				break;
-			
-			default:
-				DEBUG_OUT(("%s %d: other event: %i", __func__, __LINE__, the_event->what_));
-				
-				break;
+			(*event_dispatch_table[the_event->what_])(the_event_manager, the_event);
 		}
 		
 		//DEBUG_OUT(("%s %d: r idx=%i, w idx=%i, meets_mask will be=%x", __func__, __LINE__, the_event_manager->write_idx_, the_event_manager->read_idx_, the_event->what_ & the_mask));
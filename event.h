@@ -62,6 +62,28 @@
 /*****************************************************************************/
 
 #define EVENT_QUEUE_SIZE	64		//! number of event records in the circular buffer
+#define INPUT_QUEUE_SIZE	32		//! number of raw keyboard/mouse records the interrupt handlers can queue up before EventManager_ProcessInput() drains them
+
+#define EXTENDED_KEY_FLAG	0xE000	//! added to the key code of keyDown/keyUp events for keys the keyboard sends with a 0xE0 prefix (arrows, right ctrl/alt, etc.)
+#define MOUSE_BUTTON_LEFT	0x01	//! PS/2 mouse packet button bits
+#define MOUSE_BUTTON_RIGHT	0x02
+#define MOUSE_BUTTON_MIDDLE	0x04
+
+#define EVENT_MAX_TIMERS		16		//! number of timers that can be active at one time
+#define EVENT_MAX_IDLE_TASKS	8		//! number of idle tasks that can be registered at one time
+#define TIMER_WHEEL_BITS		5
+#define TIMER_WHEEL_SIZE		(1 << TIMER_WHEEL_BITS)	//! slots per level of the timer wheel. level 0 slots are 1 tick apart, level 1 slots are TIMER_WHEEL_SIZE ticks apart.
+#define TIMER_WHEEL_MASK		(TIMER_WHEEL_SIZE - 1)
+#define TIMER_NOT_QUEUED		-1		//! EventTimer slot_ value for a timer that is not on the wheel
+#define TIMER_FIRING			-2		//! EventTimer slot_ value for a timer taken off the wheel to be run this tick
+#define EVENT_IDLE_SLICE_TICKS	1		//! once idle tasks have run for this many ticks, control goes back to the event loop
+#define EVENT_MICROSECONDS_PER_TICK	16667	//! length of one sys_time_jiffies tick (1/60 s), for reporting the average time used per call
+
+#define EVENT_LOG_MAGIC			0x4F534645	//! "OSFE": first 4 bytes of an event log file
+#define EVENT_LOG_VERSION		1
+#define EVENT_LOG_HEADER_SIZE	8		//! bytes: magic, version (2 bytes), number of entries (2 bytes)
+#define EVENT_LOG_ENTRY_SIZE	14		//! bytes per recorded event in an event log file
+#define EVENT_LOG_MAX_DELAY		0xFFFF	//! longer gaps between recorded events are shortened to this many ticks
 
 
 /*****************************************************************************/
@@ -88,6 +110,7 @@ typedef enum event_kind
 	controlClicked			= 15,
 	mouseMoved				= 16,
 	windowChanged			= 17,
+	numEventKinds,							// not a kind of event: one more than the last kind. Keep it last, so it follows any kind added above it.
 } event_kind;
 
 
@@ -110,7 +133,7 @@ typedef enum event_mask
 	controlClickedMask		= 1 << controlClicked,	// a clickable (2 state) control has been clicked
 	mouseMovedMask			= 1 << mouseMoved,		// mouse has been moved
 	windowChangedMask		= 1 << windowChanged,	// a window has changed size and/or position
-	everyEvent				= 0xFFFF				// all of the above
+	everyEvent				= (1 << numEventKinds) - 2	// all of the above
 } event_mask;
 
 
@@ -143,6 +166,17 @@ typedef enum event_modifier_flags
 } event_modifier_flags;
 
 
+// kinds of raw input record queued by the keyboard and mouse interrupt handlers
+typedef enum input_kind
+{
+	inputNone				= 0,
+	inputKeyDown			= 1,
+	inputKeyUp				= 2,
+	inputMouse				= 3,
+	inputAutoKey			= 4,	// the keyboard sent the make code of a key that is already down: it is repeating
+} input_kind;
+
+
 // TODO: localize this for A2560
 enum
 {
@@ -181,21 +215,116 @@ enum
 struct EventRecord
 {
 	event_kind			what_;
-	uint32_t			code_;		//! For keydown, keyup: the key code. For windowChanged, the width in the high word, height in the low word.
+	uint32_t			code_;		//! For keydown, keyup: the key code. For windowChanged, and updateEvt with a strip to redraw, the width in the high word, height in the low word.
 	uint32_t			when_;		//! ticks
 	Window*				window_;	//! not set for a diskEvt
+	uint32_t			window_ref_;	//! the window's slot and generation (see Sys_GetWindowRef()) when the event was queued. Events whose window has since closed are discarded.
 	Control*			control_;	//! not set for every event type. if not set on mouseDown/Up, pointer was not over a control
-	int16_t				x_;			//! for mouse events: the global x position of mouse. for windowChanged, the new global x posiiton of the window.
-	int16_t				y_;			//! for mouse events: the global y position of mouse. for windowChanged, the new global y posiiton of the window.
+	int16_t				x_;			//! for mouse events: the global x position of mouse. for windowChanged, the new global x posiiton of the window. for updateEvt, the content-local x of the strip to redraw, or -1 for all of it.
+	int16_t				y_;			//! for mouse events: the global y position of mouse. for windowChanged, the new global y posiiton of the window. for updateEvt, the content-local y of the strip to redraw, or -1 for all of it.
 	event_modifiers		modifiers_;	//! set for keyboard and mouse events
 };
 
+//! Compact record written by the keyboard and mouse interrupt handlers. EventManager_ProcessInput() turns these into EventRecords.
+typedef struct InputRecord
+{
+	uint8_t				kind_;		//! an input_kind
+	uint8_t				buttons_;	//! for inputMouse: the MOUSE_BUTTON_xxx bits held down when the packet was sent
+	uint16_t			code_;		//! for inputKeyDown/Up/AutoKey: the set 1 make code, plus EXTENDED_KEY_FLAG if it was sent with a 0xE0 prefix
+	int16_t				dx_;		//! for inputMouse: horizontal movement, in pixels
+	int16_t				dy_;		//! for inputMouse: vertical movement, in pixels (positive is down the screen)
+	uint16_t			modifiers_;	//! the event_modifier_flags for keys held down when the record was queued
+} InputRecord;
+
+//! Timer handler: called from the main loop (never from an interrupt) when the timer comes due
+typedef void (*EventTimerHandler)(void* the_user_data);
+
+//! Idle task handler: do one small piece of background work, then return
+//! @return	Return true if there is more work to do, false when finished (the task is then removed)
+typedef bool (*EventIdleHandler)(void* the_user_data);
+
+typedef struct EventTimer
+{
+	EventTimerHandler	handler_;
+	void*				user_data_;
+	uint32_t			expires_;	//! tick (sys_time_jiffies) at which the timer is due
+	uint32_t			period_;	//! ticks between firings for a repeating timer. 0 for a one-shot timer.
+	uint32_t			run_ticks_;	//! total ticks spent in handler_, summed over every call. See EventManager_GetTimerTicksUsed().
+	uint32_t			run_count_;	//! number of times handler_ has been called
+	int8_t				slot_;		//! wheel slot the timer is queued in (level * TIMER_WHEEL_SIZE + index), or TIMER_NOT_QUEUED/TIMER_FIRING
+	int8_t				next_;		//! next timer in the same wheel slot, or -1
+	bool				in_use_;
+} EventTimer;
+
+//! One recorded input event. Event log files hold these big-endian, EVENT_LOG_ENTRY_SIZE bytes each, so a log recorded on one machine replays on any other.
+typedef struct EventLogEntry
+{
+	uint8_t				what_;		//! the event_kind
+	uint8_t				reserved_;
+	uint16_t			modifiers_;
+	uint16_t			delay_;		//! ticks since the previous recorded event
+	int16_t				x_;
+	int16_t				y_;
+	uint32_t			code_;
+} EventLogEntry;
+
+//! Totals collected by EventManager_Replay()
+typedef struct EventReplayStats
+{
+	uint16_t			events_;				//! number of events replayed
+	uint32_t			elapsed_ticks_;			//! ticks from the start of the replay to the end of handling the last event
+	uint32_t			handling_ticks_;		//! ticks spent handling the events, including any rendering they caused
+	uint32_t			max_handling_ticks_;	//! longest time spent handling one event
+	uint32_t			render_ticks_;			//! ticks spent in Sys_Render()
+	uint32_t			bytes_blitted_;			//! bytes copied by Bitmap_Blit()
+} EventReplayStats;
+
+typedef struct EventIdleTask
+{
+	EventIdleHandler	handler_;
+	void*				user_data_;
+	uint32_t			run_ticks_;	//! total ticks spent in handler_, summed over every call. See EventManager_GetTimerTicksUsed().
+	uint32_t			run_count_;	//! number of times handler_ has been called
+	bool				in_use_;
+} EventIdleTask;
+
 struct EventManager
 {
 	EventRecord*		queue_[EVENT_QUEUE_SIZE];	//! circular buffer for the event queue
-	uint16_t			write_idx_;					//! index to queue_: where the next event record will be slotted
-	uint16_t			read_idx_;					//! index to queue_: where the next event record will be read from
+	volatile uint16_t	write_idx_;					//! index to queue_: where the next event record will be slotted. Only ever changed by the producer (EventManager_AddEvent).
+	volatile uint16_t	read_idx_;					//! index to queue_: where the next event record will be read from. Only ever changed by the consumer (EventManager_NextEvent).
+	volatile uint32_t	dropped_count_;				//! number of events discarded because the queue was full
+	volatile uint32_t	coalesced_count_;			//! number of mouseMoved events merged into a mouseMoved that was still waiting in the queue
+	volatile bool		overflowed_;				//! set when an event is dropped. cleared by EventManager_CheckOverflow().
+	uint32_t			masked_count_;				//! number of events dropped because the target window's event mask did not include them
+	uint32_t			stale_count_;				//! number of events discarded because their window was closed while they were in the queue
 	MouseTracker*		mouse_tracker_;				//! tracks whether mouse is in drag mode, etc.
+	InputRecord			input_queue_[INPUT_QUEUE_SIZE];	//! raw input from the interrupt handlers, waiting for EventManager_ProcessInput()
+	volatile uint16_t	input_write_idx_;			//! index to input_queue_: only ever changed by the interrupt handlers
+	volatile uint16_t	input_read_idx_;			//! index to input_queue_: only ever changed by EventManager_ProcessInput()
+	volatile uint32_t	input_dropped_count_;		//! number of raw input records discarded because input_queue_ was full
+	uint16_t			kbd_modifiers_;				//! event_modifier_flags for the modifier keys currently held down. Keyboard interrupt handler only.
+	uint8_t				kbd_prefix_;				//! 0xE0 if the last byte from the keyboard was the extended-key prefix, otherwise 0
+	uint8_t				kbd_skip_count_;			//! number of bytes still to be ignored in a pause key sequence
+	uint8_t				kbd_held_[32];				//! one bit for each key currently held down: the make code, plus 128 for extended keys. Keyboard interrupt handler only.
+	uint8_t				mouse_packet_[3];			//! the mouse packet being assembled by the mouse interrupt handler
+	uint8_t				mouse_packet_idx_;			//! which byte of mouse_packet_ the next byte from the mouse goes into
+	uint8_t				mouse_buttons_;				//! MOUSE_BUTTON_xxx bits as of the last mouse record turned into events
+	int16_t				pointer_x_;					//! global position of the mouse pointer, built up from the mouse packets
+	int16_t				pointer_y_;
+	EventTimer			timers_[EVENT_MAX_TIMERS];
+	int8_t				timer_wheel_[TIMER_WHEEL_SIZE * 2];	//! index of the first timer in each slot of the 2-level wheel, or -1
+	uint32_t			wheel_now_;					//! the next tick the timer wheel has not yet processed
+	EventIdleTask		idle_tasks_[EVENT_MAX_IDLE_TASKS];
+	uint8_t				idle_next_;					//! idle task to start with on the next time slice, so every task gets a turn
+	EventLogEntry*		record_buffer_;				//! input events captured since EventManager_StartRecording(), or NULL when not recording
+	uint16_t			record_max_;				//! number of entries record_buffer_ has room for
+	volatile uint16_t	record_count_;				//! number of entries in record_buffer_
+	uint32_t			record_last_when_;			//! tick of the last event recorded
+	uint32_t			shortcut_code_;				//! key code of the last keyDown that was a menu shortcut, so its autoKey repeats can reuse the lookup. 0 if none.
+	uint16_t			shortcut_modifiers_;		//! modifiers held down with shortcut_code_
+	uint32_t			shortcut_window_ref_;		//! window the shortcut was found in (see Sys_GetWindowRef())
+	int16_t				shortcut_menu_id_;			//! id_ of the menu item the shortcut selected
 };
 
 
@@ -213,6 +342,8 @@ struct EventManager
 
 // **** events are pre-created in a fixed size array on system startup (circular buffer)
 // **** as interrupts need to add more events, they take the next slot available in the array
+// **** the queue has one producer (EventManager_AddEvent, which may be called from an interrupt) and one consumer (EventManager_NextEvent, main loop only)
+// **** if the queue is full, new events are dropped (and counted); queued events are never overwritten
 
 // **** CONSTRUCTOR AND DESTRUCTOR *****
 
@@ -240,32 +371,169 @@ bool EventManager_Destroy(EventManager** the_event_manager);
 // **** Queue Management functions *****
 
 
-//! Nulls out any events associated with the window pointer passed
-//! Call this when a window has been closed, to ensure that there are not future events that will try to recall the window after it is destroyed
-void EventManager_RemoveEventsForWindow(Window* the_window);
-
 //! Checks to see if there is an event in the queue
 //! returns NULL if no event (not the same as returning an event of type nullEvent)
+//! Events for a window that was closed after they were queued are skipped, so the window_ and control_ of a returned event are always valid
 EventRecord* EventManager_NextEvent(void);
 
 //! Add a new event to the event queue
 //! NOTE: this does not actually insert a new record, as the event queue is a circular buffer
-//! It overwrites whatever slot is next in line
+//! It fills in the next free slot, and only then makes it visible to EventManager_NextEvent(), so it is safe to call from an interrupt.
+//! If the queue is full, the event is dropped: see EventManager_CheckOverflow().
+//! A mouseMoved event is merged into the last queued event, if that is a mouseMoved with the same modifiers that has not been read yet.
 //! @param	the_window: this may be set for non-mouse up/down events. For mouse up/down events, it will not be set, and X/Y will be used to find the window.
 void EventManager_AddEvent(event_kind the_what, uint32_t the_code, int16_t x, int16_t y, event_modifiers the_modifiers, Window* the_window, Control* the_control);
 
+//! @return	Returns the number of events waiting in the queue
+uint16_t EventManager_GetPendingCount(void);
+
+//! Check whether any events have been dropped because the queue was full, and reset the check
+//! @return	Returns true if one or more events were dropped since the last call
+bool EventManager_CheckOverflow(void);
+
+//! @return	Returns the total number of events dropped because the queue was full
+uint32_t EventManager_GetDroppedCount(void);
+
+//! @return	Returns the total number of mouseMoved events merged into a queued mouseMoved
+uint32_t EventManager_GetCoalescedCount(void);
+
+//! @return	Returns the total number of events dropped because the target window's event mask did not include them
+uint32_t EventManager_GetMaskedCount(void);
+
+//! @return	Returns the total number of events discarded because their window was closed while they were in the queue
+uint32_t EventManager_GetStaleCount(void);
+
 //! Wait for an event to happen, do system-processing of it, then if appropriate, give the window responsible for the event a chance to do something with it
+//! While the queue is empty, runs any timers that come due and gives idle tasks time slices. With no idle work to do, it sleeps until the next timer or until input arrives.
+//! Returns once the events in the queue have been handled.
 void EventManager_WaitForEvent(void);
 
 
 
 
+// **** Timer and idle task functions *****
+
+// **** timers are kept in a 2-level timing wheel, so adding, removing, and advancing them does not depend on how many there are
+// **** timer and idle task handlers are always called from the main loop, so they can draw and add events freely
+
+//! Start a timer
+//! @param	the_delay: number of ticks (sys_time_jiffies) from now until the timer first fires. Minimum 1.
+//! @param	the_period: number of ticks between firings after that, or 0 for a timer that fires only once
+//! @param	the_handler: the function to call when the timer fires
+//! @param	the_user_data: passed to the_handler
+//! @return	Returns the id of the timer, or -1 if all timers are in use
+int16_t EventManager_AddTimer(uint32_t the_delay, uint32_t the_period, EventTimerHandler the_handler, void* the_user_data);
+
+//! Stop a timer. Safe to call from within a timer handler, including the timer's own.
+//! @return	Returns false if the id did not refer to an active timer
+bool EventManager_RemoveTimer(int16_t the_timer_id);
+
+//! Call the handlers of any timers that have come due, and re-arm repeating timers
+//! @return	Returns the number of timer handlers called
+uint16_t EventManager_RunTimers(void);
+
+//! @return	Returns the tick at which the next timer comes due, or 0 if there are no active timers
+uint32_t EventManager_GetNextTimerTicks(void);
+
+//! Register a task to be given time whenever the event loop has nothing else to do
+//! @return	Returns the id of the task, or -1 if all idle task slots are in use
+int16_t EventManager_AddIdleTask(EventIdleHandler the_handler, void* the_user_data);
+
+//! Unregister an idle task
+//! @return	Returns false if the id did not refer to a registered idle task
+bool EventManager_RemoveIdleTask(int16_t the_task_id);
+
+//! Give registered idle tasks one time slice (EVENT_IDLE_SLICE_TICKS), in turn, stopping early if input or events arrive
+//! @return	Returns true if any idle tasks are still registered
+bool EventManager_RunIdleTasks(void);
+
+//! Ticks are only 1/60 s, so a single call to a handler almost always measures 0 ticks, and now and then 1.
+//! A call that takes a fraction of a tick measures 1 tick with that same chance, so over many calls the total adds up to the real time spent.
+//! Use it together with the number of calls (see EventManager_PrintTaskStats()), not as the cost of any one call.
+//! @return	Returns the total number of ticks spent in the handler of the specified timer, or 0 if not a valid timer
+uint32_t EventManager_GetTimerTicksUsed(int16_t the_timer_id);
+
+//! Like EventManager_GetTimerTicksUsed(), this is only meaningful summed over many calls
+//! @return	Returns the total number of ticks spent in the handler of the specified idle task, or 0 if not a valid task
+uint32_t EventManager_GetIdleTaskTicksUsed(int16_t the_task_id);
+
+
+
+
+// **** Input pipeline functions *****
+
+// **** the keyboard and mouse interrupt handlers (top half) only decode the bytes from the PS/2 port into InputRecords
+// **** EventManager_ProcessInput() (bottom half, main loop only) turns those into keyboard and mouse events
+// **** both interrupts come in at the same level and never preempt each other, so the input queue has a single producer
+
+//! Interrupt-time handling of one byte from the PS/2 keyboard
+//! Tracks the 0xE0 prefix, modifier keys, and which keys are held down, and queues one InputRecord for each key pressed, repeated, or released
+//! @param	scan_code: the set 1 scan code byte read from the PS/2 data port
+void EventManager_HandleKeyboardIRQ(uint8_t scan_code);
+
+//! Interrupt-time handling of one byte from the PS/2 mouse
+//! Assembles 3-byte mouse packets, and queues one InputRecord for each complete packet. Bytes that are out of step with the packet boundaries are discarded.
+//! @param	mouse_byte: the byte read from the PS/2 data port
+void EventManager_HandleMouseIRQ(uint8_t mouse_byte);
+
+//! Turn any raw input queued by the interrupt handlers into keyDown/autoKey/keyUp, mouseMoved, mouseDown/Up and rMouseDown/Up events
+//! Called by EventManager_WaitForEvent() before it reads the event queue
+//! @return	Returns the number of events added to the event queue
+uint16_t EventManager_ProcessInput(void);
+
+//! @return	Returns the total number of raw input records dropped because the input queue was full
+uint32_t EventManager_GetInputDroppedCount(void);
+
+
+
+
+// **** Record/replay functions *****
+
+// **** recording captures the keyboard and mouse events passed to EventManager_AddEvent(), with the time between them
+// **** replaying a log feeds those events back in, and measures what it costs the system to handle each one
+// **** only stdio is used for the log, so the same workload can be replayed against any build, on the Foenix or elsewhere
+
+//! Start capturing keyboard and mouse events as they are added to the event queue
+//! @param	max_events: number of events to make room for. Events after that are not recorded.
+//! @return	Returns false if already recording, or if the memory could not be allocated
+bool EventManager_StartRecording(uint16_t max_events);
+
+//! Stop capturing events, and write the events captured to an event log file
+//! @param	the_file_path: the file to write. Pass NULL to discard the events.
+//! @return	Returns false if not recording, or if the file could not be written
+bool EventManager_StopRecording(const char* the_file_path);
+
+//! Feed the events from an event log file back into the event queue one at a time, handling each one fully before the next
+//! @param	at_original_speed: if true, events are spaced out as they were when recorded. If false, each event is added as soon as the last one has been handled.
+//! @param	the_results_path: if not NULL, a tab-separated line is written here for each event: handling ticks, render ticks, bytes blitted
+//! @param	the_stats: totals for the whole replay are returned here
+//! @return	Returns false if the log could not be read
+bool EventManager_Replay(const char* the_file_path, bool at_original_speed, const char* the_results_path, EventReplayStats* the_stats);
+
+
+
+
+// **** DEBUG/TESTING Functions *****
+
+//! Feed a random stream of keyboard and mouse bytes through the interrupt handlers, as if num_interrupts PS/2 interrupts had fired
+//! Includes 0xE0-prefixed keys, shifted keys, button presses, and stray mouse bytes that have to be resynchronized. Use to load-test the input pipeline without hardware.
+void EventManager_SimulateInputIRQs(uint16_t num_interrupts);
+
+
+
+
 
 // **** Debug functions *****
 
 void Event_Print(EventRecord* the_event);
 void EventManager_Print(EventManager* the_event_manager);
 
+//! Log the time used by each active timer and idle task, in total and on average per call
+void EventManager_PrintTaskStats(EventManager* the_event_manager);
+
+//! Log the totals collected by EventManager_Replay()
+void EventManager_PrintReplayStats(EventReplayStats* the_stats);
+
 
 
 #endif /* EVENT_H_ */
@@ -57,6 +57,7 @@ static const char*		kDebugFlag[5] = {
 						};
 
 static FILE*			global_log_file;
+static General_LogHook	global_log_hook;	// optional extra destination for logged messages. see General_SetLogHook()
 
 
 /*****************************************************************************/
@@ -1338,6 +1339,11 @@ void General_LogError(const char* format, ...)
 	vsprintf(debug_buffer, format, args);
 	va_end(args);
 
+	if (global_log_hook != NULL)
+	{
+		(*global_log_hook)(LogError, debug_buffer);
+	}
+
 	// f68 emulator has a log to console feature:
 #ifdef _f68_
 	*((long *)-4) = (long)&debug_buffer;
@@ -1357,6 +1363,11 @@ void General_LogWarning(const char* format, ...)
 	vsprintf(debug_buffer, format, args);
 	va_end(args);
 
+	if (global_log_hook != NULL)
+	{
+		(*global_log_hook)(LogWarning, debug_buffer);
+	}
+
 	// f68 emulator has a log to console feature:
 #ifdef _f68_
 	*((long *)-4) = (long)&debug_buffer;
@@ -1376,6 +1387,11 @@ void General_LogInfo(const char* format, ...)
 	vsprintf(debug_buffer, format, args);
 	va_end(args);
 
+	if (global_log_hook != NULL)
+	{
+		(*global_log_hook)(LogInfo, debug_buffer);
+	}
+
 	// f68 emulator has a log to console feature:
 #ifdef _f68_
 	*((long *)-4) = (long)&debug_buffer;
@@ -1394,6 +1410,11 @@ void General_DebugOut(const char* format, ...)
 	va_start(args, format);
 	vsprintf(debug_buffer, format, args);
 	va_end(args);
+
+	if (global_log_hook != NULL)
+	{
+		(*global_log_hook)(LogDebug, debug_buffer);
+	}
 	
 	// f68 emulator has a log to console feature:
 #ifdef _f68_
@@ -1413,6 +1434,11 @@ void General_LogAlloc(const char* format, ...)
 	va_start(args, format);
 	vsprintf(debug_buffer, format, args);
 	va_end(args);
+
+	if (global_log_hook != NULL)
+	{
+		(*global_log_hook)(LogAlloc, debug_buffer);
+	}
 	
 	// f68 emulator has a log to console feature:
 #ifdef _f68_
@@ -1454,6 +1480,12 @@ void General_LogCleanUp(void)
 #endif
 }
 
+// pass every logged message to the_hook as well as the usual log destinations. Pass NULL to stop. Only one hook is supported at a time.
+void General_SetLogHook(General_LogHook the_hook)
+{
+	global_log_hook = the_hook;
+}
+
 
 // debug function to print out a chunk of memory character by character
 void General_PrintBufferCharacters(char* the_data, int16_t the_len)
@@ -117,6 +117,9 @@ typedef enum LoggingLevel
 	LogAlloc = 4
 } LoggingLevel;
 
+// a function that wants to see every logged message as well, for example to show it in a text console. the_message is only valid for the duration of the call.
+typedef void (*General_LogHook)(LoggingLevel the_level, const char* the_message);
+
 
 
 /*****************************************************************************/
@@ -398,6 +401,9 @@ void General_LogAlloc(const char* format, ...);
 bool General_LogInitialize(void);
 void General_LogCleanUp(void);
 
+// pass every logged message to the_hook as well as the usual log destinations. Pass NULL to stop. Only one hook is supported at a time.
+void General_SetLogHook(General_LogHook the_hook);
+
 // debug function to print out a chunk of memory character by character
 void General_PrintBufferCharacters(char* the_data, int16_t the_len);
 
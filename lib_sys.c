@@ -60,9 +60,9 @@
 System*			global_system;
 
 // MCP / previous interrupt handler functions for restore on exit
-// p_int_handler	global_old_keyboard_interrupt;
-// p_int_handler	global_old_mouse_interrupt;
 // p_int_handler is defined in mcp/interrupt.h as typedef void (*p_int_handler)();
+static p_int_handler	global_old_keyboard_interrupt;
+static p_int_handler	global_old_mouse_interrupt;
 
 // VGA colors, used for both fore- and background colors in Text mode
 // in C256, these are 8 bit values; in A2560s, they are 32 bit values, and endianness matters
@@ -128,6 +128,21 @@ void Sys_UpdateWindowTheme(System* the_system);
 
 void Sys_RenumberWindows(System* the_system);
 
+//! Convert a global horizontal coordinate to a column in the window hit-testing grid
+static uint8_t Sys_GetWindowGridCol(int16_t x);
+
+//! Convert a global vertical coordinate to a row in the window hit-testing grid
+static uint8_t Sys_GetWindowGridRow(int16_t y);
+
+//! Set or clear the passed window slot bit in every grid cell touched by the passed global rect
+static void Sys_MarkWindowGrid(System* the_system, Rectangle* the_rect, uint8_t the_slot, bool add_it);
+
+//! Give the window a free slot and add it to the hit-testing grid. Returns false if no slot is available.
+static bool Sys_AddWindowToGrid(System* the_system, Window* the_window);
+
+//! Take the window out of the hit-testing grid and free up its slot
+static void Sys_RemoveWindowFromGrid(System* the_system, Window* the_window);
+
 // enable or disable the gamma correction 
 bool Sys_SetGammaMode(System* the_system, Screen* the_screen, bool enable_it);
 
@@ -359,15 +374,113 @@ void Window_BackdropWinEventHandler(EventRecord* the_event)
 }
 
 
-// // interrupt 1 is PS2 keyboard, interrupt 2 is A2560K keyboard
-// void Sys_InterruptKeyboard(void)
-// {
-// 	kbd_handle_irq();
-// }
+//! Convert a global horizontal coordinate to a column in the window hit-testing grid
+static uint8_t Sys_GetWindowGridCol(int16_t x)
+{
+	if (x < 0)
+	{
+		return 0;
+	}
+	
+	x = x >> SYS_WIN_GRID_CELL_SHIFT;
+	
+	return (x < SYS_WIN_GRID_COLS) ? x : SYS_WIN_GRID_COLS - 1;
+}
+
 
-// 
-// // interrupt 4 is PS2 mouse
-// void Sys_InterruptMouse(void);
+//! Convert a global vertical coordinate to a row in the window hit-testing grid
+static uint8_t Sys_GetWindowGridRow(int16_t y)
+{
+	if (y < 0)
+	{
+		return 0;
+	}
+	
+	y = y >> SYS_WIN_GRID_CELL_SHIFT;
+	
+	return (y < SYS_WIN_GRID_ROWS) ? y : SYS_WIN_GRID_ROWS - 1;
+}
+
+
+//! Set or clear the passed window slot bit in every grid cell touched by the passed global rect
+static void Sys_MarkWindowGrid(System* the_system, Rectangle* the_rect, uint8_t the_slot, bool add_it)
+{
+	uint32_t	the_bit = 1UL << the_slot;
+	uint8_t		min_col;
+	uint8_t		max_col;
+	uint8_t		max_row;
+	uint8_t		col;
+	uint8_t		row;
+	
+	// LOGIC:
+	//   windows partly or wholly off-screen are folded into the edge cells, same as any point tested off-screen
+	//   because the folding is monotonic, a point inside a window always lands in a cell marked for that window
+	//   a rect with MaxX < MinX (closed/never placed) touches no cells
+	
+	if (the_rect->MaxX < the_rect->MinX || the_rect->MaxY < the_rect->MinY)
+	{
+		return;
+	}
+	
+	min_col = Sys_GetWindowGridCol(the_rect->MinX);
+	max_col = Sys_GetWindowGridCol(the_rect->MaxX);
+	max_row = Sys_GetWindowGridRow(the_rect->MaxY);
+	
+	for (row = Sys_GetWindowGridRow(the_rect->MinY); row <= max_row; row++)
+	{
+		uint32_t*	the_cell = &the_system->window_grid_[row][min_col];
+		
+		for (col = min_col; col <= max_col; col++)
+		{
+			if (add_it)
+			{
+				*the_cell++ |= the_bit;
+			}
+			else
+			{
+				*the_cell++ &= ~the_bit;
+			}
+		}
+	}
+}
+
+
+//! Give the window a free slot and add it to the hit-testing grid. Returns false if no slot is available.
+static bool Sys_AddWindowToGrid(System* the_system, Window* the_window)
+{
+	uint8_t		the_slot;
+	
+	for (the_slot = 0; the_slot < SYS_MAX_WINDOWS; the_slot++)
+	{
+		if (the_system->window_slot_[the_slot] == NULL)
+		{
+			the_system->window_slot_[the_slot] = the_window;
+			the_window->id_ = the_slot;
+			Sys_MarkWindowGrid(the_system, &the_window->global_rect_, the_slot, true);
+			
+			return true;
+		}
+	}
+	
+	return false;
+}
+
+
+//! Take the window out of the hit-testing grid and free up its slot
+static void Sys_RemoveWindowFromGrid(System* the_system, Window* the_window)
+{
+	if (the_window->id_ >= SYS_MAX_WINDOWS || the_system->window_slot_[the_window->id_] != the_window)
+	{
+		LOG_WARN(("%s %d: window '%s' was not in the hit-testing grid", __func__ , __LINE__, the_window->title_));
+		return;
+	}
+	
+	Sys_MarkWindowGrid(the_system, &the_window->global_rect_, the_window->id_, false);
+	the_system->window_slot_[the_window->id_] = NULL;
+	
+	// any references to the window still held (by queued events, etc.) are now stale: see Sys_GetWindowFromRef()
+	the_system->window_generation_[the_window->id_]++;
+}
 
 
 // **** Debug functions *****
@@ -402,6 +515,10 @@ void Sys_PrintScreen(Screen* the_screen)
 	DEBUG_OUT(("  text_mem_rows_: %i", 		the_screen->text_mem_rows_));
 	DEBUG_OUT(("  text_ram_: %p", 			the_screen->text_ram_));
 	DEBUG_OUT(("  text_attr_ram_: %p", 		the_screen->text_attr_ram_));
+	DEBUG_OUT(("  text_vram_: %p", 			the_screen->text_vram_));
+	DEBUG_OUT(("  text_attr_vram_: %p", 	the_screen->text_attr_vram_));
+	DEBUG_OUT(("  text_shadow_: %p", 		the_screen->text_shadow_));
+	DEBUG_OUT(("  text_window_top_: %p", 	the_screen->text_window_top_));
 	DEBUG_OUT(("  text_font_ram_: %p", 		the_screen->text_font_ram_));
 	DEBUG_OUT(("  bitmap_[0]: %p", 			the_screen->bitmap_[0]));
 	DEBUG_OUT(("  bitmap_[1]: %p", 			the_screen->bitmap_[1]));
@@ -435,6 +552,8 @@ System* Sys_New(void)
 	
 	DEBUG_OUT(("%s %d: System object created ok...", __func__ , __LINE__));
 
+	the_system->backing_store_budget_ = SYS_DEFAULT_BACKING_STORE_BUDGET;
+
 	// event manager -- not currently 65816 compatible
 	#ifndef _C256_FMX_
 		if ( (the_system->event_manager_ = EventManager_New() ) == NULL)
@@ -511,6 +630,7 @@ bool Sys_Destroy(System** the_system)
 	{
 		if ((*the_system)->screen_[i])
 		{
+			Text_DisableShadow((*the_system)->screen_[i]);
 			LOG_ALLOC(("%s %d:	__FREE__	(*the_system)->screen_[i]	%p	size	%i", __func__ , __LINE__, (*the_system)->screen_[i], sizeof(Screen)));
 			free((*the_system)->screen_[i]);
 			(*the_system)->screen_[i] = NULL;
@@ -532,6 +652,19 @@ bool Sys_Destroy(System** the_system)
 		Menu_Destroy(&(*the_system)->menu_manager_);
 	}
 
+	// hand the keyboard and mouse back to MCP before the event manager goes away
+	if (global_old_keyboard_interrupt)
+	{
+		sys_int_register(INT_KBD_PS2, global_old_keyboard_interrupt);
+		global_old_keyboard_interrupt = NULL;
+	}
+
+	if (global_old_mouse_interrupt)
+	{
+		sys_int_register(INT_MOUSE, global_old_mouse_interrupt);
+		global_old_mouse_interrupt = NULL;
+	}
+
 	if ((*the_system)->event_manager_)
 	{
 		EventManager_Destroy(&(*the_system)->event_manager_);
@@ -542,6 +675,13 @@ bool Sys_Destroy(System** the_system)
 		Sys_DestroyAllWindows(*the_system);
 	}
 
+	for (i = 0; i < SYS_CHROME_CACHE_SIZE; i++)
+	{
+		if ((*the_system)->chrome_cache_[i].bitmap_)
+		{
+			Bitmap_Destroy(&(*the_system)->chrome_cache_[i].bitmap_);
+		}
+	}
 
 	LOG_ALLOC(("%s %d:	__FREE__	*the_system	%p	size	%i", __func__ , __LINE__, *the_system, sizeof(System)));
 	free(*the_system);
@@ -580,6 +720,7 @@ void Sys_DestroyAllWindows(System* the_system)
 	{
 		Window*		this_window = (Window*)(the_item->payload_);
 		
+		Sys_RemoveWindowFromGrid(the_system, this_window);
 		Window_Destroy(&this_window);
 		++num_nodes;
 		--the_system->window_count_;
@@ -719,10 +860,14 @@ bool Sys_InitSystem(void)
 	//R32(VICKYB_MOUSE_CTRL_A2560K) = 1;
 	
 	// set interrupt handlers
-//	ps2_init();
-//	global_old_keyboard_interrupt = sys_int_register(INT_KBD_PS2, &Sys_InterruptKeyboard);
-// 	global_old_keyboard_interrupt = sys_int_register(INT_KBD_A2560K, &Sys_InterruptKeyboard);
-// 	global_old_mouse_interrupt = sys_int_register(INT_MOUSE, &Sys_InterruptKeyboard);
+	// LOGIC:
+	//   MCP has already run ps2_init() at boot, so the keyboard and mouse are set up; we just take over their interrupts
+	//   the handlers only decode bytes into the event manager's input queue. EventManager_WaitForEvent() does the rest.
+	//   the A2560K's built-in keyboard (INT_KBD_A2560K) does not speak PS/2, and is left to MCP for now
+	global_old_keyboard_interrupt = sys_int_register(INT_KBD_PS2, &Sys_InterruptKeyboard);
+	global_old_mouse_interrupt = sys_int_register(INT_MOUSE, &Sys_InterruptMouse);
+	sys_int_enable(INT_KBD_PS2);
+	sys_int_enable(INT_MOUSE);
 
 	DEBUG_OUT(("%s %d: System initialization complete.", __func__, __LINE__));
 
@@ -739,21 +884,28 @@ error:
 
 // **** Event-handling functions *****
 
-// see MCP's ps2.c for real examples once real machine available
+//! Interrupt handler for the PS/2 keyboard: pass the byte waiting at the PS/2 port to the event manager
+void Sys_InterruptKeyboard(void)
+{
+	uint8_t		the_byte;
+	
+	the_byte = R8(PS2_DATA_PORT);
+	sys_int_clear(INT_KBD_PS2);
+	
+	EventManager_HandleKeyboardIRQ(the_byte);
+}
 
-// // interrupt 1 is PS2 keyboard, interrupt 2 is A2560K keyboard
-// void Sys_InterruptKeyboard(void)
-// {
-// 	printf("keyboard!\n");
-// 	return;
-// }
-// 
-// // interrupt 4 is PS2 mouse
-// void Sys_InterruptMouse(void)
-// {
-// 	printf("mouse!\n");
-// 	return;
-// }
+
+//! Interrupt handler for the PS/2 mouse: pass the byte waiting at the PS/2 port to the event manager
+void Sys_InterruptMouse(void)
+{
+	uint8_t		the_byte;
+	
+	the_byte = R8(PS2_DATA_PORT);
+	sys_int_clear(INT_MOUSE);
+	
+	EventManager_HandleMouseIRQ(the_byte);
+}
 
 
 
@@ -1278,6 +1430,9 @@ bool Sys_DetectScreenSize(Screen* the_screen)
 		border_y_pixels = (the_border_control_value >> 16) & 0xFF & 0x3F;
 	#endif
 	
+	// a shadow text buffer is laid out for the old mode: flush it and stop using it
+	Text_DisableShadow(the_screen);
+	
 	border_x_cols = border_x_pixels * 2 / the_screen->text_font_width_;
 	border_y_cols = border_y_pixels * 2 / the_screen->text_font_height_;
 	the_screen->text_mem_cols_ = the_screen->width_ / the_screen->text_font_width_;
@@ -1579,6 +1734,9 @@ bool Sys_AddToWindowList(System* the_system, Window* the_new_window)
 	new_display_order = SYS_MAX_WINDOWS;
 	Window_SetDisplayOrder(the_new_window, new_display_order);
 	
+	// window count is capped at SYS_MAX_WINDOWS, so a free slot is always available here
+	Sys_AddWindowToGrid(the_system, the_new_window);
+	
 	++the_system->window_count_;
 	
 	Sys_SetActiveWindow(the_system, the_new_window);
@@ -1872,7 +2030,9 @@ error:
 //! @param	y: global vertical coordinate
 Window* Sys_GetWindowAtXY(System* the_system, int16_t x, int16_t y)
 {
- 	List*	the_item;
+ 	uint32_t	the_candidates;
+ 	uint8_t		the_slot;
+ 	Window*		the_window = NULL;
 
  	if (the_system == NULL)
  	{
@@ -1893,27 +2053,102 @@ Window* Sys_GetWindowAtXY(System* the_system, int16_t x, int16_t y)
 	// LOGIC:
 	//   OS/f windows are all known by the system
 	//   each window has a display order property set by the system, from low to high being backmost to frontmost
-	//   the system also keeps them sorted in its list, with first item being front most
+	//   the system keeps a grid of screen cells, each with a bit mask of the windows that touch it
+	//   only the windows in the cell under the point need to be checked; of those that contain the point, the frontmost wins
+	//   because the display order is what decides, changing z-order never requires the grid to be touched
 		
-	the_item = *(the_system->list_windows_);
+	the_candidates = the_system->window_grid_[Sys_GetWindowGridRow(y)][Sys_GetWindowGridCol(x)];
 
-	while (the_item != NULL)
+	for (the_slot = 0; the_candidates != 0; the_slot++, the_candidates >>= 1)
 	{
- 		bool		in_this_win;
-		Window*		this_window = (Window*)(the_item->payload_);
+		Window*		this_window;
+		
+		if ((the_candidates & 0x01) == 0)
+		{
+			continue;
+		}
 		
-		in_this_win = General_PointInRect(x, y, this_window->global_rect_);
+		this_window = the_system->window_slot_[the_slot];
 		
-		if (in_this_win)
+		if (the_window != NULL && this_window->display_order_ <= the_window->display_order_)
 		{
-			DEBUG_OUT(("%s %d: window at %i, %i = '%s'", __func__, __LINE__, x, y, this_window->title_));
-			return this_window;
+			continue;
+		}
+		
+		if (General_PointInRect(x, y, this_window->global_rect_))
+		{
+			the_window = this_window;
 		}
-
-		the_item = the_item->next_item_;
 	}
 	
+	if (the_window != NULL)
+	{
+		DEBUG_OUT(("%s %d: window at %i, %i = '%s'", __func__, __LINE__, x, y, the_window->title_));
+	}
+	
+	return the_window;
+	
+error:
+	Sys_Destroy(&global_system);	// crash early, crash often
 	return NULL;
+}
+
+
+//! Get a reference to an open window that is safe to hold on to after the window may have been closed (in a queued event, etc.)
+//! @param	the_system: valid pointer to system object
+//! @return	Returns the window's slot and the slot's generation packed together, or SYS_WINDOW_REF_NONE if the window is not open
+uint32_t Sys_GetWindowRef(System* the_system, Window* the_window)
+{
+ 	if (the_system == NULL)
+ 	{
+		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
+		goto error;
+ 	}
+	
+	if (the_window == NULL || the_window->id_ >= SYS_MAX_WINDOWS || the_system->window_slot_[the_window->id_] != the_window)
+	{
+		return SYS_WINDOW_REF_NONE;
+	}
+	
+	// LOGIC:
+	//   low byte is the slot number + 1, so that no open window ever gets a ref of 0 (SYS_WINDOW_REF_NONE)
+	//   the slot's generation goes above it. Sys_RemoveWindowFromGrid() bumps the generation when it frees the slot,
+	//     so a ref to a closed window never matches again, even once a new window has been given the same slot
+	
+	return ((uint32_t)the_system->window_generation_[the_window->id_] << 8) | (the_window->id_ + 1);
+	
+error:
+	Sys_Destroy(&global_system);	// crash early, crash often
+	return SYS_WINDOW_REF_NONE;
+}
+
+
+//! Get the window a reference made with Sys_GetWindowRef() refers to
+//! @param	the_system: valid pointer to system object
+//! @return	Returns NULL if the reference is SYS_WINDOW_REF_NONE, or the window has been closed since the reference was made
+Window* Sys_GetWindowFromRef(System* the_system, uint32_t the_ref)
+{
+	uint8_t		the_slot;
+	
+ 	if (the_system == NULL)
+ 	{
+		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
+		goto error;
+ 	}
+	
+	if (the_ref == SYS_WINDOW_REF_NONE)
+	{
+		return NULL;
+	}
+	
+	the_slot = (the_ref & 0xFF) - 1;
+	
+	if (the_slot >= SYS_MAX_WINDOWS || the_system->window_generation_[the_slot] != (uint16_t)(the_ref >> 8))
+	{
+		return NULL;
+	}
+	
+	return the_system->window_slot_[the_slot];
 	
 error:
 	Sys_Destroy(&global_system);	// crash early, crash often
@@ -1921,6 +2156,46 @@ error:
 }
 
 
+//! Update the system's hit-testing grid after a window has been moved or resized
+//! NOTE: z-order changes do not require an update: the grid only narrows the candidates, the frontmost is picked by display order
+//! @param	the_system: valid pointer to system object
+//! @param	the_window: reference to a valid Window object that is already in the system's list of windows
+//! @param	the_old_rect: the global rect the window had before the change
+void Sys_UpdateWindowGrid(System* the_system, Window* the_window, Rectangle* the_old_rect)
+{
+ 	if (the_system == NULL)
+ 	{
+		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
+		goto error;
+ 	}
+
+	if (the_window == NULL || the_old_rect == NULL)
+	{
+		LOG_ERR(("%s %d: passed window or rect was null", __func__ , __LINE__));
+		goto error;
+	}
+	
+	if (the_window->id_ >= SYS_MAX_WINDOWS || the_system->window_slot_[the_window->id_] != the_window)
+	{
+		// window hasn't been added to the system yet; it will be put in the grid when it is
+		return;
+	}
+	
+	// LOGIC:
+	//   clear the window's bit from the cells of the old rect, then set it in the cells of the new one
+	//   other windows' bits are untouched, so this costs only the cells the window covers
+	
+	Sys_MarkWindowGrid(the_system, the_old_rect, the_window->id_, false);
+	Sys_MarkWindowGrid(the_system, &the_window->global_rect_, the_window->id_, true);
+	
+	return;
+	
+error:
+	Sys_Destroy(&global_system);	// crash early, crash often
+	return;
+}
+
+
 //! Set the passed window to the active window, and marks the previously active window as inactive
 //! NOTE: This will resort the list of windows to move the (new) active one to the front
 //! NOTE: The exception to this is that the backdrop window is never moved in front of other windows
@@ -2020,8 +2295,9 @@ void Sys_CloseOneWindow(System* the_system, Window* the_window)
 		goto error;
 	}
 	
-	// nullify any upcoming events that reference this Window
-	EventManager_RemoveEventsForWindow(the_window);
+	// LOGIC:
+	//   upcoming events that reference this window don't need to be hunted down: 
+	//   freeing its slot below makes their window refs stale, and EventManager_NextEvent() skips them
 	
 	// before destroying the window, calculate and distribute any damage rects that may result from it being removed from screen
 	the_new_rect.MinX = -2;
@@ -2041,6 +2317,7 @@ void Sys_CloseOneWindow(System* the_system, Window* the_window)
 	}
 	
 	// destroy the window, making sure to set a new active window
+	Sys_RemoveWindowFromGrid(the_system, the_window);
 	Window_Destroy(&the_window);
 	DEBUG_OUT(("%s %d: window destroyed", __func__ , __LINE__));
 	--the_system->window_count_;
@@ -2257,6 +2534,430 @@ error:
 
 
 
+//! Check if the passed window is entirely hidden behind a single visible window in front of it
+//! @param	the_system: valid pointer to system object
+//! @param	the_window: reference to a valid Window object
+//! @return	Returns true if no part of the window can currently be seen
+bool Sys_WindowIsOccluded(System* the_system, Window* the_window)
+{
+ 	List*	the_item;
+
+ 	if (the_system == NULL)
+ 	{
+		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
+		goto error;
+ 	}
+	
+	// LOGIC:
+	//   the window list is sorted front to back, so every window before this one in the list is in front of it
+	//   only checks for containment by one window: a window covered by a patchwork of several is treated as visible
+	
+	the_item = *(the_system->list_windows_);
+
+	while (the_item != NULL)
+	{
+		Window*		this_window = (Window*)(the_item->payload_);
+		
+		if (this_window == the_window)
+		{
+			return false;
+		}
+		
+		if (this_window->visible_ && this_window->is_backdrop_ == false &&
+			this_window->global_rect_.MinX <= the_window->global_rect_.MinX && this_window->global_rect_.MaxX >= the_window->global_rect_.MaxX &&
+			this_window->global_rect_.MinY <= the_window->global_rect_.MinY && this_window->global_rect_.MaxY >= the_window->global_rect_.MaxY)
+		{
+			return true;
+		}
+
+		the_item = the_item->next_item_;
+	}
+	
+	return false;
+	
+error:
+	Sys_Destroy(&global_system);	// crash early, crash often
+	return false;
+}
+
+
+
+// **** Backing store management functions *****
+
+
+//! Set the maximum number of bytes of off-screen window bitmaps the system should keep allocated
+//! When a window bitmap needs to be allocated or grown past this budget, the bitmaps of hidden, minimized, or fully occluded windows are discarded, least recently rendered first.
+//! Discarded bitmaps are re-allocated and redrawn when the window next needs to render or be drawn into, and the window is sent an updateEvt so it can redraw its content.
+//! @param	the_system: valid pointer to system object
+//! @param	the_budget: max bytes to keep allocated. Pass 0 for no limit.
+void Sys_SetBackingStoreBudget(System* the_system, uint32_t the_budget)
+{
+ 	if (the_system == NULL)
+ 	{
+		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
+		goto error;
+ 	}
+	
+	the_system->backing_store_budget_ = the_budget;
+	
+	// a smaller budget may already be exceeded
+	Sys_ReclaimBackingStore(the_system, 0, NULL);
+	
+	return;
+	
+error:
+	Sys_Destroy(&global_system);	// crash early, crash often
+	return;
+}
+
+
+//! @param	the_system: valid pointer to system object
+//! @return	Returns the number of bytes currently allocated for off-screen window bitmaps (backdrop excluded, as it lives in VRAM). A window that shrank still counts the larger storage it keeps.
+uint32_t Sys_GetBackingStoreUsed(System* the_system)
+{
+ 	List*		the_item;
+ 	uint32_t	bytes_used = 0;
+
+ 	if (the_system == NULL)
+ 	{
+		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
+		goto error;
+ 	}
+	
+	if (the_system->list_windows_ == NULL)
+	{
+		return 0;
+	}
+	
+	// LOGIC:
+	//   there are never more than SYS_MAX_WINDOWS, so simply add it up each time rather than keep a running count in sync
+	
+	the_item = *(the_system->list_windows_);
+
+	while (the_item != NULL)
+	{
+		Window*		this_window = (Window*)(the_item->payload_);
+		
+		if (this_window->is_backdrop_ == false && this_window->backing_store_evicted_ == false)
+		{
+			bytes_used += this_window->bitmap_->alloc_size_;
+		}
+
+		the_item = the_item->next_item_;
+	}
+	
+	return bytes_used;
+	
+error:
+	Sys_Destroy(&global_system);	// crash early, crash often
+	return 0;
+}
+
+
+//! @param	the_system: valid pointer to system object
+//! @return	Returns the number of times a window's off-screen bitmap has been discarded to stay within budget
+uint32_t Sys_GetBackingStoreEvictions(System* the_system)
+{
+ 	if (the_system == NULL)
+ 	{
+		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
+		goto error;
+ 	}
+	
+	return the_system->backing_store_evictions_;
+	
+error:
+	Sys_Destroy(&global_system);	// crash early, crash often
+	return 0;
+}
+
+
+//! @param	the_system: valid pointer to system object
+//! @return	Returns the number of times a discarded off-screen bitmap has been re-allocated and redrawn
+uint32_t Sys_GetBackingStoreRebuilds(System* the_system)
+{
+ 	if (the_system == NULL)
+ 	{
+		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
+		goto error;
+ 	}
+	
+	return the_system->backing_store_rebuilds_;
+	
+error:
+	Sys_Destroy(&global_system);	// crash early, crash often
+	return 0;
+}
+
+
+//! Evict off-screen bitmaps of hidden or occluded windows, least recently rendered first, until the passed number of bytes fits in the budget
+//! @param	the_system: valid pointer to system object
+//! @param	bytes_needed: number of bytes about to be allocated
+//! @param	the_keep_window: optional window that must not be evicted (typically the one about to get the allocation). Pass NULL if not needed.
+//! @return	Returns false if the bytes still won't fit after evicting everything that could be. The caller may still go ahead: the budget is a target, not a hard cap.
+bool Sys_ReclaimBackingStore(System* the_system, uint32_t bytes_needed, Window* the_keep_window)
+{
+ 	List*		the_item;
+ 	uint32_t	bytes_used;
+
+ 	if (the_system == NULL)
+ 	{
+		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
+		goto error;
+ 	}
+	
+	if (the_system->backing_store_budget_ == 0)
+	{
+		return true;
+	}
+	
+	// LOGIC:
+	//   candidates for eviction are windows that can't currently be seen: hidden, minimized, or entirely behind another window
+	//   the backdrop (and any other window drawn directly in VRAM), the active window, and the window asking for the space are never evicted
+	//   of the candidates, evict the one that was rendered longest ago, and repeat until the request fits
+	
+	bytes_used = Sys_GetBackingStoreUsed(the_system);
+	
+	while (bytes_used + bytes_needed > the_system->backing_store_budget_)
+	{
+		Window*		the_victim = NULL;
+		
+		the_item = (the_system->list_windows_ == NULL) ? NULL : *(the_system->list_windows_);
+
+		while (the_item != NULL)
+		{
+			Window*		this_window = (Window*)(the_item->payload_);
+			
+			if (this_window->is_backdrop_ == false && this_window->backing_store_evicted_ == false && this_window->bitmap_->in_vram_ == false &&
+				this_window != the_system->active_window_ && this_window != the_keep_window &&
+				(the_victim == NULL || this_window->last_used_ < the_victim->last_used_) &&
+				(this_window->visible_ == false || Sys_WindowIsOccluded(the_system, this_window)))
+			{
+				the_victim = this_window;
+			}
+
+			the_item = the_item->next_item_;
+		}
+		
+		if (the_victim == NULL)
+		{
+			LOG_WARN(("%s %d: backing store budget %lu exceeded (%lu used, %lu needed), and nothing left to evict", __func__ , __LINE__, the_system->backing_store_budget_, bytes_used, bytes_needed));
+			return false;
+		}
+		
+		DEBUG_OUT(("%s %d: evicting backing store of window '%s'", __func__ , __LINE__, the_victim->title_));
+		
+		bytes_used -= the_victim->bitmap_->alloc_size_;
+		
+		if (Window_EvictBackingStore(the_victim) == false)
+		{
+			LOG_ERR(("%s %d: could not evict backing store of window '%s'", __func__ , __LINE__, the_victim->title_));
+			goto error;
+		}
+		
+		++the_system->backing_store_evictions_;
+	}
+	
+	return true;
+	
+error:
+	Sys_Destroy(&global_system);	// crash early, crash often
+	return false;
+}
+
+
+//! Re-allocate and redraw the off-screen bitmap of a window that was evicted, making room for it first if necessary
+//! @param	the_system: valid pointer to system object
+//! @param	the_window: reference to a valid Window object
+//! @return	Returns false if the bitmap could not be re-allocated
+bool Sys_RestoreBackingStore(System* the_system, Window* the_window)
+{
+ 	if (the_system == NULL)
+ 	{
+		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
+		goto error;
+ 	}
+	
+	if (the_window == NULL)
+	{
+		LOG_ERR(("%s %d: passed window was null", __func__ , __LINE__));
+		goto error;
+	}
+	
+	if (the_window->backing_store_evicted_ == false)
+	{
+		return true;
+	}
+	
+	Sys_ReclaimBackingStore(the_system, (uint32_t)the_window->width_ * the_window->height_, the_window);
+	
+	if (Window_RebuildBackingStore(the_window) == false)
+	{
+		LOG_ERR(("%s %d: could not rebuild backing store of window '%s'", __func__ , __LINE__, the_window->title_));
+		return false;
+	}
+	
+	++the_system->backing_store_rebuilds_;
+	
+	return true;
+	
+error:
+	Sys_Destroy(&global_system);	// crash early, crash often
+	return false;
+}
+
+
+
+
+// **** Window chrome cache functions *****
+
+
+//! Find a pre-rendered titlebar matching the passed size and state
+//! @param	the_system: valid pointer to system object
+//! @param	width, height: size of the titlebar rect, in pixels
+//! @param	widget_mask: which built-in widgets the titlebar has (1 bit per window_base_control_id)
+//! @param	is_active: true to find a titlebar drawn in the active state, false for the inactive state
+//! @return	Returns a bitmap of exactly width x height to blit into the window, or NULL if none has been cached
+Bitmap* Sys_GetCachedChrome(System* the_system, int16_t width, int16_t height, uint8_t widget_mask, bool is_active)
+{
+	ChromeCacheEntry*	the_entry;
+	int16_t				i;
+	
+	if (the_system == NULL)
+	{
+		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
+		goto error;
+	}
+	
+	for (i = 0; i < SYS_CHROME_CACHE_SIZE; i++)
+	{
+		the_entry = &the_system->chrome_cache_[i];
+		
+		if (the_entry->bitmap_ != NULL && the_entry->width_ == width && the_entry->height_ == height && the_entry->widget_mask_ == widget_mask && the_entry->active_ == is_active)
+		{
+			the_entry->last_used_ = ++the_system->chrome_clock_;
+			return the_entry->bitmap_;
+		}
+	}
+	
+	return NULL;
+	
+error:
+	Sys_Destroy(&global_system);	// crash early, crash often
+	return NULL;
+}
+
+
+//! Copy a freshly-drawn titlebar into the cache, so that other windows of the same width (or this one, on its next activate/deactivate) can reuse it
+//! If the cache is full, the least recently used titlebar is replaced.
+//! @param	the_system: valid pointer to system object
+//! @param	src_bm: the window bitmap the titlebar was drawn into
+//! @param	src_rect: the titlebar rect within src_bm
+//! @param	widget_mask: which built-in widgets were drawn into the titlebar (1 bit per window_base_control_id)
+//! @param	is_active: true if the titlebar was drawn in the active state
+//! @return	Returns false if no memory could be allocated for the copy
+bool Sys_CacheChrome(System* the_system, Bitmap* src_bm, Rectangle* src_rect, uint8_t widget_mask, bool is_active)
+{
+	ChromeCacheEntry*	the_entry;
+	ChromeCacheEntry*	oldest_entry = NULL;
+	int16_t				width;
+	int16_t				height;
+	int16_t				i;
+	
+	if (the_system == NULL)
+	{
+		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
+		goto error;
+	}
+	
+	width = src_rect->MaxX - src_rect->MinX + 1;
+	height = src_rect->MaxY - src_rect->MinY + 1;
+	
+	// LOGIC:
+	//   use an empty entry if there is one, otherwise replace the least recently used one
+	//   replaced entries keep their bitmap, resized if need be, so that windows of a few common widths don't churn the heap
+	
+	for (i = 0; i < SYS_CHROME_CACHE_SIZE; i++)
+	{
+		the_entry = &the_system->chrome_cache_[i];
+		
+		if (the_entry->bitmap_ == NULL)
+		{
+			oldest_entry = the_entry;
+			break;
+		}
+		
+		if (oldest_entry == NULL || the_entry->last_used_ < oldest_entry->last_used_)
+		{
+			oldest_entry = the_entry;
+		}
+	}
+	
+	the_entry = oldest_entry;
+	
+	if (the_entry->bitmap_ == NULL)
+	{
+		if ( (the_entry->bitmap_ = Bitmap_New(width, height, NULL, PARAM_NOT_IN_VRAM)) == NULL)
+		{
+			LOG_WARN(("%s %d: could not allocate a bitmap to cache the titlebar", __func__ , __LINE__));
+			return false;
+		}
+	}
+	else if (the_entry->width_ != width || the_entry->height_ != height)
+	{
+		if (Bitmap_Resize(the_entry->bitmap_, width, height) == false)
+		{
+			LOG_WARN(("%s %d: could not resize a bitmap to cache the titlebar", __func__ , __LINE__));
+			Bitmap_Destroy(&the_entry->bitmap_);
+			return false;
+		}
+	}
+	
+	Bitmap_BlitRect(src_bm, src_rect, the_entry->bitmap_, 0, 0);
+	
+	the_entry->width_ = width;
+	the_entry->height_ = height;
+	the_entry->widget_mask_ = widget_mask;
+	the_entry->active_ = is_active;
+	the_entry->last_used_ = ++the_system->chrome_clock_;
+	
+	return true;
+	
+error:
+	Sys_Destroy(&global_system);	// crash early, crash often
+	return false;
+}
+
+
+//! Discard all pre-rendered titlebars. Called when the theme changes.
+//! @param	the_system: valid pointer to system object
+void Sys_FlushChromeCache(System* the_system)
+{
+	int16_t		i;
+	
+	if (the_system == NULL)
+	{
+		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
+		goto error;
+	}
+	
+	for (i = 0; i < SYS_CHROME_CACHE_SIZE; i++)
+	{
+		if (the_system->chrome_cache_[i].bitmap_ != NULL)
+		{
+			Bitmap_Destroy(&the_system->chrome_cache_[i].bitmap_);
+		}
+	}
+	
+	return;
+	
+error:
+	Sys_Destroy(&global_system);	// crash early, crash often
+	return;
+}
+
+
+
 // **** Other GET functions *****
 
 
@@ -2520,6 +3221,9 @@ bool Sys_SetTheme(System* the_system, Theme* the_theme)
 	
 	the_system->theme_ = the_theme;
 	
+	// pre-rendered titlebars were drawn with the old theme's colors, widgets, and sizes
+	Sys_FlushChromeCache(the_system);
+	
 	Sys_SetSystemFont(the_system, the_theme->control_font_);
 	Sys_SetAppFont(the_system, the_theme->icon_font_);
 	
@@ -2634,6 +3338,7 @@ void Sys_Render(System* the_system)
 {
 	int16_t		num_nodes = 0;
 	List*		the_item;
+	uint32_t	start_ticks;
 
  	if (the_system == NULL)
  	{
@@ -2656,6 +3361,7 @@ void Sys_Render(System* the_system)
 	}
 	
 	//List_Print(the_system->list_windows_, (void*)&Window_PrintBrief);
+	start_ticks = sys_time_jiffies();
 	the_item = List_GetLast(the_system->list_windows_);
 	//the_item = *(the_system->list_windows_);
 
@@ -2679,6 +3385,8 @@ void Sys_Render(System* the_system)
 
 	//DEBUG_OUT(("%s %d: %i windows rendered out of %i total window", __func__ , __LINE__, num_nodes, the_system->window_count_));
 	
+	the_system->render_ticks_ += sys_time_jiffies() - start_ticks;
+	
 	return;
 	
 error:
@@ -2686,3 +3394,21 @@ error:
 	return;
 }
 
+
+//! @param	the_system: valid pointer to system object
+//! @return	Returns the total number of ticks spent in Sys_Render()
+uint32_t Sys_GetRenderTicks(System* the_system)
+{
+ 	if (the_system == NULL)
+ 	{
+		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
+		goto error;
+ 	}
+	
+	return the_system->render_ticks_;
+	
+error:
+	Sys_Destroy(&global_system);	// crash early, crash often
+	return 0;
+}
+
@@ -59,6 +59,15 @@
 #define SYS_MAX_WINDOWS					32
 #define SYS_WIN_Z_ORDER_BACKDROP		-127
 #define SYS_WIN_Z_ORDER_NEWLY_ACTIVE	SYS_MAX_WINDOWS + 1
+#define SYS_WINDOW_REF_NONE				0	// a window reference that does not refer to any window
+
+#define SYS_WIN_GRID_CELL_SHIFT			6	//! windows are indexed for hit-testing in cells of 64x64 pixels
+#define SYS_WIN_GRID_COLS				16	//! enough 64 pixel cells to cover 1024 pixels. Coordinates beyond the grid are folded into the last column.
+#define SYS_WIN_GRID_ROWS				12	//! enough 64 pixel cells to cover 768 pixels. Coordinates beyond the grid are folded into the last row.
+
+#define SYS_DEFAULT_BACKING_STORE_BUDGET	0	//! max bytes of off-screen window bitmaps to keep allocated. 0 means no limit: nothing is ever evicted.
+
+#define SYS_CHROME_CACHE_SIZE			8	//! number of pre-rendered titlebars the system keeps for reuse. One is needed per window width and active state in use.
 
 
 /*****************************************************************************/
@@ -71,6 +80,16 @@
 /*                                 Structs                                   */
 /*****************************************************************************/
 
+typedef struct ChromeCacheEntry
+{
+	Bitmap*			bitmap_;		// pre-rendered titlebar: fill, outline, and built-in widgets, but not the title. NULL if the entry is unused.
+	int16_t			width_;
+	int16_t			height_;
+	uint8_t			widget_mask_;	// which of the built-in widgets were drawn into the titlebar (1 bit per window_base_control_id)
+	bool			active_;		// drawn in the active or inactive state
+	uint32_t		last_used_;		// value of the system's chrome_clock_ when last drawn from or into. least recently used entry is replaced first.
+} ChromeCacheEntry;
+
 struct System
 {
 	EventManager*	event_manager_;
@@ -84,6 +103,15 @@ struct System
 	uint8_t			window_count_;
 	uint16_t		model_number_;
 	Menu*			menu_manager_;
+	Window*			window_slot_[SYS_MAX_WINDOWS];	// every open window has one slot; the window's id_ is its slot number
+	uint16_t		window_generation_[SYS_MAX_WINDOWS];	// bumped each time a slot is freed, so a window reference taken before a close no longer matches
+	uint32_t		window_grid_[SYS_WIN_GRID_ROWS][SYS_WIN_GRID_COLS];	// for each screen cell, a bit mask of the window slots whose global rect touches that cell
+	uint32_t		backing_store_budget_;		// max bytes of off-screen window bitmaps to keep allocated. 0 = no limit. Hidden/occluded windows are evicted, least recently rendered first, to stay under it.
+	uint32_t		backing_store_evictions_;	// number of times a window's off-screen bitmap has been discarded to stay within budget
+	uint32_t		backing_store_rebuilds_;	// number of times a discarded off-screen bitmap has been re-allocated and redrawn
+	uint32_t		render_ticks_;				// total ticks spent in Sys_Render()
+	ChromeCacheEntry	chrome_cache_[SYS_CHROME_CACHE_SIZE];	// pre-rendered titlebars, shared by all windows of the same width. Flushed when the theme changes.
+	uint32_t		chrome_clock_;				// counts uses of chrome_cache_. A whole screen of titlebars is drawn within one jiffy, so jiffies can't tell which was used last.
 	#ifdef _C256_FMX_
 		Font		rom_font_;			// for C256 systems, pre-allocate a Font object
 		uint8_t		font_data_[10240];	// for C256 systems, pre-allocate 10K for permanent use for one font.
@@ -127,6 +155,11 @@ bool Sys_InitSystem(void);
 
 // **** Event-handling functions *****
 
+//! Interrupt handler for the PS/2 keyboard: pass the byte waiting at the PS/2 port to the event manager
+void Sys_InterruptKeyboard(void);
+
+//! Interrupt handler for the PS/2 mouse: pass the byte waiting at the PS/2 port to the event manager
+void Sys_InterruptMouse(void);
 
 
 
@@ -215,6 +248,21 @@ Window* Sys_GetPreviousWindow(System* the_system);
 //! @param	y: global vertical coordinate
 Window* Sys_GetWindowAtXY(System* the_system, int16_t x, int16_t y);
 
+//! Get a reference to an open window that is safe to hold on to after the window may have been closed (in a queued event, etc.)
+//! @return	Returns the window's slot and the slot's generation packed together, or SYS_WINDOW_REF_NONE if the window is not open
+uint32_t Sys_GetWindowRef(System* the_system, Window* the_window);
+
+//! Get the window a reference made with Sys_GetWindowRef() refers to
+//! @return	Returns NULL if the reference is SYS_WINDOW_REF_NONE, or the window has been closed since the reference was made
+Window* Sys_GetWindowFromRef(System* the_system, uint32_t the_ref);
+
+//! Update the system's hit-testing grid after a window has been moved or resized
+//! NOTE: z-order changes do not require an update: the grid only narrows the candidates, the frontmost is picked by display order
+//! @param	the_system: valid pointer to system object
+//! @param	the_window: reference to a valid Window object that is already in the system's list of windows
+//! @param	the_old_rect: the global rect the window had before the change
+void Sys_UpdateWindowGrid(System* the_system, Window* the_window, Rectangle* the_old_rect);
+
 //! Set the passed window to the active window, and marks the previously active window as inactive
 //! NOTE: This will resort the list of windows to move the (new) active one to the front
 //! NOTE: The exception to this is that the backdrop window is never moved in front of other windows
@@ -239,6 +287,75 @@ void Sys_IssueMenuDamageRects(System* the_system);
 //! Note: does not call for system re-render
 void Sys_CollectDamageRects(System* the_system, Window* the_future_active_window);
 
+//! Check if the passed window is entirely hidden behind a single visible window in front of it
+//! @param	the_system: valid pointer to system object
+//! @param	the_window: reference to a valid Window object
+//! @return	Returns true if no part of the window can currently be seen
+bool Sys_WindowIsOccluded(System* the_system, Window* the_window);
+
+
+
+// **** Backing store management functions *****
+
+//! Set the maximum number of bytes of off-screen window bitmaps the system should keep allocated
+//! When a window bitmap needs to be allocated or grown past this budget, the bitmaps of hidden, minimized, or fully occluded windows are discarded, least recently rendered first.
+//! Discarded bitmaps are re-allocated and redrawn when the window next needs to render or be drawn into, and the window is sent an updateEvt so it can redraw its content.
+//! @param	the_system: valid pointer to system object
+//! @param	the_budget: max bytes to keep allocated. Pass 0 for no limit.
+void Sys_SetBackingStoreBudget(System* the_system, uint32_t the_budget);
+
+//! @param	the_system: valid pointer to system object
+//! @return	Returns the number of bytes currently allocated for off-screen window bitmaps (backdrop excluded, as it lives in VRAM). A window that shrank still counts the larger storage it keeps.
+uint32_t Sys_GetBackingStoreUsed(System* the_system);
+
+//! @param	the_system: valid pointer to system object
+//! @return	Returns the number of times a window's off-screen bitmap has been discarded to stay within budget
+uint32_t Sys_GetBackingStoreEvictions(System* the_system);
+
+//! @param	the_system: valid pointer to system object
+//! @return	Returns the number of times a discarded off-screen bitmap has been re-allocated and redrawn
+uint32_t Sys_GetBackingStoreRebuilds(System* the_system);
+
+//! Evict off-screen bitmaps of hidden or occluded windows, least recently rendered first, until the passed number of bytes fits in the budget
+//! @param	the_system: valid pointer to system object
+//! @param	bytes_needed: number of bytes about to be allocated
+//! @param	the_keep_window: optional window that must not be evicted (typically the one about to get the allocation). Pass NULL if not needed.
+//! @return	Returns false if the bytes still won't fit after evicting everything that could be. The caller may still go ahead: the budget is a target, not a hard cap.
+bool Sys_ReclaimBackingStore(System* the_system, uint32_t bytes_needed, Window* the_keep_window);
+
+//! Re-allocate and redraw the off-screen bitmap of a window that was evicted, making room for it first if necessary
+//! @param	the_system: valid pointer to system object
+//! @param	the_window: reference to a valid Window object
+//! @return	Returns false if the bitmap could not be re-allocated
+bool Sys_RestoreBackingStore(System* the_system, Window* the_window);
+
+
+
+
+// **** Window chrome cache functions *****
+
+//! Find a pre-rendered titlebar matching the passed size and state
+//! @param	the_system: valid pointer to system object
+//! @param	width, height: size of the titlebar rect, in pixels
+//! @param	widget_mask: which built-in widgets the titlebar has (1 bit per window_base_control_id)
+//! @param	is_active: true to find a titlebar drawn in the active state, false for the inactive state
+//! @return	Returns a bitmap of exactly width x height to blit into the window, or NULL if none has been cached
+Bitmap* Sys_GetCachedChrome(System* the_system, int16_t width, int16_t height, uint8_t widget_mask, bool is_active);
+
+//! Copy a freshly-drawn titlebar into the cache, so that other windows of the same width (or this one, on its next activate/deactivate) can reuse it
+//! If the cache is full, the least recently used titlebar is replaced.
+//! @param	the_system: valid pointer to system object
+//! @param	src_bm: the window bitmap the titlebar was drawn into
+//! @param	src_rect: the titlebar rect within src_bm
+//! @param	widget_mask: which built-in widgets were drawn into the titlebar (1 bit per window_base_control_id)
+//! @param	is_active: true if the titlebar was drawn in the active state
+//! @return	Returns false if no memory could be allocated for the copy
+bool Sys_CacheChrome(System* the_system, Bitmap* src_bm, Rectangle* src_rect, uint8_t widget_mask, bool is_active);
+
+//! Discard all pre-rendered titlebars. Called when the theme changes.
+//! @param	the_system: valid pointer to system object
+void Sys_FlushChromeCache(System* the_system);
+
 
 
 
@@ -367,6 +484,10 @@ Font* Sys_LoadAppFont(void);
 //! @param	the_system: valid pointer to system object
 void Sys_Render(System* the_system);
 
+//! @param	the_system: valid pointer to system object
+//! @return	Returns the total number of ticks spent in Sys_Render()
+uint32_t Sys_GetRenderTicks(System* the_system);
+
 
 
 // **** Debug functions *****
@@ -871,6 +871,9 @@ void TestWindowEvents(void)
 	ShowDescription("This is a demo of window event handling, including mouse clicks, window resizing, closing, and moving. Next action: Click on Window #1's titlebar to activate it (make it front-most window)");	
 	WaitForUser();
 
+	// capture the events below, so the same workload can be replayed with EventManager_Replay() to compare builds
+	EventManager_StartRecording(64);
+
 	// click on window 0 to activate it.
 	EventManager_AddEvent(mouseDown, 0L, win0_x + titlebar_offset_x, win0_y + titlebar_offset_y, 0L, NULL, NULL);
 	EventManager_AddEvent(mouseUp, 0L, win0_x + titlebar_offset_x, win0_y + titlebar_offset_y, 0L, NULL, NULL);
@@ -954,9 +957,8 @@ void TestWindowEvents(void)
 	EventManager_AddEvent(mouseUp, 0L, win1_x + win1_x_dist - drag_resize_amt + 1, win0_y + 9, 0L, NULL, NULL);
 	DEBUG_OUT(("%s %d: about to wait for events 3", __func__, __LINE__));
 	EventManager_WaitForEvent();
-	DEBUG_OUT(("%s %d: about to wait for events 4", __func__, __LINE__));
-	EventManager_WaitForEvent();
 	
+	EventManager_StopRecording("window_events.evt");
 }
 
 
@@ -968,6 +970,10 @@ void TestMenus(void)
 	
 	CreateMenuSystem();
 	
+	// let the active window's menus be used from the keyboard as well
+	Window_AttachMenuGroup(Sys_GetActiveWindow(global_system), &MyAppMenu);
+	Window_AttachMenuGroup(Sys_GetActiveWindow(global_system), &MyWindowSubMenu);
+	
 	// open a menu, release button, move right, click and release r button again
 	ShowDescription("This is a demo of the menu system. Next step: open a menu by right-clicking near the middle of the screen (menus stay open until dismissed)");	
 	WaitForUser();
@@ -1088,7 +1094,6 @@ void SharedEventHandler(EventRecord* the_event)
 	bool				exit_app = false;
 	
 	Window*				the_window;
-	static Rectangle	the_rect;
 	
 // 	DEBUG_OUT(("%s %d: reached", __func__, __LINE__));
 
@@ -1114,11 +1119,6 @@ void SharedEventHandler(EventRecord* the_event)
 				{
 					Window_SetPenXYFromGlobal(the_window, the_event->x_, the_event->y_);
 					Window_DrawBox(the_window, 5, 5, SYS_COLOR_GREEN1, true);
-					the_rect.MinX = the_event->x_ - the_window->x_;
-					the_rect.MinY = the_event->y_ - the_window->y_;
-					the_rect.MaxX = the_rect.MinX + 5;
-					the_rect.MaxY = the_rect.MinY + 5;
-					Window_AddClipRect(the_window, &the_rect);
 					Window_Render(the_window);
 					//Sys_Render(global_system);
 				}
@@ -1132,11 +1132,6 @@ void SharedEventHandler(EventRecord* the_event)
 				{
 					Window_SetPenXYFromGlobal(the_window, the_event->x_, the_event->y_);
 					Window_DrawBox(the_window, 5, 5, SYS_COLOR_RED1, true);
-					the_rect.MinX = the_event->x_ - the_window->x_;
-					the_rect.MinY = the_event->y_ - the_window->y_;
-					the_rect.MaxX = the_rect.MinX + 5;
-					the_rect.MaxY = the_rect.MinY + 5;
-					Window_AddClipRect(the_window, &the_rect);
 
 					if (Window_IsActive(the_window)) // temp: re-render just this window if active. if not, have to re-render all windows or it will jump to foreground
 					{
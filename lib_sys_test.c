@@ -24,6 +24,8 @@
 
 // C includes
 #include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
 
 
 // A2560 includes
@@ -33,6 +35,8 @@
 #include <mb/text.h>
 #include <mb/font.h>
 #include <mb/window.h>
+#include <mb/control.h>
+#include <mb/event.h>
 
 
 
@@ -40,6 +44,9 @@
 /*                               Definitions                                 */
 /*****************************************************************************/
 
+#define HIT_TEST_NUM_PASSES		20	// number of times to sweep the screen (or window) with hit tests in each speed test
+#define HIT_TEST_STEP			8	// pixel distance between tested points in each sweep
+
 
 
 /*****************************************************************************/
@@ -61,12 +68,59 @@ extern System*			global_system;
 /*                       Private Function Prototypes                         */
 /*****************************************************************************/
 
+// find window under a point by walking the entire window list, front to back: used as a reference for the hit-testing grid
+static Window* Test_GetWindowAtXYLinear(System* the_system, int16_t x, int16_t y);
+
+// find control under a point by walking the entire control list: used as a reference for the control index
+static Control* Test_GetControlAtXYLinear(Window* the_window, int16_t x, int16_t y);
+
 
 
 /*****************************************************************************/
 /*                       Private Function Definitions                        */
 /*****************************************************************************/
 
+// find window under a point by walking the entire window list, front to back: used as a reference for the hit-testing grid
+static Window* Test_GetWindowAtXYLinear(System* the_system, int16_t x, int16_t y)
+{
+	List*	the_item;
+	
+	the_item = *(the_system->list_windows_);
+
+	while (the_item != NULL)
+	{
+		Window*		this_window = (Window*)(the_item->payload_);
+		
+		if (General_PointInRect(x, y, this_window->global_rect_))
+		{
+			return this_window;
+		}
+
+		the_item = the_item->next_item_;
+	}
+	
+	return NULL;
+}
+
+
+// find control under a point by walking the entire control list: used as a reference for the control index
+static Control* Test_GetControlAtXYLinear(Window* the_window, int16_t x, int16_t y)
+{
+	Control*	the_control = the_window->root_control_;
+
+	while (the_control != NULL)
+	{
+		if (General_PointInRect(x, y, the_control->rect_))
+		{
+			return the_control;
+		}
+
+		the_control = the_control->next_;
+	}
+	
+	return NULL;
+}
+
 
 
 
@@ -93,6 +147,140 @@ void text_test_teardown(void)	// this is called EVERY test
 
 
 
+// **** unit tests
+
+// under a small budget, a covered or hidden window gives up its storage; showing it again rebuilds it and asks the app to redraw
+MU_TEST(sys_test_backing_store_eviction)
+{
+	NewWinTemplate*	the_win_template;
+	Window*			the_back_window;
+	Window*			the_front_window;
+	EventRecord*	the_event;
+	uint32_t		used_before;
+	uint32_t		back_size;
+	uint32_t		evictions_before;
+	uint32_t		rebuilds_before;
+	bool			got_update = false;
+	
+	mu_assert( (the_win_template = Window_GetNewWinTemplate((char*)"Evicted")) != NULL, "Could not get a new window template" );
+	the_win_template->x_ = 100;
+	the_win_template->y_ = 100;
+	the_win_template->width_ = 200;
+	the_win_template->height_ = 150;
+	mu_assert( (the_back_window = Window_New(the_win_template, NULL)) != NULL, "Could not open a window" );
+	
+	// a bigger window in front, covering all of the first one
+	the_win_template->title_ = (char*)"Covering";
+	the_win_template->x_ = 50;
+	the_win_template->y_ = 50;
+	the_win_template->width_ = 400;
+	the_win_template->height_ = 300;
+	mu_assert( (the_front_window = Window_New(the_win_template, NULL)) != NULL, "Could not open a window" );
+	
+	mu_assert( Sys_SetActiveWindow(global_system, the_front_window) == true, "Could not activate front window" );
+	Window_Render(the_back_window);
+	Window_Render(the_front_window);
+	mu_assert( Sys_WindowIsOccluded(global_system, the_back_window) == true, "Back window should be covered" );
+	
+	// shrinking keeps the larger storage, and it still counts against the budget
+	used_before = Sys_GetBackingStoreUsed(global_system);
+	Window_ChangeWindow(the_back_window, 100, 100, 150, 100, WIN_PARAM_DO_NOT_UPDATE_NORM_SIZE);
+	mu_assert_int_eq(used_before, Sys_GetBackingStoreUsed(global_system));
+	back_size = the_back_window->bitmap_->alloc_size_;
+	mu_assert( back_size > (uint32_t)the_back_window->width_ * the_back_window->height_, "Shrunk window should keep its larger storage" );
+	
+	// a budget just under what is in use: the covered window is evicted, the active one in front of it is not
+	evictions_before = Sys_GetBackingStoreEvictions(global_system);
+	Sys_SetBackingStoreBudget(global_system, used_before - 1);
+	mu_assert( the_back_window->backing_store_evicted_ == true, "Covered window was not evicted" );
+	mu_assert( the_back_window->bitmap_->addr_ == NULL, "Covered window still has storage" );
+	mu_assert( the_front_window->backing_store_evicted_ == false, "Active window was evicted" );
+	mu_assert_int_eq(evictions_before + 1, Sys_GetBackingStoreEvictions(global_system));
+	mu_assert_int_eq(used_before - back_size, Sys_GetBackingStoreUsed(global_system));
+	
+	// while it is still covered, rendering it does not bring the storage back
+	Window_Render(the_back_window);
+	mu_assert( the_back_window->backing_store_evicted_ == true, "Covered window was rebuilt" );
+	
+	// uncover it: rendering rebuilds it, and the app is sent an updateEvt to redraw its content
+	Sys_SetBackingStoreBudget(global_system, 0);
+	
+	while (EventManager_NextEvent() != NULL)
+	{
+	}
+	
+	rebuilds_before = Sys_GetBackingStoreRebuilds(global_system);
+	Window_SetVisible(the_front_window, false);
+	Window_Render(the_back_window);
+	mu_assert( the_back_window->backing_store_evicted_ == false, "Uncovered window was not rebuilt" );
+	mu_assert( the_back_window->bitmap_->addr_ != NULL, "Uncovered window has no storage" );
+	mu_assert_int_eq(rebuilds_before + 1, Sys_GetBackingStoreRebuilds(global_system));
+	
+	while ((the_event = EventManager_NextEvent()) != NULL)
+	{
+		if (the_event->what_ == updateEvt && the_event->window_ == the_back_window)
+		{
+			got_update = true;
+		}
+	}
+	
+	mu_assert( got_update == true, "Rebuilt window was not sent an updateEvt" );
+	
+	// a hidden window is evicted the same way
+	Window_SetVisible(the_front_window, true);
+	Window_SetVisible(the_back_window, false);
+	Sys_SetBackingStoreBudget(global_system, Sys_GetBackingStoreUsed(global_system) - 1);
+	mu_assert( the_back_window->backing_store_evicted_ == true, "Hidden window was not evicted" );
+	
+	Sys_SetBackingStoreBudget(global_system, 0);
+	Sys_CloseOneWindow(global_system, the_front_window);
+	Sys_CloseOneWindow(global_system, the_back_window);
+	
+	free(the_win_template);
+}
+
+// a window ref finds its window while it is open, and never again once it is closed, even after a new window gets the same slot
+MU_TEST(sys_test_window_refs)
+{
+	NewWinTemplate*	the_win_template;
+	Window*			the_first_window;
+	Window*			the_second_window;
+	uint32_t		first_ref;
+	uint32_t		second_ref;
+	int16_t			first_slot;
+	
+	mu_assert_int_eq(SYS_WINDOW_REF_NONE, Sys_GetWindowRef(global_system, NULL));
+	mu_assert( Sys_GetWindowFromRef(global_system, SYS_WINDOW_REF_NONE) == NULL, "the null ref found a window" );
+	
+	mu_assert( (the_win_template = Window_GetNewWinTemplate((char*)"First")) != NULL, "Could not get a new window template" );
+	mu_assert( (the_first_window = Window_New(the_win_template, NULL)) != NULL, "Could not open a window" );
+	first_slot = the_first_window->id_;
+	first_ref = Sys_GetWindowRef(global_system, the_first_window);
+	mu_assert( first_ref != SYS_WINDOW_REF_NONE, "open window has no ref" );
+	mu_assert( Sys_GetWindowFromRef(global_system, first_ref) == the_first_window, "ref did not find its window" );
+	mu_assert_int_eq(first_ref, Sys_GetWindowRef(global_system, the_first_window));
+	
+	Sys_CloseOneWindow(global_system, the_first_window);
+	mu_assert( Sys_GetWindowFromRef(global_system, first_ref) == NULL, "ref to a closed window still found it" );
+	
+	// the lowest free slot is handed out first, so the new window reuses the closed window's slot
+	the_win_template->title_ = (char*)"Second";
+	mu_assert( (the_second_window = Window_New(the_win_template, NULL)) != NULL, "Could not open a window" );
+	mu_assert_int_eq(first_slot, the_second_window->id_);
+	second_ref = Sys_GetWindowRef(global_system, the_second_window);
+	mu_assert( second_ref != first_ref, "reused slot gave the same ref" );
+	mu_assert( Sys_GetWindowFromRef(global_system, first_ref) == NULL, "ref to a closed window found the window in its old slot" );
+	mu_assert( Sys_GetWindowFromRef(global_system, second_ref) == the_second_window, "ref did not find its window" );
+	
+	Sys_CloseOneWindow(global_system, the_second_window);
+	mu_assert( Sys_GetWindowFromRef(global_system, second_ref) == NULL, "ref to a closed window still found it" );
+	
+	free(the_win_template);
+}
+
+
+
+
 // **** speed tests
 
 MU_TEST(text_test_hline_speed)
@@ -127,12 +315,241 @@ MU_TEST(text_test_hline_speed)
 
 
 
+// hit-test cost vs. number of windows: grid-indexed Sys_GetWindowAtXY vs. walking the window list
+MU_TEST(sys_test_window_hit_speed)
+{
+	long			start1;
+	long			end1;
+	long			start2;
+	long			end2;
+	Window*			the_window[SYS_MAX_WINDOWS];
+	NewWinTemplate*	the_win_template;
+	char			title_buff[WINDOW_MAX_WINTITLE_SIZE];
+	Screen*			the_screen = Sys_GetScreen(global_system, ID_CHANNEL_B);
+	int16_t			win_count = 0;
+	int16_t			batch_size[4] = {4, 8, 16, 28};
+	int16_t			batch;
+	int16_t			i;
+	int16_t			x;
+	int16_t			y;
+	
+	srand(1);
+	
+	mu_assert( (the_win_template = Window_GetNewWinTemplate(title_buff)) != NULL, "Could not get a new window template" );
+	
+	for (batch = 0; batch < 4; batch++)
+	{
+		// open more windows at random spots, until we have the number for this batch
+		for (; win_count < batch_size[batch]; win_count++)
+		{
+			sprintf(title_buff, "Hit test #%i", win_count + 1);
+			the_win_template->x_ = rand() % (the_screen->width_ / 2);
+			the_win_template->y_ = rand() % (the_screen->height_ / 2);
+			the_win_template->width_ = WIN_DEFAULT_MIN_WIDTH + rand() % (the_screen->width_ / 2);
+			the_win_template->height_ = WIN_DEFAULT_MIN_HEIGHT + rand() % (the_screen->height_ / 2);
+			
+			mu_assert( (the_window[win_count] = Window_New(the_win_template, NULL)) != NULL, "Could not open a window" );
+		}
+
+		// make sure the grid finds the same window the list walk does, before timing anything
+		for (y = 0; y < the_screen->height_; y += HIT_TEST_STEP)
+		{
+			for (x = 0; x < the_screen->width_; x += HIT_TEST_STEP)
+			{
+				mu_assert( Sys_GetWindowAtXY(global_system, x, y) == Test_GetWindowAtXYLinear(global_system, x, y), "Grid and list walk found different windows" );
+			}
+		}
+		
+		// test speed of first variant
+		start1 = mu_timer_real();
+		
+		for (i = 0; i < HIT_TEST_NUM_PASSES; i++)
+		{
+			for (y = 0; y < the_screen->height_; y += HIT_TEST_STEP)
+			{
+				for (x = 0; x < the_screen->width_; x += HIT_TEST_STEP)
+				{
+					Test_GetWindowAtXYLinear(global_system, x, y);
+				}
+			}
+		}
+		
+		end1 = mu_timer_real();
+		
+		// test speed of second variant
+		start2 = mu_timer_real();
+		
+		for (i = 0; i < HIT_TEST_NUM_PASSES; i++)
+		{
+			for (y = 0; y < the_screen->height_; y += HIT_TEST_STEP)
+			{
+				for (x = 0; x < the_screen->width_; x += HIT_TEST_STEP)
+				{
+					Sys_GetWindowAtXY(global_system, x, y);
+				}
+			}
+		}
+		
+		end2 = mu_timer_real();
+		
+		printf("\nSpeed results (%i windows): list walk completed in %li ticks; grid in %li ticks\n", win_count, end1 - start1, end2 - start2);
+	}
+	
+	for (i = 0; i < win_count; i++)
+	{
+		Sys_CloseOneWindow(global_system, the_window[i]);
+	}
+	
+	free(the_win_template);
+}
+// when controls cover too many cells to index, lookups fall back to the list walk, without trying to rebuild the index on every call
+MU_TEST(sys_test_control_index_overflow)
+{
+	Window*			the_window;
+	NewWinTemplate*	the_win_template;
+	Control*		the_control;
+	int16_t			num_controls;
+	int16_t			i;
+	
+	mu_assert( (the_win_template = Window_GetNewWinTemplate((char*)"Control index overflow")) != NULL, "Could not get a new window template" );
+	the_win_template->x_ = 0;
+	the_win_template->y_ = 0;
+	the_win_template->width_ = WIN_DEFAULT_MAX_WIDTH;
+	the_win_template->height_ = WIN_DEFAULT_MAX_HEIGHT;
+	mu_assert( (the_window = Window_New(the_win_template, NULL)) != NULL, "Could not open a window" );
+	
+	// stretch enough controls over the whole window that each one takes a slot in every cell
+	num_controls = WIN_CONTROL_INDEX_MAX_ENTRIES / (((the_window->width_ - 1) >> WIN_CONTROL_INDEX_CELL_SHIFT) + 1) / (((the_window->height_ - 1) >> WIN_CONTROL_INDEX_CELL_SHIFT) + 1) + 1;
+	
+	for (i = 0; i < num_controls; i++)
+	{
+		mu_assert( (the_control = Window_AddNewControl(the_window, TEXT_BUTTON, 40, 20, 0, 0, H_ALIGN_LEFT, V_ALIGN_TOP, (char*)"Big", 1000 + i, 0)) != NULL, "Could not add a control" );
+		the_control->rect_.MinX = 0;
+		the_control->rect_.MinY = 0;
+		the_control->rect_.MaxX = the_window->width_ - 1;
+		the_control->rect_.MaxY = the_window->height_ - 1;
+	}
+	
+	mu_assert( Window_GetControlAtXY(the_window, 10, 10) == Test_GetControlAtXYLinear(the_window, 10, 10), "List walk fallback found a different control" );
+	mu_assert( the_window->control_index_too_big_ == true, "Index was not marked as too big" );
+	mu_assert( the_window->control_index_invalidated_ == false, "Index will be rebuilt again on the next lookup" );
+	
+	// further lookups use the list walk as they are
+	mu_assert( Window_GetControl(the_window, 1000 + num_controls - 1) != NULL, "Could not find last control by ID" );
+	mu_assert( Window_GetControlAtXY(the_window, the_window->width_ - 1, the_window->height_ - 1) == Test_GetControlAtXYLinear(the_window, the_window->width_ - 1, the_window->height_ - 1), "List walk fallback found a different control" );
+	mu_assert( the_window->control_index_too_big_ == true && the_window->control_index_invalidated_ == false, "Lookup tried to rebuild the index" );
+	
+	// adding a control invalidates the index, so the next lookup tries again
+	mu_assert( Window_AddNewControl(the_window, TEXT_BUTTON, 40, 20, 0, 0, H_ALIGN_LEFT, V_ALIGN_TOP, (char*)"Small", 1000 + num_controls, 0) != NULL, "Could not add a control" );
+	mu_assert( the_window->control_index_invalidated_ == true, "Adding a control did not invalidate the index" );
+	mu_assert( Window_GetControl(the_window, 1000 + num_controls) != NULL, "Could not find the added control by ID" );
+	mu_assert( the_window->control_index_too_big_ == true && the_window->control_index_invalidated_ == false, "Index was not rebuilt, or was not marked as too big" );
+	
+	Sys_CloseOneWindow(global_system, the_window);
+	
+	free(the_win_template);
+}
+
+
+// hit-test cost vs. number of controls: indexed Window_GetControlAtXY vs. walking the control list
+MU_TEST(sys_test_control_hit_speed)
+{
+	long			start1;
+	long			end1;
+	long			start2;
+	long			end2;
+	Window*			the_window;
+	NewWinTemplate*	the_win_template;
+	Theme*			the_theme = Sys_GetTheme(global_system);
+	int16_t			control_count = 0;
+	int16_t			batch_size[4] = {16, 64, 128, 256};
+	int16_t			batch;
+	int16_t			i;
+	int16_t			x;
+	int16_t			y;
+	int16_t			width = 40;
+	int16_t			height = the_theme->flex_width_backdrops_[TEXT_BUTTON].height_;
+	int16_t			per_row = 14;
+	
+	mu_assert( (the_win_template = Window_GetNewWinTemplate((char*)"Control hit test")) != NULL, "Could not get a new window template" );
+	the_win_template->x_ = 0;
+	the_win_template->y_ = 0;
+	the_win_template->width_ = WIN_DEFAULT_MAX_WIDTH;
+	the_win_template->height_ = WIN_DEFAULT_MAX_HEIGHT;
+	mu_assert( (the_window = Window_New(the_win_template, NULL)) != NULL, "Could not open a window" );
+	
+	for (batch = 0; batch < 4; batch++)
+	{
+		// lay out more buttons in a grid, like icons in a file browser, until we have the number for this batch
+		for (; control_count < batch_size[batch]; control_count++)
+		{
+			x = (control_count % per_row) * (width + 10);
+			y = (control_count / per_row) * (height + 6);
+			
+			mu_assert( Window_AddNewControl(the_window, TEXT_BUTTON, width, height, x, y, H_ALIGN_LEFT, V_ALIGN_TOP, (char*)"Hit", 1000 + control_count, 0) != NULL, "Could not add a control" );
+		}
+
+		// make sure the index finds the same control the list walk does, before timing anything
+		for (y = 0; y < the_window->height_; y += HIT_TEST_STEP)
+		{
+			for (x = 0; x < the_window->width_; x += HIT_TEST_STEP)
+			{
+				mu_assert( Window_GetControlAtXY(the_window, x, y) == Test_GetControlAtXYLinear(the_window, x, y), "Index and list walk found different controls" );
+			}
+		}
+		
+		mu_assert( Window_GetControl(the_window, 1000 + control_count - 1) != NULL, "Could not find last control by ID" );
+		
+		// test speed of first variant
+		start1 = mu_timer_real();
+		
+		for (i = 0; i < HIT_TEST_NUM_PASSES; i++)
+		{
+			for (y = 0; y < the_window->height_; y += HIT_TEST_STEP)
+			{
+				for (x = 0; x < the_window->width_; x += HIT_TEST_STEP)
+				{
+					Test_GetControlAtXYLinear(the_window, x, y);
+				}
+			}
+		}
+		
+		end1 = mu_timer_real();
+		
+		// test speed of second variant
+		start2 = mu_timer_real();
+		
+		for (i = 0; i < HIT_TEST_NUM_PASSES; i++)
+		{
+			for (y = 0; y < the_window->height_; y += HIT_TEST_STEP)
+			{
+				for (x = 0; x < the_window->width_; x += HIT_TEST_STEP)
+				{
+					Window_GetControlAtXY(the_window, x, y);
+				}
+			}
+		}
+		
+		end2 = mu_timer_real();
+		
+		printf("\nSpeed results (%i controls): list walk completed in %li ticks; index in %li ticks\n", control_count, end1 - start1, end2 - start2);
+	}
+	
+	Sys_CloseOneWindow(global_system, the_window);
+	
+	free(the_win_template);
+}
+
+
+
 	// speed tests
 MU_TEST_SUITE(text_test_suite_speed)
 {	
 	MU_SUITE_CONFIGURE(&text_test_setup, &text_test_teardown);
 	
 // 	MU_RUN_TEST(text_test_hline_speed);
+	MU_RUN_TEST(sys_test_window_hit_speed);
+	MU_RUN_TEST(sys_test_control_hit_speed);
 }
 
 
@@ -142,6 +559,9 @@ MU_TEST_SUITE(text_test_suite_units)
 	MU_SUITE_CONFIGURE(&text_test_setup, &text_test_teardown);
 	
 // 	MU_RUN_TEST(font_replace_test);
+	MU_RUN_TEST(sys_test_backing_store_eviction);
+	MU_RUN_TEST(sys_test_window_refs);
+	MU_RUN_TEST(sys_test_control_index_overflow);
 }
 
 
@@ -170,7 +590,7 @@ int main(int argc, char* argv[])
 	printf("now in graphics mode");
 
 	MU_RUN_SUITE(text_test_suite_units);
-// 	MU_RUN_SUITE(text_test_suite_speed);
+	MU_RUN_SUITE(text_test_suite_speed);
 	MU_REPORT();
 
 	Sys_SetModeText(global_system, false);
@@ -134,6 +134,31 @@ void Mouse_AcceptUpdate(MouseTracker* the_mouse, Window* the_window, int16_t x,
 	
 	if (button_down)
 	{
+		uint32_t	now_ticks;
+		
+		// LOGIC:
+		//   movement_area_, clicked_ticks, and moved_ still describe the previous click at this point
+		//   this click completes a double click if the previous click was a single click that did not turn into a drag, 
+		//     it was recent enough, and the pointer is still near where it was.
+		//   a double click is never extended into a triple click: the next click starts over at 1
+		now_ticks = sys_time_jiffies();
+		
+		if (the_mouse->click_count_ == 1 && the_mouse->moved_ == false && now_ticks - the_mouse->clicked_ticks <= MOUSE_DOUBLE_CLICK_TICKS && General_PointInRect(x, y, the_mouse->movement_area_))
+		{
+			the_mouse->click_count_ = 2;
+			the_mouse->double_clicks_++;
+		}
+		else
+		{
+			the_mouse->click_count_ = 1;
+		}
+		
+		the_mouse->clicks_++;
+		the_mouse->clicked_ticks = now_ticks;
+		the_mouse->moved_ = false;
+		the_mouse->outline_x_ = x;
+		the_mouse->outline_y_ = y;
+		
 		the_mouse->clicked_window_ = the_window;
 		the_mouse->clicked_x_ = x;
 		the_mouse->clicked_y_ = y;
@@ -189,6 +214,9 @@ void Mouse_Clear(MouseTracker* the_mouse)
 	the_mouse->x_ = -1;
 	the_mouse->y_ = -1;
 	the_mouse->mode_ = mouseFree;
+	the_mouse->clicked_ticks = 0;
+	the_mouse->click_count_ = 0;
+	the_mouse->moved_ = false;
 	
 	return;
 	
@@ -363,33 +391,116 @@ error:
 // **** OTHER FUNCTIONS *****
 
 
-// check for a double click, assuming it just happened. Returns true if timer says it was double click. If not double click, resets the button down time to now.
+// check whether the last button down completed a double click: it came within MOUSE_DOUBLE_CLICK_TICKS of a single click, without the pointer having moved more than MOUSE_MOVEMENT_THRESHOLD
 bool Mouse_WasDoubleClick(MouseTracker* the_mouse)
 {
-	uint32_t	now_ticks;
+	if (the_mouse == NULL)
+	{
+		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
+		goto error;
+	}
+	
+	return (the_mouse->click_count_ == 2);
+	
+error:
+	Sys_Destroy(&global_system);	// crash early, crash often
+	return false;
+}
+
+
+// get the click count for the last button down: 1 for a single click, 2 for the second click of a double click
+uint8_t Mouse_GetClickCount(MouseTracker* the_mouse)
+{
+	if (the_mouse == NULL)
+	{
+		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
+		goto error;
+	}
+	
+	return the_mouse->click_count_;
 	
+error:
+	Sys_Destroy(&global_system);	// crash early, crash often
+	return 0;
+}
+
+
+// accept a pointer move while the button is down, and advance the gesture state
+// returns true once the pointer has moved more than MOUSE_MOVEMENT_THRESHOLD away from the button down point, and keeps returning true until the next button down
+// returns false for jitter inside the threshold, which should not start a drag, resize, or lasso, or cause any redraw
+bool Mouse_AcceptMove(MouseTracker* the_mouse, int16_t x, int16_t y)
+{
 	if (the_mouse == NULL)
 	{
 		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
 		goto error;
 	}
 	
-	now_ticks = sys_time_jiffies();
+	the_mouse->x_ = x;
+	the_mouse->y_ = y;
 	
-	if ( now_ticks - the_mouse->clicked_ticks <= MOUSE_DOUBLE_CLICK_TICKS )
+	// LOGIC:
+	//   this is the hysteresis: the pointer has to leave movement_area_ to start a gesture, but once started, 
+	//   the gesture carries on even if the pointer comes back inside it. a drag that ends where it began is still a drag.
+	if (the_mouse->moved_ == false)
 	{
-		the_mouse->mode_ = mouseDoubleclick;
-		the_mouse->clicked_ticks = 0;
-		//DEBUG_OUT(("%s %d: Double click event!", __func__ , __LINE__));
+		if (General_PointInRect(x, y, the_mouse->movement_area_))
+		{
+			the_mouse->jitter_moves_++;
+			return false;
+		}
+		
+		the_mouse->moved_ = true;
+		the_mouse->moves_started_++;
+	}
+	
+	return true;
+	
+error:
+	Sys_Destroy(&global_system);	// crash early, crash often
+	return false;
+}
 
-		return true;
+
+// check whether a drag/resize outline should be redrawn for the current pointer position
+// returns false if the pointer has not moved far enough to start a drag, if it has not moved since the last redraw, or if the last redraw was less than MOUSE_OUTLINE_REDRAW_TICKS ago
+// returns true, and records the position and time as the last redraw, otherwise
+bool Mouse_OutlineNeedsRedraw(MouseTracker* the_mouse)
+{
+	uint32_t	now_ticks;
+	
+	if (the_mouse == NULL)
+	{
+		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
+		goto error;
 	}
-	else
+	
+	if (the_mouse->moved_ == false)
 	{
-		the_mouse->clicked_ticks = now_ticks;
 		return false;
 	}
 	
+	if (the_mouse->x_ == the_mouse->outline_x_ && the_mouse->y_ == the_mouse->outline_y_)
+	{
+		return false;
+	}
+	
+	// LOGIC:
+	//   the mouse sends packets much faster than an outline can be usefully redrawn. 
+	//   skipped positions are not lost: the next redraw (or the mouse up) uses wherever the pointer is by then.
+	now_ticks = sys_time_jiffies();
+	
+	if (now_ticks - the_mouse->outline_ticks_ < MOUSE_OUTLINE_REDRAW_TICKS)
+	{
+		the_mouse->outlines_skipped_++;
+		return false;
+	}
+	
+	the_mouse->outline_ticks_ = now_ticks;
+	the_mouse->outline_x_ = the_mouse->x_;
+	the_mouse->outline_y_ = the_mouse->y_;
+	the_mouse->outlines_drawn_++;
+	
 	return true;
 	
 error:
@@ -484,7 +595,7 @@ bool Mouse_MovedEnoughForLassoStart(MouseTracker* the_mouse)
 		goto error;
 	}
 	
-	return !(General_PointInRect(the_mouse->x_, the_mouse->y_, the_mouse->movement_area_));
+	return (the_mouse->moved_ || !(General_PointInRect(the_mouse->x_, the_mouse->y_, the_mouse->movement_area_)));
 	
 error:
 	Sys_Destroy(&global_system);	// crash early, crash often
@@ -501,7 +612,7 @@ bool Mouse_MovedEnoughForDragStart(MouseTracker* the_mouse)
 		goto error;
 	}
 	
-	return !(General_PointInRect(the_mouse->x_, the_mouse->y_, the_mouse->movement_area_));
+	return (the_mouse->moved_ || !(General_PointInRect(the_mouse->x_, the_mouse->y_, the_mouse->movement_area_)));
 	
 error:
 	Sys_Destroy(&global_system);	// crash early, crash often
@@ -573,5 +684,22 @@ void Mouse_Print(MouseTracker* the_mouse)
 	DEBUG_OUT(("  clicked_ticks: %lu", 	the_mouse->clicked_ticks));
 	DEBUG_OUT(("  selection_area_: %i, %i, %i, %i", the_mouse->selection_area_.MinX, the_mouse->selection_area_.MinY, the_mouse->selection_area_.MaxX, the_mouse->selection_area_.MaxY));
 	DEBUG_OUT(("  movement_area_: %i, %i, %i, %i", the_mouse->movement_area_.MinX, the_mouse->movement_area_.MinY, the_mouse->movement_area_.MaxX, the_mouse->movement_area_.MaxY));
+	DEBUG_OUT(("  click_count_: %u", the_mouse->click_count_));
+	DEBUG_OUT(("  moved_: %i", the_mouse->moved_));
+	DEBUG_OUT(("  outline_ticks_: %lu", the_mouse->outline_ticks_));
+	DEBUG_OUT(("  outline_x_: %i", the_mouse->outline_x_));
+	DEBUG_OUT(("  outline_y_: %i", the_mouse->outline_y_));
+}
+
+// log the gesture-recognition counts: clicks, double clicks, drags started, jitter ignored, outlines drawn and skipped
+void Mouse_PrintGestureStats(MouseTracker* the_mouse)
+{
+	DEBUG_OUT(("Mouse gesture stats:"));
+	DEBUG_OUT(("  clicks_: %lu",			the_mouse->clicks_));
+	DEBUG_OUT(("  double_clicks_: %lu",		the_mouse->double_clicks_));
+	DEBUG_OUT(("  moves_started_: %lu",		the_mouse->moves_started_));
+	DEBUG_OUT(("  jitter_moves_: %lu",		the_mouse->jitter_moves_));
+	DEBUG_OUT(("  outlines_drawn_: %lu",	the_mouse->outlines_drawn_));
+	DEBUG_OUT(("  outlines_skipped_: %lu",	the_mouse->outlines_skipped_));
 }
 
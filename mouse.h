@@ -52,6 +52,7 @@
 #define MOUSE_POINTER_RADIUS		2	// number of pixels up/down/left/right from mouse pointer that will be included in selection. might need to be 0
 #define MOUSE_MOVEMENT_THRESHOLD	4	// number of pixels away from the mouse-down point that mouse must before before lasso starts drawing or drag mode begins
 #define MOUSE_DOUBLE_CLICK_TICKS	30	// maximum number of ticks between first and second click for a double-click event to be registered
+#define MOUSE_OUTLINE_REDRAW_TICKS	2	// minimum number of ticks between redraws of a drag or resize outline while the mouse is moving
 
 
 /*****************************************************************************/
@@ -93,6 +94,17 @@ struct MouseTracker
 	uint32_t		clicked_ticks;
 	Rectangle		selection_area_;	// a box around the pointer (if not lasso), or the lasso box, used to detect icon selection and drag-mode start
 	Rectangle		movement_area_;		// a box between the last clicked and current location
+	uint8_t			click_count_;		// 1 if the last button down was a single click, 2 if it completed a double click
+	bool			moved_;				// true once the pointer has left movement_area_ since the last button down. Stays true even if pointer comes back.
+	uint32_t		outline_ticks_;		// ticks when the drag/resize outline was last drawn
+	int16_t			outline_x_;			// pointer position the drag/resize outline was last drawn for
+	int16_t			outline_y_;
+	uint32_t		clicks_;			// number of button downs seen
+	uint32_t		double_clicks_;		// number of button downs that completed a double click
+	uint32_t		moves_started_;		// number of button downs that turned into a drag or lasso
+	uint32_t		jitter_moves_;		// number of moves with the button down that stayed inside movement_area_, and were ignored
+	uint32_t		outlines_drawn_;	// number of times Mouse_OutlineNeedsRedraw() returned true
+	uint32_t		outlines_skipped_;	// number of times Mouse_OutlineNeedsRedraw() returned false because the last redraw was too recent
 };
 
 
@@ -128,6 +140,7 @@ void Mouse_SetXY(MouseTracker* the_mouse, int16_t x, int16_t y);
 // sets the current x, y coord. If button_down is true, it also sets button down coord to passed coord.
 // Note: regardless of the value of the_window, clicked_window_ will only be updated if button_down is true. 
 //   Window should only be set when calling AcceptUpdate on a mouse down (click)
+// on a button down, also decides whether this click completes a double click (see Mouse_WasDoubleClick)
 void Mouse_AcceptUpdate(MouseTracker* the_mouse, Window* the_window, int16_t x, int16_t y, bool button_down);
 
 // updates the selection rectangle
@@ -173,9 +186,22 @@ int16_t Mouse_GetYDelta(MouseTracker* the_mouse);
 
 // **** OTHER FUNCTIONS *****
 
-// check for a double click, assuming it just happened. Returns true if timer says it was double click. If not double click, resets the button down time to now.
+// check whether the last button down completed a double click: it came within MOUSE_DOUBLE_CLICK_TICKS of a single click, without the pointer having moved more than MOUSE_MOVEMENT_THRESHOLD
 bool Mouse_WasDoubleClick(MouseTracker* the_mouse);
 
+// get the click count for the last button down: 1 for a single click, 2 for the second click of a double click
+uint8_t Mouse_GetClickCount(MouseTracker* the_mouse);
+
+// accept a pointer move while the button is down, and advance the gesture state
+// returns true once the pointer has moved more than MOUSE_MOVEMENT_THRESHOLD away from the button down point, and keeps returning true until the next button down
+// returns false for jitter inside the threshold, which should not start a drag, resize, or lasso, or cause any redraw
+bool Mouse_AcceptMove(MouseTracker* the_mouse, int16_t x, int16_t y);
+
+// check whether a drag/resize outline should be redrawn for the current pointer position
+// returns false if the pointer has not moved far enough to start a drag, if it has not moved since the last redraw, or if the last redraw was less than MOUSE_OUTLINE_REDRAW_TICKS ago
+// returns true, and records the position and time as the last redraw, otherwise
+bool Mouse_OutlineNeedsRedraw(MouseTracker* the_mouse);
+
 // detect an overlap (selection) between the current selection area of the mouse, and the passed rectangle
 bool Mouse_DetectOverlap(MouseTracker* the_mouse, Rectangle the_other_object);
 
@@ -194,6 +220,9 @@ void Mouse_DrawSelectionBox(MouseTracker* the_mouse);
 
 void Mouse_Print(MouseTracker* the_mouse);
 
+// log the gesture-recognition counts: clicks, double clicks, drags started, jitter ignored, outlines drawn and skipped
+void Mouse_PrintGestureStats(MouseTracker* the_mouse);
+
 
 
 
@@ -0,0 +1,928 @@
+/*
+ * terminal.c
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+
+
+
+
+/*****************************************************************************/
+/*                                Includes                                   */
+/*****************************************************************************/
+
+// project includes
+#include "terminal.h"
+#include "text.h"
+
+// A2560 includes
+#include <mcp/syscalls.h>
+#include "lib_sys.h"
+#include "general.h"
+
+// C includes
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+
+/*****************************************************************************/
+/*                               Definitions                                 */
+/*****************************************************************************/
+
+
+
+/*****************************************************************************/
+/*                             Global Variables                              */
+/*****************************************************************************/
+
+extern System*			global_system;
+
+
+
+/*****************************************************************************/
+/*                       Private Function Prototypes                         */
+/*****************************************************************************/
+
+// true if the passed byte is drawn, rather than acted on
+bool Terminal_IsPrintable(unsigned char the_char);
+
+// work out the colors to draw with from the SGR colors, bold, and reverse
+void Terminal_UpdateDrawColors(Terminal* the_terminal);
+
+// return the parameter at the passed index, or the passed default if it was missing or 0
+int16_t Terminal_GetParam(Terminal* the_terminal, uint8_t the_index, int16_t the_default);
+
+// keep the cursor inside the area
+void Terminal_ClampCursor(Terminal* the_terminal);
+
+// erase a rectangle of the area, in coordinates relative to the area, with the current background color
+void Terminal_Erase(Terminal* the_terminal, int16_t x1, int16_t y1, int16_t x2, int16_t y2);
+
+// scroll rows first_row to last_row of the area. positive num_rows scrolls up.
+void Terminal_ScrollRows(Terminal* the_terminal, int16_t first_row, int16_t last_row, int16_t num_rows);
+
+// move down a row, scrolling the scroll region if at its bottom
+void Terminal_LineFeed(Terminal* the_terminal);
+
+// move up a row, scrolling the scroll region down if at its top
+void Terminal_ReverseLineFeed(Terminal* the_terminal);
+
+// act on a byte that is not part of a run of printable characters
+void Terminal_ProcessByte(Terminal* the_terminal, unsigned char the_char);
+
+// act on a control character (0x00-0x1F)
+void Terminal_ProcessControl(Terminal* the_terminal, unsigned char the_char);
+
+// act on the byte after an ESC
+void Terminal_ProcessEscape(Terminal* the_terminal, unsigned char the_char);
+
+// act on a complete CSI sequence, given its final byte
+void Terminal_ProcessCSI(Terminal* the_terminal, unsigned char the_final);
+
+// act on a CSI m (Select Graphic Rendition) sequence
+void Terminal_ProcessSGR(Terminal* the_terminal);
+
+
+
+/*****************************************************************************/
+/*                       Private Function Definitions                        */
+/*****************************************************************************/
+
+// true if the passed byte is drawn, rather than acted on
+// LOGIC: the A2560 font has glyphs for 0x80-0xFF (code page 437), so those are drawn too
+bool Terminal_IsPrintable(unsigned char the_char)
+{
+	return (the_char >= ' ' && the_char != 0x7F);
+}
+
+
+// work out the colors to draw with from the SGR colors, bold, and reverse
+void Terminal_UpdateDrawColors(Terminal* the_terminal)
+{
+	uint8_t		the_fore;
+	uint8_t		the_back;
+
+	// LOGIC:
+	//   ANSI colors 0-7 are in the same order as the first 8 text mode colors, and the bright versions are the next 8
+	//   bold is shown as the bright version of the foreground color
+	the_fore = the_terminal->fore_color_;
+	the_back = the_terminal->back_color_;
+
+	if (the_terminal->bold_)
+	{
+		the_fore |= 0x08;
+	}
+
+	if (the_terminal->reverse_)
+	{
+		the_terminal->draw_fore_ = the_back;
+		the_terminal->draw_back_ = the_fore;
+	}
+	else
+	{
+		the_terminal->draw_fore_ = the_fore;
+		the_terminal->draw_back_ = the_back;
+	}
+}
+
+
+// return the parameter at the passed index, or the passed default if it was missing or 0
+int16_t Terminal_GetParam(Terminal* the_terminal, uint8_t the_index, int16_t the_default)
+{
+	if (the_index >= the_terminal->param_count_ || the_terminal->params_[the_index] == 0)
+	{
+		return the_default;
+	}
+
+	return the_terminal->params_[the_index];
+}
+
+
+// keep the cursor inside the area
+void Terminal_ClampCursor(Terminal* the_terminal)
+{
+	if (the_terminal->cursor_x_ < 0)
+	{
+		the_terminal->cursor_x_ = 0;
+	}
+	else if (the_terminal->cursor_x_ >= the_terminal->width_)
+	{
+		the_terminal->cursor_x_ = the_terminal->width_ - 1;
+	}
+
+	if (the_terminal->cursor_y_ < 0)
+	{
+		the_terminal->cursor_y_ = 0;
+	}
+	else if (the_terminal->cursor_y_ >= the_terminal->height_)
+	{
+		the_terminal->cursor_y_ = the_terminal->height_ - 1;
+	}
+}
+
+
+// erase a rectangle of the area, in coordinates relative to the area, with the current background color
+void Terminal_Erase(Terminal* the_terminal, int16_t x1, int16_t y1, int16_t x2, int16_t y2)
+{
+	if (x1 > x2 || y1 > y2)
+	{
+		return;
+	}
+
+	Text_FillBox(the_terminal->screen_, the_terminal->x1_ + x1, the_terminal->y1_ + y1, the_terminal->x1_ + x2, the_terminal->y1_ + y2, CH_SPACE, the_terminal->draw_fore_, the_terminal->draw_back_);
+}
+
+
+// scroll rows first_row to last_row of the area. positive num_rows scrolls up.
+void Terminal_ScrollRows(Terminal* the_terminal, int16_t first_row, int16_t last_row, int16_t num_rows)
+{
+	if (first_row > last_row || num_rows == 0)
+	{
+		return;
+	}
+
+	Text_ScrollBox(the_terminal->screen_, the_terminal->x1_, the_terminal->y1_ + first_row, the_terminal->x2_, the_terminal->y1_ + last_row, num_rows, the_terminal->draw_fore_, the_terminal->draw_back_);
+}
+
+
+// move down a row, scrolling the scroll region if at its bottom
+void Terminal_LineFeed(Terminal* the_terminal)
+{
+	if (the_terminal->cursor_y_ == the_terminal->scroll_bottom_)
+	{
+		Terminal_ScrollRows(the_terminal, the_terminal->scroll_top_, the_terminal->scroll_bottom_, 1);
+	}
+	else if (the_terminal->cursor_y_ < the_terminal->height_ - 1)
+	{
+		the_terminal->cursor_y_++;
+	}
+}
+
+
+// move up a row, scrolling the scroll region down if at its top
+void Terminal_ReverseLineFeed(Terminal* the_terminal)
+{
+	if (the_terminal->cursor_y_ == the_terminal->scroll_top_)
+	{
+		Terminal_ScrollRows(the_terminal, the_terminal->scroll_top_, the_terminal->scroll_bottom_, -1);
+	}
+	else if (the_terminal->cursor_y_ > 0)
+	{
+		the_terminal->cursor_y_--;
+	}
+}
+
+
+// act on a byte that is not part of a run of printable characters
+void Terminal_ProcessByte(Terminal* the_terminal, unsigned char the_char)
+{
+	// LOGIC:
+	//   as on a VT100, control characters are acted on even in the middle of an escape sequence
+	//   ESC always starts a new escape sequence, abandoning any unfinished one
+	if (the_char == CH_ESC)
+	{
+		the_terminal->state_ = TERMINAL_STATE_ESCAPE;
+		return;
+	}
+
+	if (the_char < ' ')
+	{
+		Terminal_ProcessControl(the_terminal, the_char);
+		return;
+	}
+
+	switch (the_terminal->state_)
+	{
+		case TERMINAL_STATE_ESCAPE:
+			Terminal_ProcessEscape(the_terminal, the_char);
+			break;
+
+		case TERMINAL_STATE_CSI:
+			if (the_char >= '0' && the_char <= '9')
+			{
+				if (the_terminal->param_count_ == 0)
+				{
+					the_terminal->param_count_ = 1;
+				}
+
+				if (the_terminal->param_count_ <= TERMINAL_MAX_PARAMS)
+				{
+					int16_t*	the_param = &the_terminal->params_[the_terminal->param_count_ - 1];
+
+					*the_param = *the_param * 10 + (the_char - '0');
+
+					if (*the_param > TERMINAL_MAX_PARAM_VALUE)
+					{
+						*the_param = TERMINAL_MAX_PARAM_VALUE;
+					}
+				}
+			}
+			else if (the_char == ';')
+			{
+				// LOGIC: a leading ';' means the first parameter was left out
+				if (the_terminal->param_count_ == 0)
+				{
+					the_terminal->param_count_ = 1;
+				}
+
+				if (the_terminal->param_count_ <= TERMINAL_MAX_PARAMS)
+				{
+					the_terminal->param_count_++;
+				}
+			}
+			else if (the_char >= '<' && the_char <= '?')
+			{
+				the_terminal->private_mode_ = true;
+			}
+			else if (the_char >= 0x40 && the_char <= 0x7E)
+			{
+				if (the_terminal->param_count_ > TERMINAL_MAX_PARAMS)
+				{
+					the_terminal->param_count_ = TERMINAL_MAX_PARAMS;
+				}
+
+				the_terminal->state_ = TERMINAL_STATE_NORMAL;
+				Terminal_ProcessCSI(the_terminal, the_char);
+			}
+			// anything else (intermediate bytes 0x20-0x2F) is ignored
+			break;
+
+		case TERMINAL_STATE_CHARSET:
+			// only the one built-in character set is available
+			the_terminal->state_ = TERMINAL_STATE_NORMAL;
+			break;
+
+		default:
+			// DEL: nothing to do. printable characters never get here; Terminal_Write() draws them.
+			break;
+	}
+}
+
+
+// act on a control character (0x00-0x1F)
+void Terminal_ProcessControl(Terminal* the_terminal, unsigned char the_char)
+{
+	switch (the_char)
+	{
+		case '\b':
+			Terminal_ClampCursor(the_terminal);
+
+			if (the_terminal->cursor_x_ > 0)
+			{
+				the_terminal->cursor_x_--;
+			}
+			break;
+
+		case '\t':
+			the_terminal->cursor_x_ = (the_terminal->cursor_x_ / TERMINAL_TAB_WIDTH + 1) * TERMINAL_TAB_WIDTH;
+
+			if (the_terminal->cursor_x_ >= the_terminal->width_)
+			{
+				the_terminal->cursor_x_ = the_terminal->width_ - 1;
+			}
+			break;
+
+		case '\n':
+		case '\v':
+		case '\f':
+			// LOGIC: Unix programs expect the tty to turn \n into \r\n
+			the_terminal->cursor_x_ = 0;
+			Terminal_LineFeed(the_terminal);
+			break;
+
+		case '\r':
+			the_terminal->cursor_x_ = 0;
+			break;
+
+		default:
+			// BEL, NUL, SO/SI, etc.: nothing to do
+			break;
+	}
+}
+
+
+// act on the byte after an ESC
+void Terminal_ProcessEscape(Terminal* the_terminal, unsigned char the_char)
+{
+	the_terminal->state_ = TERMINAL_STATE_NORMAL;
+	the_terminal->escapes_++;
+
+	switch (the_char)
+	{
+		case '[':
+			memset(the_terminal->params_, 0, sizeof(the_terminal->params_));
+			the_terminal->param_count_ = 0;
+			the_terminal->private_mode_ = false;
+			the_terminal->state_ = TERMINAL_STATE_CSI;
+			break;
+
+		case '(':
+		case ')':
+			the_terminal->state_ = TERMINAL_STATE_CHARSET;
+			break;
+
+		case '7':
+			the_terminal->saved_x_ = the_terminal->cursor_x_;
+			the_terminal->saved_y_ = the_terminal->cursor_y_;
+			break;
+
+		case '8':
+			the_terminal->cursor_x_ = the_terminal->saved_x_;
+			the_terminal->cursor_y_ = the_terminal->saved_y_;
+			break;
+
+		case 'D':
+			Terminal_ClampCursor(the_terminal);
+			Terminal_LineFeed(the_terminal);
+			break;
+
+		case 'E':
+			the_terminal->cursor_x_ = 0;
+			Terminal_LineFeed(the_terminal);
+			break;
+
+		case 'M':
+			Terminal_ClampCursor(the_terminal);
+			Terminal_ReverseLineFeed(the_terminal);
+			break;
+
+		case 'c':
+			Terminal_Reset(the_terminal);
+			break;
+
+		default:
+			break;
+	}
+}
+
+
+// act on a complete CSI sequence, given its final byte
+void Terminal_ProcessCSI(Terminal* the_terminal, unsigned char the_final)
+{
+	int16_t		n;
+	int16_t		top;
+	int16_t		bottom;
+
+	// LOGIC: private sequences (cursor visibility, etc.) have nothing to act on in text mode
+	if (the_terminal->private_mode_)
+	{
+		return;
+	}
+
+	// LOGIC: a pending wrap is cancelled by anything that moves or uses the cursor
+	if (the_final != 'm')
+	{
+		Terminal_ClampCursor(the_terminal);
+	}
+
+	n = Terminal_GetParam(the_terminal, 0, 1);
+
+	switch (the_final)
+	{
+		case 'A':	// cursor up
+			the_terminal->cursor_y_ -= n;
+			break;
+
+		case 'B':	// cursor down
+			the_terminal->cursor_y_ += n;
+			break;
+
+		case 'C':	// cursor forward
+			the_terminal->cursor_x_ += n;
+			break;
+
+		case 'D':	// cursor back
+			the_terminal->cursor_x_ -= n;
+			break;
+
+		case 'E':	// cursor to start of line, n lines down
+			the_terminal->cursor_x_ = 0;
+			the_terminal->cursor_y_ += n;
+			break;
+
+		case 'F':	// cursor to start of line, n lines up
+			the_terminal->cursor_x_ = 0;
+			the_terminal->cursor_y_ -= n;
+			break;
+
+		case 'G':	// cursor to column
+			the_terminal->cursor_x_ = n - 1;
+			break;
+
+		case 'd':	// cursor to row
+			the_terminal->cursor_y_ = n - 1;
+			break;
+
+		case 'H':	// cursor to row;column
+		case 'f':
+			the_terminal->cursor_y_ = n - 1;
+			the_terminal->cursor_x_ = Terminal_GetParam(the_terminal, 1, 1) - 1;
+			break;
+
+		case 'J':	// erase in display
+			switch (Terminal_GetParam(the_terminal, 0, 0))
+			{
+				case 0:
+					Terminal_Erase(the_terminal, the_terminal->cursor_x_, the_terminal->cursor_y_, the_terminal->width_ - 1, the_terminal->cursor_y_);
+					Terminal_Erase(the_terminal, 0, the_terminal->cursor_y_ + 1, the_terminal->width_ - 1, the_terminal->height_ - 1);
+					break;
+
+				case 1:
+					Terminal_Erase(the_terminal, 0, 0, the_terminal->width_ - 1, the_terminal->cursor_y_ - 1);
+					Terminal_Erase(the_terminal, 0, the_terminal->cursor_y_, the_terminal->cursor_x_, the_terminal->cursor_y_);
+					break;
+
+				default:
+					Terminal_Erase(the_terminal, 0, 0, the_terminal->width_ - 1, the_terminal->height_ - 1);
+					break;
+			}
+			break;
+
+		case 'K':	// erase in line
+			switch (Terminal_GetParam(the_terminal, 0, 0))
+			{
+				case 0:
+					Terminal_Erase(the_terminal, the_terminal->cursor_x_, the_terminal->cursor_y_, the_terminal->width_ - 1, the_terminal->cursor_y_);
+					break;
+
+				case 1:
+					Terminal_Erase(the_terminal, 0, the_terminal->cursor_y_, the_terminal->cursor_x_, the_terminal->cursor_y_);
+					break;
+
+				default:
+					Terminal_Erase(the_terminal, 0, the_terminal->cursor_y_, the_terminal->width_ - 1, the_terminal->cursor_y_);
+					break;
+			}
+			break;
+
+		case 'X':	// erase characters
+			Terminal_Erase(the_terminal, the_terminal->cursor_x_, the_terminal->cursor_y_, the_terminal->cursor_x_ + n - 1 < the_terminal->width_ ? the_terminal->cursor_x_ + n - 1 : the_terminal->width_ - 1, the_terminal->cursor_y_);
+			break;
+
+		case 'L':	// insert lines at the cursor, pushing the lines below it down the scroll region
+			if (the_terminal->cursor_y_ >= the_terminal->scroll_top_ && the_terminal->cursor_y_ <= the_terminal->scroll_bottom_)
+			{
+				Terminal_ScrollRows(the_terminal, the_terminal->cursor_y_, the_terminal->scroll_bottom_, -n);
+				the_terminal->cursor_x_ = 0;
+			}
+			break;
+
+		case 'M':	// delete lines at the cursor, pulling the lines below it up the scroll region
+			if (the_terminal->cursor_y_ >= the_terminal->scroll_top_ && the_terminal->cursor_y_ <= the_terminal->scroll_bottom_)
+			{
+				Terminal_ScrollRows(the_terminal, the_terminal->cursor_y_, the_terminal->scroll_bottom_, n);
+				the_terminal->cursor_x_ = 0;
+			}
+			break;
+
+		case 'S':	// scroll the scroll region up
+			Terminal_ScrollRows(the_terminal, the_terminal->scroll_top_, the_terminal->scroll_bottom_, n);
+			break;
+
+		case 'T':	// scroll the scroll region down
+			Terminal_ScrollRows(the_terminal, the_terminal->scroll_top_, the_terminal->scroll_bottom_, -n);
+			break;
+
+		case 'm':
+			Terminal_ProcessSGR(the_terminal);
+			break;
+
+		case 'r':	// set scroll region, and home the cursor
+			top = Terminal_GetParam(the_terminal, 0, 1) - 1;
+			bottom = Terminal_GetParam(the_terminal, 1, the_terminal->height_) - 1;
+
+			if (bottom >= the_terminal->height_)
+			{
+				bottom = the_terminal->height_ - 1;
+			}
+
+			if (top < bottom)
+			{
+				the_terminal->scroll_top_ = top;
+				the_terminal->scroll_bottom_ = bottom;
+				the_terminal->cursor_x_ = 0;
+				the_terminal->cursor_y_ = 0;
+			}
+			break;
+
+		case 's':
+			the_terminal->saved_x_ = the_terminal->cursor_x_;
+			the_terminal->saved_y_ = the_terminal->cursor_y_;
+			break;
+
+		case 'u':
+			the_terminal->cursor_x_ = the_terminal->saved_x_;
+			the_terminal->cursor_y_ = the_terminal->saved_y_;
+			break;
+
+		default:
+			break;
+	}
+
+	if (the_final != 'm')
+	{
+		Terminal_ClampCursor(the_terminal);
+	}
+}
+
+
+// act on a CSI m (Select Graphic Rendition) sequence
+void Terminal_ProcessSGR(Terminal* the_terminal)
+{
+	uint8_t		i;
+	int16_t		the_param;
+
+	// LOGIC: "CSI m" with no parameters is the same as "CSI 0 m"
+	if (the_terminal->param_count_ == 0)
+	{
+		the_terminal->param_count_ = 1;
+	}
+
+	for (i = 0; i < the_terminal->param_count_; i++)
+	{
+		the_param = the_terminal->params_[i];
+
+		if (the_param == 0)
+		{
+			the_terminal->fore_color_ = the_terminal->default_fore_;
+			the_terminal->back_color_ = the_terminal->default_back_;
+			the_terminal->bold_ = false;
+			the_terminal->reverse_ = false;
+		}
+		else if (the_param == 1)
+		{
+			the_terminal->bold_ = true;
+		}
+		else if (the_param == 22)
+		{
+			the_terminal->bold_ = false;
+		}
+		else if (the_param == 7)
+		{
+			the_terminal->reverse_ = true;
+		}
+		else if (the_param == 27)
+		{
+			the_terminal->reverse_ = false;
+		}
+		else if (the_param >= 30 && the_param <= 37)
+		{
+			the_terminal->fore_color_ = the_param - 30;
+		}
+		else if (the_param == 39)
+		{
+			the_terminal->fore_color_ = the_terminal->default_fore_;
+		}
+		else if (the_param >= 40 && the_param <= 47)
+		{
+			the_terminal->back_color_ = the_param - 40;
+		}
+		else if (the_param == 49)
+		{
+			the_terminal->back_color_ = the_terminal->default_back_;
+		}
+		else if (the_param >= 90 && the_param <= 97)
+		{
+			the_terminal->fore_color_ = the_param - 90 + 8;
+		}
+		else if (the_param >= 100 && the_param <= 107)
+		{
+			the_terminal->back_color_ = the_param - 100 + 8;
+		}
+		else if ((the_param == 38 || the_param == 48) && i + 1 < the_terminal->param_count_)
+		{
+			// LOGIC:
+			//   38;5;n and 48;5;n pick from a 256 color palette. the first 16 are the same as the text mode colors; others are ignored.
+			//   38;2;r;g;b and 48;2;r;g;b are 24-bit colors, which are skipped.
+			if (the_terminal->params_[i + 1] == 5 && i + 2 < the_terminal->param_count_)
+			{
+				if (the_terminal->params_[i + 2] < 16)
+				{
+					if (the_param == 38)
+					{
+						the_terminal->fore_color_ = the_terminal->params_[i + 2];
+					}
+					else
+					{
+						the_terminal->back_color_ = the_terminal->params_[i + 2];
+					}
+				}
+
+				i += 2;
+			}
+			else if (the_terminal->params_[i + 1] == 2)
+			{
+				i += 4;
+			}
+		}
+		// anything else (italic, underline, blink, etc.) can't be shown in text mode, and is ignored
+	}
+
+	Terminal_UpdateDrawColors(the_terminal);
+}
+
+
+
+
+/*****************************************************************************/
+/*                        Public Function Definitions                        */
+/*****************************************************************************/
+
+
+
+// **** CONSTRUCTOR AND DESTRUCTOR *****
+
+
+// constructor
+//! Allocate a terminal for a rectangular area of a text screen, and clear the area
+//! @param	the_screen: valid pointer to the target screen to operate on
+//! @param	x1: the leftmost horizontal position, between 0 and the screen's text_cols_vis_ - 1
+//! @param	y1: the uppermost vertical position, between 0 and the screen's text_rows_vis_ - 1
+//! @param	x2: the rightmost horizontal position, between 0 and the screen's text_cols_vis_ - 1
+//! @param	y2: the lowermost vertical position, between 0 and the screen's text_rows_vis_ - 1
+//! @param	fore_color: Index to the default foreground color (0-15)
+//! @param	back_color: Index to the default background color (0-15)
+//! @return	Returns NULL on any error/invalid input, or if memory could not be allocated
+Terminal* Terminal_New(Screen* the_screen, int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint8_t fore_color, uint8_t back_color)
+{
+	Terminal*	the_terminal = NULL;
+
+	if (the_screen == NULL)
+	{
+		LOG_ERR(("%s %d: passed screen was NULL", __func__, __LINE__));
+		goto error;
+	}
+
+	if (x1 < 0 || y1 < 0 || x1 > x2 || y1 > y2 || x2 >= the_screen->text_cols_vis_ || y2 >= the_screen->text_rows_vis_)
+	{
+		LOG_ERR(("%s %d: illegal coordinates (%i, %i) - (%i, %i)", __func__, __LINE__, x1, y1, x2, y2));
+		goto error;
+	}
+
+	if (fore_color > 15 || back_color > 15)
+	{
+		LOG_ERR(("%s %d: illegal color (%u, %u)", __func__, __LINE__, fore_color, back_color));
+		goto error;
+	}
+
+	if ( (the_terminal = (Terminal*)calloc(1, sizeof(Terminal)) ) == NULL)
+	{
+		LOG_ERR(("%s %d: could not allocate memory to create new Terminal object", __func__ , __LINE__));
+		goto error;
+	}
+	LOG_ALLOC(("%s %d:	__ALLOC__	the_terminal	%p	size	%i", __func__ , __LINE__, the_terminal, sizeof(Terminal)));
+
+	the_terminal->screen_ = the_screen;
+	the_terminal->x1_ = x1;
+	the_terminal->y1_ = y1;
+	the_terminal->x2_ = x2;
+	the_terminal->y2_ = y2;
+	the_terminal->width_ = x2 - x1 + 1;
+	the_terminal->height_ = y2 - y1 + 1;
+	the_terminal->default_fore_ = fore_color;
+	the_terminal->default_back_ = back_color;
+
+	Terminal_Reset(the_terminal);
+
+	return the_terminal;
+
+error:
+	return NULL;
+}
+
+
+// destructor
+// frees all allocated memory associated with the passed object, and the object itself
+void Terminal_Destroy(Terminal** the_terminal)
+{
+	if (*the_terminal == NULL)
+	{
+		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
+		return;
+	}
+
+	LOG_ALLOC(("%s %d:	__FREE__	*the_terminal	%p	size	%i", __func__ , __LINE__, *the_terminal, sizeof(Terminal)));
+	free(*the_terminal);
+	*the_terminal = NULL;
+}
+
+
+
+
+// **** SETTERS *****
+
+
+//! Put the terminal back to its starting state: default colors, cursor at top left, full-height scroll region, and a cleared area
+void Terminal_Reset(Terminal* the_terminal)
+{
+	if (the_terminal == NULL)
+	{
+		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
+		goto error;
+	}
+
+	the_terminal->fore_color_ = the_terminal->default_fore_;
+	the_terminal->back_color_ = the_terminal->default_back_;
+	the_terminal->bold_ = false;
+	the_terminal->reverse_ = false;
+	Terminal_UpdateDrawColors(the_terminal);
+
+	the_terminal->cursor_x_ = 0;
+	the_terminal->cursor_y_ = 0;
+	the_terminal->saved_x_ = 0;
+	the_terminal->saved_y_ = 0;
+	the_terminal->scroll_top_ = 0;
+	the_terminal->scroll_bottom_ = the_terminal->height_ - 1;
+	the_terminal->state_ = TERMINAL_STATE_NORMAL;
+
+	Terminal_Erase(the_terminal, 0, 0, the_terminal->width_ - 1, the_terminal->height_ - 1);
+
+	return;
+
+error:
+	Sys_Destroy(&global_system);	// crash early, crash often
+	return;
+}
+
+
+
+
+// **** GETTERS *****
+
+
+//! @return	Returns the number of characters per second Terminal_Write() has processed so far, or 0 if too little time has been spent to tell
+uint32_t Terminal_GetCharsPerSecond(Terminal* the_terminal)
+{
+	if (the_terminal == NULL)
+	{
+		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
+		goto error;
+	}
+
+	if (the_terminal->ticks_ == 0)
+	{
+		return 0;
+	}
+
+	// LOGIC: avoid overflowing 32 bits on very long runs, at the cost of a little precision
+	if (the_terminal->chars_written_ < 0xFFFFFFFF / SYS_TICKS_PER_SEC)
+	{
+		return (the_terminal->chars_written_ * SYS_TICKS_PER_SEC) / the_terminal->ticks_;
+	}
+
+	return (the_terminal->chars_written_ / the_terminal->ticks_) * SYS_TICKS_PER_SEC;
+
+error:
+	Sys_Destroy(&global_system);	// crash early, crash often
+	return 0;
+}
+
+
+
+
+// **** OTHER FUNCTIONS *****
+
+
+//! Process a chunk of a stream of text and ANSI escape sequences, drawing it to the screen
+//! Escape sequences may be split across calls. '\n' moves to the start of the next line, as Unix programs expect.
+//! Supported: CR, LF, VT, FF, BS, TAB; ESC 7, 8, D, E, M, c; CSI A-H, J, K, L, M, S, T, X, d, f, m, r, s, u
+//! @param	the_data: the bytes to process. does not need to be null-terminated.
+//! @param	the_len: the number of bytes to process
+void Terminal_Write(Terminal* the_terminal, const char* the_data, uint32_t the_len)
+{
+	const unsigned char*	the_byte = (const unsigned char*)the_data;
+	const unsigned char*	the_end = the_byte + the_len;
+	int16_t					run_len;
+	int16_t					max_run_len;
+	uint32_t				start_ticks;
+
+	if (the_terminal == NULL)
+	{
+		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
+		goto error;
+	}
+
+	start_ticks = sys_time_jiffies();
+
+	// LOGIC:
+	//   the bulk of a typical stream is plain text, so collect as many printable characters as fit on the rest of the row,
+	//   and draw them with one call, instead of handling them one at a time
+	while (the_byte < the_end)
+	{
+		if (the_terminal->state_ != TERMINAL_STATE_NORMAL || !Terminal_IsPrintable(*the_byte))
+		{
+			Terminal_ProcessByte(the_terminal, *the_byte++);
+			continue;
+		}
+
+		// deferred wrap: a character in the last column leaves the cursor past it, and the next character wraps
+		if (the_terminal->cursor_x_ >= the_terminal->width_)
+		{
+			the_terminal->cursor_x_ = 0;
+			Terminal_LineFeed(the_terminal);
+		}
+
+		max_run_len = the_terminal->width_ - the_terminal->cursor_x_;
+
+		if (max_run_len > the_end - the_byte)
+		{
+			max_run_len = the_end - the_byte;
+		}
+
+		run_len = 1;
+
+		while (run_len < max_run_len && Terminal_IsPrintable(the_byte[run_len]))
+		{
+			run_len++;
+		}
+
+		Text_DrawCharsAtXY(the_terminal->screen_, the_terminal->x1_ + the_terminal->cursor_x_, the_terminal->y1_ + the_terminal->cursor_y_, (char*)the_byte, run_len, the_terminal->draw_fore_, the_terminal->draw_back_);
+
+		the_terminal->cursor_x_ += run_len;
+		the_terminal->runs_drawn_++;
+		the_byte += run_len;
+	}
+
+	the_terminal->chars_written_ += the_len;
+	the_terminal->ticks_ += sys_time_jiffies() - start_ticks;
+
+	return;
+
+error:
+	Sys_Destroy(&global_system);	// crash early, crash often
+	return;
+}
+
+
+//! Process a null-terminated string. See Terminal_Write().
+void Terminal_WriteString(Terminal* the_terminal, const char* the_string)
+{
+	Terminal_Write(the_terminal, the_string, strlen(the_string));
+}
+
+
+
+
+// **** Debug functions *****
+
+void Terminal_Print(Terminal* the_terminal)
+{
+	DEBUG_OUT(("Terminal print out:"));
+	DEBUG_OUT(("  address: %p", 			the_terminal));
+	DEBUG_OUT(("  screen_: %p", 			the_terminal->screen_));
+	DEBUG_OUT(("  x1_, y1_: %i, %i", 		the_terminal->x1_, the_terminal->y1_));
+	DEBUG_OUT(("  x2_, y2_: %i, %i", 		the_terminal->x2_, the_terminal->y2_));
+	DEBUG_OUT(("  cursor_x_, cursor_y_: %i, %i", the_terminal->cursor_x_, the_terminal->cursor_y_));
+	DEBUG_OUT(("  scroll_top_, scroll_bottom_: %i, %i", the_terminal->scroll_top_, the_terminal->scroll_bottom_));
+	DEBUG_OUT(("  draw_fore_, draw_back_: %u, %u", the_terminal->draw_fore_, the_terminal->draw_back_));
+	DEBUG_OUT(("  state_: %i", 				the_terminal->state_));
+	DEBUG_OUT(("  chars_written_: %lu", 	the_terminal->chars_written_));
+	DEBUG_OUT(("  runs_drawn_: %lu", 		the_terminal->runs_drawn_));
+	DEBUG_OUT(("  escapes_: %lu", 			the_terminal->escapes_));
+	DEBUG_OUT(("  ticks_: %lu", 			the_terminal->ticks_));
+	DEBUG_OUT(("  chars per second: %lu", 	Terminal_GetCharsPerSecond(the_terminal)));
+}
@@ -0,0 +1,168 @@
+//! @file terminal.h
+
+/*
+ * terminal.h
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#ifndef TERMINAL_H_
+#define TERMINAL_H_
+
+
+
+/* about this class: Terminal
+ *
+ * An ANSI/VT100-style terminal that draws a stream of text and escape sequences into a rectangular area of a text screen
+ *
+ *** things this class needs to be able to do
+ * accept a byte stream in chunks of any size, with escape sequences split across chunks
+ * draw runs of printable characters as single row writes, wrapping at the right edge
+ * move the cursor (CR, LF, BS, TAB, and the CSI cursor movement and positioning sequences)
+ * map SGR colors (30-37, 40-47, 90-97, 100-107, bold, reverse) to the 16 text mode colors
+ * erase in line and erase in display
+ * scroll a scroll region up and down, and insert/delete lines in it
+ * measure how many characters per second it can process
+ *
+ *** things objects of this class have
+ * a screen, and a rectangle on that screen
+ * a cursor position, current colors, and a scroll region
+ * the state of the escape sequence parser
+ *
+ */
+
+
+/*****************************************************************************/
+/*                                Includes                                   */
+/*****************************************************************************/
+
+// project includes
+
+// C includes
+#include <stdbool.h>
+
+// A2560 includes
+#include "a2560_platform.h"
+
+
+/*****************************************************************************/
+/*                            Macro Definitions                              */
+/*****************************************************************************/
+
+#define TERMINAL_MAX_PARAMS			8	// CSI parameters beyond this many are ignored
+#define TERMINAL_MAX_PARAM_VALUE	9999
+#define TERMINAL_TAB_WIDTH			8	// tab characters advance to the next multiple of this many columns
+
+#define CH_ESC						(unsigned char)0x1B	// escape: starts an escape sequence
+
+
+/*****************************************************************************/
+/*                               Enumerations                                */
+/*****************************************************************************/
+
+typedef enum terminal_parse_state
+{
+	TERMINAL_STATE_NORMAL	= 0,	//! drawing characters
+	TERMINAL_STATE_ESCAPE	= 1,	//! got ESC
+	TERMINAL_STATE_CSI		= 2,	//! got ESC [, collecting parameters until a final byte
+	TERMINAL_STATE_CHARSET	= 3,	//! got ESC ( or ESC ), skipping the character set designator
+} terminal_parse_state;
+
+
+/*****************************************************************************/
+/*                                 Structs                                   */
+/*****************************************************************************/
+
+struct Terminal
+{
+	Screen*					screen_;
+	int16_t					x1_;				// area of the screen the terminal is drawn in, in text columns and rows
+	int16_t					y1_;
+	int16_t					x2_;
+	int16_t					y2_;
+	int16_t					width_;
+	int16_t					height_;
+	int16_t					cursor_x_;			// cursor position, relative to x1_, y1_. cursor_x_ == width_ means the next printable character wraps first.
+	int16_t					cursor_y_;
+	int16_t					saved_x_;			// cursor position saved by ESC 7 or CSI s
+	int16_t					saved_y_;
+	int16_t					scroll_top_;		// scroll region, in rows relative to y1_. line feeds at scroll_bottom_ scroll the region up.
+	int16_t					scroll_bottom_;
+	uint8_t					default_fore_;		// colors used for SGR 0, 39, and 49
+	uint8_t					default_back_;
+	uint8_t					fore_color_;		// colors last set by SGR, before bold and reverse are applied
+	uint8_t					back_color_;
+	bool					bold_;
+	bool					reverse_;
+	uint8_t					draw_fore_;			// colors characters are actually drawn and erased with, with bold and reverse applied
+	uint8_t					draw_back_;
+	terminal_parse_state	state_;
+	bool					private_mode_;		// true if the current CSI sequence started with '<', '=', '>', or '?'
+	uint8_t					param_count_;
+	int16_t					params_[TERMINAL_MAX_PARAMS];
+	uint32_t				chars_written_;		// number of bytes passed to Terminal_Write()
+	uint32_t				runs_drawn_;		// number of row writes used to draw them
+	uint32_t				escapes_;			// number of escape sequences processed
+	uint32_t				ticks_;				// ticks spent in Terminal_Write()
+};
+
+
+/*****************************************************************************/
+/*                             Global Variables                              */
+/*****************************************************************************/
+
+
+/*****************************************************************************/
+/*                       Public Function Prototypes                          */
+/*****************************************************************************/
+
+// **** CONSTRUCTOR AND DESTRUCTOR *****
+
+// constructor
+//! Allocate a terminal for a rectangular area of a text screen, and clear the area
+//! @param	the_screen: valid pointer to the target screen to operate on
+//! @param	x1: the leftmost horizontal position, between 0 and the screen's text_cols_vis_ - 1
+//! @param	y1: the uppermost vertical position, between 0 and the screen's text_rows_vis_ - 1
+//! @param	x2: the rightmost horizontal position, between 0 and the screen's text_cols_vis_ - 1
+//! @param	y2: the lowermost vertical position, between 0 and the screen's text_rows_vis_ - 1
+//! @param	fore_color: Index to the default foreground color (0-15)
+//! @param	back_color: Index to the default background color (0-15)
+//! @return	Returns NULL on any error/invalid input, or if memory could not be allocated
+Terminal* Terminal_New(Screen* the_screen, int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint8_t fore_color, uint8_t back_color);
+
+// destructor
+// frees all allocated memory associated with the passed object, and the object itself
+void Terminal_Destroy(Terminal** the_terminal);
+
+
+// **** SETTERS *****
+
+//! Put the terminal back to its starting state: default colors, cursor at top left, full-height scroll region, and a cleared area
+void Terminal_Reset(Terminal* the_terminal);
+
+
+// **** GETTERS *****
+
+//! @return	Returns the number of characters per second Terminal_Write() has processed so far, or 0 if too little time has been spent to tell
+uint32_t Terminal_GetCharsPerSecond(Terminal* the_terminal);
+
+
+// **** OTHER FUNCTIONS *****
+
+//! Process a chunk of a stream of text and ANSI escape sequences, drawing it to the screen
+//! Escape sequences may be split across calls. '\n' moves to the start of the next line, as Unix programs expect.
+//! Supported: CR, LF, VT, FF, BS, TAB; ESC 7, 8, D, E, M, c; CSI A-H, J, K, L, M, S, T, X, d, f, m, r, s, u
+//! @param	the_data: the bytes to process. does not need to be null-terminated.
+//! @param	the_len: the number of bytes to process
+void Terminal_Write(Terminal* the_terminal, const char* the_data, uint32_t the_len);
+
+//! Process a null-terminated string. See Terminal_Write().
+void Terminal_WriteString(Terminal* the_terminal, const char* the_string);
+
+
+// **** Debug functions *****
+
+void Terminal_Print(Terminal* the_terminal);
+
+
+#endif /* TERMINAL_H_ */
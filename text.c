@@ -98,6 +98,66 @@ bool Text_FillMemoryBoxBoth(Screen* the_screen, int16_t x, int16_t y, int16_t wi
 //! @return	Returns false on any error/invalid input.
 bool Text_FillMemoryBox(Screen* the_screen, int16_t x, int16_t y, int16_t width, int16_t height, bool for_attr, uint8_t the_fill);
 
+//! Flag rows of the shadow buffer as needing to be compared with VRAM on the next Text_FlushShadow(). Does nothing if the screen has no shadow buffer.
+//! @param	the_screen: valid pointer to the target screen to operate on
+//! @param	y1: the first row that was written to
+//! @param	y2: the last row that was written to
+void Text_MarkRowsDirty(Screen* the_screen, int16_t y1, int16_t y2);
+
+//! Copy the span of one row of char or attr data that differs between the shadow buffer and the copy of what was last flushed, to VRAM
+//! @param	the_shadow_loc: start of the row in the shadow buffer
+//! @param	the_flushed_loc: start of the row in the copy of what was last flushed. Updated to match the shadow buffer.
+//! @param	the_vram_loc: start of the row in VRAM
+//! @param	the_len: number of bytes in the row
+//! @return	Returns the number of bytes written to VRAM
+int16_t Text_FlushShadowRow(char* the_shadow_loc, char* the_flushed_loc, char* the_vram_loc, int16_t the_len);
+
+//! Change a run of attribute bytes, 4 at a time where the run is long-aligned: either swap the fore and back nibbles, or keep the bits in keep_mask and add set_bits
+//! @param	the_attr_loc: the first attribute byte to change
+//! @param	the_len: number of attribute bytes to change
+//! @param	keep_mask: bits of each attribute byte to keep (0xF0 to keep the foreground, 0x0F to keep the background). Ignored if swap_nibbles is true.
+//! @param	set_bits: bits to add to each attribute byte after masking. Ignored if swap_nibbles is true.
+//! @param	swap_nibbles: true to swap foreground and background colors instead of masking
+void Text_UpdateAttrRun(char* the_attr_loc, int32_t the_len, uint8_t keep_mask, uint8_t set_bits, bool swap_nibbles);
+
+//! Change the attribute bytes of a box with Text_UpdateAttrRun(). Boxes that span whole rows of memory are done as one run.
+//! calling function must validate screen id, coords, before passing!
+//! @param	the_screen: valid pointer to the target screen to operate on
+//! @param	x1: the leftmost horizontal position, between 0 and the screen's text_cols_vis_ - 1
+//! @param	y1: the uppermost vertical position, between 0 and the screen's text_rows_vis_ - 1
+//! @param	x2: the rightmost horizontal position, between 0 and the screen's text_cols_vis_ - 1
+//! @param	y2: the lowermost vertical position, between 0 and the screen's text_rows_vis_ - 1
+//! @param	keep_mask: see Text_UpdateAttrRun()
+//! @param	set_bits: see Text_UpdateAttrRun()
+//! @param	swap_nibbles: see Text_UpdateAttrRun()
+void Text_UpdateAttrBox(Screen* the_screen, int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint8_t keep_mask, uint8_t set_bits, bool swap_nibbles);
+
+//! Draw a horizontal or vertical run of one char and/or attribute value. Horizontal runs are one memset each for chars and attrs.
+//! calling function must validate screen id, starting coords, attribute value before passing! The run is clipped to the visible screen here.
+//! @param	the_screen: valid pointer to the target screen to operate on
+//! @param	x: the starting horizontal position, between 0 and the screen's text_cols_vis_ - 1
+//! @param	y: the starting vertical position, between 0 and the screen's text_rows_vis_ - 1
+//! @param	the_len: number of cells in the run. Nothing is drawn if less than 1.
+//! @param	is_vertical: true to draw down from x, y, false to draw right from x, y
+//! @param	the_char: the character to be used when drawing
+//! @param	the_attribute_value: a 1-byte attribute code (foreground in high nibble, background in low nibble)
+//! @param	the_draw_choice: controls the scope of the action, and is one of CHAR_ONLY, ATTR_ONLY, or CHAR_AND_ATTR. See the text_draw_choice enum.
+void Text_DrawRun(Screen* the_screen, int16_t x, int16_t y, int16_t the_len, bool is_vertical, unsigned char the_char, uint8_t the_attribute_value, text_draw_choice the_draw_choice);
+
+//! Draw the outline of a box as 2 horizontal and 2 vertical runs, with optional corner pieces
+//! calling function must validate screen id, coords, attribute value, and that x1 <= x2 and y1 <= y2, before passing!
+//! @param	the_screen: valid pointer to the target screen to operate on
+//! @param	x1: the leftmost horizontal position, between 0 and the screen's text_cols_vis_ - 1
+//! @param	y1: the uppermost vertical position, between 0 and the screen's text_rows_vis_ - 1
+//! @param	x2: the rightmost horizontal position, between 0 and the screen's text_cols_vis_ - 1
+//! @param	y2: the lowermost vertical position, between 0 and the screen's text_rows_vis_ - 1
+//! @param	h_char: the character to be used for the top and bottom sides
+//! @param	v_char: the character to be used for the left and right sides
+//! @param	the_corners: NULL to draw the corners as part of the sides, or 4 chars for the upper left, upper right, lower right, and lower left corners
+//! @param	the_attribute_value: a 1-byte attribute code (foreground in high nibble, background in low nibble)
+//! @param	the_draw_choice: controls the scope of the action, and is one of CHAR_ONLY, ATTR_ONLY, or CHAR_AND_ATTR. See the text_draw_choice enum.
+void Text_DrawFrame(Screen* the_screen, int16_t x1, int16_t y1, int16_t x2, int16_t y2, unsigned char h_char, unsigned char v_char, const unsigned char* the_corners, uint8_t the_attribute_value, text_draw_choice the_draw_choice);
+
 //! \endcond
 
 
@@ -185,6 +245,8 @@ bool Text_FillMemory(Screen* the_screen, bool for_attr, uint8_t the_fill)
 	the_write_len = the_screen->text_mem_cols_ * the_screen->text_mem_rows_;
 	
 	memset(the_write_loc, the_fill, the_write_len);
+	
+	Text_MarkRowsDirty(the_screen, 0, the_screen->text_mem_rows_ - 1);
 
 	return true;
 }
@@ -211,6 +273,15 @@ bool Text_FillMemoryBoxBoth(Screen* the_screen, int16_t x, int16_t y, int16_t wi
 	
 	max_row = y + height;
 	
+	// LOGIC: if the box is as wide as text memory, its rows are back to back, and can be filled in one go
+	if (width == the_screen->text_mem_cols_)
+	{
+		memset(the_char_loc, the_char, (int32_t)width * (height + 1));
+		memset(the_attr_loc, the_attribute_value, (int32_t)width * (height + 1));
+		Text_MarkRowsDirty(the_screen, y, max_row);
+		return true;
+	}
+	
 	for (; y <= max_row; y++)
 	{
 		memset(the_char_loc, the_char, width);
@@ -218,6 +289,8 @@ bool Text_FillMemoryBoxBoth(Screen* the_screen, int16_t x, int16_t y, int16_t wi
 		the_char_loc += the_screen->text_mem_cols_;
 		the_attr_loc += the_screen->text_mem_cols_;
 	}
+	
+	Text_MarkRowsDirty(the_screen, max_row - height, max_row);
 			
 	return true;
 }
@@ -243,15 +316,375 @@ bool Text_FillMemoryBox(Screen* the_screen, int16_t x, int16_t y, int16_t width,
 	
 	max_row = y + height;
 	
+	// LOGIC: if the box is as wide as text memory, its rows are back to back, and can be filled in one go
+	if (width == the_screen->text_mem_cols_)
+	{
+		memset(the_write_loc, the_fill, (int32_t)width * (height + 1));
+		Text_MarkRowsDirty(the_screen, y, max_row);
+		return true;
+	}
+	
 	for (; y <= max_row; y++)
 	{
 		memset(the_write_loc, the_fill, width);
 		the_write_loc += the_screen->text_mem_cols_;
 	}
+	
+	Text_MarkRowsDirty(the_screen, max_row - height, max_row);
 			
 	return true;
 }
 
+
+//! Flag rows of the shadow buffer as needing to be compared with VRAM on the next Text_FlushShadow(). Does nothing if the screen has no shadow buffer.
+//! @param	the_screen: valid pointer to the target screen to operate on
+//! @param	y1: the first row that was written to
+//! @param	y2: the last row that was written to
+void Text_MarkRowsDirty(Screen* the_screen, int16_t y1, int16_t y2)
+{
+	if (the_screen->text_shadow_ == NULL)
+	{
+		return;
+	}
+	
+	// LOGIC:
+	//   the dirty map has exactly one flag per row of text_mem_rows_, so both ends are clamped to it
+	
+	if (y1 < 0)
+	{
+		y1 = 0;
+	}
+	
+	if (y2 >= the_screen->text_mem_rows_)
+	{
+		y2 = the_screen->text_mem_rows_ - 1;
+	}
+	
+	if (y1 > y2)
+	{
+		return;
+	}
+	
+	memset(&the_screen->text_dirty_[y1], 1, y2 - y1 + 1);
+}
+
+
+//! Copy the span of one row of char or attr data that differs between the shadow buffer and the copy of what was last flushed, to VRAM
+//! @param	the_shadow_loc: start of the row in the shadow buffer
+//! @param	the_flushed_loc: start of the row in the copy of what was last flushed. Updated to match the shadow buffer.
+//! @param	the_vram_loc: start of the row in VRAM
+//! @param	the_len: number of bytes in the row
+//! @return	Returns the number of bytes written to VRAM
+int16_t Text_FlushShadowRow(char* the_shadow_loc, char* the_flushed_loc, char* the_vram_loc, int16_t the_len)
+{
+	int16_t		first;
+	int16_t		last;
+	int16_t		i;
+	
+	// LOGIC:
+	//   VRAM is much slower to access than regular RAM, so we never read it here: we compare the shadow buffer with our own copy of what was flushed.
+	//   only the span from the first to the last difference is written. 
+	//   rows are long-aligned in every VICKY text mode, so compare and write 4 bytes at a time. fall back to bytes if not.
+	
+	if ((((unsigned long)the_shadow_loc | (unsigned long)the_flushed_loc | (unsigned long)the_vram_loc | (unsigned long)the_len) & 0x03) == 0)
+	{
+		uint32_t*	the_shadow_long = (uint32_t*)the_shadow_loc;
+		uint32_t*	the_flushed_long = (uint32_t*)the_flushed_loc;
+		uint32_t*	the_vram_long = (uint32_t*)the_vram_loc;
+		int16_t		num_longs = the_len >> 2;
+		
+		for (first = 0; first < num_longs && the_shadow_long[first] == the_flushed_long[first]; first++);
+		
+		if (first == num_longs)
+		{
+			return 0;
+		}
+		
+		for (last = num_longs - 1; the_shadow_long[last] == the_flushed_long[last]; last--);
+		
+		for (i = first; i <= last; i++)
+		{
+			the_flushed_long[i] = the_shadow_long[i];
+			the_vram_long[i] = the_shadow_long[i];
+		}
+		
+		return (last - first + 1) << 2;
+	}
+	
+	for (first = 0; first < the_len && the_shadow_loc[first] == the_flushed_loc[first]; first++);
+	
+	if (first == the_len)
+	{
+		return 0;
+	}
+	
+	for (last = the_len - 1; the_shadow_loc[last] == the_flushed_loc[last]; last--);
+	
+	memcpy(&the_flushed_loc[first], &the_shadow_loc[first], last - first + 1);
+	memcpy(&the_vram_loc[first], &the_shadow_loc[first], last - first + 1);
+	
+	return last - first + 1;
+}
+
+
+//! Change a run of attribute bytes, 4 at a time where the run is long-aligned: either swap the fore and back nibbles, or keep the bits in keep_mask and add set_bits
+//! @param	the_attr_loc: the first attribute byte to change
+//! @param	the_len: number of attribute bytes to change
+//! @param	keep_mask: bits of each attribute byte to keep (0xF0 to keep the foreground, 0x0F to keep the background). Ignored if swap_nibbles is true.
+//! @param	set_bits: bits to add to each attribute byte after masking. Ignored if swap_nibbles is true.
+//! @param	swap_nibbles: true to swap foreground and background colors instead of masking
+void Text_UpdateAttrRun(char* the_attr_loc, int32_t the_len, uint8_t keep_mask, uint8_t set_bits, bool swap_nibbles)
+{
+	uint8_t*	the_byte_loc = (uint8_t*)the_attr_loc;
+	uint32_t*	the_long_loc;
+	uint32_t	keep_long;
+	uint32_t	set_long;
+	uint32_t	the_long;
+	
+	// LOGIC:
+	//   text mode only supports 16 colors. lower 4 bits are back, upper 4 bits are foreground
+	//   the same masks and shifts work on 4 attribute bytes at once, as long as the nibbles are kept from crossing byte boundaries.
+	//   do single bytes until long-aligned, then longs, then any bytes left over.
+	
+	while (the_len > 0 && ((unsigned long)the_byte_loc & 0x03) != 0)
+	{
+		if (swap_nibbles)
+		{
+			*the_byte_loc = (uint8_t)((*the_byte_loc << 4) | (*the_byte_loc >> 4));
+		}
+		else
+		{
+			*the_byte_loc = (*the_byte_loc & keep_mask) | set_bits;
+		}
+		
+		the_byte_loc++;
+		the_len--;
+	}
+	
+	the_long_loc = (uint32_t*)the_byte_loc;
+	
+	if (swap_nibbles)
+	{
+		for (; the_len >= 4; the_len -= 4)
+		{
+			the_long = *the_long_loc;
+			*the_long_loc++ = ((the_long & 0x0F0F0F0FUL) << 4) | ((the_long >> 4) & 0x0F0F0F0FUL);
+		}
+	}
+	else
+	{
+		keep_long = keep_mask * 0x01010101UL;
+		set_long = set_bits * 0x01010101UL;
+		
+		for (; the_len >= 4; the_len -= 4)
+		{
+			*the_long_loc = (*the_long_loc & keep_long) | set_long;
+			the_long_loc++;
+		}
+	}
+	
+	the_byte_loc = (uint8_t*)the_long_loc;
+	
+	while (the_len > 0)
+	{
+		if (swap_nibbles)
+		{
+			*the_byte_loc = (uint8_t)((*the_byte_loc << 4) | (*the_byte_loc >> 4));
+		}
+		else
+		{
+			*the_byte_loc = (*the_byte_loc & keep_mask) | set_bits;
+		}
+		
+		the_byte_loc++;
+		the_len--;
+	}
+}
+
+
+//! Change the attribute bytes of a box with Text_UpdateAttrRun(). Boxes that span whole rows of memory are done as one run.
+//! calling function must validate screen id, coords, before passing!
+//! @param	the_screen: valid pointer to the target screen to operate on
+//! @param	x1: the leftmost horizontal position, between 0 and the screen's text_cols_vis_ - 1
+//! @param	y1: the uppermost vertical position, between 0 and the screen's text_rows_vis_ - 1
+//! @param	x2: the rightmost horizontal position, between 0 and the screen's text_cols_vis_ - 1
+//! @param	y2: the lowermost vertical position, between 0 and the screen's text_rows_vis_ - 1
+//! @param	keep_mask: see Text_UpdateAttrRun()
+//! @param	set_bits: see Text_UpdateAttrRun()
+//! @param	swap_nibbles: see Text_UpdateAttrRun()
+void Text_UpdateAttrBox(Screen* the_screen, int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint8_t keep_mask, uint8_t set_bits, bool swap_nibbles)
+{
+	char*			the_write_loc;
+	int16_t			the_row_len;
+	
+	the_write_loc = Text_GetMemLocForXY(the_screen, x1, y1, SCREEN_FOR_TEXT_ATTR);
+	the_row_len = x2 - x1 + 1;
+
+	Text_MarkRowsDirty(the_screen, y1, y2);
+	
+	// LOGIC: if the box is as wide as text memory, its rows are back to back, and it can be done in one go
+	if (the_row_len == the_screen->text_mem_cols_)
+	{
+		Text_UpdateAttrRun(the_write_loc, (int32_t)the_row_len * (y2 - y1 + 1), keep_mask, set_bits, swap_nibbles);
+		return;
+	}
+	
+	for (; y1 <= y2; y1++)
+	{
+		Text_UpdateAttrRun(the_write_loc, the_row_len, keep_mask, set_bits, swap_nibbles);
+		the_write_loc += the_screen->text_mem_cols_;
+	}
+}
+
+
+//! Draw a horizontal or vertical run of one char and/or attribute value. Horizontal runs are one memset each for chars and attrs.
+//! calling function must validate screen id, starting coords, attribute value before passing! The run is clipped to the visible screen here.
+//! @param	the_screen: valid pointer to the target screen to operate on
+//! @param	x: the starting horizontal position, between 0 and the screen's text_cols_vis_ - 1
+//! @param	y: the starting vertical position, between 0 and the screen's text_rows_vis_ - 1
+//! @param	the_len: number of cells in the run. Nothing is drawn if less than 1.
+//! @param	is_vertical: true to draw down from x, y, false to draw right from x, y
+//! @param	the_char: the character to be used when drawing
+//! @param	the_attribute_value: a 1-byte attribute code (foreground in high nibble, background in low nibble)
+//! @param	the_draw_choice: controls the scope of the action, and is one of CHAR_ONLY, ATTR_ONLY, or CHAR_AND_ATTR. See the text_draw_choice enum.
+void Text_DrawRun(Screen* the_screen, int16_t x, int16_t y, int16_t the_len, bool is_vertical, unsigned char the_char, uint8_t the_attribute_value, text_draw_choice the_draw_choice)
+{
+	char*			the_char_loc;
+	char*			the_attr_loc;
+	int16_t			the_max_len;
+	int16_t			the_stride;
+	int16_t			i;
+	
+	// LOGIC: clip once here, so the loops below don't need to check anything per cell
+	if (is_vertical)
+	{
+		the_max_len = the_screen->text_rows_vis_ - y;
+	}
+	else
+	{
+		the_max_len = the_screen->text_cols_vis_ - x;
+	}
+	
+	if (the_len > the_max_len)
+	{
+		the_len = the_max_len;
+	}
+	
+	if (the_len < 1)
+	{
+		return;
+	}
+	
+	the_char_loc = Text_GetMemLocForXY(the_screen, x, y, SCREEN_FOR_TEXT_CHAR);
+	the_attr_loc = the_char_loc + (the_screen->text_attr_ram_ - the_screen->text_ram_);
+
+	if (!is_vertical)
+	{
+		if (the_draw_choice != ATTR_ONLY)
+		{
+			memset(the_char_loc, the_char, the_len);
+		}
+		
+		if (the_draw_choice != CHAR_ONLY)
+		{
+			memset(the_attr_loc, the_attribute_value, the_len);
+		}
+		
+		Text_MarkRowsDirty(the_screen, y, y);
+		return;
+	}
+	
+	// LOGIC: a vertical run is one byte per row, so step down a row at a time. choose the loop once, not per cell.
+	the_stride = the_screen->text_mem_cols_;
+	
+	switch (the_draw_choice)
+	{
+		case CHAR_ONLY:
+			for (i = 0; i < the_len; i++)
+			{
+				*the_char_loc = the_char;
+				the_char_loc += the_stride;
+			}
+			break;
+			
+		case ATTR_ONLY:
+			for (i = 0; i < the_len; i++)
+			{
+				*the_attr_loc = the_attribute_value;
+				the_attr_loc += the_stride;
+			}
+			break;
+			
+		case CHAR_AND_ATTR:
+		default:
+			for (i = 0; i < the_len; i++)
+			{
+				*the_char_loc = the_char;
+				*the_attr_loc = the_attribute_value;
+				the_char_loc += the_stride;
+				the_attr_loc += the_stride;
+			}
+			break;			
+	}
+	
+	Text_MarkRowsDirty(the_screen, y, y + the_len - 1);
+}
+
+
+//! Draw the outline of a box as 2 horizontal and 2 vertical runs, with optional corner pieces
+//! calling function must validate screen id, coords, attribute value, and that x1 <= x2 and y1 <= y2, before passing!
+//! @param	the_screen: valid pointer to the target screen to operate on
+//! @param	x1: the leftmost horizontal position, between 0 and the screen's text_cols_vis_ - 1
+//! @param	y1: the uppermost vertical position, between 0 and the screen's text_rows_vis_ - 1
+//! @param	x2: the rightmost horizontal position, between 0 and the screen's text_cols_vis_ - 1
+//! @param	y2: the lowermost vertical position, between 0 and the screen's text_rows_vis_ - 1
+//! @param	h_char: the character to be used for the top and bottom sides
+//! @param	v_char: the character to be used for the left and right sides
+//! @param	the_corners: NULL to draw the corners as part of the sides, or 4 chars for the upper left, upper right, lower right, and lower left corners
+//! @param	the_attribute_value: a 1-byte attribute code (foreground in high nibble, background in low nibble)
+//! @param	the_draw_choice: controls the scope of the action, and is one of CHAR_ONLY, ATTR_ONLY, or CHAR_AND_ATTR. See the text_draw_choice enum.
+void Text_DrawFrame(Screen* the_screen, int16_t x1, int16_t y1, int16_t x2, int16_t y2, unsigned char h_char, unsigned char v_char, const unsigned char* the_corners, uint8_t the_attribute_value, text_draw_choice the_draw_choice)
+{
+	int16_t			the_width;
+	int16_t			the_side_len;
+	char*			the_char_loc;
+	
+	the_width = x2 - x1 + 1;
+	the_side_len = y2 - y1 - 1;
+	
+	// LOGIC: 
+	//   top and bottom rows are full width, so the sides only need the rows between them. no cell is written twice.
+	//   a box 1 row tall is just the top row.
+	Text_DrawRun(the_screen, x1, y1, the_width, false, h_char, the_attribute_value, the_draw_choice);
+	
+	if (y2 > y1)
+	{
+		Text_DrawRun(the_screen, x1, y2, the_width, false, h_char, the_attribute_value, the_draw_choice);
+	}
+	
+	Text_DrawRun(the_screen, x1, y1 + 1, the_side_len, true, v_char, the_attribute_value, the_draw_choice);
+	
+	if (x2 > x1)
+	{
+		Text_DrawRun(the_screen, x2, y1 + 1, the_side_len, true, v_char, the_attribute_value, the_draw_choice);
+	}
+	
+	if (the_corners == NULL || the_draw_choice == ATTR_ONLY)
+	{
+		return;
+	}
+	
+	// corner attributes were already set with the sides. same order as always, so degenerate boxes end up with the same corner pieces.
+	the_char_loc = Text_GetMemLocForXY(the_screen, x1, y1, SCREEN_FOR_TEXT_CHAR);
+	*the_char_loc = the_corners[0];
+	the_char_loc += (x2 - x1);
+	*the_char_loc = the_corners[1];
+	the_char_loc += (int32_t)(y2 - y1) * the_screen->text_mem_cols_;
+	*the_char_loc = the_corners[2];
+	the_char_loc -= (x2 - x1);
+	*the_char_loc = the_corners[3];
+}
+
 //! \endcond
 
 
@@ -261,6 +694,136 @@ bool Text_FillMemoryBox(Screen* the_screen, int16_t x, int16_t y, int16_t width,
 /*****************************************************************************/
 
 // ** NOTE: there is no destructor or constructor for this library, as it does not track any allocated memory. It works on the basis of a screen ID, which corresponds to the text memory for Vicky's Channel A and Channel B video memory.
+// ** the one exception is the optional shadow buffer: see Text_EnableShadow() and Text_DisableShadow()
+
+
+// **** Shadow buffer functions ****
+
+//! Start drawing text to a shadow buffer in regular RAM, instead of directly to VRAM
+//! All other Text functions work unchanged, but nothing they draw reaches the screen until Text_FlushShadow() is called.
+//! The shadow buffer starts out as a copy of what is currently on screen. 
+//! Changing video mode disables the shadow buffer. Call this again afterwards to use one in the new mode.
+//! @param	the_screen: valid pointer to the target screen to operate on
+//! @return	Returns false on any error/invalid input, or if the memory could not be allocated
+bool Text_EnableShadow(Screen* the_screen)
+{
+	unsigned long	the_size;
+	
+	if (the_screen == NULL)
+	{
+		LOG_ERR(("%s %d: passed screen was NULL", __func__, __LINE__));
+		return false;
+	}
+	
+	if (the_screen->text_shadow_ != NULL)
+	{
+		return true;
+	}
+	
+	// LOGIC:
+	//   one allocation, 4 planes the size of VRAM: shadow chars, shadow attrs, flushed chars, flushed attrs, then one dirty flag per row.
+	//   the flushed planes are what we know VRAM to hold, so the flush can find changes without ever reading VRAM back.
+	//   the dirty map is sized from text_mem_rows_ of the current mode, which can be more rows than are visible.
+	//   text_ram_ and text_attr_ram_ are switched to the shadow planes, which is what redirects every other Text function.
+	the_size = the_screen->text_mem_cols_ * the_screen->text_mem_rows_;
+	
+	if ( (the_screen->text_shadow_ = (char*)calloc(1, 4 * the_size + the_screen->text_mem_rows_)) == NULL)
+	{
+		LOG_ERR(("%s %d: could not allocate memory for a shadow text buffer", __func__, __LINE__));
+		return false;
+	}
+	LOG_ALLOC(("%s %d:	__ALLOC__	the_screen->text_shadow_	%p	size	%lu", __func__ , __LINE__, the_screen->text_shadow_, 4 * the_size + the_screen->text_mem_rows_));
+
+	memcpy(the_screen->text_shadow_, the_screen->text_ram_, the_size);
+	memcpy(the_screen->text_shadow_ + the_size, the_screen->text_attr_ram_, the_size);
+	memcpy(the_screen->text_shadow_ + (2 * the_size), the_screen->text_shadow_, 2 * the_size);
+	the_screen->text_dirty_ = (uint8_t*)the_screen->text_shadow_ + (4 * the_size);
+	
+	the_screen->text_vram_ = the_screen->text_ram_;
+	the_screen->text_attr_vram_ = the_screen->text_attr_ram_;
+	the_screen->text_ram_ = the_screen->text_shadow_;
+	the_screen->text_attr_ram_ = the_screen->text_shadow_ + the_size;
+	
+	return true;
+}
+
+
+//! Flush the shadow buffer to the screen, free it, and go back to drawing text directly to VRAM
+//! @param	the_screen: valid pointer to the target screen to operate on
+//! @return	Returns false on any error/invalid input. Returns true if the screen had no shadow buffer.
+bool Text_DisableShadow(Screen* the_screen)
+{
+	if (the_screen == NULL)
+	{
+		LOG_ERR(("%s %d: passed screen was NULL", __func__, __LINE__));
+		return false;
+	}
+	
+	if (the_screen->text_shadow_ == NULL)
+	{
+		return true;
+	}
+	
+	Text_FlushShadow(the_screen);
+	
+	the_screen->text_ram_ = the_screen->text_vram_;
+	the_screen->text_attr_ram_ = the_screen->text_attr_vram_;
+	the_screen->text_vram_ = NULL;
+	the_screen->text_attr_vram_ = NULL;
+
+	LOG_ALLOC(("%s %d:	__FREE__	the_screen->text_shadow_	%p	size	%lu", __func__ , __LINE__, the_screen->text_shadow_, 4 * (unsigned long)the_screen->text_mem_cols_ * the_screen->text_mem_rows_ + the_screen->text_mem_rows_));
+	free(the_screen->text_shadow_);
+	the_screen->text_shadow_ = NULL;
+	the_screen->text_dirty_ = NULL;
+	
+	return true;
+}
+
+
+//! Copy what has changed in the shadow buffer since the last flush to VRAM
+//! Only rows that were drawn to are examined, and in each of those, only the span of columns that actually differs from what is on screen is written.
+//! Redrawing a screen with the same content therefore writes nothing to VRAM.
+//! @param	the_screen: valid pointer to the target screen to operate on
+//! @return	Returns the number of bytes written to VRAM. Returns 0 if the screen has no shadow buffer, or on any error/invalid input.
+uint32_t Text_FlushShadow(Screen* the_screen)
+{
+	char*			the_flushed_char_ram;
+	char*			the_flushed_attr_ram;
+	uint32_t		bytes_written = 0;
+	unsigned long	the_offset;
+	int16_t			y;
+	
+	if (the_screen == NULL)
+	{
+		LOG_ERR(("%s %d: passed screen was NULL", __func__, __LINE__));
+		return 0;
+	}
+	
+	if (the_screen->text_shadow_ == NULL)
+	{
+		return 0;
+	}
+	
+	// the flushed planes follow the shadow char and attr planes (see Text_EnableShadow())
+	the_offset = the_screen->text_mem_cols_ * the_screen->text_mem_rows_;
+	the_flushed_char_ram = the_screen->text_shadow_ + (2 * the_offset);
+	the_flushed_attr_ram = the_screen->text_shadow_ + (3 * the_offset);
+	
+	for (y = 0; y < the_screen->text_mem_rows_; y++)
+	{
+		if (the_screen->text_dirty_[y])
+		{
+			the_offset = the_screen->text_mem_cols_ * y;
+			
+			bytes_written += Text_FlushShadowRow(the_screen->text_ram_ + the_offset, the_flushed_char_ram + the_offset, the_screen->text_vram_ + the_offset, the_screen->text_mem_cols_);
+			bytes_written += Text_FlushShadowRow(the_screen->text_attr_ram_ + the_offset, the_flushed_attr_ram + the_offset, the_screen->text_attr_vram_ + the_offset, the_screen->text_mem_cols_);
+			the_screen->text_dirty_[y] = 0;
+		}
+	}
+	
+	return bytes_written;
+}
+
 
 
 // **** Block copy functions ****
@@ -284,6 +847,8 @@ bool Text_CopyAttrMemToScreen(Screen* the_screen, char* the_source_buffer)
 	the_write_len = the_screen->text_cols_vis_ * the_screen->text_rows_vis_;
 	
 	memcpy(the_vram_loc, the_source_buffer, the_write_len);
+	
+	Text_MarkRowsDirty(the_screen, 0, the_screen->text_mem_rows_ - 1);
 
 	return true;
 }
@@ -330,6 +895,8 @@ bool Text_CopyCharMemToScreen(Screen* the_screen, char* the_source_buffer)
 	the_write_len = the_screen->text_cols_vis_ * the_screen->text_rows_vis_;
 	
 	memcpy(the_vram_loc, the_source_buffer, the_write_len);
+	
+	Text_MarkRowsDirty(the_screen, 0, the_screen->text_mem_rows_ - 1);
 
 	return true;
 }
@@ -396,6 +963,7 @@ bool Text_CopyScreen(Screen* the_screen, char* the_buffer, bool to_screen, bool
 	if (to_screen)
 	{
 		memcpy(the_vram_loc, the_buffer, the_write_len);
+		Text_MarkRowsDirty(the_screen, 0, the_screen->text_mem_rows_ - 1);
 	}
 	else
 	{
@@ -467,6 +1035,11 @@ bool Text_CopyMemBox(Screen* the_screen, char* the_buffer, int16_t x1, int16_t y
 
 //DEBUG_OUT(("%s %d: vramloc=%p, buffer=%p, bufferloc=%p, to_screen=%i, the_write_len=%i", the_vram_loc, the_buffer, the_buffer_loc, to_screen, the_write_len));
 
+	if (to_screen)
+	{
+		Text_MarkRowsDirty(the_screen, y1, y2);
+	}
+	
 	for (; y1 <= y2; y1++)
 	{
 		if (to_screen)
@@ -487,6 +1060,125 @@ bool Text_CopyMemBox(Screen* the_screen, char* the_buffer, int16_t x1, int16_t y
 
 
 
+//! Scroll the characters and attributes in a rectangular area of the screen up or down, and clear the rows left behind
+//! Whole rows are moved as blocks, so this is much faster than redrawing the area.
+//! @param	the_screen: valid pointer to the target screen to operate on
+//! @param	x1: the leftmost horizontal position, between 0 and the screen's text_cols_vis_ - 1
+//! @param	y1: the uppermost vertical position, between 0 and the screen's text_rows_vis_ - 1
+//! @param	x2: the rightmost horizontal position, between 0 and the screen's text_cols_vis_ - 1
+//! @param	y2: the lowermost vertical position, between 0 and the screen's text_rows_vis_ - 1
+//! @param	num_rows: number of rows to scroll by. Positive numbers scroll the contents up, negative numbers scroll them down. If this is the height of the area or more, the area is just cleared.
+//! @param	fore_color: Index to the foreground color (0-15) for the cleared rows. The predefined macro constants may be used (COLOR_DK_RED, etc.), but be aware that the colors are not fixed, and may not correspond to the names if the LUT in RAM has been modified.
+//! @param	back_color: Index to the background color (0-15) for the cleared rows. The predefined macro constants may be used (COLOR_DK_RED, etc.), but be aware that the colors are not fixed, and may not correspond to the names if the LUT in RAM has been modified.
+//! @return	Returns false on any error/invalid input.
+bool Text_ScrollBox(Screen* the_screen, int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t num_rows, uint8_t fore_color, uint8_t back_color)
+{
+	char*			the_char_loc;
+	char*			the_attr_loc;
+	int16_t			the_width;
+	int16_t			the_height;
+	int16_t			the_row;
+	int16_t			rows_to_move;
+	int16_t			clear_y;
+	long			the_distance;
+	uint8_t			the_attribute_value;
+	
+	if (!Text_ValidateAll(the_screen, x1, y1, fore_color, back_color))
+	{
+		LOG_ERR(("%s %d: illegal coordinate (%i, %i) or color", __func__, __LINE__, x1, y1));
+		return false;
+	}
+	
+	if (!Text_ValidateXY(the_screen, x2, y2))
+	{
+		LOG_ERR(("%s %d: illegal coordinate (%i, %i)", __func__, __LINE__, x2, y2));
+		return false;
+	}
+
+	if (x1 > x2 || y1 > y2)
+	{
+		LOG_ERR(("%s %d: illegal coordinates", __func__, __LINE__));
+		return false;
+	}
+	
+	if (num_rows == 0)
+	{
+		return true;
+	}
+	
+	the_width = x2 - x1 + 1;
+	the_height = y2 - y1 + 1;
+	
+	// LOGIC: text mode only supports 16 colors. lower 4 bits are back, upper 4 bits are foreground
+	the_attribute_value = ((fore_color << 4) | back_color);
+
+	if (num_rows >= the_height || -num_rows >= the_height)
+	{
+		return Text_FillMemoryBoxBoth(the_screen, x1, y1, the_width, the_height - 1, ' ', the_attribute_value);
+	}
+	
+	// LOGIC:
+	//   if the area is full rows of VRAM, all the rows that survive are one contiguous block, and can be moved with one memmove per plane.
+	//   otherwise, move one row at a time. when scrolling up, work from the top down, and when scrolling down, from the bottom up, so no row is overwritten before it is moved.
+	
+	if (num_rows > 0)
+	{
+		rows_to_move = the_height - num_rows;
+		clear_y = y2 - num_rows + 1;
+		the_char_loc = Text_GetMemLocForXY(the_screen, x1, y1, SCREEN_FOR_TEXT_CHAR);
+		the_distance = (long)the_screen->text_mem_cols_ * num_rows;
+	}
+	else
+	{
+		rows_to_move = the_height + num_rows;
+		clear_y = y1;
+		the_char_loc = Text_GetMemLocForXY(the_screen, x1, y1 - num_rows, SCREEN_FOR_TEXT_CHAR);
+		the_distance = (long)the_screen->text_mem_cols_ * num_rows;
+	}
+
+	the_attr_loc = the_char_loc + (the_screen->text_attr_ram_ - the_screen->text_ram_);
+	
+	if (the_width == the_screen->text_mem_cols_)
+	{
+		memmove(the_char_loc, the_char_loc + the_distance, (long)the_screen->text_mem_cols_ * rows_to_move);
+		memmove(the_attr_loc, the_attr_loc + the_distance, (long)the_screen->text_mem_cols_ * rows_to_move);
+	}
+	else if (num_rows > 0)
+	{
+		for (the_row = 0; the_row < rows_to_move; the_row++)
+		{
+			memcpy(the_char_loc, the_char_loc + the_distance, the_width);
+			memcpy(the_attr_loc, the_attr_loc + the_distance, the_width);
+			the_char_loc += the_screen->text_mem_cols_;
+			the_attr_loc += the_screen->text_mem_cols_;
+		}
+	}
+	else
+	{
+		the_char_loc += (long)the_screen->text_mem_cols_ * (rows_to_move - 1);
+		the_attr_loc += (long)the_screen->text_mem_cols_ * (rows_to_move - 1);
+		
+		for (the_row = 0; the_row < rows_to_move; the_row++)
+		{
+			memcpy(the_char_loc, the_char_loc + the_distance, the_width);
+			memcpy(the_attr_loc, the_attr_loc + the_distance, the_width);
+			the_char_loc -= the_screen->text_mem_cols_;
+			the_attr_loc -= the_screen->text_mem_cols_;
+		}
+	}
+	
+	Text_MarkRowsDirty(the_screen, y1, y2);
+	
+	// clear the rows the contents moved away from
+	if (num_rows < 0)
+	{
+		num_rows = -num_rows;
+	}
+	
+	return Text_FillMemoryBoxBoth(the_screen, x1, clear_y, the_width, num_rows - 1, ' ', the_attribute_value);
+}
+
+
 // **** Block fill functions ****
 
 
@@ -560,8 +1252,7 @@ bool Text_FillCharMem(Screen* the_screen, unsigned char the_fill)
 }
 
 
-//! Fill a box-shaped section of character and/or attribute memory
-//! This version uses char-by-char functions, so it is very slow. It will be removed before release. 
+//! Fill character and attribute memory for a specific box area
 //! @param	the_screen: valid pointer to the target screen to operate on
 //! @param	x1: the leftmost horizontal position, between 0 and the screen's text_cols_vis_ - 1
 //! @param	y1: the uppermost vertical position, between 0 and the screen's text_rows_vis_ - 1
@@ -570,11 +1261,12 @@ bool Text_FillCharMem(Screen* the_screen, unsigned char the_fill)
 //! @param	the_char: the character to be used for the fill operation
 //! @param	fore_color: Index to the desired foreground color (0-15). The predefined macro constants may be used (COLOR_DK_RED, etc.), but be aware that the colors are not fixed, and may not correspond to the names if the LUT in RAM has been modified.
 //! @param	back_color: Index to the desired background color (0-15). The predefined macro constants may be used (COLOR_DK_RED, etc.), but be aware that the colors are not fixed, and may not correspond to the names if the LUT in RAM has been modified.
-//! @param	the_draw_choice: controls the scope of the action, and is one of CHAR_ONLY, ATTR_ONLY, or CHAR_AND_ATTR. See the text_draw_choice enum.
 //! @return	Returns false on any error/invalid input.
-bool Text_FillBoxSlow(Screen* the_screen, int16_t x1, int16_t y1, int16_t x2, int16_t y2, unsigned char the_char, uint8_t fore_color, uint8_t back_color, text_draw_choice the_draw_choice)
+bool Text_FillBox(Screen* the_screen, int16_t x1, int16_t y1, int16_t x2, int16_t y2, unsigned char the_char, uint8_t fore_color, uint8_t back_color)
 {
+	int16_t		dy;
 	int16_t		dx;
+	uint8_t		the_attribute_value;
 	
 	if (the_screen == NULL)
 	{
@@ -582,15 +1274,15 @@ bool Text_FillBoxSlow(Screen* the_screen, int16_t x1, int16_t y1, int16_t x2, in
 		return false;
 	}
 
-	if (!Text_ValidateAll(the_screen, x1, y1,fore_color, back_color))
+	if (!Text_ValidateAll(the_screen, x1, y1, fore_color, back_color))
 	{
-		LOG_ERR(("%s %d: illegal screen id, coordinate, or color", __func__, __LINE__));
+		LOG_ERR(("%s %d: illegal coordinate (%i, %i) or color", __func__, __LINE__, x1, y1));
 		return false;
 	}
 	
 	if (!Text_ValidateXY(the_screen, x2, y2))
 	{
-		LOG_ERR(("%s %d: illegal coordinate", __func__, __LINE__));
+		LOG_ERR(("%s %d: illegal coordinate (%i, %i)", __func__, __LINE__, x2, y2));
 		return false;
 	}
 
@@ -600,37 +1292,79 @@ bool Text_FillBoxSlow(Screen* the_screen, int16_t x1, int16_t y1, int16_t x2, in
 		return false;
 	}
 
-	// add 1 to line len, because desired behavior is a box that connects fully to the passed coords
+ 	// add 1 to H line len, because dx becomes width, and if width = 0, then memset gets 0, and nothing happens.
+	// dy can be 0 and you still get at least one row done.
 	dx = x2 - x1 + 1;
+	dy = y2 - y1 + 0;
+
+	// calculate attribute value from passed fore and back colors
+	// LOGIC: text mode only supports 16 colors. lower 4 bits are back, upper 4 bits are foreground
+	the_attribute_value = ((fore_color << 4) | back_color);
+
+	return Text_FillMemoryBoxBoth(the_screen, x1, y1, dx, dy, the_char, the_attribute_value);
+}
+
+
+//! Fill character memory for a specific box area
+//! @param	the_screen: valid pointer to the target screen to operate on
+//! @param	x1: the leftmost horizontal position, between 0 and the screen's text_cols_vis_ - 1
+//! @param	y1: the uppermost vertical position, between 0 and the screen's text_rows_vis_ - 1
+//! @param	x2: the rightmost horizontal position, between 0 and the screen's text_cols_vis_ - 1
+//! @param	y2: the lowermost vertical position, between 0 and the screen's text_rows_vis_ - 1
+//! @param	the_char: the character to be used for the fill operation
+//! @return	Returns false on any error/invalid input.
+bool Text_FillBoxCharOnly(Screen* the_screen, int16_t x1, int16_t y1, int16_t x2, int16_t y2, unsigned char the_char)
+{
+	int16_t		dy;
+	int16_t		dx;
 	
-	for (; y1 <= y2; y1++)
+	if (the_screen == NULL)
 	{
-		if (!Text_DrawHLine(the_screen, x1, y1, dx, the_char, fore_color, back_color, the_draw_choice))
-		{
-			LOG_ERR(("%s %d: fill failed", __func__, __LINE__));
-			return false;
-		}
+		LOG_ERR(("%s %d: passed screen was NULL", __func__, __LINE__));
+		return false;
 	}
-			
-	return true;
+
+	if (!Text_ValidateAll(the_screen, x1, y1, 0, 0))
+	{
+		LOG_ERR(("%s %d: illegal coordinate (%i, %i) or color", __func__, __LINE__, x1, y1));
+		return false;
+	}
+	
+	if (!Text_ValidateXY(the_screen, x2, y2))
+	{
+		LOG_ERR(("%s %d: illegal coordinate (%i, %i)", __func__, __LINE__, x2, y2));
+		return false;
+	}
+
+	if (x1 > x2 || y1 > y2)
+	{
+		LOG_ERR(("%s %d: illegal coordinates", __func__, __LINE__));
+		return false;
+	}
+
+ 	// add 1 to H line len, because dx becomes width, and if width = 0, then memset gets 0, and nothing happens.
+	// dy can be 0 and you still get at least one row done.
+	dx = x2 - x1 + 1;
+	dy = y2 - y1 + 0;
+
+	return Text_FillMemoryBox(the_screen, x1, y1, dx, dy, SCREEN_FOR_TEXT_CHAR, the_char);
 }
 
 
-//! Fill character and attribute memory for a specific box area
+//! Fill attribute memory for a specific box area
 //! @param	the_screen: valid pointer to the target screen to operate on
 //! @param	x1: the leftmost horizontal position, between 0 and the screen's text_cols_vis_ - 1
 //! @param	y1: the uppermost vertical position, between 0 and the screen's text_rows_vis_ - 1
 //! @param	x2: the rightmost horizontal position, between 0 and the screen's text_cols_vis_ - 1
 //! @param	y2: the lowermost vertical position, between 0 and the screen's text_rows_vis_ - 1
-//! @param	the_char: the character to be used for the fill operation
 //! @param	fore_color: Index to the desired foreground color (0-15). The predefined macro constants may be used (COLOR_DK_RED, etc.), but be aware that the colors are not fixed, and may not correspond to the names if the LUT in RAM has been modified.
 //! @param	back_color: Index to the desired background color (0-15). The predefined macro constants may be used (COLOR_DK_RED, etc.), but be aware that the colors are not fixed, and may not correspond to the names if the LUT in RAM has been modified.
 //! @return	Returns false on any error/invalid input.
-bool Text_FillBox(Screen* the_screen, int16_t x1, int16_t y1, int16_t x2, int16_t y2, unsigned char the_char, uint8_t fore_color, uint8_t back_color)
+bool Text_FillBoxAttrOnly(Screen* the_screen, int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint8_t fore_color, uint8_t back_color)
 {
-	int16_t		dy;
-	int16_t		dx;
-	uint8_t		the_attribute_value;
+	int16_t			dy;
+	int16_t			dx;
+	uint8_t			the_attribute_value;
 	
 	if (the_screen == NULL)
 	{
@@ -638,7 +1372,7 @@ bool Text_FillBox(Screen* the_screen, int16_t x1, int16_t y1, int16_t x2, int16_
 		return false;
 	}
 
-	if (!Text_ValidateAll(the_screen, x1, y1, fore_color, back_color))
+	if (!Text_ValidateAll(the_screen, x1, y1, 0, 0))
 	{
 		LOG_ERR(("%s %d: illegal coordinate (%i, %i) or color", __func__, __LINE__, x1, y1));
 		return false;
@@ -665,23 +1399,20 @@ bool Text_FillBox(Screen* the_screen, int16_t x1, int16_t y1, int16_t x2, int16_
 	// LOGIC: text mode only supports 16 colors. lower 4 bits are back, upper 4 bits are foreground
 	the_attribute_value = ((fore_color << 4) | back_color);
 
-	return Text_FillMemoryBoxBoth(the_screen, x1, y1, dx, dy, the_char, the_attribute_value);
+	return Text_FillMemoryBox(the_screen, x1, y1, dx, dy, SCREEN_FOR_TEXT_ATTR, the_attribute_value);
 }
 
 
-//! Fill character memory for a specific box area
+//! Invert the colors of a rectangular block.
+//! The fore and back colors of 4 cells at a time are swapped, so a whole-row selection bar costs about a quarter as many memory accesses as there are cells.
 //! @param	the_screen: valid pointer to the target screen to operate on
 //! @param	x1: the leftmost horizontal position, between 0 and the screen's text_cols_vis_ - 1
 //! @param	y1: the uppermost vertical position, between 0 and the screen's text_rows_vis_ - 1
 //! @param	x2: the rightmost horizontal position, between 0 and the screen's text_cols_vis_ - 1
 //! @param	y2: the lowermost vertical position, between 0 and the screen's text_rows_vis_ - 1
-//! @param	the_char: the character to be used for the fill operation
 //! @return	Returns false on any error/invalid input.
-bool Text_FillBoxCharOnly(Screen* the_screen, int16_t x1, int16_t y1, int16_t x2, int16_t y2, unsigned char the_char)
+bool Text_InvertBox(Screen* the_screen, int16_t x1, int16_t y1, int16_t x2, int16_t y2)
 {
-	int16_t		dy;
-	int16_t		dx;
-	
 	if (the_screen == NULL)
 	{
 		LOG_ERR(("%s %d: passed screen was NULL", __func__, __LINE__));
@@ -690,13 +1421,13 @@ bool Text_FillBoxCharOnly(Screen* the_screen, int16_t x1, int16_t y1, int16_t x2
 
 	if (!Text_ValidateAll(the_screen, x1, y1, 0, 0))
 	{
-		LOG_ERR(("%s %d: illegal coordinate (%i, %i) or color", __func__, __LINE__, x1, y1));
+		LOG_ERR(("%s %d: illegal screen id, coordinate, or color", __func__, __LINE__));
 		return false;
 	}
 	
 	if (!Text_ValidateXY(the_screen, x2, y2))
 	{
-		LOG_ERR(("%s %d: illegal coordinate (%i, %i)", __func__, __LINE__, x2, y2));
+		LOG_ERR(("%s %d: illegal coordinate", __func__, __LINE__));
 		return false;
 	}
 
@@ -706,39 +1437,32 @@ bool Text_FillBoxCharOnly(Screen* the_screen, int16_t x1, int16_t y1, int16_t x2
 		return false;
 	}
 
- 	// add 1 to H line len, because dx becomes width, and if width = 0, then memset gets 0, and nothing happens.
-	// dy can be 0 and you still get at least one row done.
-	dx = x2 - x1 + 1;
-	dy = y2 - y1 + 0;
+	Text_UpdateAttrBox(the_screen, x1, y1, x2, y2, 0, 0, true);
 
-	return Text_FillMemoryBox(the_screen, x1, y1, dx, dy, SCREEN_FOR_TEXT_CHAR, the_char);
+	return true;
 }
 
 
-//! Fill attribute memory for a specific box area
+//! Change the foreground color of a rectangular block, leaving the background colors and characters as they are
+//! 4 cells at a time are recolored with a mask, so this is about as fast as Text_FillBoxAttrOnly().
 //! @param	the_screen: valid pointer to the target screen to operate on
 //! @param	x1: the leftmost horizontal position, between 0 and the screen's text_cols_vis_ - 1
 //! @param	y1: the uppermost vertical position, between 0 and the screen's text_rows_vis_ - 1
 //! @param	x2: the rightmost horizontal position, between 0 and the screen's text_cols_vis_ - 1
 //! @param	y2: the lowermost vertical position, between 0 and the screen's text_rows_vis_ - 1
 //! @param	fore_color: Index to the desired foreground color (0-15). The predefined macro constants may be used (COLOR_DK_RED, etc.), but be aware that the colors are not fixed, and may not correspond to the names if the LUT in RAM has been modified.
-//! @param	back_color: Index to the desired background color (0-15). The predefined macro constants may be used (COLOR_DK_RED, etc.), but be aware that the colors are not fixed, and may not correspond to the names if the LUT in RAM has been modified.
 //! @return	Returns false on any error/invalid input.
-bool Text_FillBoxAttrOnly(Screen* the_screen, int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint8_t fore_color, uint8_t back_color)
+bool Text_FillBoxForeOnly(Screen* the_screen, int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint8_t fore_color)
 {
-	int16_t			dy;
-	int16_t			dx;
-	uint8_t			the_attribute_value;
-	
 	if (the_screen == NULL)
 	{
 		LOG_ERR(("%s %d: passed screen was NULL", __func__, __LINE__));
 		return false;
 	}
 
-	if (!Text_ValidateAll(the_screen, x1, y1, 0, 0))
+	if (!Text_ValidateAll(the_screen, x1, y1, fore_color, 0))
 	{
-		LOG_ERR(("%s %d: illegal coordinate (%i, %i) or color", __func__, __LINE__, x1, y1));
+		LOG_ERR(("%s %d: illegal coordinate (%i, %i) or color (%u)", __func__, __LINE__, x1, y1, fore_color));
 		return false;
 	}
 	
@@ -754,50 +1478,39 @@ bool Text_FillBoxAttrOnly(Screen* the_screen, int16_t x1, int16_t y1, int16_t x2
 		return false;
 	}
 
- 	// add 1 to H line len, because dx becomes width, and if width = 0, then memset gets 0, and nothing happens.
-	// dy can be 0 and you still get at least one row done.
-	dx = x2 - x1 + 1;
-	dy = y2 - y1 + 0;
-
-	// calculate attribute value from passed fore and back colors
 	// LOGIC: text mode only supports 16 colors. lower 4 bits are back, upper 4 bits are foreground
-	the_attribute_value = ((fore_color << 4) | back_color);
+	Text_UpdateAttrBox(the_screen, x1, y1, x2, y2, 0x0F, fore_color << 4, false);
 
-	return Text_FillMemoryBox(the_screen, x1, y1, dx, dy, SCREEN_FOR_TEXT_ATTR, the_attribute_value);
+	return true;
 }
 
 
-//! Invert the colors of a rectangular block.
-//! As this requires sampling each character cell, it is no faster (per cell) to do for entire screen as opposed to a subset box
+//! Change the background color of a rectangular block, leaving the foreground colors and characters as they are
+//! 4 cells at a time are recolored with a mask, so this is about as fast as Text_FillBoxAttrOnly().
 //! @param	the_screen: valid pointer to the target screen to operate on
 //! @param	x1: the leftmost horizontal position, between 0 and the screen's text_cols_vis_ - 1
 //! @param	y1: the uppermost vertical position, between 0 and the screen's text_rows_vis_ - 1
 //! @param	x2: the rightmost horizontal position, between 0 and the screen's text_cols_vis_ - 1
 //! @param	y2: the lowermost vertical position, between 0 and the screen's text_rows_vis_ - 1
+//! @param	back_color: Index to the desired background color (0-15). The predefined macro constants may be used (COLOR_DK_RED, etc.), but be aware that the colors are not fixed, and may not correspond to the names if the LUT in RAM has been modified.
 //! @return	Returns false on any error/invalid input.
-bool Text_InvertBox(Screen* the_screen, int16_t x1, int16_t y1, int16_t x2, int16_t y2)
+bool Text_FillBoxBackOnly(Screen* the_screen, int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint8_t back_color)
 {
-	uint8_t			the_attribute_value;
-	uint8_t			the_inversed_value;
-	char*			the_write_loc;
-	int16_t			the_col;
-	int16_t			skip_len;
-	
 	if (the_screen == NULL)
 	{
 		LOG_ERR(("%s %d: passed screen was NULL", __func__, __LINE__));
 		return false;
 	}
 
-	if (!Text_ValidateAll(the_screen, x1, y1, 0, 0))
+	if (!Text_ValidateAll(the_screen, x1, y1, 0, back_color))
 	{
-		LOG_ERR(("%s %d: illegal screen id, coordinate, or color", __func__, __LINE__));
+		LOG_ERR(("%s %d: illegal coordinate (%i, %i) or color (%u)", __func__, __LINE__, x1, y1, back_color));
 		return false;
 	}
 	
 	if (!Text_ValidateXY(the_screen, x2, y2))
 	{
-		LOG_ERR(("%s %d: illegal coordinate", __func__, __LINE__));
+		LOG_ERR(("%s %d: illegal coordinate (%i, %i)", __func__, __LINE__, x2, y2));
 		return false;
 	}
 
@@ -807,26 +1520,7 @@ bool Text_InvertBox(Screen* the_screen, int16_t x1, int16_t y1, int16_t x2, int1
 		return false;
 	}
 
-	// get initial read/write loc
-	the_write_loc = Text_GetMemLocForXY(the_screen, x1, y1, SCREEN_FOR_TEXT_ATTR);	
-	
-	// amount of cells to skip past once we have written the specified line len
-	skip_len = the_screen->text_mem_cols_ - (x2 - x1) - 1;
-
-	for (; y1 <= y2; y1++)
-	{
-		for (the_col = x1; the_col <= x2; the_col++)
-		{
-			the_attribute_value = (unsigned char)*the_write_loc;
-			
-			// LOGIC: text mode only supports 16 colors. lower 4 bits are back, upper 4 bits are foreground
-			the_inversed_value = (((the_attribute_value & 0x0F) << 4) | ((the_attribute_value & 0xF0) >> 4));
-			
-			*the_write_loc++ = the_inversed_value;
-		}
-
-		the_write_loc += skip_len;
-	}
+	Text_UpdateAttrBox(the_screen, x1, y1, x2, y2, 0xF0, back_color, false);
 
 	return true;
 }
@@ -860,6 +1554,33 @@ bool Text_UpdateFontData(Screen* the_screen, char* new_font_data)
 }
 
 
+//! replace the font data for a single character, leaving the rest of the font alone
+//! Only that character's glyph (text_font_height_ bytes) is written to font memory. Any cells on screen already showing that character change with it.
+//! @param	the_screen: valid pointer to the target screen to operate on
+//! @param	the_char: the character code (0-255) whose glyph is to be replaced
+//! @param	the_glyph_data: Pointer to the screen's text_font_height_ bytes of glyph data (8 or 16). Each byte represents one line of the glyph, high bit on the left.
+//! @return	Returns false on any error/invalid input.
+bool Text_UpdateFontGlyph(Screen* the_screen, unsigned char the_char, char* the_glyph_data)
+{
+	if (the_screen == NULL)
+	{
+		LOG_ERR(("%s %d: passed screen was NULL", __func__, __LINE__));
+		return false;
+	}
+
+	if (the_glyph_data == NULL)
+	{
+		LOG_ERR(("%s %d: passed glyph data was NULL", __func__, __LINE__));
+		return false;
+	}
+
+	// LOGIC: glyphs are stored back to back, one byte per line, so each one is text_font_height_ bytes from the last
+	memcpy(the_screen->text_font_ram_ + (int32_t)the_char * the_screen->text_font_height_, the_glyph_data, the_screen->text_font_height_);
+
+	return true;
+}
+
+
 //! Test function to display all 256 font characters.
 //! Characters are rendered in 8 rows of 32 characters.
 //! @param	the_screen: valid pointer to the target screen to operate on
@@ -879,6 +1600,7 @@ bool Text_ShowFontChars(Screen* the_screen, int16_t y)
 	}
 
 	the_write_loc = the_screen->text_ram_ + (the_screen->text_mem_cols_ * y);
+	Text_MarkRowsDirty(the_screen, y, y + 7);
 	
 	// print rows of 32 characters at a time
 	for (j = 0; j < 8; j++)
@@ -923,6 +1645,7 @@ bool Text_SetCharAtXY(Screen* the_screen, int16_t x, int16_t y, unsigned char th
 	
 	the_write_loc = Text_GetMemLocForXY(the_screen, x, y, SCREEN_FOR_TEXT_CHAR);	
  	*the_write_loc = the_char;
+	Text_MarkRowsDirty(the_screen, y, y);
 	
 	return true;
 }
@@ -952,6 +1675,7 @@ bool Text_SetAttrAtXY(Screen* the_screen, int16_t x, int16_t y, uint8_t the_attr
 
 	the_write_loc = Text_GetMemLocForXY(the_screen, x, y, SCREEN_FOR_TEXT_ATTR);	
  	*the_write_loc = the_attribute_value;
+	Text_MarkRowsDirty(the_screen, y, y);
 	
 	return true;
 }
@@ -1019,6 +1743,7 @@ bool Text_SetCharAndColorAtXY(Screen* the_screen, int16_t x, int16_t y, unsigned
 	// write attribute memory (reuse same calc, just add attr ram delta)
 	the_write_loc += the_screen->text_attr_ram_ - the_screen->text_ram_;
 	*the_write_loc = the_attribute_value;
+	Text_MarkRowsDirty(the_screen, y, y);
 	
 	return true;
 }
@@ -1152,6 +1877,7 @@ uint8_t Text_GetBackColorAtXY(Screen* the_screen, int16_t x, int16_t y)
 
 
 //! Draws a horizontal line from specified coords, for n characters, using the specified char and/or attribute
+//! The line is clipped at the right edge of the screen.
 //! @param	the_screen: valid pointer to the target screen to operate on
 //! @param	x: the starting horizontal position, between 0 and the screen's text_cols_vis_ - 1
 //! @param	y: the starting vertical position, between 0 and the screen's text_rows_vis_ - 1
@@ -1163,64 +1889,8 @@ uint8_t Text_GetBackColorAtXY(Screen* the_screen, int16_t x, int16_t y)
 //! @return	Returns false on any error/invalid input.
 bool Text_DrawHLine(Screen* the_screen, int16_t x, int16_t y, int16_t the_line_len, unsigned char the_char, uint8_t fore_color, uint8_t back_color, text_draw_choice the_draw_choice)
 {
-	bool			result;
-	
 	// LOGIC: 
-	//   an H line is just a box with 1 row, so we can re-use Text_FillMemoryBox(Both)(). These routines use memset, so are quicker than for loops. 
-	
-	if (the_screen == NULL)
-	{
-		LOG_ERR(("%s %d: passed screen was NULL", __func__, __LINE__));
-		return false;
-	}
-
-	if (!Text_ValidateAll(the_screen, x, y, fore_color, back_color))
-	{
-		LOG_ERR(("%s %d: illegal screen id, coordinate, or color", __func__, __LINE__));
-		return false;
-	}
-
-	if (the_draw_choice == CHAR_ONLY)
-	{
-		result = Text_FillMemoryBox(the_screen, x, y, the_line_len, 0, SCREEN_FOR_TEXT_CHAR, the_char);
-	}
-	else
-	{
-		// calculate attribute value from passed fore and back colors
-		// LOGIC: text mode only supports 16 colors. lower 4 bits are back, upper 4 bits are foreground
-
-		uint8_t			the_attribute_value;
-
-		the_attribute_value = ((fore_color << 4) | back_color);
-	
-		if (the_draw_choice == ATTR_ONLY)
-		{
-			result = Text_FillMemoryBox(the_screen, x, y, the_line_len, 0, SCREEN_FOR_TEXT_ATTR, the_attribute_value);
-		}
-		else
-		{
-			result = Text_FillMemoryBoxBoth(the_screen, x, y, the_line_len, 0, the_char, the_attribute_value);
-		}
-	}
-
-	return result;
-}
-
-
-//! Draws a horizontal line from specified coords, for n characters, using the specified char and/or attribute
-//! This version uses char-by-char functions, so it is very slow. It will be removed before release. 
-//! @param	the_screen: valid pointer to the target screen to operate on
-//! @param	x: the starting horizontal position, between 0 and the screen's text_cols_vis_ - 1
-//! @param	y: the starting vertical position, between 0 and the screen's text_rows_vis_ - 1
-//! @param	the_line_len: The total length of the line, in characters, including the start and end character.
-//! @param	the_char: the character to be used when drawing
-//! @param	fore_color: Index to the desired foreground color (0-15). The predefined macro constants may be used (COLOR_DK_RED, etc.), but be aware that the colors are not fixed, and may not correspond to the names if the LUT in RAM has been modified.
-//! @param	back_color: Index to the desired background color (0-15). The predefined macro constants may be used (COLOR_DK_RED, etc.), but be aware that the colors are not fixed, and may not correspond to the names if the LUT in RAM has been modified.
-//! @param	the_draw_choice: controls the scope of the action, and is one of CHAR_ONLY, ATTR_ONLY, or CHAR_AND_ATTR. See the text_draw_choice enum.
-//! @return	Returns false on any error/invalid input.
-bool Text_DrawHLineSlow(Screen* the_screen, int16_t x, int16_t y, int16_t the_line_len, unsigned char the_char, uint8_t fore_color, uint8_t back_color, text_draw_choice the_draw_choice)
-{
-	int16_t		dx;
+	//   validate once, then the whole line is one run: a memset each for chars and attrs.
 	
 	if (the_screen == NULL)
 	{
@@ -1234,36 +1904,15 @@ bool Text_DrawHLineSlow(Screen* the_screen, int16_t x, int16_t y, int16_t the_li
 		return false;
 	}
 
-	switch (the_draw_choice)
-	{
-		case CHAR_ONLY:
-			for (dx = 0; dx < the_line_len; dx++)
-			{
-				Text_SetCharAtXY(the_screen, x + dx, y, the_char);
-			}
-			break;
-			
-		case ATTR_ONLY:
-			for (dx = 0; dx < the_line_len; dx++)
-			{
-				Text_SetColorAtXY(the_screen, x + dx, y, fore_color, back_color);
-			}
-			break;
-			
-		case CHAR_AND_ATTR:
-		default:
-			for (dx = 0; dx < the_line_len; dx++)
-			{
-				Text_SetCharAndColorAtXY(the_screen, x + dx, y, the_char, fore_color, back_color);		
-			}
-			break;			
-	}
+	// LOGIC: text mode only supports 16 colors. lower 4 bits are back, upper 4 bits are foreground
+	Text_DrawRun(the_screen, x, y, the_line_len, false, the_char, ((fore_color << 4) | back_color), the_draw_choice);
 
 	return true;
 }
 
 
 //! Draws a vertical line from specified coords, for n characters, using the specified char and/or attribute
+//! The line is clipped at the bottom edge of the screen.
 //! @param	the_screen: valid pointer to the target screen to operate on
 //! @param	x: the starting horizontal position, between 0 and the screen's text_cols_vis_ - 1
 //! @param	y: the starting vertical position, between 0 and the screen's text_rows_vis_ - 1
@@ -1275,7 +1924,8 @@ bool Text_DrawHLineSlow(Screen* the_screen, int16_t x, int16_t y, int16_t the_li
 //! @return	Returns false on any error/invalid input.
 bool Text_DrawVLine(Screen* the_screen, int16_t x, int16_t y, int16_t the_line_len, unsigned char the_char, uint8_t fore_color, uint8_t back_color, text_draw_choice the_draw_choice)
 {
-	int16_t		dy;
+	// LOGIC: 
+	//   validate once, then the whole line is one run, stepping down a row at a time.
 	
 	if (the_screen == NULL)
 	{
@@ -1289,30 +1939,7 @@ bool Text_DrawVLine(Screen* the_screen, int16_t x, int16_t y, int16_t the_line_l
 		return false;
 	}
 
-	switch (the_draw_choice)
-	{
-		case CHAR_ONLY:
-			for (dy = 0; dy < the_line_len; dy++)
-			{
-				Text_SetCharAtXY(the_screen, x, y + dy, the_char);
-			}
-			break;
-			
-		case ATTR_ONLY:
-			for (dy = 0; dy < the_line_len; dy++)
-			{
-				Text_SetColorAtXY(the_screen, x, y + dy, fore_color, back_color);
-			}
-			break;
-			
-		case CHAR_AND_ATTR:
-		default:
-			for (dy = 0; dy < the_line_len; dy++)
-			{
-				Text_SetCharAndColorAtXY(the_screen, x, y + dy, the_char, fore_color, back_color);		
-			}
-			break;			
-	}
+	Text_DrawRun(the_screen, x, y, the_line_len, true, the_char, ((fore_color << 4) | back_color), the_draw_choice);
 	
 	return true;
 }
@@ -1331,9 +1958,6 @@ bool Text_DrawVLine(Screen* the_screen, int16_t x, int16_t y, int16_t the_line_l
 //! @return	Returns false on any error/invalid input.
 bool Text_DrawBoxCoords(Screen* the_screen, int16_t x1, int16_t y1, int16_t x2, int16_t y2, unsigned char the_char, uint8_t fore_color, uint8_t back_color, text_draw_choice the_draw_choice)
 {
-	int16_t		dy;
-	int16_t		dx;
-	
 	if (the_screen == NULL)
 	{
 		LOG_ERR(("%s %d: passed screen was NULL", __func__, __LINE__));
@@ -1358,35 +1982,7 @@ bool Text_DrawBoxCoords(Screen* the_screen, int16_t x1, int16_t y1, int16_t x2,
 		return false;
 	}
 
-// 	// add 1 to H line len, because dx becomes width, and if width = 0, then memset gets 0, and nothing happens.
-	// dy can be 0 and you still get at least one row done.
-	// don't add 1 to line len, because if you do, you can never draw a box that is only 1 char wide or 1 char tall
-	dx = x2 - x1 + 1;
-	dy = y2 - y1 + 0;
-	
-	if (!Text_DrawHLine(the_screen, x1, y1, dx, the_char, fore_color, back_color, the_draw_choice))
-	{
-		LOG_ERR(("%s %d: draw box failed", __func__, __LINE__));
-		return false;
-	}
-	
-	if (!Text_DrawVLine(the_screen, x2, y1, dy, the_char, fore_color, back_color, the_draw_choice))
-	{
-		LOG_ERR(("%s %d: draw box failed", __func__, __LINE__));
-		return false;
-	}
-	
-	if (!Text_DrawHLine(the_screen, x1, y2, dx, the_char, fore_color, back_color, the_draw_choice))
-	{
-		LOG_ERR(("%s %d: draw box failed", __func__, __LINE__));
-		return false;
-	}
-	
-	if (!Text_DrawVLine(the_screen, x1, y1, dy, the_char, fore_color, back_color, the_draw_choice))
-	{
-		LOG_ERR(("%s %d: draw box failed", __func__, __LINE__));
-		return false;
-	}
+	Text_DrawFrame(the_screen, x1, y1, x2, y2, the_char, the_char, NULL, ((fore_color << 4) | back_color), the_draw_choice);
 		
 	return true;
 }
@@ -1403,8 +1999,7 @@ bool Text_DrawBoxCoords(Screen* the_screen, int16_t x1, int16_t y1, int16_t x2,
 //! @return	Returns false on any error/invalid input.
 bool Text_DrawBoxCoordsFancy(Screen* the_screen, int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint8_t fore_color, uint8_t back_color)
 {
-	int16_t		dy;
-	int16_t		dx;
+	static const unsigned char	the_corners[4] = {CH_WALL_UL, CH_WALL_UR, CH_WALL_LR, CH_WALL_LL};
 	
 	if (the_screen == NULL)
 	{
@@ -1430,43 +2025,8 @@ bool Text_DrawBoxCoordsFancy(Screen* the_screen, int16_t x1, int16_t y1, int16_t
 		return false;
 	}
 
-// 	// add 1 to H line len, because dx becomes width, and if width = 0, then memset gets 0, and nothing happens.
-	// dy can be 0 and you still get at least one row done.
-	// but, for this, because of how we draw H line, do NOT add 1 to x1. see "x1+1" below... 
-	dx = x2 - x1 + 0;
-	dy = y2 - y1 + 0;
-	
-	// draw all lines one char shorter on each end so that we don't overdraw when we do corners
-	
-	if (!Text_DrawHLine(the_screen, x1+1, y1, dx, CH_WALL_H, fore_color, back_color, CHAR_AND_ATTR))
-	{
-		LOG_ERR(("%s %d: draw box failed", __func__, __LINE__));
-		return false;
-	}
-	
-	if (!Text_DrawHLine(the_screen, x1+1, y2, dx, CH_WALL_H, fore_color, back_color, CHAR_AND_ATTR))
-	{
-		LOG_ERR(("%s %d: draw box failed", __func__, __LINE__));
-		return false;
-	}
-	
-	if (!Text_DrawVLine(the_screen, x2, y1+1, dy, CH_WALL_V, fore_color, back_color, CHAR_AND_ATTR))
-	{
-		LOG_ERR(("%s %d: draw box failed", __func__, __LINE__));
-		return false;
-	}
-	
-	if (!Text_DrawVLine(the_screen, x1, y1+1, dy, CH_WALL_V, fore_color, back_color, CHAR_AND_ATTR))
-	{
-		LOG_ERR(("%s %d: draw box failed", __func__, __LINE__));
-		return false;
-	}
-	
-	// draw the 4 corners with dedicated corner pieces
-	Text_SetCharAndColorAtXY(the_screen, x1, y1, CH_WALL_UL, fore_color, back_color);		
-	Text_SetCharAndColorAtXY(the_screen, x2, y1, CH_WALL_UR, fore_color, back_color);		
-	Text_SetCharAndColorAtXY(the_screen, x2, y2, CH_WALL_LR, fore_color, back_color);		
-	Text_SetCharAndColorAtXY(the_screen, x1, y2, CH_WALL_LL, fore_color, back_color);		
+	// draw the sides, then drop the dedicated corner pieces over their ends
+	Text_DrawFrame(the_screen, x1, y1, x2, y2, CH_WALL_H, CH_WALL_V, the_corners, ((fore_color << 4) | back_color), CHAR_AND_ATTR);
 	
 	return true;
 }
@@ -1497,35 +2057,13 @@ bool Text_DrawBox(Screen* the_screen, int16_t x, int16_t y, int16_t width, int16
 		return false;
 	}
 	
-	if (!Text_ValidateXY(the_screen, x + width - 1, y + height - 1))
+	if (width < 1 || height < 1 || !Text_ValidateXY(the_screen, x + width - 1, y + height - 1))
 	{
 		LOG_ERR(("%s %d: illegal coordinate", __func__, __LINE__));
 		return false;
 	}
 
-	if (!Text_DrawHLine(the_screen, x, y, width, the_char, fore_color, back_color, the_draw_choice))
-	{
-		LOG_ERR(("%s %d: draw box failed", __func__, __LINE__));
-		return false;
-	}
-	
-	if (!Text_DrawVLine(the_screen, x + width - 1, y, height, the_char, fore_color, back_color, the_draw_choice))
-	{
-		LOG_ERR(("%s %d: draw box failed", __func__, __LINE__));
-		return false;
-	}
-	
-	if (!Text_DrawHLine(the_screen, x, y + height - 1, width, the_char, fore_color, back_color, the_draw_choice))
-	{
-		LOG_ERR(("%s %d: draw box failed", __func__, __LINE__));
-		return false;
-	}
-	
-	if (!Text_DrawVLine(the_screen, x, y, height, the_char, fore_color, back_color, the_draw_choice))
-	{
-		LOG_ERR(("%s %d: draw box failed", __func__, __LINE__));
-		return false;
-	}
+	Text_DrawFrame(the_screen, x, y, x + width - 1, y + height - 1, the_char, the_char, NULL, ((fore_color << 4) | back_color), the_draw_choice);
 		
 	return true;
 }
@@ -1546,11 +2084,35 @@ bool Text_DrawBox(Screen* the_screen, int16_t x, int16_t y, int16_t width, int16
 //! @param	back_color: Index to the desired background color (0-15). The predefined macro constants may be used (COLOR_DK_RED, etc.), but be aware that the colors are not fixed, and may not correspond to the names if the LUT in RAM has been modified.
 //! @return	Returns false on any error/invalid input.
 bool Text_DrawStringAtXY(Screen* the_screen, int16_t x, int16_t y, char* the_string, uint8_t fore_color, uint8_t back_color)
+{
+	if (the_screen == NULL)
+	{
+		LOG_ERR(("%s %d: passed screen was NULL", __func__, __LINE__));
+		return false;
+	}
+
+	// can't be wider than the screen anyway
+	return Text_DrawCharsAtXY(the_screen, x, y, the_string, General_Strnlen(the_string, the_screen->text_mem_cols_), fore_color, back_color);
+}
+
+
+//! Draw a run of characters at a specified x, y coord, also setting the color attributes.
+//! Unlike Text_DrawStringAtXY(), the characters do not need to be null-terminated, and any byte value is drawn.
+//! The run is written as one block copy to character memory and one block fill to attribute memory.
+//! If it is too long to display on the line it started, it will be truncated at the right edge of the screen.
+//! @param	the_screen: valid pointer to the target screen to operate on
+//! @param	x: the starting horizontal position, between 0 and the screen's text_cols_vis_ - 1
+//! @param	y: the starting vertical position, between 0 and the screen's text_rows_vis_ - 1
+//! @param	the_chars: the characters to be drawn
+//! @param	num_chars: the number of characters to draw
+//! @param	fore_color: Index to the desired foreground color (0-15). The predefined macro constants may be used (COLOR_DK_RED, etc.), but be aware that the colors are not fixed, and may not correspond to the names if the LUT in RAM has been modified.
+//! @param	back_color: Index to the desired background color (0-15). The predefined macro constants may be used (COLOR_DK_RED, etc.), but be aware that the colors are not fixed, and may not correspond to the names if the LUT in RAM has been modified.
+//! @return	Returns false on any error/invalid input.
+bool Text_DrawCharsAtXY(Screen* the_screen, int16_t x, int16_t y, char* the_chars, int16_t num_chars, uint8_t fore_color, uint8_t back_color)
 {
 	char*			the_char_loc;
 	char*			the_attr_loc;
 	uint8_t			the_attribute_value;
-	int16_t			i;
 	int16_t			max_col;
 	int16_t			draw_len;
 	
@@ -1566,7 +2128,7 @@ bool Text_DrawStringAtXY(Screen* the_screen, int16_t x, int16_t y, char* the_str
 		return false;
 	}
 	
-	draw_len = General_Strnlen(the_string, the_screen->text_mem_cols_); // can't be wider than the screen anyway
+	draw_len = num_chars;
 	max_col = the_screen->text_cols_vis_ - 1;
 	
 	if ( x + draw_len > max_col)
@@ -1574,7 +2136,10 @@ bool Text_DrawStringAtXY(Screen* the_screen, int16_t x, int16_t y, char* the_str
 		draw_len = (max_col - x) + 1;
 	}
 	
-	//DEBUG_OUT(("%s %d: draw_len=%i, max_col=%i, x=%i", __func__, __LINE__, draw_len, max_col, x));
+	if (draw_len <= 0)
+	{
+		return true;
+	}
 	
 	// calculate attribute value from passed fore and back colors
 	// LOGIC: text mode only supports 16 colors. lower 4 bits are back, upper 4 bits are foreground
@@ -1584,12 +2149,11 @@ bool Text_DrawStringAtXY(Screen* the_screen, int16_t x, int16_t y, char* the_str
 	the_char_loc = Text_GetMemLocForXY(the_screen, x, y, SCREEN_FOR_TEXT_CHAR);
 	the_attr_loc = the_char_loc + (the_screen->text_attr_ram_ - the_screen->text_ram_);
 	
-	// draw the string
-	for (i = 0; i < draw_len; i++)
-	{
-		*the_char_loc++ = the_string[i];
-		*the_attr_loc++ = the_attribute_value;
-	}
+	// draw the run
+	memcpy(the_char_loc, the_chars, draw_len);
+	memset(the_attr_loc, the_attribute_value, draw_len);
+	
+	Text_MarkRowsDirty(the_screen, y, y);
 	
 	return true;
 }
@@ -1689,7 +2253,7 @@ char* Text_DrawStringInBox(Screen* the_screen, int16_t x1, int16_t y1, int16_t x
 		// clear the target box area on the screen -- if fail to do this, when we draw page 2, etc, it will be messy.
 		Text_FillBox(the_screen, x1, y1, x2, y2, ' ', fore_color, back_color);
 
-		// set up char and attribute memory initial loc
+		// set up char and attribute memory initial loc. (the rows were flagged for Text_FlushShadow() by Text_FillBox())
 		the_char_loc = Text_GetMemLocForXY(the_screen, x1, y1, SCREEN_FOR_TEXT_CHAR);
 		the_attr_loc = the_char_loc + (the_screen->text_attr_ram_ - the_screen->text_ram_);
 
@@ -38,6 +38,7 @@
  * display a string in a rectangular block on the screen, with wrap
  * display a string in a rectangular block on the screen, with wrap, taking a hook for a "display more" event, and scrolling text vertically up after hook func returns 'continue' (or exit, returning control to calling func, if hook returns 'stop')
  * replace current text font with another, loading from specified ram loc.
+ * optionally draw to a shadow buffer in regular RAM, and flush only what changed to VRAM
  */
 
 
@@ -183,6 +184,30 @@ typedef enum text_draw_choice
 
 
 // ** NOTE: there is no destructor or constructor for this library, as it does not track any allocated memory.
+// ** the one exception is the optional shadow buffer: see Text_EnableShadow() and Text_DisableShadow()
+
+
+// **** Shadow buffer functions ****
+
+//! Start drawing text to a shadow buffer in regular RAM, instead of directly to VRAM
+//! All other Text functions work unchanged, but nothing they draw reaches the screen until Text_FlushShadow() is called.
+//! The shadow buffer starts out as a copy of what is currently on screen. 
+//! Changing video mode disables the shadow buffer. Call this again afterwards to use one in the new mode.
+//! @param	the_screen: valid pointer to the target screen to operate on
+//! @return	Returns false on any error/invalid input, or if the memory could not be allocated
+bool Text_EnableShadow(Screen* the_screen);
+
+//! Flush the shadow buffer to the screen, free it, and go back to drawing text directly to VRAM
+//! @param	the_screen: valid pointer to the target screen to operate on
+//! @return	Returns false on any error/invalid input. Returns true if the screen had no shadow buffer.
+bool Text_DisableShadow(Screen* the_screen);
+
+//! Copy what has changed in the shadow buffer since the last flush to VRAM
+//! Only rows that were drawn to are examined, and in each of those, only the span of columns that actually differs from what is on screen is written.
+//! Redrawing a screen with the same content therefore writes nothing to VRAM.
+//! @param	the_screen: valid pointer to the target screen to operate on
+//! @return	Returns the number of bytes written to VRAM. Returns 0 if the screen has no shadow buffer, or on any error/invalid input.
+uint32_t Text_FlushShadow(Screen* the_screen);
 
 
 // **** Block copy functions ****
@@ -231,6 +256,19 @@ bool Text_CopyScreen(Screen* the_screen, char* the_buffer, bool to_screen, bool
 //! @return	Returns false on any error/invalid input.
 bool Text_CopyMemBox(Screen* the_screen, char* the_buffer, int16_t x1, int16_t y1, int16_t x2, int16_t y2, bool to_screen, bool for_attr);
 
+//! Scroll the characters and attributes in a rectangular area of the screen up or down, and clear the rows left behind
+//! Whole rows are moved as blocks, so this is much faster than redrawing the area.
+//! @param	the_screen: valid pointer to the target screen to operate on
+//! @param	x1: the leftmost horizontal position, between 0 and the screen's text_cols_vis_ - 1
+//! @param	y1: the uppermost vertical position, between 0 and the screen's text_rows_vis_ - 1
+//! @param	x2: the rightmost horizontal position, between 0 and the screen's text_cols_vis_ - 1
+//! @param	y2: the lowermost vertical position, between 0 and the screen's text_rows_vis_ - 1
+//! @param	num_rows: number of rows to scroll by. Positive numbers scroll the contents up, negative numbers scroll them down. If this is the height of the area or more, the area is just cleared.
+//! @param	fore_color: Index to the foreground color (0-15) for the cleared rows. The predefined macro constants may be used (COLOR_DK_RED, etc.), but be aware that the colors are not fixed, and may not correspond to the names if the LUT in RAM has been modified.
+//! @param	back_color: Index to the background color (0-15) for the cleared rows. The predefined macro constants may be used (COLOR_DK_RED, etc.), but be aware that the colors are not fixed, and may not correspond to the names if the LUT in RAM has been modified.
+//! @return	Returns false on any error/invalid input.
+bool Text_ScrollBox(Screen* the_screen, int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t num_rows, uint8_t fore_color, uint8_t back_color);
+
 
 // **** Block fill functions ****
 
@@ -257,20 +295,6 @@ bool Text_FillAttrMem(Screen* the_screen, uint8_t the_fill);
 //! @return	Returns false on any error/invalid input.
 bool Text_FillCharMem(Screen* the_screen, unsigned char the_fill);
 
-//! Fill a box-shaped section of character and/or attribute memory
-//! This version uses char-by-char functions, so it is very slow. It will be removed before release. 
-//! @param	the_screen: valid pointer to the target screen to operate on
-//! @param	x1: the leftmost horizontal position, between 0 and the screen's text_cols_vis_ - 1
-//! @param	y1: the uppermost vertical position, between 0 and the screen's text_rows_vis_ - 1
-//! @param	x2: the rightmost horizontal position, between 0 and the screen's text_cols_vis_ - 1
-//! @param	y2: the lowermost vertical position, between 0 and the screen's text_rows_vis_ - 1
-//! @param	the_char: the character to be used for the fill operation
-//! @param	fore_color: Index to the desired foreground color (0-15). The predefined macro constants may be used (COLOR_DK_RED, etc.), but be aware that the colors are not fixed, and may not correspond to the names if the LUT in RAM has been modified.
-//! @param	back_color: Index to the desired background color (0-15). The predefined macro constants may be used (COLOR_DK_RED, etc.), but be aware that the colors are not fixed, and may not correspond to the names if the LUT in RAM has been modified.
-//! @param	the_draw_choice: controls the scope of the action, and is one of CHAR_ONLY, ATTR_ONLY, or CHAR_AND_ATTR. See the text_draw_choice enum.
-//! @return	Returns false on any error/invalid input.
-bool Text_FillBoxSlow(Screen* the_screen, int16_t x1, int16_t y1, int16_t x2, int16_t y2, unsigned char the_char, uint8_t fore_color, uint8_t back_color, text_draw_choice the_draw_choice);
-
 //! Fill character and attribute memory for a specific box area
 //! @param	the_screen: valid pointer to the target screen to operate on
 //! @param	x1: the leftmost horizontal position, between 0 and the screen's text_cols_vis_ - 1
@@ -305,7 +329,7 @@ bool Text_FillBoxCharOnly(Screen* the_screen, int16_t x1, int16_t y1, int16_t x2
 bool Text_FillBoxAttrOnly(Screen* the_screen, int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint8_t fore_color, uint8_t back_color);
 
 //! Invert the colors of a rectangular block.
-//! As this requires sampling each character cell, it is no faster (per cell) to do for entire screen as opposed to a subset box
+//! The fore and back colors of 4 cells at a time are swapped, so a whole-row selection bar costs about a quarter as many memory accesses as there are cells.
 //! @param	the_screen: valid pointer to the target screen to operate on
 //! @param	x1: the leftmost horizontal position, between 0 and the screen's text_cols_vis_ - 1
 //! @param	y1: the uppermost vertical position, between 0 and the screen's text_rows_vis_ - 1
@@ -314,6 +338,28 @@ bool Text_FillBoxAttrOnly(Screen* the_screen, int16_t x1, int16_t y1, int16_t x2
 //! @return	Returns false on any error/invalid input.
 bool Text_InvertBox(Screen* the_screen, int16_t x1, int16_t y1, int16_t x2, int16_t y2);
 
+//! Change the foreground color of a rectangular block, leaving the background colors and characters as they are
+//! 4 cells at a time are recolored with a mask, so this is about as fast as Text_FillBoxAttrOnly().
+//! @param	the_screen: valid pointer to the target screen to operate on
+//! @param	x1: the leftmost horizontal position, between 0 and the screen's text_cols_vis_ - 1
+//! @param	y1: the uppermost vertical position, between 0 and the screen's text_rows_vis_ - 1
+//! @param	x2: the rightmost horizontal position, between 0 and the screen's text_cols_vis_ - 1
+//! @param	y2: the lowermost vertical position, between 0 and the screen's text_rows_vis_ - 1
+//! @param	fore_color: Index to the desired foreground color (0-15). The predefined macro constants may be used (COLOR_DK_RED, etc.), but be aware that the colors are not fixed, and may not correspond to the names if the LUT in RAM has been modified.
+//! @return	Returns false on any error/invalid input.
+bool Text_FillBoxForeOnly(Screen* the_screen, int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint8_t fore_color);
+
+//! Change the background color of a rectangular block, leaving the foreground colors and characters as they are
+//! 4 cells at a time are recolored with a mask, so this is about as fast as Text_FillBoxAttrOnly().
+//! @param	the_screen: valid pointer to the target screen to operate on
+//! @param	x1: the leftmost horizontal position, between 0 and the screen's text_cols_vis_ - 1
+//! @param	y1: the uppermost vertical position, between 0 and the screen's text_rows_vis_ - 1
+//! @param	x2: the rightmost horizontal position, between 0 and the screen's text_cols_vis_ - 1
+//! @param	y2: the lowermost vertical position, between 0 and the screen's text_rows_vis_ - 1
+//! @param	back_color: Index to the desired background color (0-15). The predefined macro constants may be used (COLOR_DK_RED, etc.), but be aware that the colors are not fixed, and may not correspond to the names if the LUT in RAM has been modified.
+//! @return	Returns false on any error/invalid input.
+bool Text_FillBoxBackOnly(Screen* the_screen, int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint8_t back_color);
+
 
 
 
@@ -326,6 +372,14 @@ bool Text_InvertBox(Screen* the_screen, int16_t x1, int16_t y1, int16_t x2, int1
 //! @return	Returns false on any error/invalid input.
 bool Text_UpdateFontData(Screen* the_screen, char* new_font_data);
 
+//! replace the font data for a single character, leaving the rest of the font alone
+//! Only that character's glyph (text_font_height_ bytes) is written to font memory. Any cells on screen already showing that character change with it.
+//! @param	the_screen: valid pointer to the target screen to operate on
+//! @param	the_char: the character code (0-255) whose glyph is to be replaced
+//! @param	the_glyph_data: Pointer to the screen's text_font_height_ bytes of glyph data (8 or 16). Each byte represents one line of the glyph, high bit on the left.
+//! @return	Returns false on any error/invalid input.
+bool Text_UpdateFontGlyph(Screen* the_screen, unsigned char the_char, char* the_glyph_data);
+
 //! Test function to display all 256 font characters.
 //! Characters are rendered in 8 rows of 32 characters.
 //! @param	the_screen: valid pointer to the target screen to operate on
@@ -414,6 +468,7 @@ uint8_t Text_GetBackColorAtXY(Screen* the_screen, int16_t x, int16_t y);
 
 
 //! Draws a horizontal line from specified coords, for n characters, using the specified char and/or attribute
+//! The line is clipped at the right edge of the screen.
 //! @param	the_screen: valid pointer to the target screen to operate on
 //! @param	x: the starting horizontal position, between 0 and the screen's text_cols_vis_ - 1
 //! @param	y: the starting vertical position, between 0 and the screen's text_rows_vis_ - 1
@@ -425,20 +480,8 @@ uint8_t Text_GetBackColorAtXY(Screen* the_screen, int16_t x, int16_t y);
 //! @return	Returns false on any error/invalid input.
 bool Text_DrawHLine(Screen* the_screen, int16_t x, int16_t y, int16_t the_line_len, unsigned char the_char, uint8_t fore_color, uint8_t back_color, text_draw_choice the_draw_choice);
 
-//! Draws a horizontal line from specified coords, for n characters, using the specified char and/or attribute
-//! This version uses char-by-char functions, so it is very slow. It will be removed before release. 
-//! @param	the_screen: valid pointer to the target screen to operate on
-//! @param	x: the starting horizontal position, between 0 and the screen's text_cols_vis_ - 1
-//! @param	y: the starting vertical position, between 0 and the screen's text_rows_vis_ - 1
-//! @param	the_line_len: The total length of the line, in characters, including the start and end character.
-//! @param	the_char: the character to be used when drawing
-//! @param	fore_color: Index to the desired foreground color (0-15). The predefined macro constants may be used (COLOR_DK_RED, etc.), but be aware that the colors are not fixed, and may not correspond to the names if the LUT in RAM has been modified.
-//! @param	back_color: Index to the desired background color (0-15). The predefined macro constants may be used (COLOR_DK_RED, etc.), but be aware that the colors are not fixed, and may not correspond to the names if the LUT in RAM has been modified.
-//! @param	the_draw_choice: controls the scope of the action, and is one of CHAR_ONLY, ATTR_ONLY, or CHAR_AND_ATTR. See the text_draw_choice enum.
-//! @return	Returns false on any error/invalid input.
-bool Text_DrawHLineSlow(Screen* the_screen, int16_t x, int16_t y, int16_t the_line_len, unsigned char the_char, uint8_t fore_color, uint8_t back_color, text_draw_choice the_draw_choice);
-
 //! Draws a vertical line from specified coords, for n characters, using the specified char and/or attribute
+//! The line is clipped at the bottom edge of the screen.
 //! @param	the_screen: valid pointer to the target screen to operate on
 //! @param	x: the starting horizontal position, between 0 and the screen's text_cols_vis_ - 1
 //! @param	y: the starting vertical position, between 0 and the screen's text_rows_vis_ - 1
@@ -504,6 +547,20 @@ bool Text_DrawBox(Screen* the_screen, int16_t x, int16_t y, int16_t width, int16
 //! @return	Returns false on any error/invalid input.
 bool Text_DrawStringAtXY(Screen* the_screen, int16_t x, int16_t y, char* the_string, uint8_t fore_color, uint8_t back_color);
 
+//! Draw a run of characters at a specified x, y coord, also setting the color attributes.
+//! Unlike Text_DrawStringAtXY(), the characters do not need to be null-terminated, and any byte value is drawn.
+//! The run is written as one block copy to character memory and one block fill to attribute memory.
+//! If it is too long to display on the line it started, it will be truncated at the right edge of the screen.
+//! @param	the_screen: valid pointer to the target screen to operate on
+//! @param	x: the starting horizontal position, between 0 and the screen's text_cols_vis_ - 1
+//! @param	y: the starting vertical position, between 0 and the screen's text_rows_vis_ - 1
+//! @param	the_chars: the characters to be drawn
+//! @param	num_chars: the number of characters to draw
+//! @param	fore_color: Index to the desired foreground color (0-15). The predefined macro constants may be used (COLOR_DK_RED, etc.), but be aware that the colors are not fixed, and may not correspond to the names if the LUT in RAM has been modified.
+//! @param	back_color: Index to the desired background color (0-15). The predefined macro constants may be used (COLOR_DK_RED, etc.), but be aware that the colors are not fixed, and may not correspond to the names if the LUT in RAM has been modified.
+//! @return	Returns false on any error/invalid input.
+bool Text_DrawCharsAtXY(Screen* the_screen, int16_t x, int16_t y, char* the_chars, int16_t num_chars, uint8_t fore_color, uint8_t back_color);
+
 //! Draw a string in a rectangular block on the screen, with wrap.
 //! If a word can't be wrapped, it will break the word and move on to the next line. So if you pass a rect with 1 char of width, it will draw a vertical line of chars down the screen.
 //! @param	the_screen: valid pointer to the target screen to operate on
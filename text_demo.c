@@ -70,8 +70,6 @@ void Demo_Text_FillCharMem1(void);
 void Demo_Text_FillCharMem2(void);
 void Demo_Text_FillAttrMem1(void);
 void Demo_Text_FillAttrMem2(void);
-void Demo_Text_FillBoxSlow1(void);
-void Demo_Text_FillBoxSlow2(void);
 void Demo_Text_FillBox1(void);
 void Demo_Text_FillBox2(void);
 void Demo_Text_FillBox3(void);
@@ -273,22 +271,6 @@ void Demo_Text_FillAttrMem2(void)
 }
 
 
-void Demo_Text_FillBoxSlow1(void)
-{
-	ShowDescription("Text_FillBoxSlow -> fill a square on screen with a checkered pattern, black on white (slow routine)");	
-	Text_FillBoxSlow(global_system->screen_[ID_CHANNEL_B], 0, 6, global_system->screen_[ID_CHANNEL_B]->text_cols_vis_ - 1, 35, CH_CHECKERED, COLOR_BLACK, BG_COLOR_BRIGHT_WHITE, CHAR_AND_ATTR);
-	WaitForUser();
-}
-
-
-void Demo_Text_FillBoxSlow2(void)
-{
-	ShowDescription("Text_FillBoxSlow -> fill a square on screen with a checkered pattern, blue on dark blue (slow routine)");	
-	Text_FillBoxSlow(global_system->screen_[ID_CHANNEL_B], 2, 9, global_system->screen_[ID_CHANNEL_B]->text_cols_vis_ - 1, 35, CH_CHECKERED, COLOR_BRIGHT_BLUE, COLOR_BLUE, CHAR_AND_ATTR);
-	WaitForUser();
-}
-
-
 void Demo_Text_FillBox1(void)
 {
 	int16_t		x1;
@@ -296,7 +278,7 @@ void Demo_Text_FillBox1(void)
 	int16_t		x2;
 	int16_t		y2;
 	
-	ShowDescription("Text_FillBox -> fill a square on screen with a checkered pattern, black on white (fast routine)");	
+	ShowDescription("Text_FillBox -> fill a square on screen with a checkered pattern, black on white");	
 
 	x1 = 0;
 	y1 = 8;
@@ -331,7 +313,7 @@ void Demo_Text_FillBox1(void)
 
 void Demo_Text_FillBox2(void)
 {
-	ShowDescription("Text_FillBox -> fill a square on screen with a checkered pattern, blue on dark blue (fast routine)");	
+	ShowDescription("Text_FillBox -> fill a square on screen with a checkered pattern, blue on dark blue");	
 	Text_FillBox(global_system->screen_[ID_CHANNEL_B], 6, 13, global_system->screen_[ID_CHANNEL_B]->text_cols_vis_ - 1, 39, CH_CHECKERED, COLOR_BRIGHT_BLUE, COLOR_BLUE);
 	WaitForUser();
 }
@@ -339,7 +321,7 @@ void Demo_Text_FillBox2(void)
 
 void Demo_Text_FillBox3(void)
 {
-	ShowDescription("Text_FillBox -> fill various squares with colors and characters (fast routine)");	
+	ShowDescription("Text_FillBox -> fill various squares with colors and characters");	
 	Text_FillBox(global_system->screen_[ID_CHANNEL_B], 0, 7, 3, 9, CH_RIGHT, COLOR_BRIGHT_GREEN, COLOR_BLUE);
 	Text_FillBox(global_system->screen_[ID_CHANNEL_B], 0, 10, 2, 12, CH_LEFT, COLOR_BRIGHT_RED, COLOR_BLUE);
 	Text_FillBox(global_system->screen_[ID_CHANNEL_B], 0, 13, 4, 16, CH_UP, COLOR_BRIGHT_MAGENTA, COLOR_BLUE);
@@ -1020,9 +1002,6 @@ void RunDemo(void)
 	Demo_Text_FillAttrMem1();
 	Demo_Text_FillAttrMem2();
 	
-	Demo_Text_FillBoxSlow1();
-	Demo_Text_FillBoxSlow2();
-	
 	Demo_Text_FillBox1();
 	Demo_Text_FillBox2();
 	Demo_Text_FillBox3();
@@ -0,0 +1,355 @@
+/*
+ * text_glyph_atlas.c
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+
+
+
+
+/*****************************************************************************/
+/*                                Includes                                   */
+/*****************************************************************************/
+
+// project includes
+#include "text_glyph_atlas.h"
+#include "text.h"
+
+// A2560 includes
+#include <mcp/syscalls.h>
+#include "lib_sys.h"
+#include "general.h"
+
+// C includes
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+
+/*****************************************************************************/
+/*                               Definitions                                 */
+/*****************************************************************************/
+
+
+
+/*****************************************************************************/
+/*                             Global Variables                              */
+/*****************************************************************************/
+
+extern System*			global_system;
+
+
+
+/*****************************************************************************/
+/*                       Private Function Prototypes                         */
+/*****************************************************************************/
+
+// find the slot holding the passed glyph, or -1 if it is not loaded
+int16_t TextGlyphAtlas_FindSlot(TextGlyphAtlas* the_atlas, uint16_t the_glyph_id);
+
+// pick the slot for a glyph that is not loaded: the first free slot, or if there are none, the least recently used one
+int16_t TextGlyphAtlas_GetFreeSlot(TextGlyphAtlas* the_atlas);
+
+// write glyph data to a slot's font memory, unless the slot already has exactly that data
+void TextGlyphAtlas_WriteSlot(TextGlyphAtlas* the_atlas, int16_t the_slot, char* the_glyph_data);
+
+
+
+/*****************************************************************************/
+/*                       Private Function Definitions                        */
+/*****************************************************************************/
+
+// find the slot holding the passed glyph, or -1 if it is not loaded
+int16_t TextGlyphAtlas_FindSlot(TextGlyphAtlas* the_atlas, uint16_t the_glyph_id)
+{
+	int16_t		i;
+
+	// LOGIC: there are at most TEXT_GLYPH_ATLAS_MAX_SLOTS slots, so a straight scan is cheaper than keeping a lookup table in step
+	for (i = 0; i < the_atlas->num_slots_; i++)
+	{
+		if (the_atlas->last_used_[i] != 0 && the_atlas->glyph_id_[i] == the_glyph_id)
+		{
+			return i;
+		}
+	}
+
+	return -1;
+}
+
+
+// pick the slot for a glyph that is not loaded: the first free slot, or if there are none, the least recently used one
+int16_t TextGlyphAtlas_GetFreeSlot(TextGlyphAtlas* the_atlas)
+{
+	int16_t		i;
+	int16_t		oldest_slot = 0;
+
+	for (i = 0; i < the_atlas->num_slots_; i++)
+	{
+		if (the_atlas->last_used_[i] == 0)
+		{
+			return i;
+		}
+
+		if (the_atlas->last_used_[i] < the_atlas->last_used_[oldest_slot])
+		{
+			oldest_slot = i;
+		}
+	}
+
+	the_atlas->evictions_++;
+
+	return oldest_slot;
+}
+
+
+// write glyph data to a slot's font memory, unless the slot already has exactly that data
+void TextGlyphAtlas_WriteSlot(TextGlyphAtlas* the_atlas, int16_t the_slot, char* the_glyph_data)
+{
+	if (the_atlas->is_written_[the_slot] && memcmp(the_atlas->glyph_data_[the_slot], the_glyph_data, the_atlas->glyph_bytes_) == 0)
+	{
+		return;
+	}
+
+	memcpy(the_atlas->glyph_data_[the_slot], the_glyph_data, the_atlas->glyph_bytes_);
+	the_atlas->is_written_[the_slot] = true;
+
+	Text_UpdateFontGlyph(the_atlas->screen_, the_atlas->first_char_ + the_slot, the_glyph_data);
+	the_atlas->uploads_++;
+}
+
+
+
+
+/*****************************************************************************/
+/*                        Public Function Definitions                        */
+/*****************************************************************************/
+
+
+
+// **** CONSTRUCTOR AND DESTRUCTOR *****
+
+
+// constructor
+//! Reserve a range of character codes in a text screen's font for glyphs loaded on demand
+//! Nothing is written to font memory until a glyph is asked for. The glyphs the font had in the range are not restored when the atlas is destroyed.
+//! @param	the_screen: valid pointer to the target screen to operate on
+//! @param	first_char: the first character code to reserve
+//! @param	num_slots: the number of character codes to reserve, from 1 to TEXT_GLYPH_ATLAS_MAX_SLOTS. first_char + num_slots must not be more than 256.
+//! @return	Returns NULL on any error/invalid input, or if memory could not be allocated
+TextGlyphAtlas* TextGlyphAtlas_New(Screen* the_screen, unsigned char first_char, int16_t num_slots)
+{
+	TextGlyphAtlas*		the_atlas = NULL;
+
+	if (the_screen == NULL)
+	{
+		LOG_ERR(("%s %d: passed screen was NULL", __func__, __LINE__));
+		goto error;
+	}
+
+	if (num_slots < 1 || num_slots > TEXT_GLYPH_ATLAS_MAX_SLOTS || first_char + num_slots > 256)
+	{
+		LOG_ERR(("%s %d: illegal character range (%u, %i slots)", __func__, __LINE__, first_char, num_slots));
+		goto error;
+	}
+
+	if (the_screen->text_font_height_ > TEXT_GLYPH_MAX_BYTES)
+	{
+		LOG_ERR(("%s %d: font height %i is not supported", __func__, __LINE__, the_screen->text_font_height_));
+		goto error;
+	}
+
+	if ( (the_atlas = (TextGlyphAtlas*)calloc(1, sizeof(TextGlyphAtlas)) ) == NULL)
+	{
+		LOG_ERR(("%s %d: could not allocate memory to create new TextGlyphAtlas object", __func__ , __LINE__));
+		goto error;
+	}
+	LOG_ALLOC(("%s %d:	__ALLOC__	the_atlas	%p	size	%i", __func__ , __LINE__, the_atlas, sizeof(TextGlyphAtlas)));
+
+	the_atlas->screen_ = the_screen;
+	the_atlas->first_char_ = first_char;
+	the_atlas->num_slots_ = num_slots;
+	the_atlas->glyph_bytes_ = the_screen->text_font_height_;
+
+	return the_atlas;
+
+error:
+	if (the_atlas)	TextGlyphAtlas_Destroy(&the_atlas);
+	return NULL;
+}
+
+
+// destructor
+// frees all allocated memory associated with the passed object, and the object itself
+void TextGlyphAtlas_Destroy(TextGlyphAtlas** the_atlas)
+{
+	if (*the_atlas == NULL)
+	{
+		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
+		return;
+	}
+
+	LOG_ALLOC(("%s %d:	__FREE__	*the_atlas	%p	size	%i", __func__ , __LINE__, *the_atlas, sizeof(TextGlyphAtlas)));
+	free(*the_atlas);
+	*the_atlas = NULL;
+}
+
+
+
+
+// **** SETTERS *****
+
+
+//! Forget which glyphs are loaded, freeing all the slots. Font memory is not changed.
+void TextGlyphAtlas_Reset(TextGlyphAtlas* the_atlas)
+{
+	if (the_atlas == NULL)
+	{
+		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
+		goto error;
+	}
+
+	// LOGIC: glyph_data_ still matches font memory, so it is kept: reloading the same glyphs later won't write them again
+	memset(the_atlas->last_used_, 0, sizeof(the_atlas->last_used_));
+	the_atlas->clock_ = 0;
+
+	return;
+
+error:
+	Sys_Destroy(&global_system);	// crash early, crash often
+}
+
+
+//! Free the slot holding a glyph, so it is the first to be reused
+//! @return	Returns false if the glyph was not loaded
+bool TextGlyphAtlas_Release(TextGlyphAtlas* the_atlas, uint16_t the_glyph_id)
+{
+	int16_t		the_slot;
+
+	if (the_atlas == NULL)
+	{
+		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
+		goto error;
+	}
+
+	the_slot = TextGlyphAtlas_FindSlot(the_atlas, the_glyph_id);
+
+	if (the_slot < 0)
+	{
+		return false;
+	}
+
+	the_atlas->last_used_[the_slot] = 0;
+
+	return true;
+
+error:
+	Sys_Destroy(&global_system);	// crash early, crash often
+	return false;
+}
+
+
+
+
+// **** GETTERS *****
+
+
+//! Find the character code for a glyph, without loading it or counting it as used
+//! @return	Returns the character code, or -1 if the glyph is not loaded
+int16_t TextGlyphAtlas_FindChar(TextGlyphAtlas* the_atlas, uint16_t the_glyph_id)
+{
+	int16_t		the_slot;
+
+	if (the_atlas == NULL)
+	{
+		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
+		goto error;
+	}
+
+	the_slot = TextGlyphAtlas_FindSlot(the_atlas, the_glyph_id);
+
+	if (the_slot < 0)
+	{
+		return -1;
+	}
+
+	return the_atlas->first_char_ + the_slot;
+
+error:
+	Sys_Destroy(&global_system);	// crash early, crash often
+	return -1;
+}
+
+
+
+
+// **** OTHER FUNCTIONS *****
+
+
+//! Get the character code to draw for a glyph, loading it into the atlas if needed
+//! If the glyph is not loaded, it goes in a free slot, or if there are none, in the least recently used slot. Any cells on screen still showing the glyph that was in that slot will change to the new one.
+//! If the glyph is loaded, but the_glyph_data has changed (an animated glyph, say), the new data is written over the old.
+//! Font memory is only written if the slot's glyph data actually changes.
+//! @param	the_glyph_id: the app's id for the glyph. Any value, as long as the app uses one id per glyph.
+//! @param	the_glyph_data: the screen's text_font_height_ bytes (8 or 16) of glyph data. Each byte represents one line of the glyph, high bit on the left.
+//! @return	Returns the character code (0-255), or -1 on any error
+int16_t TextGlyphAtlas_GetChar(TextGlyphAtlas* the_atlas, uint16_t the_glyph_id, char* the_glyph_data)
+{
+	int16_t		the_slot;
+
+	if (the_atlas == NULL)
+	{
+		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
+		goto error;
+	}
+
+	if (the_glyph_data == NULL)
+	{
+		LOG_ERR(("%s %d: passed glyph data was NULL", __func__, __LINE__));
+		return -1;
+	}
+
+	the_slot = TextGlyphAtlas_FindSlot(the_atlas, the_glyph_id);
+
+	if (the_slot < 0)
+	{
+		the_slot = TextGlyphAtlas_GetFreeSlot(the_atlas);
+		the_atlas->glyph_id_[the_slot] = the_glyph_id;
+	}
+	else
+	{
+		the_atlas->hits_++;
+	}
+
+	// LOGIC: clock_ starts at 0, and 0 means a free slot, so count before stamping
+	the_atlas->last_used_[the_slot] = ++the_atlas->clock_;
+
+	TextGlyphAtlas_WriteSlot(the_atlas, the_slot, the_glyph_data);
+
+	return the_atlas->first_char_ + the_slot;
+
+error:
+	Sys_Destroy(&global_system);	// crash early, crash often
+	return -1;
+}
+
+
+
+
+// **** Debug functions *****
+
+void TextGlyphAtlas_Print(TextGlyphAtlas* the_atlas)
+{
+	DEBUG_OUT(("TextGlyphAtlas print out:"));
+	DEBUG_OUT(("  address: %p", 			the_atlas));
+	DEBUG_OUT(("  screen_: %p", 			the_atlas->screen_));
+	DEBUG_OUT(("  first_char_: %u", 		the_atlas->first_char_));
+	DEBUG_OUT(("  num_slots_: %i", 			the_atlas->num_slots_));
+	DEBUG_OUT(("  glyph_bytes_: %i", 		the_atlas->glyph_bytes_));
+	DEBUG_OUT(("  clock_: %lu", 			the_atlas->clock_));
+	DEBUG_OUT(("  hits_: %lu", 				the_atlas->hits_));
+	DEBUG_OUT(("  uploads_: %lu", 			the_atlas->uploads_));
+	DEBUG_OUT(("  evictions_: %lu", 		the_atlas->evictions_));
+}
@@ -0,0 +1,138 @@
+//! @file text_glyph_atlas.h
+
+/*
+ * text_glyph_atlas.h
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#ifndef TEXT_GLYPH_ATLAS_H_
+#define TEXT_GLYPH_ATLAS_H_
+
+
+
+/* about this class: TextGlyphAtlas
+ *
+ * A set of character codes in a text screen's font reserved for an app's own glyphs (icons, progress bar segments, extra box-drawing pieces), loaded on demand
+ *
+ *** things this class needs to be able to do
+ * give the app a character code to draw for any of its glyphs, loading the glyph into a free reserved slot if it isn't already loaded
+ * when all the slots are in use, reuse the one that was least recently asked for, so an app can have more distinct glyphs than slots, as long as no more than that are on screen at once
+ * write only the glyphs that change to font memory, never the whole font
+ * skip the write entirely if the glyph already in the slot is identical
+ *
+ *** things objects of this class have
+ * a screen, and the first character code and number of character codes reserved on it
+ * for each slot: the app's id for the glyph in it, when it was last asked for, and a copy of the glyph data written to it
+ * counts of glyphs found already loaded, glyphs written to font memory, and slots reused
+ *
+ */
+
+
+/*****************************************************************************/
+/*                                Includes                                   */
+/*****************************************************************************/
+
+// project includes
+
+// C includes
+#include <stdbool.h>
+
+// A2560 includes
+#include "a2560_platform.h"
+
+
+/*****************************************************************************/
+/*                            Macro Definitions                              */
+/*****************************************************************************/
+
+#define TEXT_GLYPH_ATLAS_MAX_SLOTS	64	// most character codes one atlas can reserve
+#define TEXT_GLYPH_MAX_BYTES		16	// 8x16 font, as used by channel A on the A2560K. 8x8 fonts only use the first 8.
+
+
+/*****************************************************************************/
+/*                               Enumerations                                */
+/*****************************************************************************/
+
+
+/*****************************************************************************/
+/*                                 Structs                                   */
+/*****************************************************************************/
+
+struct TextGlyphAtlas
+{
+	Screen*			screen_;
+	uint8_t			first_char_;								// first character code reserved for the atlas
+	int16_t			num_slots_;									// number of character codes reserved, starting at first_char_
+	int16_t			glyph_bytes_;								// bytes per glyph: the screen's text_font_height_
+	uint32_t		clock_;										// counts lookups, so the slot with the lowest last_used_ is the least recently used
+	uint32_t		last_used_[TEXT_GLYPH_ATLAS_MAX_SLOTS];		// value of clock_ when the glyph in the slot was last asked for. 0 if the slot is free.
+	uint16_t		glyph_id_[TEXT_GLYPH_ATLAS_MAX_SLOTS];		// the app's id for the glyph in the slot
+	bool			is_written_[TEXT_GLYPH_ATLAS_MAX_SLOTS];	// true once the atlas has written a glyph to the slot, so glyph_data_ matches font memory
+	char			glyph_data_[TEXT_GLYPH_ATLAS_MAX_SLOTS][TEXT_GLYPH_MAX_BYTES];	// copy of the glyph last written to the slot's font memory
+	uint32_t		hits_;										// lookups that found the glyph already loaded
+	uint32_t		uploads_;									// glyphs written to font memory
+	uint32_t		evictions_;									// lookups that had to reuse a slot holding another glyph
+};
+
+
+/*****************************************************************************/
+/*                             Global Variables                              */
+/*****************************************************************************/
+
+
+/*****************************************************************************/
+/*                       Public Function Prototypes                          */
+/*****************************************************************************/
+
+// **** CONSTRUCTOR AND DESTRUCTOR *****
+
+// constructor
+//! Reserve a range of character codes in a text screen's font for glyphs loaded on demand
+//! Nothing is written to font memory until a glyph is asked for. The glyphs the font had in the range are not restored when the atlas is destroyed.
+//! @param	the_screen: valid pointer to the target screen to operate on
+//! @param	first_char: the first character code to reserve
+//! @param	num_slots: the number of character codes to reserve, from 1 to TEXT_GLYPH_ATLAS_MAX_SLOTS. first_char + num_slots must not be more than 256.
+//! @return	Returns NULL on any error/invalid input, or if memory could not be allocated
+TextGlyphAtlas* TextGlyphAtlas_New(Screen* the_screen, unsigned char first_char, int16_t num_slots);
+
+// destructor
+// frees all allocated memory associated with the passed object, and the object itself
+void TextGlyphAtlas_Destroy(TextGlyphAtlas** the_atlas);
+
+
+// **** SETTERS *****
+
+//! Forget which glyphs are loaded, freeing all the slots. Font memory is not changed.
+void TextGlyphAtlas_Reset(TextGlyphAtlas* the_atlas);
+
+//! Free the slot holding a glyph, so it is the first to be reused
+//! @return	Returns false if the glyph was not loaded
+bool TextGlyphAtlas_Release(TextGlyphAtlas* the_atlas, uint16_t the_glyph_id);
+
+
+// **** GETTERS *****
+
+//! Find the character code for a glyph, without loading it or counting it as used
+//! @return	Returns the character code, or -1 if the glyph is not loaded
+int16_t TextGlyphAtlas_FindChar(TextGlyphAtlas* the_atlas, uint16_t the_glyph_id);
+
+
+// **** OTHER FUNCTIONS *****
+
+//! Get the character code to draw for a glyph, loading it into the atlas if needed
+//! If the glyph is not loaded, it goes in a free slot, or if there are none, in the least recently used slot. Any cells on screen still showing the glyph that was in that slot will change to the new one.
+//! If the glyph is loaded, but the_glyph_data has changed (an animated glyph, say), the new data is written over the old.
+//! Font memory is only written if the slot's glyph data actually changes.
+//! @param	the_glyph_id: the app's id for the glyph. Any value, as long as the app uses one id per glyph.
+//! @param	the_glyph_data: the screen's text_font_height_ bytes (8 or 16) of glyph data. Each byte represents one line of the glyph, high bit on the left.
+//! @return	Returns the character code (0-255), or -1 on any error
+int16_t TextGlyphAtlas_GetChar(TextGlyphAtlas* the_atlas, uint16_t the_glyph_id, char* the_glyph_data);
+
+
+// **** Debug functions *****
+
+void TextGlyphAtlas_Print(TextGlyphAtlas* the_atlas);
+
+
+#endif /* TEXT_GLYPH_ATLAS_H_ */
@@ -18,12 +18,17 @@
 #include "minunit.h"
 
 // project includes
+#include "console.h"
+#include "terminal.h"
+#include "text_window.h"
+#include "text_glyph_atlas.h"
 
 // class being tested
 #include "text.h"
 
 // C includes
 #include <stdbool.h>
+#include <string.h>
 
 
 // A2560 includes
@@ -198,6 +203,224 @@ void text_test_teardown(void)	// this is called EVERY test
 
 
 
+MU_TEST(text_test_scroll_box)
+{
+	Screen*		the_screen = global_system->screen_[ID_CHANNEL_B];
+	
+	Text_FillBox(the_screen, 0, 10, 9, 13, CH_SPACE, FG_COLOR_BRIGHT_WHITE, BG_COLOR_BLUE);
+	Text_DrawStringAtXY(the_screen, 0, 10, "row 0", FG_COLOR_BRIGHT_WHITE, BG_COLOR_BLUE);
+	Text_DrawStringAtXY(the_screen, 0, 11, "row 1", FG_COLOR_BRIGHT_WHITE, BG_COLOR_BLUE);
+	Text_DrawStringAtXY(the_screen, 0, 12, "row 2", FG_COLOR_BRIGHT_WHITE, BG_COLOR_BLUE);
+	Text_DrawStringAtXY(the_screen, 0, 13, "row 3", FG_COLOR_BRIGHT_WHITE, BG_COLOR_BLUE);
+	
+	// scroll up: the top row goes away, and the bottom row is cleared
+	mu_assert( Text_ScrollBox(the_screen, 0, 10, 9, 13, 1, FG_COLOR_BRIGHT_WHITE, BG_COLOR_BLUE) == true, "Text_ScrollBox failed" );
+	mu_assert( Text_GetCharAtXY(the_screen, 4, 10) == '1', "Text_ScrollBox did not move row 1 up" );
+	mu_assert( Text_GetCharAtXY(the_screen, 4, 12) == '3', "Text_ScrollBox did not move row 3 up" );
+	mu_assert( Text_GetCharAtXY(the_screen, 4, 13) == CH_SPACE, "Text_ScrollBox did not clear the vacated row" );
+	
+	// scroll down by 2 (negative): the top 2 rows are cleared
+	mu_assert( Text_ScrollBox(the_screen, 0, 10, 9, 13, -2, FG_COLOR_BRIGHT_WHITE, BG_COLOR_BLUE) == true, "Text_ScrollBox failed" );
+	mu_assert( Text_GetCharAtXY(the_screen, 4, 11) == CH_SPACE, "Text_ScrollBox did not clear the vacated rows" );
+	mu_assert( Text_GetCharAtXY(the_screen, 4, 12) == '1', "Text_ScrollBox did not move row 1 down" );
+	mu_assert( Text_GetCharAtXY(the_screen, 4, 13) == '2', "Text_ScrollBox did not move row 2 down" );
+}
+
+
+MU_TEST(text_test_terminal)
+{
+	Screen*		the_screen = global_system->screen_[ID_CHANNEL_B];
+	Terminal*	the_terminal;
+	
+	the_terminal = Terminal_New(the_screen, 0, 10, 19, 14, FG_COLOR_WHITE, BG_COLOR_BLACK);
+	mu_assert( the_terminal != NULL, "Terminal_New failed" );
+	
+	// cursor positioning, and SGR colors mapped to the 16 text mode colors
+	Terminal_WriteString(the_terminal, "\x1b[2;3HA\x1b[1;31;44mB\x1b[0mC");
+	mu_assert( Text_GetCharAtXY(the_screen, 2, 11) == 'A', "Terminal did not position the cursor" );
+	mu_assert( Text_GetForeColorAtXY(the_screen, 3, 11) == COLOR_BRIGHT_RED, "Terminal did not set bold red" );
+	mu_assert( Text_GetBackColorAtXY(the_screen, 3, 11) == COLOR_BLUE, "Terminal did not set a blue background" );
+	mu_assert( Text_GetForeColorAtXY(the_screen, 4, 11) == COLOR_WHITE, "Terminal did not reset colors" );
+	
+	// an escape sequence split across writes, then erase to end of line
+	Terminal_WriteString(the_terminal, "\x1b[1");
+	Terminal_WriteString(the_terminal, "GX\x1b[K");
+	mu_assert( Text_GetCharAtXY(the_screen, 0, 11) == 'X', "Terminal did not handle a split escape sequence" );
+	mu_assert( Text_GetCharAtXY(the_screen, 2, 11) == CH_SPACE, "Terminal did not erase to end of line" );
+	
+	// line feed on the last row scrolls
+	Terminal_WriteString(the_terminal, "\x1b[5;1Hlast\nnew");
+	mu_assert( Text_GetCharAtXY(the_screen, 0, 13) == 'l', "Terminal did not scroll at the bottom" );
+	mu_assert( Text_GetCharAtXY(the_screen, 0, 14) == 'n', "Terminal did not start a new line at the bottom" );
+	
+	Terminal_Destroy(&the_terminal);
+}
+
+
+MU_TEST(text_test_text_window)
+{
+	Screen*			the_screen = global_system->screen_[ID_CHANNEL_B];
+	TextWindow*		lower;
+	TextWindow*		upper;
+	TextWindow*		narrow;
+	
+	Text_FillBox(the_screen, 0, 20, 39, 34, CH_CHECKERED, FG_COLOR_BRIGHT_WHITE, BG_COLOR_BLUE);
+	
+	lower = TextWindow_New(the_screen, 2, 21, 20, 28, FG_COLOR_BLACK, BG_COLOR_WHITE, "Lower");
+	upper = TextWindow_New(the_screen, 10, 24, 30, 32, FG_COLOR_BLACK, BG_COLOR_CYAN, "Upper");
+	mu_assert( lower != NULL && upper != NULL, "TextWindow_New failed" );
+	
+	mu_assert( TextWindow_Open(lower) == true, "TextWindow_Open failed" );
+	mu_assert( TextWindow_Open(upper) == true, "TextWindow_Open failed" );
+	mu_assert( TextWindow_FindAtXY(the_screen, 12, 25) == upper, "TextWindow_FindAtXY did not find the top window" );
+	
+	// drawing into the lower window must not draw over the upper one
+	TextWindow_DrawStringAtXY(lower, 0, 5, "lower window text", FG_COLOR_BLACK, BG_COLOR_WHITE);
+	mu_assert( Text_GetCharAtXY(the_screen, 3, 27) == 'l', "TextWindow_DrawStringAtXY did not draw the uncovered part" );
+	mu_assert( Text_GetCharAtXY(the_screen, 12, 27) == CH_SPACE, "TextWindow_DrawStringAtXY drew over the window above" );
+	
+	// closing the lower window first puts the background back only where it shows
+	mu_assert( TextWindow_Close(lower) == true, "TextWindow_Close failed" );
+	mu_assert( Text_GetCharAtXY(the_screen, 3, 27) == CH_CHECKERED, "TextWindow_Close did not restore the background" );
+	mu_assert( Text_GetCharAtXY(the_screen, 12, 27) == CH_SPACE, "TextWindow_Close drew over the window above" );
+	
+	// closing the upper window now shows the background, not the closed lower window
+	mu_assert( TextWindow_Close(upper) == true, "TextWindow_Close failed" );
+	mu_assert( Text_GetCharAtXY(the_screen, 12, 27) == CH_CHECKERED, "TextWindow_Close did not restore the background under both windows" );
+	mu_assert( the_screen->text_window_top_ == NULL, "TextWindow_Close left a window in the stack" );
+	
+	// a window at the minimum width has no room for its title, which must not spill past its frame
+	narrow = TextWindow_New(the_screen, 32, 21, 32 + TEXT_WINDOW_MIN_WIDTH - 1, 21 + TEXT_WINDOW_MIN_HEIGHT - 1, FG_COLOR_BLACK, BG_COLOR_WHITE, "A title far too long for the window");
+	mu_assert( narrow != NULL, "TextWindow_New failed at the minimum size" );
+	mu_assert( TextWindow_Open(narrow) == true, "TextWindow_Open failed" );
+	mu_assert( Text_GetCharAtXY(the_screen, 33, 21) != 'A', "TextWindow_Open drew the title over the frame" );
+	mu_assert( Text_GetCharAtXY(the_screen, 35, 21) == CH_CHECKERED, "TextWindow_Open drew the title past the window" );
+	mu_assert( TextWindow_Close(narrow) == true, "TextWindow_Close failed" );
+	mu_assert( Text_GetCharAtXY(the_screen, 33, 21) == CH_CHECKERED, "TextWindow_Close did not restore the background" );
+	
+	TextWindow_Destroy(&lower);
+	TextWindow_Destroy(&upper);
+	TextWindow_Destroy(&narrow);
+}
+
+
+MU_TEST(text_test_glyph_atlas)
+{
+	Screen*				the_screen = global_system->screen_[ID_CHANNEL_B];
+	TextGlyphAtlas*		the_atlas;
+	char				glyph_a[TEXT_GLYPH_MAX_BYTES] = {0x18, 0x3C, 0x7E, 0xFF, 0xFF, 0x7E, 0x3C, 0x18, 0x18, 0x3C, 0x7E, 0xFF, 0xFF, 0x7E, 0x3C, 0x18};
+	char				glyph_b[TEXT_GLYPH_MAX_BYTES] = {0xFF, 0x81, 0x81, 0x81, 0x81, 0x81, 0x81, 0xFF, 0xFF, 0x81, 0x81, 0x81, 0x81, 0x81, 0x81, 0xFF};
+	char				glyph_c[TEXT_GLYPH_MAX_BYTES] = {0xAA, 0x55, 0xAA, 0x55, 0xAA, 0x55, 0xAA, 0x55, 0xAA, 0x55, 0xAA, 0x55, 0xAA, 0x55, 0xAA, 0x55};
+	
+	// 2 slots, so the 3rd glyph has to reuse one
+	the_atlas = TextGlyphAtlas_New(the_screen, 0xF0, 2);
+	mu_assert( the_atlas != NULL, "TextGlyphAtlas_New failed" );
+	
+	mu_assert( TextGlyphAtlas_GetChar(the_atlas, 1, glyph_a) == 0xF0, "TextGlyphAtlas_GetChar did not use the first slot" );
+	mu_assert( TextGlyphAtlas_GetChar(the_atlas, 2, glyph_b) == 0xF1, "TextGlyphAtlas_GetChar did not use the second slot" );
+	mu_assert( TextGlyphAtlas_GetChar(the_atlas, 1, glyph_a) == 0xF0, "TextGlyphAtlas_GetChar did not find a loaded glyph" );
+	mu_assert( the_atlas->uploads_ == 2, "TextGlyphAtlas_GetChar wrote an unchanged glyph again" );
+	
+	// glyph 2 is now the least recently used
+	mu_assert( TextGlyphAtlas_GetChar(the_atlas, 3, glyph_c) == 0xF1, "TextGlyphAtlas_GetChar did not reuse the least recently used slot" );
+	mu_assert( TextGlyphAtlas_FindChar(the_atlas, 2) == -1, "TextGlyphAtlas_FindChar found a glyph that was replaced" );
+	mu_assert( TextGlyphAtlas_FindChar(the_atlas, 1) == 0xF0, "TextGlyphAtlas_FindChar lost a glyph" );
+	mu_assert( the_atlas->evictions_ == 1, "TextGlyphAtlas_GetChar did not count the reused slot" );
+	
+	// a freed slot is used before any loaded one is replaced
+	mu_assert( TextGlyphAtlas_Release(the_atlas, 1) == true, "TextGlyphAtlas_Release failed" );
+	mu_assert( TextGlyphAtlas_GetChar(the_atlas, 2, glyph_b) == 0xF0, "TextGlyphAtlas_GetChar did not use the freed slot" );
+	mu_assert( TextGlyphAtlas_FindChar(the_atlas, 3) == 0xF1, "TextGlyphAtlas_GetChar replaced a glyph when a slot was free" );
+	
+	Text_SetCharAtXY(the_screen, 0, 36, TextGlyphAtlas_FindChar(the_atlas, 2));
+	Text_SetCharAtXY(the_screen, 1, 36, TextGlyphAtlas_FindChar(the_atlas, 3));
+	
+	TextGlyphAtlas_Destroy(&the_atlas);
+	
+	// bad values
+	mu_assert( TextGlyphAtlas_New(the_screen, 0xF0, 17) == NULL, "TextGlyphAtlas_New accepted a range past character 255" );
+	mu_assert( TextGlyphAtlas_New(the_screen, 0, 0) == NULL, "TextGlyphAtlas_New accepted 0 slots" );
+	mu_assert( Text_UpdateFontGlyph(NULL, 0xF0, glyph_a) == false, "Text_UpdateFontGlyph accepted an illegal screen ID" );
+}
+
+
+MU_TEST(text_test_console_log_hook)
+{
+	Screen*			the_screen = global_system->screen_[ID_CHANNEL_B];
+	Console*		the_console;
+	uint32_t		first_line;
+	uint32_t		line_count;
+	
+	the_console = Console_New(the_screen, 42, 20, 71, 29, 20, FG_COLOR_BLACK, BG_COLOR_WHITE);
+	mu_assert( the_console != NULL, "Console_New failed" );
+	
+	// a logged message goes on a line of its own, after any line the console was part way through
+	Console_Write(the_console, "partial");
+	first_line = the_console->line_count_ - 1;
+	Console_SetLogConsole(the_console);
+	General_LogError("log hook %i", 1);
+	General_LogWarning("log hook %i", 2);
+	
+	mu_assert( strncmp(the_console->lines_ + (first_line % the_console->max_lines_) * the_console->width_, "partial ", 8) == 0, "the log hook wrote over the line in progress" );
+	mu_assert( strncmp(the_console->lines_ + ((first_line + 1) % the_console->max_lines_) * the_console->width_, "log hook 1 ", 11) == 0, "the log hook did not add the error" );
+	mu_assert( strncmp(the_console->lines_ + ((first_line + 2) % the_console->max_lines_) * the_console->width_, "log hook 2 ", 11) == 0, "the log hook did not add the warning" );
+	mu_assert( the_console->line_count_ == first_line + 4 && the_console->cursor_x_ == 0, "the log hook did not end its line" );
+	
+	Console_Render(the_console);
+	
+	// once the hook is removed, nothing more reaches the console
+	Console_SetLogConsole(NULL);
+	line_count = the_console->line_count_;
+	General_LogInfo("log hook %i", 3);
+	mu_assert( the_console->line_count_ == line_count, "a message was logged to the console after the hook was removed" );
+	
+	// destroying the log console removes the hook too, so logging afterwards is safe
+	Console_SetLogConsole(the_console);
+	Console_Destroy(&the_console);
+	mu_assert( the_console == NULL, "Console_Destroy did not clear the pointer" );
+	General_LogInfo("log hook %i", 4);
+}
+
+
+MU_TEST(text_test_shadow)
+{
+	Screen*		the_screen = global_system->screen_[ID_CHANNEL_B];
+	char*		the_vram;
+	uint32_t	bytes_flushed;
+	
+	mu_assert( Text_EnableShadow(the_screen) == true, "Text_EnableShadow failed" );
+	the_vram = the_screen->text_vram_;
+	mu_assert( the_vram != NULL && the_screen->text_ram_ != the_vram, "Text_EnableShadow did not redirect character memory" );
+	
+	// nothing drawn yet, so nothing to flush
+	mu_assert( Text_FlushShadow(the_screen) == 0, "Text_FlushShadow wrote to VRAM when nothing had been drawn" );
+	
+	// drawing goes to the shadow buffer only, until flushed
+	Text_DrawStringAtXY(the_screen, 0, 2, "xxxxxx", FG_COLOR_BRIGHT_WHITE, BG_COLOR_BLUE);
+	Text_FlushShadow(the_screen);
+	Text_DrawStringAtXY(the_screen, 0, 2, "shadow", FG_COLOR_BRIGHT_WHITE, BG_COLOR_BLUE);
+	mu_assert( Text_GetCharAtXY(the_screen, 0, 2) == 's', "Text_DrawStringAtXY did not draw to the shadow buffer" );
+	mu_assert( the_vram[the_screen->text_mem_cols_ * 2] == 'x', "Text_DrawStringAtXY drew to VRAM with a shadow buffer in use" );
+	
+	bytes_flushed = Text_FlushShadow(the_screen);
+	mu_assert( bytes_flushed > 0 && bytes_flushed < (uint32_t)(2 * the_screen->text_mem_cols_), "Text_FlushShadow did not limit the write to the changed span" );
+	mu_assert( the_vram[the_screen->text_mem_cols_ * 2] == 's', "Text_FlushShadow did not copy the changed row to VRAM" );
+	
+	// drawing the same thing again changes nothing on screen, so nothing should be written
+	Text_DrawStringAtXY(the_screen, 0, 2, "shadow", FG_COLOR_BRIGHT_WHITE, BG_COLOR_BLUE);
+	mu_assert( Text_FlushShadow(the_screen) == 0, "Text_FlushShadow wrote an unchanged row to VRAM" );
+	
+	// the dirty map covers every row of VRAM, not just the visible ones
+	Text_FillCharMem(the_screen, 'q');
+	Text_FlushShadow(the_screen);
+	mu_assert( the_vram[the_screen->text_mem_cols_ * the_screen->text_mem_rows_ - 1] == 'q', "Text_FlushShadow did not copy the last row of VRAM" );
+	
+	mu_assert( Text_DisableShadow(the_screen) == true, "Text_DisableShadow failed" );
+	mu_assert( the_screen->text_ram_ == the_vram && the_screen->text_shadow_ == NULL, "Text_DisableShadow did not restore character memory" );
+	mu_assert( Text_FlushShadow(the_screen) == 0, "Text_FlushShadow did something with no shadow buffer" );
+}
+
+
 MU_TEST(text_test_block_copy)
 {
 	char*	buffer1;
@@ -366,17 +589,17 @@ MU_TEST(text_test_fill_attr)
 MU_TEST(text_test_fill_box)
 {
 	// good values
-	mu_assert( Text_FillBoxSlow(global_system->screen_[ID_CHANNEL_A], 0, 6, 15, 8, CH_PATTERN_B0, COLOR_BLACK, BG_COLOR_BRIGHT_WHITE, CHAR_AND_ATTR) == true, "Text_FillBoxSlow failed" );
-	mu_assert( Text_FillBoxSlow(global_system->screen_[ID_CHANNEL_A], 21, 5, 39, 7, CH_CHECKERED, COLOR_RED, COLOR_BRIGHT_RED, CHAR_AND_ATTR) == true, "Text_FillBoxSlow failed" );
+	mu_assert( Text_FillBox(global_system->screen_[ID_CHANNEL_A], 0, 6, 15, 8, CH_PATTERN_B0, COLOR_BLACK, BG_COLOR_BRIGHT_WHITE) == true, "Text_FillBox failed" );
+	mu_assert( Text_FillBox(global_system->screen_[ID_CHANNEL_A], 21, 5, 39, 7, CH_CHECKERED, COLOR_RED, COLOR_BRIGHT_RED) == true, "Text_FillBox failed" );
 	mu_assert( Text_FillBox(global_system->screen_[ID_CHANNEL_A], 3, 6, 67, 50, CH_PATTERN_B2, COLOR_BRIGHT_GREEN, COLOR_GREEN) == true, "Text_FillBox failed" );
 	mu_assert( Text_FillBox(global_system->screen_[ID_CHANNEL_B], 21, 21, 40, 40, CH_PATTERN_B2, COLOR_BRIGHT_YELLOW, COLOR_YELLOW) == true, "Text_FillBox failed" );
 
 	// bad values
-	mu_assert( Text_FillBoxSlow(NULL, 0, 6, 15, 8, CH_PATTERN_B0, COLOR_BRIGHT_MAGENTA, COLOR_CYAN, CHAR_AND_ATTR) == false, "Text_FillBoxSlow accepted an illegal screen ID" );
-	mu_assert( Text_FillBox(global_system->screen_[ID_CHANNEL_B], -67, 6, 72, 30, CH_PATTERN_B2, COLOR_BRIGHT_BLUE, COLOR_BLUE) == false, "Text_FillBoxSlow accepted an illegal x coord" );
-	mu_assert( Text_FillBox(global_system->screen_[ID_CHANNEL_B], 32767, 6, 72, 30, CH_PATTERN_B2, COLOR_BRIGHT_BLUE, COLOR_BLUE) == false, "Text_FillBoxSlow accepted an illegal x coord" );
-	mu_assert( Text_FillBox(global_system->screen_[ID_CHANNEL_B], 5, -6, 72, 30, CH_PATTERN_B2, COLOR_BRIGHT_BLUE, COLOR_BLUE) == false, "Text_FillBoxSlow accepted an illegal y coord" );
-	mu_assert( Text_FillBox(global_system->screen_[ID_CHANNEL_B], 5, 6000, 72, 30, CH_PATTERN_B2, COLOR_BRIGHT_BLUE, COLOR_BLUE) == false, "Text_FillBoxSlow accepted an illegal y coord" );
+	mu_assert( Text_FillBox(NULL, 0, 6, 15, 8, CH_PATTERN_B0, COLOR_BRIGHT_MAGENTA, COLOR_CYAN) == false, "Text_FillBox accepted an illegal screen ID" );
+	mu_assert( Text_FillBox(global_system->screen_[ID_CHANNEL_B], -67, 6, 72, 30, CH_PATTERN_B2, COLOR_BRIGHT_BLUE, COLOR_BLUE) == false, "Text_FillBox accepted an illegal x coord" );
+	mu_assert( Text_FillBox(global_system->screen_[ID_CHANNEL_B], 32767, 6, 72, 30, CH_PATTERN_B2, COLOR_BRIGHT_BLUE, COLOR_BLUE) == false, "Text_FillBox accepted an illegal x coord" );
+	mu_assert( Text_FillBox(global_system->screen_[ID_CHANNEL_B], 5, -6, 72, 30, CH_PATTERN_B2, COLOR_BRIGHT_BLUE, COLOR_BLUE) == false, "Text_FillBox accepted an illegal y coord" );
+	mu_assert( Text_FillBox(global_system->screen_[ID_CHANNEL_B], 5, 6000, 72, 30, CH_PATTERN_B2, COLOR_BRIGHT_BLUE, COLOR_BLUE) == false, "Text_FillBox accepted an illegal y coord" );
 }
 
 
@@ -399,6 +622,29 @@ MU_TEST(text_test_invert_box)
 }
 
 
+MU_TEST(text_test_fore_back_only)
+{
+	Screen*		the_screen = global_system->screen_[ID_CHANNEL_B];
+	
+	// odd start and width, so the long-aligned middle and the leftover bytes at each end are all exercised
+	mu_assert( Text_FillBoxAttrOnly(the_screen, 3, 40, 40, 42, COLOR_WHITE, COLOR_BLUE), "Could not fill attributes of a box" );
+	
+	mu_assert( Text_FillBoxForeOnly(the_screen, 3, 40, 40, 42, COLOR_BRIGHT_YELLOW), "Could not change foreground color of a box" );
+	mu_assert( Text_GetForeColorAtXY(the_screen, 3, 40) == COLOR_BRIGHT_YELLOW && Text_GetBackColorAtXY(the_screen, 3, 40) == COLOR_BLUE, "Text_FillBoxForeOnly changed the wrong nibble" );
+	mu_assert( Text_GetForeColorAtXY(the_screen, 40, 42) == COLOR_BRIGHT_YELLOW && Text_GetBackColorAtXY(the_screen, 40, 42) == COLOR_BLUE, "Text_FillBoxForeOnly missed the end of the box" );
+	
+	mu_assert( Text_FillBoxBackOnly(the_screen, 3, 40, 40, 42, COLOR_RED), "Could not change background color of a box" );
+	mu_assert( Text_GetForeColorAtXY(the_screen, 20, 41) == COLOR_BRIGHT_YELLOW && Text_GetBackColorAtXY(the_screen, 20, 41) == COLOR_RED, "Text_FillBoxBackOnly changed the wrong nibble" );
+	
+	mu_assert( Text_InvertBox(the_screen, 3, 40, 40, 42), "Could not invert color of a box" );
+	mu_assert( Text_GetForeColorAtXY(the_screen, 4, 41) == COLOR_RED && Text_GetBackColorAtXY(the_screen, 4, 41) == COLOR_BRIGHT_YELLOW, "Text_InvertBox did not swap colors" );
+
+	// bad values
+	mu_assert( Text_FillBoxForeOnly(the_screen, 3, 40, 40, 42, 16) == false, "Text_FillBoxForeOnly accepted an illegal color" );
+	mu_assert( Text_FillBoxBackOnly(the_screen, 40, 40, 3, 42, COLOR_RED) == false, "Text_FillBoxBackOnly accepted illegal rect coordinates" );
+}
+
+
 MU_TEST(text_test_font_overwrite)
 {
 	mu_assert( Text_UpdateFontData(global_system->screen_[ID_CHANNEL_A], (char*)0x000000), "Could not replace font data for channel A" );
@@ -688,6 +934,32 @@ MU_TEST(text_test_fancy_box)
 }
 
 
+MU_TEST(text_test_line_clipping)
+{
+	Screen*		the_screen = global_system->screen_[ID_CHANNEL_B];
+	int16_t		max_x = the_screen->text_cols_vis_ - 1;
+	int16_t		max_y = the_screen->text_rows_vis_ - 1;
+	
+	// lines that run off the screen are clipped at the edge, not wrapped onto the next row or past the end of memory
+	mu_assert( Text_SetCharAtXY(the_screen, 0, 11, 'A'), "Could not set char" );
+	mu_assert( Text_DrawHLine(the_screen, max_x - 4, 10, 50, CH_WALL_H, FG_COLOR_WHITE, BG_COLOR_BLACK, CHAR_AND_ATTR) == true, "Text_DrawHLine failed" );
+	mu_assert( Text_GetCharAtXY(the_screen, max_x, 10) == CH_WALL_H, "Text_DrawHLine did not reach the right edge" );
+	mu_assert( Text_GetCharAtXY(the_screen, 0, 11) == 'A', "Text_DrawHLine wrapped onto the next row" );
+	mu_assert( Text_DrawVLine(the_screen, 5, max_y - 2, 50, CH_WALL_V, FG_COLOR_WHITE, BG_COLOR_BLACK, CHAR_ONLY) == true, "Text_DrawVLine failed" );
+	mu_assert( Text_GetCharAtXY(the_screen, 5, max_y) == CH_WALL_V, "Text_DrawVLine did not reach the bottom edge" );
+	
+	// fancy boxes as small as 1 row or 1 column still get their corner pieces
+	mu_assert( Text_DrawBoxCoordsFancy(the_screen, 10, 20, 11, 21, FG_COLOR_WHITE, BG_COLOR_BLUE) == true, "Text_DrawBoxCoordsFancy failed" );
+	mu_assert( Text_GetCharAtXY(the_screen, 10, 20) == CH_WALL_UL && Text_GetCharAtXY(the_screen, 11, 20) == CH_WALL_UR, "Text_DrawBoxCoordsFancy drew the wrong top corners" );
+	mu_assert( Text_GetCharAtXY(the_screen, 11, 21) == CH_WALL_LR && Text_GetCharAtXY(the_screen, 10, 21) == CH_WALL_LL, "Text_DrawBoxCoordsFancy drew the wrong bottom corners" );
+	mu_assert( Text_DrawBoxCoordsFancy(the_screen, 20, 20, 30, 20, FG_COLOR_WHITE, BG_COLOR_BLUE) == true, "Text_DrawBoxCoordsFancy failed on a 1 row box" );
+	mu_assert( Text_GetCharAtXY(the_screen, 25, 20) == CH_WALL_H, "Text_DrawBoxCoordsFancy drew the wrong side" );
+	
+	// bad values
+	mu_assert( Text_DrawBox(the_screen, 10, 10, 0, 5, CH_WALL_H, FG_COLOR_WHITE, BG_COLOR_BLACK, CHAR_AND_ATTR) == false, "Text_DrawBox accepted a zero width" );
+}
+
+
 MU_TEST(text_test_draw_string)
 {
 	char*	the_message;
@@ -884,6 +1156,7 @@ MU_TEST(text_test_hline_speed)
 	int16_t			i;
 	int16_t			num_passes = 90;
 	int16_t			j;
+	int16_t			dx;
 	int16_t			num_cycles = 10;
 
 	x = 1;
@@ -891,14 +1164,17 @@ MU_TEST(text_test_hline_speed)
 	line_len = 120;
 	the_char = CH_WALL_H;	
 	
-	// test speed of first variant
+	// test speed of first variant: one validated call per cell
 	start1 = mu_timer_real();
 	
 	for (j = 0; j < num_cycles; j++)
 	{
 		for (i=0; i < num_passes; i++)
 		{
-			mu_assert( Text_DrawHLineSlow(global_system->screen_[ID_CHANNEL_A], x, y + i, line_len, the_char, FG_COLOR_BRIGHT_GREEN, BG_COLOR_BLACK, CHAR_ONLY) == true, "Text_DrawHLine failed" );
+			for (dx = 0; dx < line_len; dx++)
+			{
+				Text_SetCharAtXY(global_system->screen_[ID_CHANNEL_A], x + dx, y + i, the_char);
+			}
 		}
 	}
 		
@@ -927,14 +1203,17 @@ MU_TEST(text_test_hline_speed)
 	line_len = 120;
 	the_char = CH_WALL_H;	
 	
-	// test speed of first variant
+	// test speed of first variant: one validated call per cell
 	start1 = mu_timer_real();
 	
 	for (j = 0; j < num_cycles; j++)
 	{
 		for (i=0; i < num_passes; i++)
 		{
-			mu_assert( Text_DrawHLineSlow(global_system->screen_[ID_CHANNEL_A], x, y + i, line_len, the_char, FG_COLOR_BRIGHT_GREEN, BG_COLOR_BLACK, CHAR_AND_ATTR) == true, "Text_DrawHLine failed" );
+			for (dx = 0; dx < line_len; dx++)
+			{
+				Text_SetCharAndColorAtXY(global_system->screen_[ID_CHANNEL_A], x + dx, y + i, the_char, FG_COLOR_BRIGHT_GREEN, BG_COLOR_BLACK);
+			}
 		}
 	}
 	
@@ -958,6 +1237,133 @@ MU_TEST(text_test_hline_speed)
 }
 
 
+MU_TEST(text_test_box_speed)
+{
+	long			start1;
+	long			end1;
+	long			start2;
+	long			end2;
+	int16_t			x1;
+	int16_t			y1;
+	int16_t			x2;
+	int16_t			y2;
+	int16_t			dx;
+	int16_t			dy;
+	int16_t			i;
+	int16_t			num_passes = 200;
+	Screen*			the_screen = global_system->screen_[ID_CHANNEL_A];
+
+	// nested fancy boxes, shrinking toward the middle of the screen, like a stack of dialogs
+	
+	// test speed of first variant: the sides and corners drawn one validated call per cell
+	start1 = mu_timer_real();
+	
+	for (i = 0; i < num_passes; i++)
+	{
+		for (x1 = 0, y1 = 0, x2 = the_screen->text_cols_vis_ - 1, y2 = the_screen->text_rows_vis_ - 1; x1 < x2 && y1 < y2; x1 += 2, y1 += 2, x2 -= 2, y2 -= 2)
+		{
+			for (dx = x1 + 1; dx < x2; dx++)
+			{
+				Text_SetCharAndColorAtXY(the_screen, dx, y1, CH_WALL_H, FG_COLOR_WHITE, BG_COLOR_BLUE);
+				Text_SetCharAndColorAtXY(the_screen, dx, y2, CH_WALL_H, FG_COLOR_WHITE, BG_COLOR_BLUE);
+			}
+			
+			for (dy = y1 + 1; dy < y2; dy++)
+			{
+				Text_SetCharAndColorAtXY(the_screen, x1, dy, CH_WALL_V, FG_COLOR_WHITE, BG_COLOR_BLUE);
+				Text_SetCharAndColorAtXY(the_screen, x2, dy, CH_WALL_V, FG_COLOR_WHITE, BG_COLOR_BLUE);
+			}
+			
+			Text_SetCharAndColorAtXY(the_screen, x1, y1, CH_WALL_UL, FG_COLOR_WHITE, BG_COLOR_BLUE);
+			Text_SetCharAndColorAtXY(the_screen, x2, y1, CH_WALL_UR, FG_COLOR_WHITE, BG_COLOR_BLUE);
+			Text_SetCharAndColorAtXY(the_screen, x2, y2, CH_WALL_LR, FG_COLOR_WHITE, BG_COLOR_BLUE);
+			Text_SetCharAndColorAtXY(the_screen, x1, y2, CH_WALL_LL, FG_COLOR_WHITE, BG_COLOR_BLUE);
+		}
+	}
+	
+	end1 = mu_timer_real();
+	
+	// test speed of second variant: one validation per box, and a run per side
+	start2 = mu_timer_real();
+	
+	for (i = 0; i < num_passes; i++)
+	{
+		for (x1 = 0, y1 = 0, x2 = the_screen->text_cols_vis_ - 1, y2 = the_screen->text_rows_vis_ - 1; x1 < x2 && y1 < y2; x1 += 2, y1 += 2, x2 -= 2, y2 -= 2)
+		{
+			mu_assert( Text_DrawBoxCoordsFancy(the_screen, x1, y1, x2, y2, FG_COLOR_BRIGHT_WHITE, BG_COLOR_BLUE) == true, "Text_DrawBoxCoordsFancy failed" );
+		}
+	}
+	
+	end2 = mu_timer_real();
+	
+	printf("\nSpeed results: first routine completed in %li ticks; second in %li ticks\n", end1 - start1, end2 - start2);
+	
+	// run again, with vertical lines only, which can't use memset
+	
+	// test speed of first variant
+	start1 = mu_timer_real();
+	
+	for (i = 0; i < num_passes; i++)
+	{
+		for (dx = 0; dx < the_screen->text_cols_vis_; dx++)
+		{
+			for (dy = 0; dy < the_screen->text_rows_vis_; dy++)
+			{
+				Text_SetCharAndColorAtXY(the_screen, dx, dy, CH_WALL_V, FG_COLOR_BRIGHT_GREEN, BG_COLOR_BLACK);
+			}
+		}
+	}
+	
+	end1 = mu_timer_real();
+	
+	// test speed of second variant
+	start2 = mu_timer_real();
+	
+	for (i = 0; i < num_passes; i++)
+	{
+		for (dx = 0; dx < the_screen->text_cols_vis_; dx++)
+		{
+			mu_assert( Text_DrawVLine(the_screen, dx, 0, the_screen->text_rows_vis_, CH_WALL_V, FG_COLOR_BRIGHT_RED, BG_COLOR_BLACK, CHAR_AND_ATTR) == true, "Text_DrawVLine failed" );
+		}
+	}
+	
+	end2 = mu_timer_real();
+	
+	printf("\nSpeed results: first routine completed in %li ticks; second in %li ticks\n", end1 - start1, end2 - start2);
+}
+
+
+MU_TEST(text_test_terminal_speed)
+{
+	long			start1;
+	long			end1;
+	Terminal*		the_terminal;
+	char			the_line[128];
+	int16_t			i;
+	int16_t			num_lines = 2000;
+	uint32_t		num_chars = 0;
+
+	the_terminal = Terminal_New(global_system->screen_[ID_CHANNEL_A], 0, 0, global_system->screen_[ID_CHANNEL_A]->text_cols_vis_ - 1, global_system->screen_[ID_CHANNEL_A]->text_rows_vis_ - 1, FG_COLOR_WHITE, BG_COLOR_BLACK);
+	mu_assert( the_terminal != NULL, "Terminal_New failed" );
+
+	// a log dump: mostly plain text, with a colored level tag on each line, and a line feed that scrolls the whole screen
+	start1 = mu_timer_real();
+	
+	for (i = 0; i < num_lines; i++)
+	{
+		sprintf(the_line, "\x1b[%im[%05i]\x1b[0m mount: /dev/sd%c%i mounted read-write, %i blocks free, no errors found\n", 31 + (i % 6), i, 'a' + (i % 4), i % 8, i * 7);
+		Terminal_WriteString(the_terminal, the_line);
+		num_chars += strlen(the_line);
+	}
+		
+	end1 = mu_timer_real();
+	
+	printf("\nSpeed results: terminal processed %lu chars in %li ticks (%lu chars/sec); %lu row writes\n", num_chars, end1 - start1, Terminal_GetCharsPerSecond(the_terminal), the_terminal->runs_drawn_);
+	
+	Terminal_Destroy(&the_terminal);
+}
+
+
 
 	// speed tests
 MU_TEST_SUITE(text_test_suite_speed)
@@ -965,6 +1371,8 @@ MU_TEST_SUITE(text_test_suite_speed)
 	MU_SUITE_CONFIGURE(&text_test_setup, &text_test_teardown);
 	
 	MU_RUN_TEST(text_test_hline_speed);
+	MU_RUN_TEST(text_test_box_speed);
+	MU_RUN_TEST(text_test_terminal_speed);
 }
 
 
@@ -993,14 +1401,23 @@ MU_TEST_SUITE(text_test_suite_units)
 	MU_RUN_TEST(text_test_basic_box_coords);
 	MU_RUN_TEST(text_test_basic_box_hw);
 	MU_RUN_TEST(text_test_fancy_box);
+	MU_RUN_TEST(text_test_line_clipping);
 	
 	MU_RUN_TEST(text_test_draw_string);
 	MU_RUN_TEST(text_test_draw_string_in_box);
 
 	MU_RUN_TEST(text_test_invert_box);
+	MU_RUN_TEST(text_test_fore_back_only);
 	
 	MU_RUN_TEST(text_test_block_copy);
 	
+	MU_RUN_TEST(text_test_shadow);
+	MU_RUN_TEST(text_test_scroll_box);
+	MU_RUN_TEST(text_test_terminal);
+	MU_RUN_TEST(text_test_text_window);
+	MU_RUN_TEST(text_test_glyph_atlas);
+	MU_RUN_TEST(text_test_console_log_hook);
+	
 	MU_RUN_TEST(font_replace_test);
 }
 
@@ -0,0 +1,573 @@
+/*
+ * text_window.c
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+
+
+
+
+/*****************************************************************************/
+/*                                Includes                                   */
+/*****************************************************************************/
+
+// project includes
+#include "text_window.h"
+#include "text.h"
+
+// A2560 includes
+#include <mcp/syscalls.h>
+#include "lib_sys.h"
+#include "general.h"
+
+// C includes
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+
+/*****************************************************************************/
+/*                               Definitions                                 */
+/*****************************************************************************/
+
+
+
+/*****************************************************************************/
+/*                             Global Variables                              */
+/*****************************************************************************/
+
+extern System*			global_system;
+
+
+
+/*****************************************************************************/
+/*                       Private Function Prototypes                         */
+/*****************************************************************************/
+
+// put cells x1 to x2 of row y wherever they currently show: in the save-under buffer of the lowest window, from the_window up, that covers them, or on the screen
+// if the_attrs is NULL, every cell gets the_attribute_value, and the_chars is the run of chars to draw.
+// otherwise, the_chars and the_attrs point at cell (x1, y) of buffers in screen memory layout, such as another window's save-under buffers.
+void TextWindow_PutCells(Screen* the_screen, TextWindow* the_window, int16_t x1, int16_t x2, int16_t y, char* the_chars, char* the_attrs, uint8_t the_attribute_value);
+
+// clip a string to x1..x2 of row y, and put it with TextWindow_PutCells()
+bool TextWindow_PutString(Screen* the_screen, TextWindow* the_window, int16_t x, int16_t y, int16_t clip_x1, int16_t clip_x2, char* the_string, uint8_t fore_color, uint8_t back_color);
+
+// find the bottom of the stack of open windows on the passed screen
+TextWindow* TextWindow_GetBottom(Screen* the_screen);
+
+
+
+/*****************************************************************************/
+/*                       Private Function Definitions                        */
+/*****************************************************************************/
+
+// put cells x1 to x2 of row y wherever they currently show: in the save-under buffer of the lowest window, from the_window up, that covers them, or on the screen
+// if the_attrs is NULL, every cell gets the_attribute_value, and the_chars is the run of chars to draw.
+// otherwise, the_chars and the_attrs point at cell (x1, y) of buffers in screen memory layout, such as another window's save-under buffers.
+void TextWindow_PutCells(Screen* the_screen, TextWindow* the_window, int16_t x1, int16_t x2, int16_t y, char* the_chars, char* the_attrs, uint8_t the_attribute_value)
+{
+	int16_t		covered_x1;
+	int16_t		covered_x2;
+	int32_t		the_offset;
+
+	// LOGIC:
+	//   a window's save-under buffer holds whatever would be on screen if it weren't there, so a cell drawn beneath it goes there instead of to the screen
+	//   if several windows cover a cell, it goes to the lowest of them: the ones above it have that window's content in their buffers, not this
+	while (the_window != NULL && (y < the_window->y1_ || y > the_window->y2_ || x2 < the_window->x1_ || x1 > the_window->x2_))
+	{
+		the_window = the_window->above_;
+	}
+
+	if (the_window == NULL)
+	{
+		if (the_attrs == NULL)
+		{
+			Text_DrawCharsAtXY(the_screen, x1, y, the_chars, x2 - x1 + 1, the_attribute_value >> 4, the_attribute_value & 0x0F);
+		}
+		else
+		{
+			the_offset = (int32_t)the_screen->text_mem_cols_ * y + x1;
+			Text_CopyMemBox(the_screen, the_chars - the_offset, x1, y, x2, y, SCREEN_COPY_TO_SCREEN, SCREEN_FOR_TEXT_CHAR);
+			Text_CopyMemBox(the_screen, the_attrs - the_offset, x1, y, x2, y, SCREEN_COPY_TO_SCREEN, SCREEN_FOR_TEXT_ATTR);
+		}
+
+		return;
+	}
+
+	covered_x1 = (x1 > the_window->x1_) ? x1 : the_window->x1_;
+	covered_x2 = (x2 < the_window->x2_) ? x2 : the_window->x2_;
+
+	// the parts to either side of this window can only be covered by windows above it
+	if (x1 < covered_x1)
+	{
+		TextWindow_PutCells(the_screen, the_window->above_, x1, covered_x1 - 1, y, the_chars, the_attrs, the_attribute_value);
+	}
+
+	if (x2 > covered_x2)
+	{
+		TextWindow_PutCells(the_screen, the_window->above_, covered_x2 + 1, x2, y, the_chars + (covered_x2 + 1 - x1), (the_attrs == NULL) ? NULL : the_attrs + (covered_x2 + 1 - x1), the_attribute_value);
+	}
+
+	the_offset = (int32_t)the_screen->text_mem_cols_ * y + covered_x1;
+	memcpy(the_window->save_chars_ + the_offset, the_chars + (covered_x1 - x1), covered_x2 - covered_x1 + 1);
+
+	if (the_attrs == NULL)
+	{
+		memset(the_window->save_attrs_ + the_offset, the_attribute_value, covered_x2 - covered_x1 + 1);
+	}
+	else
+	{
+		memcpy(the_window->save_attrs_ + the_offset, the_attrs + (covered_x1 - x1), covered_x2 - covered_x1 + 1);
+	}
+}
+
+
+// clip a string to x1..x2 of row y, and put it with TextWindow_PutCells()
+bool TextWindow_PutString(Screen* the_screen, TextWindow* the_window, int16_t x, int16_t y, int16_t clip_x1, int16_t clip_x2, char* the_string, uint8_t fore_color, uint8_t back_color)
+{
+	int16_t		draw_len;
+
+	if (fore_color > 15 || back_color > 15)
+	{
+		LOG_ERR(("%s %d: illegal color (%u, %u)", __func__, __LINE__, fore_color, back_color));
+		return false;
+	}
+
+	if (y < 0 || y >= the_screen->text_rows_vis_)
+	{
+		return true;
+	}
+
+	if (x < clip_x1)
+	{
+		draw_len = General_Strnlen(the_string, clip_x1 - x);
+
+		if (draw_len < clip_x1 - x)
+		{
+			return true;
+		}
+
+		the_string += draw_len;
+		x = clip_x1;
+	}
+
+	if (x > clip_x2)
+	{
+		return true;
+	}
+
+	draw_len = General_Strnlen(the_string, clip_x2 - x + 1);
+
+	if (draw_len > 0)
+	{
+		TextWindow_PutCells(the_screen, the_window, x, x + draw_len - 1, y, the_string, NULL, (fore_color << 4) | back_color);
+	}
+
+	return true;
+}
+
+
+// find the bottom of the stack of open windows on the passed screen
+TextWindow* TextWindow_GetBottom(Screen* the_screen)
+{
+	TextWindow*		the_window = the_screen->text_window_top_;
+
+	while (the_window != NULL && the_window->below_ != NULL)
+	{
+		the_window = the_window->below_;
+	}
+
+	return the_window;
+}
+
+
+
+
+/*****************************************************************************/
+/*                        Public Function Definitions                        */
+/*****************************************************************************/
+
+
+
+// **** CONSTRUCTOR AND DESTRUCTOR *****
+
+
+// constructor
+//! Allocate a text window and its save-under buffers. The window is not shown until TextWindow_Open() is called.
+//! The save-under buffers are sized for the screen's current text memory: close any windows before changing screen resolution.
+//! @param	the_screen: valid pointer to the target screen to operate on
+//! @param	x1: the leftmost horizontal position of the frame, between 0 and the screen's text_cols_vis_ - 1
+//! @param	y1: the uppermost vertical position of the frame, between 0 and the screen's text_rows_vis_ - 1
+//! @param	x2: the rightmost horizontal position of the frame, between 0 and the screen's text_cols_vis_ - 1
+//! @param	y2: the lowermost vertical position of the frame, between 0 and the screen's text_rows_vis_ - 1
+//! @param	fore_color: Index to the foreground color (0-15) for the frame and content
+//! @param	back_color: Index to the background color (0-15) for the frame and content
+//! @param	the_title: optional string to show in the top of the frame. No copy is made. Pass NULL for no title.
+//! @return	Returns NULL on any error/invalid input, or if memory could not be allocated
+TextWindow* TextWindow_New(Screen* the_screen, int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint8_t fore_color, uint8_t back_color, char* the_title)
+{
+	TextWindow*		the_window = NULL;
+	uint32_t		the_buffer_size;
+
+	if (the_screen == NULL)
+	{
+		LOG_ERR(("%s %d: passed screen was NULL", __func__, __LINE__));
+		goto error;
+	}
+
+	if (x1 < 0 || y1 < 0 || x2 - x1 + 1 < TEXT_WINDOW_MIN_WIDTH || y2 - y1 + 1 < TEXT_WINDOW_MIN_HEIGHT || x2 >= the_screen->text_cols_vis_ || y2 >= the_screen->text_rows_vis_)
+	{
+		LOG_ERR(("%s %d: illegal coordinates (%i, %i) - (%i, %i)", __func__, __LINE__, x1, y1, x2, y2));
+		goto error;
+	}
+
+	if (fore_color > 15 || back_color > 15)
+	{
+		LOG_ERR(("%s %d: illegal color (%u, %u)", __func__, __LINE__, fore_color, back_color));
+		goto error;
+	}
+
+	if ( (the_window = (TextWindow*)calloc(1, sizeof(TextWindow)) ) == NULL)
+	{
+		LOG_ERR(("%s %d: could not allocate memory to create new TextWindow object", __func__ , __LINE__));
+		goto error;
+	}
+	LOG_ALLOC(("%s %d:	__ALLOC__	the_window	%p	size	%i", __func__ , __LINE__, the_window, sizeof(TextWindow)));
+
+	// LOGIC:
+	//   the save-under buffers use the same layout as screen memory, as Text_CopyMemBox() expects.
+	//   that makes them as big as the screen, but any window can find the cell for any (x, y) in any other window's buffer without translation.
+	the_buffer_size = (uint32_t)the_screen->text_mem_cols_ * the_screen->text_mem_rows_;
+
+	if ( (the_window->save_chars_ = (char*)calloc(the_buffer_size, sizeof(char)) ) == NULL)
+	{
+		LOG_ERR(("%s %d: could not allocate memory for the save-under buffer", __func__ , __LINE__));
+		goto error;
+	}
+	LOG_ALLOC(("%s %d:	__ALLOC__	the_window->save_chars_	%p	size	%lu", __func__ , __LINE__, the_window->save_chars_, the_buffer_size));
+
+	if ( (the_window->save_attrs_ = (char*)calloc(the_buffer_size, sizeof(char)) ) == NULL)
+	{
+		LOG_ERR(("%s %d: could not allocate memory for the save-under buffer", __func__ , __LINE__));
+		goto error;
+	}
+	LOG_ALLOC(("%s %d:	__ALLOC__	the_window->save_attrs_	%p	size	%lu", __func__ , __LINE__, the_window->save_attrs_, the_buffer_size));
+
+	the_window->screen_ = the_screen;
+	the_window->x1_ = x1;
+	the_window->y1_ = y1;
+	the_window->x2_ = x2;
+	the_window->y2_ = y2;
+	the_window->fore_color_ = fore_color;
+	the_window->back_color_ = back_color;
+	the_window->title_ = the_title;
+
+	return the_window;
+
+error:
+	if (the_window)	TextWindow_Destroy(&the_window);
+	return NULL;
+}
+
+
+// destructor
+// closes the window if it is open, then frees all allocated memory associated with the passed object, and the object itself
+void TextWindow_Destroy(TextWindow** the_window)
+{
+	if (*the_window == NULL)
+	{
+		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
+		return;
+	}
+
+	if ((*the_window)->is_open_)
+	{
+		TextWindow_Close(*the_window);
+	}
+
+	if ((*the_window)->save_chars_)
+	{
+		LOG_ALLOC(("%s %d:	__FREE__	(*the_window)->save_chars_	%p", __func__ , __LINE__, (*the_window)->save_chars_));
+		free((*the_window)->save_chars_);
+		(*the_window)->save_chars_ = NULL;
+	}
+
+	if ((*the_window)->save_attrs_)
+	{
+		LOG_ALLOC(("%s %d:	__FREE__	(*the_window)->save_attrs_	%p", __func__ , __LINE__, (*the_window)->save_attrs_));
+		free((*the_window)->save_attrs_);
+		(*the_window)->save_attrs_ = NULL;
+	}
+
+	LOG_ALLOC(("%s %d:	__FREE__	*the_window	%p	size	%i", __func__ , __LINE__, *the_window, sizeof(TextWindow)));
+	free(*the_window);
+	*the_window = NULL;
+}
+
+
+
+
+// **** SETTERS *****
+
+
+//! Save what is under the window, put the window on top of any other open windows, and draw its frame and cleared content area
+//! @return	Returns false if the window was already open, or on any error
+bool TextWindow_Open(TextWindow* the_window)
+{
+	Screen*		the_screen;
+	int16_t		title_len;
+
+	if (the_window == NULL)
+	{
+		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
+		goto error;
+	}
+
+	if (the_window->is_open_)
+	{
+		return false;
+	}
+
+	the_screen = the_window->screen_;
+
+	// save-under: one box copy each for chars and attrs
+	if (!Text_CopyMemBox(the_screen, the_window->save_chars_, the_window->x1_, the_window->y1_, the_window->x2_, the_window->y2_, SCREEN_COPY_FROM_SCREEN, SCREEN_FOR_TEXT_CHAR))
+	{
+		return false;
+	}
+
+	Text_CopyMemBox(the_screen, the_window->save_attrs_, the_window->x1_, the_window->y1_, the_window->x2_, the_window->y2_, SCREEN_COPY_FROM_SCREEN, SCREEN_FOR_TEXT_ATTR);
+
+	// put it on top of the stack
+	the_window->below_ = the_screen->text_window_top_;
+	the_window->above_ = NULL;
+
+	if (the_window->below_ != NULL)
+	{
+		the_window->below_->above_ = the_window;
+	}
+
+	the_screen->text_window_top_ = the_window;
+	the_window->is_open_ = true;
+
+	// LOGIC: it is on top, so nothing can be covering it, and it can draw straight to the screen
+	Text_FillBox(the_screen, the_window->x1_ + 1, the_window->y1_ + 1, the_window->x2_ - 1, the_window->y2_ - 1, CH_SPACE, the_window->fore_color_, the_window->back_color_);
+	Text_DrawBoxCoordsFancy(the_screen, the_window->x1_, the_window->y1_, the_window->x2_, the_window->y2_, the_window->fore_color_, the_window->back_color_);
+
+	// LOGIC: the title needs a corner and a line segment at each end of the title bar, so a window of 4 columns or less has no room for it
+	if (the_window->title_ != NULL && the_window->x2_ - the_window->x1_ > 3)
+	{
+		title_len = General_Strnlen(the_window->title_, the_window->x2_ - the_window->x1_ - 3);
+		Text_DrawCharsAtXY(the_screen, the_window->x1_ + 2, the_window->y1_, the_window->title_, title_len, the_window->fore_color_, the_window->back_color_);
+	}
+
+	return true;
+
+error:
+	Sys_Destroy(&global_system);	// crash early, crash often
+	return false;
+}
+
+
+//! Put back what was under the window, and take it out of the stack of open windows
+//! If the window is on top, this is one box copy each for chars and attrs. If it is partly covered, only the parts not covered are drawn to the screen; the rest goes to the save-under buffers of the windows covering them.
+//! @return	Returns false if the window was not open, or on any error
+bool TextWindow_Close(TextWindow* the_window)
+{
+	Screen*		the_screen;
+	int16_t		y;
+	int32_t		the_offset;
+
+	if (the_window == NULL)
+	{
+		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
+		goto error;
+	}
+
+	if (!the_window->is_open_)
+	{
+		return false;
+	}
+
+	the_screen = the_window->screen_;
+
+	if (the_window->above_ == NULL)
+	{
+		Text_CopyMemBox(the_screen, the_window->save_chars_, the_window->x1_, the_window->y1_, the_window->x2_, the_window->y2_, SCREEN_COPY_TO_SCREEN, SCREEN_FOR_TEXT_CHAR);
+		Text_CopyMemBox(the_screen, the_window->save_attrs_, the_window->x1_, the_window->y1_, the_window->x2_, the_window->y2_, SCREEN_COPY_TO_SCREEN, SCREEN_FOR_TEXT_ATTR);
+	}
+	else
+	{
+		// LOGIC: what was under this window now belongs wherever this window showed: the screen, or the windows above covering it
+		for (y = the_window->y1_; y <= the_window->y2_; y++)
+		{
+			the_offset = (int32_t)the_screen->text_mem_cols_ * y + the_window->x1_;
+			TextWindow_PutCells(the_screen, the_window->above_, the_window->x1_, the_window->x2_, y, the_window->save_chars_ + the_offset, the_window->save_attrs_ + the_offset, 0);
+		}
+	}
+
+	// take it out of the stack
+	if (the_window->above_ != NULL)
+	{
+		the_window->above_->below_ = the_window->below_;
+	}
+	else
+	{
+		the_screen->text_window_top_ = the_window->below_;
+	}
+
+	if (the_window->below_ != NULL)
+	{
+		the_window->below_->above_ = the_window->above_;
+	}
+
+	the_window->above_ = NULL;
+	the_window->below_ = NULL;
+	the_window->is_open_ = false;
+
+	return true;
+
+error:
+	Sys_Destroy(&global_system);	// crash early, crash often
+	return false;
+}
+
+
+
+
+// **** GETTERS *****
+
+
+//! Find the topmost open text window covering the passed screen coordinates
+//! @return	Returns NULL if no open window covers that spot
+TextWindow* TextWindow_FindAtXY(Screen* the_screen, int16_t x, int16_t y)
+{
+	TextWindow*		the_window;
+
+	if (the_screen == NULL)
+	{
+		LOG_ERR(("%s %d: passed screen was NULL", __func__, __LINE__));
+		return NULL;
+	}
+
+	for (the_window = the_screen->text_window_top_; the_window != NULL; the_window = the_window->below_)
+	{
+		if (x >= the_window->x1_ && x <= the_window->x2_ && y >= the_window->y1_ && y <= the_window->y2_)
+		{
+			return the_window;
+		}
+	}
+
+	return NULL;
+}
+
+
+
+
+// **** OTHER FUNCTIONS *****
+
+
+//! Draw a string inside the window's frame, at coordinates relative to the top left of the content area
+//! Parts covered by other windows are not drawn to the screen, but will appear when those windows close. The string is clipped to the content area.
+//! @return	Returns false if the window is not open, or on any error
+bool TextWindow_DrawStringAtXY(TextWindow* the_window, int16_t x, int16_t y, char* the_string, uint8_t fore_color, uint8_t back_color)
+{
+	if (the_window == NULL)
+	{
+		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
+		goto error;
+	}
+
+	if (!the_window->is_open_)
+	{
+		return false;
+	}
+
+	// LOGIC: rows outside the content area are clipped, the same as columns
+	if (y < 0 || the_window->y1_ + 1 + y >= the_window->y2_)
+	{
+		return true;
+	}
+
+	return TextWindow_PutString(the_window->screen_, the_window->above_, the_window->x1_ + 1 + x, the_window->y1_ + 1 + y, the_window->x1_ + 1, the_window->x2_ - 1, the_string, fore_color, back_color);
+
+error:
+	Sys_Destroy(&global_system);	// crash early, crash often
+	return false;
+}
+
+
+//! Clear the window's content area to its background color
+//! @return	Returns false if the window is not open, or on any error
+bool TextWindow_ClearContent(TextWindow* the_window)
+{
+	char		the_spaces[TEXT_COL_COUNT_FOR_PLOTTING];
+	int16_t		y;
+
+	if (the_window == NULL)
+	{
+		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
+		goto error;
+	}
+
+	if (!the_window->is_open_)
+	{
+		return false;
+	}
+
+	if (the_window->above_ == NULL)
+	{
+		return Text_FillBox(the_window->screen_, the_window->x1_ + 1, the_window->y1_ + 1, the_window->x2_ - 1, the_window->y2_ - 1, CH_SPACE, the_window->fore_color_, the_window->back_color_);
+	}
+
+	memset(the_spaces, CH_SPACE, sizeof(the_spaces));
+
+	for (y = the_window->y1_ + 1; y < the_window->y2_; y++)
+	{
+		TextWindow_PutCells(the_window->screen_, the_window->above_, the_window->x1_ + 1, the_window->x2_ - 1, y, the_spaces, NULL, (the_window->fore_color_ << 4) | the_window->back_color_);
+	}
+
+	return true;
+
+error:
+	Sys_Destroy(&global_system);	// crash early, crash often
+	return false;
+}
+
+
+//! Draw a string to the screen beneath all open text windows, at screen coordinates
+//! Use this instead of Text_DrawStringAtXY() for an app's own full-screen drawing while windows are open over it.
+//! @return	Returns false on any error/invalid input
+bool TextWindow_DrawStringUnderWindows(Screen* the_screen, int16_t x, int16_t y, char* the_string, uint8_t fore_color, uint8_t back_color)
+{
+	if (the_screen == NULL)
+	{
+		LOG_ERR(("%s %d: passed screen was NULL", __func__, __LINE__));
+		return false;
+	}
+
+	return TextWindow_PutString(the_screen, TextWindow_GetBottom(the_screen), x, y, 0, the_screen->text_cols_vis_ - 1, the_string, fore_color, back_color);
+}
+
+
+
+
+// **** Debug functions *****
+
+void TextWindow_Print(TextWindow* the_window)
+{
+	DEBUG_OUT(("TextWindow print out:"));
+	DEBUG_OUT(("  address: %p", 			the_window));
+	DEBUG_OUT(("  screen_: %p", 			the_window->screen_));
+	DEBUG_OUT(("  x1_, y1_: %i, %i", 		the_window->x1_, the_window->y1_));
+	DEBUG_OUT(("  x2_, y2_: %i, %i", 		the_window->x2_, the_window->y2_));
+	DEBUG_OUT(("  title_: %s", 				the_window->title_ ? the_window->title_ : "(none)"));
+	DEBUG_OUT(("  save_chars_: %p", 		the_window->save_chars_));
+	DEBUG_OUT(("  save_attrs_: %p", 		the_window->save_attrs_));
+	DEBUG_OUT(("  is_open_: %i", 			the_window->is_open_));
+	DEBUG_OUT(("  above_: %p", 				the_window->above_));
+	DEBUG_OUT(("  below_: %p", 				the_window->below_));
+}
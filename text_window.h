@@ -0,0 +1,152 @@
+//! @file text_window.h
+
+/*
+ * text_window.h
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#ifndef TEXT_WINDOW_H_
+#define TEXT_WINDOW_H_
+
+
+
+/* about this class: TextWindow
+ *
+ * A lightweight framed window for text mode, such as a dialog popped up over a full-screen text app
+ *
+ *** things this class needs to be able to do
+ * save whatever is under it when opened, and put it back when closed, with one box copy each for chars and attrs
+ * stack with other open text windows on the same screen, newest on top
+ * close in any order, without the windows above it losing anything
+ * draw into itself even while partly covered, without drawing over the windows above it
+ * let the app draw into the screen beneath all open windows
+ *
+ *** things objects of this class have
+ * a screen, and a rectangle on that screen (including the frame)
+ * a save-under buffer for chars and one for attrs, in screen memory layout so they can be used with Text_CopyMemBox()
+ * links to the open windows directly above and below it
+ *
+ */
+
+
+/*****************************************************************************/
+/*                                Includes                                   */
+/*****************************************************************************/
+
+// project includes
+
+// C includes
+#include <stdbool.h>
+
+// A2560 includes
+#include "a2560_platform.h"
+
+
+/*****************************************************************************/
+/*                            Macro Definitions                              */
+/*****************************************************************************/
+
+#define TEXT_WINDOW_MIN_WIDTH		3	// frame on each side, and at least 1 column of content
+#define TEXT_WINDOW_MIN_HEIGHT		3	// frame above and below, and at least 1 row of content
+
+
+/*****************************************************************************/
+/*                               Enumerations                                */
+/*****************************************************************************/
+
+
+/*****************************************************************************/
+/*                                 Structs                                   */
+/*****************************************************************************/
+
+struct TextWindow
+{
+	Screen*			screen_;
+	int16_t			x1_;				// area of the screen the window covers, frame included
+	int16_t			y1_;
+	int16_t			x2_;
+	int16_t			y2_;
+	uint8_t			fore_color_;
+	uint8_t			back_color_;
+	char*			title_;				// optional title drawn in the top of the frame. No copy is made.
+	char*			save_chars_;		// while open, the chars under the window. same layout as screen memory, so the char for (x, y) is at y * text_mem_cols_ + x.
+	char*			save_attrs_;		// while open, the attrs under the window, in the same layout
+	bool			is_open_;
+	TextWindow*		above_;				// next open window up the stack, or NULL if this is the top one
+	TextWindow*		below_;				// next open window down the stack, or NULL if this is the bottom one
+};
+
+
+/*****************************************************************************/
+/*                             Global Variables                              */
+/*****************************************************************************/
+
+
+/*****************************************************************************/
+/*                       Public Function Prototypes                          */
+/*****************************************************************************/
+
+// **** CONSTRUCTOR AND DESTRUCTOR *****
+
+// constructor
+//! Allocate a text window and its save-under buffers. The window is not shown until TextWindow_Open() is called.
+//! The save-under buffers are sized for the screen's current text memory: close any windows before changing screen resolution.
+//! @param	the_screen: valid pointer to the target screen to operate on
+//! @param	x1: the leftmost horizontal position of the frame, between 0 and the screen's text_cols_vis_ - 1
+//! @param	y1: the uppermost vertical position of the frame, between 0 and the screen's text_rows_vis_ - 1
+//! @param	x2: the rightmost horizontal position of the frame, between 0 and the screen's text_cols_vis_ - 1
+//! @param	y2: the lowermost vertical position of the frame, between 0 and the screen's text_rows_vis_ - 1
+//! @param	fore_color: Index to the foreground color (0-15) for the frame and content
+//! @param	back_color: Index to the background color (0-15) for the frame and content
+//! @param	the_title: optional string to show in the top of the frame. No copy is made. Pass NULL for no title.
+//! @return	Returns NULL on any error/invalid input, or if memory could not be allocated
+TextWindow* TextWindow_New(Screen* the_screen, int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint8_t fore_color, uint8_t back_color, char* the_title);
+
+// destructor
+// closes the window if it is open, then frees all allocated memory associated with the passed object, and the object itself
+void TextWindow_Destroy(TextWindow** the_window);
+
+
+// **** SETTERS *****
+
+//! Save what is under the window, put the window on top of any other open windows, and draw its frame and cleared content area
+//! @return	Returns false if the window was already open, or on any error
+bool TextWindow_Open(TextWindow* the_window);
+
+//! Put back what was under the window, and take it out of the stack of open windows
+//! If the window is on top, this is one box copy each for chars and attrs. If it is partly covered, only the parts not covered are drawn to the screen; the rest goes to the save-under buffers of the windows covering them.
+//! @return	Returns false if the window was not open, or on any error
+bool TextWindow_Close(TextWindow* the_window);
+
+
+// **** GETTERS *****
+
+//! Find the topmost open text window covering the passed screen coordinates
+//! @return	Returns NULL if no open window covers that spot
+TextWindow* TextWindow_FindAtXY(Screen* the_screen, int16_t x, int16_t y);
+
+
+// **** OTHER FUNCTIONS *****
+
+//! Draw a string inside the window's frame, at coordinates relative to the top left of the content area
+//! Parts covered by other windows are not drawn to the screen, but will appear when those windows close. The string is clipped to the content area.
+//! @return	Returns false if the window is not open, or on any error
+bool TextWindow_DrawStringAtXY(TextWindow* the_window, int16_t x, int16_t y, char* the_string, uint8_t fore_color, uint8_t back_color);
+
+//! Clear the window's content area to its background color
+//! @return	Returns false if the window is not open, or on any error
+bool TextWindow_ClearContent(TextWindow* the_window);
+
+//! Draw a string to the screen beneath all open text windows, at screen coordinates
+//! Use this instead of Text_DrawStringAtXY() for an app's own full-screen drawing while windows are open over it.
+//! @return	Returns false on any error/invalid input
+bool TextWindow_DrawStringUnderWindows(Screen* the_screen, int16_t x, int16_t y, char* the_string, uint8_t fore_color, uint8_t back_color);
+
+
+// **** Debug functions *****
+
+void TextWindow_Print(TextWindow* the_window);
+
+
+#endif /* TEXT_WINDOW_H_ */
@@ -3123,7 +3123,7 @@ ControlTemplate* Theme_CreateControlTemplateFlexWidth(Theme* the_theme, control_
 			}
 
 			// first tile the middle piece, then blit the left and right on top of that. 
-			Bitmap_Tile(the_theme->flex_width_backdrops_[the_type].image_mid_[is_active][is_pushed], 0, 0, the_bitmap, the_theme->flex_width_backdrops_[the_type].mid_width_, the_theme->flex_width_backdrops_[the_type].height_);
+			Bitmap_Tile(the_theme->flex_width_backdrops_[the_type].image_mid_[is_active][is_pushed], 0, 0, the_bitmap, the_theme->flex_width_backdrops_[the_type].mid_width_, the_theme->flex_width_backdrops_[the_type].height_, NULL);
 			Bitmap_Blit(the_theme->flex_width_backdrops_[the_type].image_left_[is_active][is_pushed], 0, 0, the_bitmap, 0, 0, the_theme->flex_width_backdrops_[the_type].left_width_, the_theme->flex_width_backdrops_[the_type].height_);
 			Bitmap_Blit(the_theme->flex_width_backdrops_[the_type].image_right_[is_active][is_pushed], 0, 0, the_bitmap, width - the_theme->flex_width_backdrops_[the_type].right_width_, 0, the_theme->flex_width_backdrops_[the_type].right_width_, the_theme->flex_width_backdrops_[the_type].height_);
 			the_template->image_[is_active][is_pushed] = the_bitmap;
@@ -19,6 +19,7 @@
 #include "control.h"
 
 // C includes
+#include <ctype.h>
 #include <stdbool.h>
 #include <stdarg.h>
 #include <stdio.h>
@@ -33,6 +34,8 @@
 #include "text.h"
 #include "font.h"
 #include "lib_sys.h"
+#include "event.h"
+#include "menu.h"
 
 
 /*****************************************************************************/
@@ -79,6 +82,13 @@ void Window_UpdateControlTheme(Window* the_window);
 //! @return:	Returns -1 in event of error, or the calculated width
 static int16_t Window_CalculateTitleSpace(Window* the_window);
 
+//! Reduce event_modifier_flags to the bits that tell one shortcut from another: right-hand modifier keys count as left-hand ones, and alpha lock is ignored
+static uint8_t Window_GetShortcutModifiers(uint16_t the_modifiers);
+
+//! Find the slot in the window's shortcut table that holds the passed key combination, or the empty slot where it would go
+//! @return	Returns -1 if the combination is not in the table, and there is no room to add it
+static int16_t Window_FindShortcutSlot(Window* the_window, uint8_t the_key, uint8_t the_modifiers);
+
 
 
 // **** Private CONTROL management functions *****
@@ -88,6 +98,18 @@ static int16_t Window_CalculateTitleSpace(Window* the_window);
 //! @return:	Returns a control pointer, or NULL on any error, or if there is no root control
 Control* Window_GetRootControl(Window* the_window);
 
+//! Free the window's control hit-testing index, and mark it as needing a rebuild
+//! @param	the_window: reference to a valid Window object.
+static void Window_FreeControlIndex(Window* the_window);
+
+//! Rebuild the window's control hit-testing index (cell buckets and ID-sorted list) from its list of controls
+//! @param	the_window: reference to a valid Window object.
+//! @return:	Returns false if the index could not be built. Callers should then fall back to walking the control list.
+static bool Window_RebuildControlIndex(Window* the_window);
+
+//! Get the range of control index cells covered by the passed window-local rect. Coordinates outside the window are folded into the edge cells.
+static void Window_GetControlIndexCells(Window* the_window, Rectangle* the_rect, uint8_t* min_col, uint8_t* min_row, uint8_t* max_col, uint8_t* max_row);
+
 
 
 	
@@ -110,6 +132,46 @@ static void Window_DrawTitlebar(Window* the_window);
 //! @param	the_window: a valid pointer to a Window
 static void Window_DrawTitle(Window* the_window);
 
+//! Make sure the window has off-screen bitmap storage to draw into, rebuilding it if the system had evicted it
+//! @param	the_window: reference to a valid Window object.
+//! @return:	Returns false if storage could not be rebuilt
+static bool Window_EnsureBackingStore(Window* the_window);
+
+
+// **** Private DRAWING functions *****
+
+//! Trim the passed window-local rect so that it lies within the window's content area
+//! @param	the_window: reference to a valid Window object.
+//! @param	the_rect: the rect to be trimmed, in window-local coordinates. MinX/MinY must not be greater than MaxX/MaxY.
+//! @return:	Returns false if no part of the rect is within the content area
+static bool Window_ClipRectToContent(Window* the_window, Rectangle* the_rect);
+
+//! Trim the passed window-local line so that it lies within the window's content area (Cohen-Sutherland)
+//! @param	the_window: reference to a valid Window object.
+//! @return:	Returns false if no part of the line is within the content area
+static bool Window_ClipLineToContent(Window* the_window, int16_t* x1, int16_t* y1, int16_t* x2, int16_t* y2);
+
+//! Record an area of the window's bitmap that has just been drawn to, so that only that area is blitted on the next render
+//! If the area is already covered by a pending clip rect, or the whole window will be reblitted anyway, nothing is recorded
+//! @param	the_window: reference to a valid Window object.
+//! @param	the_rect: the changed area, in window-local coordinates. Must already be clipped to the content area.
+static void Window_AddDirtyRect(Window* the_window, Rectangle* the_rect);
+
+//! Draw a horizontal or vertical line of the_line_len pixels, trimmed to the window's content area. Does not record a dirty rect.
+//! @param	x, y: the starting position, in window-local coordinates
+static void Window_DrawClippedHLine(Window* the_window, int16_t x, int16_t y, int16_t the_line_len, uint8_t the_color);
+static void Window_DrawClippedVLine(Window* the_window, int16_t x, int16_t y, int16_t the_line_len, uint8_t the_color);
+
+//! Draw the outline of the passed window-local rect (all 4 edges inclusive), trimmed to the content area, and record it as dirty
+static void Window_DrawClippedFrame(Window* the_window, Rectangle* the_frame, uint8_t the_color);
+
+//! Fill the passed window-local rect (inclusive), trimmed to the content area, and record it as dirty
+static void Window_FillClippedRect(Window* the_window, Rectangle* the_rect, uint8_t the_color);
+
+//! Clear a strip of the content area that was exposed by scrolling, and send the window an updateEvt asking for it to be redrawn
+//! @param	the_strip: the exposed area, in window-local coordinates
+static void Window_ExposeStrip(Window* the_window, Rectangle* the_strip);
+
 
 /*****************************************************************************/
 /*                       Private Function Definitions                        */
@@ -508,6 +570,57 @@ error:
 }
 
 
+//! Reduce event_modifier_flags to the bits that tell one shortcut from another: right-hand modifier keys count as left-hand ones, and alpha lock is ignored
+static uint8_t Window_GetShortcutModifiers(uint16_t the_modifiers)
+{
+	if (the_modifiers & rightShiftKey)
+	{
+		the_modifiers |= shiftKey;
+	}
+	
+	if (the_modifiers & rightOptionKey)
+	{
+		the_modifiers |= optionKey;
+	}
+	
+	if (the_modifiers & rightControlKey)
+	{
+		the_modifiers |= controlKey;
+	}
+	
+	return (the_modifiers & (foenixKey | shiftKey | optionKey | controlKey)) >> 8;
+}
+
+
+//! Find the slot in the window's shortcut table that holds the passed key combination, or the empty slot where it would go
+//! @return	Returns -1 if the combination is not in the table, and there is no room to add it
+static int16_t Window_FindShortcutSlot(Window* the_window, uint8_t the_key, uint8_t the_modifiers)
+{
+	uint8_t		the_slot;
+	uint8_t		i;
+	
+	// LOGIC:
+	//   open addressing: key + modifiers pick a starting slot, and collisions go to the next slot along
+	//   shortcuts are only ever removed all at once (Window_ClearShortcuts()), so an empty slot always ends the search
+	
+	the_slot = (the_key * 3 + the_modifiers) & (WIN_SHORTCUT_TABLE_SIZE - 1);
+	
+	for (i = 0; i < WIN_SHORTCUT_TABLE_SIZE; i++)
+	{
+		WindowShortcut*		this_shortcut = &the_window->shortcut_[the_slot];
+		
+		if (this_shortcut->key_ == 0 || (this_shortcut->key_ == the_key && this_shortcut->modifiers_ == the_modifiers))
+		{
+			return the_slot;
+		}
+		
+		the_slot = (the_slot + 1) & (WIN_SHORTCUT_TABLE_SIZE - 1);
+	}
+	
+	return -1;
+}
+
+
 
 
 
@@ -534,6 +647,190 @@ error:
 }
 
 
+//! Free the window's control hit-testing index, and mark it as needing a rebuild
+//! @param	the_window: reference to a valid Window object.
+static void Window_FreeControlIndex(Window* the_window)
+{
+	if (the_window->control_index_)
+	{
+		LOG_ALLOC(("%s %d:	__FREE__	the_window->control_index_	%p", __func__ , __LINE__, the_window->control_index_));
+		free(the_window->control_index_);
+		the_window->control_index_ = NULL;
+	}
+	
+	if (the_window->control_index_start_)
+	{
+		LOG_ALLOC(("%s %d:	__FREE__	the_window->control_index_start_	%p", __func__ , __LINE__, the_window->control_index_start_));
+		free(the_window->control_index_start_);
+		the_window->control_index_start_ = NULL;
+	}
+	
+	if (the_window->control_id_index_)
+	{
+		LOG_ALLOC(("%s %d:	__FREE__	the_window->control_id_index_	%p", __func__ , __LINE__, the_window->control_id_index_));
+		free(the_window->control_id_index_);
+		the_window->control_id_index_ = NULL;
+	}
+	
+	the_window->control_index_count_ = 0;
+	the_window->control_index_invalidated_ = true;
+	the_window->control_index_too_big_ = false;
+}
+
+
+//! Get the range of control index cells covered by the passed window-local rect. Coordinates outside the window are folded into the edge cells.
+static void Window_GetControlIndexCells(Window* the_window, Rectangle* the_rect, uint8_t* min_col, uint8_t* min_row, uint8_t* max_col, uint8_t* max_row)
+{
+	int16_t		last_col = the_window->control_index_cols_ - 1;
+	int16_t		last_row = the_window->control_index_rows_ - 1;
+	int16_t		the_cell;
+	
+	the_cell = (the_rect->MinX < 0) ? 0 : the_rect->MinX >> WIN_CONTROL_INDEX_CELL_SHIFT;
+	*min_col = (the_cell > last_col) ? last_col : the_cell;
+	the_cell = (the_rect->MaxX < 0) ? 0 : the_rect->MaxX >> WIN_CONTROL_INDEX_CELL_SHIFT;
+	*max_col = (the_cell > last_col) ? last_col : the_cell;
+	the_cell = (the_rect->MinY < 0) ? 0 : the_rect->MinY >> WIN_CONTROL_INDEX_CELL_SHIFT;
+	*min_row = (the_cell > last_row) ? last_row : the_cell;
+	the_cell = (the_rect->MaxY < 0) ? 0 : the_rect->MaxY >> WIN_CONTROL_INDEX_CELL_SHIFT;
+	*max_row = (the_cell > last_row) ? last_row : the_cell;
+}
+
+
+//! Rebuild the window's control hit-testing index (cell buckets and ID-sorted list) from its list of controls
+//! @param	the_window: reference to a valid Window object.
+//! @return:	Returns false if the index could not be built. Callers should then fall back to walking the control list.
+static bool Window_RebuildControlIndex(Window* the_window)
+{
+	Control*	the_control;
+	uint16_t	num_controls = 0;
+	uint16_t	num_cells;
+	uint32_t	num_entries = 0;
+	uint16_t	i;
+	uint8_t		min_col;
+	uint8_t		min_row;
+	uint8_t		max_col;
+	uint8_t		max_row;
+	uint8_t		col;
+	uint8_t		row;
+	
+	// LOGIC:
+	//   The window is divided into 32x32 cells. Each cell gets a run of the controls whose rects touch it.
+	//   All runs live in one array (control_index_), with control_index_start_[cell] giving where each run begins,
+	//     so a hit-test only looks at the handful of controls in one cell.
+	//   Runs are filled in list order, so that with overlapping controls, the same control wins as when walking the list.
+	//   Built in 2 passes: count controls per cell, then convert counts to offsets and drop the controls in.
+	//   Controls rarely change, so the index is simply rebuilt the next time it's needed after any add/move/resize.
+	
+	Window_FreeControlIndex(the_window);
+	
+	the_window->control_index_cols_ = (the_window->width_ > 0) ? ((the_window->width_ - 1) >> WIN_CONTROL_INDEX_CELL_SHIFT) + 1 : 1;
+	the_window->control_index_rows_ = (the_window->height_ > 0) ? ((the_window->height_ - 1) >> WIN_CONTROL_INDEX_CELL_SHIFT) + 1 : 1;
+	num_cells = the_window->control_index_cols_ * the_window->control_index_rows_;
+	
+	// first pass: count controls, and how many cell slots each will take up
+	for (the_control = the_window->root_control_; the_control != NULL; the_control = the_control->next_)
+	{
+		Window_GetControlIndexCells(the_window, &the_control->rect_, &min_col, &min_row, &max_col, &max_row);
+		num_entries += (uint32_t)(max_col - min_col + 1) * (max_row - min_row + 1);
+		++num_controls;
+	}
+	
+	if (num_controls == 0)
+	{
+		the_window->control_index_invalidated_ = false;
+		return true;
+	}
+	
+	// LOGIC: the index is not rebuilt, nor the warning repeated, on every lookup: the linear scan is used until a control or the window changes again
+	if (num_entries > WIN_CONTROL_INDEX_MAX_ENTRIES)
+	{
+		LOG_WARN(("%s %d: controls cover too many cells (%lu) to index", __func__ , __LINE__, num_entries));
+		the_window->control_index_too_big_ = true;
+		the_window->control_index_invalidated_ = false;
+		return false;
+	}
+	
+	if ( (the_window->control_index_start_ = (uint16_t*)calloc(num_cells + 1, sizeof(uint16_t)) ) == NULL)
+	{
+		LOG_ERR(("%s %d: could not allocate memory for the control index", __func__ , __LINE__));
+		goto error;
+	}
+	LOG_ALLOC(("%s %d:	__ALLOC__	the_window->control_index_start_	%p	size	%i", __func__ , __LINE__, the_window->control_index_start_, (num_cells + 1) * sizeof(uint16_t)));
+	
+	if ( (the_window->control_index_ = (Control**)calloc(num_entries, sizeof(Control*)) ) == NULL)
+	{
+		LOG_ERR(("%s %d: could not allocate memory for the control index", __func__ , __LINE__));
+		goto error;
+	}
+	LOG_ALLOC(("%s %d:	__ALLOC__	the_window->control_index_	%p	size	%i", __func__ , __LINE__, the_window->control_index_, num_entries * sizeof(Control*)));
+	
+	if ( (the_window->control_id_index_ = (Control**)calloc(num_controls, sizeof(Control*)) ) == NULL)
+	{
+		LOG_ERR(("%s %d: could not allocate memory for the control ID index", __func__ , __LINE__));
+		goto error;
+	}
+	LOG_ALLOC(("%s %d:	__ALLOC__	the_window->control_id_index_	%p	size	%i", __func__ , __LINE__, the_window->control_id_index_, num_controls * sizeof(Control*)));
+	
+	// count per cell, stored one cell to the right, so that a running total turns it into the start offset of each cell
+	for (the_control = the_window->root_control_; the_control != NULL; the_control = the_control->next_)
+	{
+		Window_GetControlIndexCells(the_window, &the_control->rect_, &min_col, &min_row, &max_col, &max_row);
+
+		for (row = min_row; row <= max_row; row++)
+		{
+			for (col = min_col; col <= max_col; col++)
+			{
+				++the_window->control_index_start_[row * the_window->control_index_cols_ + col + 1];
+			}
+		}
+	}
+	
+	for (i = 1; i <= num_cells; i++)
+	{
+		the_window->control_index_start_[i] += the_window->control_index_start_[i - 1];
+	}
+	
+	// second pass: drop each control into its cells, and into the ID list, using insertion sort (controls are usually added in ID order already)
+	for (the_control = the_window->root_control_; the_control != NULL; the_control = the_control->next_)
+	{
+		uint16_t	the_id = Control_GetID(the_control);
+		
+		Window_GetControlIndexCells(the_window, &the_control->rect_, &min_col, &min_row, &max_col, &max_row);
+
+		for (row = min_row; row <= max_row; row++)
+		{
+			for (col = min_col; col <= max_col; col++)
+			{
+				the_window->control_index_[the_window->control_index_start_[row * the_window->control_index_cols_ + col]++] = the_control;
+			}
+		}
+		
+		for (i = the_window->control_index_count_; i > 0 && Control_GetID(the_window->control_id_index_[i - 1]) > the_id; i--)
+		{
+			the_window->control_id_index_[i] = the_window->control_id_index_[i - 1];
+		}
+		
+		the_window->control_id_index_[i] = the_control;
+		++the_window->control_index_count_;
+	}
+	
+	// filling the cells moved each start offset up to where the next cell starts: shift them back down
+	for (i = num_cells; i > 0; i--)
+	{
+		the_window->control_index_start_[i] = the_window->control_index_start_[i - 1];
+	}
+	
+	the_window->control_index_start_[0] = 0;
+	the_window->control_index_invalidated_ = false;
+	
+	return true;
+	
+error:
+	Window_FreeControlIndex(the_window);
+	return false;
+}
+
+
 
 
 
@@ -572,6 +869,20 @@ error:
 }
 
 
+//! Make sure the window has off-screen bitmap storage to draw into, rebuilding it if the system had evicted it
+//! @param	the_window: reference to a valid Window object.
+//! @return:	Returns false if storage could not be rebuilt
+static bool Window_EnsureBackingStore(Window* the_window)
+{
+	if (the_window->backing_store_evicted_ == false)
+	{
+		return true;
+	}
+	
+	return Sys_RestoreBackingStore(global_system, the_window);
+}
+
+
 // draws or redraws the entire window, including clearing the content area
 // forces redraw of all controls, by marking them invalidated
 static void Window_DrawAll(Window* the_window)
@@ -637,8 +948,12 @@ error:
 // draws or redraws the titlebar area, including close/min/max/normal size controls
 static void Window_DrawTitlebar(Window* the_window)
 {
-	Theme*	the_theme;
-	int16_t	i;
+	Theme*		the_theme;
+	Bitmap*		the_cached_chrome = NULL;
+	Control*	the_widget[MAX_BUILT_IN_WIDGET];
+	uint8_t		widget_mask = 0;
+	bool		is_cacheable = true;
+	int16_t		i;
 
 	// LOGIC:
 	//   not checking for valid window, because this is only called by Window_DrawStructure, and it checks validity
@@ -647,20 +962,77 @@ static void Window_DrawTitlebar(Window* the_window)
 	//   order of rect rendering must be Fill titlebar > Draw overall border rect > draw titlebar rect
 	//   this allows titlebar to overwrite the overall border when it has one, but not have its fill overwrite the overall border if no titlebar border
 	
+	// LOGIC:
+	//   apart from the title text, a titlebar looks the same for every window of the same width, in the same active state
+	//   so the system keeps pre-rendered titlebars (fill, outline, built-in widgets), and a window only has to draw its title on top
+	//   this makes activate/deactivate a blit rather than a redraw
+	//   a titlebar with a widget that is pressed, or not yet visible, is a one-off: it is drawn, but not cached
+	
 	the_theme = Sys_GetTheme(global_system);
 
-	if (the_window->active_)
+	for (i=CLOSE_WIDGET_ID; i < MAX_BUILT_IN_WIDGET; i++)
 	{
-		Bitmap_FillBoxRect(the_window->bitmap_, &the_window->titlebar_rect_, Theme_GetTitlebarColor(the_theme));
+		the_widget[i] = Window_GetControl(the_window, i);
+		
+		if (the_widget[i] != NULL)
+		{
+			Control_SetActive(the_widget[i], the_window->active_);
+			widget_mask |= (1 << i);
+			
+			if (the_widget[i]->pressed_ || the_widget[i]->visible_ == false)
+			{
+				is_cacheable = false;
+			}
+		}
 	}
-	else
+	
+	if (is_cacheable)
 	{
-		Bitmap_FillBoxRect(the_window->bitmap_, &the_window->titlebar_rect_, Theme_GetInactiveBackColor(the_theme));
+		the_cached_chrome = Sys_GetCachedChrome(global_system, the_window->titlebar_rect_.MaxX - the_window->titlebar_rect_.MinX + 1, the_window->titlebar_rect_.MaxY - the_window->titlebar_rect_.MinY + 1, widget_mask, the_window->active_);
 	}
+	
+	if (the_cached_chrome != NULL)
+	{
+		Bitmap_Blit(the_cached_chrome, 0, 0, the_window->bitmap_, the_window->titlebar_rect_.MinX, the_window->titlebar_rect_.MinY, the_cached_chrome->width_, the_cached_chrome->height_);
 
-	if (the_theme->titlebar_outline_)
+		// the widgets are already in the pixels we just copied
+		for (i=CLOSE_WIDGET_ID; i < MAX_BUILT_IN_WIDGET; i++)
+		{
+			if (the_widget[i] != NULL)
+			{
+				Control_MarkInvalidated(the_widget[i], false);
+			}
+		}
+	}
+	else
 	{
-		Bitmap_DrawBoxRect(the_window->bitmap_, &the_window->titlebar_rect_, Theme_GetOutlineColor(the_theme));
+		if (the_window->active_)
+		{
+			Bitmap_FillBoxRect(the_window->bitmap_, &the_window->titlebar_rect_, Theme_GetTitlebarColor(the_theme));
+		}
+		else
+		{
+			Bitmap_FillBoxRect(the_window->bitmap_, &the_window->titlebar_rect_, Theme_GetInactiveBackColor(the_theme));
+		}
+
+		if (the_theme->titlebar_outline_)
+		{
+			Bitmap_DrawBoxRect(the_window->bitmap_, &the_window->titlebar_rect_, Theme_GetOutlineColor(the_theme));
+		}
+		
+		if (is_cacheable)
+		{
+			// draw the widgets now rather than in the controls pass, so they are part of the cached titlebar
+			for (i=CLOSE_WIDGET_ID; i < MAX_BUILT_IN_WIDGET; i++)
+			{
+				if (the_widget[i] != NULL)
+				{
+					Control_Render(the_widget[i]);
+				}
+			}
+			
+			Sys_CacheChrome(global_system, the_window->bitmap_, &the_window->titlebar_rect_, widget_mask, the_window->active_);
+		}
 	}
 
 	Window_DrawTitle(the_window);
@@ -670,20 +1042,6 @@ static void Window_DrawTitlebar(Window* the_window)
 
 	// add titlebar rect to the list of clip rects that need to be blitted from window to screen
 	Window_AddClipRect(the_window, &the_window->titlebar_rect_);
-	
-	// mark the controls positioned in the title bar as invalid so they get redrawn as well
-	for (i=CLOSE_WIDGET_ID; i < MAX_BUILT_IN_WIDGET; i++)
-	{
-		Control*	the_control;
-		
-		the_control = Window_GetControl(the_window, i);
-		
-		if (the_control != NULL)
-		{
-			Control_MarkInvalidated(the_control, true);
-			Control_SetActive(the_control, the_window->active_);
-		}
-	}
 }
 
 
@@ -748,61 +1106,309 @@ error:
 }
 
 
-// **** Debug functions *****
+// **** Private DRAWING functions *****
 
-void Window_Print(Window* the_window)
+//! Trim the passed window-local rect so that it lies within the window's content area
+//! @param	the_window: reference to a valid Window object.
+//! @param	the_rect: the rect to be trimmed, in window-local coordinates. MinX/MinY must not be greater than MaxX/MaxY.
+//! @return:	Returns false if no part of the rect is within the content area
+static bool Window_ClipRectToContent(Window* the_window, Rectangle* the_rect)
 {
-	DEBUG_OUT(("Window print out:"));
-	DEBUG_OUT(("  address: %p", 		the_window));
-	DEBUG_OUT(("  id_: %i", 			the_window->id_));
-	DEBUG_OUT(("  display_order_: %i", 	the_window->display_order_));
-	DEBUG_OUT(("  user_data_: %i",		the_window->user_data_));
-	DEBUG_OUT(("  title_: '%s'",		the_window->title_));
-	DEBUG_OUT(("  state_: %i",			the_window->state_));
-	DEBUG_OUT(("  bitmap_: %p",			the_window->bitmap_));
-	DEBUG_OUT(("  buffer_bitmap_: %p",	the_window->buffer_bitmap_));
-	DEBUG_OUT(("  overall_rect_: %i, %i, %i, %i", the_window->overall_rect_.MinX, the_window->overall_rect_.MinY, the_window->overall_rect_.MaxX, the_window->overall_rect_.MaxY));
-	DEBUG_OUT(("  titlebar_rect_: %i, %i, %i, %i", the_window->titlebar_rect_.MinX, the_window->titlebar_rect_.MinY, the_window->titlebar_rect_.MaxX, the_window->titlebar_rect_.MaxY));
-	DEBUG_OUT(("  iconbar_rect_: %i, %i, %i, %i", the_window->iconbar_rect_.MinX, the_window->iconbar_rect_.MinY, the_window->iconbar_rect_.MaxX, the_window->iconbar_rect_.MaxY));
-	DEBUG_OUT(("  content_rect_: %i, %i, %i, %i", the_window->content_rect_.MinX, the_window->content_rect_.MinY, the_window->content_rect_.MaxX, the_window->content_rect_.MaxY));
-	DEBUG_OUT(("  grow_left_rect_: %i, %i, %i, %i", the_window->grow_left_rect_.MinX, the_window->grow_left_rect_.MinY, the_window->grow_left_rect_.MaxX, the_window->grow_left_rect_.MaxY));
-	DEBUG_OUT(("  grow_right_rect_: %i, %i, %i, %i", the_window->grow_right_rect_.MinX, the_window->grow_right_rect_.MinY, the_window->grow_right_rect_.MaxX, the_window->grow_right_rect_.MaxY));
-	DEBUG_OUT(("  grow_top_rect_: %i, %i, %i, %i", the_window->grow_top_rect_.MinX, the_window->grow_top_rect_.MinY, the_window->grow_top_rect_.MaxX, the_window->grow_top_rect_.MaxY));
-	DEBUG_OUT(("  grow_bottom_rect_: %i, %i, %i, %i", the_window->grow_bottom_rect_.MinX, the_window->grow_bottom_rect_.MinY, the_window->grow_bottom_rect_.MaxX, the_window->grow_bottom_rect_.MaxY));
-	DEBUG_OUT(("  show_iconbar_: %i",	the_window->show_iconbar_));
-	DEBUG_OUT(("  is_backdrop_: %i",	the_window->is_backdrop_));
-	DEBUG_OUT(("  visible_: %i",		the_window->visible_));
-	DEBUG_OUT(("  active_: %i",			the_window->active_));
-	DEBUG_OUT(("  changes_to_save_: %i",	the_window->changes_to_save_));
-	DEBUG_OUT(("  can_resize_: %i",		the_window->can_resize_));	
-	DEBUG_OUT(("  x_: %i",				the_window->x_));	
-	DEBUG_OUT(("  y_: %i",				the_window->y_));	
-	DEBUG_OUT(("  width_: %i",			the_window->width_));	
-	DEBUG_OUT(("  height_: %i",			the_window->height_));	
-	DEBUG_OUT(("  min_width_: %i",		the_window->min_width_));	
-	DEBUG_OUT(("  min_height_: %i",		the_window->min_height_));	
-	DEBUG_OUT(("  max_width_: %i",		the_window->max_width_));	
-	DEBUG_OUT(("  max_height_: %i",		the_window->max_height_));	
-	DEBUG_OUT(("  inner_width_: %i",	the_window->inner_width_));	
-	DEBUG_OUT(("  inner_height_: %i",	the_window->inner_height_));	
-	DEBUG_OUT(("  avail_title_width_: %i",	the_window->avail_title_width_));	
-	DEBUG_OUT(("  content_left_: %i",	the_window->content_left_));	
-	DEBUG_OUT(("  content_top_: %i",	the_window->content_top_));	
-	DEBUG_OUT(("  required_inner_width_: %i",		the_window->required_inner_width_));	
-	DEBUG_OUT(("  required_inner_height_: %i",		the_window->required_inner_height_));	
-	DEBUG_OUT(("  h_scroller_visible_: %i",			the_window->h_scroller_visible_));	
-	DEBUG_OUT(("  v_scroller_visible_: %i",			the_window->v_scroller_visible_));	
-	DEBUG_OUT(("  pattern_: %p",		the_window->pattern_));	
-	DEBUG_OUT(("  parent_window_: %p",	the_window->parent_window_));	
-	DEBUG_OUT(("  child_window_: %p",	the_window->child_window_));	
-	DEBUG_OUT(("  root_control_: %p",	the_window->root_control_));	
+	Rectangle*	the_content = &the_window->content_rect_;
+	
+	if (the_rect->MinX < the_content->MinX)
+	{
+		the_rect->MinX = the_content->MinX;
+	}
+	
+	if (the_rect->MinY < the_content->MinY)
+	{
+		the_rect->MinY = the_content->MinY;
+	}
+	
+	if (the_rect->MaxX > the_content->MaxX)
+	{
+		the_rect->MaxX = the_content->MaxX;
+	}
+	
+	if (the_rect->MaxY > the_content->MaxY)
+	{
+		the_rect->MaxY = the_content->MaxY;
+	}
+	
+	return (the_rect->MinX <= the_rect->MaxX && the_rect->MinY <= the_rect->MaxY);
 }
 
 
-// helper function called by List class's print function: prints one window entry
-void Window_PrintBrief(void* the_payload)
+//! Trim the passed window-local line so that it lies within the window's content area (Cohen-Sutherland)
+//! @param	the_window: reference to a valid Window object.
+//! @return:	Returns false if no part of the line is within the content area
+static bool Window_ClipLineToContent(Window* the_window, int16_t* x1, int16_t* y1, int16_t* x2, int16_t* y2)
 {
-	Window*		this_window = (Window*)(the_payload);
+	Rectangle*	the_content = &the_window->content_rect_;
+	uint8_t		code1;
+	uint8_t		code2;
+	uint8_t		the_code;
+	int32_t		x;
+	int32_t		y;
+	
+	// LOGIC:
+	//   each end point gets a 4-bit outcode: 1=left, 2=right, 4=above, 8=below the content rect
+	//   both codes 0: line is entirely inside. codes share a bit: line is entirely outside on that side.
+	//   otherwise, move the outside point to the edge it crosses, and try again
+	
+	for (;;)
+	{
+		code1 = (*x1 < the_content->MinX) | ((*x1 > the_content->MaxX) << 1) | ((*y1 < the_content->MinY) << 2) | ((*y1 > the_content->MaxY) << 3);
+		code2 = (*x2 < the_content->MinX) | ((*x2 > the_content->MaxX) << 1) | ((*y2 < the_content->MinY) << 2) | ((*y2 > the_content->MaxY) << 3);
+		
+		if ((code1 | code2) == 0)
+		{
+			return true;
+		}
+		
+		if (code1 & code2)
+		{
+			return false;
+		}
+		
+		the_code = (code1 != 0) ? code1 : code2;
+		
+		if (the_code & 8)
+		{
+			y = the_content->MaxY;
+			x = *x1 + (int32_t)(*x2 - *x1) * (y - *y1) / (*y2 - *y1);
+		}
+		else if (the_code & 4)
+		{
+			y = the_content->MinY;
+			x = *x1 + (int32_t)(*x2 - *x1) * (y - *y1) / (*y2 - *y1);
+		}
+		else if (the_code & 2)
+		{
+			x = the_content->MaxX;
+			y = *y1 + (int32_t)(*y2 - *y1) * (x - *x1) / (*x2 - *x1);
+		}
+		else
+		{
+			x = the_content->MinX;
+			y = *y1 + (int32_t)(*y2 - *y1) * (x - *x1) / (*x2 - *x1);
+		}
+		
+		if (the_code == code1)
+		{
+			*x1 = (int16_t)x;
+			*y1 = (int16_t)y;
+		}
+		else
+		{
+			*x2 = (int16_t)x;
+			*y2 = (int16_t)y;
+		}
+	}
+}
+
+
+//! Record an area of the window's bitmap that has just been drawn to, so that only that area is blitted on the next render
+//! If the area is already covered by a pending clip rect, or the whole window will be reblitted anyway, nothing is recorded
+//! @param	the_window: reference to a valid Window object.
+//! @param	the_rect: the changed area, in window-local coordinates. Must already be clipped to the content area.
+static void Window_AddDirtyRect(Window* the_window, Rectangle* the_rect)
+{
+	Rectangle*	the_clip;
+	int16_t		i;
+	
+	// LOGIC:
+	//   apps tend to draw the same area several times per update (erase, then draw text, then underline, etc.)
+	//   so don't spend clip rect slots on areas that are already going to be blitted.
+	//   if the new area swallows a pending one, reuse that slot instead.
+	//   once the window runs out of clip rects, Window_Render() falls back to reblitting the whole window.
+	
+	if (the_window->invalidated_ == true || the_window->clip_count_ >= WIN_MAX_CLIP_RECTS)
+	{
+		return;
+	}
+	
+	for (i = 0; i < the_window->clip_count_; i++)
+	{
+		the_clip = &the_window->clip_rect_[i];
+		
+		if (the_rect->MinX >= the_clip->MinX && the_rect->MaxX <= the_clip->MaxX && the_rect->MinY >= the_clip->MinY && the_rect->MaxY <= the_clip->MaxY)
+		{
+			return;
+		}
+		
+		if (the_clip->MinX >= the_rect->MinX && the_clip->MaxX <= the_rect->MaxX && the_clip->MinY >= the_rect->MinY && the_clip->MaxY <= the_rect->MaxY)
+		{
+			General_CopyRect(the_clip, the_rect);
+			return;
+		}
+	}
+	
+	Window_AddClipRect(the_window, the_rect);
+}
+
+
+//! Draw a horizontal line of the_line_len pixels, trimmed to the window's content area. Does not record a dirty rect.
+//! @param	x, y: the starting position, in window-local coordinates
+static void Window_DrawClippedHLine(Window* the_window, int16_t x, int16_t y, int16_t the_line_len, uint8_t the_color)
+{
+	Rectangle	the_rect;
+	
+	if (the_line_len < 1)
+	{
+		return;
+	}
+	
+	the_rect.MinX = x;
+	the_rect.MinY = y;
+	the_rect.MaxX = x + the_line_len - 1;
+	the_rect.MaxY = y;
+	
+	if (Window_ClipRectToContent(the_window, &the_rect))
+	{
+		Bitmap_DrawHLine(the_window->bitmap_, the_rect.MinX, the_rect.MinY, the_rect.MaxX - the_rect.MinX + 1, the_color);
+	}
+}
+
+
+//! Draw a vertical line of the_line_len pixels, trimmed to the window's content area. Does not record a dirty rect.
+//! @param	x, y: the starting position, in window-local coordinates
+static void Window_DrawClippedVLine(Window* the_window, int16_t x, int16_t y, int16_t the_line_len, uint8_t the_color)
+{
+	Rectangle	the_rect;
+	
+	if (the_line_len < 1)
+	{
+		return;
+	}
+	
+	the_rect.MinX = x;
+	the_rect.MinY = y;
+	the_rect.MaxX = x;
+	the_rect.MaxY = y + the_line_len - 1;
+	
+	if (Window_ClipRectToContent(the_window, &the_rect))
+	{
+		Bitmap_DrawVLine(the_window->bitmap_, the_rect.MinX, the_rect.MinY, the_rect.MaxY - the_rect.MinY + 1, the_color);
+	}
+}
+
+
+//! Draw the outline of the passed window-local rect (all 4 edges inclusive), trimmed to the content area, and record it as dirty
+static void Window_DrawClippedFrame(Window* the_window, Rectangle* the_frame, uint8_t the_color)
+{
+	Rectangle	the_dirty_rect;
+	int16_t		width;
+	int16_t		height;
+	
+	width = the_frame->MaxX - the_frame->MinX + 1;
+	height = the_frame->MaxY - the_frame->MinY + 1;
+	
+	Window_DrawClippedHLine(the_window, the_frame->MinX, the_frame->MinY, width, the_color);
+	Window_DrawClippedHLine(the_window, the_frame->MinX, the_frame->MaxY, width, the_color);
+	Window_DrawClippedVLine(the_window, the_frame->MinX, the_frame->MinY, height, the_color);
+	Window_DrawClippedVLine(the_window, the_frame->MaxX, the_frame->MinY, height, the_color);
+	
+	General_CopyRect(&the_dirty_rect, the_frame);
+	
+	if (Window_ClipRectToContent(the_window, &the_dirty_rect))
+	{
+		Window_AddDirtyRect(the_window, &the_dirty_rect);
+	}
+}
+
+
+//! Fill the passed window-local rect (inclusive), trimmed to the content area, and record it as dirty
+static void Window_FillClippedRect(Window* the_window, Rectangle* the_rect, uint8_t the_color)
+{
+	if (Window_ClipRectToContent(the_window, the_rect) == false)
+	{
+		return;
+	}
+	
+	// Bitmap_FillBox() fills height + 1 rows
+	Bitmap_FillBox(the_window->bitmap_, the_rect->MinX, the_rect->MinY, the_rect->MaxX - the_rect->MinX + 1, the_rect->MaxY - the_rect->MinY, the_color);
+	Window_AddDirtyRect(the_window, the_rect);
+}
+
+
+//! Clear a strip of the content area that was exposed by scrolling, and send the window an updateEvt asking for it to be redrawn
+//! @param	the_strip: the exposed area, in window-local coordinates
+static void Window_ExposeStrip(Window* the_window, Rectangle* the_strip)
+{
+	int16_t		width;
+	int16_t		height;
+	
+	width = the_strip->MaxX - the_strip->MinX + 1;
+	height = the_strip->MaxY - the_strip->MinY + 1;
+	
+	if (width < 1 || height < 1)
+	{
+		return;
+	}
+	
+	Window_FillClippedRect(the_window, the_strip, Theme_GetContentAreaColor(Sys_GetTheme(global_system)));
+	
+	EventManager_AddEvent(updateEvt, ((uint32_t)width << 16) | (uint32_t)height, the_strip->MinX - the_window->content_rect_.MinX, the_strip->MinY - the_window->content_rect_.MinY, 0L, the_window, NULL);
+}
+
+
+// **** Debug functions *****
+
+void Window_Print(Window* the_window)
+{
+	DEBUG_OUT(("Window print out:"));
+	DEBUG_OUT(("  address: %p", 		the_window));
+	DEBUG_OUT(("  id_: %i", 			the_window->id_));
+	DEBUG_OUT(("  display_order_: %i", 	the_window->display_order_));
+	DEBUG_OUT(("  user_data_: %i",		the_window->user_data_));
+	DEBUG_OUT(("  title_: '%s'",		the_window->title_));
+	DEBUG_OUT(("  state_: %i",			the_window->state_));
+	DEBUG_OUT(("  bitmap_: %p",			the_window->bitmap_));
+	DEBUG_OUT(("  buffer_bitmap_: %p",	the_window->buffer_bitmap_));
+	DEBUG_OUT(("  overall_rect_: %i, %i, %i, %i", the_window->overall_rect_.MinX, the_window->overall_rect_.MinY, the_window->overall_rect_.MaxX, the_window->overall_rect_.MaxY));
+	DEBUG_OUT(("  titlebar_rect_: %i, %i, %i, %i", the_window->titlebar_rect_.MinX, the_window->titlebar_rect_.MinY, the_window->titlebar_rect_.MaxX, the_window->titlebar_rect_.MaxY));
+	DEBUG_OUT(("  iconbar_rect_: %i, %i, %i, %i", the_window->iconbar_rect_.MinX, the_window->iconbar_rect_.MinY, the_window->iconbar_rect_.MaxX, the_window->iconbar_rect_.MaxY));
+	DEBUG_OUT(("  content_rect_: %i, %i, %i, %i", the_window->content_rect_.MinX, the_window->content_rect_.MinY, the_window->content_rect_.MaxX, the_window->content_rect_.MaxY));
+	DEBUG_OUT(("  grow_left_rect_: %i, %i, %i, %i", the_window->grow_left_rect_.MinX, the_window->grow_left_rect_.MinY, the_window->grow_left_rect_.MaxX, the_window->grow_left_rect_.MaxY));
+	DEBUG_OUT(("  grow_right_rect_: %i, %i, %i, %i", the_window->grow_right_rect_.MinX, the_window->grow_right_rect_.MinY, the_window->grow_right_rect_.MaxX, the_window->grow_right_rect_.MaxY));
+	DEBUG_OUT(("  grow_top_rect_: %i, %i, %i, %i", the_window->grow_top_rect_.MinX, the_window->grow_top_rect_.MinY, the_window->grow_top_rect_.MaxX, the_window->grow_top_rect_.MaxY));
+	DEBUG_OUT(("  grow_bottom_rect_: %i, %i, %i, %i", the_window->grow_bottom_rect_.MinX, the_window->grow_bottom_rect_.MinY, the_window->grow_bottom_rect_.MaxX, the_window->grow_bottom_rect_.MaxY));
+	DEBUG_OUT(("  show_iconbar_: %i",	the_window->show_iconbar_));
+	DEBUG_OUT(("  is_backdrop_: %i",	the_window->is_backdrop_));
+	DEBUG_OUT(("  visible_: %i",		the_window->visible_));
+	DEBUG_OUT(("  active_: %i",			the_window->active_));
+	DEBUG_OUT(("  changes_to_save_: %i",	the_window->changes_to_save_));
+	DEBUG_OUT(("  can_resize_: %i",		the_window->can_resize_));	
+	DEBUG_OUT(("  x_: %i",				the_window->x_));	
+	DEBUG_OUT(("  y_: %i",				the_window->y_));	
+	DEBUG_OUT(("  width_: %i",			the_window->width_));	
+	DEBUG_OUT(("  height_: %i",			the_window->height_));	
+	DEBUG_OUT(("  min_width_: %i",		the_window->min_width_));	
+	DEBUG_OUT(("  min_height_: %i",		the_window->min_height_));	
+	DEBUG_OUT(("  max_width_: %i",		the_window->max_width_));	
+	DEBUG_OUT(("  max_height_: %i",		the_window->max_height_));	
+	DEBUG_OUT(("  inner_width_: %i",	the_window->inner_width_));	
+	DEBUG_OUT(("  inner_height_: %i",	the_window->inner_height_));	
+	DEBUG_OUT(("  avail_title_width_: %i",	the_window->avail_title_width_));	
+	DEBUG_OUT(("  content_left_: %i",	the_window->content_left_));	
+	DEBUG_OUT(("  content_top_: %i",	the_window->content_top_));	
+	DEBUG_OUT(("  required_inner_width_: %i",		the_window->required_inner_width_));	
+	DEBUG_OUT(("  required_inner_height_: %i",		the_window->required_inner_height_));	
+	DEBUG_OUT(("  h_scroller_visible_: %i",			the_window->h_scroller_visible_));	
+	DEBUG_OUT(("  v_scroller_visible_: %i",			the_window->v_scroller_visible_));	
+	DEBUG_OUT(("  pattern_: %p",		the_window->pattern_));	
+	DEBUG_OUT(("  parent_window_: %p",	the_window->parent_window_));	
+	DEBUG_OUT(("  child_window_: %p",	the_window->child_window_));	
+	DEBUG_OUT(("  root_control_: %p",	the_window->root_control_));	
+}
+
+
+// helper function called by List class's print function: prints one window entry
+void Window_PrintBrief(void* the_payload)
+{
+	Window*		this_window = (Window*)(the_payload);
 
 	DEBUG_OUT(("%s %d: %s (%p, %i)", __func__ , __LINE__, (this_window->is_backdrop_ == false ? this_window->title_ : (char*)"Backdrop"), this_window, this_window->display_order_ ));
 
@@ -875,6 +1481,9 @@ Window* Window_New(NewWinTemplate* the_win_template, void (* event_handler)(Even
 	// assign the bitmap passed by win_setup, or allocate a new one
 	if ( the_win_template->bitmap_ == NULL)
 	{
+		// make room within the system's backing store budget, if one is set
+		Sys_ReclaimBackingStore(global_system, (uint32_t)the_win_template->width_ * the_win_template->height_, NULL);
+		
 		if ( (the_window->bitmap_ = Bitmap_New(the_win_template->width_, the_win_template->height_, Sys_GetAppFont(global_system), PARAM_NOT_IN_VRAM)) == NULL)
 		{
 			LOG_ERR(("%s %d: Failed to create bitmap", __func__, __LINE__));
@@ -910,7 +1519,9 @@ Window* Window_New(NewWinTemplate* the_win_template, void (* event_handler)(Even
 	the_window->can_resize_ = the_win_template->can_resize_;
 	the_window->clip_count_ = 0;
 	the_window->event_handler_ = event_handler;
+	the_window->event_mask_ = WIN_DEFAULT_EVENT_MASK;
 	the_window->selected_control_ = NULL;
+	the_window->control_index_invalidated_ = true;
 	
 	// set up the rects for titlebar, content, etc. 
 	Window_ConfigureStructureRects(the_window);
@@ -1015,6 +1626,8 @@ bool Window_Destroy(Window** the_window)
 		Bitmap_Destroy(&(*the_window)->bitmap_);
 	}
 	
+	Window_FreeControlIndex(*the_window);
+	
 	LOG_ALLOC(("%s %d:	__FREE__	*the_window	%p	size	%i", __func__ , __LINE__, *the_window, sizeof(Window)));
 	free(*the_window);
 	*the_window = NULL;
@@ -1167,6 +1780,13 @@ bool Window_BlitClipRects(Window* the_window)
 		return true; // not an error condition
 	}
 	
+	// if the system discarded this window's bitmap to save memory, there is nothing to blit from until it is rebuilt
+	if (Window_EnsureBackingStore(the_window) == false)
+	{
+		LOG_ERR(("%s %d: could not rebuild window storage!", __func__ , __LINE__));
+		goto error;
+	}
+	
 	the_screen_bitmap = Sys_GetScreenBitmap(global_system, back_layer);
 	
 	for (i = 0; i < the_window->clip_count_; i++)
@@ -1406,6 +2026,7 @@ bool Window_AddControl(Window* the_window, Control* the_control)
 		Control_SetNextControl(last_control_in_window, the_control);
 		Control_SetNextControl(the_control, NULL);
 		Control_SetActive(the_control, CONTROL_ACTIVE);
+		the_window->control_index_invalidated_ = true;
 		//DEBUG_OUT(("%s %d: control (%p, type=%i) added!", __func__, __LINE__, the_control, the_control->type_));
 		
 		return true;
@@ -1614,6 +2235,45 @@ Control* Window_GetControl(Window* the_window, uint16_t the_control_id)
 		goto error;
 	}
 	
+	// LOGIC:
+	//   The control index keeps a copy of the control list sorted by ID, so it can be binary searched
+	//   If the index couldn't be built, walk the list instead
+	
+	if (the_window->control_index_invalidated_)
+	{
+		Window_RebuildControlIndex(the_window);
+	}
+	
+	if (the_window->control_index_invalidated_ == false && the_window->control_index_too_big_ == false)
+	{
+		int16_t		low = 0;
+		int16_t		high = the_window->control_index_count_ - 1;
+		
+		while (low <= high)
+		{
+			int16_t		mid = (low + high) / 2;
+			uint16_t	this_id;
+			
+			the_control = the_window->control_id_index_[mid];
+			this_id = Control_GetID(the_control);
+			
+			if (this_id == the_control_id)
+			{
+				return the_control;
+			}
+			else if (this_id < the_control_id)
+			{
+				low = mid + 1;
+			}
+			else
+			{
+				high = mid - 1;
+			}
+		}
+		
+		return NULL;
+	}
+	
 	the_control = Window_GetRootControl(the_window);
 	
 	while (the_control)
@@ -1689,6 +2349,46 @@ Control* Window_GetControlAtXY(Window* the_window, int16_t x, int16_t y)
 	//   Controls are in a linked list property of the window
 	//   Unlike finding window under mouse, for control, we don't care about order
 	//   Programmer who allows overlapping controls is doing something wrong anyway!
+	//   The control index narrows the search to the controls touching the 32x32 cell under the point
+	//   If the index couldn't be built, walk the whole list instead
+	
+	if (the_window->control_index_invalidated_)
+	{
+		Window_RebuildControlIndex(the_window);
+	}
+	
+	if (the_window->control_index_invalidated_ == false && the_window->control_index_too_big_ == false)
+	{
+		Rectangle	the_point;
+		uint8_t		col;
+		uint8_t		row;
+		uint16_t	i;
+		uint16_t	the_cell;
+		
+		if (the_window->control_index_count_ == 0)
+		{
+			return NULL;
+		}
+		
+		// fold the point into the grid exactly the way control rects were folded when indexed
+		the_point.MinX = the_point.MaxX = x;
+		the_point.MinY = the_point.MaxY = y;
+		Window_GetControlIndexCells(the_window, &the_point, &col, &row, &col, &row);
+		
+		the_cell = row * the_window->control_index_cols_ + col;
+		
+		for (i = the_window->control_index_start_[the_cell]; i < the_window->control_index_start_[the_cell + 1]; i++)
+		{
+			the_control = the_window->control_index_[i];
+			
+			if (General_PointInRect(x, y, the_control->rect_))
+			{
+				return the_control;
+			}
+		}
+		
+		return NULL;
+	}
 		
 	the_control = the_window->root_control_;
 
@@ -1725,6 +2425,7 @@ void Window_Render(Window* the_window)
 {
 	Theme*	the_theme;
 	Bitmap*	the_pattern;
+	int16_t	i;
 	
 	if (the_window == NULL)
 	{
@@ -1749,13 +2450,51 @@ void Window_Render(Window* the_window)
 		return;
 	}
 	
+	// if the system discarded this window's bitmap to save memory, rebuild it, unless the window still can't be seen anyway
+	if (the_window->backing_store_evicted_)
+	{
+		if (Sys_WindowIsOccluded(global_system, the_window))
+		{
+			return;
+		}
+		
+		if (Window_EnsureBackingStore(the_window) == false)
+		{
+			LOG_ERR(("%s %d: could not rebuild window storage!", __func__ , __LINE__));
+			goto error;
+		}
+	}
+	
+	the_window->last_used_ = sys_time_jiffies();
+	
 	if (the_window->is_backdrop_)
 	{
-		if (the_window->invalidated_ == true)
+		// backdrop window: fill it with its pattern. no controls, borders, etc. 
+		// tile the default theme's background pattern
+		
+		// LOGIC:
+		//   the backdrop's bitmap is the screen, so other windows blitting to the screen draw over its pattern. the damage rects they leave behind are its clip rects.
+		//   if the whole backdrop is invalid, or it has as many clip rects as it can track (so some damage may have been dropped), re-tile all of it.
+		//   otherwise, re-tile only the clip rects. the tiler keeps the pattern lined up with the top left of the bitmap, so the repairs match what is around them.
+		//   either way, the pattern is tiled straight into the screen, so there is nothing left to blit.
+		
+		if (the_window->invalidated_ == true || the_window->clip_count_ >= WIN_MAX_CLIP_RECTS)
+		{
+			Bitmap_Tile(the_pattern, 0, 0, the_window->bitmap_, the_theme->pattern_width_, the_theme->pattern_height_, NULL);
+		}
+		else
+		{
+			for (i = 0; i < the_window->clip_count_; i++)
+			{
+				Bitmap_Tile(the_pattern, 0, 0, the_window->bitmap_, the_theme->pattern_width_, the_theme->pattern_height_, &the_window->clip_rect_[i]);
+			}
+		}
+		
+		if (the_window->bitmap_ == Sys_GetScreenBitmap(global_system, back_layer))
 		{
-			// backdrop window: fill it with its pattern. no controls, borders, etc. 
-			// tile the default theme's background pattern
-			Bitmap_Tile(the_pattern, 0, 0, the_window->bitmap_, the_theme->pattern_width_, the_theme->pattern_height_);
+			the_window->clip_count_ = 0;
+			the_window->invalidated_ = false;
+			return;
 		}
 	}
 	else
@@ -1851,9 +2590,15 @@ void Window_ClearContent(Window* the_window)
 		goto error;
 	}
 
+	if (Window_EnsureBackingStore(the_window) == false)
+	{
+		goto error;
+	}
+	
 	the_theme = Sys_GetTheme(global_system);
 
 	Bitmap_FillBoxRect(the_window->bitmap_, &the_window->content_rect_, Theme_GetContentAreaColor(the_theme));
+	Window_AddDirtyRect(the_window, &the_window->content_rect_);
 	
 	return;
 	
@@ -1888,31 +2633,108 @@ error:
 }
 
 
-
-
-// **** Set functions *****
-
-
-
-// replace the current window title with the passed string
-// Note: the passed string will be copied into storage by the window. The passing function can dispose of the passed string when done.
-void Window_SetTitle(Window* the_window, char* the_title)
+//! Discard the window's off-screen bitmap storage to free memory. The window keeps its size, controls, etc.
+//! WARNING: This function is designed to be called by the system only (see Sys_ReclaimBackingStore()): do not use this
+//! @param	the_window: reference to a valid Window object.
+//! @return:	Returns false on any error condition
+bool Window_EvictBackingStore(Window* the_window)
 {
 	if (the_window == NULL)
 	{
 		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
 		goto error;
 	}
-
-	if (the_window->title_)
+	
+	if (the_window->backing_store_evicted_)
 	{
-		LOG_ALLOC(("%s %d:	__FREE__	the_window->title_	%p	size	%i		'%s'", __func__ , __LINE__, the_window->title_, General_Strnlen(the_window->title_, WINDOW_MAX_WINTITLE_SIZE) + 1, the_window->title_));
-		free(the_window->title_);
+		return true;
 	}
 	
-	if ( (the_window->title_ = General_StrlcpyWithAlloc(the_title, WINDOW_MAX_WINTITLE_SIZE)) == NULL)
+	if (Bitmap_ReleaseStorage(the_window->bitmap_) == false)
 	{
-		LOG_ERR(("%s %d: could not allocate memory for the window name string", __func__ , __LINE__));
+		return false;
+	}
+	
+	// anything queued up to be blitted is gone with the bitmap
+	the_window->clip_count_ = 0;
+	the_window->backing_store_evicted_ = true;
+	
+	return true;
+	
+error:
+	Sys_Destroy(&global_system);	// crash early, crash often
+	return false;
+}
+
+
+//! Re-allocate a discarded off-screen bitmap, redraw the window structure and controls into it via Window_DrawAll(), and send the window an updateEvt so it can redraw its content
+//! WARNING: This function is designed to be called by the system only (see Sys_RestoreBackingStore()): do not use this
+//! @param	the_window: reference to a valid Window object.
+//! @return:	Returns false on any error condition
+bool Window_RebuildBackingStore(Window* the_window)
+{
+	if (the_window == NULL)
+	{
+		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
+		goto error;
+	}
+	
+	if (the_window->backing_store_evicted_ == false)
+	{
+		return true;
+	}
+	
+	if (Bitmap_RestoreStorage(the_window->bitmap_) == false)
+	{
+		return false;
+	}
+	
+	the_window->backing_store_evicted_ = false;
+	
+	// LOGIC:
+	//   the system can rebuild the window's frame and controls, but only the app knows what was in the content area
+	//   draw everything now (rather than just invalidating), so that any drawing the app does before the next render lands on a finished window
+	//   queue the whole window for blitting, and send an update event so the app redraws its content
+	
+	Window_InvalidateTitlebar(the_window);
+	Window_DrawAll(the_window);
+	Window_AddClipRect(the_window, &the_window->overall_rect_);
+	
+	EventManager_AddEvent(updateEvt, 0L, -1, -1, 0L, the_window, NULL);
+	
+	return true;
+	
+error:
+	Sys_Destroy(&global_system);	// crash early, crash often
+	return false;
+}
+
+
+
+
+// **** Set functions *****
+
+
+
+// replace the current window title with the passed string
+// Note: the passed string will be copied into storage by the window. The passing function can dispose of the passed string when done.
+void Window_SetTitle(Window* the_window, char* the_title)
+{
+	if (the_window == NULL)
+	{
+		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
+		goto error;
+	}
+
+	if (the_window->title_)
+	{
+		LOG_ALLOC(("%s %d:	__FREE__	the_window->title_	%p	size	%i		'%s'", __func__ , __LINE__, the_window->title_, General_Strnlen(the_window->title_, WINDOW_MAX_WINTITLE_SIZE) + 1, the_window->title_));
+		free(the_window->title_);
+	}
+	
+	if ( (the_window->title_ = General_StrlcpyWithAlloc(the_title, WINDOW_MAX_WINTITLE_SIZE)) == NULL)
+	{
+		LOG_ERR(("%s %d: could not allocate memory for the window name string", __func__ , __LINE__));
 		goto error;
 	}
 	LOG_ALLOC(("%s %d:	__ALLOC__	the_window->title_	%p	size	%i		'%s'", __func__ , __LINE__, the_window->title_, General_Strnlen(the_window->title_, WINDOW_MAX_WINTITLE_SIZE) + 1, the_window->title_));
@@ -1946,6 +2768,149 @@ error:
 }
 
 
+//! Set which kinds of events the window wants to receive
+//! Events of other kinds are dropped by the event manager before any handler is called, and where possible, before they are queued.
+//! The system still does its own processing of mouse events (activating windows, pressing controls, dragging, etc.) regardless of the mask.
+//! @param	the_window: reference to a valid Window object.
+//! @param	the_mask: event_mask bits (see event.h) for each kind of event wanted. Windows start with WIN_DEFAULT_EVENT_MASK.
+void Window_SetEventMask(Window* the_window, uint32_t the_mask)
+{
+	if (the_window == NULL)
+	{
+		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
+		goto error;
+	}
+	
+	the_window->event_mask_ = the_mask;
+	
+	return;
+	
+error:
+	Sys_Destroy(&global_system);	// crash early, crash often
+	return;
+}
+
+
+//! Register a handler for one kind of event, to be called instead of the window's main event handler
+//! NOTE: this does not change the event mask: the kind must also be in the window's event mask for the handler to be called.
+//! @param	the_window: reference to a valid Window object.
+//! @param	the_event_kind: the event_kind (see event.h) the handler is for
+//! @param	the_handler: the function to call for events of that kind, or NULL to go back to using the main event handler
+//! @return	Returns false if the event kind is out of range
+bool Window_SetEventHandlerForKind(Window* the_window, uint8_t the_event_kind, void (*the_handler)(EventRecord*))
+{
+	if (the_window == NULL)
+	{
+		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
+		goto error;
+	}
+	
+	if (the_event_kind >= WIN_EVENT_KIND_COUNT)
+	{
+		LOG_WARN(("%s %d: event kind %u is out of range", __func__ , __LINE__, the_event_kind));
+		return false;
+	}
+	
+	the_window->kind_handler_[the_event_kind] = the_handler;
+	
+	return true;
+	
+error:
+	Sys_Destroy(&global_system);	// crash early, crash often
+	return false;
+}
+
+
+//! Attach a menu group to the window, adding the keyboard shortcuts of its items to the window's shortcut table
+//! Once attached, a keyDown in the window that matches a shortcut is turned into a menuSelected event for the item, without the menu being opened.
+//! Attach each submenu group as well, if its items have shortcuts. The menu group must stay allocated while attached.
+//! @param	the_window: reference to a valid Window object.
+//! @param	the_menu_group: reference to a valid MenuGroup
+//! @return	Returns false if the shortcut table was too full to take all the group's shortcuts
+bool Window_AttachMenuGroup(Window* the_window, MenuGroup* the_menu_group)
+{
+	MenuItem*	this_item;
+	int16_t		i;
+	int16_t		the_slot;
+	uint8_t		the_key;
+	uint8_t		the_modifiers;
+	bool		all_added = true;
+	
+	if (the_window == NULL)
+	{
+		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
+		goto error;
+	}
+	
+	if (the_menu_group == NULL)
+	{
+		LOG_ERR(("%s %d: passed menu group was null", __func__ , __LINE__));
+		goto error;
+	}
+	
+	// LOGIC:
+	//   only plain menu items can be chosen by shortcut: dividers do nothing, and a submenu item only opens its group
+	//   if two items use the same key combination, the one attached last wins
+	
+	for (i = 0; i < the_menu_group->num_menu_items_; i++)
+	{
+		this_item = the_menu_group->item_[i];
+		
+		if (this_item == NULL || this_item->type_ != menuItem || this_item->shortcut_ == 0)
+		{
+			continue;
+		}
+		
+		the_key = toupper(this_item->shortcut_);
+		the_modifiers = Window_GetShortcutModifiers(this_item->modifiers_);
+		the_slot = Window_FindShortcutSlot(the_window, the_key, the_modifiers);
+		
+		if (the_slot < 0)
+		{
+			LOG_WARN(("%s %d: no room for the shortcut of menu item %i in window '%s'", __func__ , __LINE__, this_item->id_, the_window->title_));
+			all_added = false;
+			continue;
+		}
+		
+		if (the_window->shortcut_[the_slot].key_ == 0)
+		{
+			the_window->shortcut_count_++;
+		}
+		
+		the_window->shortcut_[the_slot].key_ = the_key;
+		the_window->shortcut_[the_slot].modifiers_ = the_modifiers;
+		the_window->shortcut_[the_slot].menu_id_ = this_item->id_;
+	}
+	
+	return all_added;
+	
+error:
+	Sys_Destroy(&global_system);	// crash early, crash often
+	return false;
+}
+
+
+//! Remove all keyboard shortcuts from the window, eg, before attaching a different set of menu groups
+//! @param	the_window: reference to a valid Window object.
+void Window_ClearShortcuts(Window* the_window)
+{
+	if (the_window == NULL)
+	{
+		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
+		goto error;
+	}
+	
+	memset(the_window->shortcut_, 0, sizeof(the_window->shortcut_));
+	the_window->shortcut_count_ = 0;
+	
+	return;
+	
+error:
+	Sys_Destroy(&global_system);	// crash early, crash often
+	return;
+}
+
+
 //! Set the display order of the window
 //! NOTE: This does not immediately re-render or change the display order visibly.
 //! WARNING: This function is designed to be called by the system only: do not use this
@@ -2099,6 +3064,12 @@ void Window_ChangeWindow(Window* the_window, int16_t x, int16_t y, int16_t width
 			width_changed = true;
 		}
 		
+		// control index cells are window-local, so only a size change affects them
+		if (width_changed || the_window->height_ != height)
+		{
+			the_window->control_index_invalidated_ = true;
+		}
+		
 		if (update_norm)
 		{
 			the_window->norm_x_ = x;
@@ -2119,6 +3090,9 @@ void Window_ChangeWindow(Window* the_window, int16_t x, int16_t y, int16_t width
 		the_window->global_rect_.MinY = the_window->y_;
 		the_window->global_rect_.MaxY = the_window->y_ + the_window->height_ - 1;
 
+		// keep the system's hit-testing grid in step with the new position/size
+		Sys_UpdateWindowGrid(global_system, the_window, &the_old_rect);
+
 		// create damage rects at this point - does not percolate them anywhere, or do any rendering
 		Window_GenerateDamageRects(the_window, &the_old_rect);
 		Sys_IssueDamageRects(global_system);
@@ -2130,7 +3104,18 @@ void Window_ChangeWindow(Window* the_window, int16_t x, int16_t y, int16_t width
 		the_window->invalidated_ = true;
 		Window_InvalidateTitlebar(the_window);
 
-		// get bigger storage if necessary
+		// get bigger storage if necessary, making room within the system's backing store budget first
+		if (the_window->backing_store_evicted_ == false)
+		{
+			uint32_t	old_size = the_window->bitmap_->alloc_size_;
+			uint32_t	new_size = (uint32_t)width * height;
+			
+			if (new_size > old_size)
+			{
+				Sys_ReclaimBackingStore(global_system, new_size - old_size, the_window);
+			}
+		}
+		
 		if (Bitmap_Resize(the_window->bitmap_, width, height) == false)
 		{
 			LOG_ERR(("%s %d: could not resize window storage!", __func__ , __LINE__));
@@ -2315,6 +3300,58 @@ error:
 }
 
 
+//! @return	Returns the event_mask bits for the kinds of event the window wants
+uint32_t Window_GetEventMask(Window* the_window)
+{
+	if (the_window == NULL)
+	{
+		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
+		goto error;
+	}
+	
+	return the_window->event_mask_;
+	
+error:
+	Sys_Destroy(&global_system);	// crash early, crash often
+	return 0;
+}
+
+
+//! Find the menu item a key combination is the shortcut for, in constant time
+//! @param	the_window: reference to a valid Window object.
+//! @param	the_key: the character of the key pressed. Case does not matter.
+//! @param	the_modifiers: the event_modifier_flags in effect. Left- and right-hand modifier keys are treated alike, and alpha lock is ignored.
+//! @return	Returns the id_ of the menu item, or MENU_ID_NO_SELECTION if the key combination is not a shortcut in this window
+int16_t Window_FindShortcut(Window* the_window, unsigned char the_key, uint16_t the_modifiers)
+{
+	int16_t		the_slot;
+	
+	if (the_window == NULL)
+	{
+		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
+		goto error;
+	}
+	
+	if (the_window->shortcut_count_ == 0 || the_key == 0)
+	{
+		return MENU_ID_NO_SELECTION;
+	}
+	
+	the_slot = Window_FindShortcutSlot(the_window, toupper(the_key), Window_GetShortcutModifiers(the_modifiers));
+	
+	if (the_slot < 0 || the_window->shortcut_[the_slot].key_ == 0)
+	{
+		return MENU_ID_NO_SELECTION;
+	}
+	
+	return the_window->shortcut_[the_slot].menu_id_;
+	
+error:
+	Sys_Destroy(&global_system);	// crash early, crash often
+	return MENU_ID_NO_SELECTION;
+}
+
+
 //! Get the value stored in the user data field of the window.
 //! NOTE: this field is for the exclusive use of application programs. The system will not act on this data in any way: you are free to store whatever 4-byte value you want here.
 //! @param	the_window: reference to a valid Window object.
@@ -2385,6 +3422,12 @@ Bitmap* Window_GetBitmap(Window* the_window)
 		goto error;
 	}
 	
+	// caller is likely to draw into the bitmap, so it needs storage
+	if (Window_EnsureBackingStore(the_window) == false)
+	{
+		goto error;
+	}
+	
 	return the_window->bitmap_;
 	
 error:
@@ -2530,6 +3573,166 @@ error:
 
 
 
+// **** SCROLL functions *****
+
+
+//! Tell the window how much space its content needs, so it knows how far it can be scrolled
+//! The scroll position will be adjusted if it is now out of range. Scroller visibility flags are updated to match.
+//! @param	the_window: reference to a valid Window object.
+//! @param	required_width: the total H space, in pixels, needed to display all of the window's content.
+//! @param	required_height: the total V space, in pixels, needed to display all of the window's content.
+void Window_SetContentSize(Window* the_window, int16_t required_width, int16_t required_height)
+{
+	if (the_window == NULL)
+	{
+		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
+		goto error;
+	}
+	
+	the_window->h_scroller_visible_ = (required_width > the_window->inner_width_);
+	the_window->v_scroller_visible_ = (required_height > the_window->inner_height_);
+	the_window->required_inner_width_ = (the_window->h_scroller_visible_) ? required_width : the_window->inner_width_;
+	the_window->required_inner_height_ = (the_window->v_scroller_visible_) ? required_height : the_window->inner_height_;
+	
+	// if content shrank, the current scroll position may no longer be valid
+	Window_ScrollTo(the_window, the_window->content_left_, the_window->content_top_);
+	
+	return;
+	
+error:
+	Sys_Destroy(&global_system);	// crash early, crash often
+	return;
+}
+
+
+//! Scroll the window's content so that the passed content position shows at the top left of the content area
+//! The existing pixels that remain visible are moved within the window's bitmap; they are not redrawn.
+//! The area newly exposed along the edge(s) is cleared, and the window is sent one updateEvt per exposed strip. 
+//!   Each event's x_ and y_ are the content-area-local top left of the strip, and its code_ has the strip's width in the high word, height in the low word.
+//!   Add content_left_ and content_top_ to translate the strip into content coordinates.
+//! If the scroll distance is larger than the content area, the whole content area is cleared and one updateEvt is sent for it.
+//! @param	the_window: reference to a valid Window object.
+//! @param	the_left: the H position within the content to scroll to. Will be clipped to the scrollable range.
+//! @param	the_top: the V position within the content to scroll to. Will be clipped to the scrollable range.
+//! @return:	Returns false on any error condition
+bool Window_ScrollTo(Window* the_window, int16_t the_left, int16_t the_top)
+{
+	Rectangle*	the_content;
+	Rectangle	the_strip;
+	int16_t		max_left;
+	int16_t		max_top;
+	int16_t		dx;
+	int16_t		dy;
+	int16_t		abs_dx;
+	int16_t		abs_dy;
+	int16_t		width;
+	int16_t		height;
+	
+	if (the_window == NULL)
+	{
+		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
+		goto error;
+	}
+	
+	max_left = the_window->required_inner_width_ - the_window->inner_width_;
+	max_top = the_window->required_inner_height_ - the_window->inner_height_;
+	max_left = (max_left < 0) ? 0 : max_left;
+	max_top = (max_top < 0) ? 0 : max_top;
+	
+	the_left = (the_left < 0) ? 0 : the_left;
+	the_left = (the_left > max_left) ? max_left : the_left;
+	the_top = (the_top < 0) ? 0 : the_top;
+	the_top = (the_top > max_top) ? max_top : the_top;
+	
+	dx = the_left - the_window->content_left_;
+	dy = the_top - the_window->content_top_;
+	
+	if (dx == 0 && dy == 0)
+	{
+		return true;
+	}
+	
+	the_window->content_left_ = the_left;
+	the_window->content_top_ = the_top;
+	
+	if (Window_EnsureBackingStore(the_window) == false)
+	{
+		goto error;
+	}
+	
+	the_content = &the_window->content_rect_;
+	width = the_content->MaxX - the_content->MinX + 1;
+	height = the_content->MaxY - the_content->MinY + 1;
+	abs_dx = (dx < 0) ? -dx : dx;
+	abs_dy = (dy < 0) ? -dy : dy;
+	
+	// LOGIC:
+	//   if nothing that was visible before is still visible, there is nothing to move: the app has to redraw everything
+	//   otherwise, move the part that is still visible with one (overlap-safe) blit, then ask the app for just the strip(s) that scrolled into view:
+	//     a full-width strip at the top or bottom for V scrolling, and a strip at the left or right, between those rows, for H scrolling
+	
+	if (abs_dx >= width || abs_dy >= height)
+	{
+		General_CopyRect(&the_strip, the_content);
+		Window_ExposeStrip(the_window, &the_strip);
+		return true;
+	}
+	
+	Bitmap_Blit(the_window->bitmap_, 
+				the_content->MinX + ((dx > 0) ? dx : 0), 
+				the_content->MinY + ((dy > 0) ? dy : 0), 
+				the_window->bitmap_, 
+				the_content->MinX + ((dx < 0) ? abs_dx : 0), 
+				the_content->MinY + ((dy < 0) ? abs_dy : 0), 
+				width - abs_dx, 
+				height - abs_dy
+				);
+	
+	Window_AddDirtyRect(the_window, the_content);
+	
+	the_strip.MinX = the_content->MinX;
+	the_strip.MaxX = the_content->MaxX;
+	the_strip.MinY = (dy > 0) ? the_content->MaxY - abs_dy + 1 : the_content->MinY;
+	the_strip.MaxY = (dy > 0) ? the_content->MaxY : the_content->MinY + abs_dy - 1;
+	Window_ExposeStrip(the_window, &the_strip);
+	
+	the_strip.MinX = (dx > 0) ? the_content->MaxX - abs_dx + 1 : the_content->MinX;
+	the_strip.MaxX = (dx > 0) ? the_content->MaxX : the_content->MinX + abs_dx - 1;
+	the_strip.MinY = (dy > 0) ? the_content->MinY : the_content->MinY + abs_dy;
+	the_strip.MaxY = (dy > 0) ? the_content->MaxY - abs_dy : the_content->MaxY;
+	Window_ExposeStrip(the_window, &the_strip);
+	
+	return true;
+	
+error:
+	Sys_Destroy(&global_system);	// crash early, crash often
+	return false;
+}
+
+
+//! Scroll the window's content by the passed number of pixels. See Window_ScrollTo().
+//! @param	the_window: reference to a valid Window object.
+//! @param	delta_x: number of pixels to scroll right (positive) or left (negative)
+//! @param	delta_y: number of pixels to scroll down (positive) or up (negative)
+//! @return:	Returns false on any error condition
+bool Window_ScrollBy(Window* the_window, int16_t delta_x, int16_t delta_y)
+{
+	if (the_window == NULL)
+	{
+		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
+		goto error;
+	}
+	
+	return Window_ScrollTo(the_window, the_window->content_left_ + delta_x, the_window->content_top_ + delta_y);
+	
+error:
+	Sys_Destroy(&global_system);	// crash early, crash often
+	return false;
+}
+
+
+
+
 // **** DRAWING functions *****
 
 
@@ -2635,8 +3838,8 @@ error:
 //! This also sets the pen position of the window's bitmap
 //! This is the location that the next pen-based graphics function will use for a starting location
 //! @param	the_window: reference to a valid Window object.
-//! @param	x: the global horizontal position to be converted to window-local. Will be clipped to the edges.
-//! @param	y: the global vertical position to be converted to window-local. Will be clipped to the edges.
+//! @param	x: the global horizontal position to be converted to content-area-local. Will be clipped to the edges.
+//! @param	y: the global vertical position to be converted to content-area-local. Will be clipped to the edges.
 //! @return Returns false on any error condition
 bool Window_SetPenXYFromGlobal(Window* the_window, int16_t x, int16_t y)
 {
@@ -2648,8 +3851,8 @@ bool Window_SetPenXYFromGlobal(Window* the_window, int16_t x, int16_t y)
 	
 	//DEBUG_OUT(("%s %d: window global rect: %i, %i - %i, %i", __func__ , __LINE__, the_window->global_rect_.MinX, the_window->global_rect_.MinY, the_window->global_rect_.MaxX, the_window->global_rect_.MaxY));
 	//DEBUG_OUT(("%s %d: x/y before making local: %i, %i", __func__ , __LINE__, x, y));
-	x -= the_window->x_;
-	y -= the_window->y_;
+	x -= the_window->x_ + the_window->content_rect_.MinX;
+	y -= the_window->y_ + the_window->content_rect_.MinY;
 	//DEBUG_OUT(("%s %d: x/y after making local: %i, %i", __func__ , __LINE__, x, y));
 	//DEBUG_OUT(("%s %d: content rect: %i, %i - %i, %i", __func__ , __LINE__, the_window->content_rect_.MinX, the_window->content_rect_.MinY, the_window->content_rect_.MaxX, the_window->content_rect_.MaxY));
 	
@@ -2710,20 +3913,47 @@ error:
 
 
 //! Blit from source bitmap to the window's content area, at the window's current pen coordinate
-//! The source bitmap can be the window's bitmap: you can use this to copy a chunk of pixels from one part of a window to another. If the destination location cannot fit the entirety of the copied rectangle, the copy will be truncated, but will not return an error. 
+//! The source bitmap can be the window's bitmap: you can use this to copy a chunk of pixels from one part of a window to another. If the content area cannot fit the entirety of the copied rectangle at the destination location, the copy will be truncated, but will not return an error. 
 //! @param	the_window: reference to a valid Window object.
 //! @param src_bm: the source bitmap. It must have a valid address within the VRAM memory space.
 //! @param src_x, src_y: the upper left coordinate within the source bitmap, for the rectangle you want to copy. May be negative.
 //! @param width, height: the scope of the copy, in pixels.
 bool Window_Blit(Window* the_window, Bitmap* src_bm, int16_t src_x, int16_t src_y, int16_t width, int16_t height)
 {
+	Rectangle	the_rect;
+	
 	if (the_window == NULL)
 	{
 		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
 		goto error;
 	}
 	
-	return Bitmap_Blit(src_bm, src_x, src_y, the_window->bitmap_, the_window->pen_x_, the_window->pen_y_, width, height);
+	if (Window_EnsureBackingStore(the_window) == false)
+	{
+		goto error;
+	}
+	
+	// localize to content area, and trim to it, shifting the source rect by whatever was trimmed from the top/left
+	the_rect.MinX = the_window->pen_x_ + the_window->content_rect_.MinX;
+	the_rect.MinY = the_window->pen_y_ + the_window->content_rect_.MinY;
+	the_rect.MaxX = the_rect.MinX + width - 1;
+	the_rect.MaxY = the_rect.MinY + height - 1;
+	src_x -= the_rect.MinX;
+	src_y -= the_rect.MinY;
+	
+	if (width < 1 || height < 1 || Window_ClipRectToContent(the_window, &the_rect) == false)
+	{
+		return true;
+	}
+	
+	if (Bitmap_Blit(src_bm, src_x + the_rect.MinX, src_y + the_rect.MinY, the_window->bitmap_, the_rect.MinX, the_rect.MinY, the_rect.MaxX - the_rect.MinX + 1, the_rect.MaxY - the_rect.MinY + 1) == false)
+	{
+		return false;
+	}
+	
+	Window_AddDirtyRect(the_window, &the_rect);
+	
+	return true;
 	
 error:
 	Sys_Destroy(&global_system);	// crash early, crash often
@@ -2739,13 +3969,33 @@ error:
 //! @return:	returns false on any error/invalid input.
 bool Window_FillBox(Window* the_window, int16_t width, int16_t height, uint8_t the_color)
 {
+	Rectangle	the_rect;
+	
 	if (the_window == NULL)
 	{
 		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
 		goto error;
 	}
 	
-	return Bitmap_FillBox(the_window->bitmap_, the_window->pen_x_, the_window->pen_y_, width, height, the_color);
+	if (Window_EnsureBackingStore(the_window) == false)
+	{
+		goto error;
+	}
+	
+	if (width < 1 || height < 1)
+	{
+		return true;
+	}
+	
+	// localize to content area
+	the_rect.MinX = the_window->pen_x_ + the_window->content_rect_.MinX;
+	the_rect.MinY = the_window->pen_y_ + the_window->content_rect_.MinY;
+	the_rect.MaxX = the_rect.MinX + width - 1;
+	the_rect.MaxY = the_rect.MinY + height - 1;
+	
+	Window_FillClippedRect(the_window, &the_rect, the_color);
+	
+	return true;
 	
 error:
 	Sys_Destroy(&global_system);	// crash early, crash often
@@ -2760,10 +4010,7 @@ error:
 //! @return:	returns false on any error/invalid input.
 bool Window_FillBoxRect(Window* the_window, Rectangle* the_coords, uint8_t the_color)
 {
-	int16_t		x1;
-	int16_t		y1;
-	int16_t		x2;
-	int16_t		y2;
+	Rectangle	the_rect;
 	
 	if (the_window == NULL)
 	{
@@ -2771,13 +4018,26 @@ bool Window_FillBoxRect(Window* the_window, Rectangle* the_coords, uint8_t the_c
 		goto error;
 	}
 	
+	if (Window_EnsureBackingStore(the_window) == false)
+	{
+		goto error;
+	}
+	
+	if (the_coords->MinX > the_coords->MaxX || the_coords->MinY > the_coords->MaxY)
+	{
+		LOG_WARN(("%s %d: illegal coordinates %i to %i, %i to %i", __func__, __LINE__, the_coords->MinX, the_coords->MaxX, the_coords->MinY, the_coords->MaxY));
+		return false;
+	}
+	
 	// localize to content area
-	x1 = the_coords->MinX + the_window->content_rect_.MinX;
-	y1 = the_coords->MinY + the_window->content_rect_.MinY;
-	x2 = the_coords->MaxX + the_window->content_rect_.MinX;
-	y2 = the_coords->MaxY + the_window->content_rect_.MinY;
+	the_rect.MinX = the_coords->MinX + the_window->content_rect_.MinX;
+	the_rect.MinY = the_coords->MinY + the_window->content_rect_.MinY;
+	the_rect.MaxX = the_coords->MaxX + the_window->content_rect_.MinX;
+	the_rect.MaxY = the_coords->MaxY + the_window->content_rect_.MinY;
 	
-	return Bitmap_FillBox(the_window->bitmap_, x1, y1, x2 - x1, y2 - y1, the_color);
+	Window_FillClippedRect(the_window, &the_rect, the_color);
+	
+	return true;
 	
 error:
 	Sys_Destroy(&global_system);	// crash early, crash often
@@ -2791,13 +4051,36 @@ error:
 //! @return:	returns false on any error/invalid input.
 bool Window_SetPixel(Window* the_window, uint8_t the_color)
 {
+	Rectangle	the_rect;
+	
 	if (the_window == NULL)
 	{
 		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
 		goto error;
 	}
 	
-	return Bitmap_SetPixelAtXY(the_window->bitmap_, the_window->pen_x_, the_window->pen_y_, the_color);
+	if (Window_EnsureBackingStore(the_window) == false)
+	{
+		goto error;
+	}
+	
+	// localize to content area
+	the_rect.MinX = the_rect.MaxX = the_window->pen_x_ + the_window->content_rect_.MinX;
+	the_rect.MinY = the_rect.MaxY = the_window->pen_y_ + the_window->content_rect_.MinY;
+	
+	if (Window_ClipRectToContent(the_window, &the_rect) == false)
+	{
+		return true;
+	}
+	
+	if (Bitmap_SetPixelAtXY(the_window->bitmap_, the_rect.MinX, the_rect.MinY, the_color) == false)
+	{
+		return false;
+	}
+	
+	Window_AddDirtyRect(the_window, &the_rect);
+	
+	return true;
 	
 error:
 	Sys_Destroy(&global_system);	// crash early, crash often
@@ -2816,19 +4099,42 @@ error:
 //! Based on http://rosettacode.org/wiki/Bitmap/Bresenham%27s_line_algorithm#C. Used in C128 Lich King. 
 bool Window_DrawLine(Window* the_window, int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint8_t the_color)
 {
+	Rectangle	the_rect;
+	
 	if (the_window == NULL)
 	{
 		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
 		goto error;
 	}
 	
+	if (Window_EnsureBackingStore(the_window) == false)
+	{
+		goto error;
+	}
+	
 	// localize to content area
 	x1 += the_window->content_rect_.MinX;
 	y1 += the_window->content_rect_.MinY;
 	x2 += the_window->content_rect_.MinX;
 	y2 += the_window->content_rect_.MinY;
 	
-	return Bitmap_DrawLine(the_window->bitmap_, x1, y1, x2, y2, the_color);
+	if (Window_ClipLineToContent(the_window, &x1, &y1, &x2, &y2) == false)
+	{
+		return true;
+	}
+	
+	if (Bitmap_DrawLine(the_window->bitmap_, x1, y1, x2, y2, the_color) == false)
+	{
+		return false;
+	}
+	
+	the_rect.MinX = (x1 < x2) ? x1 : x2;
+	the_rect.MaxX = (x1 < x2) ? x2 : x1;
+	the_rect.MinY = (y1 < y2) ? y1 : y2;
+	the_rect.MaxY = (y1 < y2) ? y2 : y1;
+	Window_AddDirtyRect(the_window, &the_rect);
+	
+	return true;
 	
 error:
 	Sys_Destroy(&global_system);	// crash early, crash often
@@ -2843,13 +4149,33 @@ error:
 //! @return:	returns false on any error/invalid input.
 bool Window_DrawHLine(Window* the_window, int16_t the_line_len, uint8_t the_color)
 {
+	Rectangle	the_rect;
+	
 	if (the_window == NULL)
 	{
 		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
 		goto error;
 	}
 	
-	return Bitmap_DrawHLine(the_window->bitmap_, the_window->pen_x_, the_window->pen_y_, the_line_len, the_color);
+	if (Window_EnsureBackingStore(the_window) == false)
+	{
+		goto error;
+	}
+	
+	// localize to content area
+	the_rect.MinX = the_window->pen_x_ + the_window->content_rect_.MinX;
+	the_rect.MinY = the_rect.MaxY = the_window->pen_y_ + the_window->content_rect_.MinY;
+	the_rect.MaxX = the_rect.MinX + the_line_len - 1;
+	
+	if (the_line_len < 1 || Window_ClipRectToContent(the_window, &the_rect) == false)
+	{
+		return true;
+	}
+	
+	Window_DrawClippedHLine(the_window, the_rect.MinX, the_rect.MinY, the_rect.MaxX - the_rect.MinX + 1, the_color);
+	Window_AddDirtyRect(the_window, &the_rect);
+	
+	return true;
 	
 error:
 	Sys_Destroy(&global_system);	// crash early, crash often
@@ -2864,13 +4190,33 @@ error:
 //! @return:	returns false on any error/invalid input.
 bool Window_DrawVLine(Window* the_window, int16_t the_line_len, uint8_t the_color)
 {
+	Rectangle	the_rect;
+	
 	if (the_window == NULL)
 	{
 		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
 		goto error;
 	}
 	
-	return Bitmap_DrawVLine(the_window->bitmap_, the_window->pen_x_, the_window->pen_y_, the_line_len, the_color);
+	if (Window_EnsureBackingStore(the_window) == false)
+	{
+		goto error;
+	}
+	
+	// localize to content area
+	the_rect.MinX = the_rect.MaxX = the_window->pen_x_ + the_window->content_rect_.MinX;
+	the_rect.MinY = the_window->pen_y_ + the_window->content_rect_.MinY;
+	the_rect.MaxY = the_rect.MinY + the_line_len - 1;
+	
+	if (the_line_len < 1 || Window_ClipRectToContent(the_window, &the_rect) == false)
+	{
+		return true;
+	}
+	
+	Window_DrawClippedVLine(the_window, the_rect.MinX, the_rect.MinY, the_rect.MaxY - the_rect.MinY + 1, the_color);
+	Window_AddDirtyRect(the_window, &the_rect);
+	
+	return true;
 	
 error:
 	Sys_Destroy(&global_system);	// crash early, crash often
@@ -2885,24 +4231,18 @@ error:
 //! @return:	returns false on any error/invalid input.
 bool Window_DrawBoxRect(Window* the_window, Rectangle* the_coords, uint8_t the_color)
 {
-	int16_t		x1;
-	int16_t		y1;
-	int16_t		x2;
-	int16_t		y2;
-	
 	if (the_window == NULL)
 	{
 		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
 		goto error;
 	}
 	
-	// localize to content area
-	x1 = the_coords->MinX + the_window->content_rect_.MinX;
-	y1 = the_coords->MinY + the_window->content_rect_.MinY;
-	x2 = the_coords->MaxX + the_window->content_rect_.MinX;
-	y2 = the_coords->MaxY + the_window->content_rect_.MinY;
+	if (Window_EnsureBackingStore(the_window) == false)
+	{
+		goto error;
+	}
 	
-	return Bitmap_DrawBoxCoords(the_window->bitmap_, x1, y1, x2, y2, the_color);
+	return Window_DrawBoxCoords(the_window, the_coords->MinX, the_coords->MinY, the_coords->MaxX, the_coords->MaxY, the_color);
 	
 error:
 	Sys_Destroy(&global_system);	// crash early, crash often
@@ -2920,19 +4260,39 @@ error:
 //! @return:	returns false on any error/invalid input.
 bool Window_DrawBoxCoords(Window* the_window, int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint8_t the_color)
 {
+	Rectangle	the_frame;
+	
 	if (the_window == NULL)
 	{
 		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
 		goto error;
 	}
 	
+	if (Window_EnsureBackingStore(the_window) == false)
+	{
+		goto error;
+	}
+	
 	// localize to content area
 	x1 += the_window->content_rect_.MinX;
 	y1 += the_window->content_rect_.MinY;
 	x2 += the_window->content_rect_.MinX;
 	y2 += the_window->content_rect_.MinY;
 	
-	return Bitmap_DrawBoxCoords(the_window->bitmap_, x1, y1, x2, y2, the_color);
+	if (x1 > x2 || y1 > y2)
+	{
+		LOG_WARN(("%s %d: illegal coordinates %i to %i, %i to %i", __func__, __LINE__, x1, x2, y1, y2));
+		return false;
+	}
+	
+	the_frame.MinX = x1;
+	the_frame.MinY = y1;
+	the_frame.MaxX = x2;
+	the_frame.MaxY = y2;
+	
+	Window_DrawClippedFrame(the_window, &the_frame, the_color);
+	
+	return true;
 	
 error:
 	Sys_Destroy(&global_system);	// crash early, crash often
@@ -2949,13 +4309,40 @@ error:
 //! @return:	returns false on any error/invalid input.
 bool Window_DrawBox(Window* the_window, int16_t width, int16_t height, uint8_t the_color, bool do_fill)
 {
+	Rectangle	the_rect;
+	
 	if (the_window == NULL)
 	{
 		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
 		goto error;
 	}
 	
-	return Bitmap_DrawBox(the_window->bitmap_, the_window->pen_x_, the_window->pen_y_, width, height, the_color, do_fill);
+	if (Window_EnsureBackingStore(the_window) == false)
+	{
+		goto error;
+	}
+	
+	if (width < 1 || height < 1)
+	{
+		return true;
+	}
+	
+	// localize to content area
+	the_rect.MinX = the_window->pen_x_ + the_window->content_rect_.MinX;
+	the_rect.MinY = the_window->pen_y_ + the_window->content_rect_.MinY;
+	the_rect.MaxX = the_rect.MinX + width - 1;
+	the_rect.MaxY = the_rect.MinY + height - 1;
+	
+	if (do_fill)
+	{
+		Window_FillClippedRect(the_window, &the_rect, the_color);
+	}
+	else
+	{
+		Window_DrawClippedFrame(the_window, &the_rect, the_color);
+	}
+	
+	return true;
 	
 error:
 	Sys_Destroy(&global_system);	// crash early, crash often
@@ -2973,13 +4360,41 @@ error:
 //! @return:	returns false on any error/invalid input.
 bool Window_DrawRoundBox(Window* the_window, int16_t width, int16_t height, int16_t radius, uint8_t the_color, bool do_fill)
 {
+	Rectangle	the_rect;
+	
 	if (the_window == NULL)
 	{
 		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
 		goto error;
 	}
 	
-	return Bitmap_DrawRoundBox(the_window->bitmap_, the_window->pen_x_, the_window->pen_y_, width, height, radius, the_color, do_fill);
+	if (Window_EnsureBackingStore(the_window) == false)
+	{
+		goto error;
+	}
+	
+	// localize to content area
+	the_rect.MinX = the_window->pen_x_ + the_window->content_rect_.MinX;
+	the_rect.MinY = the_window->pen_y_ + the_window->content_rect_.MinY;
+	the_rect.MaxX = the_rect.MinX + width - 1;
+	the_rect.MaxY = the_rect.MinY + height - 1;
+	
+	// LOGIC:
+	//   the arcs can't be trimmed piecemeal, so (as with the bitmap edges) a box that doesn't fit in the content area is refused
+	if (the_rect.MinX < the_window->content_rect_.MinX || the_rect.MinY < the_window->content_rect_.MinY || the_rect.MaxX > the_window->content_rect_.MaxX || the_rect.MaxY > the_window->content_rect_.MaxY)
+	{
+		LOG_WARN(("%s %d: round box (%i, %i, %i, %i) does not fit in content area", __func__, __LINE__, the_rect.MinX, the_rect.MinY, width, height));
+		return false;
+	}
+	
+	if (Bitmap_DrawRoundBox(the_window->bitmap_, the_rect.MinX, the_rect.MinY, width, height, radius, the_color, do_fill) == false)
+	{
+		return false;
+	}
+	
+	Window_AddDirtyRect(the_window, &the_rect);
+	
+	return true;
 	
 error:
 	Sys_Destroy(&global_system);	// crash early, crash often
@@ -2994,13 +4409,41 @@ error:
 //! @param	the_color: a 1-byte index to the current color LUT
 bool Window_DrawCircle(Window* the_window, int16_t radius, uint8_t the_color)
 {
+	Rectangle	the_rect;
+	
 	if (the_window == NULL)
 	{
 		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
 		goto error;
 	}
 	
-	return Bitmap_DrawCircle(the_window->bitmap_, the_window->pen_x_, the_window->pen_y_, radius, the_color);
+	if (Window_EnsureBackingStore(the_window) == false)
+	{
+		goto error;
+	}
+	
+	// localize to content area
+	the_rect.MinX = the_window->pen_x_ + the_window->content_rect_.MinX - radius;
+	the_rect.MinY = the_window->pen_y_ + the_window->content_rect_.MinY - radius;
+	the_rect.MaxX = the_rect.MinX + radius * 2;
+	the_rect.MaxY = the_rect.MinY + radius * 2;
+	
+	// LOGIC:
+	//   the arc can't be trimmed piecemeal, so a circle that doesn't fit in the content area is refused
+	if (the_rect.MinX < the_window->content_rect_.MinX || the_rect.MinY < the_window->content_rect_.MinY || the_rect.MaxX > the_window->content_rect_.MaxX || the_rect.MaxY > the_window->content_rect_.MaxY)
+	{
+		LOG_WARN(("%s %d: circle (radius %i) does not fit in content area", __func__, __LINE__, radius));
+		return false;
+	}
+	
+	if (Bitmap_DrawCircle(the_window->bitmap_, the_rect.MinX + radius, the_rect.MinY + radius, radius, the_color) == false)
+	{
+		return false;
+	}
+	
+	Window_AddDirtyRect(the_window, &the_rect);
+	
+	return true;
 	
 error:
 	Sys_Destroy(&global_system);	// crash early, crash often
@@ -3015,13 +4458,65 @@ error:
 // If max_chars is -1, then the full string length will be drawn, as space allows.
 bool Window_DrawString(Window* the_window, char* the_string, int16_t max_chars)
 {
+	Rectangle	the_rect;
+	Font*		the_font;
+	int16_t		fit_count;
+	int16_t		pixels_used;
+	
 	if (the_window == NULL)
 	{
 		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
 		goto error;
 	}
 	
-	return Font_DrawString(the_window->bitmap_, the_string, max_chars);
+	if (Window_EnsureBackingStore(the_window) == false)
+	{
+		goto error;
+	}
+	
+	// LOGIC:
+	//   Font_DrawString() only truncates at the edge of the bitmap, so work out how much fits before the edge of the content area
+	//   the bitmap's pen was localized to the content area by Window_SetPenXY()
+	
+	the_font = the_window->bitmap_->font_;
+	the_rect.MinX = the_window->bitmap_->x_;
+	the_rect.MinY = the_window->bitmap_->y_;
+	the_rect.MaxY = the_rect.MinY + the_font->fRectHeight - 1;
+
+	if (the_rect.MinX > the_window->content_rect_.MaxX || the_rect.MaxY > the_window->content_rect_.MaxY)
+	{
+		LOG_WARN(("%s %d: string at %i, %i does not fit in content area", __func__, __LINE__, the_rect.MinX, the_rect.MinY));
+		return false;
+	}
+	
+	fit_count = strlen(the_string);
+	
+	if (max_chars == GEN_NO_STRLEN_CAP || max_chars > fit_count)
+	{
+		max_chars = fit_count;
+	}
+	
+	fit_count = Font_MeasureStringWidth(the_font, the_string, max_chars, the_window->content_rect_.MaxX - the_rect.MinX + 1, 0, &pixels_used);
+	
+	if (fit_count < 1)
+	{
+		return (fit_count == 0);
+	}
+	
+	if (Font_DrawString(the_window->bitmap_, the_string, fit_count) == false)
+	{
+		return false;
+	}
+	
+	// the bitmap's pen has now been advanced past the last character drawn
+	the_rect.MaxX = the_window->bitmap_->x_ - 1;
+	
+	if (Window_ClipRectToContent(the_window, &the_rect))
+	{
+		Window_AddDirtyRect(the_window, &the_rect);
+	}
+	
+	return true;
 	
 error:
 	Sys_Destroy(&global_system);	// crash early, crash often
@@ -3042,24 +4537,40 @@ error:
 //! @return:	returns a pointer to the first character in the string after which it stopped processing (if string is too long to be displayed in its entirety). Returns the original string if the entire string was processed successfully. Returns NULL in the event of any error.
 char* Window_DrawStringInBox(Window* the_window, int16_t width, int16_t height, char* the_string, int16_t num_chars, char** wrap_buffer, bool (* continue_function)(void))
 {
+	Rectangle	the_rect;
+	char*		the_result;
+	
 	if (the_window == NULL)
 	{
 		LOG_ERR(("%s %d: passed class object was null", __func__ , __LINE__));
 		goto error;
 	}
 	
-	// the next routine will check if it fits in the bitmap, but won't check if it fits within the window's content area
-	if (the_window->pen_x_ + width > the_window->inner_width_)
+	if (Window_EnsureBackingStore(the_window) == false)
 	{
-		width -= the_window->inner_width_ - the_window->pen_x_;
+		goto error;
 	}
 	
-	if (the_window->pen_y_ + height > the_window->inner_height_)
+	// the next routine will check if it fits in the bitmap, but won't check if it fits within the window's content area
+	the_rect.MinX = the_window->bitmap_->x_;
+	the_rect.MinY = the_window->bitmap_->y_;
+	the_rect.MaxX = the_rect.MinX + width - 1;
+	the_rect.MaxY = the_rect.MinY + height - 1;
+	
+	if (Window_ClipRectToContent(the_window, &the_rect) == false)
 	{
-		height -= the_window->inner_height_ - the_window->pen_y_;
+		LOG_WARN(("%s %d: text box does not fit in content area", __func__, __LINE__));
+		return NULL;
 	}
 	
-	return Font_DrawStringInBox(the_window->bitmap_, width, height, the_string, num_chars, wrap_buffer, continue_function);
+	width = the_rect.MaxX - the_rect.MinX + 1;
+	height = the_rect.MaxY - the_rect.MinY + 1;
+	
+	the_result = Font_DrawStringInBox(the_window->bitmap_, width, height, the_string, num_chars, wrap_buffer, continue_function);
+	
+	Window_AddDirtyRect(the_window, &the_rect);
+	
+	return the_result;
 	
 error:
 	Sys_Destroy(&global_system);	// crash early, crash often
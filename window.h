@@ -78,6 +78,14 @@
 #define WIN_MAX_CLIP_RECTS				10	//! if a window accumulates more clip rects than this, it will refresh the entire window in one go
 #define WIN_MENU_MAX_GROUPS				4	//! Maximum number of menus levels that can be defined per window
 
+#define WIN_EVENT_KIND_COUNT			18			//! number of event kinds a window can register its own handler for. Must equal numEventKinds in event.h, which this header can't see: event.c fails to compile if they differ.
+#define WIN_DEFAULT_EVENT_MASK			0x0002FFFE	//! everyEvent, less mouseMovedMask: by default, windows don't track the mouse when no button is down. Checked against event.h the same way.
+
+#define WIN_SHORTCUT_TABLE_SIZE			32		//! slots in a window's keyboard shortcut table. Must be a power of 2. Kept well above the number of shortcuts a window will have, so lookups take 1 or 2 probes.
+
+#define WIN_CONTROL_INDEX_CELL_SHIFT	5		//! controls are indexed for hit-testing in cells of 32x32 pixels (window-local)
+#define WIN_CONTROL_INDEX_MAX_ENTRIES	65535	//! if controls cover more cell slots than this in total, hit-testing falls back to walking the control list
+
 #define WIN_PARAM_OPEN_AS_BACKDROP				true	// Window_New() parameter
 #define WIN_PARAM_DO_NOT_OPEN_AS_BACKDROP		false	// Window_New() parameter
 
@@ -126,6 +134,13 @@ typedef enum window_base_control_id
 /*****************************************************************************/
 
 
+typedef struct WindowShortcut
+{
+	uint8_t					key_;							// the shortcut key, upper case. 0 if the slot is unused.
+	uint8_t					modifiers_;						// high byte of the event_modifier_flags that must be held down, with right-hand modifier keys counted as left-hand ones
+	int16_t					menu_id_;						// id_ of the menu item the shortcut selects
+} WindowShortcut;
+
 struct ClipRect
 {
 	int16_t					x_;								// horizontal coordinate, relative to the parent window
@@ -136,7 +151,7 @@ struct ClipRect
 
 struct Window
 {
-	uint8_t					id_;							// reserved. Not currently used.
+	uint8_t					id_;							// slot number assigned by the system when the window is added to its list. Used for hit-testing.
 	int8_t					display_order_;					// 0 = active window, ascending order from there. maintained by system. 
 	uint32_t				user_data_;						// 32 bits for use of programs. The system will not process this field. 
 	char*					title_;
@@ -188,8 +203,8 @@ struct Window
 	int16_t					inner_width_;					// space available inside the content area, accounting for border thicknesses
 	int16_t					inner_height_;					// space available inside the content area, accounting for border thicknesses and title bar
 	int16_t					avail_title_width_;				// available pixel width for the title to be rendered, based on delta between title x offset and left-most titlebar control
-	int16_t					content_left_;					// of the raw x pos of the window (non-gzz), the x pos where window should start rendering content. =gzz_left_ until window is scrolled leftwards
-	int16_t					content_top_;					// of the raw y pos of the window (non-gzz), the y pos where window should start rendering content. =gzz_top_ until window is scrolled down
+	int16_t					content_left_;					// scroll position: the H position within the window's content that is showing at the left edge of the content area. 0 until window is scrolled rightwards
+	int16_t					content_top_;					// scroll position: the V position within the window's content that is showing at the top edge of the content area. 0 until window is scrolled down
 	int16_t					required_inner_width_;			// greater of current inner_width or H space required inside the window to display all content. If greater than H space, a scroller is needed.
 	int16_t					required_inner_height_;			// greater of current inner_height or V space required inside the window to display all content. If greater than V space, a scroller is needed.
 	bool					h_scroller_visible_;
@@ -199,12 +214,26 @@ struct Window
 	Window*					child_window_;					// can be NULL. used when a window spawns a requester. (This is the requester). NULLs out again when requester is closed. 
 	Control*				root_control_;					// first control in the window
 	Control*				selected_control_;				// the currently selected control for the window. Only 1 can be selected per window. No guarantee that any are selected.
+	Control**				control_index_;					// controls bucketed by 32x32 cell, for hit-testing. Rebuilt on next use whenever control_index_invalidated_ is set.
+	uint16_t*				control_index_start_;			// for each cell, offset into control_index_ of its first control. One extra entry marks the end of the last cell.
+	Control**				control_id_index_;				// all controls sorted by ID, for binary search in Window_GetControl()
+	uint16_t				control_index_count_;			// number of controls in control_id_index_
+	uint8_t					control_index_cols_;			// number of cell columns in the control index
+	uint8_t					control_index_rows_;			// number of cell rows in the control index
+	bool					control_index_invalidated_;		// if true, a control was added, moved, or the window resized, and the control index must be rebuilt before use
+	bool					control_index_too_big_;			// if true, the controls covered too many cells to index at the last rebuild, and lookups walk the control list until the index is next invalidated
+	uint32_t				last_used_;						// system tick count when the window was last rendered. Used to pick least-recently-used windows for backing store eviction.
+	bool					backing_store_evicted_;			// if true, the system has discarded bitmap_'s storage to save memory. It will be rebuilt before the window is next rendered or drawn into.
 	Rectangle				clip_rect_[WIN_MAX_CLIP_RECTS];		// one or more clipping rects; determines which parts of window need to be blitted to the main screen
 	int16_t					clip_count_;					// number of clip rects the window is currently tracking
 	Rectangle				damage_rect_[4];				// 0 to 4 rects that describe to other windows under this one, which parts of the screen were previously covered by this window (prior to a move or resize)
 	int16_t					damage_count_;					// number of damage rects the window is currently tracking
 	void					(*event_handler_)(EventRecord*);	// function that will be called by the system when an event related to the window is encountered.
+	void					(*kind_handler_[WIN_EVENT_KIND_COUNT])(EventRecord*);	// optional handler for each kind of event. Where set, called instead of event_handler_.
+	uint32_t				event_mask_;					// event_mask bits for the kinds of event the window wants. Other kinds are dropped without calling any handler.
 	Menu*					menu_[WIN_MENU_MAX_GROUPS];				// non-permanent containers for menu structures; will be used for first, 2nd, 3rd, and 4th level menus as used in the window.
+	WindowShortcut			shortcut_[WIN_SHORTCUT_TABLE_SIZE];	// keyboard shortcuts of the menu groups attached to the window, hashed by key + modifiers
+	uint8_t					shortcut_count_;				// number of slots in use in shortcut_
 	int16_t					current_menu_level_;			// index to menu_[]; starts out at menu_no_menu; when a menu is opened, it goes to menu_level_0; increases with each submenu. Resets to menu_no_men uon close of menu.
 // 	Window*					zoom_to_window_;				// the window that contains the zoom_to_file, so we can get offset to global screen coords
 // 	int16_t					zoom_x_[WIN_ZOOM_RECT_COUNT];	// Used to plot the coords for zoom rects when opening/closing window
@@ -422,6 +451,33 @@ void Window_SetTitle(Window* the_window, char* the_title);
 //! @param	is_visible: set to true if window should be rendered in the next pass, false if not
 void Window_SetVisible(Window* the_window, bool is_visible);
 
+//! Set which kinds of events the window wants to receive
+//! Events of other kinds are dropped by the event manager before any handler is called, and where possible, before they are queued.
+//! The system still does its own processing of mouse events (activating windows, pressing controls, dragging, etc.) regardless of the mask.
+//! @param	the_window: reference to a valid Window object.
+//! @param	the_mask: event_mask bits (see event.h) for each kind of event wanted. Windows start with WIN_DEFAULT_EVENT_MASK.
+void Window_SetEventMask(Window* the_window, uint32_t the_mask);
+
+//! Register a handler for one kind of event, to be called instead of the window's main event handler
+//! NOTE: this does not change the event mask: the kind must also be in the window's event mask for the handler to be called.
+//! @param	the_window: reference to a valid Window object.
+//! @param	the_event_kind: the event_kind (see event.h) the handler is for
+//! @param	the_handler: the function to call for events of that kind, or NULL to go back to using the main event handler
+//! @return	Returns false if the event kind is out of range
+bool Window_SetEventHandlerForKind(Window* the_window, uint8_t the_event_kind, void (*the_handler)(EventRecord*));
+
+//! Attach a menu group to the window, adding the keyboard shortcuts of its items to the window's shortcut table
+//! Once attached, a keyDown in the window that matches a shortcut is turned into a menuSelected event for the item, without the menu being opened.
+//! Attach each submenu group as well, if its items have shortcuts. The menu group must stay allocated while attached.
+//! @param	the_window: reference to a valid Window object.
+//! @param	the_menu_group: reference to a valid MenuGroup
+//! @return	Returns false if the shortcut table was too full to take all the group's shortcuts
+bool Window_AttachMenuGroup(Window* the_window, MenuGroup* the_menu_group);
+
+//! Remove all keyboard shortcuts from the window, eg, before attaching a different set of menu groups
+//! @param	the_window: reference to a valid Window object.
+void Window_ClearShortcuts(Window* the_window);
+
 //! Set the display order of the window
 //! NOTE: This does not immediately re-render or change the display order visibly.
 //! WARNING: This function is designed to be called by the system only: do not use this
@@ -479,6 +535,16 @@ void Window_Minimize(Window* the_window);
 
 // **** Get functions *****
 
+//! @return	Returns the event_mask bits for the kinds of event the window wants
+uint32_t Window_GetEventMask(Window* the_window);
+
+//! Find the menu item a key combination is the shortcut for, in constant time
+//! @param	the_window: reference to a valid Window object.
+//! @param	the_key: the character of the key pressed. Case does not matter.
+//! @param	the_modifiers: the event_modifier_flags in effect. Left- and right-hand modifier keys are treated alike, and alpha lock is ignored.
+//! @return	Returns the id_ of the menu item, or MENU_ID_NO_SELECTION if the key combination is not a shortcut in this window
+int16_t Window_FindShortcut(Window* the_window, unsigned char the_key, uint16_t the_modifiers);
+
 
 //! Get a pointer to the current window title
 //! Note: It is not guaranteed that every window will have a title. Backdrop windows, for example, do not have a title.
@@ -563,13 +629,59 @@ void Window_UpdateTheme(Window* the_window);
 
 //! Mark entire window as invalidated
 //! This will cause it to be redrawn and fully reblitted in the next render cycle
+//! NOTE: drawing done through the Window_* drawing functions is tracked automatically; this is only needed when drawing directly to the window's bitmap
 //! @param	the_window: reference to a valid Window object.
 void Window_Invalidate(Window* the_window);
 
+//! Discard the window's off-screen bitmap storage to free memory. The window keeps its size, controls, etc.
+//! WARNING: This function is designed to be called by the system only (see Sys_ReclaimBackingStore()): do not use this
+//! @param	the_window: reference to a valid Window object.
+//! @return:	Returns false on any error condition
+bool Window_EvictBackingStore(Window* the_window);
+
+//! Re-allocate a discarded off-screen bitmap, redraw the window structure and controls into it via Window_DrawAll(), and send the window an updateEvt so it can redraw its content
+//! WARNING: This function is designed to be called by the system only (see Sys_RestoreBackingStore()): do not use this
+//! @param	the_window: reference to a valid Window object.
+//! @return:	Returns false on any error condition
+bool Window_RebuildBackingStore(Window* the_window);
+
+
+
+// **** SCROLL functions *****
+
+//! Tell the window how much space its content needs, so it knows how far it can be scrolled
+//! The scroll position will be adjusted if it is now out of range. Scroller visibility flags are updated to match.
+//! @param	the_window: reference to a valid Window object.
+//! @param	required_width: the total H space, in pixels, needed to display all of the window's content.
+//! @param	required_height: the total V space, in pixels, needed to display all of the window's content.
+void Window_SetContentSize(Window* the_window, int16_t required_width, int16_t required_height);
+
+//! Scroll the window's content so that the passed content position shows at the top left of the content area
+//! The existing pixels that remain visible are moved within the window's bitmap; they are not redrawn.
+//! The area newly exposed along the edge(s) is cleared, and the window is sent one updateEvt per exposed strip. 
+//!   Each event's x_ and y_ are the content-area-local top left of the strip, and its code_ has the strip's width in the high word, height in the low word.
+//!   Add content_left_ and content_top_ to translate the strip into content coordinates.
+//! If the scroll distance is larger than the content area, the whole content area is cleared and one updateEvt is sent for it.
+//! @param	the_window: reference to a valid Window object.
+//! @param	the_left: the H position within the content to scroll to. Will be clipped to the scrollable range.
+//! @param	the_top: the V position within the content to scroll to. Will be clipped to the scrollable range.
+//! @return:	Returns false on any error condition
+bool Window_ScrollTo(Window* the_window, int16_t the_left, int16_t the_top);
+
+//! Scroll the window's content by the passed number of pixels. See Window_ScrollTo().
+//! @param	the_window: reference to a valid Window object.
+//! @param	delta_x: number of pixels to scroll right (positive) or left (negative)
+//! @param	delta_y: number of pixels to scroll down (positive) or up (negative)
+//! @return:	Returns false on any error condition
+bool Window_ScrollBy(Window* the_window, int16_t delta_x, int16_t delta_y);
+
 
 
 // **** DRAW functions *****
 
+// NOTE: the drawing functions below are trimmed to the window's content area, and each one records the area it changed as a clip rect,
+//   so the next Window_Render() reblits only those pixels. There is no need to call Window_Invalidate() or Window_AddClipRect() after drawing.
+
 //! Convert the passed x, y global coordinates to local (to window) coordinates
 //! @param	the_window: reference to a valid Window object.
 //! @param	x: the global horizontal position to be converted to window-local.
@@ -604,8 +716,8 @@ bool Window_SetColor(Window* the_window, uint8_t the_color);
 //! This also sets the pen position of the window's bitmap
 //! This is the location that the next pen-based graphics function will use for a starting location
 //! @param	the_window: reference to a valid Window object.
-//! @param	x: the global horizontal position to be converted to window-local. Will be clipped to the edges.
-//! @param	y: the global vertical position to be converted to window-local. Will be clipped to the edges.
+//! @param	x: the global horizontal position to be converted to content-area-local. Will be clipped to the edges.
+//! @param	y: the global vertical position to be converted to content-area-local. Will be clipped to the edges.
 //! @return Returns false on any error condition
 bool Window_SetPenXYFromGlobal(Window* the_window, int16_t x, int16_t y);
 
@@ -24,6 +24,9 @@
 
 // C includes
 #include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 
 
 // A2560 includes
@@ -33,6 +36,9 @@
 #include <mb/text.h>
 #include <mb/font.h>
 #include <mb/lib_sys.h>
+#include <mb/event.h>
+#include <mb/menu.h>
+#include <mb/theme.h>
 
 
 
@@ -54,6 +60,12 @@
 
 extern System*			global_system;
 
+static uint32_t			dispatch_count;
+static uint32_t			window_changed_count;
+static int16_t			window_changed_x;
+static int16_t			window_changed_y;
+static uint16_t			kind_count[WIN_EVENT_KIND_COUNT];
+
 
 
 
@@ -67,6 +79,125 @@ extern System*			global_system;
 /*                       Private Function Definitions                        */
 /*****************************************************************************/
 
+// event handler for dispatch tests: just counts the events it is given
+static void window_test_count_events(EventRecord* the_event)
+{
+	dispatch_count++;
+}
+
+
+// find the pre-rendered titlebar the system would give this window, if it has one
+static Bitmap* window_test_cached_titlebar(Window* the_window)
+{
+	uint8_t		widget_mask = 0;
+	int16_t		i;
+	
+	for (i = CLOSE_WIDGET_ID; i < MAX_BUILT_IN_WIDGET; i++)
+	{
+		if (Window_GetControl(the_window, i) != NULL)
+		{
+			widget_mask |= (1 << i);
+		}
+	}
+	
+	return Sys_GetCachedChrome(global_system, the_window->titlebar_rect_.MaxX - the_window->titlebar_rect_.MinX + 1, the_window->titlebar_rect_.MaxY - the_window->titlebar_rect_.MinY + 1, widget_mask, the_window->active_);
+}
+
+
+// count the titlebars the system currently has cached
+static int16_t window_test_count_cached_titlebars(void)
+{
+	int16_t		num_cached = 0;
+	int16_t		i;
+	
+	for (i = 0; i < SYS_CHROME_CACHE_SIZE; i++)
+	{
+		if (global_system->chrome_cache_[i].bitmap_ != NULL)
+		{
+			num_cached++;
+		}
+	}
+	
+	return num_cached;
+}
+
+
+// event handler for drag tests: remembers where the last windowChanged event asked the window to move to
+static void window_test_record_window_changed(EventRecord* the_event)
+{
+	if (the_event->what_ == windowChanged)
+	{
+		window_changed_count++;
+		window_changed_x = the_event->x_;
+		window_changed_y = the_event->y_;
+	}
+}
+
+
+// event handler for replay tests: counts the events of each kind it is given, and remembers windowChanged positions
+static void window_test_count_kinds(EventRecord* the_event)
+{
+	if (the_event->what_ < WIN_EVENT_KIND_COUNT)
+	{
+		kind_count[the_event->what_]++;
+	}
+	
+	window_test_record_window_changed(the_event);
+}
+
+
+// timer handler for timer tests: counts the times it is called
+static void window_test_count_timer(void* the_user_data)
+{
+	(*(uint16_t*)the_user_data)++;
+}
+
+
+// idle task for idle task tests: counts the times it is called, and finishes after 5 calls
+static bool window_test_idle_task(void* the_user_data)
+{
+	(*(uint16_t*)the_user_data)++;
+	
+	return (*(uint16_t*)the_user_data < 5);
+}
+
+
+// idle task for idle task tests: counts the times it is called, and never finishes
+static bool window_test_endless_idle_task(void* the_user_data)
+{
+	(*(uint16_t*)the_user_data)++;
+	
+	return true;
+}
+
+
+// throw away anything waiting in the event queue, without dispatching it
+static void window_test_drain_events(void)
+{
+	while (EventManager_NextEvent() != NULL)
+	{
+	}
+}
+
+
+// queue one mouse event and let the event manager handle it straight away, so consecutive moves are not coalesced
+static void window_test_send_mouse_event(event_kind the_what, int16_t x, int16_t y)
+{
+	EventManager_AddEvent(the_what, 0L, x, y, 0L, NULL, NULL);
+	EventManager_WaitForEvent();
+}
+
+
+// spin until at least the_ticks have passed
+static void window_test_wait_ticks(uint32_t the_ticks)
+{
+	uint32_t	start_ticks = sys_time_jiffies();
+	
+	while (sys_time_jiffies() - start_ticks < the_ticks)
+	{
+	}
+}
+
 
 
 
@@ -93,6 +224,938 @@ void text_test_teardown(void)	// this is called EVERY test
 
 
 
+// **** unit tests
+
+// drawing through the Window_* functions should record just the changed area, trimmed to the content area
+MU_TEST(window_test_dirty_tracking)
+{
+	NewWinTemplate*		the_win_template;
+	Window*				the_window;
+	Rectangle*			the_clip;
+	Rectangle*			the_content;
+	
+	mu_assert( (the_win_template = Window_GetNewWinTemplate((char*)"Dirty tracking")) != NULL, "Could not get a new window template" );
+	mu_assert( (the_window = Window_New(the_win_template, NULL)) != NULL, "Could not open a window" );
+	
+	// first render clears the invalidated state and any pending clip rects
+	Window_Render(the_window);
+	mu_assert_int_eq(0, the_window->clip_count_);
+	the_content = &the_window->content_rect_;
+	
+	// one small fill: one clip rect, exactly the box, offset by the content area
+	Window_SetPenXY(the_window, 10, 20);
+	mu_assert( Window_FillBox(the_window, 8, 4, SYS_COLOR_RED1) == true, "FillBox failed" );
+	mu_assert_int_eq(1, the_window->clip_count_);
+	the_clip = &the_window->clip_rect_[0];
+	mu_assert_int_eq(the_content->MinX + 10, the_clip->MinX);
+	mu_assert_int_eq(the_content->MinY + 20, the_clip->MinY);
+	mu_assert_int_eq(the_content->MinX + 17, the_clip->MaxX);
+	mu_assert_int_eq(the_content->MinY + 23, the_clip->MaxY);
+	
+	// drawing inside an area already pending should not use up another clip rect
+	Window_SetPenXY(the_window, 11, 21);
+	mu_assert( Window_DrawHLine(the_window, 4, SYS_COLOR_GREEN1) == true, "DrawHLine failed" );
+	mu_assert_int_eq(1, the_window->clip_count_);
+	
+	// a line running off the content area is trimmed to it
+	mu_assert( Window_DrawLine(the_window, -50, 5, 5000, 5, SYS_COLOR_GREEN1) == true, "DrawLine failed" );
+	mu_assert_int_eq(2, the_window->clip_count_);
+	the_clip = &the_window->clip_rect_[1];
+	mu_assert_int_eq(the_content->MinX, the_clip->MinX);
+	mu_assert_int_eq(the_content->MaxX, the_clip->MaxX);
+	
+	// an empty box draws nothing, but is not an error
+	Window_SetPenXY(the_window, 0, 0);
+	mu_assert( Window_FillBox(the_window, 0, 0, SYS_COLOR_RED1) == true, "Empty FillBox failed" );
+	mu_assert_int_eq(2, the_window->clip_count_);
+	
+	// round shapes can't be trimmed, so any that stick out of the content area, on any side, are refused and record nothing
+	Window_SetPenXY(the_window, -5, 10);
+	mu_assert( Window_DrawRoundBox(the_window, 30, 20, 4, SYS_COLOR_RED1, true) == false, "Round box off the left was drawn" );
+	Window_SetPenXY(the_window, 10, -5);
+	mu_assert( Window_DrawRoundBox(the_window, 30, 20, 4, SYS_COLOR_RED1, true) == false, "Round box off the top was drawn" );
+	Window_SetPenXY(the_window, the_content->MaxX - the_content->MinX - 10, 10);
+	mu_assert( Window_DrawRoundBox(the_window, 30, 20, 4, SYS_COLOR_RED1, true) == false, "Round box off the right was drawn" );
+	Window_SetPenXY(the_window, 5, 10);
+	mu_assert( Window_DrawCircle(the_window, 8, SYS_COLOR_RED1) == false, "Circle off the left was drawn" );
+	mu_assert_int_eq(2, the_window->clip_count_);
+	
+	// render blits and clears the pending clip rects
+	Window_Render(the_window);
+	mu_assert_int_eq(0, the_window->clip_count_);
+	
+	Sys_CloseOneWindow(global_system, the_window);
+}
+
+
+// scrolling should move the pixels still in view, and clamp to the content size
+MU_TEST(window_test_scroll)
+{
+	NewWinTemplate*		the_win_template;
+	Window*				the_window;
+	Rectangle*			the_content;
+	EventRecord*		the_event;
+	uint32_t			content_width;
+	int16_t				content_height;
+	
+	mu_assert( (the_win_template = Window_GetNewWinTemplate((char*)"Scroll")) != NULL, "Could not get a new window template" );
+	mu_assert( (the_window = Window_New(the_win_template, NULL)) != NULL, "Could not open a window" );
+	Window_Render(the_window);
+	the_content = &the_window->content_rect_;
+	
+	// without more content than fits, there is nowhere to scroll to
+	mu_assert( Window_ScrollBy(the_window, 0, 10) == true, "ScrollBy failed" );
+	mu_assert_int_eq(0, the_window->content_top_);
+	
+	Window_SetContentSize(the_window, the_window->inner_width_, the_window->inner_height_ * 3);
+	mu_assert( the_window->v_scroller_visible_ == true, "V scroller should be needed" );
+	mu_assert( the_window->h_scroller_visible_ == false, "H scroller should not be needed" );
+	
+	Window_SetPenXY(the_window, 5, 20);
+	Window_SetPixel(the_window, SYS_COLOR_RED1);
+	content_width = the_content->MaxX - the_content->MinX + 1;
+	content_height = the_content->MaxY - the_content->MinY + 1;
+	window_test_drain_events();
+	
+	// scroll down 10: the pixel moves up 10, and the app is asked to draw the 10 rows exposed at the bottom
+	mu_assert( Window_ScrollBy(the_window, 0, 10) == true, "ScrollBy failed" );
+	mu_assert_int_eq(10, the_window->content_top_);
+	mu_assert_int_eq(SYS_COLOR_RED1, Bitmap_GetPixelAtXY(the_window->bitmap_, the_content->MinX + 5, the_content->MinY + 10));
+	mu_assert( (the_event = EventManager_NextEvent()) != NULL && the_event->what_ == updateEvt && the_event->window_ == the_window, "ScrollBy did not ask for the exposed strip to be drawn" );
+	mu_assert_int_eq(0, the_event->x_);
+	mu_assert_int_eq(content_height - 10, the_event->y_);
+	mu_assert( the_event->code_ == ((content_width << 16) | 10), "updateEvt did not give the size of the bottom strip" );
+	mu_assert( EventManager_NextEvent() == NULL, "ScrollBy asked for more than the bottom strip" );
+	
+	// and back up again, through the overlapping bottom-up copy: this time the 4 rows at the top are exposed
+	mu_assert( Window_ScrollBy(the_window, 0, -4) == true, "ScrollBy failed" );
+	mu_assert_int_eq(6, the_window->content_top_);
+	mu_assert_int_eq(SYS_COLOR_RED1, Bitmap_GetPixelAtXY(the_window->bitmap_, the_content->MinX + 5, the_content->MinY + 14));
+	mu_assert( (the_event = EventManager_NextEvent()) != NULL && the_event->what_ == updateEvt && the_event->window_ == the_window, "ScrollBy did not ask for the exposed strip to be drawn" );
+	mu_assert_int_eq(0, the_event->x_);
+	mu_assert_int_eq(0, the_event->y_);
+	mu_assert( the_event->code_ == ((content_width << 16) | 4), "updateEvt did not give the size of the top strip" );
+	mu_assert( EventManager_NextEvent() == NULL, "ScrollBy asked for more than the top strip" );
+	
+	// scroll position is clamped to the content size
+	mu_assert( Window_ScrollTo(the_window, 100, 32000) == true, "ScrollTo failed" );
+	mu_assert_int_eq(0, the_window->content_left_);
+	mu_assert_int_eq(the_window->required_inner_height_ - the_window->inner_height_, the_window->content_top_);
+	
+	Sys_CloseOneWindow(global_system, the_window);
+}
+
+
+// menu shortcuts should be found by key + modifiers, whichever hand's modifier key is used, and holding a shortcut down should repeat it
+MU_TEST(window_test_shortcuts)
+{
+	NewWinTemplate*		the_win_template;
+	Window*				the_window;
+	EventManager*		the_event_manager;
+	MenuGroup			the_group;
+	MenuItem			open_item;
+	MenuItem			close_item;
+	MenuItem			divider_item;
+	
+	mu_assert( (the_win_template = Window_GetNewWinTemplate((char*)"Shortcuts")) != NULL, "Could not get a new window template" );
+	mu_assert( (the_window = Window_New(the_win_template, &window_test_count_kinds)) != NULL, "Could not open a window" );
+	
+	open_item.id_ = 10;
+	open_item.shortcut_ = 'o';
+	open_item.modifiers_ = foenixKey;
+	open_item.type_ = menuItem;
+	close_item.id_ = 11;
+	close_item.shortcut_ = 'W';
+	close_item.modifiers_ = (foenixKey|optionKey);
+	close_item.type_ = menuItem;
+	divider_item.id_ = MENU_ID_DIVIDER;
+	divider_item.shortcut_ = 'D';
+	divider_item.modifiers_ = 0;
+	divider_item.type_ = menuDivider;
+	the_group.item_[0] = &open_item;
+	the_group.item_[1] = &divider_item;
+	the_group.item_[2] = &close_item;
+	the_group.num_menu_items_ = 3;
+	
+	mu_assert_int_eq(MENU_ID_NO_SELECTION, Window_FindShortcut(the_window, 'O', foenixKey));
+	mu_assert( Window_AttachMenuGroup(the_window, &the_group) == true, "AttachMenuGroup failed" );
+	
+	mu_assert_int_eq(10, Window_FindShortcut(the_window, 'O', foenixKey));
+	mu_assert_int_eq(10, Window_FindShortcut(the_window, 'o', foenixKey|alphaLock));
+	mu_assert_int_eq(11, Window_FindShortcut(the_window, 'W', foenixKey|rightOptionKey));
+	mu_assert_int_eq(MENU_ID_NO_SELECTION, Window_FindShortcut(the_window, 'W', foenixKey));
+	mu_assert_int_eq(MENU_ID_NO_SELECTION, Window_FindShortcut(the_window, 'O', 0));
+	mu_assert_int_eq(MENU_ID_NO_SELECTION, Window_FindShortcut(the_window, 'D', 0));
+	
+	// from the keyboard: while a key is held, the keyboard sends its make code again and again, which must come through as autoKey, not as more key presses
+	the_event_manager = Sys_GetEventManager(global_system);
+	Sys_SetActiveWindow(global_system, the_window);
+	EventManager_ProcessInput();
+	window_test_drain_events();
+	the_event_manager->kbd_modifiers_ = 0;
+	memset(kind_count, 0, sizeof(kind_count));
+	
+	EventManager_HandleKeyboardIRQ(0xE0);	// foenix (left "Windows") key down
+	EventManager_HandleKeyboardIRQ(0x5B);
+	EventManager_HandleKeyboardIRQ(0x18);	// O down, then held long enough to repeat twice
+	EventManager_HandleKeyboardIRQ(0x18);
+	EventManager_HandleKeyboardIRQ(0x18);
+	EventManager_HandleKeyboardIRQ(0x98);	// O up
+	EventManager_HandleKeyboardIRQ(0xE0);	// foenix key up
+	EventManager_HandleKeyboardIRQ(0xDB);
+	
+	mu_assert_int_eq(6, EventManager_ProcessInput());
+	mu_assert_int_eq(6, EventManager_GetPendingCount());
+	mu_assert( the_event_manager->queue_[(the_event_manager->read_idx_ + 2) % EVENT_QUEUE_SIZE]->what_ == autoKey, "repeated make code was not an autoKey" );
+	mu_assert( the_event_manager->queue_[(the_event_manager->read_idx_ + 3) % EVENT_QUEUE_SIZE]->what_ == autoKey, "repeated make code was not an autoKey" );
+	EventManager_WaitForEvent();
+	
+	// the shortcut is picked once for the press and once for each repeat; the window never sees the O key itself
+	mu_assert_int_eq(3, kind_count[menuSelected]);
+	mu_assert_int_eq(1, kind_count[keyDown]);
+	mu_assert_int_eq(0, kind_count[autoKey]);
+	mu_assert_int_eq(1, kind_count[keyUp]);
+	
+	// a held key that isn't a shortcut reaches the window as keyDown, autoKey..., keyUp
+	memset(kind_count, 0, sizeof(kind_count));
+	EventManager_HandleKeyboardIRQ(0x1E);
+	EventManager_HandleKeyboardIRQ(0x1E);
+	EventManager_HandleKeyboardIRQ(0x1E);
+	EventManager_HandleKeyboardIRQ(0x9E);
+	EventManager_HandleKeyboardIRQ(0x1E);	// pressed again after release: a new key press
+	EventManager_HandleKeyboardIRQ(0x9E);
+	EventManager_ProcessInput();
+	EventManager_WaitForEvent();
+	mu_assert_int_eq(0, kind_count[menuSelected]);
+	mu_assert_int_eq(2, kind_count[keyDown]);
+	mu_assert_int_eq(2, kind_count[autoKey]);
+	mu_assert_int_eq(2, kind_count[keyUp]);
+	
+	// holding caps lock down toggles it once, not once per repeat
+	EventManager_HandleKeyboardIRQ(0x3A);
+	EventManager_HandleKeyboardIRQ(0x3A);
+	EventManager_HandleKeyboardIRQ(0x3A);
+	EventManager_HandleKeyboardIRQ(0xBA);
+	mu_assert( (the_event_manager->kbd_modifiers_ & alphaLock) != 0, "caps lock not on" );
+	EventManager_HandleKeyboardIRQ(0x3A);
+	EventManager_HandleKeyboardIRQ(0xBA);
+	mu_assert( (the_event_manager->kbd_modifiers_ & alphaLock) == 0, "caps lock not off" );
+	EventManager_ProcessInput();
+	window_test_drain_events();
+	
+	Window_ClearShortcuts(the_window);
+	mu_assert_int_eq(MENU_ID_NO_SELECTION, Window_FindShortcut(the_window, 'O', foenixKey));
+	
+	Sys_CloseOneWindow(global_system, the_window);
+}
+
+
+// a full event queue drops (and counts) new events rather than overwriting queued ones, and consecutive mouse moves merge, but never across a button event
+MU_TEST(window_test_event_queue)
+{
+	NewWinTemplate*		the_win_template;
+	Window*				the_window;
+	EventRecord*		the_event;
+	uint32_t			dropped_before;
+	uint32_t			coalesced_before;
+	int16_t				i;
+	
+	mu_assert( (the_win_template = Window_GetNewWinTemplate((char*)"Queue")) != NULL, "Could not get a new window template" );
+	mu_assert( (the_window = Window_New(the_win_template, NULL)) != NULL, "Could not open a window" );
+	Window_SetEventMask(the_window, WIN_DEFAULT_EVENT_MASK | mouseMovedMask);
+	
+	window_test_drain_events();
+	EventManager_CheckOverflow();
+	
+	// one slot is always left empty, so the queue holds EVENT_QUEUE_SIZE - 1 events
+	dropped_before = EventManager_GetDroppedCount();
+	
+	for (i = 0; i < EVENT_QUEUE_SIZE + 4; i++)
+	{
+		EventManager_AddEvent(updateEvt, i, -1, -1, 0L, the_window, NULL);
+	}
+	
+	mu_assert_int_eq(EVENT_QUEUE_SIZE - 1, EventManager_GetPendingCount());
+	mu_assert_int_eq(5, EventManager_GetDroppedCount() - dropped_before);
+	mu_assert( EventManager_CheckOverflow() == true, "overflow not reported" );
+	mu_assert( EventManager_CheckOverflow() == false, "overflow not reset once reported" );
+	
+	// the oldest events survive: reading one frees exactly one slot
+	mu_assert( (the_event = EventManager_NextEvent()) != NULL, "no event in a full queue" );
+	mu_assert_int_eq(0, the_event->code_);
+	EventManager_AddEvent(updateEvt, 100, -1, -1, 0L, the_window, NULL);
+	EventManager_AddEvent(updateEvt, 101, -1, -1, 0L, the_window, NULL);
+	mu_assert_int_eq(EVENT_QUEUE_SIZE - 1, EventManager_GetPendingCount());
+	mu_assert_int_eq(6, EventManager_GetDroppedCount() - dropped_before);
+	mu_assert( (the_event = EventManager_NextEvent()) != NULL, "no event in a full queue" );
+	mu_assert_int_eq(1, the_event->code_);
+	window_test_drain_events();
+	mu_assert_int_eq(0, EventManager_GetPendingCount());
+	EventManager_CheckOverflow();
+	
+	// consecutive moves merge into one event, at the last position
+	coalesced_before = EventManager_GetCoalescedCount();
+	EventManager_AddEvent(mouseMoved, 0, 10, 10, 0L, the_window, NULL);
+	EventManager_AddEvent(mouseMoved, 0, 20, 20, 0L, the_window, NULL);
+	EventManager_AddEvent(mouseMoved, 0, 30, 40, 0L, the_window, NULL);
+	mu_assert_int_eq(1, EventManager_GetPendingCount());
+	mu_assert_int_eq(2, EventManager_GetCoalescedCount() - coalesced_before);
+	mu_assert( (the_event = EventManager_NextEvent()) != NULL, "merged move missing" );
+	mu_assert_int_eq(mouseMoved, the_event->what_);
+	mu_assert_int_eq(30, the_event->x_);
+	mu_assert_int_eq(40, the_event->y_);
+	
+	// a move that has already been read is never changed, and a move with other modifiers held is a new event
+	EventManager_AddEvent(mouseMoved, 0, 50, 50, 0L, the_window, NULL);
+	EventManager_AddEvent(mouseMoved, 0, 60, 60, (event_modifiers)shiftKey, the_window, NULL);
+	mu_assert_int_eq(30, the_event->x_);
+	mu_assert_int_eq(2, EventManager_GetPendingCount());
+	mu_assert_int_eq(2, EventManager_GetCoalescedCount() - coalesced_before);
+	window_test_drain_events();
+	
+	// a move never merges across a button event: the window must see where the button went down and came up
+	coalesced_before = EventManager_GetCoalescedCount();
+	EventManager_AddEvent(mouseMoved, 0, 100, 100, 0L, the_window, NULL);
+	EventManager_AddEvent(mouseDown, 0, 100, 100, 0L, the_window, NULL);
+	EventManager_AddEvent(mouseMoved, 0, 110, 110, 0L, the_window, NULL);
+	EventManager_AddEvent(mouseMoved, 0, 120, 120, 0L, the_window, NULL);
+	EventManager_AddEvent(mouseUp, 0, 120, 120, 0L, the_window, NULL);
+	EventManager_AddEvent(mouseMoved, 0, 130, 130, 0L, the_window, NULL);
+	mu_assert_int_eq(5, EventManager_GetPendingCount());
+	mu_assert_int_eq(1, EventManager_GetCoalescedCount() - coalesced_before);
+	
+	mu_assert( (the_event = EventManager_NextEvent()) != NULL && the_event->what_ == mouseMoved && the_event->x_ == 100, "move before mouseDown lost" );
+	mu_assert( (the_event = EventManager_NextEvent()) != NULL && the_event->what_ == mouseDown && the_event->x_ == 100, "mouseDown out of order" );
+	mu_assert( (the_event = EventManager_NextEvent()) != NULL && the_event->what_ == mouseMoved && the_event->x_ == 120, "moves while down not merged" );
+	mu_assert( (the_event = EventManager_NextEvent()) != NULL && the_event->what_ == mouseUp && the_event->x_ == 120, "mouseUp out of order" );
+	mu_assert( (the_event = EventManager_NextEvent()) != NULL && the_event->what_ == mouseMoved && the_event->x_ == 130, "move after mouseUp merged across it" );
+	mu_assert( EventManager_NextEvent() == NULL, "extra events in queue" );
+	
+	Sys_CloseOneWindow(global_system, the_window);
+}
+
+
+// the interrupt handlers decode set 1 scan codes and PS/2 mouse packets into the right events, and under load every input record is either turned into events or counted as dropped
+MU_TEST(window_test_input_pipeline)
+{
+	NewWinTemplate*		the_win_template;
+	Window*				the_window;
+	EventManager*		the_event_manager;
+	EventRecord*		the_event;
+	Screen*				the_screen;
+	uint32_t			input_dropped_before;
+	uint32_t			dropped_before;
+	uint32_t			coalesced_before;
+	uint32_t			masked_before;
+	uint32_t			num_events;
+	uint32_t			num_key_downs = 0;
+	uint32_t			num_key_ups = 0;
+	int16_t				i;
+	
+	mu_assert( (the_win_template = Window_GetNewWinTemplate((char*)"Input")) != NULL, "Could not get a new window template" );
+	mu_assert( (the_window = Window_New(the_win_template, NULL)) != NULL, "Could not open a window" );
+	Sys_SetActiveWindow(global_system, the_window);
+	Window_SetEventMask(the_window, WIN_DEFAULT_EVENT_MASK | mouseMovedMask);
+	
+	the_event_manager = Sys_GetEventManager(global_system);
+	the_screen = Sys_GetScreen(global_system, ID_CHANNEL_B);
+	EventManager_ProcessInput();
+	window_test_drain_events();
+	the_event_manager->kbd_modifiers_ = 0;
+	
+	// shift + A, then up arrow (0xE0 prefix), then the pause key, which has no events at all
+	EventManager_HandleKeyboardIRQ(0x2A);
+	EventManager_HandleKeyboardIRQ(0x1E);
+	EventManager_HandleKeyboardIRQ(0x9E);
+	EventManager_HandleKeyboardIRQ(0xAA);
+	EventManager_HandleKeyboardIRQ(0xE0);
+	EventManager_HandleKeyboardIRQ(0x48);
+	EventManager_HandleKeyboardIRQ(0xE0);
+	EventManager_HandleKeyboardIRQ(0xC8);
+	EventManager_HandleKeyboardIRQ(0xE1);
+	EventManager_HandleKeyboardIRQ(0x1D);
+	EventManager_HandleKeyboardIRQ(0x45);
+	EventManager_HandleKeyboardIRQ(0xE1);
+	EventManager_HandleKeyboardIRQ(0x9D);
+	EventManager_HandleKeyboardIRQ(0xC5);
+	
+	mu_assert_int_eq(6, EventManager_ProcessInput());
+	mu_assert( (the_event = EventManager_NextEvent()) != NULL && the_event->what_ == keyDown && the_event->code_ == 0x2A && the_event->modifiers_ == (event_modifiers)shiftKey, "shift down" );
+	mu_assert( (the_event = EventManager_NextEvent()) != NULL && the_event->what_ == keyDown && the_event->code_ == 0x1E && the_event->modifiers_ == (event_modifiers)shiftKey, "shifted A down" );
+	mu_assert( (the_event = EventManager_NextEvent()) != NULL && the_event->what_ == keyUp && the_event->code_ == 0x1E && the_event->modifiers_ == (event_modifiers)shiftKey, "shifted A up" );
+	mu_assert( (the_event = EventManager_NextEvent()) != NULL && the_event->what_ == keyUp && the_event->code_ == 0x2A && the_event->modifiers_ == 0, "shift up" );
+	mu_assert( (the_event = EventManager_NextEvent()) != NULL && the_event->what_ == keyDown && the_event->code_ == (0x48 | EXTENDED_KEY_FLAG), "up arrow down" );
+	mu_assert( (the_event = EventManager_NextEvent()) != NULL && the_event->what_ == keyUp && the_event->code_ == (0x48 | EXTENDED_KEY_FLAG), "up arrow up" );
+	mu_assert( EventManager_NextEvent() == NULL, "pause key made events" );
+	
+	// mouse: right 5 and up 3 with the left button down, a byte out of step with the packets, then left 5 with the button up
+	the_event_manager->pointer_x_ = 100;
+	the_event_manager->pointer_y_ = 100;
+	the_event_manager->mouse_buttons_ = 0;
+	EventManager_HandleMouseIRQ(0x08 | MOUSE_BUTTON_LEFT);
+	EventManager_HandleMouseIRQ(5);
+	EventManager_HandleMouseIRQ(3);
+	EventManager_HandleMouseIRQ(0x01);
+	EventManager_HandleMouseIRQ(0x08 | 0x10);
+	EventManager_HandleMouseIRQ(0xFB);
+	EventManager_HandleMouseIRQ(0);
+	
+	mu_assert_int_eq(4, EventManager_ProcessInput());
+	mu_assert( (the_event = EventManager_NextEvent()) != NULL && the_event->what_ == mouseMoved && the_event->x_ == 105 && the_event->y_ == 97, "first move" );
+	mu_assert( (the_event = EventManager_NextEvent()) != NULL && the_event->what_ == mouseDown && the_event->x_ == 105 && the_event->y_ == 97, "left button down" );
+	mu_assert( (the_event = EventManager_NextEvent()) != NULL && the_event->what_ == mouseMoved && the_event->x_ == 100 && the_event->y_ == 97, "second move" );
+	mu_assert( (the_event = EventManager_NextEvent()) != NULL && the_event->what_ == mouseUp && the_event->x_ == 100 && the_event->y_ == 97, "left button up" );
+	mu_assert( EventManager_NextEvent() == NULL, "stray mouse byte made events" );
+	
+	// load: bursts small enough for both queues lose nothing, and every key tap comes out as a down and an up
+	input_dropped_before = EventManager_GetInputDroppedCount();
+	dropped_before = EventManager_GetDroppedCount();
+	
+	for (i = 0; i < 200; i++)
+	{
+		EventManager_SimulateInputIRQs(16);
+		EventManager_ProcessInput();
+		
+		while ( (the_event = EventManager_NextEvent()) != NULL)
+		{
+			mu_assert( the_event->what_ == keyDown || the_event->what_ == keyUp || the_event->what_ == mouseMoved || the_event->what_ == mouseDown || the_event->what_ == mouseUp || the_event->what_ == rMouseDown || the_event->what_ == rMouseUp, "unexpected kind of event" );
+			
+			if (the_event->what_ == keyDown)
+			{
+				num_key_downs++;
+			}
+			else if (the_event->what_ == keyUp)
+			{
+				num_key_ups++;
+			}
+			else
+			{
+				mu_assert( the_event->x_ >= 0 && the_event->x_ < the_screen->width_ && the_event->y_ >= 0 && the_event->y_ < the_screen->height_, "pointer left the screen" );
+			}
+		}
+	}
+	
+	mu_assert( num_key_downs > 0, "no keys decoded" );
+	mu_assert_int_eq(num_key_downs, num_key_ups);
+	mu_assert_int_eq(0, EventManager_GetInputDroppedCount() - input_dropped_before);
+	mu_assert_int_eq(0, EventManager_GetDroppedCount() - dropped_before);
+	
+	// overload: the input queue fills up and drops (and counts) records, and every event made from what was kept is queued, merged, masked, or counted as dropped
+	coalesced_before = EventManager_GetCoalescedCount();
+	masked_before = EventManager_GetMaskedCount();
+	EventManager_SimulateInputIRQs(1000);
+	mu_assert( EventManager_GetInputDroppedCount() - input_dropped_before > 0, "input queue overflow not counted" );
+	
+	num_events = EventManager_ProcessInput();
+	mu_assert( the_event_manager->input_read_idx_ == the_event_manager->input_write_idx_, "input queue not emptied" );
+	mu_assert_int_eq(num_events, EventManager_GetPendingCount() + (EventManager_GetCoalescedCount() - coalesced_before) + (EventManager_GetMaskedCount() - masked_before) + (EventManager_GetDroppedCount() - dropped_before));
+	
+	window_test_drain_events();
+	EventManager_CheckOverflow();
+	the_event_manager->mouse_buttons_ = 0;
+	
+	Sys_CloseOneWindow(global_system, the_window);
+}
+
+
+// timers fire at their deadline and not before, repeating timers stay on schedule, and idle tasks get turns until they finish
+MU_TEST(window_test_timers)
+{
+	EventManager*		the_event_manager;
+	int16_t				the_timer_id;
+	int16_t				the_task_id;
+	int16_t				other_task_id;
+	uint32_t			start_ticks;
+	uint32_t			the_deadline;
+	uint16_t			num_fired;
+	uint16_t			fired_count = 0;
+	uint16_t			run_count = 0;
+	uint16_t			other_run_count = 0;
+	int16_t				i;
+	
+	the_event_manager = Sys_GetEventManager(global_system);
+	EventManager_ProcessInput();
+	window_test_drain_events();
+	EventManager_RunTimers();
+	
+	// one-shot: nothing before the deadline, then exactly one call
+	start_ticks = sys_time_jiffies();
+	mu_assert( (the_timer_id = EventManager_AddTimer(3, 0, &window_test_count_timer, &fired_count)) >= 0, "AddTimer failed" );
+	the_deadline = EventManager_GetNextTimerTicks();
+	mu_assert( the_deadline >= start_ticks + 3 && the_deadline <= sys_time_jiffies() + 3, "deadline not 3 ticks out" );
+	
+	while ((int32_t)(the_deadline - 1 - sys_time_jiffies()) > 0)
+	{
+	}
+	
+	num_fired = EventManager_RunTimers();
+	
+	if ((int32_t)(the_deadline - sys_time_jiffies()) > 0)
+	{
+		mu_assert_int_eq(0, num_fired);
+		mu_assert_int_eq(0, fired_count);
+	}
+	
+	while ((int32_t)(the_deadline - sys_time_jiffies()) > 0)
+	{
+	}
+	
+	EventManager_RunTimers();
+	mu_assert_int_eq(1, fired_count);
+	mu_assert_int_eq(1, the_event_manager->timers_[the_timer_id].run_count_);
+	mu_assert( EventManager_RemoveTimer(the_timer_id) == false, "one-shot timer still active after firing" );
+	mu_assert_int_eq(0, EventManager_GetNextTimerTicks());
+	
+	// a timer removed before its deadline never fires
+	fired_count = 0;
+	mu_assert( (the_timer_id = EventManager_AddTimer(1, 0, &window_test_count_timer, &fired_count)) >= 0, "AddTimer failed" );
+	mu_assert( EventManager_RemoveTimer(the_timer_id) == true, "RemoveTimer failed" );
+	start_ticks = sys_time_jiffies();
+	
+	while (sys_time_jiffies() - start_ticks < 3)
+	{
+		EventManager_RunTimers();
+	}
+	
+	mu_assert_int_eq(0, fired_count);
+	
+	// repeating: first call after 1 tick, then every 2 ticks, whenever RunTimers gets called
+	fired_count = 0;
+	mu_assert( (the_timer_id = EventManager_AddTimer(1, 2, &window_test_count_timer, &fired_count)) >= 0, "AddTimer failed" );
+	the_deadline = EventManager_GetNextTimerTicks();
+	
+	while ((int32_t)(the_deadline + 8 - sys_time_jiffies()) > 0)
+	{
+		EventManager_RunTimers();
+	}
+	
+	EventManager_RunTimers();
+	mu_assert_int_eq(5, fired_count);
+	mu_assert_int_eq(the_deadline + 10, EventManager_GetNextTimerTicks());
+	mu_assert( EventManager_RemoveTimer(the_timer_id) == true, "repeating timer not active" );
+	
+	// an idle task is called until it says it is finished, then unregistered
+	mu_assert( (the_task_id = EventManager_AddIdleTask(&window_test_idle_task, &run_count)) >= 0, "AddIdleTask failed" );
+	
+	for (i = 0; i < 100 && EventManager_RunIdleTasks() == true; i++)
+	{
+	}
+	
+	mu_assert_int_eq(5, run_count);
+	mu_assert_int_eq(5, the_event_manager->idle_tasks_[the_task_id].run_count_);
+	mu_assert( EventManager_RemoveIdleTask(the_task_id) == false, "finished idle task still registered" );
+	
+	// two idle tasks take turns
+	run_count = 0;
+	mu_assert( (the_task_id = EventManager_AddIdleTask(&window_test_endless_idle_task, &run_count)) >= 0, "AddIdleTask failed" );
+	mu_assert( (other_task_id = EventManager_AddIdleTask(&window_test_endless_idle_task, &other_run_count)) >= 0, "AddIdleTask failed" );
+	mu_assert( EventManager_RunIdleTasks() == true, "idle tasks not registered" );
+	mu_assert( run_count > 0 && other_run_count > 0, "an idle task did not get a turn" );
+	mu_assert( run_count - other_run_count <= 1 && other_run_count - run_count <= 1, "idle tasks not given equal turns" );
+	mu_assert( EventManager_RemoveIdleTask(the_task_id) == true, "RemoveIdleTask failed" );
+	mu_assert( EventManager_RemoveIdleTask(other_task_id) == true, "RemoveIdleTask failed" );
+	mu_assert( EventManager_RunIdleTasks() == false, "idle tasks still registered" );
+}
+
+
+// a drag whose button down, move, and button up are all queued before any of them is handled still moves the window, even though the window doesn't ask for mouseMoved
+MU_TEST(window_test_drag_in_one_batch)
+{
+	NewWinTemplate*		the_win_template;
+	Window*				the_window;
+	int16_t				start_x;
+	int16_t				start_y;
+	int16_t				titlebar_offset_x = 25;	// safe place to click in titlebar without hitting a close/etc button
+	int16_t				titlebar_offset_y = 5;
+	
+	mu_assert( (the_win_template = Window_GetNewWinTemplate((char*)"Drag")) != NULL, "Could not get a new window template" );
+	the_win_template->x_ = 100;
+	the_win_template->y_ = 100;
+	the_win_template->width_ = 300;
+	the_win_template->height_ = 200;
+	mu_assert( (the_window = Window_New(the_win_template, &window_test_record_window_changed)) != NULL, "Could not open a window" );
+	Sys_SetActiveWindow(global_system, the_window);
+	mu_assert( (the_window->event_mask_ & mouseMovedMask) == 0, "window should not be asking for mouseMoved" );
+	
+	EventManager_ProcessInput();
+	window_test_drain_events();
+	Mouse_SetMode(Sys_GetEventManager(global_system)->mouse_tracker_, mouseFree);
+	
+	start_x = Window_GetX(the_window) + titlebar_offset_x;
+	start_y = Window_GetY(the_window) + titlebar_offset_y;
+	window_changed_count = 0;
+	
+	EventManager_AddEvent(mouseDown, 0L, start_x, start_y, 0L, NULL, NULL);
+	EventManager_AddEvent(mouseMoved, 0L, start_x + 30, start_y + 20, 0L, NULL, NULL);
+	EventManager_AddEvent(mouseUp, 0L, start_x + 30, start_y + 20, 0L, NULL, NULL);
+	mu_assert_int_eq(3, EventManager_GetPendingCount());
+	
+	EventManager_WaitForEvent();
+	
+	mu_assert_int_eq(1, window_changed_count);
+	mu_assert_int_eq(Window_GetX(the_window) + 30, window_changed_x);
+	mu_assert_int_eq(Window_GetY(the_window) + 20, window_changed_y);
+	mu_assert_int_eq(mouseFree, Mouse_GetMode(Sys_GetEventManager(global_system)->mouse_tracker_));
+	
+	Sys_CloseOneWindow(global_system, the_window);
+}
+
+
+// mouse gestures: a title drag has to leave MOUSE_MOVEMENT_THRESHOLD before it moves the window, a second click is a double click only if it is close in time and place, and drag outlines are not redrawn more often than MOUSE_OUTLINE_REDRAW_TICKS
+MU_TEST(window_test_mouse_gestures)
+{
+	NewWinTemplate*		the_win_template;
+	Window*				the_window;
+	MouseTracker*		the_mouse;
+	int16_t				title_x;
+	int16_t				title_y;
+	int16_t				content_x;
+	int16_t				content_y;
+	uint32_t			jitter_before;
+	uint32_t			started_before;
+	uint32_t			doubles_before;
+	uint32_t			drawn_before;
+	uint32_t			skipped_before;
+	uint32_t			start_ticks;
+	uint32_t			elapsed_ticks;
+	int16_t				i;
+	
+	mu_assert( (the_win_template = Window_GetNewWinTemplate((char*)"Gestures")) != NULL, "Could not get a new window template" );
+	the_win_template->x_ = 100;
+	the_win_template->y_ = 100;
+	the_win_template->width_ = 300;
+	the_win_template->height_ = 200;
+	mu_assert( (the_window = Window_New(the_win_template, &window_test_record_window_changed)) != NULL, "Could not open a window" );
+	Sys_SetActiveWindow(global_system, the_window);
+	
+	EventManager_ProcessInput();
+	window_test_drain_events();
+	the_mouse = Sys_GetEventManager(global_system)->mouse_tracker_;
+	Mouse_SetMode(the_mouse, mouseFree);
+	
+	title_x = Window_GetX(the_window) + 25;
+	title_y = Window_GetY(the_window) + 5;
+	content_x = Window_GetX(the_window) + 150;
+	content_y = Window_GetY(the_window) + 100;
+	
+	// drag threshold: a move that stays inside the threshold is jitter, and the window stays put
+	window_changed_count = 0;
+	jitter_before = the_mouse->jitter_moves_;
+	started_before = the_mouse->moves_started_;
+	window_test_send_mouse_event(mouseDown, title_x, title_y);
+	mu_assert_int_eq(mouseDragTitle, Mouse_GetMode(the_mouse));
+	window_test_send_mouse_event(mouseMoved, title_x + MOUSE_MOVEMENT_THRESHOLD, title_y - MOUSE_MOVEMENT_THRESHOLD);
+	window_test_send_mouse_event(mouseUp, title_x + MOUSE_MOVEMENT_THRESHOLD, title_y - MOUSE_MOVEMENT_THRESHOLD);
+	mu_assert_int_eq(0, window_changed_count);
+	mu_assert_int_eq(jitter_before + 1, the_mouse->jitter_moves_);
+	mu_assert_int_eq(started_before, the_mouse->moves_started_);
+	mu_assert_int_eq(mouseFree, Mouse_GetMode(the_mouse));
+	
+	// one pixel past the threshold starts the drag, even if it is purely horizontal
+	window_test_send_mouse_event(mouseDown, title_x, title_y);
+	window_test_send_mouse_event(mouseMoved, title_x + MOUSE_MOVEMENT_THRESHOLD + 1, title_y);
+	window_test_send_mouse_event(mouseUp, title_x + MOUSE_MOVEMENT_THRESHOLD + 1, title_y);
+	mu_assert_int_eq(1, window_changed_count);
+	mu_assert_int_eq(Window_GetX(the_window) + MOUSE_MOVEMENT_THRESHOLD + 1, window_changed_x);
+	mu_assert_int_eq(Window_GetY(the_window), window_changed_y);
+	mu_assert_int_eq(started_before + 1, the_mouse->moves_started_);
+	
+	// double clicks: the second of two quick clicks close together is a double click, and a third click starts over
+	doubles_before = the_mouse->double_clicks_;
+	window_test_send_mouse_event(mouseDown, content_x, content_y);
+	mu_assert_int_eq(1, Mouse_GetClickCount(the_mouse));
+	window_test_send_mouse_event(mouseUp, content_x, content_y);
+	window_test_send_mouse_event(mouseDown, content_x + MOUSE_MOVEMENT_THRESHOLD, content_y - MOUSE_MOVEMENT_THRESHOLD);
+	mu_assert_int_eq(2, Mouse_GetClickCount(the_mouse));
+	window_test_send_mouse_event(mouseUp, content_x + MOUSE_MOVEMENT_THRESHOLD, content_y - MOUSE_MOVEMENT_THRESHOLD);
+	window_test_send_mouse_event(mouseDown, content_x, content_y);
+	mu_assert_int_eq(1, Mouse_GetClickCount(the_mouse));
+	window_test_send_mouse_event(mouseUp, content_x, content_y);
+	
+	// too far from the first click
+	window_test_send_mouse_event(mouseDown, content_x + MOUSE_MOVEMENT_THRESHOLD + 1, content_y);
+	mu_assert_int_eq(1, Mouse_GetClickCount(the_mouse));
+	window_test_send_mouse_event(mouseUp, content_x + MOUSE_MOVEMENT_THRESHOLD + 1, content_y);
+	
+	// too long after the first click
+	window_test_wait_ticks(MOUSE_DOUBLE_CLICK_TICKS + 1);
+	window_test_send_mouse_event(mouseDown, content_x + MOUSE_MOVEMENT_THRESHOLD + 1, content_y);
+	mu_assert_int_eq(1, Mouse_GetClickCount(the_mouse));
+	window_test_send_mouse_event(mouseUp, content_x + MOUSE_MOVEMENT_THRESHOLD + 1, content_y);
+	mu_assert_int_eq(doubles_before + 1, the_mouse->double_clicks_);
+	
+	// outline rate limit: of a stream of moves, no more are drawn than the time allows, and the rest are counted as skipped
+	drawn_before = the_mouse->outlines_drawn_;
+	skipped_before = the_mouse->outlines_skipped_;
+	window_test_send_mouse_event(mouseDown, title_x, title_y);
+	start_ticks = sys_time_jiffies();
+	
+	for (i = 1; i <= 10; i++)
+	{
+		window_test_send_mouse_event(mouseMoved, title_x + 10 + i, title_y);
+	}
+	
+	elapsed_ticks = sys_time_jiffies() - start_ticks;
+	mu_assert( the_mouse->outlines_drawn_ - drawn_before >= 1, "first outline of a drag was not drawn" );
+	mu_assert( the_mouse->outlines_drawn_ - drawn_before <= elapsed_ticks / MOUSE_OUTLINE_REDRAW_TICKS + 1, "outline redrawn too often" );
+	mu_assert_int_eq(10, (the_mouse->outlines_drawn_ - drawn_before) + (the_mouse->outlines_skipped_ - skipped_before));
+	
+	// moves spaced out by the redraw interval are all drawn
+	drawn_before = the_mouse->outlines_drawn_;
+	
+	for (i = 1; i <= 3; i++)
+	{
+		window_test_wait_ticks(MOUSE_OUTLINE_REDRAW_TICKS);
+		window_test_send_mouse_event(mouseMoved, title_x + 30 + i, title_y);
+	}
+	
+	mu_assert_int_eq(drawn_before + 3, the_mouse->outlines_drawn_);
+	
+	window_changed_count = 0;
+	window_test_send_mouse_event(mouseUp, title_x + 33, title_y);
+	mu_assert_int_eq(1, window_changed_count);
+	mu_assert_int_eq(Window_GetX(the_window) + 33, window_changed_x);
+	
+	Sys_CloseOneWindow(global_system, the_window);
+}
+
+
+// events still queued for a window when it closes are skipped and counted, without touching events for other windows, or for a new window given the same slot
+MU_TEST(window_test_stale_events)
+{
+	NewWinTemplate*		the_win_template;
+	Window*				the_closed_window;
+	Window*				the_open_window;
+	Window*				the_new_window;
+	EventRecord*		the_event;
+	uint32_t			stale_before;
+	
+	mu_assert( (the_win_template = Window_GetNewWinTemplate((char*)"Closing")) != NULL, "Could not get a new window template" );
+	mu_assert( (the_closed_window = Window_New(the_win_template, NULL)) != NULL, "Could not open a window" );
+	mu_assert( (the_win_template = Window_GetNewWinTemplate((char*)"Staying")) != NULL, "Could not get a new window template" );
+	mu_assert( (the_open_window = Window_New(the_win_template, NULL)) != NULL, "Could not open a window" );
+	
+	EventManager_ProcessInput();
+	window_test_drain_events();
+	stale_before = EventManager_GetStaleCount();
+	
+	EventManager_AddEvent(updateEvt, 1, -1, -1, 0L, the_closed_window, NULL);
+	EventManager_AddEvent(updateEvt, 2, -1, -1, 0L, the_open_window, NULL);
+	EventManager_AddEvent(activateEvt, 3, -1, -1, 0L, the_closed_window, NULL);
+	EventManager_AddEvent(updateEvt, 4, -1, -1, 0L, the_open_window, NULL);
+	
+	Sys_CloseOneWindow(global_system, the_closed_window);
+	
+	// the new window is given the closed window's slot, so only the generation tells its events apart
+	mu_assert( (the_win_template = Window_GetNewWinTemplate((char*)"Reusing")) != NULL, "Could not get a new window template" );
+	mu_assert( (the_new_window = Window_New(the_win_template, NULL)) != NULL, "Could not open a window" );
+	EventManager_AddEvent(updateEvt, 5, -1, -1, 0L, the_new_window, NULL);
+	
+	mu_assert( (the_event = EventManager_NextEvent()) != NULL && the_event->code_ == 2 && the_event->window_ == the_open_window, "event for open window lost" );
+	mu_assert( (the_event = EventManager_NextEvent()) != NULL && the_event->code_ == 4 && the_event->window_ == the_open_window, "event for open window lost" );
+	mu_assert( (the_event = EventManager_NextEvent()) != NULL && the_event->code_ == 5 && the_event->window_ == the_new_window, "event for new window lost" );
+	mu_assert( EventManager_NextEvent() == NULL, "event for closed window delivered" );
+	mu_assert_int_eq(2, EventManager_GetStaleCount() - stale_before);
+	
+	Sys_CloseOneWindow(global_system, the_new_window);
+	Sys_CloseOneWindow(global_system, the_open_window);
+}
+
+
+// a recorded session replays to the same results: the same events reach the window, and the drag in it moves the window to the same place
+MU_TEST(window_test_record_replay)
+{
+	NewWinTemplate*		the_win_template;
+	Window*				the_window;
+	EventReplayStats	the_stats;
+	FILE*				the_file;
+	char				the_line[80];
+	uint16_t			live_count[WIN_EVENT_KIND_COUNT];
+	int16_t				live_x;
+	int16_t				live_y;
+	int16_t				start_x;
+	int16_t				start_y;
+	int16_t				num_lines = 0;
+	int16_t				i;
+	
+	mu_assert( (the_win_template = Window_GetNewWinTemplate((char*)"Replay")) != NULL, "Could not get a new window template" );
+	the_win_template->x_ = 100;
+	the_win_template->y_ = 100;
+	the_win_template->width_ = 300;
+	the_win_template->height_ = 200;
+	mu_assert( (the_window = Window_New(the_win_template, &window_test_count_kinds)) != NULL, "Could not open a window" );
+	Sys_SetActiveWindow(global_system, the_window);
+	
+	EventManager_ProcessInput();
+	window_test_drain_events();
+	Mouse_SetMode(Sys_GetEventManager(global_system)->mouse_tracker_, mouseFree);
+	
+	// the handler reports the windowChanged but doesn't act on it, so the window is in the same place for the replay
+	start_x = Window_GetX(the_window) + 25;
+	start_y = Window_GetY(the_window) + 5;
+	memset(kind_count, 0, sizeof(kind_count));
+	window_changed_count = 0;
+	
+	mu_assert( EventManager_StartRecording(16) == true, "StartRecording failed" );
+	mu_assert( EventManager_StartRecording(16) == false, "StartRecording while recording" );
+	EventManager_AddEvent(mouseDown, 0L, start_x, start_y, 0L, NULL, NULL);
+	EventManager_AddEvent(mouseMoved, 0L, start_x + 20, start_y + 10, 0L, NULL, NULL);
+	EventManager_AddEvent(mouseUp, 0L, start_x + 40, start_y + 15, 0L, NULL, NULL);
+	EventManager_WaitForEvent();
+	EventManager_AddEvent(keyDown, 0x1E, -1, -1, (event_modifiers)shiftKey, NULL, NULL);
+	EventManager_AddEvent(keyUp, 0x1E, -1, -1, (event_modifiers)shiftKey, NULL, NULL);
+	EventManager_AddEvent(updateEvt, 0, -1, -1, 0L, the_window, NULL);	// not input: not recorded
+	EventManager_WaitForEvent();
+	mu_assert( EventManager_StopRecording("replay_test.evt") == true, "StopRecording failed" );
+	mu_assert( EventManager_StopRecording(NULL) == false, "StopRecording while not recording" );
+	
+	mu_assert_int_eq(1, window_changed_count);
+	mu_assert_int_eq(1, kind_count[keyDown]);
+	mu_assert_int_eq(1, kind_count[keyUp]);
+	memcpy(live_count, kind_count, sizeof(kind_count));
+	live_x = window_changed_x;
+	live_y = window_changed_y;
+	
+	// replay as fast as possible
+	memset(kind_count, 0, sizeof(kind_count));
+	window_changed_count = 0;
+	
+	mu_assert( EventManager_Replay("replay_test.evt", false, "replay_test.txt", &the_stats) == true, "Replay failed" );
+	EventManager_PrintReplayStats(&the_stats);
+	mu_assert_int_eq(5, the_stats.events_);
+	mu_assert( the_stats.max_handling_ticks_ <= the_stats.handling_ticks_ && the_stats.handling_ticks_ <= the_stats.elapsed_ticks_, "replay totals inconsistent" );
+	mu_assert_int_eq(1, window_changed_count);
+	mu_assert_int_eq(live_x, window_changed_x);
+	mu_assert_int_eq(live_y, window_changed_y);
+	
+	for (i = 0; i < WIN_EVENT_KIND_COUNT; i++)
+	{
+		if (i != updateEvt)
+		{
+			mu_assert_int_eq(live_count[i], kind_count[i]);
+		}
+	}
+	
+	// one header line, then one line per event
+	mu_assert( (the_file = fopen("replay_test.txt", "r")) != NULL, "no results file" );
+	
+	while (fgets(the_line, sizeof(the_line), the_file) != NULL)
+	{
+		num_lines++;
+	}
+	
+	fclose(the_file);
+	mu_assert_int_eq(1 + 5, num_lines);
+	
+	// a file that isn't an event log is refused
+	mu_assert( EventManager_Replay("replay_test.txt", false, NULL, &the_stats) == false, "replayed a file that is not an event log" );
+	mu_assert_int_eq(0, the_stats.events_);
+	
+	remove("replay_test.evt");
+	remove("replay_test.txt");
+	
+	Sys_CloseOneWindow(global_system, the_window);
+}
+
+
+// titlebars are cached per width and active state, rebuilt after a width or theme change, and replaced least recently used first
+MU_TEST(window_test_titlebar_cache)
+{
+	NewWinTemplate*		the_win_template;
+	Window*				the_window;
+	Bitmap*				the_chrome;
+	Theme*				the_theme;
+	Rectangle			the_rect;
+	int16_t				num_cached;
+	int16_t				i;
+	
+	mu_assert( (the_win_template = Window_GetNewWinTemplate((char*)"Titlebar cache")) != NULL, "Could not get a new window template" );
+	the_win_template->x_ = 20;
+	the_win_template->y_ = 20;
+	the_win_template->width_ = 300;
+	the_win_template->height_ = 200;
+	mu_assert( (the_window = Window_New(the_win_template, NULL)) != NULL, "Could not open a window" );
+	mu_assert( Sys_SetActiveWindow(global_system, the_window) == true, "Could not activate window" );
+	Window_Render(the_window);
+	mu_assert( (the_chrome = window_test_cached_titlebar(the_window)) != NULL, "Titlebar was not cached" );
+	
+	// redrawing the same titlebar is a hit: same entry, nothing added
+	num_cached = window_test_count_cached_titlebars();
+	Window_Invalidate(the_window);
+	Window_Render(the_window);
+	mu_assert_int_eq(num_cached, window_test_count_cached_titlebars());
+	mu_assert( window_test_cached_titlebar(the_window) == the_chrome, "Redraw did not reuse the cached titlebar" );
+	
+	// the inactive state is a miss the first time, then a hit in both states
+	Window_SetActive(the_window, false);
+	Window_Render(the_window);
+	mu_assert( window_test_cached_titlebar(the_window) != NULL, "Inactive titlebar was not cached" );
+	mu_assert( window_test_cached_titlebar(the_window) != the_chrome, "Inactive titlebar reused the active one" );
+	num_cached = window_test_count_cached_titlebars();
+	Window_SetActive(the_window, true);
+	Window_Render(the_window);
+	mu_assert_int_eq(num_cached, window_test_count_cached_titlebars());
+	mu_assert( window_test_cached_titlebar(the_window) == the_chrome, "Reactivating did not reuse the cached titlebar" );
+	
+	// a new width is a miss, and is cached in turn
+	Window_ChangeWindow(the_window, 20, 20, 340, 200, WIN_PARAM_DO_NOT_UPDATE_NORM_SIZE);
+	Window_Render(the_window);
+	mu_assert( window_test_cached_titlebar(the_window) != NULL, "Titlebar at new width was not cached" );
+	mu_assert( window_test_cached_titlebar(the_window) != the_chrome, "Titlebar at new width reused the old one" );
+	
+	// a theme change throws away every cached titlebar; the window's is rebuilt when it redraws in the new theme
+	the_rect.MinX = 0;
+	the_rect.MinY = 0;
+	the_rect.MaxX = 32;
+	the_rect.MaxY = 9;
+	mu_assert( Sys_CacheChrome(global_system, the_window->bitmap_, &the_rect, 0, true) == true, "CacheChrome failed" );
+	mu_assert( Sys_GetCachedChrome(global_system, 33, 10, 0, true) != NULL, "Titlebar was not cached" );
+	mu_assert( (the_theme = Theme_CreateGreenTheme()) != NULL, "Could not create theme" );
+	
+	if (Theme_Activate(the_theme) == false)
+	{
+		Theme_Destroy(&the_theme);
+		mu_fail("Could not change theme");
+	}
+	
+	mu_assert( Sys_GetCachedChrome(global_system, 33, 10, 0, true) == NULL, "Theme change did not flush the cache" );
+	Window_Render(the_window);
+	mu_assert( window_test_cached_titlebar(the_window) != NULL, "Titlebar was not rebuilt in the new theme" );
+	
+	// the system destroys the theme it replaces, so only a theme it refused is left for the test to destroy
+	mu_assert( (the_theme = Theme_CreateDefaultTheme(THEME_PARAM_FULL_RESOURCES)) != NULL, "Could not create theme" );
+	
+	if (Theme_Activate(the_theme) == false)
+	{
+		Theme_Destroy(&the_theme);
+		mu_fail("Could not restore theme");
+	}
+	
+	// once the cache is full, the entry used longest ago is the one replaced
+	Sys_FlushChromeCache(global_system);
+	mu_assert_int_eq(0, window_test_count_cached_titlebars());
+	
+	for (i = 0; i < SYS_CHROME_CACHE_SIZE; i++)
+	{
+		the_rect.MaxX = 19 + i;
+		mu_assert( Sys_CacheChrome(global_system, the_window->bitmap_, &the_rect, 0, true) == true, "CacheChrome failed" );
+	}
+	
+	mu_assert_int_eq(SYS_CHROME_CACHE_SIZE, window_test_count_cached_titlebars());
+	mu_assert( Sys_GetCachedChrome(global_system, 20, 10, 0, true) != NULL, "First titlebar was not cached" );
+	the_rect.MaxX = 19 + SYS_CHROME_CACHE_SIZE;
+	mu_assert( Sys_CacheChrome(global_system, the_window->bitmap_, &the_rect, 0, true) == true, "CacheChrome failed" );
+	mu_assert_int_eq(SYS_CHROME_CACHE_SIZE, window_test_count_cached_titlebars());
+	mu_assert( Sys_GetCachedChrome(global_system, 20, 10, 0, true) != NULL, "Recently used titlebar was replaced" );
+	mu_assert( Sys_GetCachedChrome(global_system, 21, 10, 0, true) == NULL, "Least recently used titlebar was not replaced" );
+	mu_assert( Sys_GetCachedChrome(global_system, 20 + SYS_CHROME_CACHE_SIZE, 10, 0, true) != NULL, "New titlebar was not cached" );
+	
+	Sys_CloseOneWindow(global_system, the_window);
+	
+	free(the_win_template);
+}
+
+
 // **** speed tests
 
 MU_TEST(text_test_hline_speed)
@@ -126,6 +1189,90 @@ MU_TEST(text_test_hline_speed)
 }
 
 
+// cost of posting and dispatching events: through the main handler, through a per-kind handler, and turned away by the event mask
+MU_TEST(window_test_dispatch_speed)
+{
+	long start1;
+	long end1;
+	long start2;
+	long end2;
+	long start3;
+	long end3;
+	NewWinTemplate*		the_win_template;
+	Window*				the_window;
+	uint32_t			masked_before;
+	int16_t				i;
+	int16_t				num_events = 32;	// must fit in the event queue
+	int16_t				j;
+	int16_t				num_cycles = 100;
+	
+	mu_assert( (the_win_template = Window_GetNewWinTemplate((char*)"Dispatch")) != NULL, "Could not get a new window template" );
+	mu_assert( (the_window = Window_New(the_win_template, &window_test_count_events)) != NULL, "Could not open a window" );
+	
+	// main event handler
+	dispatch_count = 0;
+	start1 = mu_timer_real();
+	
+	for (j = 0; j < num_cycles; j++)
+	{
+		for (i = 0; i < num_events; i++)
+		{
+			EventManager_AddEvent(updateEvt, 0, -1, -1, 0L, the_window, NULL);
+		}
+		
+		EventManager_WaitForEvent();
+	}
+	
+	end1 = mu_timer_real();
+	mu_assert_int_eq(num_events * num_cycles, dispatch_count);
+	
+	// per-kind handler from the window's dispatch table
+	dispatch_count = 0;
+	mu_assert( Window_SetEventHandlerForKind(the_window, updateEvt, &window_test_count_events) == true, "SetEventHandlerForKind failed" );
+	start2 = mu_timer_real();
+	
+	for (j = 0; j < num_cycles; j++)
+	{
+		for (i = 0; i < num_events; i++)
+		{
+			EventManager_AddEvent(updateEvt, 0, -1, -1, 0L, the_window, NULL);
+		}
+		
+		EventManager_WaitForEvent();
+	}
+	
+	end2 = mu_timer_real();
+	mu_assert_int_eq(num_events * num_cycles, dispatch_count);
+	
+	// masked out: events are dropped when posted, and never reach the queue
+	dispatch_count = 0;
+	masked_before = EventManager_GetMaskedCount();
+	Window_SetEventMask(the_window, WIN_DEFAULT_EVENT_MASK & ~updateMask);
+	start3 = mu_timer_real();
+	
+	for (j = 0; j < num_cycles; j++)
+	{
+		for (i = 0; i < num_events; i++)
+		{
+			EventManager_AddEvent(updateEvt, 0, -1, -1, 0L, the_window, NULL);
+		}
+		
+		if (EventManager_GetPendingCount() > 0)
+		{
+			EventManager_WaitForEvent();
+		}
+	}
+	
+	end3 = mu_timer_real();
+	mu_assert_int_eq(0, dispatch_count);
+	mu_assert_int_eq(num_events * num_cycles, EventManager_GetMaskedCount() - masked_before);
+	
+	printf("\nSpeed results: %i events via main handler in %li ticks; via per-kind handler in %li ticks; masked out in %li ticks\n", num_events * num_cycles, end1 - start1, end2 - start2, end3 - start3);
+	
+	Sys_CloseOneWindow(global_system, the_window);
+}
+
+
 
 	// speed tests
 MU_TEST_SUITE(text_test_suite_speed)
@@ -133,6 +1280,7 @@ MU_TEST_SUITE(text_test_suite_speed)
 	MU_SUITE_CONFIGURE(&text_test_setup, &text_test_teardown);
 	
 // 	MU_RUN_TEST(text_test_hline_speed);
+	MU_RUN_TEST(window_test_dispatch_speed);
 }
 
 
@@ -142,6 +1290,17 @@ MU_TEST_SUITE(text_test_suite_units)
 	MU_SUITE_CONFIGURE(&text_test_setup, &text_test_teardown);
 	
 // 	MU_RUN_TEST(font_replace_test);
+	MU_RUN_TEST(window_test_dirty_tracking);
+	MU_RUN_TEST(window_test_scroll);
+	MU_RUN_TEST(window_test_shortcuts);
+	MU_RUN_TEST(window_test_titlebar_cache);
+	MU_RUN_TEST(window_test_event_queue);
+	MU_RUN_TEST(window_test_input_pipeline);
+	MU_RUN_TEST(window_test_timers);
+	MU_RUN_TEST(window_test_drag_in_one_batch);
+	MU_RUN_TEST(window_test_mouse_gestures);
+	MU_RUN_TEST(window_test_stale_events);
+	MU_RUN_TEST(window_test_record_replay);
 }
 
 